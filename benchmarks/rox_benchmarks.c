@@ -0,0 +1,1191 @@
+//==============================================================================
+//
+//    OPENROX   : File rox_benchmarks.c
+//
+//    Contents  : Benchmark suite for kernels and pipelines
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== HEADERS   ================================================================
+
+#include <api/openrox.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <baseproc/image/remap/remap_bilinear_nomask_uchar_to_uchar/remap_bilinear_nomask_uchar_to_uchar.h>
+#include <baseproc/image/pyramid/pyramid_uchar.h>
+#include <baseproc/image/convolve/array2d_float_symmetric_separable_convolve.h>
+#include <baseproc/image/imask/imask.h>
+#include <baseproc/maths/kernels/gaussian2d.h>
+#include <baseproc/geometry/pixelgrid/meshgrid2d.h>
+#include <baseproc/geometry/pixelgrid/warp_grid_matsl3.h>
+#include <baseproc/array/crosscor/array2d_uchar_zncc_nomask.h>
+#include <baseproc/calculus/linsys/linsys_texture_matsl3_light_affine.h>
+#include <core/features/detectors/segment/fastst.h>
+#include <core/features/detectors/segment/fastst_score.h>
+#include <core/features/descriptors/ehid/ehid.h>
+#include <generated/dynvec_segment_point_struct.h>
+#include <generated/dynvec_ehid_point_struct.h>
+
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
+
+// ===== INTERNAL MACROS    =================================================
+
+#define ROX_BENCH_MAX_SIZES    8
+#define ROX_BENCH_MAX_THREADS  8
+#define ROX_BENCH_MAX_REPEAT   1000
+#define ROX_BENCH_MAX_RECORDS  1024
+#define ROX_BENCH_NAME_LENGTH  64
+
+// Maximum number of points described by the ehid case, as in the identification
+#define ROX_BENCH_EHID_POINTS 300
+
+// Size of the template used by the tracking and identification pipelines
+#define ROX_BENCH_TEMPLATE_SIZE 128
+
+// ===== INTERNAL TYPESDEFS =================================================
+
+//! One benchmark case: setup is not timed, run is timed, cleanup releases the context
+typedef struct Rox_Bench_Case_Struct
+{
+   //! The case name (kernel or pipeline)
+   const Rox_Char * name;
+   //! Create the inputs of the case for a given image size
+   Rox_ErrorCode ( * setup ) ( Rox_Void ** context, const Rox_Image image );
+   //! One timed run
+   Rox_ErrorCode ( * run ) ( Rox_Void * context );
+   //! Release the context
+   Rox_Void ( * cleanup ) ( Rox_Void * context );
+} Rox_Bench_Case;
+
+//! One measurement
+typedef struct Rox_Bench_Record_Struct
+{
+   Rox_Char name[ROX_BENCH_NAME_LENGTH];
+   Rox_Sint cols;
+   Rox_Sint rows;
+   Rox_Sint threads;
+   Rox_Double median_ms;
+   Rox_Double p10_ms;
+   Rox_Double p90_ms;
+   Rox_Double min_ms;
+   Rox_Double max_ms;
+} Rox_Bench_Record;
+
+// ===== INTERNAL DATATYPES =================================================
+
+typedef struct Rox_Bench_Remap_Struct
+{
+   Rox_Image input;
+   Rox_Image output;
+   Rox_MeshGrid2D_Float grid;
+} * Rox_Bench_Remap;
+
+typedef struct Rox_Bench_Pyramid_Struct
+{
+   Rox_Image input;
+   Rox_Pyramid_Uchar pyramid;
+} * Rox_Bench_Pyramid;
+
+typedef struct Rox_Bench_Convolve_Struct
+{
+   Rox_Array2D_Float input;
+   Rox_Array2D_Float output;
+   Rox_Array2D_Float hfilter;
+   Rox_Array2D_Float vfilter;
+} * Rox_Bench_Convolve;
+
+typedef struct Rox_Bench_Fastst_Struct
+{
+   Rox_Image input;
+   Rox_DynVec_Segment_Point points;
+} * Rox_Bench_Fastst;
+
+typedef struct Rox_Bench_Ehid_Struct
+{
+   Rox_Image input;
+   Rox_DynVec_Ehid_Point points;
+} * Rox_Bench_Ehid;
+
+typedef struct Rox_Bench_Zncc_Struct
+{
+   Rox_Image one;
+   Rox_Image two;
+} * Rox_Bench_Zncc;
+
+typedef struct Rox_Bench_Linsys_Struct
+{
+   Rox_Array2D_Float Ia;
+   Rox_Array2D_Float Id;
+   Rox_Array2D_Float Iu;
+   Rox_Array2D_Float Iv;
+   Rox_Imask Im;
+   Rox_Matrix LtL;
+   Rox_Matrix Lte;
+} * Rox_Bench_Linsys;
+
+typedef struct Rox_Bench_Tracking_Struct
+{
+   Rox_Image input;
+   Rox_Image model;
+   Rox_Tracking_Params params;
+   Rox_Tracking tracking;
+   Rox_MatSL3 H;
+} * Rox_Bench_Tracking;
+
+typedef struct Rox_Bench_Ident_Struct
+{
+   Rox_Image model;
+   Rox_Camera camera;
+   Rox_Database_Item item;
+   Rox_Database database;
+   Rox_Ident_Database_SE3 ident;
+} * Rox_Bench_Ident;
+
+// ===== INTERNAL VARIABLES =================================================
+
+static Rox_Bench_Record records[ROX_BENCH_MAX_RECORDS];
+static Rox_Sint nb_records = 0;
+
+// ===== INTERNAL FUNCTDEFS =================================================
+
+// ===== INTERNAL FUNCTIONS =================================================
+
+//! Deterministic pseudo random generator (same sequence on every platform)
+static Rox_Uint rox_bench_random ( Rox_Uint * state )
+{
+   *state = *state * 1664525u + 1013904223u;
+   return *state >> 8;
+}
+
+//! Fill an image with a deterministic textured pattern: smooth waves, checker squares and noise
+static Rox_ErrorCode rox_bench_fill_image ( Rox_Image image, Rox_Uint seed )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uchar ** data = NULL;
+   Rox_Sint rows = 0, cols = 0;
+   Rox_Uint state = seed;
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_get_data_pointer_to_pointer ( &data, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         Rox_Double value = 128.0 + 50.0 * sin ( 0.11 * j ) * cos ( 0.07 * i );
+         value += ( ( ( i / 16 ) + ( j / 24 ) ) % 2 ) ? 40.0 : -40.0;
+         value += ( Rox_Double ) ( rox_bench_random ( &state ) % 17 ) - 8.0;
+
+         if ( value < 0.0 ) value = 0.0;
+         if ( value > 255.0 ) value = 255.0;
+         data[i][j] = ( Rox_Uchar ) value;
+      }
+   }
+
+function_terminate:
+   return error;
+}
+
+//! Create a sub image (deep copy) of size x size at (top, left)
+static Rox_ErrorCode rox_bench_new_crop ( Rox_Image * crop, const Rox_Image image, Rox_Sint top, Rox_Sint left, Rox_Sint size )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uchar ** dc = NULL, ** di = NULL;
+
+   error = rox_image_new ( crop, size, size );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_get_data_pointer_to_pointer ( &dc, *crop );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_get_data_pointer_to_pointer ( &di, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < size; i++ )
+   {
+      memcpy ( dc[i], &di[top + i][left], size );
+   }
+
+function_terminate:
+   return error;
+}
+
+//! Convert an image to a float array
+static Rox_ErrorCode rox_bench_new_float ( Rox_Array2D_Float * output, const Rox_Image image, Rox_Float scale )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uchar ** di = NULL;
+   Rox_Float ** df = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_new ( output, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_get_data_pointer_to_pointer ( &di, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &df, *output );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < rows; i++ )
+      for ( Rox_Sint j = 0; j < cols; j++ )
+         df[i][j] = scale * di[i][j];
+
+function_terminate:
+   return error;
+}
+
+//! Homography close to identity used by the warping cases
+static Rox_ErrorCode rox_bench_set_homography ( Rox_MatSL3 H, Rox_Double tu, Rox_Double tv )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** dH = NULL;
+   Rox_Double c = 0.98 * cos ( 0.03 ), s = 0.98 * sin ( 0.03 );
+
+   error = rox_matsl3_get_data_pointer_to_pointer ( &dH, H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   dH[0][0] =  c; dH[0][1] = -s; dH[0][2] = tu;
+   dH[1][0] =  s; dH[1][1] =  c; dH[1][2] = tv;
+   dH[2][0] = 0.0; dH[2][1] = 0.0; dH[2][2] = 1.0;
+
+function_terminate:
+   return error;
+}
+
+//--- remap -----------------------------------------------------------------
+
+static Rox_Void rox_bench_remap_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Remap ctx = ( Rox_Bench_Remap ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->input );
+   rox_image_del ( &ctx->output );
+   rox_meshgrid2d_float_del ( &ctx->grid );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_remap_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Remap ctx = NULL;
+   Rox_MatSL3 H = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Remap ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->input, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_copy ( ctx->input, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->output, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_meshgrid2d_float_new ( &ctx->grid, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_matsl3_new ( &H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_set_homography ( H, 3.5, -2.25 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_warp_grid_sl3_float ( ctx->grid, H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   rox_matsl3_del ( &H );
+   if ( error ) { rox_bench_remap_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_remap_run ( Rox_Void * context )
+{
+   Rox_Bench_Remap ctx = ( Rox_Bench_Remap ) context;
+   return rox_remap_bilinear_nomask_uchar_to_uchar ( ctx->output, ctx->input, ctx->grid );
+}
+
+//--- pyramid ---------------------------------------------------------------
+
+static Rox_Void rox_bench_pyramid_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Pyramid ctx = ( Rox_Bench_Pyramid ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->input );
+   rox_pyramid_uchar_del ( &ctx->pyramid );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_pyramid_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Pyramid ctx = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Pyramid ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->input, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_copy ( ctx->input, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_pyramid_uchar_new ( &ctx->pyramid, cols, rows, 4, 16 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   if ( error ) { rox_bench_pyramid_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_pyramid_run ( Rox_Void * context )
+{
+   Rox_Bench_Pyramid ctx = ( Rox_Bench_Pyramid ) context;
+   return rox_pyramid_uchar_assign_gaussian ( ctx->pyramid, ctx->input, 1.0f );
+}
+
+//--- separable convolution -------------------------------------------------
+
+static Rox_Void rox_bench_convolve_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Convolve ctx = ( Rox_Bench_Convolve ) context;
+   if ( !ctx ) return;
+   rox_array2d_float_del ( &ctx->input );
+   rox_array2d_float_del ( &ctx->output );
+   rox_array2d_float_del ( &ctx->hfilter );
+   rox_array2d_float_del ( &ctx->vfilter );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_convolve_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Convolve ctx = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Convolve ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_new_float ( &ctx->input, image, 1.0f );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_new ( &ctx->output, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_kernelgen_gaussian2d_separable_float_new ( &ctx->hfilter, &ctx->vfilter, 1.5f, 3.0f );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   if ( error ) { rox_bench_convolve_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_convolve_run ( Rox_Void * context )
+{
+   Rox_Bench_Convolve ctx = ( Rox_Bench_Convolve ) context;
+   return rox_array2d_float_symmetric_seperable_convolve ( ctx->output, ctx->input, ctx->hfilter );
+}
+
+//--- fastst ----------------------------------------------------------------
+
+static Rox_Void rox_bench_fastst_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Fastst ctx = ( Rox_Bench_Fastst ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->input );
+   rox_dynvec_segment_point_del ( &ctx->points );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_fastst_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Fastst ctx = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Fastst ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->input, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_copy ( ctx->input, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_segment_point_new ( &ctx->points, 1000 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   if ( error ) { rox_bench_fastst_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_fastst_run ( Rox_Void * context )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Fastst ctx = ( Rox_Bench_Fastst ) context;
+
+   error = rox_dynvec_segment_point_reset ( ctx->points );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_fastst_detector ( ctx->points, ctx->input, 20, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+//--- ehid descriptors ------------------------------------------------------
+
+static Rox_Void rox_bench_ehid_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Ehid ctx = ( Rox_Bench_Ehid ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->input );
+   rox_dynvec_ehid_point_del ( &ctx->points );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_ehid_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Ehid ctx = NULL;
+   Rox_DynVec_Segment_Point corners = NULL;
+   Rox_DynVec_Segment_Point corners_nonmax = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Ehid ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->input, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_copy ( ctx->input, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_ehid_point_new ( &ctx->points, ROX_BENCH_EHID_POINTS );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_segment_point_new ( &corners, 1000 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_segment_point_new ( &corners_nonmax, 1000 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // The strongest corners away from the borders, selected as in the identification
+   error = rox_fastst_detector ( corners, ctx->input, 20, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_fastst_detector_score ( corners, ctx->input, 20 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_fastst_nonmax_suppression ( corners_nonmax, corners );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_fastst_detector_sort ( corners_nonmax );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Uint k = 0; k < corners_nonmax->used && ctx->points->used < ROX_BENCH_EHID_POINTS; k++ )
+   {
+      Rox_Ehid_Point_Struct point;
+      memset ( &point, 0, sizeof ( point ) );
+
+      point.pos.u = corners_nonmax->data[k].j;
+      point.pos.v = corners_nonmax->data[k].i;
+
+      if ( point.pos.u < 10 || point.pos.v < 10 || point.pos.u >= cols - 10 || point.pos.v >= rows - 10 ) continue;
+
+      error = rox_dynvec_ehid_point_append ( ctx->points, &point );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   rox_dynvec_segment_point_del ( &corners );
+   rox_dynvec_segment_point_del ( &corners_nonmax );
+   if ( error ) { rox_bench_ehid_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_ehid_run ( Rox_Void * context )
+{
+   Rox_Bench_Ehid ctx = ( Rox_Bench_Ehid ) context;
+   return rox_ehid_points_compute ( ctx->points, ctx->input );
+}
+
+//--- zncc ------------------------------------------------------------------
+
+static Rox_Void rox_bench_zncc_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Zncc ctx = ( Rox_Bench_Zncc ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->one );
+   rox_image_del ( &ctx->two );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_zncc_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Zncc ctx = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Zncc ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->one, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_copy ( ctx->one, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->two, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_fill_image ( ctx->two, 7 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   if ( error ) { rox_bench_zncc_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_zncc_run ( Rox_Void * context )
+{
+   Rox_Bench_Zncc ctx = ( Rox_Bench_Zncc ) context;
+   Rox_Double score = 0.0;
+   return rox_array2d_uchar_zncc_nomask ( &score, ctx->one, ctx->two );
+}
+
+//--- linsys ----------------------------------------------------------------
+
+static Rox_Void rox_bench_linsys_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Linsys ctx = ( Rox_Bench_Linsys ) context;
+   if ( !ctx ) return;
+   rox_array2d_float_del ( &ctx->Ia );
+   rox_array2d_float_del ( &ctx->Id );
+   rox_array2d_float_del ( &ctx->Iu );
+   rox_array2d_float_del ( &ctx->Iv );
+   rox_imask_del ( &ctx->Im );
+   rox_matrix_del ( &ctx->LtL );
+   rox_matrix_del ( &ctx->Lte );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_linsys_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Linsys ctx = NULL;
+   Rox_Image other = NULL;
+   Rox_Float ** dIa = NULL, ** dIu = NULL, ** dIv = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Linsys ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &other, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_fill_image ( other, 11 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_new_float ( &ctx->Ia, image, 1.0f );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_new_float ( &ctx->Id, other, 0.1f );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_new ( &ctx->Iu, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_new ( &ctx->Iv, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &dIa, ctx->Ia );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &dIu, ctx->Iu );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &dIv, ctx->Iv );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Central differences
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         Rox_Sint jm = j > 0 ? j - 1 : j, jp = j < cols - 1 ? j + 1 : j;
+         Rox_Sint im = i > 0 ? i - 1 : i, ip = i < rows - 1 ? i + 1 : i;
+         dIu[i][j] = 0.5f * ( dIa[i][jp] - dIa[i][jm] );
+         dIv[i][j] = 0.5f * ( dIa[ip][j] - dIa[im][j] );
+      }
+   }
+
+   error = rox_imask_new ( &ctx->Im, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_imask_set_ones ( ctx->Im );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_matrix_new ( &ctx->LtL, 10, 10 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_matrix_new ( &ctx->Lte, 10, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   rox_image_del ( &other );
+   if ( error ) { rox_bench_linsys_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_linsys_run ( Rox_Void * context )
+{
+   Rox_Bench_Linsys ctx = ( Rox_Bench_Linsys ) context;
+   return linsys_texture_matsl3_light_affine ( ctx->LtL, ctx->Lte, ctx->Ia, ctx->Id, ctx->Iu, ctx->Iv, ctx->Im );
+}
+
+//--- tracking pipeline -----------------------------------------------------
+
+static Rox_Void rox_bench_tracking_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Tracking ctx = ( Rox_Bench_Tracking ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->input );
+   rox_image_del ( &ctx->model );
+   rox_tracking_del ( &ctx->tracking );
+   rox_tracking_params_del ( &ctx->params );
+   rox_matsl3_del ( &ctx->H );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_tracking_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Tracking ctx = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Tracking ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_new ( &ctx->input, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_image_copy ( ctx->input, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // The model is the centered template of the image
+   error = rox_bench_new_crop ( &ctx->model, image, ( rows - ROX_BENCH_TEMPLATE_SIZE ) / 2, ( cols - ROX_BENCH_TEMPLATE_SIZE ) / 2, ROX_BENCH_TEMPLATE_SIZE );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_tracking_params_new ( &ctx->params );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_tracking_new ( &ctx->tracking, ctx->params, ctx->model );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_matsl3_new ( &ctx->H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   if ( error ) { rox_bench_tracking_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_tracking_run ( Rox_Void * context )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Tracking ctx = ( Rox_Bench_Tracking ) context;
+   Rox_Sint rows = 0, cols = 0;
+   Rox_Double ** dH = NULL;
+
+   error = rox_image_get_size ( &rows, &cols, ctx->input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_matsl3_set_unit ( ctx->H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_matsl3_get_data_pointer_to_pointer ( &dH, ctx->H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Start each run from the same perturbed prediction
+   dH[0][2] = ( cols - ROX_BENCH_TEMPLATE_SIZE ) / 2 + 2.0;
+   dH[1][2] = ( rows - ROX_BENCH_TEMPLATE_SIZE ) / 2 - 1.5;
+
+   error = rox_tracking_set_homography ( ctx->tracking, ctx->H );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_tracking_make ( ctx->tracking, ctx->input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+//--- identification pipeline -----------------------------------------------
+
+static Rox_Void rox_bench_ident_cleanup ( Rox_Void * context )
+{
+   Rox_Bench_Ident ctx = ( Rox_Bench_Ident ) context;
+   if ( !ctx ) return;
+   rox_image_del ( &ctx->model );
+   rox_camera_del ( &ctx->camera );
+   rox_ident_database_se3_del ( &ctx->ident );
+   rox_database_del ( &ctx->database );
+   rox_database_item_del ( &ctx->item );
+   rox_memory_delete ( ctx );
+}
+
+static Rox_ErrorCode rox_bench_ident_setup ( Rox_Void ** context, const Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Bench_Ident ctx = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   ctx = ( Rox_Bench_Ident ) rox_memory_allocate ( sizeof ( *ctx ), 1 );
+   if ( !ctx ) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   memset ( ctx, 0, sizeof ( *ctx ) );
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bench_new_crop ( &ctx->model, image, ( rows - ROX_BENCH_TEMPLATE_SIZE ) / 2, ( cols - ROX_BENCH_TEMPLATE_SIZE ) / 2, ROX_BENCH_TEMPLATE_SIZE );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_database_item_new ( &ctx->item );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_database_item_learn_template ( ctx->item, ctx->model );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_database_new ( &ctx->database );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_database_add_item ( ctx->database, ctx->item, 0.2, 0.2 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_database_compile ( ctx->database );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_ident_database_se3_new ( &ctx->ident, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_ident_database_se3_set_database ( ctx->ident, ctx->database );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_camera_new ( &ctx->camera, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_camera_set_pinhole_params ( ctx->camera, cols, cols, cols / 2.0, rows / 2.0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_camera_set_image ( ctx->camera, image );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   if ( error ) { rox_bench_ident_cleanup ( ctx ); ctx = NULL; }
+   *context = ctx;
+   return error;
+}
+
+static Rox_ErrorCode rox_bench_ident_run ( Rox_Void * context )
+{
+   Rox_Bench_Ident ctx = ( Rox_Bench_Ident ) context;
+   return rox_ident_database_se3_make ( ctx->ident, ctx->camera );
+}
+
+//--- registry --------------------------------------------------------------
+
+static const Rox_Bench_Case cases[] =
+{
+   { "remap_bilinear_nomask_uchar", rox_bench_remap_setup   , rox_bench_remap_run   , rox_bench_remap_cleanup    },
+   { "pyramid_uchar_gaussian"     , rox_bench_pyramid_setup , rox_bench_pyramid_run , rox_bench_pyramid_cleanup  },
+   { "convolve_separable_float"   , rox_bench_convolve_setup, rox_bench_convolve_run, rox_bench_convolve_cleanup },
+   { "fastst_detector"            , rox_bench_fastst_setup  , rox_bench_fastst_run  , rox_bench_fastst_cleanup   },
+   { "ehid_points_compute"        , rox_bench_ehid_setup    , rox_bench_ehid_run    , rox_bench_ehid_cleanup     },
+   { "zncc_nomask_uchar"          , rox_bench_zncc_setup    , rox_bench_zncc_run    , rox_bench_zncc_cleanup     },
+   { "linsys_texture_matsl3"      , rox_bench_linsys_setup  , rox_bench_linsys_run  , rox_bench_linsys_cleanup   },
+   { "pipeline_tracking_make"     , rox_bench_tracking_setup, rox_bench_tracking_run, rox_bench_tracking_cleanup },
+   { "pipeline_ident_database_se3", rox_bench_ident_setup   , rox_bench_ident_run   , rox_bench_ident_cleanup    },
+};
+
+//--- statistics and reports ------------------------------------------------
+
+static int rox_bench_compare_double ( const void * a, const void * b )
+{
+   Rox_Double da = * ( const Rox_Double * ) a;
+   Rox_Double db = * ( const Rox_Double * ) b;
+   return ( da > db ) - ( da < db );
+}
+
+//! Percentile of sorted samples with linear interpolation
+static Rox_Double rox_bench_percentile ( const Rox_Double * sorted, Rox_Sint count, Rox_Double percent )
+{
+   Rox_Double position = percent * ( count - 1 );
+   Rox_Sint low = ( Rox_Sint ) floor ( position );
+   Rox_Sint high = low + 1 < count ? low + 1 : low;
+   Rox_Double alpha = position - low;
+   return ( 1.0 - alpha ) * sorted[low] + alpha * sorted[high];
+}
+
+static Rox_Void rox_bench_set_threads ( Rox_Sint threads )
+{
+#ifdef ROX_USES_OPENMP
+   omp_set_num_threads ( threads );
+#else
+   ( void ) threads;
+#endif
+}
+
+static Rox_Sint rox_bench_max_threads ( Rox_Void )
+{
+#ifdef ROX_USES_OPENMP
+   return omp_get_max_threads ( );
+#else
+   return 1;
+#endif
+}
+
+//! Run one case for one size and one thread count: warmup runs, then repeat timed runs
+static Rox_ErrorCode rox_bench_measure ( Rox_Bench_Record * record, const Rox_Bench_Case * bench, Rox_Void * context, Rox_Sint warmup, Rox_Sint repeat, Rox_Timer timer )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double samples[ROX_BENCH_MAX_REPEAT];
+
+   for ( Rox_Sint k = 0; k < warmup; k++ )
+   {
+      error = bench->run ( context );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   for ( Rox_Sint k = 0; k < repeat; k++ )
+   {
+      error = rox_timer_start ( timer );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = bench->run ( context );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_timer_stop ( timer );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_timer_get_elapsed_ms ( &samples[k], timer );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   qsort ( samples, repeat, sizeof ( Rox_Double ), rox_bench_compare_double );
+
+   record->median_ms = rox_bench_percentile ( samples, repeat, 0.5 );
+   record->p10_ms = rox_bench_percentile ( samples, repeat, 0.1 );
+   record->p90_ms = rox_bench_percentile ( samples, repeat, 0.9 );
+   record->min_ms = samples[0];
+   record->max_ms = samples[repeat - 1];
+
+function_terminate:
+   return error;
+}
+
+//! Write the records in JSON, one result per line
+static Rox_ErrorCode rox_bench_write_json ( const Rox_Char * filename, Rox_Sint warmup, Rox_Sint repeat )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   FILE * out = fopen ( filename, "w" );
+
+   if ( !out ) { error = ROX_ERROR_EXTERNAL; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   fprintf ( out, "{\n" );
+   fprintf ( out, "  \"version\": \"%s.%s.%s\",\n", OPENROX_MAJOR_VERSION, OPENROX_MINOR_VERSION, OPENROX_PATCH_VERSION );
+   fprintf ( out, "  \"warmup\": %d,\n", warmup );
+   fprintf ( out, "  \"repeat\": %d,\n", repeat );
+   fprintf ( out, "  \"results\": [\n" );
+
+   for ( Rox_Sint k = 0; k < nb_records; k++ )
+   {
+      Rox_Bench_Record * r = &records[k];
+      fprintf ( out, "    {\"name\": \"%s\", \"cols\": %d, \"rows\": %d, \"threads\": %d, \"median_ms\": %.6f, \"p10_ms\": %.6f, \"p90_ms\": %.6f, \"min_ms\": %.6f, \"max_ms\": %.6f}%s\n",
+                r->name, r->cols, r->rows, r->threads, r->median_ms, r->p10_ms, r->p90_ms, r->min_ms, r->max_ms, ( k < nb_records - 1 ) ? "," : "" );
+   }
+
+   fprintf ( out, "  ]\n" );
+   fprintf ( out, "}\n" );
+
+function_terminate:
+   if ( out ) fclose ( out );
+   return error;
+}
+
+//! Compare the records with a baseline written by rox_bench_write_json
+//! A case regresses when its median is slower than the baseline median by more than tolerance
+static Rox_ErrorCode rox_bench_compare_baseline ( Rox_Sint * regressions, const Rox_Char * filename, Rox_Double tolerance )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Char line[1024];
+   FILE * in = fopen ( filename, "r" );
+
+   *regressions = 0;
+
+   if ( !in ) { error = ROX_ERROR_EXTERNAL; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   printf ( "\n%-30s %11s %7s %12s %12s %8s\n", "case", "size", "threads", "baseline_ms", "current_ms", "ratio" );
+
+   while ( fgets ( line, sizeof ( line ), in ) )
+   {
+      Rox_Char name[ROX_BENCH_NAME_LENGTH];
+      Rox_Sint cols = 0, rows = 0, threads = 0;
+      Rox_Double median = 0.0;
+      const Rox_Char * start = strstr ( line, "{\"name\"" );
+
+      if ( !start ) continue;
+      if ( sscanf ( start, "{\"name\": \"%63[^\"]\", \"cols\": %d, \"rows\": %d, \"threads\": %d, \"median_ms\": %lf", name, &cols, &rows, &threads, &median ) != 5 ) continue;
+
+      for ( Rox_Sint k = 0; k < nb_records; k++ )
+      {
+         Rox_Bench_Record * r = &records[k];
+         Rox_Double ratio = 0.0;
+
+         if ( strcmp ( r->name, name ) || r->cols != cols || r->rows != rows || r->threads != threads ) continue;
+
+         ratio = median > 0.0 ? r->median_ms / median : 1.0;
+         printf ( "%-30s %5dx%-5d %7d %12.3f %12.3f %8.3f%s\n", name, cols, rows, threads, median, r->median_ms, ratio, ratio > 1.0 + tolerance ? "  REGRESSION" : "" );
+
+         if ( ratio > 1.0 + tolerance ) ( *regressions )++;
+      }
+   }
+
+function_terminate:
+   if ( in ) fclose ( in );
+   return error;
+}
+
+//! Parse a comma separated list of integers ("1,4") or of sizes ("640x480,1280x720")
+//! Returns 0 when an entry is not strictly positive, so that the list is rejected
+static Rox_Sint rox_bench_parse_list ( Rox_Sint * first, Rox_Sint * second, Rox_Sint max, const Rox_Char * text )
+{
+   Rox_Sint count = 0;
+   const Rox_Char * cursor = text;
+
+   while ( cursor && *cursor && count < max )
+   {
+      if ( second )
+      {
+         if ( sscanf ( cursor, "%dx%d", &first[count], &second[count] ) != 2 ) break;
+         if ( second[count] < 1 ) return 0;
+      }
+      else
+      {
+         if ( sscanf ( cursor, "%d", &first[count] ) != 1 ) break;
+      }
+      if ( first[count] < 1 ) return 0;
+      count++;
+      cursor = strchr ( cursor, ',' );
+      if ( cursor ) cursor++;
+   }
+
+   return count;
+}
+
+static Rox_Void rox_bench_usage ( const Rox_Char * program )
+{
+   printf ( "usage: %s [options]\n", program );
+   printf ( "  --output FILE       JSON results (default: rox_benchmarks.json)\n" );
+   printf ( "  --baseline FILE     JSON results to compare with\n" );
+   printf ( "  --tolerance T       Allowed median slowdown wrt baseline (default: 0.10)\n" );
+   printf ( "  --warmup N          Untimed runs before measuring (default: 3)\n" );
+   printf ( "  --repeat N          Timed runs (default: 15)\n" );
+   printf ( "  --sizes WxH,...     Image sizes (default: 320x240,640x480,1280x720)\n" );
+   printf ( "  --threads N,...     Thread counts (default: 1 and the maximum)\n" );
+   printf ( "  --filter TEXT       Only run the cases whose name contains TEXT\n" );
+}
+
+// ===== EXPORTED FUNCTIONS =================================================
+
+Rox_Sint main ( Rox_Sint argc, Rox_Char * argv[] )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   const Rox_Char * output = "rox_benchmarks.json";
+   const Rox_Char * baseline = NULL;
+   const Rox_Char * filter = NULL;
+   Rox_Double tolerance = 0.10;
+   Rox_Sint warmup = 3, repeat = 15;
+
+   Rox_Sint cols[ROX_BENCH_MAX_SIZES] = { 320, 640, 1280 };
+   Rox_Sint rows[ROX_BENCH_MAX_SIZES] = { 240, 480, 720 };
+   Rox_Sint nb_sizes = 3;
+   Rox_Sint threads[ROX_BENCH_MAX_THREADS] = { 1 };
+   Rox_Sint nb_threads = 1;
+   Rox_Sint regressions = 0;
+   Rox_Sint max_threads = rox_bench_max_threads ( );
+
+   Rox_Timer timer = NULL;
+   Rox_Image image = NULL;
+
+   if ( max_threads > 1 )
+   {
+      threads[1] = max_threads;
+      nb_threads = 2;
+   }
+
+   for ( Rox_Sint a = 1; a < argc; a++ )
+   {
+      const Rox_Char * value = ( a + 1 < argc ) ? argv[a + 1] : NULL;
+
+      if      ( !strcmp ( argv[a], "--output"    ) && value ) { output = value; a++; }
+      else if ( !strcmp ( argv[a], "--baseline"  ) && value ) { baseline = value; a++; }
+      else if ( !strcmp ( argv[a], "--filter"    ) && value ) { filter = value; a++; }
+      else if ( !strcmp ( argv[a], "--tolerance" ) && value ) { tolerance = atof ( value ); a++; }
+      else if ( !strcmp ( argv[a], "--warmup"    ) && value ) { warmup = atoi ( value ); a++; }
+      else if ( !strcmp ( argv[a], "--repeat"    ) && value ) { repeat = atoi ( value ); a++; }
+      else if ( !strcmp ( argv[a], "--sizes"     ) && value ) { nb_sizes = rox_bench_parse_list ( cols, rows, ROX_BENCH_MAX_SIZES, value ); a++; }
+      else if ( !strcmp ( argv[a], "--threads"   ) && value ) { nb_threads = rox_bench_parse_list ( threads, NULL, ROX_BENCH_MAX_THREADS, value ); a++; }
+      else { rox_bench_usage ( argv[0] ); return 1; }
+   }
+
+   if ( repeat < 1 || repeat > ROX_BENCH_MAX_REPEAT || warmup < 0 || nb_sizes < 1 || nb_threads < 1 )
+   { rox_bench_usage ( argv[0] ); return 1; }
+
+   error = rox_timer_new ( &timer );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   printf ( "%-30s %11s %7s %12s %12s %12s\n", "case", "size", "threads", "median_ms", "p10_ms", "p90_ms" );
+
+   for ( Rox_Sint s = 0; s < nb_sizes; s++ )
+   {
+      // Inputs are deterministic: same seed for every size and every run
+      error = rox_image_new ( &image, cols[s], rows[s] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_bench_fill_image ( image, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      for ( Rox_Uint c = 0; c < sizeof ( cases ) / sizeof ( cases[0] ); c++ )
+      {
+         const Rox_Bench_Case * bench = &cases[c];
+         Rox_Void * context = NULL;
+
+         if ( filter && !strstr ( bench->name, filter ) ) continue;
+
+         error = bench->setup ( &context, image );
+         if ( error )
+         {
+            printf ( "%-30s %5dx%-5d setup failed (error %d), skipped\n", bench->name, cols[s], rows[s], error );
+            error = ROX_ERROR_NONE;
+            continue;
+         }
+
+         for ( Rox_Sint t = 0; t < nb_threads && nb_records < ROX_BENCH_MAX_RECORDS; t++ )
+         {
+            Rox_Bench_Record * record = &records[nb_records];
+
+            rox_bench_set_threads ( threads[t] );
+
+            strncpy ( record->name, bench->name, ROX_BENCH_NAME_LENGTH - 1 );
+            record->name[ROX_BENCH_NAME_LENGTH - 1] = 0;
+            record->cols = cols[s];
+            record->rows = rows[s];
+            record->threads = threads[t];
+
+            error = rox_bench_measure ( record, bench, context, warmup, repeat, timer );
+            if ( error )
+            {
+               printf ( "%-30s %5dx%-5d %7d run failed (error %d), skipped\n", bench->name, cols[s], rows[s], threads[t], error );
+               error = ROX_ERROR_NONE;
+               continue;
+            }
+
+            printf ( "%-30s %5dx%-5d %7d %12.3f %12.3f %12.3f\n", record->name, record->cols, record->rows, record->threads, record->median_ms, record->p10_ms, record->p90_ms );
+            nb_records++;
+         }
+
+         bench->cleanup ( context );
+      }
+
+      rox_image_del ( &image );
+   }
+
+   rox_bench_set_threads ( max_threads );
+
+   error = rox_bench_write_json ( output, warmup, repeat );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   printf ( "\nResults written to %s\n", output );
+
+   if ( baseline )
+   {
+      error = rox_bench_compare_baseline ( &regressions, baseline, tolerance );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      printf ( "\n%d regression(s) with tolerance %.0f%%\n", regressions, 100.0 * tolerance );
+   }
+
+function_terminate:
+   rox_image_del ( &image );
+   rox_timer_del ( &timer );
+
+   if ( error ) { rox_error_print ( error ); return 1; }
+
+   return regressions > 0 ? 2 : 0;
+}
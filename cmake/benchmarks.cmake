@@ -0,0 +1,38 @@
+### BENCHMARKS ####
+
+MESSAGE(STATUS "\n_____ rox_open/cmake/benchmarks.cmake ____________________________________________\n" )
+
+option ( OPENROX_BUILD_BENCHMARKS "Build benchmarks" OFF )
+
+# Results of a previous run of the "benchmark" target, used to detect regressions
+set ( OPENROX_BENCHMARKS_BASELINE "" CACHE FILEPATH "JSON results of a previous benchmark run to compare with" )
+set ( OPENROX_BENCHMARKS_TOLERANCE "0.10" CACHE STRING "Allowed relative slowdown of a benchmark median wrt the baseline" )
+
+if ( OPENROX_BUILD_BENCHMARKS )
+
+   set ( BENCHMARKS_SOURCES_DIR ${OPENROX_SOURCE_DIR}/benchmarks )
+   set ( BENCHMARKS_EXTERNAL_LIBS openrox ${OPENROX_PLUGIN_NAME} ${OPENROX_EXTERNAL_LIBS} )
+
+   if(NOT WIN32)
+      set ( BENCHMARKS_EXTERNAL_LIBS ${BENCHMARKS_EXTERNAL_LIBS} m )
+   endif()
+
+   add_executable ( rox_benchmarks ${BENCHMARKS_SOURCES_DIR}/rox_benchmarks.c )
+   set_target_properties ( rox_benchmarks PROPERTIES FOLDER benchmarks )
+   target_link_libraries ( rox_benchmarks ${BENCHMARKS_EXTERNAL_LIBS} )
+
+   set ( BENCHMARKS_ARGS --output ${CMAKE_BINARY_DIR}/rox_benchmarks.json )
+
+   if ( OPENROX_BENCHMARKS_BASELINE )
+      list ( APPEND BENCHMARKS_ARGS --baseline ${OPENROX_BENCHMARKS_BASELINE} --tolerance ${OPENROX_BENCHMARKS_TOLERANCE} )
+   endif()
+
+   # Run the whole suite, write the JSON results in the build folder and compare with the baseline if any
+   add_custom_target ( benchmark
+      COMMAND rox_benchmarks ${BENCHMARKS_ARGS}
+      DEPENDS rox_benchmarks
+      WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+      COMMENT "Running OpenROX benchmarks"
+      USES_TERMINAL )
+
+endif ()
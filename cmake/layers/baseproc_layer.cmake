@@ -31,6 +31,9 @@ SET (BASEPROC_LAYER_ARRAY_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/svd?mkl?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/svd_jacobi.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/svdsort.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/svd3x3.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/ansi_svd3x3?sse?.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/eigen_symm.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/housebidiag.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/cholesky?mkl?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/gausspivoting.c
@@ -62,12 +65,15 @@ SET (BASEPROC_LAYER_ARRAY_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/array/inverse/inverse.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/inverse/inverse_lu?mkl?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/median/median.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/median/introselect.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/mad/mad.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/mean/mean.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/meanvar/meanvar.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/minmax/minmax.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/maxima/maxima.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/morphological/ansi_morphology?sse,neon?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/morphological/dilate_grayone.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/morphological/morphology.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/multiply/mulmatmat.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/multiply/mulmatmattrans.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/multiply/mulmattransmat.c
@@ -84,6 +90,7 @@ SET (BASEPROC_LAYER_ARRAY_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/array/solve/symm3x3solve.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/solve/svd_solve.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/solve/linsys_solve_cholesky.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/solve/linsys_schur.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/substract/substract.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/tridiagonal/tridiagonal.c
 
@@ -94,6 +101,7 @@ SET (BASEPROC_LAYER_ARRAY_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/array/multiply/ansi_mulmatmat.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/multiply/ansi_mulmattransmat.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/ansi_cholesky.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/array/decomposition/ansi_eigen_symm.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/inverse/ansi_lotinverse.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/error/ansi_ssd.c
    ${BASEPROC_LAYER_SOURCES_DIR}/array/solve/ansi_linsys_solve_cholesky.c
@@ -141,6 +149,11 @@ SET (BASEPROC_LAYER_CALCULUS_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/jacobians/jacobian_row_bundle_matse3_point3d.c
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/jacobians/jacobian_perspective_stereo_calibration.c
 
+   # Shared normal equations accumulator
+   ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/ansi_linsys_accumulator?sse,neon?.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_accumulator.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_steepest_descent.c
+
    # Wrappers for ansi, sse, avx or neon optimisation
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/ansi_linsys_texture_matse3_light_affine_model3d_zi?sse,avx,neon?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_texture_matse3_light_affine_model3d_zi.c
@@ -153,7 +166,6 @@ SET (BASEPROC_LAYER_CALCULUS_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_point_to_line_matse3.c
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_texture_matse3_model3d_zi.c
 
-   ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/ansi_linsys_texture_matsl3_light_affine?neon?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_texture_matsl3_light_affine.c
 
    ${BASEPROC_LAYER_SOURCES_DIR}/calculus/linsys/linsys_weighted_texture_matse3_light_affine_model3d.c
@@ -220,6 +232,7 @@ SET (BASEPROC_LAYER_GEOMETRY_SOURCES
 
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/cadmodel/cadmodel.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/calibration/optimalcalib.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/geometry/connectivity/connected_components.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/connectivity/connectivity.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/disparity/depthfromdisparity.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/point/dynvec_point2d_tools.c
@@ -293,6 +306,7 @@ SET (BASEPROC_LAYER_GEOMETRY_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/distortion/point2d_undistort.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/matsl3/sl3virtualview.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/matsl3/sl3from4points.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/matsl3/ansi_sl3from4points?sse?.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/matsl3/sl3fromNpoints.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/matsl3/sl3normalize.c
    ${BASEPROC_LAYER_SOURCES_DIR}/geometry/transforms/matsl3/sl3interfrom3dpoints.c
@@ -390,6 +404,9 @@ SET (BASEPROC_LAYER_IMAGE_SOURCES
 
    ${BASEPROC_LAYER_SOURCES_DIR}/image/remap/remap_bilinear_nomask_uint_to_uint/remap_bilinear_nomask_uint_to_uint?sse?.c
 
+   ${BASEPROC_LAYER_SOURCES_DIR}/image/remap/remap_bilinear_table/ansi_remap_bilinear_table?sse?.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/image/remap/remap_bilinear_table/remap_bilinear_table.c
+
    ${BASEPROC_LAYER_SOURCES_DIR}/image/remap/remap_ewa_omo/remap_ewa_omo.c
    
    ${BASEPROC_LAYER_SOURCES_DIR}/image/noise/gaussian_noise.c
@@ -418,6 +435,8 @@ SET (BASEPROC_LAYER_IMAGE_SOURCES
    ${BASEPROC_LAYER_SOURCES_DIR}/image/convert/yuv422_to_roxrgba.c
    ${BASEPROC_LAYER_SOURCES_DIR}/image/convert/roxrgba_split.c
    ${BASEPROC_LAYER_SOURCES_DIR}/image/convert/alpha8_to_roxgray.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/image/convert/ansi_ingest?sse?.c
+   ${BASEPROC_LAYER_SOURCES_DIR}/image/convert/frame_ingest.c
 )
 
 SET (BASEPROC_LAYER_MATHS_SOURCES
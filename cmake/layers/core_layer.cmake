@@ -48,6 +48,7 @@ SET (CORE_FEATURES_DESCRIPTORS_SOURCES
    ${OPENROX_BINARY_DIR}/generated/objset_dynvec_fpsm_template.c
    ${CORE_LAYER_SOURCES_DIR}/features/descriptors/brief/brief.c
    ${CORE_LAYER_SOURCES_DIR}/features/descriptors/sraid/sraid.c
+   ${CORE_LAYER_SOURCES_DIR}/features/descriptors/sraid/sraid_workspace.c
    ${CORE_LAYER_SOURCES_DIR}/features/descriptors/sraid/sraiddesc.c
    ${CORE_LAYER_SOURCES_DIR}/features/descriptors/sraid/sraid_match?sse?.c
    ${CORE_LAYER_SOURCES_DIR}/features/descriptors/sraid/sraid_matchset.c
@@ -97,6 +98,7 @@ SET (CORE_FEATURES_DETECTORS_SOURCES
    ${CORE_LAYER_SOURCES_DIR}/features/detectors/corners/gftt.c
    ${CORE_LAYER_SOURCES_DIR}/features/detectors/orientation/orimoments.c
    ${CORE_LAYER_SOURCES_DIR}/features/detectors/checkerboard/checkercorner_detect.c
+   ${CORE_LAYER_SOURCES_DIR}/features/detectors/checkerboard/ansi_checkercorner_response?sse?.c
    ${CORE_LAYER_SOURCES_DIR}/features/detectors/checkerboard/checkerboard_detect.c
    ${CORE_LAYER_SOURCES_DIR}/features/detectors/checkerboard/checkerboard.c
    ${CORE_LAYER_SOURCES_DIR}/features/detectors/edges/canny.c
@@ -174,6 +176,7 @@ SET (CORE_IDENTIFICATION_SOURCES
    ${CORE_LAYER_SOURCES_DIR}/identification/multiident.c
    ${CORE_LAYER_SOURCES_DIR}/identification/photoframe.c
    ${CORE_LAYER_SOURCES_DIR}/identification/codedframe.c
+   ${CORE_LAYER_SOURCES_DIR}/identification/ansi_codedframe_bits?sse?.c
    ${CORE_LAYER_SOURCES_DIR}/identification/dbident_se3.c
    ${CORE_LAYER_SOURCES_DIR}/identification/dbident_sl3.c
 )
@@ -246,6 +249,7 @@ SET (CORE_TRACKING_SOURCES
    ${CORE_LAYER_SOURCES_DIR}/tracking/point/tracking_point.c
    ${CORE_LAYER_SOURCES_DIR}/tracking/point/tracking_point_9x9.c
    ${CORE_LAYER_SOURCES_DIR}/tracking/point/tracking_point_11x11.c
+   ${CORE_LAYER_SOURCES_DIR}/tracking/point/tracking_point_batch.c
 
    # Edge
 
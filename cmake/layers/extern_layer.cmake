@@ -4,6 +4,7 @@ set(EXTERN_SOURCES_DIR ${OPENROX_CODE_DIR}/extern)
 
 set(EXTERN_LAYER_CAD_MODEL
       ${EXTERN_SOURCES_DIR}/caofile/caofile_edges.c
+      ${EXTERN_SOURCES_DIR}/caofile/caofile_visibility.c
 )
 
 #Add sources
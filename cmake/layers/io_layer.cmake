@@ -10,6 +10,10 @@ set(IO_LAYER_IMAGE_SOURCES
       ${IO_SOURCES_DIR}/image/ppm/ppmfile.c
 )
 
+set(IO_LAYER_VIDEO_SOURCES
+      ${IO_SOURCES_DIR}/video/frame_source.c
+)
+
 set(IO_LAYER_MASK_SOURCES
       ${IO_SOURCES_DIR}/mask/pgm/mask_pgmfile.c
 )
@@ -75,9 +79,11 @@ set (IO_LAYER_SERIALIZATION_SOURCES
 )
 
 set (IO_LAYER_SYSTEM_SOURCES
+   ${IO_SOURCES_DIR}/system/arena_print.c
    ${IO_SOURCES_DIR}/system/errors_print.c
    ${IO_SOURCES_DIR}/system/memory_print.c
    ${IO_SOURCES_DIR}/system/print.c
+   ${IO_SOURCES_DIR}/system/log_sink.c
    ${IO_SOURCES_DIR}/system/file.c
 )
 
@@ -13,6 +13,7 @@ SET (SYSTEM_LAYER_BASE_SOURCES
    ${SYSTEM_LAYER_SOURCES_DIR}/memory/datatypes.c
    ${SYSTEM_LAYER_SOURCES_DIR}/memory/array.c
    ${SYSTEM_LAYER_SOURCES_DIR}/memory/array2d.c
+   ${SYSTEM_LAYER_SOURCES_DIR}/memory/arena.c
 
    # Version
    ${SYSTEM_LAYER_SOURCES_DIR}/version/version.c
@@ -30,6 +31,7 @@ SET (SYSTEM_LAYER_BASE_SOURCES
    # Generated Dynvec
    ${OPENROX_BINARY_DIR}/generated/dynvec_uint.c
    ${OPENROX_BINARY_DIR}/generated/dynvec_sint.c
+   ${OPENROX_BINARY_DIR}/generated/dynvec_slint.c
    ${OPENROX_BINARY_DIR}/generated/dynvec_double.c
    ${OPENROX_BINARY_DIR}/generated/dynvec_sparse_value.c
    ${OPENROX_BINARY_DIR}/generated/dynvec_array2d.c
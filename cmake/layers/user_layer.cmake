@@ -73,6 +73,7 @@ SET (USER_LAYER_TRACKING_SOURCES
 
 SET (USER_LAYER_MOTION_DETECTION_SOURCES
    ${USER_LAYER_SOURCES_DIR}/detection/motion/motion_detection.c
+   ${USER_LAYER_SOURCES_DIR}/detection/motion/ansi_motion_detection?sse?.c
    ${USER_LAYER_SOURCES_DIR}/detection/motion/cluster.c
    ${USER_LAYER_SOURCES_DIR}/detection/rectangle/rectangle_detection.c
    ${USER_LAYER_SOURCES_DIR}/detection/plane/plane_detection.c
@@ -80,6 +81,8 @@ SET (USER_LAYER_MOTION_DETECTION_SOURCES
 )
 
 #Add sources
+replace_platform_optimization(USER_LAYER_MOTION_DETECTION_SOURCES)
+
 SET (USER_LAYER_SOURCES
    ${USER_LAYER_CALIBRATION_SOURCES}
    ${USER_LAYER_IDENTIFICATION_SOURCES}
@@ -42,6 +42,9 @@ include(${OPENROX_CMAKE_DIR}/tests.cmake)
 # Examples for library
 include(${OPENROX_CMAKE_DIR}/examples.cmake)
 
+# Benchmarks for library
+include(${OPENROX_CMAKE_DIR}/benchmarks.cmake)
+
 # Output parameters for release
 include(${OPENROX_CMAKE_DIR}/install/install.cmake)
 
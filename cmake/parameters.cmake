@@ -25,6 +25,9 @@ option(OPENROX_VERBOSE_MEMORY                    "display rox_memory calls"
 
 option(OPENROX_LOGS 							          "enable rox_log" 										             ON)
 
+# Minimum severity of the ROX_LOG_* messages kept at compile time (0 debug, 1 info, 2 warning, 3 error, 4 none)
+set(OPENROX_LOG_COMPILED_LEVEL "0" CACHE STRING "minimum severity of the compiled log messages")
+
 #cmake_dependent_option(OPENROX_CREATE_MANUAL_PROG "Use Doxygen to create the HTML based API documentation"  OFF OPENROX_BUILD_RELEASE ON)
 #cmake_dependent_option(OPENROX_CREATE_MANUAL_USER "Use pdflatex to build the user manual"                   OFF OPENROX_BUILD_RELEASE ON)
 
@@ -49,6 +52,8 @@ if (OPENROX_LOGS)
    add_definitions(-DROX_LOGS)
 endif()
 
+add_definitions(-DROX_LOG_COMPILED_LEVEL=${OPENROX_LOG_COMPILED_LEVEL})
+
 if(OPENROX_VERBOSE_DISPLAY)
    message("OPENROX_VERBOSE_DISPLAY: " ${OPENROX_VERBOSE_DISPLAY})
 endif()
@@ -45,6 +45,7 @@ if ( OPENROX_BUILD_TESTS )
 
    unit_test_macro ( system/memory                          test_array )
    unit_test_macro ( system/memory                          test_array2d )
+   unit_test_macro ( system/memory                          test_arena )
    unit_test_macro ( system/memory                          test_memory )
    unit_test_macro ( system/version                         test_version )
 
@@ -72,6 +73,8 @@ endif ()
    unit_test_macro ( baseproc/array/determinant              test_determinant                                              )
    unit_test_macro ( baseproc/array/decomposition            test_decomposition_cholesky                                   )
    unit_test_macro ( baseproc/array/decomposition            test_decomposition_svd                                        )
+   unit_test_macro ( baseproc/array/decomposition            test_decomposition_svd3x3                                     )
+   unit_test_macro ( baseproc/array/decomposition            test_decomposition_eigen_symm                                 )
 
    unit_test_macro ( baseproc/array/eigenv                   test_real_eigenvalues_eigenvectors                            )
 
@@ -93,8 +96,10 @@ endif ()
    unit_test_macro ( baseproc/array/mean                     test_mean                                                     )
    unit_test_macro ( baseproc/array/meanvar                  test_meanvar                                                  )
    unit_test_macro ( baseproc/array/median                   test_median                                                   )
+   unit_test_macro ( baseproc/array/median                   test_introselect                                              )
    unit_test_macro ( baseproc/array/minmax                   test_minmax                                                   )
    unit_test_macro ( baseproc/array/morphological            test_dilate_grayone                                           )
+   unit_test_macro ( baseproc/array/morphological            test_morphology                                               )
    unit_test_macro ( baseproc/array/multiply                 test_mulmatmat                                                )
    unit_test_macro ( baseproc/array/multiply                 test_mulmatmattrans                                           )
    unit_test_macro ( baseproc/array/multiply                 test_mulmattransmat                                           )
@@ -107,6 +112,7 @@ endif ()
    unit_test_macro ( baseproc/array/scale                    test_scale                                                    )
    unit_test_macro ( baseproc/array/solve                    test_svd_solve                                                )
    unit_test_macro ( baseproc/array/solve                    test_linsys_solve_cholesky                                    )
+   unit_test_macro ( baseproc/array/solve                    test_linsys_schur                                             )
    unit_test_macro ( baseproc/array/solve                    test_symm3x3_solve                                            )
    unit_test_macro ( baseproc/array/substract                test_substract                                                )
    unit_test_macro ( baseproc/array/transpose                test_transpose                                                )
@@ -130,6 +136,8 @@ endif ()
    unit_test_macro ( baseproc/calculus/linsys                test_linsys_se3_z1_light_affine_premul_left                   )
    unit_test_macro ( baseproc/calculus/linsys                test_linsys_stereo_point2d_pix_matse3_weighted                )
 
+   unit_test_macro ( baseproc/calculus/linsys                test_linsys_accumulator                                       )
+   unit_test_macro ( baseproc/calculus/linsys                test_linsys_steepest_descent                                  )
    unit_test_macro ( baseproc/calculus/linsys                test_linsys_weighted_texture_matse3_light_affine_model3d_zi   )
    unit_test_macro ( baseproc/calculus/linsys                test_linsys_weighted_texture_matse3_light_affine_model3d      )
    unit_test_macro ( baseproc/calculus/linsys                test_linsys_texture_matse3_model3d_zi                         )
@@ -151,6 +159,7 @@ endif ()
 
    unit_test_macro ( baseproc/geometry/calibration           test_optimalcalib                                             )
    unit_test_macro ( baseproc/geometry/connectivity          test_connectivity                                             )
+   unit_test_macro ( baseproc/geometry/connectivity          test_connected_components                                     )
    unit_test_macro ( baseproc/geometry/disparity             test_depthfromdisparity                                       )
    
    unit_test_macro ( baseproc/geometry/segment               test_segment2d                                                )
@@ -198,6 +207,7 @@ endif ()
    unit_test_macro ( baseproc/image/convert                  test_roxrgba_to_roxgray                        )
    unit_test_macro ( baseproc/image/convert                  test_roxgray_to_gray                           )
    unit_test_macro ( baseproc/image/convert                  test_roxgray_uchar_to_roxgray_float            )
+   unit_test_macro ( baseproc/image/convert                  test_frame_ingest                              )
    unit_test_macro ( baseproc/image/convolve                 test_basic_convolve                            )
    unit_test_macro ( baseproc/image/convolve                 test_sparse_convolve                           )
    unit_test_macro ( baseproc/image/convolve                 test_symm_convolve                             )
@@ -217,6 +227,7 @@ endif ()
    unit_test_macro ( baseproc/image/remap                    test_remap_bilinear_onepixel                   )
    unit_test_macro ( baseproc/image/remap                    test_remap_bilinear_trans                      )
    unit_test_macro ( baseproc/image/remap                    test_remap_bilinear_nomask_float_to_float_doubled )
+   unit_test_macro ( baseproc/image/remap                    test_remap_bilinear_table                      )
    unit_test_macro ( baseproc/image/remap                    test_remap_ewa_omo                             )
    unit_test_macro ( baseproc/image/remap                    test_remap_box_halved                          )
    unit_test_macro ( baseproc/image/remap                    test_remap_box_mask_halved                     )
@@ -379,6 +390,7 @@ endif ()
    unit_test_macro ( core/tracking/point                    test_tracking_point_11x11 )
    unit_test_macro ( core/tracking/point                    test_tracking_point_9x9 )
    unit_test_macro ( core/tracking/point                    test_tracking_point )
+   unit_test_macro ( core/tracking/point                    test_tracking_point_batch )
    unit_test_macro ( core/tracking/edge                     test_search_edge )
    unit_test_macro ( core/tracking/edge                     test_scan_scale_angle_matrix )
    unit_test_macro ( core/tracking/edge                     test_find_closest_scale_above_threshold_angle_isinrange )
@@ -398,13 +410,17 @@ endif ()
 
    unit_test_macro ( inout/mask/fill                        test_set_polygon )
 
+   unit_test_macro ( inout/video                            test_frame_source )
+
    unit_test_macro ( inout/system                           test_file )
+   unit_test_macro ( inout/system                           test_log_sink )
 
    #################################################################################################
    ## Test user layer
    #################################################################################################
 
    unit_test_macro ( user/calibration/camproj               test_calibration_camproj_checkerboard     )
+   unit_test_macro ( user/calibration/mono                  test_camera_calibration_checkerboard      )
 
    unit_test_macro ( user/identification/database           test_database                             )
    unit_test_macro ( user/identification/database           test_database_item                        )
@@ -421,6 +437,8 @@ endif ()
 
    unit_test_macro ( user/tracking                          test_tracking_database                    )
 
+   unit_test_macro ( user/detection/motion                  test_motion_detection                     )
+
    unit_test_macro ( user/sensor/camera                     test_camera                               )
 
    unit_test_macro ( user/odometry/plane                    test_odometry_single_plane                )
@@ -433,5 +451,7 @@ endif ()
    ## Test extern layer
    #################################################################################################
 
+   unit_test_macro ( extern/caofile                         test_caofile_edges                        )
+
 endif ()
 
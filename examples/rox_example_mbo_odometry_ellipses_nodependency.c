@@ -157,6 +157,8 @@
 #define MIN_SEGMENT_SIZE   11
 
 #define THRESHOLD          51 // 51 = 4*255*0.05 where 4 = normalization sobel mask, 255 = max grayscale level, 0.05 threshold
+#define VISIBILITY_MAX_TRANSLATION 1e-3 // Pose change under which the visible primitives of the model are kept
+#define VISIBILITY_MAX_ROTATION    1e-3
 
 int main(int argc, char *argv[])
 {
@@ -217,6 +219,13 @@ int main(int argc, char *argv[])
    error = rox_caofile_edges_load_cao(caofile, filename);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   // Cull the primitives out of the image or hidden by the model faces
+   error = rox_caofile_edges_set_image_size(caofile, IMG_WIDTH, IMG_HEIGHT);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_caofile_edges_set_visibility_coherence(caofile, VISIBILITY_MAX_TRANSLATION, VISIBILITY_MAX_ROTATION);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    //printf("Press enter when ready\n");
    //getchar();
 
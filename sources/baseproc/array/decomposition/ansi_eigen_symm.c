@@ -0,0 +1,126 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_eigen_symm.c
+//
+//    Contents  : Implementation of ansi eigen_symm module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_eigen_symm.h"
+
+#include <math.h>
+#include <float.h>
+
+// The size is a constant at each call site of the dispatcher, so the loops are unrolled for the fixed sizes
+static inline void rox_ansi_eigen_symm_jacobi (
+   double * eigenvalues,
+   double * eigenvectors,
+   const double * S,
+   const int n
+)
+{
+   double N[ROX_EIGEN_SYMM_MAX_SIZE][ROX_EIGEN_SYMM_MAX_SIZE];
+   double V[ROX_EIGEN_SYMM_MAX_SIZE][ROX_EIGEN_SYMM_MAX_SIZE];
+
+   for ( int p = 0; p < n; p++ )
+   {
+      for ( int q = 0; q < n; q++ )
+      {
+         N[p][q] = ( p <= q ) ? S[p * n + q] : S[q * n + p];
+         V[p][q] = ( p == q ) ? 1.0 : 0.0;
+      }
+   }
+
+   for ( int sweep = 0; sweep < ROX_EIGEN_SYMM_MAX_SWEEPS; sweep++ )
+   {
+      double off = 0.0, diag = 0.0;
+
+      for ( int p = 0; p < n; p++ )
+      {
+         diag += N[p][p] * N[p][p];
+         for ( int q = p + 1; q < n; q++ ) off += N[p][q] * N[p][q];
+      }
+
+      if ( off <= DBL_EPSILON * DBL_EPSILON * diag ) break;
+
+      for ( int p = 0; p < n - 1; p++ )
+      {
+         for ( int q = p + 1; q < n; q++ )
+         {
+            if ( N[p][q] == 0.0 ) continue;
+
+            // Rotation which cancels N[p][q]
+            const double theta = ( N[q][q] - N[p][p] ) / ( 2.0 * N[p][q] );
+            const double t = copysign ( 1.0, theta ) / ( fabs ( theta ) + sqrt ( theta * theta + 1.0 ) );
+            const double c = 1.0 / sqrt ( t * t + 1.0 );
+            const double s = t * c;
+
+            for ( int k = 0; k < n; k++ )
+            {
+               const double a = N[k][p], b = N[k][q];
+               N[k][p] = c * a - s * b;
+               N[k][q] = s * a + c * b;
+            }
+
+            for ( int k = 0; k < n; k++ )
+            {
+               const double a = N[p][k], b = N[q][k];
+               N[p][k] = c * a - s * b;
+               N[q][k] = s * a + c * b;
+            }
+
+            for ( int k = 0; k < n; k++ )
+            {
+               const double a = V[k][p], b = V[k][q];
+               V[k][p] = c * a - s * b;
+               V[k][q] = s * a + c * b;
+            }
+         }
+      }
+   }
+
+   // Sort the eigenvalues in decreasing order
+   int order[ROX_EIGEN_SYMM_MAX_SIZE];
+   for ( int k = 0; k < n; k++ ) order[k] = k;
+
+   for ( int i = 1; i < n; i++ )
+   {
+      const int id = order[i];
+      int j = i;
+      for ( ; j > 0 && N[order[j - 1]][order[j - 1]] < N[id][id]; j-- ) order[j] = order[j - 1];
+      order[j] = id;
+   }
+
+   for ( int k = 0; k < n; k++ )
+   {
+      eigenvalues[k] = N[order[k]][order[k]];
+      for ( int i = 0; i < n; i++ ) eigenvectors[i * n + k] = V[i][order[k]];
+   }
+}
+
+int rox_ansi_array_double_eigen_symm (
+   double * eigenvalues,
+   double * eigenvectors,
+   const double * S,
+   const int size
+)
+{
+   switch ( size )
+   {
+      case 3: rox_ansi_eigen_symm_jacobi ( eigenvalues, eigenvectors, S, 3 ); break;
+      case 4: rox_ansi_eigen_symm_jacobi ( eigenvalues, eigenvectors, S, 4 ); break;
+      case 9: rox_ansi_eigen_symm_jacobi ( eigenvalues, eigenvectors, S, 9 ); break;
+      default:
+         if ( size < 1 || size > ROX_EIGEN_SYMM_MAX_SIZE ) return 4;
+         rox_ansi_eigen_symm_jacobi ( eigenvalues, eigenvectors, S, size );
+         break;
+   }
+
+   return 0;
+}
@@ -0,0 +1,37 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_eigen_symm.h
+//
+//    Contents  : API of ansi eigen_symm module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ANSI_EIGEN_SYMM__
+#define __OPENROX_ANSI_EIGEN_SYMM__
+
+//! The maximal size of the symmetric matrices decomposed on the stack
+#define ROX_EIGEN_SYMM_MAX_SIZE 9
+
+//! The maximal number of Jacobi sweeps (the convergence is quadratic, small matrices need less than 10 sweeps)
+#define ROX_EIGEN_SYMM_MAX_SWEEPS 50
+
+//! Compute the eigen decomposition S = V * diag(D) * V^T of a small symmetric matrix with the cyclic Jacobi method
+//! \param  [out]  eigenvalues    The size eigenvalues sorted in decreasing order
+//! \param  [out]  eigenvectors   The size * size row major orthogonal matrix V, the column k is the eigenvector of the eigenvalue k
+//! \param  [in ]  S              The size * size row major symmetric matrix (only the upper triangle is read)
+//! \param  [in ]  size           The size of the matrix, lower or equal to ROX_EIGEN_SYMM_MAX_SIZE
+//! \return 0, or 4 if the size is not valid
+int rox_ansi_array_double_eigen_symm (
+   double * eigenvalues,
+   double * eigenvectors,
+   const double * S,
+   const int size
+);
+
+#endif // __OPENROX_ANSI_EIGEN_SYMM__
@@ -0,0 +1,169 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_svd3x3.c
+//
+//    Contents  : Implementation of ansi svd3x3 module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_svd3x3.h"
+
+#include <math.h>
+#include <float.h>
+
+// Rotate the columns p and q of B = A * V (and of V) to make them orthogonal
+static void rox_ansi_svd3x3_rotate ( double b[3][3], double v[3][3], const int p, const int q )
+{
+   const double alpha = b[p][0] * b[p][0] + b[p][1] * b[p][1] + b[p][2] * b[p][2];
+   const double beta  = b[q][0] * b[q][0] + b[q][1] * b[q][1] + b[q][2] * b[q][2];
+   const double gamma = b[p][0] * b[q][0] + b[p][1] * b[q][1] + b[p][2] * b[q][2];
+   const double tau = beta - alpha;
+
+   // t = tan(theta) is the smallest root of gamma * t^2 + tau * t - gamma = 0, without branch and without overflow for gamma = 0
+   const double t = ( 2.0 * gamma ) * copysign ( 1.0, tau ) / ( fabs ( tau ) + sqrt ( tau * tau + 4.0 * gamma * gamma ) + DBL_MIN );
+   const double c = 1.0 / sqrt ( 1.0 + t * t );
+   const double s = t * c;
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      const double x = b[p][k], y = b[q][k];
+      b[p][k] = c * x - s * y;
+      b[q][k] = s * x + c * y;
+   }
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      const double x = v[p][k], y = v[q][k];
+      v[p][k] = c * x - s * y;
+      v[q][k] = s * x + c * y;
+   }
+}
+
+// Order the columns p < q by decreasing norms, one column is negated to keep det(V) = 1
+static void rox_ansi_svd3x3_sort ( double b[3][3], double v[3][3], double n[3], const int p, const int q )
+{
+   if ( n[p] < n[q] )
+   {
+      for ( int k = 0; k < 3; k++ )
+      {
+         const double x = b[p][k], y = v[p][k];
+         b[p][k] = b[q][k]; b[q][k] = -x;
+         v[p][k] = v[q][k]; v[q][k] = -y;
+      }
+
+      const double x = n[p]; n[p] = n[q]; n[q] = x;
+   }
+}
+
+static void rox_ansi_svd3x3 ( double * U, double * S, double * V, const double * A )
+{
+   double b[3][3], v[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+   double u[3][3], n[3];
+   double scale = 0.0;
+
+   // Scale the matrix to avoid overflows in the squared norms
+   for ( int k = 0; k < 9; k++ ) scale = fmax ( scale, fabs ( A[k] ) );
+   scale = scale + DBL_MIN;
+
+   // The columns of B
+   for ( int i = 0; i < 3; i++ )
+   {
+      for ( int k = 0; k < 3; k++ )
+      {
+         b[k][i] = A[i * 3 + k] / scale;
+      }
+   }
+
+   for ( int sweep = 0; sweep < ROX_SVD3X3_SWEEPS; sweep++ )
+   {
+      rox_ansi_svd3x3_rotate ( b, v, 0, 1 );
+      rox_ansi_svd3x3_rotate ( b, v, 0, 2 );
+      rox_ansi_svd3x3_rotate ( b, v, 1, 2 );
+   }
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      n[k] = sqrt ( b[k][0] * b[k][0] + b[k][1] * b[k][1] + b[k][2] * b[k][2] );
+   }
+
+   rox_ansi_svd3x3_sort ( b, v, n, 0, 1 );
+   rox_ansi_svd3x3_sort ( b, v, n, 0, 2 );
+   rox_ansi_svd3x3_sort ( b, v, n, 1, 2 );
+
+   // The left singular vectors of the null singular values complete the basis
+   const double tolerance = DBL_EPSILON * n[0];
+
+   if ( n[0] > 0.0 )
+   {
+      for ( int k = 0; k < 3; k++ ) u[0][k] = b[0][k] / n[0];
+   }
+   else
+   {
+      u[0][0] = 1.0; u[0][1] = 0.0; u[0][2] = 0.0;
+   }
+
+   if ( n[1] > tolerance )
+   {
+      for ( int k = 0; k < 3; k++ ) u[1][k] = b[1][k] / n[1];
+   }
+   else
+   {
+      double w[3];
+
+      if ( fabs ( u[0][0] ) > fabs ( u[0][2] ) )
+      {
+         w[0] = -u[0][1]; w[1] = u[0][0]; w[2] = 0.0;
+      }
+      else
+      {
+         w[0] = 0.0; w[1] = -u[0][2]; w[2] = u[0][1];
+      }
+
+      const double norm = sqrt ( w[0] * w[0] + w[1] * w[1] + w[2] * w[2] );
+      for ( int k = 0; k < 3; k++ ) u[1][k] = w[k] / norm;
+   }
+
+   if ( n[2] > tolerance )
+   {
+      for ( int k = 0; k < 3; k++ ) u[2][k] = b[2][k] / n[2];
+   }
+   else
+   {
+      u[2][0] = u[0][1] * u[1][2] - u[0][2] * u[1][1];
+      u[2][1] = u[0][2] * u[1][0] - u[0][0] * u[1][2];
+      u[2][2] = u[0][0] * u[1][1] - u[0][1] * u[1][0];
+   }
+
+   for ( int i = 0; i < 3; i++ )
+   {
+      S[i] = n[i] * scale;
+
+      for ( int k = 0; k < 3; k++ )
+      {
+         U[i * 3 + k] = u[k][i];
+         V[i * 3 + k] = v[k][i];
+      }
+   }
+}
+
+int rox_ansi_array_double_svd3x3_batch (
+   double * U,
+   double * S,
+   double * V,
+   const double * A,
+   const int count
+)
+{
+   for ( int m = 0; m < count; m++ )
+   {
+      rox_ansi_svd3x3 ( &U[9 * m], &S[3 * m], &V[9 * m], &A[9 * m] );
+   }
+
+   return 0;
+}
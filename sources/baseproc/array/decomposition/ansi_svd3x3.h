@@ -0,0 +1,36 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_svd3x3.h
+//
+//    Contents  : API of ansi svd3x3 module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ANSI_SVD3X3__
+#define __OPENROX_ANSI_SVD3X3__
+
+//! The number of one-sided Jacobi sweeps of the 3x3 svd (the columns are orthogonal to the double precision after 4 sweeps)
+#define ROX_SVD3X3_SWEEPS 5
+
+//! Compute the singular values decompositions A = U * diag(S) * V^T of a batch of 3x3 matrices with the one-sided Jacobi method
+//! The ansi version and the sse version share the same interface and give the same results
+
+//! U      : 9 * count doubles, the row major orthogonal matrices of the left singular vectors
+//! S      : 3 * count doubles, the singular values sorted in decreasing order
+//! V      : 9 * count doubles, the row major rotation matrices (det = 1) of the right singular vectors
+//! A      : 9 * count doubles, the row major matrices to decompose
+int rox_ansi_array_double_svd3x3_batch (
+   double * U,
+   double * S,
+   double * V,
+   const double * A,
+   const int count
+);
+
+#endif // __OPENROX_ANSI_SVD3X3__
@@ -0,0 +1,191 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_svd3x3_sse.c
+//
+//    Contents  : Implementation of svd3x3 module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_svd3x3.h"
+
+#include <math.h>
+#include <float.h>
+#include <system/vectorisation/sse.h>
+
+// Select a where the mask is set and b elsewhere
+static __m128d rox_sse_svd3x3_select ( const __m128d mask, const __m128d a, const __m128d b )
+{
+   return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+// Same operations order as rox_ansi_svd3x3_rotate, for two matrices
+static void rox_sse_svd3x3_rotate ( __m128d b[3][3], __m128d v[3][3], const int p, const int q )
+{
+   const __m128d sign = _mm_set1_pd(-0.0);
+   const __m128d one = _mm_set1_pd(1.0);
+
+   const __m128d alpha = _mm_add_pd(_mm_add_pd(_mm_mul_pd(b[p][0], b[p][0]), _mm_mul_pd(b[p][1], b[p][1])), _mm_mul_pd(b[p][2], b[p][2]));
+   const __m128d beta  = _mm_add_pd(_mm_add_pd(_mm_mul_pd(b[q][0], b[q][0]), _mm_mul_pd(b[q][1], b[q][1])), _mm_mul_pd(b[q][2], b[q][2]));
+   const __m128d gamma = _mm_add_pd(_mm_add_pd(_mm_mul_pd(b[p][0], b[q][0]), _mm_mul_pd(b[p][1], b[q][1])), _mm_mul_pd(b[p][2], b[q][2]));
+   const __m128d tau = _mm_sub_pd(beta, alpha);
+
+   const __m128d num = _mm_xor_pd(_mm_mul_pd(_mm_set1_pd(2.0), gamma), _mm_and_pd(tau, sign));
+   const __m128d root = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(tau, tau), _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(4.0), gamma), gamma)));
+   const __m128d den = _mm_add_pd(_mm_add_pd(_mm_andnot_pd(sign, tau), root), _mm_set1_pd(DBL_MIN));
+   const __m128d t = _mm_div_pd(num, den);
+   const __m128d c = _mm_div_pd(one, _mm_sqrt_pd(_mm_add_pd(one, _mm_mul_pd(t, t))));
+   const __m128d s = _mm_mul_pd(t, c);
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      const __m128d x = b[p][k], y = b[q][k];
+      b[p][k] = _mm_sub_pd(_mm_mul_pd(c, x), _mm_mul_pd(s, y));
+      b[q][k] = _mm_add_pd(_mm_mul_pd(s, x), _mm_mul_pd(c, y));
+   }
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      const __m128d x = v[p][k], y = v[q][k];
+      v[p][k] = _mm_sub_pd(_mm_mul_pd(c, x), _mm_mul_pd(s, y));
+      v[q][k] = _mm_add_pd(_mm_mul_pd(s, x), _mm_mul_pd(c, y));
+   }
+}
+
+// Same as rox_ansi_svd3x3_sort, the swap is done by selection in each lane
+static void rox_sse_svd3x3_sort ( __m128d b[3][3], __m128d v[3][3], __m128d n[3], const int p, const int q )
+{
+   const __m128d sign = _mm_set1_pd(-0.0);
+   const __m128d swap = _mm_cmplt_pd(n[p], n[q]);
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      const __m128d x = b[p][k], y = v[p][k];
+      b[p][k] = rox_sse_svd3x3_select(swap, b[q][k], x);
+      b[q][k] = rox_sse_svd3x3_select(swap, _mm_xor_pd(x, sign), b[q][k]);
+      v[p][k] = rox_sse_svd3x3_select(swap, v[q][k], y);
+      v[q][k] = rox_sse_svd3x3_select(swap, _mm_xor_pd(y, sign), v[q][k]);
+   }
+
+   const __m128d x = n[p];
+   n[p] = rox_sse_svd3x3_select(swap, n[q], x);
+   n[q] = rox_sse_svd3x3_select(swap, x, n[q]);
+}
+
+// Decompose two matrices, the matrix of the second lane is A1
+static void rox_sse_svd3x3 ( double * U0, double * S0, double * V0, double * U1, double * S1, double * V1, const double * A0, const double * A1 )
+{
+   const __m128d sign = _mm_set1_pd(-0.0);
+   const __m128d zero = _mm_setzero_pd();
+   const __m128d one = _mm_set1_pd(1.0);
+
+   __m128d a[9], b[3][3], v[3][3], u[3][3], n[3], w[3];
+   __m128d scale = zero;
+
+   for ( int k = 0; k < 9; k++ )
+   {
+      a[k] = _mm_set_pd(A1[k], A0[k]);
+      scale = _mm_max_pd(scale, _mm_andnot_pd(sign, a[k]));
+   }
+   scale = _mm_add_pd(scale, _mm_set1_pd(DBL_MIN));
+
+   for ( int i = 0; i < 3; i++ )
+   {
+      for ( int k = 0; k < 3; k++ )
+      {
+         b[k][i] = _mm_div_pd(a[i * 3 + k], scale);
+         v[k][i] = ( i == k ) ? one : zero;
+      }
+   }
+
+   for ( int sweep = 0; sweep < ROX_SVD3X3_SWEEPS; sweep++ )
+   {
+      rox_sse_svd3x3_rotate ( b, v, 0, 1 );
+      rox_sse_svd3x3_rotate ( b, v, 0, 2 );
+      rox_sse_svd3x3_rotate ( b, v, 1, 2 );
+   }
+
+   for ( int k = 0; k < 3; k++ )
+   {
+      n[k] = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(b[k][0], b[k][0]), _mm_mul_pd(b[k][1], b[k][1])), _mm_mul_pd(b[k][2], b[k][2])));
+   }
+
+   rox_sse_svd3x3_sort ( b, v, n, 0, 1 );
+   rox_sse_svd3x3_sort ( b, v, n, 0, 2 );
+   rox_sse_svd3x3_sort ( b, v, n, 1, 2 );
+
+   // The left singular vectors of the null singular values complete the basis
+   const __m128d tolerance = _mm_mul_pd(_mm_set1_pd(DBL_EPSILON), n[0]);
+
+   const __m128d valid0 = _mm_cmpgt_pd(n[0], zero);
+   for ( int k = 0; k < 3; k++ )
+   {
+      u[0][k] = rox_sse_svd3x3_select(valid0, _mm_div_pd(b[0][k], n[0]), ( k == 0 ) ? one : zero);
+   }
+
+   const __m128d first = _mm_cmpgt_pd(_mm_andnot_pd(sign, u[0][0]), _mm_andnot_pd(sign, u[0][2]));
+   w[0] = rox_sse_svd3x3_select(first, _mm_xor_pd(u[0][1], sign), zero);
+   w[1] = rox_sse_svd3x3_select(first, u[0][0], _mm_xor_pd(u[0][2], sign));
+   w[2] = rox_sse_svd3x3_select(first, zero, u[0][1]);
+   const __m128d norm = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(w[0], w[0]), _mm_mul_pd(w[1], w[1])), _mm_mul_pd(w[2], w[2])));
+
+   const __m128d valid1 = _mm_cmpgt_pd(n[1], tolerance);
+   for ( int k = 0; k < 3; k++ )
+   {
+      u[1][k] = rox_sse_svd3x3_select(valid1, _mm_div_pd(b[1][k], n[1]), _mm_div_pd(w[k], norm));
+   }
+
+   const __m128d valid2 = _mm_cmpgt_pd(n[2], tolerance);
+   w[0] = _mm_sub_pd(_mm_mul_pd(u[0][1], u[1][2]), _mm_mul_pd(u[0][2], u[1][1]));
+   w[1] = _mm_sub_pd(_mm_mul_pd(u[0][2], u[1][0]), _mm_mul_pd(u[0][0], u[1][2]));
+   w[2] = _mm_sub_pd(_mm_mul_pd(u[0][0], u[1][1]), _mm_mul_pd(u[0][1], u[1][0]));
+   for ( int k = 0; k < 3; k++ )
+   {
+      u[2][k] = rox_sse_svd3x3_select(valid2, _mm_div_pd(b[2][k], n[2]), w[k]);
+   }
+
+   for ( int i = 0; i < 3; i++ )
+   {
+      const __m128d singular = _mm_mul_pd(n[i], scale);
+      _mm_storel_pd(&S0[i], singular);
+      _mm_storeh_pd(&S1[i], singular);
+
+      for ( int k = 0; k < 3; k++ )
+      {
+         _mm_storel_pd(&U0[i * 3 + k], u[k][i]);
+         _mm_storeh_pd(&U1[i * 3 + k], u[k][i]);
+         _mm_storel_pd(&V0[i * 3 + k], v[k][i]);
+         _mm_storeh_pd(&V1[i * 3 + k], v[k][i]);
+      }
+   }
+}
+
+int rox_ansi_array_double_svd3x3_batch (
+   double * U,
+   double * S,
+   double * V,
+   const double * A,
+   const int count
+)
+{
+   int m = 0;
+
+   for ( m = 0; m + 1 < count; m += 2 )
+   {
+      rox_sse_svd3x3 ( &U[9 * m], &S[3 * m], &V[9 * m], &U[9 * (m + 1)], &S[3 * (m + 1)], &V[9 * (m + 1)], &A[9 * m], &A[9 * (m + 1)] );
+   }
+
+   // The last matrix of an odd batch is decomposed in both lanes
+   if ( m < count )
+   {
+      double Ut[9], St[3], Vt[9];
+      rox_sse_svd3x3 ( &U[9 * m], &S[3 * m], &V[9 * m], Ut, St, Vt, &A[9 * m], &A[9 * m] );
+   }
+
+   return 0;
+}
@@ -0,0 +1,101 @@
+//==============================================================================
+//
+//    OPENROX   : File eigen_symm.c
+//
+//    Contents  : Implementation of eigen_symm module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "eigen_symm.h"
+#include "ansi_eigen_symm.h"
+
+#include <inout/system/errors_print.h>
+
+Rox_ErrorCode rox_array_double_eigen_symm3x3 (
+   Rox_Double eigenvalues[3],
+   Rox_Double eigenvectors[9],
+   const Rox_Double S[9]
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !eigenvalues || !eigenvectors || !S )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_ansi_array_double_eigen_symm ( eigenvalues, eigenvectors, S, 3 );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_array_double_eigen_symm4x4 (
+   Rox_Double eigenvalues[4],
+   Rox_Double eigenvectors[16],
+   const Rox_Double S[16]
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !eigenvalues || !eigenvectors || !S )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_ansi_array_double_eigen_symm ( eigenvalues, eigenvectors, S, 4 );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_array_double_eigen_symm9x9 (
+   Rox_Double eigenvalues[9],
+   Rox_Double eigenvectors[81],
+   const Rox_Double S[81]
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !eigenvalues || !eigenvectors || !S )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_ansi_array_double_eigen_symm ( eigenvalues, eigenvectors, S, 9 );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_array_double_eigen_symm_batch (
+   Rox_Double * eigenvalues,
+   Rox_Double * eigenvectors,
+   const Rox_Double * S,
+   const Rox_Sint size,
+   const Rox_Sint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !eigenvalues || !eigenvectors || !S )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( size < 1 || size > ROX_EIGEN_SYMM_MAX_SIZE )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( count < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // The Jacobi iterations branch on the convergence, so the matrices are shared between the threads rather than the SIMD lanes
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint m = 0; m < count; m++ )
+   {
+      rox_ansi_array_double_eigen_symm ( &eigenvalues[size * m], &eigenvectors[size * size * m], &S[size * size * m], size );
+   }
+
+function_terminate:
+   return error;
+}
@@ -0,0 +1,79 @@
+//==============================================================================
+//
+//    OPENROX   : File eigen_symm.h
+//
+//    Contents  : API of eigen_symm module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_EIGEN_SYMM__
+#define __OPENROX_EIGEN_SYMM__
+
+#include <system/arch/compiler.h>
+#include <system/memory/datatypes.h>
+#include <system/errors/errors.h>
+
+//! \ingroup  Linalg
+//! \defgroup Eigen_Symm Eigen_Symm
+//! \brief Eigen decomposition of small symmetric matrices without memory allocation.
+
+//! \addtogroup Eigen_Symm
+//! @{
+
+//! Compute the eigen decomposition S = V * diag(D) * V^T of a 3x3 symmetric matrix
+//! \param  [out]  eigenvalues    The 3 eigenvalues D sorted in decreasing order
+//! \param  [out]  eigenvectors   The row major orthogonal matrix V, the column k is the eigenvector of the eigenvalue k
+//! \param  [in ]  S              The row major symmetric matrix (only the upper triangle is read)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array_double_eigen_symm3x3 (
+   Rox_Double eigenvalues[3],
+   Rox_Double eigenvectors[9],
+   const Rox_Double S[9]
+);
+
+//! Compute the eigen decomposition S = V * diag(D) * V^T of a 4x4 symmetric matrix
+//! \param  [out]  eigenvalues    The 4 eigenvalues D sorted in decreasing order
+//! \param  [out]  eigenvectors   The row major orthogonal matrix V, the column k is the eigenvector of the eigenvalue k
+//! \param  [in ]  S              The row major symmetric matrix (only the upper triangle is read)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array_double_eigen_symm4x4 (
+   Rox_Double eigenvalues[4],
+   Rox_Double eigenvectors[16],
+   const Rox_Double S[16]
+);
+
+//! Compute the eigen decomposition S = V * diag(D) * V^T of a 9x9 symmetric matrix
+//! \param  [out]  eigenvalues    The 9 eigenvalues D sorted in decreasing order
+//! \param  [out]  eigenvectors   The row major orthogonal matrix V, the column k is the eigenvector of the eigenvalue k
+//! \param  [in ]  S              The row major symmetric matrix (only the upper triangle is read)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array_double_eigen_symm9x9 (
+   Rox_Double eigenvalues[9],
+   Rox_Double eigenvectors[81],
+   const Rox_Double S[81]
+);
+
+//! Compute the eigen decompositions of a batch of small symmetric matrices of the same size, in parallel
+//! \param  [out]  eigenvalues    The size * count eigenvalues, sorted in decreasing order for each matrix
+//! \param  [out]  eigenvectors   The size * size * count row major orthogonal matrices of the eigenvectors (in columns)
+//! \param  [in ]  S              The size * size * count row major symmetric matrices
+//! \param  [in ]  size           The size of the matrices, between 1 and 9
+//! \param  [in ]  count          The number of matrices
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array_double_eigen_symm_batch (
+   Rox_Double * eigenvalues,
+   Rox_Double * eigenvectors,
+   const Rox_Double * S,
+   const Rox_Sint size,
+   const Rox_Sint count
+);
+
+//! @}
+
+#endif // __OPENROX_EIGEN_SYMM__
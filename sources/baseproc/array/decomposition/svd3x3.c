@@ -0,0 +1,190 @@
+//==============================================================================
+//
+//    OPENROX   : File svd3x3.c
+//
+//    Contents  : Implementation of svd3x3 module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "svd3x3.h"
+#include "ansi_svd3x3.h"
+
+#include <inout/system/errors_print.h>
+
+//! The number of matrices projected on SO(3) per call to the svd kernel
+#define ROX_POLAR3X3_CHUNK 64
+
+// R = U * diag(1, 1, det(U)) * V^T, with det(V) = 1
+static void rox_polar3x3_from_svd ( Rox_Double * R, const Rox_Double * U, const Rox_Double * V )
+{
+   const Rox_Double det = U[0] * (U[4] * U[8] - U[5] * U[7]) - U[1] * (U[3] * U[8] - U[5] * U[6]) + U[2] * (U[3] * U[7] - U[4] * U[6]);
+   const Rox_Double last = ( det < 0.0 ) ? -1.0 : 1.0;
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         R[i * 3 + j] = U[i * 3 + 0] * V[j * 3 + 0] + U[i * 3 + 1] * V[j * 3 + 1] + last * U[i * 3 + 2] * V[j * 3 + 2];
+      }
+   }
+}
+
+Rox_ErrorCode rox_array2d_double_svd3x3 (
+   Rox_Array2D_Double U,
+   Rox_Array2D_Double S,
+   Rox_Array2D_Double V,
+   const Rox_Array2D_Double input
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** dU = NULL, ** dS = NULL, ** dV = NULL, ** dA = NULL;
+   Rox_Double A[9], Ub[9], Sb[3], Vb[9];
+
+   if ( !U || !S || !V || !input )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_array2d_double_check_size ( U, 3, 3 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_check_size ( S, 3, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_check_size ( V, 3, 3 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_check_size ( input, 3, 3 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dU, U );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dS, S );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dV, V );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dA, input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ ) A[i * 3 + j] = dA[i][j];
+   }
+
+   rox_ansi_array_double_svd3x3_batch ( Ub, Sb, Vb, A, 1 );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      dS[i][0] = Sb[i];
+
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         dU[i][j] = Ub[i * 3 + j];
+         dV[i][j] = Vb[i * 3 + j];
+      }
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_array_double_svd3x3_batch (
+   Rox_Double * U,
+   Rox_Double * S,
+   Rox_Double * V,
+   const Rox_Double * A,
+   const Rox_Sint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !U || !S || !V || !A )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( count < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_ansi_array_double_svd3x3_batch ( U, S, V, A, count );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_array2d_double_polar3x3 (
+   Rox_Array2D_Double R,
+   const Rox_Array2D_Double input
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** dR = NULL, ** dA = NULL;
+   Rox_Double A[9], Rb[9];
+
+   if ( !R || !input )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_array2d_double_check_size ( R, 3, 3 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_check_size ( input, 3, 3 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dR, R );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dA, input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ ) A[i * 3 + j] = dA[i][j];
+   }
+
+   error = rox_array_double_polar3x3_batch ( Rb, A, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ ) dR[i][j] = Rb[i * 3 + j];
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_array_double_polar3x3_batch (
+   Rox_Double * R,
+   const Rox_Double * A,
+   const Rox_Sint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double U[9 * ROX_POLAR3X3_CHUNK], S[3 * ROX_POLAR3X3_CHUNK], V[9 * ROX_POLAR3X3_CHUNK];
+
+   if ( !R || !A )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( count < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Sint start = 0; start < count; start += ROX_POLAR3X3_CHUNK )
+   {
+      const Rox_Sint chunk = ( count - start < ROX_POLAR3X3_CHUNK ) ? count - start : ROX_POLAR3X3_CHUNK;
+
+      rox_ansi_array_double_svd3x3_batch ( U, S, V, &A[9 * start], chunk );
+
+      for ( Rox_Sint m = 0; m < chunk; m++ )
+      {
+         rox_polar3x3_from_svd ( &R[9 * ( start + m )], &U[9 * m], &V[9 * m] );
+      }
+   }
+
+function_terminate:
+   return error;
+}
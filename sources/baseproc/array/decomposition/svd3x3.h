@@ -0,0 +1,77 @@
+//==============================================================================
+//
+//    OPENROX   : File svd3x3.h
+//
+//    Contents  : API of svd3x3 module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_SVD3X3__
+#define __OPENROX_SVD3X3__
+
+#include <generated/array2d_double.h>
+
+//! \ingroup  Linalg
+//! \defgroup SVD3x3 SVD3x3
+//! \brief Singular Values Decomposition and polar decomposition of 3x3 matrices without memory allocation.
+
+//! \addtogroup SVD3x3
+//! @{
+
+//! Compute the svd input = U * diag(S) * V^T of a 3x3 matrix
+//! \param  [out]  U              The 3x3 orthogonal matrix of the left singular vectors
+//! \param  [out]  S              The 3x1 singular values, sorted in decreasing order
+//! \param  [out]  V              The 3x3 rotation matrix (det(V) = 1) of the right singular vectors
+//! \param  [in ]  input          The 3x3 matrix to decompose
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_double_svd3x3 (
+   Rox_Array2D_Double U,
+   Rox_Array2D_Double S,
+   Rox_Array2D_Double V,
+   const Rox_Array2D_Double input
+);
+
+//! Compute the svd A = U * diag(S) * V^T of a batch of 3x3 matrices, two matrices at a time in the SIMD registers
+//! \param  [out]  U              The 9 * count row major orthogonal matrices of the left singular vectors
+//! \param  [out]  S              The 3 * count singular values, sorted in decreasing order for each matrix
+//! \param  [out]  V              The 9 * count row major rotation matrices of the right singular vectors
+//! \param  [in ]  A              The 9 * count row major matrices to decompose
+//! \param  [in ]  count          The number of matrices
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array_double_svd3x3_batch (
+   Rox_Double * U,
+   Rox_Double * S,
+   Rox_Double * V,
+   const Rox_Double * A,
+   const Rox_Sint count
+);
+
+//! Compute the rotation nearest to a 3x3 matrix in the Frobenius norm (rotation factor of the polar decomposition)
+//! \param  [out]  R              The 3x3 rotation matrix, R = U * diag(1, 1, det(U)) * V^T
+//! \param  [in ]  input          The 3x3 matrix to project on SO(3)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_double_polar3x3 (
+   Rox_Array2D_Double R,
+   const Rox_Array2D_Double input
+);
+
+//! Compute the rotations nearest to a batch of 3x3 matrices in the Frobenius norm
+//! \param  [out]  R              The 9 * count row major rotation matrices
+//! \param  [in ]  A              The 9 * count row major matrices to project on SO(3)
+//! \param  [in ]  count          The number of matrices
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array_double_polar3x3_batch (
+   Rox_Double * R,
+   const Rox_Double * A,
+   const Rox_Sint count
+);
+
+//! @}
+
+#endif // __OPENROX_SVD3X3__
@@ -120,7 +120,7 @@ Rox_ErrorCode rox_array2d_uchar_flip_ud(Rox_Array2D_Uchar inout)
    error = rox_array2d_uchar_get_data_pointer_to_pointer( &dinout, inout);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for (Rox_Sint i = 0; i <= rows / 2; i++)
+   for (Rox_Sint i = 0; i < rows / 2; i++)
    {
       Rox_Sint last = rows - 1;
       Rox_Uchar *swap = dinout[i]; // In case of inplace operation
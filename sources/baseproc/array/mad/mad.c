@@ -15,6 +15,7 @@
 #include "mad.h"
 #include <baseproc/maths/maths_macros.h>
 #include <baseproc/array/median/median.h>
+#include <baseproc/array/median/introselect.h>
 #include <inout/system/errors_print.h>
 
 Rox_ErrorCode rox_array2d_double_mad (
@@ -60,26 +61,79 @@ Rox_ErrorCode rox_array2d_double_mad (
 
    *ret_mad = 0.0;
 
-   // Compute median
-   error = rox_array2d_double_copy(workbuffer, input);
+   // Compute median by selection on a copy
+   Rox_Double ** dwork2 = NULL;
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dwork2, workbuffer );
    ROX_ERROR_CHECK_TERMINATE ( error );
+   Rox_Double * dwork = dwork2[0];
 
-   error = rox_array2d_double_median(&median, workbuffer);
+   Rox_Uint size = cols * rows;
+   for ( Rox_Uint i = 0; i < size; i++ )
+   {
+      dwork[i] = data[i];
+   }
+
+   error = rox_double_median_introselect ( &median, dwork, size );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // For each element, compute absolute deviation (don't care if the order was changed by median)
-   for ( Rox_Sint i = 0; i < cols*rows; i++)
+   // For each element, compute absolute deviation
+   for ( Rox_Uint i = 0; i < size; i++ )
    {
       dad[i] = fabs(data[i] - median);
-	}
+      dwork[i] = dad[i];
+   }
 
    // Compute median of absolute deviations
-   error = rox_array2d_double_copy ( workbuffer, adfrommedian );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_median(ret_mad, workbuffer);
+   error = rox_double_median_introselect ( ret_mad, dwork, size );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
  function_terminate:
   return error;
 }
+
+Rox_ErrorCode rox_array2d_double_mad_select (
+   Rox_Double * ret_mad,
+   Rox_Array2D_Double workbuffer,
+   const Rox_Array2D_Double input,
+   const enum Rox_MAD_Method method
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double median = 0.0, median_bound = 0.0, mad_bound = 0.0;
+
+   if ( !ret_mad || !input )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Sint cols = 0, rows = 0;
+   error = rox_array2d_double_get_size ( &rows, &cols, input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Check we are computing mad on a vector (rows or cols)
+   if ( cols > 1 && rows > 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Double * data = NULL;
+   error = rox_array2d_double_get_data_pointer ( &data, input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( method == Rox_MAD_Method_Histogram )
+   {
+      error = rox_double_median_mad_histogram ( &median, &median_bound, ret_mad, &mad_bound, data, cols * rows );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+   else
+   {
+      error = rox_array2d_double_check_size ( workbuffer, rows, cols );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      Rox_Double * dwork = NULL;
+      error = rox_array2d_double_get_data_pointer ( &dwork, workbuffer );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_double_median_mad_introselect ( &median, ret_mad, dwork, data, cols * rows );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
@@ -31,6 +31,24 @@
 //! \todo to be tested
 ROX_API Rox_ErrorCode rox_array2d_double_mad(Rox_Double * mad, Rox_Array2D_Double adfrommedian, Rox_Array2D_Double workbuffer, Rox_Array2D_Double input);
 
+//! The methods computing the median absolute deviation
+enum Rox_MAD_Method
+{
+   //! Exact median and MAD by selection (linear time in average)
+   Rox_MAD_Method_Exact,
+
+   //! Approximate median and MAD by histograms (no work buffer, bounded error)
+   Rox_MAD_Method_Histogram,
+};
+
+//! Compute the median absolute deviation of a vector without sorting it.
+//! \param [out] 	mad 				A pointer to the computed MAD
+//! \param [out] 	workbuffer		An array of the same size than input (exact method only, may be NULL otherwise)
+//! \param [in] 	input				The vector to compute MAD on, not modified
+//! \param [in] 	method			The method computing the MAD
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_double_mad_select(Rox_Double * mad, Rox_Array2D_Double workbuffer, const Rox_Array2D_Double input, const enum Rox_MAD_Method method);
+
 //! @} 
 
 #endif // __OPENROX_MADROW__
@@ -0,0 +1,355 @@
+//==============================================================================
+//
+//    OPENROX   : File introselect.c
+//
+//    Contents  : Implementation of introselect module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "introselect.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <inout/system/errors_print.h>
+
+//! Ranges of at most this size are finished by insertion sort
+#define ROX_INTROSELECT_SMALL 16
+
+#define _ROX_SWAP(a,b) { Rox_Double t = (a); (a) = (b); (b) = t; }
+
+static void rox_introselect_insertion_sort ( Rox_Double * data, const Rox_Sint low, const Rox_Sint high )
+{
+   for ( Rox_Sint i = low + 1; i <= high; i++ )
+   {
+      Rox_Double value = data[i];
+      Rox_Sint j = i - 1;
+      while ( j >= low && data[j] > value )
+      {
+         data[j + 1] = data[j];
+         j--;
+      }
+      data[j + 1] = value;
+   }
+}
+
+static void rox_introselect_sift_down ( Rox_Double * data, Rox_Sint root, const Rox_Sint count )
+{
+   for (;;)
+   {
+      Rox_Sint child = 2 * root + 1;
+      if ( child >= count ) break;
+      if ( child + 1 < count && data[child + 1] > data[child] ) child++;
+      if ( data[root] >= data[child] ) break;
+      _ROX_SWAP ( data[root], data[child] );
+      root = child;
+   }
+}
+
+static void rox_introselect_heap_sort ( Rox_Double * data, const Rox_Sint count )
+{
+   for ( Rox_Sint i = count / 2 - 1; i >= 0; i-- )
+   {
+      rox_introselect_sift_down ( data, i, count );
+   }
+
+   for ( Rox_Sint end = count - 1; end > 0; end-- )
+   {
+      _ROX_SWAP ( data[0], data[end] );
+      rox_introselect_sift_down ( data, 0, end );
+   }
+}
+
+// Partially order data such that data[rank] is the element of this rank
+static void rox_introselect_rank ( Rox_Double * data, const Rox_Sint size, const Rox_Sint rank )
+{
+   Rox_Sint low = 0;
+   Rox_Sint high = size - 1;
+
+   // Number of partitions allowed before the fallback to heap sort
+   Rox_Sint depth = 0;
+   for ( Rox_Sint n = size; n > 1; n >>= 1 ) depth += 2;
+
+   // Stop as soon as the range is small or the rank is on an element equal to the pivot
+   while ( high - low > ROX_INTROSELECT_SMALL && low <= rank && rank <= high )
+   {
+      if ( depth-- == 0 )
+      {
+         rox_introselect_heap_sort ( &data[low], high - low + 1 );
+         return;
+      }
+
+      // Median of low, middle and high items, the extremes are sentinels of the partition
+      Rox_Sint middle = low + ( high - low ) / 2;
+      if ( data[middle] < data[low] ) _ROX_SWAP ( data[middle], data[low] );
+      if ( data[high] < data[low] ) _ROX_SWAP ( data[high], data[low] );
+      if ( data[high] < data[middle] ) _ROX_SWAP ( data[high], data[middle] );
+
+      _ROX_SWAP ( data[middle], data[low + 1] );
+      const Rox_Double pivot = data[low + 1];
+
+      Rox_Sint ll = low + 1;
+      Rox_Sint hh = high;
+      for (;;)
+      {
+         do ll++; while ( data[ll] < pivot );
+         do hh--; while ( data[hh] > pivot );
+         if ( hh < ll ) break;
+         _ROX_SWAP ( data[ll], data[hh] );
+      }
+
+      data[low + 1] = data[hh];
+      data[hh] = pivot;
+
+      if ( hh >= rank ) high = hh - 1;
+      if ( hh <= rank ) low = ll;
+   }
+
+   if ( low < high ) rox_introselect_insertion_sort ( data, low, high );
+}
+
+Rox_ErrorCode rox_double_introselect (
+   Rox_Double * value,
+   Rox_Double * data,
+   const Rox_Uint size,
+   const Rox_Uint rank
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !value || !data )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( size < 1 || rank >= size )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_introselect_rank ( data, size, rank );
+   *value = data[rank];
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_double_median_introselect (
+   Rox_Double * median,
+   Rox_Double * data,
+   const Rox_Uint size
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !median || !data )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( size < 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint mid = size / 2;
+   rox_introselect_rank ( data, size, mid );
+
+   if ( size % 2 )
+   {
+      *median = data[mid];
+   }
+   else
+   {
+      // The lower middle element is the largest one of the lower part
+      Rox_Double lower = data[0];
+      for ( Rox_Sint i = 1; i < mid; i++ )
+      {
+         lower = ( data[i] > lower ) ? data[i] : lower;
+      }
+      *median = 0.5 * ( lower + data[mid] );
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_double_median_mad_introselect (
+   Rox_Double * median,
+   Rox_Double * mad,
+   Rox_Double * work,
+   const Rox_Double * data,
+   const Rox_Uint size
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !median || !mad || !work || !data )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memcpy ( work, data, size * sizeof ( Rox_Double ) );
+
+   error = rox_double_median_introselect ( median, work, size );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   const Rox_Double center = *median;
+   for ( Rox_Uint i = 0; i < size; i++ )
+   {
+      work[i] = fabs ( data[i] - center );
+   }
+
+   error = rox_double_median_introselect ( mad, work, size );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+// Approximate the mean of the elements of ranks first and first + count - 1 (count is 1 or 2) of data,
+// or of the absolute deviations of data from center.
+// A first histogram over the range of the values finds the bins of the ranks, a second histogram
+// splits these bins again. The selected elements are within the extrema of their sub-bins.
+static void rox_histogram_select (
+   Rox_Double * value,
+   Rox_Double * bound,
+   const Rox_Double * data,
+   const Rox_Uint size,
+   const Rox_Uint first,
+   const Rox_Uint count,
+   const Rox_Double center,
+   const Rox_Sint absolute
+)
+{
+   const Rox_Sint bins = ROX_INTROSELECT_HISTOGRAM_BINS;
+   Rox_Uint counts[ROX_INTROSELECT_HISTOGRAM_BINS];
+   Rox_Uint sub_counts[2][ROX_INTROSELECT_HISTOGRAM_BINS];
+   Rox_Double sub_min[2][ROX_INTROSELECT_HISTOGRAM_BINS];
+   Rox_Double sub_max[2][ROX_INTROSELECT_HISTOGRAM_BINS];
+   Rox_Sint bin[2] = { 0, 0 };
+   Rox_Uint rank[2] = { 0, 0 };
+   Rox_Double sub_low[2] = { 0.0, 0.0 };
+
+   Rox_Double low = INFINITY, high = -INFINITY;
+   for ( Rox_Uint i = 0; i < size; i++ )
+   {
+      const Rox_Double v = absolute ? fabs ( data[i] - center ) : data[i];
+      low = ( v < low ) ? v : low;
+      high = ( v > high ) ? v : high;
+   }
+
+   if ( high == low )
+   {
+      *value = low;
+      *bound = 0.0;
+      return;
+   }
+
+   const Rox_Double width = ( high - low ) / bins;
+   const Rox_Double scale = bins / ( high - low );
+   const Rox_Double sub_scale = bins / width;
+
+   memset ( counts, 0, sizeof ( counts ) );
+   for ( Rox_Uint i = 0; i < size; i++ )
+   {
+      const Rox_Double v = absolute ? fabs ( data[i] - center ) : data[i];
+      Rox_Sint b = ( Rox_Sint ) ( ( v - low ) * scale );
+      if ( b > bins - 1 ) b = bins - 1;
+      counts[b]++;
+   }
+
+   for ( Rox_Uint r = 0; r < count; r++ )
+   {
+      Rox_Uint below = 0;
+      Rox_Sint b = 0;
+      while ( below + counts[b] <= first + r ) below += counts[b++];
+      bin[r] = b;
+      rank[r] = first + r - below;
+      sub_low[r] = low + b * width;
+
+      memset ( sub_counts[r], 0, sizeof ( sub_counts[r] ) );
+      for ( Rox_Sint s = 0; s < bins; s++ )
+      {
+         sub_min[r][s] = INFINITY;
+         sub_max[r][s] = -INFINITY;
+      }
+   }
+
+   for ( Rox_Uint i = 0; i < size; i++ )
+   {
+      const Rox_Double v = absolute ? fabs ( data[i] - center ) : data[i];
+      Rox_Sint b = ( Rox_Sint ) ( ( v - low ) * scale );
+      if ( b > bins - 1 ) b = bins - 1;
+
+      for ( Rox_Uint r = 0; r < count; r++ )
+      {
+         if ( b != bin[r] ) continue;
+
+         Rox_Sint s = ( Rox_Sint ) ( ( v - sub_low[r] ) * sub_scale );
+         if ( s < 0 ) s = 0;
+         if ( s > bins - 1 ) s = bins - 1;
+
+         sub_counts[r][s]++;
+         if ( v < sub_min[r][s] ) sub_min[r][s] = v;
+         if ( v > sub_max[r][s] ) sub_max[r][s] = v;
+      }
+   }
+
+   *value = 0.0;
+   *bound = 0.0;
+   for ( Rox_Uint r = 0; r < count; r++ )
+   {
+      Rox_Uint below = 0;
+      Rox_Sint s = 0;
+      while ( below + sub_counts[r][s] <= rank[r] ) below += sub_counts[r][s++];
+
+      *value += 0.5 * ( sub_min[r][s] + sub_max[r][s] ) / count;
+      *bound += 0.5 * ( sub_max[r][s] - sub_min[r][s] ) / count;
+   }
+}
+
+Rox_ErrorCode rox_double_median_histogram (
+   Rox_Double * median,
+   Rox_Double * bound,
+   const Rox_Double * data,
+   const Rox_Uint size
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !median || !bound || !data )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( size < 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( size % 2 ) rox_histogram_select ( median, bound, data, size, size / 2, 1, 0.0, 0 );
+   else rox_histogram_select ( median, bound, data, size, size / 2 - 1, 2, 0.0, 0 );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_double_median_mad_histogram (
+   Rox_Double * median,
+   Rox_Double * median_bound,
+   Rox_Double * mad,
+   Rox_Double * mad_bound,
+   const Rox_Double * data,
+   const Rox_Uint size
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !mad || !mad_bound )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_double_median_histogram ( median, median_bound, data, size );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( size % 2 ) rox_histogram_select ( mad, mad_bound, data, size, size / 2, 1, *median, 1 );
+   else rox_histogram_select ( mad, mad_bound, data, size, size / 2 - 1, 2, *median, 1 );
+
+   // The deviations from the approximate median differ from the exact ones by at most the median bound
+   *mad_bound += *median_bound;
+
+function_terminate:
+   return error;
+}
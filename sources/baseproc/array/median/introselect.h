@@ -0,0 +1,106 @@
+//==============================================================================
+//
+//    OPENROX   : File introselect.h
+//
+//    Contents  : API of introselect module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_INTROSELECT__
+#define __OPENROX_INTROSELECT__
+
+#include <system/memory/datatypes.h>
+#include <system/errors/errors.h>
+
+//! \ingroup Statistics
+//! \addtogroup Median
+//! @{
+
+//! Number of bins of each level of the approximate histogram selection
+#define ROX_INTROSELECT_HISTOGRAM_BINS 256
+
+//! Select the element of given rank (0 for the smallest) of a vector, without sorting it.
+//! Quickselect with median of three pivots, falling back to a heap sort of the remaining range
+//! when the partitions do not shrink fast enough (linear time in average, n log n in the worst case).
+//! On return, data[rank] is the selected value, the elements before it are lower or equal, the ones after are greater or equal.
+//! \param  [out]  value          The selected value
+//! \param  [in ]  data           The vector, reordered in place
+//! \param  [in ]  size           The number of elements
+//! \param  [in ]  rank           The rank to select (lower than size)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_double_introselect (
+   Rox_Double * value,
+   Rox_Double * data,
+   const Rox_Uint size,
+   const Rox_Uint rank
+);
+
+//! Compute the median of a vector by selection, the vector is reordered in place.
+//! For an even size, the median is the mean of the two middle elements.
+//! \param  [out]  median         The median
+//! \param  [in ]  data           The vector, reordered in place
+//! \param  [in ]  size           The number of elements
+//! \return An error code
+ROX_API Rox_ErrorCode rox_double_median_introselect (
+   Rox_Double * median,
+   Rox_Double * data,
+   const Rox_Uint size
+);
+
+//! Compute the median and the median absolute deviation of a vector by selection, without allocation.
+//! \param  [out]  median         The median of the data
+//! \param  [out]  mad            The median of the absolute deviations from the median
+//! \param  [out]  work           A buffer of size elements
+//! \param  [in ]  data           The vector, not modified
+//! \param  [in ]  size           The number of elements
+//! \return An error code
+ROX_API Rox_ErrorCode rox_double_median_mad_introselect (
+   Rox_Double * median,
+   Rox_Double * mad,
+   Rox_Double * work,
+   const Rox_Double * data,
+   const Rox_Uint size
+);
+
+//! Approximate the median of a vector with two levels of histograms (three passes on the data, no allocation).
+//! The exact median is within bound of the returned value. The bound is at most the range of the data
+//! divided by 2*ROX_INTROSELECT_HISTOGRAM_BINS^2, it is zero when the selected elements are isolated in their bins.
+//! \param  [out]  median         The approximate median
+//! \param  [out]  bound          The bound of the absolute error on the median
+//! \param  [in ]  data           The vector, not modified
+//! \param  [in ]  size           The number of elements
+//! \return An error code
+ROX_API Rox_ErrorCode rox_double_median_histogram (
+   Rox_Double * median,
+   Rox_Double * bound,
+   const Rox_Double * data,
+   const Rox_Uint size
+);
+
+//! Approximate the median and the median absolute deviation of a vector with histograms (no allocation).
+//! The exact values are within the returned bounds of the returned values.
+//! \param  [out]  median         The approximate median
+//! \param  [out]  median_bound   The bound of the absolute error on the median
+//! \param  [out]  mad            The approximate median absolute deviation
+//! \param  [out]  mad_bound      The bound of the absolute error on the median absolute deviation
+//! \param  [in ]  data           The vector, not modified
+//! \param  [in ]  size           The number of elements
+//! \return An error code
+ROX_API Rox_ErrorCode rox_double_median_mad_histogram (
+   Rox_Double * median,
+   Rox_Double * median_bound,
+   Rox_Double * mad,
+   Rox_Double * mad_bound,
+   const Rox_Double * data,
+   const Rox_Uint size
+);
+
+//! @}
+
+#endif // __OPENROX_INTROSELECT__
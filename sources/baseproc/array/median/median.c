@@ -13,6 +13,7 @@
 //==============================================================================
 
 #include "median.h"
+#include "introselect.h"
 #include <inout/system/errors_print.h>
 
 #define _ROX_SWAP(a,b) {register Rox_Double t=(a);(a)=(b);(b)=t;}
@@ -175,9 +176,6 @@ Rox_ErrorCode rox_array2d_double_median  (Rox_Double * ret_median, Rox_Array2D_D
    if (!ret_median || !input) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   error = rox_array2d_double_asort ( input );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    Rox_Sint cols = 0, rows = 0;
    error = rox_array2d_double_get_size(&rows, &cols, input); 
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -194,22 +192,9 @@ Rox_ErrorCode rox_array2d_double_median  (Rox_Double * ret_median, Rox_Array2D_D
    error = rox_array2d_double_get_data_pointer ( &data, input );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Find the vector size (cols or rows)
-   Rox_Uint size = (cols >= rows) ? cols : rows;
-
-   Rox_Sint low = 0;
-   Rox_Sint high = size - 1;
-   Rox_Sint mid = (low + high + 1) / 2; //  Added + 1 such that the middle is half+1 for even sizes 
-
-   if (size % 2)   //  size is odd 
-   {  
-      *ret_median = data[mid];
-   }
-   else            //  size is even  
-   {
-      //  The median is 0.5*(data[mid]+data[mid-1]) 
-      *ret_median = 0.5*(data[mid]+data[mid-1]);
-   }
+   // Select the middle elements instead of sorting the vector
+   error = rox_double_median_introselect ( ret_median, data, cols * rows );
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
    return error;
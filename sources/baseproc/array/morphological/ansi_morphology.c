@@ -0,0 +1,76 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_morphology.c
+//
+//    Contents  : Implementation of ansi_morphology module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_morphology.h"
+#include <system/errors/errors.h>
+
+int rox_ansi_morphology_max_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count )
+{
+   for ( int i = 0; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_max_float ( float * res, const float * a, const float * b, const int count )
+{
+   for ( int i = 0; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_max_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count )
+{
+   for ( int i = 0; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count )
+{
+   for ( int i = 0; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_float ( float * res, const float * a, const float * b, const int count )
+{
+   for ( int i = 0; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count )
+{
+   for ( int i = 0; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
@@ -0,0 +1,66 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_morphology.h
+//
+//    Contents  : API of ansi_morphology module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ANSI_MORPHOLOGY__
+#define __OPENROX_ANSI_MORPHOLOGY__
+
+//! Element-wise maximum of two rows of unsigned chars: res[i] = max(a[i], b[i]), res may be a or b
+//! \param  [out]  res            The result row
+//! \param  [in ]  a              The first row
+//! \param  [in ]  b              The second row
+//! \param  [in ]  count          The number of elements
+//! \return An error code
+int rox_ansi_morphology_max_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count );
+
+//! Element-wise minimum of two rows of unsigned chars: res[i] = min(a[i], b[i]), res may be a or b
+//! \param  [out]  res            The result row
+//! \param  [in ]  a              The first row
+//! \param  [in ]  b              The second row
+//! \param  [in ]  count          The number of elements
+//! \return An error code
+int rox_ansi_morphology_min_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count );
+
+//! Element-wise maximum of two rows of floats: res[i] = max(a[i], b[i]), res may be a or b
+//! \param  [out]  res            The result row
+//! \param  [in ]  a              The first row
+//! \param  [in ]  b              The second row
+//! \param  [in ]  count          The number of elements
+//! \return An error code
+int rox_ansi_morphology_max_float ( float * res, const float * a, const float * b, const int count );
+
+//! Element-wise minimum of two rows of floats: res[i] = min(a[i], b[i]), res may be a or b
+//! \param  [out]  res            The result row
+//! \param  [in ]  a              The first row
+//! \param  [in ]  b              The second row
+//! \param  [in ]  count          The number of elements
+//! \return An error code
+int rox_ansi_morphology_min_float ( float * res, const float * a, const float * b, const int count );
+
+//! Element-wise maximum of two rows of unsigned ints: res[i] = max(a[i], b[i]), res may be a or b
+//! \param  [out]  res            The result row
+//! \param  [in ]  a              The first row
+//! \param  [in ]  b              The second row
+//! \param  [in ]  count          The number of elements
+//! \return An error code
+int rox_ansi_morphology_max_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count );
+
+//! Element-wise minimum of two rows of unsigned ints: res[i] = min(a[i], b[i]), res may be a or b
+//! \param  [out]  res            The result row
+//! \param  [in ]  a              The first row
+//! \param  [in ]  b              The second row
+//! \param  [in ]  count          The number of elements
+//! \return An error code
+int rox_ansi_morphology_min_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count );
+
+#endif // __OPENROX_ANSI_MORPHOLOGY__
@@ -0,0 +1,132 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_morphology_neon.c
+//
+//    Contents  : Implementation of ansi_morphology module with NEON
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_morphology.h"
+#include <system/errors/errors.h>
+#include <system/vectorisation/neon.h>
+
+int rox_ansi_morphology_max_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count )
+{
+   int i = 0;
+
+   // The rows are strips of images of any width
+   for ( ; i + 16 <= count; i += 16 )
+   {
+      uint8x16_t va = vld1q_u8( &a[i] );
+      uint8x16_t vb = vld1q_u8( &b[i] );
+      vst1q_u8( &res[i], vmaxq_u8( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_max_float ( float * res, const float * a, const float * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      float32x4_t va = vld1q_f32( &a[i] );
+      float32x4_t vb = vld1q_f32( &b[i] );
+      vst1q_f32( &res[i], vmaxq_f32( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_max_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      uint32x4_t va = vld1q_u32( &a[i] );
+      uint32x4_t vb = vld1q_u32( &b[i] );
+      vst1q_u32( &res[i], vmaxq_u32( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 16 <= count; i += 16 )
+   {
+      uint8x16_t va = vld1q_u8( &a[i] );
+      uint8x16_t vb = vld1q_u8( &b[i] );
+      vst1q_u8( &res[i], vminq_u8( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_float ( float * res, const float * a, const float * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      float32x4_t va = vld1q_f32( &a[i] );
+      float32x4_t vb = vld1q_f32( &b[i] );
+      vst1q_f32( &res[i], vminq_f32( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      uint32x4_t va = vld1q_u32( &a[i] );
+      uint32x4_t vb = vld1q_u32( &b[i] );
+      vst1q_u32( &res[i], vminq_u32( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
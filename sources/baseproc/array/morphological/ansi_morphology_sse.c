@@ -0,0 +1,132 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_morphology_sse.c
+//
+//    Contents  : Implementation of ansi_morphology module with SSE
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_morphology.h"
+#include <system/errors/errors.h>
+#include <system/vectorisation/sse.h>
+
+int rox_ansi_morphology_max_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count )
+{
+   int i = 0;
+
+   // Unaligned loads: the rows are strips of images of any width
+   for ( ; i + 16 <= count; i += 16 )
+   {
+      __m128i va = _mm_loadu_si128( (const __m128i *) &a[i] );
+      __m128i vb = _mm_loadu_si128( (const __m128i *) &b[i] );
+      _mm_storeu_si128( (__m128i *) &res[i], _mm_max_epu8( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_max_float ( float * res, const float * a, const float * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      __m128 va = _mm_loadu_ps( &a[i] );
+      __m128 vb = _mm_loadu_ps( &b[i] );
+      _mm_storeu_ps( &res[i], _mm_max_ps( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_max_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      __m128i va = _mm_loadu_si128( (const __m128i *) &a[i] );
+      __m128i vb = _mm_loadu_si128( (const __m128i *) &b[i] );
+      _mm_storeu_si128( (__m128i *) &res[i], _mm_max_epu32( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] > b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_uchar ( unsigned char * res, const unsigned char * a, const unsigned char * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 16 <= count; i += 16 )
+   {
+      __m128i va = _mm_loadu_si128( (const __m128i *) &a[i] );
+      __m128i vb = _mm_loadu_si128( (const __m128i *) &b[i] );
+      _mm_storeu_si128( (__m128i *) &res[i], _mm_min_epu8( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_float ( float * res, const float * a, const float * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      __m128 va = _mm_loadu_ps( &a[i] );
+      __m128 vb = _mm_loadu_ps( &b[i] );
+      _mm_storeu_ps( &res[i], _mm_min_ps( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+int rox_ansi_morphology_min_uint ( unsigned int * res, const unsigned int * a, const unsigned int * b, const int count )
+{
+   int i = 0;
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      __m128i va = _mm_loadu_si128( (const __m128i *) &a[i] );
+      __m128i vb = _mm_loadu_si128( (const __m128i *) &b[i] );
+      _mm_storeu_si128( (__m128i *) &res[i], _mm_min_epu32( va, vb ) );
+   }
+
+   for ( ; i < count; i++ )
+   {
+      res[i] = ( a[i] < b[i] ) ? a[i] : b[i];
+   }
+
+   return ROX_ERROR_NONE;
+}
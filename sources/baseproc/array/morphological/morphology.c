@@ -0,0 +1,332 @@
+//==============================================================================
+//
+//    OPENROX   : File morphology.c
+//
+//    Contents  : Implementation of morphology module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "morphology.h"
+#include "ansi_morphology.h"
+
+#include <math.h>
+#include <limits.h>
+#include <string.h>
+
+#include <system/memory/memory.h>
+#include <inout/system/errors_print.h>
+
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
+
+//! Number of bytes of the column strips of the vertical pass
+#define ROX_MORPHOLOGY_STRIP_BYTES 256
+
+//! Number of rows of the bands of the horizontal pass
+#define ROX_MORPHOLOGY_BAND 32
+
+// The van Herk/Gil-Werman filter of a line x of n elements padded by r neutral elements on both sides.
+// The padded line is cut in blocks of w = 2r+1 elements, g is the running extremum from the start of each block,
+// h is the running extremum to the end of each block. The window [p, p+2r] spans at most two blocks: out = op(h[p], g[p+2r]).
+// The vertical pass applies it to strips of rows with the SIMD row kernels, the horizontal pass to each row.
+
+// Vertical pass on the columns [first, first+count) of the image, out is the contiguous (rows x cols) result
+#define ROX_MORPHOLOGY_VERTICAL(NAME, TYPE) \
+static void rox_morphology_vertical_##NAME ( \
+   TYPE * out, \
+   TYPE ** in, \
+   const Rox_Sint rows, \
+   const Rox_Sint cols, \
+   const Rox_Sint first, \
+   const Rox_Sint count, \
+   const Rox_Sint radius, \
+   int ( * op ) ( TYPE *, const TYPE *, const TYPE *, const int ), \
+   const TYPE neutral, \
+   TYPE * buffer \
+) \
+{ \
+   const Rox_Sint width = 2 * radius + 1; \
+   const Rox_Sint length = rows + 2 * radius; \
+   TYPE * g = buffer; \
+   TYPE * h = g + length * count; \
+   TYPE * pad = h + length * count; \
+   \
+   if ( radius == 0 ) \
+   { \
+      for ( Rox_Sint i = 0; i < rows; i++ ) memcpy ( &out[i * cols + first], &in[i][first], count * sizeof ( TYPE ) ); \
+      return; \
+   } \
+   \
+   for ( Rox_Sint j = 0; j < count; j++ ) pad[j] = neutral; \
+   \
+   for ( Rox_Sint p = 0; p < length; p++ ) \
+   { \
+      const TYPE * x = ( p < radius || p >= rows + radius ) ? pad : &in[p - radius][first]; \
+      if ( p % width == 0 ) memcpy ( &g[p * count], x, count * sizeof ( TYPE ) ); \
+      else op ( &g[p * count], &g[( p - 1 ) * count], x, count ); \
+   } \
+   \
+   for ( Rox_Sint p = length - 1; p >= 0; p-- ) \
+   { \
+      const TYPE * x = ( p < radius || p >= rows + radius ) ? pad : &in[p - radius][first]; \
+      if ( p == length - 1 || p % width == width - 1 ) memcpy ( &h[p * count], x, count * sizeof ( TYPE ) ); \
+      else op ( &h[p * count], &h[( p + 1 ) * count], x, count ); \
+   } \
+   \
+   for ( Rox_Sint i = 0; i < rows; i++ ) \
+   { \
+      op ( &out[i * cols + first], &h[i * count], &g[( i + 2 * radius ) * count], count ); \
+   } \
+}
+
+// Horizontal pass on a row of cols elements, the buffer has 2 * (cols + 2 * radius) elements
+#define ROX_MORPHOLOGY_HORIZONTAL(NAME, TYPE, CMP) \
+static void rox_morphology_horizontal_##NAME ( \
+   TYPE * out, \
+   const TYPE * in, \
+   const Rox_Sint cols, \
+   const Rox_Sint radius, \
+   const TYPE neutral, \
+   TYPE * buffer \
+) \
+{ \
+   const Rox_Sint width = 2 * radius + 1; \
+   const Rox_Sint length = cols + 2 * radius; \
+   TYPE * g = buffer; \
+   TYPE * h = g + length; \
+   \
+   if ( radius == 0 ) \
+   { \
+      memcpy ( out, in, cols * sizeof ( TYPE ) ); \
+      return; \
+   } \
+   \
+   for ( Rox_Sint p = 0; p < length; p++ ) \
+   { \
+      const TYPE x = ( p < radius || p >= cols + radius ) ? neutral : in[p - radius]; \
+      g[p] = ( p % width == 0 || g[p - 1] CMP x ) ? x : g[p - 1]; \
+   } \
+   \
+   for ( Rox_Sint p = length - 1; p >= 0; p-- ) \
+   { \
+      const TYPE x = ( p < radius || p >= cols + radius ) ? neutral : in[p - radius]; \
+      h[p] = ( p == length - 1 || p % width == width - 1 || h[p + 1] CMP x ) ? x : h[p + 1]; \
+   } \
+   \
+   for ( Rox_Sint i = 0; i < cols; i++ ) \
+   { \
+      const TYPE a = h[i]; \
+      const TYPE b = g[i + 2 * radius]; \
+      out[i] = ( a CMP b ) ? b : a; \
+   } \
+}
+
+// Erosion or dilation of an image: vertical pass by column strips, then horizontal pass by bands of rows
+#define ROX_MORPHOLOGY_FILTER(NAME, TYPE, MIN_VALUE, MAX_VALUE) \
+ROX_MORPHOLOGY_VERTICAL(NAME, TYPE) \
+ROX_MORPHOLOGY_HORIZONTAL(NAME##_max, TYPE, <) \
+ROX_MORPHOLOGY_HORIZONTAL(NAME##_min, TYPE, >) \
+static Rox_ErrorCode rox_morphology_filter_##NAME ( \
+   TYPE ** out, \
+   TYPE ** in, \
+   const Rox_Sint rows, \
+   const Rox_Sint cols, \
+   const Rox_Sint radius_v, \
+   const Rox_Sint radius_u, \
+   const Rox_Sint dilate \
+) \
+{ \
+   Rox_ErrorCode error = ROX_ERROR_NONE; \
+   TYPE * vertical = NULL; \
+   TYPE * buffers = NULL; \
+   Rox_Sint nbthreads = 1; \
+   \
+   const TYPE neutral = dilate ? MIN_VALUE : MAX_VALUE; \
+   const Rox_Sint strip = ROX_MORPHOLOGY_STRIP_BYTES / sizeof ( TYPE ); \
+   const Rox_Sint count_strips = ( cols + strip - 1 ) / strip; \
+   const Rox_Sint count_bands = ( rows + ROX_MORPHOLOGY_BAND - 1 ) / ROX_MORPHOLOGY_BAND; \
+   const Rox_Sint size_vertical = ( 2 * ( rows + 2 * radius_v ) + 1 ) * strip; \
+   const Rox_Sint size_horizontal = 2 * ( cols + 2 * radius_u ); \
+   const Rox_Sint size = ( size_vertical > size_horizontal ) ? size_vertical : size_horizontal; \
+   \
+   int ( * op ) ( TYPE *, const TYPE *, const TYPE *, const int ) = dilate ? rox_ansi_morphology_max_##NAME : rox_ansi_morphology_min_##NAME; \
+   \
+   ROX_MORPHOLOGY_THREADS(nbthreads) \
+   \
+   vertical = ( TYPE * ) rox_memory_allocate ( sizeof ( TYPE ), rows * cols ); \
+   if ( !vertical ) \
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); } \
+   \
+   buffers = ( TYPE * ) rox_memory_allocate ( sizeof ( TYPE ), nbthreads * size ); \
+   if ( !buffers ) \
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); } \
+   \
+   ROX_MORPHOLOGY_PARALLEL \
+   { \
+      TYPE * buffer = &buffers[ROX_MORPHOLOGY_THREAD * size]; \
+      \
+      ROX_MORPHOLOGY_FOR \
+      for ( Rox_Sint s = 0; s < count_strips; s++ ) \
+      { \
+         const Rox_Sint first = s * strip; \
+         const Rox_Sint count = ( first + strip > cols ) ? cols - first : strip; \
+         rox_morphology_vertical_##NAME ( vertical, in, rows, cols, first, count, radius_v, op, neutral, buffer ); \
+      } \
+      \
+      ROX_MORPHOLOGY_FOR \
+      for ( Rox_Sint b = 0; b < count_bands; b++ ) \
+      { \
+         const Rox_Sint end = ( ( b + 1 ) * ROX_MORPHOLOGY_BAND > rows ) ? rows : ( b + 1 ) * ROX_MORPHOLOGY_BAND; \
+         for ( Rox_Sint i = b * ROX_MORPHOLOGY_BAND; i < end; i++ ) \
+         { \
+            if ( dilate ) rox_morphology_horizontal_##NAME##_max ( out[i], &vertical[i * cols], cols, radius_u, neutral, buffer ); \
+            else rox_morphology_horizontal_##NAME##_min ( out[i], &vertical[i * cols], cols, radius_u, neutral, buffer ); \
+         } \
+      } \
+   } \
+   \
+function_terminate: \
+   rox_memory_delete ( vertical ); \
+   rox_memory_delete ( buffers ); \
+   return error; \
+}
+
+#ifdef ROX_USES_OPENMP
+   #define ROX_MORPHOLOGY_THREADS(nbthreads) nbthreads = omp_get_max_threads ( );
+   #define ROX_MORPHOLOGY_PARALLEL _Pragma("omp parallel num_threads(nbthreads)")
+   #define ROX_MORPHOLOGY_FOR _Pragma("omp for schedule(dynamic)")
+   #define ROX_MORPHOLOGY_THREAD omp_get_thread_num ( )
+#else
+   #define ROX_MORPHOLOGY_THREADS(nbthreads)
+   #define ROX_MORPHOLOGY_PARALLEL
+   #define ROX_MORPHOLOGY_FOR
+   #define ROX_MORPHOLOGY_THREAD 0
+#endif
+
+ROX_MORPHOLOGY_FILTER(uchar, Rox_Uchar, 0, UCHAR_MAX)
+ROX_MORPHOLOGY_FILTER(float, Rox_Float, -INFINITY, INFINITY)
+ROX_MORPHOLOGY_FILTER(uint, Rox_Uint, 0, UINT_MAX)
+
+static Rox_ErrorCode rox_morphology_check_radius ( const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   if ( radius_v < 0 || radius_u < 0 ) return ROX_ERROR_INVALID_VALUE;
+   return ROX_ERROR_NONE;
+}
+
+// Erosion, dilation, opening or closing of an image, the second operation is skipped if second < 0
+#define ROX_MORPHOLOGY_APPLY(NAME, TYPE, ARRAY) \
+static Rox_ErrorCode rox_morphology_apply_##NAME ( \
+   ARRAY res, \
+   const ARRAY input, \
+   const Rox_Sint radius_v, \
+   const Rox_Sint radius_u, \
+   const Rox_Sint first, \
+   const Rox_Sint second \
+) \
+{ \
+   Rox_ErrorCode error = ROX_ERROR_NONE; \
+   Rox_Sint rows = 0, cols = 0; \
+   TYPE ** dres = NULL; \
+   TYPE ** din = NULL; \
+   \
+   if ( !res || !input ) \
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); } \
+   \
+   error = rox_morphology_check_radius ( radius_v, radius_u ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_array2d_##NAME##_get_size ( &rows, &cols, res ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_array2d_##NAME##_check_size ( input, rows, cols ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_array2d_##NAME##_get_data_pointer_to_pointer ( &dres, res ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_array2d_##NAME##_get_data_pointer_to_pointer ( &din, input ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_morphology_filter_##NAME ( dres, din, rows, cols, radius_v, radius_u, first ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   if ( second >= 0 ) \
+   { \
+      error = rox_morphology_filter_##NAME ( dres, dres, rows, cols, radius_v, radius_u, second ); \
+      ROX_ERROR_CHECK_TERMINATE ( error ); \
+   } \
+   \
+function_terminate: \
+   return error; \
+}
+
+ROX_MORPHOLOGY_APPLY(uchar, Rox_Uchar, Rox_Array2D_Uchar)
+ROX_MORPHOLOGY_APPLY(float, Rox_Float, Rox_Array2D_Float)
+ROX_MORPHOLOGY_APPLY(uint, Rox_Uint, Rox_Imask)
+
+Rox_ErrorCode rox_array2d_uchar_erode_rectangle ( Rox_Array2D_Uchar res, const Rox_Array2D_Uchar input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uchar ( res, input, radius_v, radius_u, 0, -1 );
+}
+
+Rox_ErrorCode rox_array2d_uchar_dilate_rectangle ( Rox_Array2D_Uchar res, const Rox_Array2D_Uchar input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uchar ( res, input, radius_v, radius_u, 1, -1 );
+}
+
+Rox_ErrorCode rox_array2d_uchar_open_rectangle ( Rox_Array2D_Uchar res, const Rox_Array2D_Uchar input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uchar ( res, input, radius_v, radius_u, 0, 1 );
+}
+
+Rox_ErrorCode rox_array2d_uchar_close_rectangle ( Rox_Array2D_Uchar res, const Rox_Array2D_Uchar input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uchar ( res, input, radius_v, radius_u, 1, 0 );
+}
+
+Rox_ErrorCode rox_array2d_float_erode_rectangle ( Rox_Array2D_Float res, const Rox_Array2D_Float input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_float ( res, input, radius_v, radius_u, 0, -1 );
+}
+
+Rox_ErrorCode rox_array2d_float_dilate_rectangle ( Rox_Array2D_Float res, const Rox_Array2D_Float input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_float ( res, input, radius_v, radius_u, 1, -1 );
+}
+
+Rox_ErrorCode rox_array2d_float_open_rectangle ( Rox_Array2D_Float res, const Rox_Array2D_Float input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_float ( res, input, radius_v, radius_u, 0, 1 );
+}
+
+Rox_ErrorCode rox_array2d_float_close_rectangle ( Rox_Array2D_Float res, const Rox_Array2D_Float input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_float ( res, input, radius_v, radius_u, 1, 0 );
+}
+
+Rox_ErrorCode rox_imask_erode_rectangle ( Rox_Imask res, const Rox_Imask input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uint ( res, input, radius_v, radius_u, 0, -1 );
+}
+
+Rox_ErrorCode rox_imask_dilate_rectangle ( Rox_Imask res, const Rox_Imask input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uint ( res, input, radius_v, radius_u, 1, -1 );
+}
+
+Rox_ErrorCode rox_imask_open_rectangle ( Rox_Imask res, const Rox_Imask input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uint ( res, input, radius_v, radius_u, 0, 1 );
+}
+
+Rox_ErrorCode rox_imask_close_rectangle ( Rox_Imask res, const Rox_Imask input, const Rox_Sint radius_v, const Rox_Sint radius_u )
+{
+   return rox_morphology_apply_uint ( res, input, radius_v, radius_u, 1, 0 );
+}
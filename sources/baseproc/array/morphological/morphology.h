@@ -0,0 +1,189 @@
+//==============================================================================
+//
+//    OPENROX   : File morphology.h
+//
+//    Contents  : API of morphology module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_MORPHOLOGY__
+#define __OPENROX_MORPHOLOGY__
+
+#include <generated/array2d_uchar.h>
+#include <generated/array2d_float.h>
+#include <baseproc/image/imask/imask.h>
+
+//! \ingroup Image
+//! \addtogroup Morphological
+//! @{
+
+//! The structuring elements are rectangles of (2*radius_v+1) rows and (2*radius_u+1) columns centered on the pixel.
+//! The pixels of the element outside the image are ignored.
+//! Each pass uses the van Herk/Gil-Werman algorithm: the cost per pixel does not depend on the size of the element.
+//! The result may be the input image.
+
+//! Grayscale erosion of an uchar image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_uchar_erode_rectangle (
+   Rox_Array2D_Uchar res,
+   const Rox_Array2D_Uchar input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale dilation of an uchar image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_uchar_dilate_rectangle (
+   Rox_Array2D_Uchar res,
+   const Rox_Array2D_Uchar input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale opening (erosion then dilation) of an uchar image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_uchar_open_rectangle (
+   Rox_Array2D_Uchar res,
+   const Rox_Array2D_Uchar input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale closing (dilation then erosion) of an uchar image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_uchar_close_rectangle (
+   Rox_Array2D_Uchar res,
+   const Rox_Array2D_Uchar input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale erosion of a float image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_float_erode_rectangle (
+   Rox_Array2D_Float res,
+   const Rox_Array2D_Float input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale dilation of a float image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_float_dilate_rectangle (
+   Rox_Array2D_Float res,
+   const Rox_Array2D_Float input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale opening (erosion then dilation) of a float image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_float_open_rectangle (
+   Rox_Array2D_Float res,
+   const Rox_Array2D_Float input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Grayscale closing (dilation then erosion) of a float image with a rectangular element
+//! \param  [out]  res            The result image
+//! \param  [in ]  input          The input image
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_float_close_rectangle (
+   Rox_Array2D_Float res,
+   const Rox_Array2D_Float input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Erosion of a mask with a rectangular element: a pixel stays valid if all the pixels of the element are valid
+//! \param  [out]  res            The result mask
+//! \param  [in ]  input          The input mask
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_imask_erode_rectangle (
+   Rox_Imask res,
+   const Rox_Imask input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Dilation of a mask with a rectangular element: a pixel becomes valid if one pixel of the element is valid
+//! \param  [out]  res            The result mask
+//! \param  [in ]  input          The input mask
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_imask_dilate_rectangle (
+   Rox_Imask res,
+   const Rox_Imask input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Opening (erosion then dilation) of a mask with a rectangular element
+//! \param  [out]  res            The result mask
+//! \param  [in ]  input          The input mask
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_imask_open_rectangle (
+   Rox_Imask res,
+   const Rox_Imask input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! Closing (dilation then erosion) of a mask with a rectangular element
+//! \param  [out]  res            The result mask
+//! \param  [in ]  input          The input mask
+//! \param  [in ]  radius_v       The vertical radius of the element
+//! \param  [in ]  radius_u       The horizontal radius of the element
+//! \return An error code
+ROX_API Rox_ErrorCode rox_imask_close_rectangle (
+   Rox_Imask res,
+   const Rox_Imask input,
+   const Rox_Sint radius_v,
+   const Rox_Sint radius_u
+);
+
+//! @}
+
+#endif // __OPENROX_MORPHOLOGY__
@@ -16,6 +16,7 @@
 #define __OPENROX_HUBER__
 
 #include <generated/array2d_double.h>
+#include <baseproc/array/mad/mad.h>
 
 //! \addtogroup Robust
 //! @{
@@ -42,6 +43,17 @@ ROX_API Rox_ErrorCode rox_array2d_double_huber(Rox_Array2D_Double weights, Rox_A
 //! \todo To be tested
 ROX_API Rox_ErrorCode rox_array2d_double_huber_bounded(Rox_Array2D_Double weights, Rox_Array2D_Double workbuffer1, Rox_Array2D_Double workbuffer2, Rox_Array2D_Double input, Rox_Double sigma_minimal, Rox_Double sigma_maximal);
 
+//! Compute the robust scale of the residuals and their Huber weights in one call, without sorting and without work buffer.
+//! The weights array is used as the work buffer of the scale estimation before being filled with the weights.
+//! \param [out] weights the weigth for each element of the input vector.
+//! \param [out] sigma the robust standard deviation (1.4826 * MAD) bounded by sigma_minimal and sigma_maximal
+//! \param [in] input the vector to compute weigths on
+//! \param [in] sigma_minimal minimal value sigma can goes to
+//! \param [in] sigma_maximal maximal value sigma can goes to
+//! \param [in] method the method computing the MAD (the histogram method suits large vectors)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_array2d_double_huber_weights(Rox_Array2D_Double weights, Rox_Double * sigma, const Rox_Array2D_Double input, const Rox_Double sigma_minimal, const Rox_Double sigma_maximal, const enum Rox_MAD_Method method);
+
 //! @} 
 
 #endif
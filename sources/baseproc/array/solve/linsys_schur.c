@@ -0,0 +1,509 @@
+//==============================================================================
+//
+//    OPENROX   : File linsys_schur.c
+//
+//    Contents  : Implementation of linsys_schur module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "linsys_schur.h"
+
+#include <string.h>
+
+#include <system/memory/memory.h>
+#include <baseproc/array/fill/fillval.h>
+#include <baseproc/array/inverse/svdinverse.h>
+#include <baseproc/array/solve/svd_solve.h>
+#include <inout/system/errors_print.h>
+
+//! Block structured normal equations
+struct Rox_LinSys_Schur_Struct
+{
+   //! Number of shared parameters
+   Rox_Sint ns;
+   //! Number of parameters per block
+   Rox_Sint nb;
+   //! Number of blocks
+   Rox_Sint blocks;
+
+   //! Per block Js^T Js (blocks x ns x ns)
+   Rox_Double * U;
+   //! Per block Js^T Jb (blocks x ns x nb)
+   Rox_Double * W;
+   //! Per block Js^T r (blocks x ns)
+   Rox_Double * gs;
+   //! Per block Jb^T r (blocks x nb)
+   Rox_Double * gb;
+   //! Per block temporary for the back substitution (blocks x nb)
+   Rox_Double * rb;
+   //! Temporary W * inv(V) product used by the reduction (ns x nb)
+   Rox_Double * WVi;
+   //! Per block activity flag
+   Rox_Sint * active;
+   //! Per block error codes for the parallel stages
+   Rox_ErrorCode * errors;
+
+   //! Per block Jb^T Jb
+   Rox_Array2D_Double * V;
+   //! Per block inverse of Jb^T Jb
+   Rox_Array2D_Double * Vinv;
+
+   //! The reduced system on the shared parameters
+   Rox_Array2D_Double S;
+   //! The reduced right hand side
+   Rox_Array2D_Double g;
+   //! The solution on the shared parameters
+   Rox_Array2D_Double xs;
+};
+
+Rox_ErrorCode rox_linsys_schur_new ( Rox_LinSys_Schur * obj, const Rox_Sint shared_size, const Rox_Sint block_size, const Rox_Sint blocks )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_LinSys_Schur ret = NULL;
+
+   if ( !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *obj = NULL;
+
+   if ( shared_size < 0 || block_size < 0 || blocks < 1 || shared_size + block_size < 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_LinSys_Schur) rox_memory_allocate ( sizeof(*ret), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->ns     = shared_size;
+   ret->nb     = block_size;
+   ret->blocks = blocks;
+   ret->U      = NULL;
+   ret->W      = NULL;
+   ret->gs     = NULL;
+   ret->gb     = NULL;
+   ret->rb     = NULL;
+   ret->WVi    = NULL;
+   ret->active = NULL;
+   ret->errors = NULL;
+   ret->V      = NULL;
+   ret->Vinv   = NULL;
+   ret->S      = NULL;
+   ret->g      = NULL;
+   ret->xs     = NULL;
+
+   ret->active = (Rox_Sint *) rox_memory_allocate ( sizeof(Rox_Sint), blocks );
+   if ( !ret->active )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->errors = (Rox_ErrorCode *) rox_memory_allocate ( sizeof(Rox_ErrorCode), blocks );
+   if ( !ret->errors )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( shared_size > 0 )
+   {
+      ret->U = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), blocks * shared_size * shared_size );
+      ret->gs = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), blocks * shared_size );
+      if ( !ret->U || !ret->gs )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_array2d_double_new ( &ret->S, shared_size, shared_size );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_new ( &ret->g, shared_size, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_new ( &ret->xs, shared_size, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   if ( block_size > 0 )
+   {
+      ret->gb = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), blocks * block_size );
+      ret->rb = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), blocks * block_size );
+      ret->V = (Rox_Array2D_Double *) rox_memory_allocate ( sizeof(Rox_Array2D_Double), blocks );
+      ret->Vinv = (Rox_Array2D_Double *) rox_memory_allocate ( sizeof(Rox_Array2D_Double), blocks );
+      if ( !ret->gb || !ret->rb || !ret->V || !ret->Vinv )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      for ( Rox_Sint i = 0; i < blocks; i++ )
+      {
+         ret->V[i] = NULL;
+         ret->Vinv[i] = NULL;
+      }
+
+      for ( Rox_Sint i = 0; i < blocks; i++ )
+      {
+         error = rox_array2d_double_new ( &ret->V[i], block_size, block_size );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+
+         error = rox_array2d_double_new ( &ret->Vinv[i], block_size, block_size );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+   }
+
+   if ( shared_size > 0 && block_size > 0 )
+   {
+      ret->W = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), blocks * shared_size * block_size );
+      ret->WVi = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), shared_size * block_size );
+      if ( !ret->W || !ret->WVi )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
+
+   error = rox_linsys_schur_reset ( ret );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   *obj = ret;
+
+function_terminate:
+   if ( error ) rox_linsys_schur_del ( &ret );
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_schur_del ( Rox_LinSys_Schur * obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_LinSys_Schur todel = NULL;
+
+   if ( !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *obj;
+   *obj = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( todel->V && todel->Vinv )
+   {
+      for ( Rox_Sint i = 0; i < todel->blocks; i++ )
+      {
+         rox_array2d_double_del ( &todel->V[i] );
+         rox_array2d_double_del ( &todel->Vinv[i] );
+      }
+   }
+
+   rox_memory_delete ( todel->V );
+   rox_memory_delete ( todel->Vinv );
+   rox_memory_delete ( todel->U );
+   rox_memory_delete ( todel->W );
+   rox_memory_delete ( todel->gs );
+   rox_memory_delete ( todel->gb );
+   rox_memory_delete ( todel->rb );
+   rox_memory_delete ( todel->WVi );
+   rox_memory_delete ( todel->active );
+   rox_memory_delete ( todel->errors );
+
+   rox_array2d_double_del ( &todel->S );
+   rox_array2d_double_del ( &todel->g );
+   rox_array2d_double_del ( &todel->xs );
+
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_schur_reset ( Rox_LinSys_Schur obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint ns = obj->ns;
+   const Rox_Sint nb = obj->nb;
+   const Rox_Sint blocks = obj->blocks;
+
+   memset ( obj->active, 0, sizeof(Rox_Sint) * blocks );
+
+   for ( Rox_Sint i = 0; i < blocks; i++ ) obj->errors[i] = ROX_ERROR_NONE;
+
+   if ( ns > 0 )
+   {
+      memset ( obj->U, 0, sizeof(Rox_Double) * blocks * ns * ns );
+      memset ( obj->gs, 0, sizeof(Rox_Double) * blocks * ns );
+   }
+
+   if ( nb > 0 )
+   {
+      memset ( obj->gb, 0, sizeof(Rox_Double) * blocks * nb );
+
+      for ( Rox_Sint i = 0; i < blocks; i++ )
+      {
+         error = rox_array2d_double_fillval ( obj->V[i], 0.0 );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+   }
+
+   if ( ns > 0 && nb > 0 )
+   {
+      memset ( obj->W, 0, sizeof(Rox_Double) * blocks * ns * nb );
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_schur_add_block ( Rox_LinSys_Schur obj, const Rox_Sint id, const Rox_Array2D_Double Js, const Rox_Array2D_Double Jb, const Rox_Array2D_Double r )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** dJs = NULL, ** dJb = NULL, ** dr = NULL, ** dV = NULL;
+   Rox_Sint rows = 0;
+
+   if ( !obj || !r )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( id < 0 || id >= obj->blocks )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint ns = obj->ns;
+   const Rox_Sint nb = obj->nb;
+
+   error = rox_array2d_double_get_rows ( &rows, r );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_check_size ( r, rows, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dr, r );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( ns > 0 )
+   {
+      if ( !Js )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_array2d_double_check_size ( Js, rows, ns );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_get_data_pointer_to_pointer ( &dJs, Js );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   if ( nb > 0 )
+   {
+      if ( !Jb )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_array2d_double_check_size ( Jb, rows, nb );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_get_data_pointer_to_pointer ( &dJb, Jb );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_get_data_pointer_to_pointer ( &dV, obj->V[id] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   Rox_Double * U  = ( ns > 0 ) ? obj->U + id * ns * ns : NULL;
+   Rox_Double * gs = ( ns > 0 ) ? obj->gs + id * ns : NULL;
+   Rox_Double * W  = ( ns > 0 && nb > 0 ) ? obj->W + id * ns * nb : NULL;
+   Rox_Double * gb = ( nb > 0 ) ? obj->gb + id * nb : NULL;
+
+   // Accumulate the lower triangles, the upper ones are filled at the end
+   for ( Rox_Sint k = 0; k < rows; k++ )
+   {
+      const Rox_Double rk = dr[k][0];
+
+      for ( Rox_Sint i = 0; i < ns; i++ )
+      {
+         const Rox_Double ji = dJs[k][i];
+
+         for ( Rox_Sint j = 0; j <= i; j++ ) U[i * ns + j] += ji * dJs[k][j];
+         for ( Rox_Sint j = 0; j < nb; j++ ) W[i * nb + j] += ji * dJb[k][j];
+
+         gs[i] += ji * rk;
+      }
+
+      for ( Rox_Sint i = 0; i < nb; i++ )
+      {
+         const Rox_Double ji = dJb[k][i];
+
+         for ( Rox_Sint j = 0; j <= i; j++ ) dV[i][j] += ji * dJb[k][j];
+
+         gb[i] += ji * rk;
+      }
+   }
+
+   for ( Rox_Sint i = 0; i < ns; i++ )
+   {
+      for ( Rox_Sint j = i + 1; j < ns; j++ ) U[i * ns + j] = U[j * ns + i];
+   }
+
+   for ( Rox_Sint i = 0; i < nb; i++ )
+   {
+      for ( Rox_Sint j = i + 1; j < nb; j++ ) dV[i][j] = dV[j][i];
+   }
+
+   obj->active[id] = 1;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_schur_solve ( Rox_Array2D_Double x, const Rox_LinSys_Schur obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** dx = NULL, ** dS = NULL, ** dg = NULL, ** dxs = NULL;
+   Rox_Sint i = 0;
+
+   if ( !x || !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint ns = obj->ns;
+   const Rox_Sint nb = obj->nb;
+   const Rox_Sint blocks = obj->blocks;
+
+   error = rox_array2d_double_check_size ( x, ns + nb * blocks, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &dx, x );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Invert the independent block diagonal terms
+   if ( nb > 0 )
+   {
+      #ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+      #endif
+      for ( i = 0; i < blocks; i++ )
+      {
+         obj->errors[i] = ROX_ERROR_NONE;
+         if ( !obj->active[i] ) continue;
+         obj->errors[i] = rox_array2d_double_svdinverse ( obj->Vinv[i], obj->V[i] );
+      }
+
+      for ( i = 0; i < blocks; i++ )
+      {
+         if ( obj->errors[i] ) { error = obj->errors[i]; ROX_ERROR_CHECK_TERMINATE ( error ); }
+      }
+   }
+
+   if ( ns > 0 )
+   {
+      error = rox_array2d_double_get_data_pointer_to_pointer ( &dS, obj->S );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_get_data_pointer_to_pointer ( &dg, obj->g );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_get_data_pointer_to_pointer ( &dxs, obj->xs );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_fillval ( obj->S, 0.0 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_double_fillval ( obj->g, 0.0 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      // Reduce the blocks in index order so that the result does not depend on the threads
+      for ( Rox_Sint b = 0; b < blocks; b++ )
+      {
+         if ( !obj->active[b] ) continue;
+
+         const Rox_Double * U  = obj->U + b * ns * ns;
+         const Rox_Double * gs = obj->gs + b * ns;
+
+         for ( Rox_Sint k = 0; k < ns; k++ )
+         {
+            for ( Rox_Sint l = 0; l < ns; l++ ) dS[k][l] += U[k * ns + l];
+            dg[k][0] += gs[k];
+         }
+
+         if ( nb == 0 ) continue;
+
+         const Rox_Double * W  = obj->W + b * ns * nb;
+         const Rox_Double * gb = obj->gb + b * nb;
+         Rox_Double ** dVi = NULL;
+
+         error = rox_array2d_double_get_data_pointer_to_pointer ( &dVi, obj->Vinv[b] );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+
+         // WVi = W * inv(V)
+         for ( Rox_Sint k = 0; k < ns; k++ )
+         {
+            for ( Rox_Sint j = 0; j < nb; j++ )
+            {
+               Rox_Double sum = 0.0;
+               for ( Rox_Sint m = 0; m < nb; m++ ) sum += W[k * nb + m] * dVi[m][j];
+               obj->WVi[k * nb + j] = sum;
+            }
+         }
+
+         // S -= W * inv(V) * W^T and g -= W * inv(V) * gb
+         for ( Rox_Sint k = 0; k < ns; k++ )
+         {
+            const Rox_Double * WVik = obj->WVi + k * nb;
+
+            for ( Rox_Sint l = 0; l < ns; l++ )
+            {
+               Rox_Double sum = 0.0;
+               for ( Rox_Sint j = 0; j < nb; j++ ) sum += WVik[j] * W[l * nb + j];
+               dS[k][l] -= sum;
+            }
+
+            Rox_Double sum = 0.0;
+            for ( Rox_Sint j = 0; j < nb; j++ ) sum += WVik[j] * gb[j];
+            dg[k][0] -= sum;
+         }
+      }
+
+      error = rox_svd_solve ( obj->xs, obj->S, obj->g );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      for ( Rox_Sint k = 0; k < ns; k++ ) dx[k][0] = dxs[k][0];
+   }
+
+   // Back substitution of the independent blocks
+   if ( nb > 0 )
+   {
+      #ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+      #endif
+      for ( i = 0; i < blocks; i++ )
+      {
+         Rox_Double ** dVi = NULL;
+         Rox_Double * rb = obj->rb + i * nb;
+
+         obj->errors[i] = ROX_ERROR_NONE;
+
+         if ( !obj->active[i] )
+         {
+            for ( Rox_Sint k = 0; k < nb; k++ ) dx[ns + i * nb + k][0] = 0.0;
+            continue;
+         }
+
+         obj->errors[i] = rox_array2d_double_get_data_pointer_to_pointer ( &dVi, obj->Vinv[i] );
+         if ( obj->errors[i] ) continue;
+
+         // rb = gb - W^T xs
+         for ( Rox_Sint k = 0; k < nb; k++ )
+         {
+            Rox_Double val = obj->gb[i * nb + k];
+            for ( Rox_Sint l = 0; l < ns; l++ ) val -= obj->W[i * ns * nb + l * nb + k] * dxs[l][0];
+            rb[k] = val;
+         }
+
+         // xb = inv(V) * rb
+         for ( Rox_Sint k = 0; k < nb; k++ )
+         {
+            Rox_Double val = 0.0;
+            for ( Rox_Sint l = 0; l < nb; l++ ) val += dVi[k][l] * rb[l];
+            dx[ns + i * nb + k][0] = val;
+         }
+      }
+
+      for ( i = 0; i < blocks; i++ )
+      {
+         if ( obj->errors[i] ) { error = obj->errors[i]; ROX_ERROR_CHECK_TERMINATE ( error ); }
+      }
+   }
+
+function_terminate:
+   return error;
+}
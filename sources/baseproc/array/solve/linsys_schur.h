@@ -0,0 +1,68 @@
+//==============================================================================
+//
+//    OPENROX   : File linsys_schur.h
+//
+//    Contents  : API of linsys_schur module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_LINSYS_SCHUR__
+#define __OPENROX_LINSYS_SCHUR__
+
+#include <generated/array2d_double.h>
+
+//! \ingroup Linalg
+//! \addtogroup solve
+//! @{
+
+//! Block structured least-squares system min || J x - r ||.
+//! The parameters are split in a set of shared parameters (e.g. camera intrinsics)
+//! followed by a set of independent blocks of parameters (e.g. one pose per view).
+//! The rows of each block only depend on the shared parameters and on the block parameters.
+//! The normal equations are reduced on the shared parameters with a Schur complement.
+typedef struct Rox_LinSys_Schur_Struct * Rox_LinSys_Schur;
+
+//! Create a new block structured system
+//! \param  [out]  obj            The created object
+//! \param  [in ]  shared_size    The number of shared parameters (may be 0)
+//! \param  [in ]  block_size     The number of parameters of each block (may be 0)
+//! \param  [in ]  blocks         The number of blocks
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_schur_new ( Rox_LinSys_Schur * obj, const Rox_Sint shared_size, const Rox_Sint block_size, const Rox_Sint blocks );
+
+//! Delete a block structured system
+//! \param  [out]  obj            The object to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_schur_del ( Rox_LinSys_Schur * obj );
+
+//! Reset the system: all blocks become inactive
+//! \param  [out]  obj            The system
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_schur_reset ( Rox_LinSys_Schur obj );
+
+//! Accumulate the normal equations of a block of rows.
+//! Different blocks can be set concurrently from different threads.
+//! \param  [out]  obj            The system
+//! \param  [in ]  id             The block index
+//! \param  [in ]  Js             The jacobian wrt the shared parameters (rows x shared_size), NULL if shared_size is 0
+//! \param  [in ]  Jb             The jacobian wrt the block parameters (rows x block_size), NULL if block_size is 0
+//! \param  [in ]  r              The residual vector (rows x 1)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_schur_add_block ( Rox_LinSys_Schur obj, const Rox_Sint id, const Rox_Array2D_Double Js, const Rox_Array2D_Double Jb, const Rox_Array2D_Double r );
+
+//! Solve the system with a deterministic reduction of the blocks in index order.
+//! The solution is stacked as [xs; xb_0; ...; xb_n-1], parameters of inactive blocks are set to 0.
+//! \param  [out]  x              The solution vector ((shared_size + blocks * block_size) x 1)
+//! \param  [in ]  obj            The system
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_schur_solve ( Rox_Array2D_Double x, const Rox_LinSys_Schur obj );
+
+//! @}
+
+#endif
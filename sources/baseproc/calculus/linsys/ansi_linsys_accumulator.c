@@ -0,0 +1,114 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_linsys_accumulator.c
+//
+//    Contents  : Implementation of ansi_linsys_accumulator module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_linsys_accumulator.h"
+#include <system/errors/errors.h>
+
+static inline void accumulate_n (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+)
+{
+   float LtL_block[ROX_LINSYS_ACCUMULATOR_MAX_SIZE * ( ROX_LINSYS_ACCUMULATOR_MAX_SIZE + 1 ) / 2];
+   float Lte_block[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+   float J_row[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+
+   const int size = n * ( n + 1 ) / 2;
+
+   for ( int start = 0; start < count; start += ROX_LINSYS_ACCUMULATOR_BLOCK )
+   {
+      int end = start + ROX_LINSYS_ACCUMULATOR_BLOCK;
+      if ( end > count ) end = count;
+
+      for ( int k = 0; k < size; k++ ) LtL_block[k] = 0.0f;
+      for ( int k = 0; k < n; k++ ) Lte_block[k] = 0.0f;
+
+      for ( int p = start; p < end; p++ )
+      {
+         const float ep = e[p];
+
+         for ( int k = 0; k < n; k++ )
+         {
+            J_row[k] = J[k][p];
+         }
+
+         // Update lower triangular part of the system
+         int id = 0;
+         for ( int k = 0; k < n; k++ )
+         {
+            for ( int l = 0; l <= k; l++ )
+            {
+               LtL_block[id++] += J_row[k] * J_row[l];
+            }
+
+            Lte_block[k] += J_row[k] * ep;
+         }
+      }
+
+      for ( int k = 0; k < size; k++ ) LtL[k] += (double) LtL_block[k];
+      for ( int k = 0; k < n; k++ ) Lte[k] += (double) Lte_block[k];
+   }
+}
+
+// Kernels for the usual sizes, unrolled by the compiler
+#define ROX_LINSYS_ACCUMULATE_FIXED(N) \
+static void accumulate_##N ( double * LtL, double * Lte, float ** J, const float * e, const int count ) \
+{ \
+   accumulate_n ( LtL, Lte, J, e, count, N ); \
+}
+
+ROX_LINSYS_ACCUMULATE_FIXED(6)
+ROX_LINSYS_ACCUMULATE_FIXED(8)
+ROX_LINSYS_ACCUMULATE_FIXED(10)
+
+int rox_ansi_linsys_accumulate (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+)
+{
+   int error = ROX_ERROR_NONE;
+
+   if ( n < 1 || n > ROX_LINSYS_ACCUMULATOR_MAX_SIZE )
+   { error = ROX_ERROR_BAD_SIZE; goto function_terminate; }
+
+   switch ( n )
+   {
+      case 6:
+         accumulate_6 ( LtL, Lte, J, e, count );
+         break;
+
+      case 8:
+         accumulate_8 ( LtL, Lte, J, e, count );
+         break;
+
+      case 10:
+         accumulate_10 ( LtL, Lte, J, e, count );
+         break;
+
+      default:
+         accumulate_n ( LtL, Lte, J, e, count, n );
+         break;
+   }
+
+function_terminate:
+   return error;
+}
@@ -0,0 +1,43 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_linsys_accumulator.h
+//
+//    Contents  : API of ansi_linsys_accumulator module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ANSI_LINSYS_ACCUMULATOR__
+#define __OPENROX_ANSI_LINSYS_ACCUMULATOR__
+
+//! Maximal number of parameters of an accumulated system
+#define ROX_LINSYS_ACCUMULATOR_MAX_SIZE 16
+
+//! Number of jacobian rows summed in float before the promotion to double
+#define ROX_LINSYS_ACCUMULATOR_BLOCK 256
+
+//! Add J'*J and J'*e to a system.
+//! The jacobian is stored parameter-wise: J[k][p] is the derivative of the error p wrt the parameter k.
+//! Rows are summed in float by blocks of ROX_LINSYS_ACCUMULATOR_BLOCK, each block is then added in double.
+//! \param  [out]  LtL            The packed lower triangular part of J'*J: element (k,l), l <= k, is at k*(k+1)/2 + l
+//! \param  [out]  Lte            The vector J'*e (n elements)
+//! \param  [in ]  J              The n arrays of count jacobian values
+//! \param  [in ]  e              The count errors
+//! \param  [in ]  count          The number of jacobian rows
+//! \param  [in ]  n              The number of parameters (at most ROX_LINSYS_ACCUMULATOR_MAX_SIZE)
+//! \return An error code
+int rox_ansi_linsys_accumulate (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+);
+
+#endif // __OPENROX_ANSI_LINSYS_ACCUMULATOR__
@@ -0,0 +1,139 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_linsys_accumulator_neon.c
+//
+//    Contents  : Implementation of ansi_linsys_accumulator module with NEON
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_linsys_accumulator.h"
+#include <system/errors/errors.h>
+#include <system/vectorisation/neon.h>
+
+static inline float hsum ( float32x4_t var )
+{
+   return ( vgetq_lane_f32 ( var, 0 ) + vgetq_lane_f32 ( var, 1 ) ) + ( vgetq_lane_f32 ( var, 2 ) + vgetq_lane_f32 ( var, 3 ) );
+}
+
+// Each lane accumulates one jacobian row out of four
+static inline void accumulate_n (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+)
+{
+   float32x4_t neon_LtL[ROX_LINSYS_ACCUMULATOR_MAX_SIZE * ( ROX_LINSYS_ACCUMULATOR_MAX_SIZE + 1 ) / 2];
+   float32x4_t neon_Lte[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+   float32x4_t neon_J[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+   float32x4_t neon_e;
+
+   const int size = n * ( n + 1 ) / 2;
+
+   for ( int start = 0; start < count; start += ROX_LINSYS_ACCUMULATOR_BLOCK )
+   {
+      int end = start + ROX_LINSYS_ACCUMULATOR_BLOCK;
+      if ( end > count ) end = count;
+
+      for ( int k = 0; k < size; k++ ) neon_LtL[k] = vdupq_n_f32 ( 0.0f );
+      for ( int k = 0; k < n; k++ ) neon_Lte[k] = vdupq_n_f32 ( 0.0f );
+
+      for ( int p = start; p < end; p += 4 )
+      {
+         if ( p + 4 <= end )
+         {
+            for ( int k = 0; k < n; k++ )
+            {
+               neon_J[k] = vld1q_f32 ( J[k] + p );
+            }
+            neon_e = vld1q_f32 ( e + p );
+         }
+         else
+         {
+            // Pad the last rows with zeros
+            float tail[4];
+
+            for ( int k = 0; k < n; k++ )
+            {
+               for ( int q = 0; q < 4; q++ ) tail[q] = ( p + q < end ) ? J[k][p + q] : 0.0f;
+               neon_J[k] = vld1q_f32 ( tail );
+            }
+
+            for ( int q = 0; q < 4; q++ ) tail[q] = ( p + q < end ) ? e[p + q] : 0.0f;
+            neon_e = vld1q_f32 ( tail );
+         }
+
+         // Update lower triangular part of the system
+         int id = 0;
+         for ( int k = 0; k < n; k++ )
+         {
+            for ( int l = 0; l <= k; l++ )
+            {
+               neon_LtL[id] = vmlaq_f32 ( neon_LtL[id], neon_J[k], neon_J[l] );
+               id++;
+            }
+
+            neon_Lte[k] = vmlaq_f32 ( neon_Lte[k], neon_J[k], neon_e );
+         }
+      }
+
+      for ( int k = 0; k < size; k++ ) LtL[k] += (double) hsum ( neon_LtL[k] );
+      for ( int k = 0; k < n; k++ ) Lte[k] += (double) hsum ( neon_Lte[k] );
+   }
+}
+
+// Kernels for the usual sizes, unrolled by the compiler
+#define ROX_LINSYS_ACCUMULATE_FIXED(N) \
+static void accumulate_##N ( double * LtL, double * Lte, float ** J, const float * e, const int count ) \
+{ \
+   accumulate_n ( LtL, Lte, J, e, count, N ); \
+}
+
+ROX_LINSYS_ACCUMULATE_FIXED(6)
+ROX_LINSYS_ACCUMULATE_FIXED(8)
+ROX_LINSYS_ACCUMULATE_FIXED(10)
+
+int rox_ansi_linsys_accumulate (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+)
+{
+   int error = ROX_ERROR_NONE;
+
+   if ( n < 1 || n > ROX_LINSYS_ACCUMULATOR_MAX_SIZE )
+   { error = ROX_ERROR_BAD_SIZE; goto function_terminate; }
+
+   switch ( n )
+   {
+      case 6:
+         accumulate_6 ( LtL, Lte, J, e, count );
+         break;
+
+      case 8:
+         accumulate_8 ( LtL, Lte, J, e, count );
+         break;
+
+      case 10:
+         accumulate_10 ( LtL, Lte, J, e, count );
+         break;
+
+      default:
+         accumulate_n ( LtL, Lte, J, e, count, n );
+         break;
+   }
+
+function_terminate:
+   return error;
+}
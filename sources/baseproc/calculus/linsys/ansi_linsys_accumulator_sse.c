@@ -0,0 +1,134 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_linsys_accumulator_sse.c
+//
+//    Contents  : Implementation of ansi_linsys_accumulator module with SSE
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_linsys_accumulator.h"
+#include <system/errors/errors.h>
+#include <system/vectorisation/sse.h>
+
+// Each lane accumulates one jacobian row out of four
+static inline void accumulate_n (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+)
+{
+   __m128 sse_LtL[ROX_LINSYS_ACCUMULATOR_MAX_SIZE * ( ROX_LINSYS_ACCUMULATOR_MAX_SIZE + 1 ) / 2];
+   __m128 sse_Lte[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+   __m128 sse_J[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+   __m128 sse_e;
+
+   const int size = n * ( n + 1 ) / 2;
+
+   for ( int start = 0; start < count; start += ROX_LINSYS_ACCUMULATOR_BLOCK )
+   {
+      int end = start + ROX_LINSYS_ACCUMULATOR_BLOCK;
+      if ( end > count ) end = count;
+
+      for ( int k = 0; k < size; k++ ) sse_LtL[k] = _mm_setzero_ps ( );
+      for ( int k = 0; k < n; k++ ) sse_Lte[k] = _mm_setzero_ps ( );
+
+      for ( int p = start; p < end; p += 4 )
+      {
+         if ( p + 4 <= end )
+         {
+            for ( int k = 0; k < n; k++ )
+            {
+               sse_J[k] = _mm_loadu_ps ( J[k] + p );
+            }
+            sse_e = _mm_loadu_ps ( e + p );
+         }
+         else
+         {
+            // Pad the last rows with zeros
+            float tail[4];
+
+            for ( int k = 0; k < n; k++ )
+            {
+               for ( int q = 0; q < 4; q++ ) tail[q] = ( p + q < end ) ? J[k][p + q] : 0.0f;
+               sse_J[k] = _mm_loadu_ps ( tail );
+            }
+
+            for ( int q = 0; q < 4; q++ ) tail[q] = ( p + q < end ) ? e[p + q] : 0.0f;
+            sse_e = _mm_loadu_ps ( tail );
+         }
+
+         // Update lower triangular part of the system
+         int id = 0;
+         for ( int k = 0; k < n; k++ )
+         {
+            for ( int l = 0; l <= k; l++ )
+            {
+               sse_LtL[id] = _mm_add_ps ( sse_LtL[id], _mm_mul_ps ( sse_J[k], sse_J[l] ) );
+               id++;
+            }
+
+            sse_Lte[k] = _mm_add_ps ( sse_Lte[k], _mm_mul_ps ( sse_J[k], sse_e ) );
+         }
+      }
+
+      for ( int k = 0; k < size; k++ ) LtL[k] += (double) rox_mm128_hsum_ps ( sse_LtL[k] );
+      for ( int k = 0; k < n; k++ ) Lte[k] += (double) rox_mm128_hsum_ps ( sse_Lte[k] );
+   }
+}
+
+// Kernels for the usual sizes, unrolled by the compiler
+#define ROX_LINSYS_ACCUMULATE_FIXED(N) \
+static void accumulate_##N ( double * LtL, double * Lte, float ** J, const float * e, const int count ) \
+{ \
+   accumulate_n ( LtL, Lte, J, e, count, N ); \
+}
+
+ROX_LINSYS_ACCUMULATE_FIXED(6)
+ROX_LINSYS_ACCUMULATE_FIXED(8)
+ROX_LINSYS_ACCUMULATE_FIXED(10)
+
+int rox_ansi_linsys_accumulate (
+   double * LtL,
+   double * Lte,
+   float ** J,
+   const float * e,
+   const int count,
+   const int n
+)
+{
+   int error = ROX_ERROR_NONE;
+
+   if ( n < 1 || n > ROX_LINSYS_ACCUMULATOR_MAX_SIZE )
+   { error = ROX_ERROR_BAD_SIZE; goto function_terminate; }
+
+   switch ( n )
+   {
+      case 6:
+         accumulate_6 ( LtL, Lte, J, e, count );
+         break;
+
+      case 8:
+         accumulate_8 ( LtL, Lte, J, e, count );
+         break;
+
+      case 10:
+         accumulate_10 ( LtL, Lte, J, e, count );
+         break;
+
+      default:
+         accumulate_n ( LtL, Lte, J, e, count, n );
+         break;
+   }
+
+function_terminate:
+   return error;
+}
@@ -17,9 +17,10 @@
 #include <stdio.h>
 #include <inout/system/errors_print.h>
 
-int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
-   double ** LtL_data, 
-   double ** Lte_data,
+int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi_row (
+   float ** L_data,
+   float * e_data,
+   int * count,
    double ** K_data,
    double ** tau_data,
    float ** Zi_data, 
@@ -30,7 +31,7 @@ int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
    float ** Id_data, 
    float ** Ia_data, 
    unsigned int ** Im_data,
-   int rows,
+   int v,
    int cols
 )
 {
@@ -39,51 +40,47 @@ int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
    int u_ini = 0;
    int v_ini = 0;
 
-   for (int v = 0; v < rows; v++)
+   double vr = (double) (v + v_ini);
+
+   for (int u = 0; u < cols; u++ )
    {
-      double vr = (double) (v + v_ini);
+      double L_row[8] = { 0.0 };
 
-      for (int u = 0; u < cols; u++ )
+      if ( Im_data[v][u] == 0 ) 
       {
-         double L_row[8] = { 0.0 };
-
-         if ( Im_data[v][u] == 0 ) 
-         {
-            continue; 
-         }
-         
-         double ur = (double) (u + u_ini);
-
-         double Iu_value = (double) Iu_data[v][u];
-         double Iv_value = (double) Iv_data[v][u];
+         for (int k = 0; k < 8; k++) L_data[k][u] = 0.0f;
+         e_data[u] = 0.0f;
+         continue; 
+      }
+      
+      double ur = (double) (u + u_ini);
 
-         double zi  = Zi_data [v][u];
-         double ziu = Ziu_data[v][u];
-         double ziv = Ziv_data[v][u];
-         
-         double e = (double) Id_data[v][u];
-         double a = (double) Ia_data[v][u];
+      double Iu_value = (double) Iu_data[v][u];
+      double Iv_value = (double) Iv_data[v][u];
 
-         error = rox_ansi_interaction_row_texture_matse3_model3d_zi ( L_row, ur, vr, Iu_value, Iv_value, zi, ziu, ziv, K_data, tau_data );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-         
-         // Interaction matrix for the light affine model
-         L_row[6] =   a;
-         L_row[7] = 1.0;
+      double zi  = Zi_data [v][u];
+      double ziu = Ziu_data[v][u];
+      double ziv = Ziv_data[v][u];
+      
+      double a = (double) Ia_data[v][u];
 
-         // Update lower triangular part of the system
-         for (int k = 0; k < 8; k++)
-         {
-            for (int l = 0; l <= k; l++)
-            {
-               LtL_data[k][l] += L_row[k] * L_row[l] ;
-            }
+      error = rox_ansi_interaction_row_texture_matse3_model3d_zi ( L_row, ur, vr, Iu_value, Iv_value, zi, ziu, ziv, K_data, tau_data );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      
+      // Interaction matrix for the light affine model
+      L_row[6] =   a;
+      L_row[7] = 1.0;
 
-            Lte_data[k][0] += L_row[k] * e;
-         }
+      for (int k = 0; k < 8; k++)
+      {
+         L_data[k][u] = (float) L_row[k];
       }
+
+      e_data[u] = Id_data[v][u];
    }
 
+   *count = cols;
+
 function_terminate:
    return error;
-}
\ No newline at end of file
+}
@@ -15,9 +15,12 @@
 #ifndef __OPENROX_ANSI_LINSYS_TEXTURE_MATSE3_LIGHT_AFFINE_MODEL3D_ZI__
 #define __OPENROX_ANSI_LINSYS_TEXTURE_MATSE3_LIGHT_AFFINE_MODEL3D_ZI__
 
-int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
-   double ** LtL_data, 
-   double ** Lte_data,
+//! Compute the jacobian rows and the errors of the image row v.
+//! Masked pixels give zero rows. The vectorised versions write the rows up to cols rounded to a multiple of 8.
+int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi_row (
+   float ** L_data,
+   float * e_data,
+   int * count,
    double ** K_data,
    double ** tau_data,
    float ** Zi_data, 
@@ -28,7 +31,7 @@ int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
    float ** Id_data, 
    float ** Ia_data, 
    unsigned int ** Im_data,
-   int rows,
+   int v,
    int cols
 );
 
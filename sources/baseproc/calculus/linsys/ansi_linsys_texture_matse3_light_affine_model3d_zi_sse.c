@@ -17,9 +17,10 @@
 #include <stdio.h>
 #include <baseproc/calculus/jacobians/sse_interaction_row_texture_matse3_model3d_zi.h>
 
-int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
-   double ** LtL_data, 
-   double ** Lte_data,
+int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi_row (
+   float ** L_data,
+   float * e_data,
+   int * count,
    double ** K_data,
    double ** tau_data,
    float ** Zi_data, 
@@ -30,7 +31,7 @@ int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
    float ** Id_data, 
    float ** Ia_data, 
    unsigned int ** Im_data,
-   int rows,
+   int v,
    int cols
 )
 {
@@ -52,109 +53,76 @@ int rox_ansi_linsys_texture_matse3_light_affine_model3d_zi (
    if (cols % 4) cols4++;
 
    __m128 sse_cols = _mm_set_ps1 ( (float) cols );
-   
-   __m128 sse_LtL[8][8], sse_Lte[8];
 
-   for (int v = 0; v < rows; v++)
+   float vr = (float) v;
+   __m128 sse_vr = _mm_set_ps1(vr);
+
+   unsigned int  *ptr_Im = Im_data[v];
+   float * ptr_Iu = Iu_data[v];
+   float * ptr_Iv = Iv_data[v];
+   float * ptr_Id = Id_data[v];
+   float * ptr_Ia = Ia_data[v];
+
+   float * ptr_Zi  = Zi_data[v] ;
+   float * ptr_Ziu = Ziu_data[v];
+   float * ptr_Ziv = Ziv_data[v];
+
+   __m128 sse_ur = _mm_set_ps(3, 2, 1, 0);
+
+   for ( int u = 0; u < cols4; u++ )
    {
-      float vr = (float) v;
-      __m128 sse_vr = _mm_set_ps1(vr);
+      __m128 sse_Im = _mm_loadu_ps( (float*) ptr_Im);
+      sse_Im = _mm_and_ps(sse_Im, _mm_cmplt_ps(sse_ur, sse_cols));
 
-      unsigned int  *ptr_Im = Im_data[v];
-      float * ptr_Iu = Iu_data[v];
-      float * ptr_Iv = Iv_data[v];
-      float * ptr_Id = Id_data[v];
-      float * ptr_Ia = Ia_data[v];
+      __m128 sse_L_row[8];
 
-      float * ptr_Zi  = Zi_data[v] ;
-      float * ptr_Ziu = Ziu_data[v];
-      float * ptr_Ziv = Ziv_data[v];
+      __m128 sse_Iu  = _mm_loadu_ps ( ptr_Iu );
+      __m128 sse_Iv  = _mm_loadu_ps ( ptr_Iv );
+      __m128 sse_Id  = _mm_loadu_ps ( ptr_Id );
+      __m128 sse_Ia  = _mm_loadu_ps ( ptr_Ia );
+      __m128 sse_Zi  = _mm_loadu_ps ( ptr_Zi );
+      __m128 sse_Ziu = _mm_loadu_ps ( ptr_Ziu);
+      __m128 sse_Ziv = _mm_loadu_ps ( ptr_Ziv);
 
-      __m128 sse_ur = _mm_set_ps(3, 2, 1, 0);
+      sse_Iu  = _mm_and_ps(sse_Iu, sse_Im);
+      sse_Iv  = _mm_and_ps(sse_Iv, sse_Im);
 
-      // Set avx_LtL and avx_Lte to 0
-      for ( int k = 0; k < 8; k++ )
-      {
-         for ( int l = 0; l <= k; l++ )
-         {
-            sse_LtL[k][l] = _mm_setzero_ps();
-         }
-         sse_Lte[k] = _mm_setzero_ps();
-      }
+      sse_Id  = _mm_and_ps(sse_Id, sse_Im);
+      sse_Ia  = _mm_and_ps(sse_Ia, sse_Im);
+      
+      sse_Zi  = _mm_and_ps(sse_Zi , sse_Im);
+      sse_Ziu = _mm_and_ps(sse_Ziu, sse_Im);
+      sse_Ziv = _mm_and_ps(sse_Ziv, sse_Im);
 
-      for ( int u = 0; u < cols4; u++ )
-      {
-         __m128 sse_Im = _mm_loadu_ps( (float*) ptr_Im);
-         sse_Im = _mm_and_ps(sse_Im, _mm_cmplt_ps(sse_ur, sse_cols));
-         
-         // unsigned int mask = _mm_movemask_ps(sse_Im);
-         
-         // // rox_mm128_printf_float(sse_Im);
-
-         // if (mask)
-         // {
-            __m128 sse_L_row[8];
-
-            __m128 sse_Iu  = _mm_loadu_ps ( ptr_Iu );
-            __m128 sse_Iv  = _mm_loadu_ps ( ptr_Iv );
-            __m128 sse_Id  = _mm_loadu_ps ( ptr_Id );
-            __m128 sse_Ia  = _mm_loadu_ps ( ptr_Ia );
-            __m128 sse_Zi  = _mm_loadu_ps ( ptr_Zi );
-            __m128 sse_Ziu = _mm_loadu_ps ( ptr_Ziu);
-            __m128 sse_Ziv = _mm_loadu_ps ( ptr_Ziv);
-
-            sse_Iu  = _mm_and_ps(sse_Iu, sse_Im);
-            sse_Iv  = _mm_and_ps(sse_Iv, sse_Im);
-
-            sse_Id  = _mm_and_ps(sse_Id, sse_Im);
-            sse_Ia  = _mm_and_ps(sse_Ia, sse_Im);
-            
-            sse_Zi  = _mm_and_ps(sse_Zi , sse_Im);
-            sse_Ziu = _mm_and_ps(sse_Ziu, sse_Im);
-            sse_Ziv = _mm_and_ps(sse_Ziv, sse_Im);
-
-            error = rox_sse_interaction_row_texture_matse3_model3d_zi ( sse_L_row, sse_ur, sse_vr, sse_Iu, sse_Iv, sse_Zi, sse_Ziu, sse_Ziv, sse_fu, sse_fv, sse_cu, sse_cv, sse_tau1, sse_tau2, sse_tau3 );
-            if (error) { goto function_terminate; }
-
-            // Interaction matrix for the light affine model
-            sse_L_row[6] = sse_Ia;
-            sse_L_row[7] = _mm_and_ps(sse_1, sse_Im);
-
-            // Update lower triangular part of the system
-            for ( int k = 0; k < 8; k++ )
-            {
-               for ( int l = 0; l <= k; l++ )
-               {
-                  sse_LtL[k][l] = _mm_add_ps(sse_LtL[k][l], _mm_mul_ps(sse_L_row[k], sse_L_row[l]));
-               }
-               sse_Lte[k] = _mm_add_ps(sse_Lte[k], _mm_mul_ps(sse_L_row[k], sse_Id));
-            }
-         // }
-         
-         ptr_Iu += 4;
-         ptr_Iv += 4;
-         ptr_Id += 4;
-         ptr_Ia += 4;
-         ptr_Im += 4;
-
-         ptr_Zi += 4;
-         ptr_Ziu += 4;
-         ptr_Ziv += 4;
-
-         sse_ur = _mm_add_ps ( sse_ur, sse_4 );
-      }
+      error = rox_sse_interaction_row_texture_matse3_model3d_zi ( sse_L_row, sse_ur, sse_vr, sse_Iu, sse_Iv, sse_Zi, sse_Ziu, sse_Ziv, sse_fu, sse_fv, sse_cu, sse_cv, sse_tau1, sse_tau2, sse_tau3 );
+      if (error) { goto function_terminate; }
 
-      // Transfer lower triangular part of the system from SSE to CPU
+      // Interaction matrix for the light affine model
+      sse_L_row[6] = sse_Ia;
+      sse_L_row[7] = _mm_and_ps(sse_1, sse_Im);
+
+      // Store the rows, masked lanes are zero
       for ( int k = 0; k < 8; k++ )
       {
-         for ( int l = 0; l <= k; l++ )
-         {
-            LtL_data[k][l] += rox_mm128_hsum_ps ( sse_LtL[k][l] );
-         }
-         Lte_data[k][0] += rox_mm128_hsum_ps ( sse_Lte[k] );
+         _mm_storeu_ps ( L_data[k] + 4 * u, sse_L_row[k] );
       }
+      _mm_storeu_ps ( e_data + 4 * u, sse_Id );
+
+      ptr_Iu += 4;
+      ptr_Iv += 4;
+      ptr_Id += 4;
+      ptr_Ia += 4;
+      ptr_Im += 4;
+
+      ptr_Zi += 4;
+      ptr_Ziu += 4;
+      ptr_Ziv += 4;
+
+      sse_ur = _mm_add_ps ( sse_ur, sse_4 );
    }
 
+   *count = cols;
+
 function_terminate:
    return error;
 }
@@ -0,0 +1,151 @@
+//==============================================================================
+//
+//    OPENROX   : File linsys_accumulator.c
+//
+//    Contents  : Implementation of linsys_accumulator module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "linsys_accumulator.h"
+#include "ansi_linsys_accumulator.h"
+
+#include <string.h>
+#include <system/memory/memory.h>
+#include <inout/system/errors_print.h>
+
+//! Number of image rows of a band
+#define ROX_LINSYS_ACCUMULATOR_BAND 8
+
+Rox_ErrorCode rox_linsys_accumulate_rows (
+   Rox_Matrix LtL,
+   Rox_Matrix Lte,
+   const Rox_Sint rows,
+   const Rox_Sint capacity,
+   const Rox_Linsys_Accumulator_Row row,
+   const Rox_Void * params
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double * partial = NULL;
+   Rox_ErrorCode * band_error = NULL;
+
+   if ( !LtL || !Lte || !row )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( rows < 0 || capacity < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Sint n = 0, cols = 0;
+   error = rox_array2d_double_get_size ( &n, &cols, LtL );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( n != cols || n > ROX_LINSYS_ACCUMULATOR_MAX_SIZE )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_array2d_double_check_size ( Lte, n, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double ** LtL_data = NULL;
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data, LtL );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double ** Lte_data = NULL;
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &Lte_data, Lte );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Each band has its own packed lower triangular part of LtL followed by Lte
+   const Rox_Sint size = n * ( n + 1 ) / 2;
+   const Rox_Sint bands = ( rows + ROX_LINSYS_ACCUMULATOR_BAND - 1 ) / ROX_LINSYS_ACCUMULATOR_BAND;
+
+   // Jacobian arrays are padded for the vectorised kernels
+   const Rox_Sint stride = ( capacity + 7 ) & ~7;
+
+   partial = (Rox_Double *) rox_memory_allocate ( sizeof ( Rox_Double ), ( bands + 1 ) * ( size + n ) );
+   band_error = (Rox_ErrorCode *) rox_memory_allocate ( sizeof ( Rox_ErrorCode ), bands + 1 );
+   if ( !partial || !band_error )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset ( partial, 0, sizeof ( Rox_Double ) * ( bands + 1 ) * ( size + n ) );
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Rox_Float * J[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+      Rox_Float * buffer = (Rox_Float *) rox_memory_allocate ( sizeof ( Rox_Float ), ( n + 1 ) * stride + 1 );
+
+      for ( Rox_Sint k = 0; k < n; k++ )
+      {
+         J[k] = buffer + k * stride;
+      }
+      Rox_Float * e = buffer + n * stride;
+
+#ifdef ROX_USES_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for ( Rox_Sint band = 0; band < bands; band++ )
+      {
+         Rox_Double * band_LtL = partial + band * ( size + n );
+         Rox_Double * band_Lte = band_LtL + size;
+
+         Rox_Sint first = band * ROX_LINSYS_ACCUMULATOR_BAND;
+         Rox_Sint last = first + ROX_LINSYS_ACCUMULATOR_BAND;
+         if ( last > rows ) last = rows;
+
+         band_error[band] = buffer ? ROX_ERROR_NONE : ROX_ERROR_NULL_POINTER;
+
+         for ( Rox_Sint i = first; i < last && !band_error[band]; i++ )
+         {
+            Rox_Sint count = 0;
+
+            band_error[band] = row ( J, e, &count, i, params );
+            if ( band_error[band] ) break;
+
+            if ( count < 0 || count > capacity )
+            { band_error[band] = ROX_ERROR_TOO_LARGE_VALUE; break; }
+
+            band_error[band] = rox_ansi_linsys_accumulate ( band_LtL, band_Lte, J, e, count, n );
+         }
+      }
+
+      rox_memory_delete ( buffer );
+   }
+
+   // Merge the bands in a fixed order
+   Rox_Double * total = partial + bands * ( size + n );
+
+   for ( Rox_Sint band = 0; band < bands; band++ )
+   {
+      error = band_error[band];
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      Rox_Double * band_data = partial + band * ( size + n );
+      for ( Rox_Sint k = 0; k < size + n; k++ )
+      {
+         total[k] += band_data[k];
+      }
+   }
+
+   // Unpack the symmetric system
+   for ( Rox_Sint k = 0; k < n; k++ )
+   {
+      for ( Rox_Sint l = 0; l <= k; l++ )
+      {
+         LtL_data[k][l] = total[k * ( k + 1 ) / 2 + l];
+         LtL_data[l][k] = LtL_data[k][l];
+      }
+
+      Lte_data[k][0] = total[size + k];
+   }
+
+function_terminate:
+   rox_memory_delete ( band_error );
+   rox_memory_delete ( partial );
+   return error;
+}
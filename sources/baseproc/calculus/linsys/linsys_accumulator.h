@@ -0,0 +1,64 @@
+//==============================================================================
+//
+//    OPENROX   : File linsys_accumulator.h
+//
+//    Contents  : API of linsys_accumulator module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_LINSYS_ACCUMULATOR__
+#define __OPENROX_LINSYS_ACCUMULATOR__
+
+#include <generated/array2d_double.h>
+#include <baseproc/maths/linalg/matrix.h>
+
+//! \ingroup Jacobians
+//! \addtogroup linsys
+//! @{
+
+//! Compute the jacobian rows of an image row.
+//! The jacobian is stored parameter-wise: J[k][p] is the derivative of the error p wrt the parameter k.
+//! Rows of masked pixels can either be skipped or set to zero.
+//! The arrays are allocated up to the capacity rounded to a multiple of 8, so that vectorised row functions can write whole registers.
+//! \param  [out]  J              The n arrays receiving the jacobian values
+//! \param  [out]  e              The array receiving the errors
+//! \param  [out]  count          The number of jacobian rows written (at most the capacity given to rox_linsys_accumulate_rows)
+//! \param  [in ]  i              The image row
+//! \param  [in ]  params         The parameters given to rox_linsys_accumulate_rows
+//! \return An error code
+typedef Rox_ErrorCode ( * Rox_Linsys_Accumulator_Row ) (
+   Rox_Float ** J,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+);
+
+//! Build the normal equations LtL = J'*J and Lte = J'*e of a dense system.
+//! Image rows are processed in parallel by bands of rows, the partial sums of the bands are merged in a fixed order
+//! so that the result does not depend on the number of threads.
+//! \param  [out]  LtL            The n x n symmetric matrix (n is at most 16)
+//! \param  [out]  Lte            The n x 1 vector
+//! \param  [in ]  rows           The number of image rows
+//! \param  [in ]  capacity       The maximal number of jacobian rows of an image row
+//! \param  [in ]  row            The function computing the jacobian rows of an image row
+//! \param  [in ]  params         The parameters given to the row function (shared by all the threads)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_accumulate_rows (
+   Rox_Matrix LtL,
+   Rox_Matrix Lte,
+   const Rox_Sint rows,
+   const Rox_Sint capacity,
+   const Rox_Linsys_Accumulator_Row row,
+   const Rox_Void * params
+);
+
+//! @}
+
+#endif // __OPENROX_LINSYS_ACCUMULATOR__
@@ -0,0 +1,492 @@
+//==============================================================================
+//
+//    OPENROX   : File linsys_steepest_descent.c
+//
+//    Contents  : Implementation of linsys_steepest_descent module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "linsys_steepest_descent.h"
+#include "linsys_accumulator.h"
+#include "ansi_linsys_accumulator.h"
+
+#include <string.h>
+#include <system/memory/memory.h>
+#include <baseproc/array/fill/fillval.h>
+#include <inout/system/errors_print.h>
+
+//! Number of image rows of a band
+#define ROX_LINSYS_STEEPEST_DESCENT_BAND 8
+
+typedef struct Rox_Linsys_Steepest_Descent_Params
+{
+   const struct Rox_Linsys_Steepest_Descent_Struct * steepest;
+   const Rox_Float * zeros;
+} Rox_Linsys_Steepest_Descent_Params;
+
+// Same jacobians as the forward builders linsys_texture_matsl3_light_affine,
+// rox_jacobian_tutvsr_light_affine_premul and rox_jacobian_tutvsusv_light_affine_premul
+static Rox_ErrorCode steepest_descent_pixel (
+   Rox_Float * J,
+   const enum Rox_Linsys_Steepest_Descent_Model model,
+   const Rox_Float Ia,
+   const Rox_Float Iu,
+   const Rox_Float Iv,
+   const Rox_Float u,
+   const Rox_Float v
+)
+{
+   Rox_Float z = -Iv * v;
+   Rox_Float w =  Iu * u;
+
+   switch ( model )
+   {
+      case Rox_Linsys_Steepest_Descent_Model_SL3_Light_Affine:
+      {
+         Rox_Float temp = z - w;
+
+         J[0] = Iu;
+         J[1] = Iv;
+         J[2] = Iu * v;
+         J[3] = Iv * u;
+         J[4] = w + z;
+         J[5] = temp + z;
+         J[6] = temp * u;
+         J[7] = temp * v;
+         J[8] = Ia;
+         J[9] = 1.0f;
+         break;
+      }
+
+      case Rox_Linsys_Steepest_Descent_Model_tu_tv_s_r_Light_Affine:
+      {
+         J[0] = Iu;
+         J[1] = Iv;
+         J[2] = Iu * v - Iv * u;
+         J[3] = 3.0f * ( Iu * u + Iv * v );
+         J[4] = Ia;
+         J[5] = 1.0f;
+         break;
+      }
+
+      case Rox_Linsys_Steepest_Descent_Model_tu_tv_su_sv_Light_Affine:
+      {
+         J[0] = Iu;
+         J[1] = Iv;
+         J[2] = z + w;
+         J[3] = 2.0f * z - w;
+         J[4] = Ia;
+         J[5] = 1.0f;
+         break;
+      }
+
+      default:
+      {
+         return ROX_ERROR_INVALID_VALUE;
+      }
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+static Rox_ErrorCode linsys_steepest_descent_hessian_row (
+   Rox_Float ** J,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Steepest_Descent_Params * p = (const Rox_Linsys_Steepest_Descent_Params *) params;
+   const struct Rox_Linsys_Steepest_Descent_Struct * sd = p->steepest;
+
+   const Rox_Sint start = sd->row_start[i];
+   const Rox_Sint n = sd->row_start[i + 1] - start;
+   const Rox_Sint stride = sd->rows * sd->cols;
+
+   for ( Rox_Sint k = 0; k < sd->size; k++ )
+   {
+      memcpy ( J[k], sd->steepest + k * stride + start, sizeof ( Rox_Float ) * n );
+   }
+   memcpy ( e, p->zeros, sizeof ( Rox_Float ) * n );
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
+Rox_ErrorCode rox_linsys_steepest_descent_new (
+   Rox_Linsys_Steepest_Descent * steepest,
+   const enum Rox_Linsys_Steepest_Descent_Model model,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Steepest_Descent ret = NULL;
+
+   if ( !steepest )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *steepest = NULL;
+
+   if ( rows < 1 || cols < 1 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_Linsys_Steepest_Descent) rox_memory_allocate ( sizeof ( *ret ), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->row_start = NULL;
+   ret->column = NULL;
+   ret->steepest = NULL;
+   ret->hessian = NULL;
+
+   switch ( model )
+   {
+      case Rox_Linsys_Steepest_Descent_Model_SL3_Light_Affine:
+         ret->size = 10;
+         break;
+
+      case Rox_Linsys_Steepest_Descent_Model_tu_tv_s_r_Light_Affine:
+      case Rox_Linsys_Steepest_Descent_Model_tu_tv_su_sv_Light_Affine:
+         ret->size = 6;
+         break;
+
+      default:
+      { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
+
+   ret->model = model;
+   ret->rows = rows;
+   ret->cols = cols;
+   ret->count = 0;
+
+   ret->row_start = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), rows + 1 );
+   ret->column = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), rows * cols );
+   ret->steepest = (Rox_Float *) rox_memory_allocate ( sizeof ( Rox_Float ), ret->size * rows * cols );
+   if ( !ret->row_start || !ret->column || !ret->steepest )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset ( ret->row_start, 0, sizeof ( Rox_Sint ) * ( rows + 1 ) );
+
+   error = rox_array2d_double_new ( &ret->hessian, ret->size, ret->size );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_fillval ( ret->hessian, 0.0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   *steepest = ret;
+
+function_terminate:
+   if ( error ) rox_linsys_steepest_descent_del ( &ret );
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_steepest_descent_del (
+   Rox_Linsys_Steepest_Descent * steepest
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Steepest_Descent todel = NULL;
+
+   if ( !steepest )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *steepest;
+   *steepest = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_array2d_double_del ( &todel->hessian );
+   rox_memory_delete ( todel->steepest );
+   rox_memory_delete ( todel->column );
+   rox_memory_delete ( todel->row_start );
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_steepest_descent_set_reference (
+   Rox_Linsys_Steepest_Descent steepest,
+   const Rox_Array2D_Float Ia,
+   const Rox_Array2D_Float Iu,
+   const Rox_Array2D_Float Iv,
+   const Rox_Imask Im
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float * zeros = NULL;
+   Rox_Array2D_Double Lte = NULL;
+
+   if ( !steepest || !Ia || !Iu || !Iv || !Im )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint rows = steepest->rows;
+   const Rox_Sint cols = steepest->cols;
+   const Rox_Sint stride = rows * cols;
+
+   error = rox_array2d_float_check_size ( Ia, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_check_size ( Iu, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_check_size ( Iv, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uint_check_size ( Im, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float ** Ia_data = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Ia_data, Ia );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float ** Iu_data = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iu_data, Iu );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float ** Iv_data = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iv_data, Iv );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Uint ** Im_data = NULL;
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &Im_data, Im );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Pack the jacobians of the reference pixels row by row
+   Rox_Float J[ROX_LINSYS_ACCUMULATOR_MAX_SIZE] = { 0 };
+   Rox_Sint count = 0;
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      Rox_Float v = (Rox_Float) i;
+
+      steepest->row_start[i] = count;
+
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         if ( !Im_data[i][j] ) continue;
+
+         error = steepest_descent_pixel ( J, steepest->model, Ia_data[i][j], Iu_data[i][j], Iv_data[i][j], (Rox_Float) j, v );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+
+         for ( Rox_Sint k = 0; k < steepest->size; k++ )
+         {
+            steepest->steepest[k * stride + count] = J[k];
+         }
+
+         steepest->column[count] = j;
+         count++;
+      }
+   }
+   steepest->row_start[rows] = count;
+   steepest->count = count;
+
+   // Hessian of all the reference pixels
+   zeros = (Rox_Float *) rox_memory_allocate ( sizeof ( Rox_Float ), cols );
+   if ( !zeros )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset ( zeros, 0, sizeof ( Rox_Float ) * cols );
+
+   error = rox_array2d_double_new ( &Lte, steepest->size, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Linsys_Steepest_Descent_Params params;
+   params.steepest = steepest;
+   params.zeros = zeros;
+
+   error = rox_linsys_accumulate_rows ( steepest->hessian, Lte, rows, cols, linsys_steepest_descent_hessian_row, &params );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   rox_array2d_double_del ( &Lte );
+   rox_memory_delete ( zeros );
+   return error;
+}
+
+Rox_ErrorCode rox_linsys_steepest_descent_make (
+   Rox_Matrix LtL,
+   Rox_Matrix Lte,
+   const Rox_Linsys_Steepest_Descent steepest,
+   const Rox_Array2D_Float Id,
+   const Rox_Imask Im
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double * partial = NULL;
+   Rox_ErrorCode * band_error = NULL;
+
+   if ( !LtL || !Lte || !steepest || !Id || !Im )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint n = steepest->size;
+   const Rox_Sint rows = steepest->rows;
+   const Rox_Sint cols = steepest->cols;
+   const Rox_Sint stride = rows * cols;
+
+   error = rox_array2d_double_check_size ( LtL, n, n );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_check_size ( Lte, n, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_check_size ( Id, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uint_check_size ( Im, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double ** LtL_data = NULL;
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data, LtL );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double ** Lte_data = NULL;
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &Lte_data, Lte );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double ** H_data = NULL;
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &H_data, steepest->hessian );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float ** Id_data = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Id_data, Id );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Uint ** Im_data = NULL;
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &Im_data, Im );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Each band has the packed lower triangular part of the removed hessian followed by Lte
+   const Rox_Sint size = n * ( n + 1 ) / 2;
+   const Rox_Sint bands = ( rows + ROX_LINSYS_STEEPEST_DESCENT_BAND - 1 ) / ROX_LINSYS_STEEPEST_DESCENT_BAND;
+   const Rox_Sint padded = ( cols + 7 ) & ~7;
+
+   partial = (Rox_Double *) rox_memory_allocate ( sizeof ( Rox_Double ), ( bands + 1 ) * ( size + n ) );
+   band_error = (Rox_ErrorCode *) rox_memory_allocate ( sizeof ( Rox_ErrorCode ), bands + 1 );
+   if ( !partial || !band_error )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset ( partial, 0, sizeof ( Rox_Double ) * ( bands + 1 ) * ( size + n ) );
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      // Jacobians of the reference pixels which are not valid anymore
+      Rox_Float * J[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+      Rox_Float * buffer = (Rox_Float *) rox_memory_allocate ( sizeof ( Rox_Float ), ( n + 1 ) * padded );
+
+      if ( buffer )
+      {
+         for ( Rox_Sint k = 0; k < n; k++ )
+         {
+            J[k] = buffer + k * padded;
+         }
+         memset ( buffer + n * padded, 0, sizeof ( Rox_Float ) * padded );
+      }
+
+#ifdef ROX_USES_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for ( Rox_Sint band = 0; band < bands; band++ )
+      {
+         Rox_Double * band_LtL = partial + band * ( size + n );
+         Rox_Double * band_Lte = band_LtL + size;
+         Rox_Double unused[ROX_LINSYS_ACCUMULATOR_MAX_SIZE] = { 0.0 };
+
+         Rox_Sint first = band * ROX_LINSYS_STEEPEST_DESCENT_BAND;
+         Rox_Sint last = first + ROX_LINSYS_STEEPEST_DESCENT_BAND;
+         if ( last > rows ) last = rows;
+
+         band_error[band] = buffer ? ROX_ERROR_NONE : ROX_ERROR_NULL_POINTER;
+
+         for ( Rox_Sint i = first; i < last && !band_error[band]; i++ )
+         {
+            Rox_Float Lte_row[ROX_LINSYS_ACCUMULATOR_MAX_SIZE];
+            Rox_Sint removed = 0;
+            Rox_Sint summed = 0;
+
+            for ( Rox_Sint k = 0; k < n; k++ ) Lte_row[k] = 0.0f;
+
+            for ( Rox_Sint p = steepest->row_start[i]; p < steepest->row_start[i + 1]; p++ )
+            {
+               Rox_Sint j = steepest->column[p];
+
+               if ( Im_data[i][j] )
+               {
+                  Rox_Float e = Id_data[i][j];
+
+                  for ( Rox_Sint k = 0; k < n; k++ )
+                  {
+                     Lte_row[k] += steepest->steepest[k * stride + p] * e;
+                  }
+
+                  // Promote to double as the accumulator does
+                  if ( ++summed == ROX_LINSYS_ACCUMULATOR_BLOCK )
+                  {
+                     for ( Rox_Sint k = 0; k < n; k++ ) { band_Lte[k] += (Rox_Double) Lte_row[k]; Lte_row[k] = 0.0f; }
+                     summed = 0;
+                  }
+               }
+               else
+               {
+                  for ( Rox_Sint k = 0; k < n; k++ )
+                  {
+                     J[k][removed] = steepest->steepest[k * stride + p];
+                  }
+                  removed++;
+               }
+            }
+
+            for ( Rox_Sint k = 0; k < n; k++ ) band_Lte[k] += (Rox_Double) Lte_row[k];
+
+            if ( removed > 0 )
+            {
+               band_error[band] = rox_ansi_linsys_accumulate ( band_LtL, unused, J, buffer + n * padded, removed, n );
+            }
+         }
+      }
+
+      rox_memory_delete ( buffer );
+   }
+
+   // Merge the bands in a fixed order
+   Rox_Double * total = partial + bands * ( size + n );
+
+   for ( Rox_Sint band = 0; band < bands; band++ )
+   {
+      error = band_error[band];
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      Rox_Double * band_data = partial + band * ( size + n );
+      for ( Rox_Sint k = 0; k < size + n; k++ )
+      {
+         total[k] += band_data[k];
+      }
+   }
+
+   // Remove the invalid pixels from the reference hessian
+   for ( Rox_Sint k = 0; k < n; k++ )
+   {
+      for ( Rox_Sint l = 0; l <= k; l++ )
+      {
+         LtL_data[k][l] = H_data[k][l] - total[k * ( k + 1 ) / 2 + l];
+         LtL_data[l][k] = LtL_data[k][l];
+      }
+
+      Lte_data[k][0] = total[size + k];
+   }
+
+function_terminate:
+   rox_memory_delete ( band_error );
+   rox_memory_delete ( partial );
+   return error;
+}
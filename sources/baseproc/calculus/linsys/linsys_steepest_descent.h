@@ -0,0 +1,129 @@
+//==============================================================================
+//
+//    OPENROX   : File linsys_steepest_descent.h
+//
+//    Contents  : API of linsys_steepest_descent module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_LINSYS_STEEPEST_DESCENT__
+#define __OPENROX_LINSYS_STEEPEST_DESCENT__
+
+#include <generated/array2d_double.h>
+#include <generated/array2d_float.h>
+#include <baseproc/maths/linalg/matrix.h>
+#include <baseproc/image/imask/imask.h>
+
+//! \ingroup Jacobians
+//! \addtogroup linsys
+//! @{
+
+//! The motion models of the inverse compositional trackers
+enum Rox_Linsys_Steepest_Descent_Model
+{
+   //! Homography plus affine illumination (10 parameters)
+   Rox_Linsys_Steepest_Descent_Model_SL3_Light_Affine,
+
+   //! Translation, scale and rotation plus affine illumination (6 parameters)
+   Rox_Linsys_Steepest_Descent_Model_tu_tv_s_r_Light_Affine,
+
+   //! Translation and two scales plus affine illumination (6 parameters)
+   Rox_Linsys_Steepest_Descent_Model_tu_tv_su_sv_Light_Affine,
+};
+
+//! The Rox_Linsys_Steepest_Descent_Struct object
+struct Rox_Linsys_Steepest_Descent_Struct
+{
+   //! The motion model
+   enum Rox_Linsys_Steepest_Descent_Model model;
+
+   //! The number of parameters
+   Rox_Sint size;
+
+   //! The image height
+   Rox_Sint rows;
+
+   //! The image width
+   Rox_Sint cols;
+
+   //! The number of reference pixels
+   Rox_Sint count;
+
+   //! The index of the first reference pixel of each image row (rows + 1 values)
+   Rox_Sint * row_start;
+
+   //! The column of each reference pixel
+   Rox_Sint * column;
+
+   //! The steepest descent images, parameter-wise: steepest[k * rows * cols + p] for the reference pixel p
+   Rox_Float * steepest;
+
+   //! The hessian J'*J on all the reference pixels
+   Rox_Array2D_Double hessian;
+};
+
+//! Define the pointer of the Rox_Linsys_Steepest_Descent_Struct
+typedef struct Rox_Linsys_Steepest_Descent_Struct * Rox_Linsys_Steepest_Descent;
+
+//! Create a steepest descent object
+//! \param  [out]  steepest       The newly created object
+//! \param  [in ]  model          The motion model
+//! \param  [in ]  rows           The image height
+//! \param  [in ]  cols           The image width
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_steepest_descent_new (
+   Rox_Linsys_Steepest_Descent * steepest,
+   const enum Rox_Linsys_Steepest_Descent_Model model,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+);
+
+//! Delete a steepest descent object
+//! \param  [in ]  steepest       The object to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_steepest_descent_del (
+   Rox_Linsys_Steepest_Descent * steepest
+);
+
+//! Compute the steepest descent images and the hessian of a reference image.
+//! The jacobian is the one of the forward builders of the model, evaluated on the reference only.
+//! \param  [out]  steepest       The steepest descent object
+//! \param  [in ]  Ia             The reference image
+//! \param  [in ]  Iu             The reference gradient along u
+//! \param  [in ]  Iv             The reference gradient along v
+//! \param  [in ]  Im             The mask of the reference pixels
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_steepest_descent_set_reference (
+   Rox_Linsys_Steepest_Descent steepest,
+   const Rox_Array2D_Float Ia,
+   const Rox_Array2D_Float Iu,
+   const Rox_Array2D_Float Iv,
+   const Rox_Imask Im
+);
+
+//! Build the normal equations from the precomputed steepest descent images.
+//! Lte is J'*e on the reference pixels valid in Im, LtL is the precomputed hessian
+//! minus the contribution of the reference pixels which are not valid in Im.
+//! \param  [out]  LtL            The result hessian matrix (J^t*J)
+//! \param  [out]  Lte            The result projected vector (J^t*e)
+//! \param  [in ]  steepest       The steepest descent object
+//! \param  [in ]  Id             The error image
+//! \param  [in ]  Im             The mask of the valid pixels
+//! \return An error code
+ROX_API Rox_ErrorCode rox_linsys_steepest_descent_make (
+   Rox_Matrix LtL,
+   Rox_Matrix Lte,
+   const Rox_Linsys_Steepest_Descent steepest,
+   const Rox_Array2D_Float Id,
+   const Rox_Imask Im
+);
+
+//! @}
+
+#endif // __OPENROX_LINSYS_STEEPEST_DESCENT__
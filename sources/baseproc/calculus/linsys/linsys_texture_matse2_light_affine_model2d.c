@@ -13,12 +13,62 @@
 //==============================================================================
 
 #include "linsys_texture_matse2_light_affine_model2d.h"
-
-#include <baseproc/array/fill/fillval.h>
-#include <baseproc/array/symmetrise/symmetrise.h>
+#include "linsys_accumulator.h"
 
 #include <inout/system/errors_print.h>
 
+typedef struct Rox_Linsys_Texture_Matse2_Light_Affine_Params
+{
+   Rox_Float ** dgx;
+   Rox_Float ** dgy;
+   Rox_Float ** dd;
+   Rox_Float ** da;
+   Rox_Uint ** dm;
+   Rox_Sint cols;
+   Rox_Float fu, fv, cu, cv;
+   Rox_Float r1, r2, r3, r4;
+} Rox_Linsys_Texture_Matse2_Light_Affine_Params;
+
+static Rox_ErrorCode jacobian_se2_light_affine_premul_row (
+   Rox_Float ** J,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Matse2_Light_Affine_Params * p = (const Rox_Linsys_Texture_Matse2_Light_Affine_Params *) params;
+
+   const Rox_Float fu = p->fu, fv = p->fv, cu = p->cu, cv = p->cv;
+   const Rox_Float r1 = p->r1, r2 = p->r2, r3 = p->r3, r4 = p->r4;
+
+   Rox_Float vr = (float)(i);
+   Rox_Sint n = 0;
+
+   for ( Rox_Sint j = 0; j < p->cols; j++)
+   {
+      if (!p->dm[i][j]) continue;
+
+      Rox_Float ur = (float)(j);
+
+      // Retrieve per pixel params
+      Rox_Float Iu = p->dgx[i][j];
+      Rox_Float Iv = p->dgy[i][j];
+
+      // Jacobian row
+      J[0][n] = Iu * fu * r1 + Iv * fv * r3;
+      J[1][n] = Iu * fu * r2 + Iv * fv * r4;
+      J[2][n] = (-Iu * r1 * (vr - cv) * fu * fu + (r2 * (ur - cu) * Iu - r3 * Iv * (vr - cv)) * fv * fu + Iv * fv * fv * r4 * (ur - cu)) / fu / fv;
+      J[3][n] = p->da[i][j];
+      J[4][n] = 1.0f;
+      e[n] = p->dd[i][j];
+      n++;
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode rox_jacobian_se2_light_affine_premul (
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -32,14 +82,9 @@ Rox_ErrorCode rox_jacobian_se2_light_affine_premul (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Matse2_Light_Affine_Params params;
    Rox_Sint cols, rows;
-   Rox_Double **dki, **dT, **dLtL, *dLte;
-   Rox_Float **dgx, ** dgy, ** dd, **da;
-   Rox_Float J[6];
-   Rox_Uint **dm;
-   Rox_Float fu, fv, cu, cv;
-   Rox_Float ur, vr, Iu, Iv, d;
-   Rox_Float r1,r2,r3,r4,a;
+   Rox_Double **dki, **dT;
 
    if (!LtL || !Lte) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -77,97 +122,41 @@ Rox_ErrorCode rox_jacobian_se2_light_affine_premul (
    error = rox_array2d_uint_check_size(mask, rows, cols); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_get_data_pointer ( &dLte, Lte);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dLtL, LtL);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    error = rox_array2d_double_get_data_pointer_to_pointer( &dki, calib_input);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   fu = (Rox_Float) dki[0][0];
-   fv = (Rox_Float) dki[1][1];
-   cu = (Rox_Float) dki[0][2];
-   cv = (Rox_Float) dki[1][2];
+   params.fu = (Rox_Float) dki[0][0];
+   params.fv = (Rox_Float) dki[1][1];
+   params.cu = (Rox_Float) dki[0][2];
+   params.cv = (Rox_Float) dki[1][2];
 
    // Get pose information as required by jacobian
    error = rox_array2d_double_get_data_pointer_to_pointer( &dT, pose_se2);
-   r1 = (Rox_Float) dT[0][0];
-   r2 = (Rox_Float) dT[0][1];
-   r3 = (Rox_Float) dT[1][0];
-   r4 = (Rox_Float) dT[1][1];
-
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &dm, mask);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dgx, gx);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dgy, gy);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   params.r1 = (Rox_Float) dT[0][0];
+   params.r2 = (Rox_Float) dT[0][1];
+   params.r3 = (Rox_Float) dT[1][0];
+   params.r4 = (Rox_Float) dT[1][1];
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dd, diff);
+   error = rox_array2d_uint_get_data_pointer_to_pointer( &params.dm, mask);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dgx, gx);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &da, mean);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dgy, gy);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillval(LtL, 0);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dd, diff);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillval(Lte, 0);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.da, mean);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for ( Rox_Sint i = 0; i < rows; i++)
-   {
-      vr = (float)(i);
-
-      for ( Rox_Sint j = 0; j < cols; j++)
-      {
-         if (!dm[i][j]) continue;
-
-         ur = (float)(j);
-
-         // Retrieve per pixel params
-         Iu = dgx[i][j];
-         Iv = dgy[i][j];
-         d = dd[i][j];
-         a = da[i][j];
-
-         // Jacobian row
-         J[0] = Iu * fu * r1 + Iv * fv * r3;
-         J[1] = Iu * fu * r2 + Iv * fv * r4;
-         J[2] = (-Iu * r1 * (vr - cv) * fu * fu + (r2 * (ur - cu) * Iu - r3 * Iv * (vr - cv)) * fv * fu + Iv * fv * fv * r4 * (ur - cu)) / fu / fv;
-
-         // Update system
-         for ( Rox_Sint k = 0; k < 3; k++)
-         {
-            for ( Rox_Sint l = 0; l <= k; l++)
-            {
-               dLtL[k][l] += J[k] * J[l];
-            }
-
-            dLte[k] += J[k] * d;
-         }
-
-         dLtL[3][0] += J[0] * a;
-         dLtL[3][1] += J[1] * a;
-         dLtL[3][2] += J[2] * a;
-         dLtL[3][3] += a * a;
-
-         dLtL[4][0] += J[0];
-         dLtL[4][1] += J[1];
-         dLtL[4][2] += J[2];
-         dLtL[4][3] += a;
-         dLtL[4][4] += 1;
-
-         dLte[3] += a * d;
-         dLte[4] += d;
-      }
-   }
+   params.cols = cols;
 
-   error = rox_array2d_double_symmetrise_lower ( LtL );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, rows, cols, jacobian_se2_light_affine_premul_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
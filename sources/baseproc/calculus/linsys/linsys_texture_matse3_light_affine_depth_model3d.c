@@ -15,11 +15,93 @@
 #include "linsys_texture_matse3_light_affine_depth_model3d.h"
 
 #include <baseproc/maths/maths_macros.h>
-#include <baseproc/array/fill/fillval.h>
-#include <baseproc/array/symmetrise/symmetrise.h>
 
 #include <inout/system/errors_print.h>
 
+#include "linsys_accumulator.h"
+
+typedef struct Rox_Linsys_Texture_Matse3_Light_Affine_Depth_Params
+{
+   Rox_Uint ** dvalidity;
+   Rox_Float ** dgx_avg;
+   Rox_Float ** dgy_avg;
+   Rox_Float ** ddepth;
+   Rox_Float ** ddiff;
+   Rox_Float ** ddiffz;
+   Rox_Float ** dmean;
+   Rox_Float ** dweight;
+   Rox_Sint width;
+   Rox_Sint height;
+   Rox_Double fu, fv, cu, cv;
+} Rox_Linsys_Texture_Matse3_Light_Affine_Depth_Params;
+
+static Rox_ErrorCode jacobian_se3_z_group_light_affine_weighted_premul_row (
+   Rox_Float ** J,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Matse3_Light_Affine_Depth_Params * p = (const Rox_Linsys_Texture_Matse3_Light_Affine_Depth_Params *) params;
+
+   const Rox_Double fu = p->fu, fv = p->fv, cu = p->cu, cv = p->cv;
+
+   Rox_Sint n = 0;
+
+   // Borders are not used
+   if ( i < 1 || i >= p->height - 1 ) goto function_terminate;
+
+   Rox_Double v = (Rox_Double) i;
+   Rox_Double y = (v - cv) / fv;
+
+   for (Rox_Sint j = 1; j < p->width - 1; j++)
+   {
+      if (!p->dvalidity[i][j]) continue;
+
+      // Gradient
+      Rox_Double Iu = (Rox_Double) p->dgx_avg[i][j];
+      Rox_Double Iv = (Rox_Double) p->dgy_avg[i][j];
+      Rox_Double w = (Rox_Double) p->dweight[i][j];
+
+      Rox_Double Z = (Rox_Double) p->ddepth[i][j];
+      Rox_Double u = (Rox_Double) j;
+      Rox_Double x = (u - cu) / fu;
+      Rox_Double a = (Rox_Double) p->dmean[i][j];
+
+      Rox_Double X = x * Z;
+      Rox_Double Y = y * Z;
+
+      // Photometric row
+      J[0][n] = (Rox_Float) (w * (Iu / Z * fu));
+      J[1][n] = (Rox_Float) (w * (Iv / Z * fv));
+      J[2][n] = (Rox_Float) (w * ((-Iu * fu * X - Iv * fv * Y) * pow(Z, -0.2e1)));
+      J[3][n] = (Rox_Float) (w * ((-fv * (Y * Y + Z * Z) * Iv - Iu * Y * fu * X) * pow(Z, -0.2e1)));
+      J[4][n] = (Rox_Float) (w * ((fu * (X * X + Z * Z) * Iu + Iv * X * fv * Y) * pow(Z, -0.2e1)));
+      J[5][n] = (Rox_Float) (w * ((Iv * fv * X - Iu * fu * Y) / Z));
+      J[6][n] = (Rox_Float) (w * a);
+      J[7][n] = (Rox_Float) w;
+      e[n] = (Rox_Float) (w * (Rox_Double) p->ddiff[i][j]);
+      n++;
+
+      // Depth row
+      J[0][n] = 0.0f;
+      J[1][n] = 0.0f;
+      J[2][n] = (Rox_Float) w;
+      J[3][n] = (Rox_Float) (w * Y);
+      J[4][n] = (Rox_Float) (- w * X);
+      J[5][n] = 0.0f;
+      J[6][n] = 0.0f;
+      J[7][n] = 0.0f;
+      e[n] = (Rox_Float) (w * (Rox_Double) p->ddiffz[i][j]);
+      n++;
+   }
+
+function_terminate:
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode rox_jacobian_se3_z_group_light_affine_weighted_premul(
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -37,19 +119,9 @@ Rox_ErrorCode rox_jacobian_se3_z_group_light_affine_weighted_premul(
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
 
-   Rox_Uint ** dvalidity = NULL;
-   Rox_Float ** dgx_avg = NULL;
-   Rox_Float ** dgy_avg = NULL;
-   Rox_Float ** ddepth = NULL;
-   Rox_Float ** ddiff = NULL;
-   Rox_Float ** ddiffz = NULL;
-   Rox_Float ** dmean = NULL;
-   Rox_Float ** dweight = NULL;
+   Rox_Linsys_Texture_Matse3_Light_Affine_Depth_Params params;
    Rox_Double ** dk = NULL;
 
-   Rox_Double ** dLtL = NULL;
-   Rox_Double  * dLte = NULL;
-
    // INPUT CHECK
    if (!LtL || !Lte )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -96,111 +168,44 @@ Rox_ErrorCode rox_jacobian_se3_z_group_light_affine_weighted_premul(
 
    // Retrieve pointers
 
-   error = rox_array2d_double_get_data_pointer ( &dLte, Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dLtL, LtL);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_uint_get_data_pointer_to_pointer ( &dvalidity, validity);
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &params.dvalidity, validity);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dgx_avg, gx_avg);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dgx_avg, gx_avg);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dgy_avg, gy_avg);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dgy_avg, gy_avg);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &ddepth, depth);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.ddepth, depth);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &ddiff, diff);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.ddiff, diff);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &ddiffz, diff_depth);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.ddiffz, diff_depth);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dmean, mean);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dmean, mean);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dweight, weight);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dweight, weight);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    error = rox_array2d_double_get_data_pointer_to_pointer( &dk, calib);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Retrieve input transformation
-   Rox_Double fu = dk[0][0];
-   Rox_Double fv = dk[1][1];
-   Rox_Double cu = dk[0][2];
-   Rox_Double cv = dk[1][2];
+   params.fu = dk[0][0];
+   params.fv = dk[1][1];
+   params.cu = dk[0][2];
+   params.cv = dk[1][2];
 
-   error = rox_array2d_double_fillval(LtL, 0);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillval(Lte, 0);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   // Compute per pixel jacobian
-   for (Rox_Sint i = 1; i < height - 1; i++)
-   {
-      Rox_Double J[2][8];
-
-      Rox_Double v = (Rox_Double) i;
-      Rox_Double y = (v - cv) / fv;
-
-      for (Rox_Sint j = 1; j < width - 1; j++)
-      {
-         if (!dvalidity[i][j]) continue;
-
-         // Gradient
-         Rox_Double Iu = (Rox_Double)dgx_avg[i][j];
-         Rox_Double Iv = (Rox_Double)dgy_avg[i][j];
-         Rox_Double w = (Rox_Double)dweight[i][j];
-
-         Rox_Double Z = (Rox_Double)ddepth[i][j];
-         Rox_Double u = (Rox_Double)j;
-         Rox_Double x = (u - cu) / fu;
-         Rox_Double d = w * (Rox_Double)ddiff[i][j];
-         Rox_Double dz = w * (Rox_Double)ddiffz[i][j];
-         Rox_Double a = (Rox_Double)dmean[i][j];
-
-         Rox_Double X = x * Z;
-         Rox_Double Y = y * Z;
-
-         J[0][0] = w * (Iu / Z * fu);
-         J[0][1] = w * (Iv / Z * fv);
-         J[0][2] = w * ((-Iu * fu * X - Iv * fv * Y) * pow(Z, -0.2e1));
-         J[0][3] = w * ((-fv * (Y * Y + Z * Z) * Iv - Iu * Y * fu * X) * pow(Z, -0.2e1));
-         J[0][4] = w * ((fu * (X * X + Z * Z) * Iu + Iv * X * fv * Y) * pow(Z, -0.2e1));
-         J[0][5] = w * ((Iv * fv * X - Iu * fu * Y) / Z);
-         J[0][6] = w * a;
-         J[0][7] = w;
-         
-         J[1][0] = 0;
-         J[1][1] = 0;
-         J[1][2] = w;
-         J[1][3] = w * Y;
-         J[1][4] = - w * X;
-         J[1][5] = 0;
-         J[1][6] = 0;
-         J[1][7] = 0;
-
-         // Jt * J
-         for (Rox_Sint k = 0; k < 8; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               dLtL[k][l] += J[0][k]*J[0][l] + J[1][k]*J[1][l];
-            }
-
-            dLte[k] += J[0][k] * d + J[1][k] * dz;
-         }
-      }
-   }
+   params.width = width;
+   params.height = height;
 
-   // Symmetrise lower triangular input
-   error = rox_array2d_double_symmetrise_lower ( LtL );
+   // Each pixel gives a photometric and a depth row
+   error = rox_linsys_accumulate_rows ( LtL, Lte, height, 2 * width, jacobian_se3_z_group_light_affine_weighted_premul_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
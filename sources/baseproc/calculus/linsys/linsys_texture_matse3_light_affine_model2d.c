@@ -17,11 +17,88 @@
 #include <float.h>
 
 #include <baseproc/maths/maths_macros.h>
-#include <baseproc/array/fill/fillval.h>
-#include <baseproc/array/symmetrise/symmetrise.h>
 
 #include <inout/system/errors_print.h>
 
+#include "linsys_accumulator.h"
+
+typedef struct Rox_Linsys_Texture_Matse3_Light_Affine_Model2d_Params
+{
+   Rox_Float ** Iu_data;
+   Rox_Float ** Iv_data;
+   Rox_Float ** dd;
+   Rox_Float ** da;
+   Rox_Uint ** dm;
+   Rox_Sint width;
+   Rox_Float ifu, ifv, icu, icv;
+   Rox_Float pa, pb, pc;
+   Rox_Float dizu, dizv;
+   Rox_Float taux, tauy, tauz;
+} Rox_Linsys_Texture_Matse3_Light_Affine_Model2d_Params;
+
+static Rox_ErrorCode linsys_texture_matse3_light_affine_model2d_row (
+   Rox_Float ** L,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Matse3_Light_Affine_Model2d_Params * p = (const Rox_Linsys_Texture_Matse3_Light_Affine_Model2d_Params *) params;
+
+   const Rox_Float ifu = p->ifu, ifv = p->ifv, icu = p->icu, icv = p->icv;
+   const Rox_Float dizu = p->dizu, dizv = p->dizv;
+   const Rox_Float taux = p->taux, tauy = p->tauy, tauz = p->tauz;
+
+   Rox_Float vr = (float) (i);
+   Rox_Float y = ifv * vr + icv;
+   Rox_Float riz = p->pb * y + p->pc;
+   Rox_Sint n = 0;
+
+   for (Rox_Sint j = 0; j < p->width; j++)
+   {
+      if (!p->dm[i][j]) continue;
+
+      Rox_Float ur = (float)(j);
+      Rox_Float x = ifu * ur + icu;
+      Rox_Float iz = p->pa * x + riz;
+
+      // Retrieve per pixel params
+      Rox_Float Iu = p->Iu_data[i][j];
+      Rox_Float Iv = p->Iv_data[i][j];
+
+      Rox_Float t1 = (Rox_Float) (tauy - tauz * y);
+      Rox_Float t2 = (Rox_Float) (1.0 + tauz * iz);
+      Rox_Float t3 = (Rox_Float) (t1 * dizv + t2 * ifv);
+      Rox_Float t4 = (Rox_Float) (taux - tauz * x);
+      Rox_Float t5 = (Rox_Float) (t4 * dizu);
+      Rox_Float t6 = (Rox_Float) (t5 * ifv + t3 * ifu);
+
+      t6 = (Rox_Float) (1.0 / t6);
+      t6 = t2 * t6;
+      t1 = t6 * (Iu * t3 - Iv * t1 * dizu);
+      t3 = t6 * (Iv * (t5 + t2 * ifu) - Iu * t4 * dizv);
+      t2 = (Rox_Float) (1.0 / t2);
+      t4 = - (t2 * t2 * (t1 * (x + taux * iz) + t3 * (y + tauy * iz)));
+      t3 = t3 * t2;
+      t1 = t1 * t2;
+
+      L[0][n] = t1 * iz;
+      L[1][n] = t3 * iz;
+      L[2][n] = t4 * iz;
+      L[3][n] = t4 * y - t3;
+      L[4][n] = t1 - t4 * x;
+      L[5][n] = t3 * x - t1 * y;
+      L[6][n] = p->da[i][j];
+      L[7][n] = 1.0f;
+      e[n] = p->dd[i][j];
+      n++;
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model2d (
    Rox_Matrix LtL,
    Rox_Matrix Lte,
@@ -39,6 +116,7 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model2d (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Matse3_Light_Affine_Model2d_Params params;
 
    // Check input
    if ( !LtL || !Lte )
@@ -84,36 +162,23 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model2d (
 
    // Buffer accessors
 
-   Rox_Double * Lte_data = NULL;
-   error = rox_array2d_double_get_data_pointer ( &Lte_data, Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** LtL_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &LtL_data, LtL );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    Rox_Double ** K_data = NULL;
    error = rox_array2d_double_get_data_pointer_to_pointer( &K_data, K );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uint ** dm = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &dm, Im );
+   error = rox_array2d_uint_get_data_pointer_to_pointer( &params.dm, Im );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iu_data, Iu );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Iu_data, Iu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iv_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iv_data, Iv );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Iv_data, Iv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** dd = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dd, Id );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dd, Id );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** da = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &da, Ia );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.da, Ia );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Calibration constants
@@ -122,18 +187,18 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model2d (
    Rox_Float cu = (Rox_Float) K_data[0][2];
    Rox_Float cv = (Rox_Float) K_data[1][2];
 
-   Rox_Float ifu = (Rox_Float) (1.0f / fu);
-   Rox_Float ifv = (Rox_Float) (1.0f / fv);
-   Rox_Float icu = (Rox_Float) (-cu / fu);
-   Rox_Float icv = (Rox_Float) (-cv / fv);
+   params.ifu = (Rox_Float) (1.0f / fu);
+   params.ifv = (Rox_Float) (1.0f / fv);
+   params.icu = (Rox_Float) (-cu / fu);
+   params.icv = (Rox_Float) (-cv / fv);
 
    // Plane depth prepare
-   Rox_Float pa = (Rox_Float) (-a / d);
-   Rox_Float pb = (Rox_Float) (-b / d);
-   Rox_Float pc = (Rox_Float) (-c / d);
+   params.pa = (Rox_Float) (-a / d);
+   params.pb = (Rox_Float) (-b / d);
+   params.pc = (Rox_Float) (-c / d);
 
-   Rox_Float dizu = pa * ifu;
-   Rox_Float dizv = pb * ifv;
+   params.dizu = params.pa * params.ifu;
+   params.dizv = params.pb * params.ifv;
 
    // Get pose information as required by jacobian
    Rox_Double ** T_data = NULL;
@@ -144,97 +209,13 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model2d (
    Rox_Float er21 = (Rox_Float) T_data[1][0]; Rox_Float er22 = (Rox_Float) T_data[1][1]; Rox_Float er23 = (Rox_Float) T_data[1][2]; Rox_Float ety = (Rox_Float) T_data[1][3];
    Rox_Float er31 = (Rox_Float) T_data[2][0]; Rox_Float er32 = (Rox_Float) T_data[2][1]; Rox_Float er33 = (Rox_Float) T_data[2][2]; Rox_Float etz = (Rox_Float) T_data[2][3];
 
-   Rox_Float taux = er11 * etx + ety * er21 + etz * er31;
-   Rox_Float tauy = er12 * etx + ety * er22 + etz * er32;
-   Rox_Float tauz = er13 * etx + er23 * ety + er33 * etz;
+   params.taux = er11 * etx + ety * er21 + etz * er31;
+   params.tauy = er12 * etx + ety * er22 + etz * er32;
+   params.tauz = er13 * etx + er23 * ety + er33 * etz;
 
-   // Zeroing jacobians
-   error = rox_array2d_double_fillval ( LtL, 0.0 );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillval ( Lte, 0.0 );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   for (Rox_Sint i = 0; i < height; i++)
-   {
-      Rox_Float vr = (float) (i);
-      Rox_Float y = ifv * vr + icv;
-      Rox_Float riz = pb * y + pc;
-
-      for (Rox_Sint j = 0; j < width; j++)
-      {
-         Rox_Float L[6];
-
-         if (!dm[i][j]) continue;
-
-         Rox_Float ur = (float)(j);
-         Rox_Float x = ifu * ur + icu;
-         Rox_Float iz = pa * x + riz;
-
-         // Retrieve per pixel params
-         Rox_Float Iu = Iu_data[i][j];
-         Rox_Float Iv = Iv_data[i][j];
-         Rox_Float dif = dd[i][j];
-         Rox_Float avg = da[i][j];
-
-         Rox_Float t1 = (Rox_Float) (tauy - tauz * y);
-         Rox_Float t2 = (Rox_Float) (1.0 + tauz * iz);
-         Rox_Float t3 = (Rox_Float) (t1 * dizv + t2 * ifv);
-         Rox_Float t4 = (Rox_Float) (taux - tauz * x);
-         Rox_Float t5 = (Rox_Float) (t4 * dizu);
-         Rox_Float t6 = (Rox_Float) (t5 * ifv + t3 * ifu);
-
-         t6 = (Rox_Float) (1.0 / t6);
-         t6 = t2 * t6;
-         t1 = t6 * (Iu * t3 - Iv * t1 * dizu);
-         t3 = t6 * (Iv * (t5 + t2 * ifu) - Iu * t4 * dizv);
-         t2 = (Rox_Float) (1.0 / t2);
-         t4 = - (t2 * t2 * (t1 * (x + taux * iz) + t3 * (y + tauy * iz)));
-         t3 = t3 * t2;
-         t1 = t1 * t2;
-
-         L[0] = t1 * iz;
-         L[1] = t3 * iz;
-         L[2] = t4 * iz;
-         L[3] = t4 * y - t3;
-         L[4] = t1 - t4 * x;
-         L[5] = t3 * x - t1 * y;
-
-         // Update system
-         for (Rox_Sint k = 0; k < 6; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               LtL_data[k][l] += L[k] * L[l];
-            }
-
-            Lte_data[k] += L[k] * dif;
-         }
-
-         LtL_data[6][0] += L[0] * avg;
-         LtL_data[6][1] += L[1] * avg;
-         LtL_data[6][2] += L[2] * avg;
-         LtL_data[6][3] += L[3] * avg;
-         LtL_data[6][4] += L[4] * avg;
-         LtL_data[6][5] += L[5] * avg;
-         LtL_data[6][6] += avg * avg;
-
-         LtL_data[7][0] += L[0];
-         LtL_data[7][1] += L[1];
-         LtL_data[7][2] += L[2];
-         LtL_data[7][3] += L[3];
-         LtL_data[7][4] += L[4];
-         LtL_data[7][5] += L[5];
-         LtL_data[7][6] += avg;
-         LtL_data[7][7] += 1;
-
-         Lte_data[6] += avg * dif;
-         Lte_data[7] += dif;
-      }
-   }
+   params.width = width;
 
-   // Symmetrise lower triangular input
-   error = rox_array2d_double_symmetrise_lower ( LtL );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, height, width, linsys_texture_matse3_light_affine_model2d_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
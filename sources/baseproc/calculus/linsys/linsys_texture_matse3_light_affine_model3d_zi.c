@@ -19,12 +19,40 @@
 
 #include "ansi_linsys_texture_matse3_light_affine_model3d_zi.h"
 
+#include "linsys_accumulator.h"
+
 #include <baseproc/maths/linalg/matrix.h>
-#include <baseproc/array/fill/fillzero.h>
-#include <baseproc/array/symmetrise/symmetrise.h>
 
 #include <inout/system/errors_print.h>
 
+typedef struct Rox_Linsys_Texture_Matse3_Light_Affine_Model3d_Zi_Params
+{
+   Rox_Double ** K_data;
+   Rox_Double ** tau_data;
+   Rox_Float ** Zi_data;
+   Rox_Float ** Ziu_data;
+   Rox_Float ** Ziv_data;
+   Rox_Float ** Iu_data;
+   Rox_Float ** Iv_data;
+   Rox_Float ** Id_data;
+   Rox_Float ** Ia_data;
+   Rox_Uint ** Im_data;
+   Rox_Sint cols;
+} Rox_Linsys_Texture_Matse3_Light_Affine_Model3d_Zi_Params;
+
+static Rox_ErrorCode linsys_texture_matse3_light_affine_model3d_zi_row (
+   Rox_Float ** L,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint v,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Matse3_Light_Affine_Model3d_Zi_Params * p = (const Rox_Linsys_Texture_Matse3_Light_Affine_Model3d_Zi_Params *) params;
+
+   return rox_ansi_linsys_texture_matse3_light_affine_model3d_zi_row ( L, e, count, p->K_data, p->tau_data, p->Zi_data, p->Ziu_data, p->Ziv_data, p->Iu_data, p->Iv_data, p->Id_data, p->Ia_data, p->Im_data, v, p->cols );
+}
+
 Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model3d_zi (
    Rox_Matrix LtL, 
    Rox_Matrix Lte,
@@ -41,6 +69,9 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model3d_zi (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Matse3_Light_Affine_Model3d_Zi_Params params;
+   Rox_MatSE3 Ti = NULL;
+   Rox_Array2D_Double tau = NULL;
 
    // Output check
    if ( !LtL || !Lte )
@@ -91,53 +122,30 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model3d_zi (
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Get pointers to data
-   Rox_Double ** LtL_data =  NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data, LtL );
+   error = rox_imask_get_data_pointer_to_pointer ( &params.Im_data, Im );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillzero ( LtL );
-   ROX_ERROR_CHECK_TERMINATE ( error  );
-
-   Rox_Double ** Lte_data =  NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &Lte_data, Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillzero ( Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Uint ** Im_data = NULL;
-   error = rox_imask_get_data_pointer_to_pointer ( &Im_data, Im );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Float ** Id_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Id_data, Id );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Id_data, Id );
    ROX_ERROR_CHECK_TERMINATE (error );
 
-   Rox_Float ** Ia_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Ia_data, Ia );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Ia_data, Ia );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iu_data, Iu );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iu_data, Iu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iv_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iv_data, Iv );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iv_data, Iv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Zi_data  =  NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Zi_data, Zi );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Zi_data, Zi );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Ziu_data =  NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Ziu_data, Ziv );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Ziu_data, Ziv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Ziv_data =  NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Ziv_data, Ziu );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Ziv_data, Ziu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_MatSE3 Ti = NULL;
    error = rox_matse3_new ( &Ti );
    ROX_ERROR_CHECK_TERMINATE ( error );
    
@@ -148,24 +156,19 @@ Rox_ErrorCode rox_linsys_texture_matse3_light_affine_model3d_zi (
    //rox_matse3_print(Ti);
 
    // NB tau = -inv(cRr)*ctr = rtc 
-   Rox_Array2D_Double tau = NULL;
    error = rox_array2d_double_new_subarray2d ( &tau, Ti, 0, 3, 3, 1 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** tau_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &tau_data, tau );
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &params.tau_data, tau );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** K_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &K_data, K );
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &params.K_data, K );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Compute Lte and lower triangular part of LtL
-   error = rox_ansi_linsys_texture_matse3_light_affine_model3d_zi ( LtL_data, Lte_data, K_data, tau_data, Zi_data, Ziu_data, Ziv_data, Iu_data, Iv_data, Id_data, Ia_data, Im_data, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   params.cols = cols;
 
-   // Symmetrise by copying the lower triangular part into the upper triangular part 
-   error = rox_array2d_double_symmetrise_lower ( LtL );
+   // Compute the symmetric system from the jacobian rows
+   error = rox_linsys_accumulate_rows ( LtL, Lte, rows, cols, linsys_texture_matse3_light_affine_model3d_zi_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
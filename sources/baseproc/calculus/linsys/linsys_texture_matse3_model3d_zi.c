@@ -19,11 +19,76 @@
 
 #include <baseproc/calculus/jacobians/interaction_row_texture_matse3_model3d_zi.h>
 #include <baseproc/maths/linalg/matrix.h>
-#include <baseproc/array/fill/fillzero.h>
-#include <baseproc/array/symmetrise/symmetrise.h>
 #include <inout/system/print.h>
 #include <inout/system/errors_print.h>
 
+#include "linsys_accumulator.h"
+
+typedef struct Rox_Linsys_Texture_Matse3_Model3d_Zi_Params
+{
+   Rox_Uint ** Im_data;
+   Rox_Float ** Id_data;
+   Rox_Float ** Iu_data;
+   Rox_Float ** Iv_data;
+   Rox_Float ** Zi_data;
+   Rox_Float ** Ziu_data;
+   Rox_Float ** Ziv_data;
+   Rox_Sint cols;
+   Rox_Sint u_ini;
+   Rox_Sint v_ini;
+   Rox_MatUT3 K;
+   Rox_Matrix tau;
+} Rox_Linsys_Texture_Matse3_Model3d_Zi_Params;
+
+static Rox_ErrorCode linsys_texture_matse3_model3d_zi_row (
+   Rox_Float ** L,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint v,
+   const Rox_Void * params
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   const Rox_Linsys_Texture_Matse3_Model3d_Zi_Params * p = (const Rox_Linsys_Texture_Matse3_Model3d_Zi_Params *) params;
+
+   Rox_Double vr = (Rox_Double) (v + p->v_ini);
+   Rox_Sint n = 0;
+
+   for (Rox_Sint u = 0; u < p->cols; u++ )
+   {
+      Rox_Double L_row[6] = { 0.0 };
+
+      if ( p->Im_data[v][u] == 0 ) 
+      {
+         continue; 
+      }
+      
+      Rox_Double ur = (Rox_Double) (u + p->u_ini);
+
+      Rox_Double Iu_value = p->Iu_data[v][u];
+      Rox_Double Iv_value = p->Iv_data[v][u];
+
+      Rox_Double zi  = p->Zi_data [v][u];
+      Rox_Double ziu = p->Ziu_data[v][u];
+      Rox_Double ziv = p->Ziv_data[v][u];
+
+      error = rox_interaction_row_texture_matse3_model3d_zi ( L_row, ur, vr, Iu_value, Iv_value, zi, ziu, ziv, p->K, p->tau );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      for (Rox_Sint k = 0; k < 6; k++)
+      {
+         L[k][n] = (Rox_Float) L_row[k];
+      }
+
+      e[n] = p->Id_data[v][u];
+      n++;
+   }
+
+function_terminate:
+   *count = n;
+   return error;
+}
+
 Rox_ErrorCode rox_linsys_texture_matse3_model3d_zi (
    Rox_Matrix LtL, 
    Rox_Matrix Lte,
@@ -40,8 +105,9 @@ Rox_ErrorCode rox_linsys_texture_matse3_model3d_zi (
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
 
-   Rox_Sint u_ini = 0;
-   Rox_Sint v_ini = 0;
+   Rox_Linsys_Texture_Matse3_Model3d_Zi_Params params;
+   Rox_MatSE3 Ti = NULL;
+   Rox_Array2D_Double tau = NULL;
 
    // Output check
    if ( !LtL || !Lte )
@@ -51,109 +117,47 @@ Rox_ErrorCode rox_linsys_texture_matse3_model3d_zi (
    if ( !Im || !Iu || !Iv || !Zi || !Ziu || !Ziv || !Id || !T || !K ) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   error = rox_array2d_double_fillzero ( LtL );
-   ROX_ERROR_CHECK_TERMINATE ( error  );
-
-   error = rox_array2d_double_fillzero ( Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    Rox_Sint cols = 0, rows = 0;
    error = rox_array2d_float_get_size ( &rows, &cols, Zi );
    ROX_ERROR_CHECK_TERMINATE ( error );
    
-   Rox_Uint ** Im_data = NULL;
-   error = rox_imask_get_data_pointer_to_pointer ( &Im_data, Im );
+   error = rox_imask_get_data_pointer_to_pointer ( &params.Im_data, Im );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Id_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Id_data, Id );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Id_data, Id );
    ROX_ERROR_CHECK_TERMINATE (error );
 
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iu_data, Iu );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iu_data, Iu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iv_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iv_data, Iv );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iv_data, Iv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Zi_data  =  NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Zi_data, Zi );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Zi_data, Zi );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Ziu_data =  NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Ziu_data, Ziv );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Ziu_data, Ziv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Ziv_data =  NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Ziv_data, Ziu );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Ziv_data, Ziu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** LtL_data =  NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data, LtL );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** Lte_data =  NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &Lte_data, Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_MatSE3 Ti = NULL;
    error = rox_matse3_new ( &Ti );
    ROX_ERROR_CHECK_TERMINATE ( error );
    
    error = rox_matse3_inv ( Ti, T );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   //rox_matse3_print(T);
-   //rox_matse3_print(Ti);
-
-   Rox_Array2D_Double tau = NULL;
    error = rox_array2d_double_new_subarray2d ( &tau, Ti, 0, 3, 3, 1 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for (Rox_Sint v = 0; v < rows; v++)
-   {
-      Rox_Double vr = (Rox_Double) (v + v_ini);
-
-      for (Rox_Sint u = 0; u < cols; u++ )
-      {
-	      Rox_Double L_row[6] = { 0.0 };
-
-         if ( Im_data[v][u] == 0 ) 
-         {
-            continue; 
-         }
-         
-         Rox_Double ur = (Rox_Double) (u + u_ini);
-
-         Rox_Double Iu_value = Iu_data[v][u];
-         Rox_Double Iv_value = Iv_data[v][u];
-
-         Rox_Double zi  = Zi_data [v][u];
-         Rox_Double ziu = Ziu_data[v][u];
-         Rox_Double ziv = Ziv_data[v][u];
-         
-         Rox_Double e  = Id_data[v][u]; 
-
-	      error = rox_interaction_row_texture_matse3_model3d_zi ( L_row, ur, vr, Iu_value, Iv_value, zi, ziu, ziv, K, tau );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-         
-
-         // Update lower triangular part of the system
-         for (Rox_Sint k = 0; k < 6; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               LtL_data[k][l] += L_row[k] * L_row[l];
-            }
-
-            Lte_data[k][0] += L_row[k] * e;
-         }
-
-      }
-   }
+   params.cols = cols;
+   params.u_ini = 0;
+   params.v_ini = 0;
+   params.K = K;
+   params.tau = tau;
 
-   error = rox_array2d_double_symmetrise_lower ( LtL );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, rows, cols, linsys_texture_matse3_model3d_zi_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
@@ -13,11 +13,63 @@
 //==============================================================================
 
 #include "linsys_texture_matsl3_light_affine.h"
-#include "ansi_linsys_texture_matsl3_light_affine.h"
+#include "linsys_accumulator.h"
 
-#include <baseproc/array/fill/fillval.h>
 #include <inout/system/errors_print.h>
 
+typedef struct Rox_Linsys_Texture_Matsl3_Light_Affine_Params
+{
+   Rox_Float ** Id_data;
+   Rox_Float ** Ia_data;
+   Rox_Float ** Iu_data;
+   Rox_Float ** Iv_data;
+   Rox_Uint ** Im_data;
+   Rox_Sint cols;
+} Rox_Linsys_Texture_Matsl3_Light_Affine_Params;
+
+static Rox_ErrorCode linsys_texture_matsl3_light_affine_row (
+   Rox_Float ** J,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Matsl3_Light_Affine_Params * p = (const Rox_Linsys_Texture_Matsl3_Light_Affine_Params *) params;
+
+   Rox_Float v = (Rox_Float) i;
+   Rox_Sint n = 0;
+
+   for (Rox_Sint j = 0; j < p->cols; j++)
+   {
+      if (!p->Im_data[i][j]) continue;
+
+      Rox_Float u = (Rox_Float) j;
+
+      Rox_Float Iu = p->Iu_data[i][j];
+      Rox_Float Iv = p->Iv_data[i][j];
+      Rox_Float z = -Iv * v;
+      Rox_Float w =  Iu * u;
+      Rox_Float temp = z - w;
+
+      J[0][n] = Iu;
+      J[1][n] = Iv;
+      J[2][n] = Iu * v;
+      J[3][n] = Iv * u;
+      J[4][n] = w + z;
+      J[5][n] = temp + z;
+      J[6][n] = temp * u;
+      J[7][n] = temp * v;
+      J[8][n] = p->Ia_data[i][j];
+      J[9][n] = 1.0f;
+      e[n] = p->Id_data[i][j];
+      n++;
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode linsys_texture_matsl3_light_affine (
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -29,6 +81,7 @@ Rox_ErrorCode linsys_texture_matsl3_light_affine (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Matsl3_Light_Affine_Params params;
 
    if (!LtL || !Lte )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -61,100 +114,26 @@ Rox_ErrorCode linsys_texture_matsl3_light_affine (
    error = rox_array2d_double_check_size(Lte, 10, 1); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillval(LtL, 0.0); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillval(Lte, 0.0); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double **LtL_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &LtL_data, LtL);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** Lte_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &Lte_data, Lte);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   Rox_Float ** Id_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Id_data, Id);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Id_data, Id);
    ROX_ERROR_CHECK_TERMINATE ( error );
    
-   Rox_Float ** Ia_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Ia_data, Ia);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Ia_data, Ia);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iu_data, Iu);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Iu_data, Iu);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iv_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iv_data, Iv);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Iv_data, Iv);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uint ** Im_data = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &Im_data, Im);
+   error = rox_array2d_uint_get_data_pointer_to_pointer( &params.Im_data, Im);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   if(1)
-   {
+   params.cols = cols;
 
-   error = rox_ansi_linsys_texture_matsl3_light_affine ( LtL_data, Lte_data[0], Iu_data, Iv_data, Id_data, Ia_data, Im_data, rows, cols );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, rows, cols, linsys_texture_matsl3_light_affine_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   }
-else
-{
-   for (Rox_Sint i = 0; i < rows; i++)
-   {
-      Rox_Double v = (Rox_Double) i;
-
-      for (Rox_Sint j = 0; j < cols; j++)
-      {
-         Rox_Double J[10];
-
-         if (!Im_data[i][j]) continue;
-
-         Rox_Double u = (Rox_Double) j;
-
-         Rox_Double d = Id_data[i][j];
-         Rox_Double Iu = Iu_data[i][j];
-         Rox_Double Iv = Iv_data[i][j];
-         Rox_Double z = -Iv * v;
-         Rox_Double w =  Iu * u;
-         Rox_Double temp = z - w;
-
-         J[0] = Iu;
-         J[1] = Iv;
-         J[2] = Iu * v;
-         J[3] = Iv * u;
-         J[4] = w + z;
-         J[5] = temp + z;
-         J[6] = temp * u;
-         J[7] = temp * v;
-         J[8] = Ia_data[i][j];
-         J[9] = 1.0;
-
-         for (Rox_Sint k = 0; k < 10; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               LtL_data[k][l] += J[k]*J[l];
-            }
-
-            Lte_data[k][0] += J[k] * d;
-         }
-      }
-   }
-
-   for (Rox_Sint k = 0; k < 10; k++)
-   {
-      for (Rox_Sint l = 0; l <= k; l++)
-      {
-         LtL_data[l][k] = LtL_data[k][l];
-      }
-   }
-}
-
 function_terminate:
    return error;
 }
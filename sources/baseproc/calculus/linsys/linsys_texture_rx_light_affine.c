@@ -13,10 +13,49 @@
 //==============================================================================
 
 #include "linsys_texture_rx_light_affine.h"
+#include "linsys_accumulator.h"
 
-#include <baseproc/array/fill/fillval.h>
 #include <inout/system/errors_print.h>
 
+typedef struct Rox_Linsys_Texture_Rx_Light_Affine_Params
+{
+   Rox_Float ** Id_data;
+   Rox_Float ** Iu_data;
+   Rox_Uint ** Im_data;
+   Rox_Sint width;
+   Rox_Sint height;
+} Rox_Linsys_Texture_Rx_Light_Affine_Params;
+
+static Rox_ErrorCode linsys_texture_rx_light_affine_row (
+   Rox_Float ** L,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Rx_Light_Affine_Params * p = (const Rox_Linsys_Texture_Rx_Light_Affine_Params *) params;
+
+   Rox_Sint n = 0;
+
+   // Border rows and columns are not used
+   if ( i > 0 && i < p->height - 1 )
+   {
+      for (Rox_Sint j = 1; j < p->width - 1; j++)
+      {
+         if ( !p->Im_data[i][j] ) continue;
+
+         L[0][n] = p->Iu_data[i][j];
+         L[1][n] = 1.0f;
+         e[n] = p->Id_data[i][j];
+         n++;
+      }
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode linsys_texture_rx_light_affine (
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -26,6 +65,7 @@ Rox_ErrorCode linsys_texture_rx_light_affine (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Rx_Light_Affine_Params params;
 
    if ( !LtL || !Lte )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -52,69 +92,21 @@ Rox_ErrorCode linsys_texture_rx_light_affine (
    error = rox_array2d_float_check_size ( Id, height, width ); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillval ( LtL, 0.0 ); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillval ( Lte, 0.0 ); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** LtL_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data, LtL );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Id_data, Id );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** Lte_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &Lte_data, Lte );
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iu_data, Iu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Id_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Id_data, Id );
+   error = rox_array2d_uint_get_data_pointer_to_pointer( &params.Im_data, Im );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iu_data, Iu );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   params.width = width;
+   params.height = height;
 
-   Rox_Uint ** Im_data = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &Im_data, Im );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, height, width, linsys_texture_rx_light_affine_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Sint count = 0;
-   for (Rox_Sint i = 1; i < height - 1; i++)
-   {
-      for (Rox_Sint j = 1; j < width - 1; j++)
-      {
-         Rox_Double L[2];
-
-         if ( !Im_data[i][j] ) continue;
-
-         Rox_Double d = Id_data[i][j];
-         Rox_Double Iu_val = Iu_data[i][j];
-
-         L[0] = Iu_val;
-         L[1] = 1.0;
-
-         for (Rox_Sint k = 0; k < 2; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               LtL_data[k][l] += L[k]*L[l];
-            }
-
-            Lte_data[k][0] += L[k] * d;
-         }
-
-         count++;
-      }
-   }
-
-   for (Rox_Sint k = 0; k < 2; k++)
-   {
-      for (Rox_Sint l = 0; l <= k; l++)
-      {
-         LtL_data[l][k] = LtL_data[k][l];
-      }
-   }
-
 function_terminate:
    return error;
 }
@@ -13,10 +13,51 @@
 //==============================================================================
 
 #include "linsys_texture_rxry_light_affine.h"
+#include "linsys_accumulator.h"
 
-#include <baseproc/array/fill/fillval.h>
 #include <inout/system/errors_print.h>
 
+typedef struct Rox_Linsys_Texture_Rxry_Light_Affine_Params
+{
+   Rox_Float ** dd;
+   Rox_Float ** dgx;
+   Rox_Float ** dgy;
+   Rox_Uint ** dm;
+   Rox_Sint cols;
+   Rox_Sint rows;
+} Rox_Linsys_Texture_Rxry_Light_Affine_Params;
+
+static Rox_ErrorCode linsys_texture_rxry_light_affine_row (
+   Rox_Float ** J,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Rxry_Light_Affine_Params * p = (const Rox_Linsys_Texture_Rxry_Light_Affine_Params *) params;
+
+   Rox_Sint n = 0;
+
+   // Border rows and columns are not used
+   if ( i > 0 && i < p->rows - 1 )
+   {
+      for (Rox_Sint j = 1; j < p->cols - 1; j++)
+      {
+         if (!p->dm[i][j]) continue;
+
+         J[0][n] = p->dgx[i][j];
+         J[1][n] = p->dgy[i][j];
+         J[2][n] = 1.0f;
+         e[n] = p->dd[i][j];
+         n++;
+      }
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode linsys_texture_rxry_light_affine (
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -27,6 +68,7 @@ Rox_ErrorCode linsys_texture_rxry_light_affine (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Rxry_Light_Affine_Params params;
 
    if ( !LtL || !Lte )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -56,75 +98,24 @@ Rox_ErrorCode linsys_texture_rxry_light_affine (
    error = rox_array2d_float_check_size(diffs, rows, cols); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillval(LtL, 0.0); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillval(Lte, 0.0); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** dLtL = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dLtL, LtL);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dd, diffs);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** djtf = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &djtf, Lte);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dgx, gradient_x);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** dd= NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dd, diffs);
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.dgy, gradient_y);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** dgx = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dgx, gradient_x);
+   error = rox_array2d_uint_get_data_pointer_to_pointer( &params.dm, input_mask);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** dgy = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &dgy, gradient_y);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   params.cols = cols;
+   params.rows = rows;
 
-   Rox_Uint ** dm = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &dm, input_mask);
+   error = rox_linsys_accumulate_rows ( LtL, Lte, rows, cols, linsys_texture_rxry_light_affine_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Sint count = 0;
-   for (Rox_Sint i = 1; i < rows - 1; i++)
-   {
-      for (Rox_Sint j = 1; j < cols - 1; j++)
-      {
-         Rox_Double J[3];
-
-         if (!dm[i][j]) continue;
-
-         Rox_Double d = dd[i][j];
-         Rox_Double Iu = dgx[i][j];
-         Rox_Double Iv = dgy[i][j];
-
-         J[0] = Iu;
-         J[1] = Iv;
-         J[2] = 1;
-
-         for (Rox_Sint k = 0; k < 3; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               dLtL[k][l] += J[k]*J[l];
-            }
-
-            djtf[k][0] += J[k] * d;
-         }
-
-         count++;
-      }
-   }
-
-   for (Rox_Sint k = 0; k < 3; k++)
-   {
-      for (Rox_Sint l = 0; l <= k; l++)
-      {
-         dLtL[l][k] = dLtL[k][l];
-      }
-   }
-
 function_terminate:
    return error;
 }
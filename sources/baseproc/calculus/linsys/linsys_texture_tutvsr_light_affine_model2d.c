@@ -13,10 +13,56 @@
 //==============================================================================
 
 #include "linsys_texture_tutvsr_light_affine_model2d.h"
+#include "linsys_accumulator.h"
 
-#include <baseproc/array/fill/fillval.h>
 #include <inout/system/errors_print.h>
 
+typedef struct Rox_Linsys_Texture_Tutvsr_Light_Affine_Params
+{
+   Rox_Float ** Id_data;
+   Rox_Float ** Ia_data;
+   Rox_Float ** Iu_data;
+   Rox_Float ** Iv_data;
+   Rox_Uint ** Im_data;
+   Rox_Sint width;
+} Rox_Linsys_Texture_Tutvsr_Light_Affine_Params;
+
+static Rox_ErrorCode jacobian_tutvsr_light_affine_premul_row (
+   Rox_Float ** L,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Texture_Tutvsr_Light_Affine_Params * p = (const Rox_Linsys_Texture_Tutvsr_Light_Affine_Params *) params;
+
+   Rox_Float v = (Rox_Float) i;
+   Rox_Sint n = 0;
+
+   for ( Rox_Sint j = 0; j < p->width; j++ )
+   {
+      if (!p->Im_data[i][j]) continue;
+
+      Rox_Float u = (Rox_Float) j;
+
+      Rox_Float Iu_val = p->Iu_data[i][j];
+      Rox_Float Iv_val = p->Iv_data[i][j];
+
+      L[0][n] = Iu_val;
+      L[1][n] = Iv_val;
+      L[2][n] = Iu_val * v - Iv_val * u;
+      L[3][n] = 3.0f * (Iu_val * u + Iv_val * v);
+      L[4][n] = p->Ia_data[i][j];
+      L[5][n] = 1.0f;
+      e[n] = p->Id_data[i][j];
+      n++;
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode rox_jacobian_tutvsr_light_affine_premul (
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -28,6 +74,7 @@ Rox_ErrorCode rox_jacobian_tutvsr_light_affine_premul (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Texture_Tutvsr_Light_Affine_Params params;
 
    if ( !LtL || !Lte ) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -60,83 +107,26 @@ Rox_ErrorCode rox_jacobian_tutvsr_light_affine_premul (
    error = rox_array2d_double_check_size ( Lte, 6, 1 ); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_fillval ( LtL, 0.0 ); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_fillval ( Lte, 0.0 ); 
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Id_data, Id );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** LtL_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &LtL_data, LtL);
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Ia_data, Ia );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** Lte_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &Lte_data, Lte);
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iu_data, Iu );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Id_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Id_data, Id);
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &params.Iv_data, Iv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Ia_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Ia_data, Ia);
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &params.Im_data, Im );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iu_data, Iu );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   params.width = width;
 
-   Rox_Float ** Iv_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iv_data, Iv );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, height, width, jacobian_tutvsr_light_affine_premul_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uint ** Im_data = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &Im_data, Im );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   for ( Rox_Sint i = 0; i < height; i++ )
-   {
-      Rox_Double v = (Rox_Double) i;
-
-      for ( Rox_Sint j = 0; j < width; j++ )
-      {
-         Rox_Double L[6];
-
-         if (!Im_data[i][j]) continue;
-
-         Rox_Double u = (Rox_Double) j;
-
-         Rox_Double d = Id_data[i][j];
-         Rox_Double Iu_val = Iu_data[i][j];
-         Rox_Double Iv_val = Iv_data[i][j];
-
-         L[0] = Iu_val;
-         L[1] = Iv_val;
-         L[2] = Iu_val * v - Iv_val * u;
-         L[3] = 3.0 * (Iu_val * u + Iv_val * v);
-         L[4] = Ia_data[i][j];
-         L[5] = 1.0;
-
-         for ( Rox_Sint k = 0; k < 6; k++ )
-         {
-            for ( Rox_Sint l = 0; l <= k; l++ )
-            {
-               LtL_data[k][l] += L[k]*L[l];
-            }
-
-            Lte_data[k][0] += L[k] * d;
-         }
-      }
-   }
-
-   for (Rox_Sint k = 0; k < 6; k++)
-   {
-      for (Rox_Sint l = 0; l <= k; l++)
-      {
-         LtL_data[l][k] = LtL_data[k][l];
-      }
-   }
-
 function_terminate:
    return error;
 }
@@ -14,11 +14,90 @@
 
 #include "linsys_weighted_texture_matse3_light_affine_model3d.h"
 
-#include <baseproc/array/fill/fillval.h>
-#include <baseproc/array/symmetrise/symmetrise.h>
-
 #include <inout/system/errors_print.h>
 
+#include "linsys_accumulator.h"
+
+typedef struct Rox_Linsys_Weighted_Texture_Matse3_Light_Affine_Model3d_Params
+{
+   Rox_Uint ** Im_data;
+   Rox_Float ** Iu_data;
+   Rox_Float ** Iv_data;
+   Rox_Float ** Z_data;
+   Rox_Float ** Id_data;
+   Rox_Float ** Ia_data;
+   Rox_Float ** weight_data;
+   Rox_Sint width;
+   Rox_Double fu, fv, cu, cv;
+   Rox_Double tau1, tau2, tau3;
+} Rox_Linsys_Weighted_Texture_Matse3_Light_Affine_Model3d_Params;
+
+static Rox_ErrorCode linsys_weighted_texture_matse3_light_affine_model3d_row (
+   Rox_Float ** L,
+   Rox_Float * e,
+   Rox_Sint * count,
+   const Rox_Sint i,
+   const Rox_Void * params
+)
+{
+   const Rox_Linsys_Weighted_Texture_Matse3_Light_Affine_Model3d_Params * p = (const Rox_Linsys_Weighted_Texture_Matse3_Light_Affine_Model3d_Params *) params;
+
+   const Rox_Double fu = p->fu, fv = p->fv, cu = p->cu, cv = p->cv;
+   const Rox_Double tau1 = p->tau1, tau2 = p->tau2, tau3 = p->tau3;
+
+   Rox_Double v = (Rox_Double) i;
+   Rox_Double y = (v - cv) / fv;
+   Rox_Sint n = 0;
+
+   for ( Rox_Sint j = 0; j < p->width; j++ )
+   {
+      if ( p->Im_data[i][j] == 0 ) 
+      {
+         continue; 
+      }
+      
+      Rox_Double u = (Rox_Double) j;
+      Rox_Double x = (u - cu) / fu;
+
+      // Gradient
+      Rox_Double Iu_val = (Rox_Double) p->Iu_data[i][j];
+      Rox_Double Iv_val = (Rox_Double) p->Iv_data[i][j];
+      
+      Rox_Double w  = (Rox_Double) p->weight_data[i][j];
+
+      Rox_Double z = (Rox_Double) p->Z_data[i][j];
+      
+      Rox_Double d = w * (Rox_Double) p->Id_data[i][j];
+      Rox_Double a =     (Rox_Double) p->Ia_data[i][j];
+
+      // TODO: test if Z < eps then continue
+      Rox_Double iz = 1.0/z;
+
+      if (z > 500000.0) iz = 0.0;
+
+      Rox_Double t25 = Iu_val * fu;
+      Rox_Double t24 = Iv_val * fv;
+      Rox_Double t23 = ( x + tau1*iz ) * t25;
+      Rox_Double t22 = ( y + tau2*iz ) * t24;
+      Rox_Double t21 = 1.0/(tau3*iz+1.0);
+
+      // Interaction matrix row
+      L[0][n] = (Rox_Float) (w * (iz*t25));
+      L[1][n] = (Rox_Float) (w * (iz*t24));
+      L[2][n] = (Rox_Float) (w * (-iz*t21*(t22+t23)));
+      L[3][n] = (Rox_Float) (w * ((-((y*tau2+tau3)*iz+y*y+1.0)*t24-y*t23)*t21));
+      L[4][n] = (Rox_Float) (w * ((+((x*tau1+tau3)*iz+x*x+1.0)*t25+x*t22)*t21));
+      L[5][n] = (Rox_Float) (w * (x*t24-y*t25));
+      L[6][n] = (Rox_Float) (w * a);
+      L[7][n] = (Rox_Float) w;
+      e[n] = (Rox_Float) d;
+      n++;
+   }
+
+   *count = n;
+   return ROX_ERROR_NONE;
+}
+
 Rox_ErrorCode rox_linsys_weighted_texture_matse3_light_affine_model3d (
    Rox_Matrix LtL, 
    Rox_Matrix Lte, 
@@ -34,6 +113,7 @@ Rox_ErrorCode rox_linsys_weighted_texture_matse3_light_affine_model3d (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Linsys_Weighted_Texture_Matse3_Light_Affine_Model3d_Params params;
 
    // Output check
    if ( !LtL || !Lte )
@@ -78,40 +158,25 @@ Rox_ErrorCode rox_linsys_weighted_texture_matse3_light_affine_model3d (
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Retrieve pointers
-   Rox_Double  * Lte_data = NULL;
-   error = rox_array2d_double_get_data_pointer( &Lte_data, Lte );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** LtL_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &LtL_data, LtL );
+   error = rox_imask_get_data_pointer_to_pointer ( &params.Im_data, Im );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uint ** Im_data = NULL;
-   error = rox_imask_get_data_pointer_to_pointer ( &Im_data, Im );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Float ** Iu_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iu_data, Iu );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Iu_data, Iu );
    ROX_ERROR_CHECK_TERMINATE ( error );
    
-   Rox_Float ** Iv_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Iv_data, Iv );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Iv_data, Iv );
    ROX_ERROR_CHECK_TERMINATE ( error );
    
-   Rox_Float ** Z_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Z_data, Z );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Z_data, Z );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Id_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Id_data, Id );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Id_data, Id );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** Ia_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &Ia_data, Ia );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.Ia_data, Ia );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** weight_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &weight_data, weight );
+   error = rox_array2d_float_get_data_pointer_to_pointer( &params.weight_data, weight );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    Rox_Double ** K_data = NULL;
@@ -123,10 +188,10 @@ Rox_ErrorCode rox_linsys_weighted_texture_matse3_light_affine_model3d (
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Retrieve input transformation
-   Rox_Double fu = K_data[0][0];
-   Rox_Double fv = K_data[1][1];
-   Rox_Double cu = K_data[0][2];
-   Rox_Double cv = K_data[1][2];
+   params.fu = K_data[0][0];
+   params.fv = K_data[1][1];
+   params.cu = K_data[0][2];
+   params.cv = K_data[1][2];
 
    Rox_Double r11 = T_data[0][0]; Rox_Double r12 = T_data[0][1]; Rox_Double r13 = T_data[0][2];
    Rox_Double r21 = T_data[1][0]; Rox_Double r22 = T_data[1][1]; Rox_Double r23 = T_data[1][2];
@@ -134,83 +199,13 @@ Rox_ErrorCode rox_linsys_weighted_texture_matse3_light_affine_model3d (
    Rox_Double  tx = T_data[0][3]; Rox_Double  ty = T_data[1][3]; Rox_Double  tz = T_data[2][3];
 
    // Compute tip for fastening computation: tau = R' * t
-   Rox_Double tau1 = ( r11 * tx + r21 * ty + r31 * tz );
-   Rox_Double tau2 = ( r12 * tx + r22 * ty + r32 * tz );
-   Rox_Double tau3 = ( r13 * tx + r23 * ty + r33 * tz );
-
-   error = rox_array2d_double_fillval ( LtL, 0 );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   params.tau1 = ( r11 * tx + r21 * ty + r31 * tz );
+   params.tau2 = ( r12 * tx + r22 * ty + r32 * tz );
+   params.tau3 = ( r13 * tx + r23 * ty + r33 * tz );
 
-   error = rox_array2d_double_fillval ( Lte, 0 );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   // Compute per pixel jacobian (ignore borders)
-   // for ( Rox_Sint i = 1; i < height - 1; i++ )
-   for ( Rox_Sint i = 0; i < height; i++ )
-   {
-      Rox_Double v = (Rox_Double) i;
-      Rox_Double y = (v - cv) / fv;
-
-      // for ( Rox_Sint j = 1; j < width - 1; j++ )
-      for ( Rox_Sint j = 0; j < width; j++ )
-      {
-         Rox_Double L[8] = { 0.0 };
-
-         if ( Im_data[i][j] == 0 ) 
-         {
-            continue; 
-         }
-         
-         Rox_Double u = (Rox_Double) j;
-         Rox_Double x = (u - cu) / fu;
-
-         // Gradient
-         Rox_Double Iu_val = (Rox_Double) Iu_data[i][j];
-         Rox_Double Iv_val = (Rox_Double) Iv_data[i][j];
-         
-         Rox_Double w  = (Rox_Double) weight_data[i][j];
-
-         Rox_Double z = (Rox_Double) Z_data[i][j];
-         
-         Rox_Double d = w * (Rox_Double) Id_data[i][j];
-         Rox_Double a =     (Rox_Double) Ia_data[i][j];
-
-         // TODO: test if Z < eps then continue
-         Rox_Double iz = 1.0/z;
-
-         if (z > 500000.0) iz = 0.0;
-
-         Rox_Double t25 = Iu_val * fu;
-         Rox_Double t24 = Iv_val * fv;
-         Rox_Double t23 = ( x + tau1*iz ) * t25;
-         Rox_Double t22 = ( y + tau2*iz ) * t24;
-         Rox_Double t21 = 1.0/(tau3*iz+1.0);
-
-         // Interaction matrix row
-         L[0] = w * (iz*t25);
-         L[1] = w * (iz*t24);
-         L[2] = w * (-iz*t21*(t22+t23));
-         L[3] = w * ((-((y*tau2+tau3)*iz+y*y+1.0)*t24-y*t23)*t21);
-         L[4] = w * ((+((x*tau1+tau3)*iz+x*x+1.0)*t25+x*t22)*t21);
-         L[5] = w * (x*t24-y*t25);
-         L[6] = w * a;
-         L[7] = w;
-
-         // Build the upper triangular part of Lt * L
-         for (Rox_Sint k = 0; k < 8; k++)
-         {
-            for (Rox_Sint l = 0; l <= k; l++)
-            {
-               LtL_data[k][l] += L[k]*L[l];
-            }
-
-            Lte_data[k] += L[k] * d;
-         }
-      }
-   }
+   params.width = width;
 
-   // Symmetrise lower triangular input   
-   error = rox_array2d_double_symmetrise_lower ( LtL );
+   error = rox_linsys_accumulate_rows ( LtL, Lte, height, width, linsys_weighted_texture_matse3_light_affine_model3d_row, &params );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
@@ -0,0 +1,452 @@
+//==============================================================================
+//
+//    OPENROX   : File connected_components.c
+//
+//    Contents  : Implementation of connected_components module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "connected_components.h"
+#include "unionfind.h"
+
+#include <system/memory/memory.h>
+#include <inout/system/errors_print.h>
+
+//! Number of rows of the bands labelled in parallel
+#define ROX_CONNECTED_COMPONENTS_BAND 64
+
+//! Initial number of provisional statistics of a band
+#define ROX_CONNECTED_COMPONENTS_INITIAL_LABELS 256
+
+Rox_ErrorCode rox_connected_components_new (
+   Rox_Connected_Components * ccl,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Connected_Components ret = NULL;
+
+   if ( !ccl )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( rows < 1 || cols < 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = ( Rox_Connected_Components ) rox_memory_allocate ( sizeof ( *ret ), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->rows = rows;
+   ret->cols = cols;
+   ret->labels = NULL;
+   ret->count = 0;
+   ret->components = NULL;
+   ret->allocated = 0;
+   ret->parent = NULL;
+   ret->count_bands = ( rows + ROX_CONNECTED_COMPONENTS_BAND - 1 ) / ROX_CONNECTED_COMPONENTS_BAND;
+   ret->band_count = NULL;
+   ret->band_allocated = NULL;
+   ret->band_stats = NULL;
+   ret->errors = NULL;
+
+   error = rox_array2d_uint_new ( &ret->labels, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   ret->parent = ( Rox_Uint * ) rox_memory_allocate ( sizeof ( Rox_Uint ), rows * cols + 1 );
+   ret->band_count = ( Rox_Uint * ) rox_memory_allocate ( sizeof ( Rox_Uint ), ret->count_bands );
+   ret->band_allocated = ( Rox_Uint * ) rox_memory_allocate ( sizeof ( Rox_Uint ), ret->count_bands );
+   ret->band_stats = ( Rox_Connected_Component_Struct ** ) rox_memory_allocate ( sizeof ( Rox_Connected_Component_Struct * ), ret->count_bands );
+   ret->errors = ( Rox_ErrorCode * ) rox_memory_allocate ( sizeof ( Rox_ErrorCode ), ret->count_bands );
+   if ( !ret->parent || !ret->band_count || !ret->band_allocated || !ret->band_stats || !ret->errors )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Sint b = 0; b < ret->count_bands; b++ )
+   {
+      ret->band_count[b] = 0;
+      ret->band_allocated[b] = 0;
+      ret->band_stats[b] = NULL;
+   }
+
+   // The background keeps the label 0 when relabelling
+   ret->parent[0] = 0;
+
+   *ccl = ret;
+
+function_terminate:
+   if ( error ) rox_connected_components_del ( &ret );
+   return error;
+}
+
+Rox_ErrorCode rox_connected_components_del (
+   Rox_Connected_Components * ccl
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Connected_Components todel = NULL;
+
+   if ( !ccl )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *ccl;
+   *ccl = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( todel->band_stats )
+   {
+      for ( Rox_Sint b = 0; b < todel->count_bands; b++ )
+      {
+         rox_memory_delete ( todel->band_stats[b] );
+      }
+   }
+
+   rox_array2d_uint_del ( &todel->labels );
+   rox_memory_delete ( todel->components );
+   rox_memory_delete ( todel->parent );
+   rox_memory_delete ( todel->band_count );
+   rox_memory_delete ( todel->band_allocated );
+   rox_memory_delete ( todel->band_stats );
+   rox_memory_delete ( todel->errors );
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+// Create a provisional label in a band, its statistics are initialized empty
+static Rox_ErrorCode rox_connected_components_new_label (
+   Rox_Uint * label,
+   Rox_Connected_Components ccl,
+   const Rox_Sint band,
+   const Rox_Uint offset
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   const Rox_Uint k = ccl->band_count[band];
+
+   if ( k == ccl->band_allocated[band] )
+   {
+      const Rox_Uint allocated = ( k == 0 ) ? ROX_CONNECTED_COMPONENTS_INITIAL_LABELS : 2 * k;
+      Rox_Connected_Component_Struct * stats = NULL;
+
+      if ( ccl->band_stats[band] )
+      {
+         stats = ( Rox_Connected_Component_Struct * ) rox_memory_reallocate ( ccl->band_stats[band], sizeof ( Rox_Connected_Component_Struct ), allocated );
+      }
+      else
+      {
+         stats = ( Rox_Connected_Component_Struct * ) rox_memory_allocate ( sizeof ( Rox_Connected_Component_Struct ), allocated );
+      }
+
+      if ( !stats )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      ccl->band_stats[band] = stats;
+      ccl->band_allocated[band] = allocated;
+   }
+
+   Rox_Connected_Component_Struct * stats = &ccl->band_stats[band][k];
+   stats->area = 0;
+   stats->u_min = ccl->cols;
+   stats->v_min = ccl->rows;
+   stats->u_max = -1;
+   stats->v_max = -1;
+   stats->sum_u = 0.0;
+   stats->sum_v = 0.0;
+   stats->sum_uu = 0.0;
+   stats->sum_uv = 0.0;
+   stats->sum_vv = 0.0;
+
+   *label = offset + k + 1;
+   ccl->parent[*label] = *label;
+   ccl->band_count[band]++;
+
+function_terminate:
+   return error;
+}
+
+// Add a pixel to the statistics of a provisional label
+static inline void rox_connected_components_add_pixel ( Rox_Connected_Component_Struct * stats, const Rox_Sint u, const Rox_Sint v )
+{
+   stats->area++;
+   if ( u < stats->u_min ) stats->u_min = u;
+   if ( u > stats->u_max ) stats->u_max = u;
+   if ( v < stats->v_min ) stats->v_min = v;
+   if ( v > stats->v_max ) stats->v_max = v;
+   stats->sum_u += u;
+   stats->sum_v += v;
+   stats->sum_uu += ( Rox_Double ) u * u;
+   stats->sum_uv += ( Rox_Double ) u * v;
+   stats->sum_vv += ( Rox_Double ) v * v;
+}
+
+// Scan of a band of rows: the first row of the band ignores the row above, it is merged later.
+// Decision tree of the 8-connectivity on the neighbours a (up left), b (up), c (up right) and d (left):
+// if b is connected it is the only label to look at since a, c and d are all neighbours of b.
+#define ROX_CONNECTED_COMPONENTS_SCAN(NAME, TYPE, SAME) \
+static Rox_ErrorCode rox_connected_components_scan_##NAME ( \
+   Rox_Connected_Components ccl, \
+   Rox_Uint ** lab, \
+   TYPE ** src, \
+   const Rox_Sint band, \
+   const Rox_Sint connectivity \
+) \
+{ \
+   Rox_ErrorCode error = ROX_ERROR_NONE; \
+   Rox_Uint * parent = ccl->parent; \
+   const Rox_Sint cols = ccl->cols; \
+   const Rox_Sint first = band * ROX_CONNECTED_COMPONENTS_BAND; \
+   const Rox_Sint last = ( first + ROX_CONNECTED_COMPONENTS_BAND < ccl->rows ) ? first + ROX_CONNECTED_COMPONENTS_BAND : ccl->rows; \
+   const Rox_Uint offset = first * cols; \
+   \
+   ccl->band_count[band] = 0; \
+   \
+   for ( Rox_Sint i = first; i < last; i++ ) \
+   { \
+      const TYPE * row = src[i]; \
+      const TYPE * up = ( i > first ) ? src[i - 1] : NULL; \
+      Rox_Uint * lrow = lab[i]; \
+      const Rox_Uint * lup = ( i > first ) ? lab[i - 1] : NULL; \
+      \
+      for ( Rox_Sint j = 0; j < cols; j++ ) \
+      { \
+         const TYPE x = row[j]; \
+         Rox_Uint l = 0; \
+         \
+         if ( x == 0 ) \
+         { \
+            lrow[j] = 0; \
+            continue; \
+         } \
+         \
+         const Rox_Sint fb = up && SAME ( x, up[j] ); \
+         const Rox_Sint fd = j > 0 && SAME ( x, row[j - 1] ); \
+         \
+         if ( connectivity == 4 ) \
+         { \
+            if ( fb && fd ) l = rox_unionfind_union ( parent, lup[j], lrow[j - 1] ); \
+            else if ( fb ) l = lup[j]; \
+            else if ( fd ) l = lrow[j - 1]; \
+         } \
+         else if ( fb ) \
+         { \
+            l = lup[j]; \
+         } \
+         else \
+         { \
+            const Rox_Sint fa = up && j > 0 && SAME ( x, up[j - 1] ); \
+            const Rox_Sint fc = up && j + 1 < cols && SAME ( x, up[j + 1] ); \
+            \
+            if ( fc ) \
+            { \
+               if ( fa ) l = rox_unionfind_union ( parent, lup[j + 1], lup[j - 1] ); \
+               else if ( fd ) l = rox_unionfind_union ( parent, lup[j + 1], lrow[j - 1] ); \
+               else l = lup[j + 1]; \
+            } \
+            else if ( fa ) l = lup[j - 1]; \
+            else if ( fd ) l = lrow[j - 1]; \
+         } \
+         \
+         if ( l == 0 ) \
+         { \
+            error = rox_connected_components_new_label ( &l, ccl, band, offset ); \
+            ROX_ERROR_CHECK_TERMINATE ( error ); \
+         } \
+         \
+         lrow[j] = l; \
+         rox_connected_components_add_pixel ( &ccl->band_stats[band][l - offset - 1], j, i ); \
+      } \
+   } \
+   \
+function_terminate: \
+   return error; \
+} \
+\
+/* Merge the first row of each band with the last row of the previous band */ \
+static void rox_connected_components_merge_##NAME ( \
+   Rox_Connected_Components ccl, \
+   Rox_Uint ** lab, \
+   TYPE ** src, \
+   const Rox_Sint connectivity \
+) \
+{ \
+   const Rox_Sint cols = ccl->cols; \
+   const Rox_Sint radius = ( connectivity == 4 ) ? 0 : 1; \
+   \
+   for ( Rox_Sint band = 1; band < ccl->count_bands; band++ ) \
+   { \
+      const Rox_Sint i = band * ROX_CONNECTED_COMPONENTS_BAND; \
+      \
+      for ( Rox_Sint j = 0; j < cols; j++ ) \
+      { \
+         const TYPE x = src[i][j]; \
+         if ( x == 0 ) continue; \
+         \
+         for ( Rox_Sint k = j - radius; k <= j + radius; k++ ) \
+         { \
+            if ( k < 0 || k >= cols ) continue; \
+            if ( SAME ( x, src[i - 1][k] ) ) rox_unionfind_union ( ccl->parent, lab[i][j], lab[i - 1][k] ); \
+         } \
+      } \
+   } \
+}
+
+#define ROX_CONNECTED_COMPONENTS_SAME_BINARY(x, y) ( ( y ) != 0 )
+#define ROX_CONNECTED_COMPONENTS_SAME_VALUE(x, y) ( ( y ) == ( x ) )
+
+ROX_CONNECTED_COMPONENTS_SCAN(binary, Rox_Uchar, ROX_CONNECTED_COMPONENTS_SAME_BINARY)
+ROX_CONNECTED_COMPONENTS_SCAN(value, Rox_Uint, ROX_CONNECTED_COMPONENTS_SAME_VALUE)
+
+// Replace the provisional labels by consecutive labels and gather the statistics of the merged labels.
+// The provisional labels are visited in increasing order and parent[l] <= l, so the parent of a merged label is already final.
+static Rox_ErrorCode rox_connected_components_flatten ( Rox_Connected_Components ccl )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uint * parent = ccl->parent;
+   Rox_Uint total = 0;
+
+   for ( Rox_Sint b = 0; b < ccl->count_bands; b++ ) total += ccl->band_count[b];
+
+   if ( total > ccl->allocated )
+   {
+      Rox_Connected_Component_Struct * components = NULL;
+
+      if ( ccl->components ) components = ( Rox_Connected_Component_Struct * ) rox_memory_reallocate ( ccl->components, sizeof ( Rox_Connected_Component_Struct ), total );
+      else components = ( Rox_Connected_Component_Struct * ) rox_memory_allocate ( sizeof ( Rox_Connected_Component_Struct ), total );
+
+      if ( !components )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      ccl->components = components;
+      ccl->allocated = total;
+   }
+
+   ccl->count = 0;
+
+   for ( Rox_Sint b = 0; b < ccl->count_bands; b++ )
+   {
+      const Rox_Uint offset = b * ROX_CONNECTED_COMPONENTS_BAND * ccl->cols;
+
+      for ( Rox_Uint k = 0; k < ccl->band_count[b]; k++ )
+      {
+         const Rox_Uint l = offset + k + 1;
+         const Rox_Connected_Component_Struct * stats = &ccl->band_stats[b][k];
+
+         if ( parent[l] == l )
+         {
+            parent[l] = ++ccl->count;
+            ccl->components[ccl->count - 1] = *stats;
+            continue;
+         }
+
+         parent[l] = parent[parent[l]];
+
+         Rox_Connected_Component_Struct * component = &ccl->components[parent[l] - 1];
+         component->area += stats->area;
+         if ( stats->u_min < component->u_min ) component->u_min = stats->u_min;
+         if ( stats->u_max > component->u_max ) component->u_max = stats->u_max;
+         if ( stats->v_min < component->v_min ) component->v_min = stats->v_min;
+         if ( stats->v_max > component->v_max ) component->v_max = stats->v_max;
+         component->sum_u += stats->sum_u;
+         component->sum_v += stats->sum_v;
+         component->sum_uu += stats->sum_uu;
+         component->sum_uv += stats->sum_uv;
+         component->sum_vv += stats->sum_vv;
+      }
+   }
+
+function_terminate:
+   return error;
+}
+
+#ifdef ROX_USES_OPENMP
+   #define ROX_CONNECTED_COMPONENTS_PARALLEL_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+   #define ROX_CONNECTED_COMPONENTS_PARALLEL_FOR
+#endif
+
+// Scan the bands in parallel, merge them, flatten the labels and relabel the pixels in parallel
+#define ROX_CONNECTED_COMPONENTS_MAKE(NAME, TYPE, ARRAY, SCAN) \
+static Rox_ErrorCode rox_connected_components_make_##NAME ( \
+   Rox_Connected_Components ccl, \
+   const ARRAY source, \
+   const Rox_Sint connectivity \
+) \
+{ \
+   Rox_ErrorCode error = ROX_ERROR_NONE; \
+   Rox_Uint ** lab = NULL; \
+   TYPE ** src = NULL; \
+   \
+   if ( !ccl || !source ) \
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); } \
+   \
+   if ( connectivity != 4 && connectivity != 8 ) \
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); } \
+   \
+   error = rox_array2d_##NAME##_check_size ( source, ccl->rows, ccl->cols ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_array2d_##NAME##_get_data_pointer_to_pointer ( &src, source ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &lab, ccl->labels ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   ROX_CONNECTED_COMPONENTS_PARALLEL_FOR \
+   for ( Rox_Sint b = 0; b < ccl->count_bands; b++ ) \
+   { \
+      ccl->errors[b] = rox_connected_components_scan_##SCAN ( ccl, lab, src, b, connectivity ); \
+   } \
+   \
+   for ( Rox_Sint b = 0; b < ccl->count_bands; b++ ) \
+   { \
+      error = ccl->errors[b]; \
+      ROX_ERROR_CHECK_TERMINATE ( error ); \
+   } \
+   \
+   rox_connected_components_merge_##SCAN ( ccl, lab, src, connectivity ); \
+   \
+   error = rox_connected_components_flatten ( ccl ); \
+   ROX_ERROR_CHECK_TERMINATE ( error ); \
+   \
+   ROX_CONNECTED_COMPONENTS_PARALLEL_FOR \
+   for ( Rox_Sint i = 0; i < ccl->rows; i++ ) \
+   { \
+      for ( Rox_Sint j = 0; j < ccl->cols; j++ ) \
+      { \
+         lab[i][j] = ccl->parent[lab[i][j]]; \
+      } \
+   } \
+   \
+function_terminate: \
+   return error; \
+}
+
+ROX_CONNECTED_COMPONENTS_MAKE(uchar, Rox_Uchar, Rox_Array2D_Uchar, binary)
+ROX_CONNECTED_COMPONENTS_MAKE(uint, Rox_Uint, Rox_Array2D_Uint, value)
+
+Rox_ErrorCode rox_connected_components_make (
+   Rox_Connected_Components ccl,
+   const Rox_Array2D_Uchar source,
+   const Rox_Sint connectivity
+)
+{
+   return rox_connected_components_make_uchar ( ccl, source, connectivity );
+}
+
+Rox_ErrorCode rox_connected_components_make_value (
+   Rox_Connected_Components ccl,
+   const Rox_Array2D_Uint source,
+   const Rox_Sint connectivity
+)
+{
+   return rox_connected_components_make_uint ( ccl, source, connectivity );
+}
@@ -0,0 +1,149 @@
+//==============================================================================
+//
+//    OPENROX   : File connected_components.h
+//
+//    Contents  : API of connected_components module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_CONNECTED_COMPONENTS__
+#define __OPENROX_CONNECTED_COMPONENTS__
+
+#include <generated/array2d_uchar.h>
+#include <generated/array2d_uint.h>
+
+//! \ingroup Image
+//! \addtogroup Connectivity
+//! @{
+
+//! The statistics of a connected component
+struct Rox_Connected_Component_Struct
+{
+   //! The number of pixels
+   Rox_Uint area;
+
+   //! The first column of the bounding box
+   Rox_Sint u_min;
+
+   //! The first row of the bounding box
+   Rox_Sint v_min;
+
+   //! The last column of the bounding box
+   Rox_Sint u_max;
+
+   //! The last row of the bounding box
+   Rox_Sint v_max;
+
+   //! The sum of the columns of the pixels
+   Rox_Double sum_u;
+
+   //! The sum of the rows of the pixels
+   Rox_Double sum_v;
+
+   //! The sum of the squared columns of the pixels
+   Rox_Double sum_uu;
+
+   //! The sum of the products of the columns and rows of the pixels
+   Rox_Double sum_uv;
+
+   //! The sum of the squared rows of the pixels
+   Rox_Double sum_vv;
+};
+
+//! Define the Rox_Connected_Component_Struct type
+typedef struct Rox_Connected_Component_Struct Rox_Connected_Component_Struct;
+
+//! The labelling of the connected components of an image, with the buffers reused between calls
+struct Rox_Connected_Components_Struct
+{
+   //! The image height
+   Rox_Sint rows;
+
+   //! The image width
+   Rox_Sint cols;
+
+   //! The label of each pixel: 0 for the background, 1 to count for the components in the order of their first pixel
+   Rox_Array2D_Uint labels;
+
+   //! The number of components
+   Rox_Uint count;
+
+   //! The statistics of each component (component of label l at l - 1)
+   Rox_Connected_Component_Struct * components;
+
+   //! The number of allocated components
+   Rox_Uint allocated;
+
+   //! The union-find parents of the provisional labels (rows * cols + 1 labels)
+   Rox_Uint * parent;
+
+   //! The number of bands of rows labelled in parallel
+   Rox_Sint count_bands;
+
+   //! The number of provisional labels of each band
+   Rox_Uint * band_count;
+
+   //! The number of allocated provisional statistics of each band
+   Rox_Uint * band_allocated;
+
+   //! The statistics of the provisional labels of each band
+   Rox_Connected_Component_Struct ** band_stats;
+
+   //! The error of each band
+   Rox_ErrorCode * errors;
+};
+
+//! Define the pointer of the Rox_Connected_Components_Struct
+typedef struct Rox_Connected_Components_Struct * Rox_Connected_Components;
+
+//! Create a connected components object for a given image size
+//! \param  [out]  ccl            The newly created object
+//! \param  [in ]  rows           The image height
+//! \param  [in ]  cols           The image width
+//! \return An error code
+ROX_API Rox_ErrorCode rox_connected_components_new (
+   Rox_Connected_Components * ccl,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+);
+
+//! Delete a connected components object
+//! \param  [in ]  ccl            The object to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_connected_components_del (
+   Rox_Connected_Components * ccl
+);
+
+//! Label the connected components of the non zero pixels of an image and compute their statistics.
+//! Bands of rows are scanned in parallel with a decision tree and a union-find on provisional labels,
+//! the bands are then merged along their boundaries. The labels do not depend on the number of threads.
+//! \param  [out]  ccl            The connected components object
+//! \param  [in ]  source         The binary image, not modified
+//! \param  [in ]  connectivity   The pixel connectivity, 4 or 8
+//! \return An error code
+ROX_API Rox_ErrorCode rox_connected_components_make (
+   Rox_Connected_Components ccl,
+   const Rox_Array2D_Uchar source,
+   const Rox_Sint connectivity
+);
+
+//! Label the connected components of the pixels with the same non zero value and compute their statistics.
+//! \param  [out]  ccl            The connected components object
+//! \param  [in ]  source         The image of values (for example a mask), not modified
+//! \param  [in ]  connectivity   The pixel connectivity, 4 or 8
+//! \return An error code
+ROX_API Rox_ErrorCode rox_connected_components_make_value (
+   Rox_Connected_Components ccl,
+   const Rox_Array2D_Uint source,
+   const Rox_Sint connectivity
+);
+
+//! @}
+
+#endif // __OPENROX_CONNECTED_COMPONENTS__
@@ -13,9 +13,69 @@
 //==============================================================================
 
 #include "connectivity.h"
+#include "connected_components.h"
 #include <generated/dynvec_point2d_sint_struct.h>
+#include <system/memory/memory.h>
 #include <inout/system/errors_print.h>
 
+// Store the pixels of the labelled components larger than min_length, in the order of the labels
+static Rox_ErrorCode rox_connected_components_get_lists (
+   Rox_ObjSet_DynVec_Point2D_Sint lists,
+   const Rox_Connected_Components ccl,
+   const Rox_Uint min_length
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_DynVec_Point2D_Sint * component_lists = NULL;
+   Rox_DynVec_Point2D_Sint addedlist = NULL;
+
+   if ( ccl->count == 0 ) goto function_terminate;
+
+   component_lists = ( Rox_DynVec_Point2D_Sint * ) rox_memory_allocate ( sizeof ( Rox_DynVec_Point2D_Sint ), ccl->count );
+   if ( !component_lists )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Uint k = 0; k < ccl->count; k++ )
+   {
+      component_lists[k] = NULL;
+      if ( ccl->components[k].area <= min_length ) continue;
+
+      error = rox_dynvec_point2d_sint_new ( &addedlist, ccl->components[k].area );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      // The set owns the list from now on
+      error = rox_objset_dynvec_point2d_sint_append ( lists, addedlist );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      component_lists[k] = addedlist;
+      addedlist = NULL;
+   }
+
+   Rox_Uint ** dl = NULL;
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &dl, ccl->labels );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < ccl->rows; i++ )
+   {
+      for ( Rox_Sint j = 0; j < ccl->cols; j++ )
+      {
+         if ( dl[i][j] == 0 ) continue;
+
+         Rox_DynVec_Point2D_Sint list = component_lists[dl[i][j] - 1];
+         if ( !list ) continue;
+
+         list->data[list->used].u = j;
+         list->data[list->used].v = i;
+         list->used++;
+      }
+   }
+
+function_terminate:
+   rox_dynvec_point2d_sint_del ( &addedlist );
+   rox_memory_delete ( component_lists );
+   return error;
+}
+
 Rox_ErrorCode rox_array2d_uchar_connectivity (
    Rox_ObjSet_DynVec_Point2D_Sint lists, 
    Rox_Array2D_Uchar source, 
@@ -23,8 +83,7 @@ Rox_ErrorCode rox_array2d_uchar_connectivity (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_DynVec_Point2D_Sint addedlist = NULL, stack = NULL;
-   Rox_Point2D_Sint_Struct toadd, top;
+   Rox_Connected_Components ccl = NULL;
 
    if (!lists || !source)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -35,81 +94,17 @@ Rox_ErrorCode rox_array2d_uchar_connectivity (
    error = rox_array2d_uchar_get_size(&rows, &cols, source);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_dynvec_point2d_sint_new(&stack, 10);
+   error = rox_connected_components_new ( &ccl, rows, cols );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uchar ** ds = NULL;
-   error = rox_array2d_uchar_get_data_pointer_to_pointer( &ds, source);
+   error = rox_connected_components_make ( ccl, source, 8 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for (Rox_Sint i = 0; i < rows; i++)
-   {
-      for (Rox_Sint j = 0; j < cols; j++)
-      {
-         if (ds[i][j] == 0) continue;
-         ds[i][j] = 0;
-
-         if (addedlist)
-         {
-            rox_dynvec_point2d_sint_reset(addedlist);
-         }
-         else
-         {
-            error = rox_dynvec_point2d_sint_new(&addedlist, 10);
-            ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-
-         toadd.u = j;
-         toadd.v = i;
-         rox_dynvec_point2d_sint_append(stack, &toadd);
-
-         while (stack->used)
-         {
-            // Pop element from stack
-            top = stack->data[stack->used - 1];
-            stack->used--;
-
-            rox_dynvec_point2d_sint_append(addedlist, &top);
-
-
-            for (Rox_Sint di = -1; di <= 1; di++)
-            {
-               Rox_Sint cy = top.v + di;
-               if (cy < 0 || cy >= rows) continue;
-
-               for (Rox_Sint dj = -1; dj <= 1; dj++)
-               {
-                  if (di == 0 && dj == 0) continue;
-                  Rox_Sint cx = top.u + dj;
-
-                  if (cx < 0 || cx >= cols) continue;
-
-                  if (ds[cy][cx] != 0)
-                  {
-                     ds[cy][cx] = 0;
-
-                     toadd.u = cx;
-                     toadd.v = cy;
-                     error = rox_dynvec_point2d_sint_append(stack, &toadd);
-                     ROX_ERROR_CHECK_TERMINATE ( error );
-                  }
-               }
-            }
-         }
-
-         if (addedlist->used > min_length)
-         {
-            error = rox_objset_dynvec_point2d_sint_append(lists, addedlist);
-            ROX_ERROR_CHECK_TERMINATE ( error );
-            addedlist = NULL;
-         }
-      }
-   }
+   error = rox_connected_components_get_lists ( lists, ccl, min_length );
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
-   rox_dynvec_point2d_sint_del(&stack);
-   rox_dynvec_point2d_sint_del(&addedlist);
-
+   rox_connected_components_del ( &ccl );
    return error;
 }
 
@@ -120,9 +115,7 @@ Rox_ErrorCode rox_array2d_uint_connectivity_value (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint val;
-   Rox_DynVec_Point2D_Sint addedlist = NULL, stack = NULL;
-   Rox_Point2D_Sint_Struct toadd, top;
+   Rox_Connected_Components ccl = NULL;
 
    if (!lists || !source) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -133,81 +126,16 @@ Rox_ErrorCode rox_array2d_uint_connectivity_value (
    error = rox_array2d_uint_get_size(&rows, &cols, source);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_dynvec_point2d_sint_new(&stack, 10);
+   error = rox_connected_components_new ( &ccl, rows, cols );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uint ** ds = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer( &ds, source);
+   error = rox_connected_components_make_value ( ccl, source, 8 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for (Rox_Sint i = 0; i < rows; i++)
-   {
-      for (Rox_Sint j = 0; j < cols; j++)
-      {
-         if (ds[i][j] == 0) continue;
-         val = ds[i][j];
-         ds[i][j] = 0;
-
-         if (addedlist)
-         {
-            rox_dynvec_point2d_sint_reset(addedlist);
-         }
-         else
-         {
-            error = rox_dynvec_point2d_sint_new(&addedlist, 10);
-            ROX_ERROR_CHECK_TERMINATE(error)
-         }
-
-         toadd.u = j;
-         toadd.v = i;
-         rox_dynvec_point2d_sint_append(stack, &toadd);
-
-         while (stack->used)
-         {
-            // Pop element from stack
-            top = stack->data[stack->used - 1];
-            stack->used--;
-
-            rox_dynvec_point2d_sint_append(addedlist, &top);
-
-
-            for (Rox_Sint di = -1; di <= 1; di++)
-            {
-               Rox_Sint cy = top.v + di;
-               if (cy < 0 || cy >= rows) continue;
-
-               for (Rox_Sint dj = -1; dj <= 1; dj++)
-               {
-                  if (di == 0 && dj == 0) continue;
-                  Rox_Sint cx = top.u + dj;
-
-                  if (cx < 0 || cx >= cols) continue;
-
-                  if (ds[cy][cx] == val)
-                  {
-                     ds[cy][cx] = 0;
-
-                     toadd.u = cx;
-                     toadd.v = cy;
-                     error = rox_dynvec_point2d_sint_append(stack, &toadd);
-                     ROX_ERROR_CHECK_TERMINATE ( error );
-                  }
-               }
-            }
-         }
-
-         if ( addedlist->used > min_length )
-         {
-            error = rox_objset_dynvec_point2d_sint_append(lists, addedlist);
-            ROX_ERROR_CHECK_TERMINATE ( error );
-            addedlist = NULL;
-         }
-      }
-   }
+   error = rox_connected_components_get_lists ( lists, ccl, min_length );
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
-   rox_dynvec_point2d_sint_del(&stack);
-   rox_dynvec_point2d_sint_del(&addedlist);
-
+   rox_connected_components_del ( &ccl );
    return error;
 }
@@ -23,9 +23,9 @@
 //! \addtogroup Connectivity
 //! @{
 
-//! Compute the list of connected chains
-//! \param  [out]  lists          A list of vectors of coordinates
-//! \param  [in ]  source         A binary image. This image will be modified by the function and may be empty after this function termination.
+//! Compute the list of connected chains (8-connectivity), in the order of their first pixel
+//! \param  [out]  lists          A list of vectors of coordinates, the coordinates of each vector are in raster order
+//! \param  [in ]  source         A binary image. This image is not modified.
 //! \param  [in ]  min_length     Minimum length of a list of pixel we want to be stored
 //! \return An error code
 ROX_API Rox_ErrorCode rox_array2d_uchar_connectivity (
@@ -34,9 +34,9 @@ ROX_API Rox_ErrorCode rox_array2d_uchar_connectivity (
    Rox_Uint min_length
 );
 
-//! Compute the list of connected chains with same value
-//! \param  [out]  lists          A list of vectors of coordinates
-//! \param  [in ]  source         A integer image. This image will be modified by the function and may be empty after this function termination.
+//! Compute the list of connected chains with same value (8-connectivity), in the order of their first pixel
+//! \param  [out]  lists          A list of vectors of coordinates, the coordinates of each vector are in raster order
+//! \param  [in ]  source         A integer image. This image is not modified.
 //! \param  [in ]  min_length     Minimum length of a list of pixel we want to be stored
 //! \return An error code
 ROX_API Rox_ErrorCode rox_array2d_uint_connectivity_value (
@@ -0,0 +1,70 @@
+//==============================================================================
+//
+//    OPENROX   : File unionfind.h
+//
+//    Contents  : API of unionfind module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_UNIONFIND__
+#define __OPENROX_UNIONFIND__
+
+#include <system/memory/datatypes.h>
+
+//! \ingroup Image
+//! \addtogroup Connectivity
+//! @{
+
+//! Union-find on an array of parents: parent[id] == id for the root of a set.
+//! The sets are always linked to the root with the lowest id, so that parent[id] <= id
+//! and a set is represented by its first element in scan order.
+
+//! Find the root of the set of an element, with path compression
+//! \param  [in ]  parent         The array of parents
+//! \param  [in ]  id             The element
+//! \return The root of the set
+static inline Rox_Uint rox_unionfind_find ( Rox_Uint * parent, Rox_Uint id )
+{
+   Rox_Uint root = id;
+   while ( parent[root] != root ) root = parent[root];
+
+   // Link the whole path to the root
+   while ( parent[id] != root )
+   {
+      const Rox_Uint next = parent[id];
+      parent[id] = root;
+      id = next;
+   }
+
+   return root;
+}
+
+//! Merge the sets of two elements
+//! \param  [in ]  parent         The array of parents
+//! \param  [in ]  a              The first element
+//! \param  [in ]  b              The second element
+//! \return The root of the merged set (the lowest of the two roots)
+static inline Rox_Uint rox_unionfind_union ( Rox_Uint * parent, const Rox_Uint a, const Rox_Uint b )
+{
+   const Rox_Uint root_a = rox_unionfind_find ( parent, a );
+   const Rox_Uint root_b = rox_unionfind_find ( parent, b );
+
+   if ( root_a < root_b )
+   {
+      parent[root_b] = root_a;
+      return root_a;
+   }
+
+   parent[root_a] = root_b;
+   return root_b;
+}
+
+//! @}
+
+#endif // __OPENROX_UNIONFIND__
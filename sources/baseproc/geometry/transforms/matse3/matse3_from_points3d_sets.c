@@ -21,7 +21,7 @@
 #include <generated/objset_array2d_double_struct.h>
 
 #include <baseproc/array/add/add.h>
-#include <baseproc/array/decomposition/svd.h>
+#include <baseproc/array/decomposition/svd3x3.h>
 #include <baseproc/array/determinant/detgl3.h>
 #include <baseproc/array/inverse/mat3x3inv.h>
 #include <baseproc/array/multiply/mulmatmat.h>
@@ -53,8 +53,7 @@ Rox_ErrorCode rox_matse3_from_dynvec_points3d_double (
    Rox_DynVec_Point3D_Double   a_pts=NULL, b_pts=NULL;
    Rox_Matrix                  bRa=NULL;
    Rox_Matrix                  As=NULL, Bs=NULL;
-   Rox_Matrix                  U=NULL, S=NULL, V=NULL;
-   Rox_Double                  det=1.0;
+   Rox_Matrix                  M=NULL;
    Rox_Point3D_Double_Struct   b_mean, b_r_mean;
 
    // Check inputs
@@ -89,22 +88,12 @@ Rox_ErrorCode rox_matse3_from_dynvec_points3d_double (
    error = rox_matrix_new( &Bs, 3 , n_b );                                
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_matrix_new( &U , 3 , 3 );                                  
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_matrix_new( &S , 3 , 1 );                                  
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_matrix_new( &V , 3 , 3 );                                  
+   error = rox_matrix_new( &M , 3 , 3 );                                  
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    Rox_Double ** bTa_data = NULL;
    error = rox_array2d_double_get_data_pointer_to_pointer ( &bTa_data, bTa );
    ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   Rox_Double ** V_data=NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &V_data, V );
-   ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Prepare bTa
    error = rox_matse3_set_unit( bTa );                                    
@@ -123,28 +112,13 @@ Rox_ErrorCode rox_matse3_from_dynvec_points3d_double (
    error = rox_matrix_from_dynvec_point3d_double( Bs, b_pts );            
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_mulmatmattrans( bRa, Bs, As );              
+   error = rox_array2d_double_mulmatmattrans( M, Bs, As );                
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_svd( U, S, V, bRa );                        
+   // The rotation is the nearest one to the correlation matrix
+   error = rox_array2d_double_polar3x3( bRa, M );                         
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_mulmatmattrans( bRa, U, V );                
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_detgl3 ( &det, bRa );                        
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   if ( det < 0.0 )
-   {
-      V_data[0][0] = -V_data[0][0];
-      V_data[0][1] = -V_data[0][1];
-      V_data[0][2] = -V_data[0][2];
-
-      error = rox_array2d_double_mulmatmattrans( bRa, U, V );             
-      ROX_ERROR_CHECK_TERMINATE ( error );
-   }
-
    // Compute bta
    error = rox_dynvec_point3d_double_mean( &b_mean, b_points );           
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -157,9 +131,7 @@ Rox_ErrorCode rox_matse3_from_dynvec_points3d_double (
    bTa_data[2][3] = - b_r_mean.Z;
 
 function_terminate:
-   if ( NULL != V     ) rox_matrix_del               ( &V     );
-   if ( NULL != S     ) rox_matrix_del               ( &S     );
-   if ( NULL != U     ) rox_matrix_del               ( &U     );
+   if ( NULL != M     ) rox_matrix_del               ( &M     );
    if ( NULL != Bs    ) rox_matrix_del               ( &Bs    );
    if ( NULL != As    ) rox_matrix_del               ( &As    );
    if ( NULL != b_pts ) rox_dynvec_point3d_double_del( &b_pts );
@@ -0,0 +1,112 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_sl3from4points.c
+//
+//    Contents  : Implementation of sl3from4points module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#include "ansi_sl3from4points.h"
+
+#include <math.h>
+#include <float.h>
+
+// The homography from the canonical frame to the 4 points
+static void rox_ansi_matsl3_canonical ( double M[9], const double * p )
+{
+   const double u1 = p[0], v1 = p[1], u2 = p[2], v2 = p[3];
+   const double u3 = p[4], v3 = p[5], u4 = p[6], v4 = p[7];
+
+   M[0] = (u2 - u1) * (u3 * v4 - v3 * u4) + (v1 * u2 - u1 * v2) * (u4 - u3);
+   M[1] = (u3 - u1) * (u2 * v4 - v2 * u4) + (v1 * u3 - u1 * v3) * (u4 - u2);
+   M[2] = (u4 - u1) * (u2 * v3 - v2 * u3) - (u1 * v4 - v1 * u4) * (u3 - u2);
+   M[3] = (u1 * v2 - v1 * u2) * (v3 - v4) + (v1 - v2) * (v3 * u4 - u3 * v4);
+   M[4] = (u1 * v3 - v1 * u3) * (v2 - v4) + (v1 - v3) * (v2 * u4 - u2 * v4);
+   M[5] = (u1 * v4 - v1 * u4) * (v2 - v3) + (v1 - v4) * (v2 * u3 - u2 * v3);
+   M[6] = (v1 - v2) * (u4 - u3) - (u2 - u1) * (v3 - v4);
+   M[7] = (v1 - v3) * (u4 - u2) - (u3 - u1) * (v2 - v4);
+   M[8] = (v1 - v4) * (u3 - u2) + (u1 - u4) * (v2 - v3);
+}
+
+static double rox_ansi_matsl3_det ( const double M[9] )
+{
+   return M[0] * M[4] * M[8] + M[1] * M[5] * M[6] + M[2] * M[3] * M[7] - M[0] * M[5] * M[7] - M[1] * M[3] * M[8] - M[2] * M[4] * M[6];
+}
+
+int rox_ansi_matsl3_from_4_points_double_batch (
+   double * homographies,
+   int * valid,
+   const double * source,
+   const double * dest,
+   const int count
+)
+{
+   const double onethird = -1.0 / 3.0;
+
+   for ( int k = 0; k < count; k++ )
+   {
+      double He[9], Hep[9], Hei[9];
+      double * H = &homographies[9 * k];
+      const double * p = &source[8 * k];
+      double det = 0.0, idet = 0.0, scale = 0.0;
+
+      rox_ansi_matsl3_canonical ( He, p );
+      rox_ansi_matsl3_canonical ( Hep, &dest[8 * k] );
+
+      valid[k] = 0;
+      for ( int i = 0; i < 9; i++ ) H[i] = 0.0;
+
+      // Inverse of He
+      det = rox_ansi_matsl3_det ( He );
+      if ( fabs ( det ) < DBL_EPSILON ) continue;
+
+      idet = 1.0 / det;
+      Hei[0] = idet * (He[4] * He[8] - He[5] * He[7]);
+      Hei[1] = idet * (He[2] * He[7] - He[1] * He[8]);
+      Hei[2] = idet * (He[1] * He[5] - He[2] * He[4]);
+      Hei[3] = idet * (He[6] * He[5] - He[3] * He[8]);
+      Hei[4] = idet * (He[0] * He[8] - He[6] * He[2]);
+      Hei[5] = idet * (He[3] * He[2] - He[0] * He[5]);
+      Hei[6] = idet * (He[3] * He[7] - He[6] * He[4]);
+      Hei[7] = idet * (He[6] * He[1] - He[0] * He[7]);
+      Hei[8] = idet * (He[0] * He[4] - He[3] * He[1]);
+
+      // H = Hep * Hei
+      for ( int i = 0; i < 3; i++ )
+      {
+         for ( int j = 0; j < 3; j++ )
+         {
+            H[i * 3 + j] = 0.0 + Hep[i * 3] * Hei[j] + Hep[i * 3 + 1] * Hei[3 + j] + Hep[i * 3 + 2] * Hei[6 + j];
+         }
+      }
+
+      // Normalize to a determinant equal to one
+      det = rox_ansi_matsl3_det ( H );
+      if ( fabs ( det - 1.0 ) < DBL_EPSILON ) scale = 1.0;
+      else if ( det < -DBL_EPSILON ) scale = -pow ( -det, onethird );
+      else if ( det > DBL_EPSILON ) scale = pow ( det, onethird );
+      else
+      {
+         for ( int i = 0; i < 9; i++ ) H[i] = 0.0;
+         continue;
+      }
+
+      for ( int i = 0; i < 9; i++ ) H[i] *= scale;
+
+      // The third coordinate of the first point must be positive
+      if ( ( H[6] * p[0] + H[7] * p[1] + H[8] ) < 0.0 )
+      {
+         for ( int i = 0; i < 9; i++ ) H[i] = -H[i];
+      }
+
+      valid[k] = 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,32 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_sl3from4points.h
+//
+//    Contents  : API of sl3from4points module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#ifndef __OPENROX_ANSI_SL3_FROM_4_POINTS__
+#define __OPENROX_ANSI_SL3_FROM_4_POINTS__
+
+//! Compute the homographies of a batch of 4 points correspondences
+//! The ansi version and the sse version share the same interface and give the same results
+
+//! homographies : 9 * count doubles, the row major homographies (zero for the invalid samples)
+//! valid        : count flags, 1 if the homography of the sample is defined, 0 otherwise
+//! source, dest : 8 * count doubles, the 4 points (u1, v1, ..., u4, v4) of each sample
+int rox_ansi_matsl3_from_4_points_double_batch (
+   double * homographies,
+   int * valid,
+   const double * source,
+   const double * dest,
+   const int count
+);
+
+#endif
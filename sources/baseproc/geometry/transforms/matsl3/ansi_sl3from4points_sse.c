@@ -0,0 +1,144 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_sl3from4points_sse.c
+//
+//    Contents  : Implementation of sl3from4points module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#include "ansi_sl3from4points.h"
+
+#include <math.h>
+#include <float.h>
+#include <system/vectorisation/sse.h>
+
+// The homography from the canonical frame to the 4 points of two samples
+static void rox_sse_matsl3_canonical ( __m128d M[9], const __m128d p[8] )
+{
+   const __m128d u1 = p[0], v1 = p[1], u2 = p[2], v2 = p[3];
+   const __m128d u3 = p[4], v3 = p[5], u4 = p[6], v4 = p[7];
+
+   M[0] = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(u2, u1), _mm_sub_pd(_mm_mul_pd(u3, v4), _mm_mul_pd(v3, u4))), _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(v1, u2), _mm_mul_pd(u1, v2)), _mm_sub_pd(u4, u3)));
+   M[1] = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(u3, u1), _mm_sub_pd(_mm_mul_pd(u2, v4), _mm_mul_pd(v2, u4))), _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(v1, u3), _mm_mul_pd(u1, v3)), _mm_sub_pd(u4, u2)));
+   M[2] = _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(u4, u1), _mm_sub_pd(_mm_mul_pd(u2, v3), _mm_mul_pd(v2, u3))), _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(u1, v4), _mm_mul_pd(v1, u4)), _mm_sub_pd(u3, u2)));
+   M[3] = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_mul_pd(u1, v2), _mm_mul_pd(v1, u2)), _mm_sub_pd(v3, v4)), _mm_mul_pd(_mm_sub_pd(v1, v2), _mm_sub_pd(_mm_mul_pd(v3, u4), _mm_mul_pd(u3, v4))));
+   M[4] = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_mul_pd(u1, v3), _mm_mul_pd(v1, u3)), _mm_sub_pd(v2, v4)), _mm_mul_pd(_mm_sub_pd(v1, v3), _mm_sub_pd(_mm_mul_pd(v2, u4), _mm_mul_pd(u2, v4))));
+   M[5] = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_mul_pd(u1, v4), _mm_mul_pd(v1, u4)), _mm_sub_pd(v2, v3)), _mm_mul_pd(_mm_sub_pd(v1, v4), _mm_sub_pd(_mm_mul_pd(v2, u3), _mm_mul_pd(u2, v3))));
+   M[6] = _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(v1, v2), _mm_sub_pd(u4, u3)), _mm_mul_pd(_mm_sub_pd(u2, u1), _mm_sub_pd(v3, v4)));
+   M[7] = _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(v1, v3), _mm_sub_pd(u4, u2)), _mm_mul_pd(_mm_sub_pd(u3, u1), _mm_sub_pd(v2, v4)));
+   M[8] = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(v1, v4), _mm_sub_pd(u3, u2)), _mm_mul_pd(_mm_sub_pd(u1, u4), _mm_sub_pd(v2, v3)));
+}
+
+// Same operations order as rox_array2d_double_detgl3
+static __m128d rox_sse_matsl3_det ( const __m128d M[9] )
+{
+   __m128d det = _mm_mul_pd(_mm_mul_pd(M[0], M[4]), M[8]);
+   det = _mm_add_pd(det, _mm_mul_pd(_mm_mul_pd(M[1], M[5]), M[6]));
+   det = _mm_add_pd(det, _mm_mul_pd(_mm_mul_pd(M[2], M[3]), M[7]));
+   det = _mm_sub_pd(det, _mm_mul_pd(_mm_mul_pd(M[0], M[5]), M[7]));
+   det = _mm_sub_pd(det, _mm_mul_pd(_mm_mul_pd(M[1], M[3]), M[8]));
+   det = _mm_sub_pd(det, _mm_mul_pd(_mm_mul_pd(M[2], M[4]), M[6]));
+   return det;
+}
+
+int rox_ansi_matsl3_from_4_points_double_batch (
+   double * homographies,
+   int * valid,
+   const double * source,
+   const double * dest,
+   const int count
+)
+{
+   const double onethird = -1.0 / 3.0;
+   const __m128d ssezero = _mm_setzero_pd();
+   const __m128d ssesign = _mm_set1_pd(-0.0);
+   ROX_STATIC_ALIGN(16) double det[2], scale[2], out[9][2];
+
+   // Two samples per iteration, the last one is duplicated if the count is odd
+   for ( int k = 0; k < count; k += 2 )
+   {
+      const int k1 = ( k + 1 < count ) ? k + 1 : k;
+      __m128d p[8], pp[8], He[9], Hep[9], Hei[9], H[9];
+      __m128d ssedet, sseidet, ssescale, ssevalid, ssew;
+      int lanes_valid[2];
+
+      for ( int i = 0; i < 8; i++ )
+      {
+         p[i] = _mm_set_pd(source[8 * k1 + i], source[8 * k + i]);
+         pp[i] = _mm_set_pd(dest[8 * k1 + i], dest[8 * k + i]);
+      }
+
+      rox_sse_matsl3_canonical ( He, p );
+      rox_sse_matsl3_canonical ( Hep, pp );
+
+      // Inverse of He
+      ssedet = rox_sse_matsl3_det ( He );
+      sseidet = _mm_div_pd(_mm_set1_pd(1.0), ssedet);
+
+      _mm_store_pd(det, ssedet);
+      lanes_valid[0] = !( fabs ( det[0] ) < DBL_EPSILON );
+      lanes_valid[1] = !( fabs ( det[1] ) < DBL_EPSILON );
+
+      Hei[0] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[4], He[8]), _mm_mul_pd(He[5], He[7])));
+      Hei[1] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[2], He[7]), _mm_mul_pd(He[1], He[8])));
+      Hei[2] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[1], He[5]), _mm_mul_pd(He[2], He[4])));
+      Hei[3] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[6], He[5]), _mm_mul_pd(He[3], He[8])));
+      Hei[4] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[0], He[8]), _mm_mul_pd(He[6], He[2])));
+      Hei[5] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[3], He[2]), _mm_mul_pd(He[0], He[5])));
+      Hei[6] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[3], He[7]), _mm_mul_pd(He[6], He[4])));
+      Hei[7] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[6], He[1]), _mm_mul_pd(He[0], He[7])));
+      Hei[8] = _mm_mul_pd(sseidet, _mm_sub_pd(_mm_mul_pd(He[0], He[4]), _mm_mul_pd(He[3], He[1])));
+
+      // H = Hep * Hei
+      for ( int i = 0; i < 3; i++ )
+      {
+         for ( int j = 0; j < 3; j++ )
+         {
+            __m128d sum = _mm_add_pd(ssezero, _mm_mul_pd(Hep[i * 3], Hei[j]));
+            sum = _mm_add_pd(sum, _mm_mul_pd(Hep[i * 3 + 1], Hei[3 + j]));
+            H[i * 3 + j] = _mm_add_pd(sum, _mm_mul_pd(Hep[i * 3 + 2], Hei[6 + j]));
+         }
+      }
+
+      // Normalize to a determinant equal to one, the cubic roots are computed for each lane
+      _mm_store_pd(det, rox_sse_matsl3_det ( H ));
+      for ( int l = 0; l < 2; l++ )
+      {
+         scale[l] = 0.0;
+         if ( fabs ( det[l] - 1.0 ) < DBL_EPSILON ) scale[l] = 1.0;
+         else if ( det[l] < -DBL_EPSILON ) scale[l] = -pow ( -det[l], onethird );
+         else if ( det[l] > DBL_EPSILON ) scale[l] = pow ( det[l], onethird );
+         else lanes_valid[l] = 0;
+      }
+
+      ssescale = _mm_load_pd(scale);
+      for ( int i = 0; i < 9; i++ ) H[i] = _mm_mul_pd(H[i], ssescale);
+
+      // The third coordinate of the first point must be positive
+      ssew = _mm_add_pd(_mm_add_pd(_mm_mul_pd(H[6], p[0]), _mm_mul_pd(H[7], p[1])), H[8]);
+      ssew = _mm_and_pd(_mm_cmplt_pd(ssew, ssezero), ssesign);
+
+      ssevalid = _mm_castsi128_pd(_mm_set_epi64x(lanes_valid[1] ? -1 : 0, lanes_valid[0] ? -1 : 0));
+      for ( int i = 0; i < 9; i++ )
+      {
+         _mm_store_pd(out[i], _mm_and_pd(_mm_xor_pd(H[i], ssew), ssevalid));
+      }
+
+      for ( int i = 0; i < 9; i++ ) homographies[9 * k + i] = out[i][0];
+      valid[k] = lanes_valid[0];
+
+      if ( k1 != k )
+      {
+         for ( int i = 0; i < 9; i++ ) homographies[9 * k1 + i] = out[i][1];
+         valid[k1] = lanes_valid[1];
+      }
+   }
+
+   return 0;
+}
@@ -45,6 +45,22 @@ ROX_API Rox_ErrorCode rox_matsl3_from_4_points_float (
    Rox_Point2D_Float dest
 );
 
+//! Generate the homographies of a batch of 4 points correspondences, without any memory allocation.
+//! The homography of each sample is the same as the one given by rox_matsl3_from_4_points_double.
+//! \param  [out]  homographies   The 9 * count values of the row major homographies (destHsource), zero for the invalid samples
+//! \param  [out]  valid          The count flags, 1 if the homography of the sample is defined, 0 otherwise
+//! \param  [in ]  source         The 4 * count points in the source view, 4 consecutive points per sample
+//! \param  [in ]  dest           The 4 * count points in the destination view, 4 consecutive points per sample
+//! \param  [in ]  count          The number of samples
+//! \return An error code
+ROX_API Rox_ErrorCode rox_matsl3_from_4_points_double_batch (
+   Rox_Double * homographies, 
+   Rox_Sint * valid, 
+   const Rox_Point2D_Double source, 
+   const Rox_Point2D_Double dest, 
+   const Rox_Sint count
+);
+
 //! @}
 
 #endif
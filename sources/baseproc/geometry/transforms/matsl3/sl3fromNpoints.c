@@ -22,8 +22,7 @@
 #include <baseproc/array/inverse/svdinverse.h>
 #include <baseproc/array/inverse/mat3x3inv.h>
 #include <baseproc/geometry/point/point2d_matsl3_transform.h>
-#include <baseproc/array/decomposition/svd.h>
-#include <baseproc/array/decomposition/svdsort.h>
+#include <baseproc/array/decomposition/eigen_symm.h>
 #include <baseproc/geometry/transforms/matsl3/sl3normalize.h>
 #include <inout/system/errors_print.h>
 
@@ -39,12 +38,13 @@ Rox_ErrorCode rox_matsl3_from_n_points_double (
 {
     Rox_ErrorCode error = ROX_ERROR_NONE;
 
-    Rox_Array2D_Double Cn = 0, U = 0, S = 0, V = 0, M = 0, iKc = 0, Vn = 0, VK = 0;
+    Rox_Array2D_Double Cn = 0, M = 0, iKc = 0, Vn = 0, VK = 0;
     Rox_Array2D_Double Kref = 0, Kcur = 0;
     Rox_Point2D_Double ref_norm = 0, cur_norm = 0;
 
     Rox_Uint row;
-    Rox_Double **dC, **dVn, **dV, **dK;
+    Rox_Double **dC, **dVn, **dM, **dK;
+    Rox_Double MtM[81], D[9], E[81];
     Rox_Double X, Y, u, v;
     Rox_Double sumx_ref = 0, sumy_ref = 0, sumx_cur = 0, sumy_cur = 0, sum_norm_ref = 0, sum_norm_cur = 0;
     Rox_Double meanx_ref = 0, meany_ref = 0, meanx_cur = 0, meany_cur = 0;
@@ -71,15 +71,6 @@ Rox_ErrorCode rox_matsl3_from_n_points_double (
     error = rox_array2d_double_new(&M, 9, 9);
     ROX_ERROR_CHECK_TERMINATE(error)
 
-    error = rox_array2d_double_new(&U, 9, 9);
-    ROX_ERROR_CHECK_TERMINATE(error)
-
-    error = rox_array2d_double_new(&V, 9, 9);
-    ROX_ERROR_CHECK_TERMINATE(error)
-
-    error = rox_array2d_double_new(&S, 9, 1);
-    ROX_ERROR_CHECK_TERMINATE ( error );
-
     error = rox_array2d_double_new(&Vn, 3, 3);
     ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -100,9 +91,6 @@ Rox_ErrorCode rox_matsl3_from_n_points_double (
     error  = rox_array2d_double_get_data_pointer_to_pointer( &dC, Cn);
     ROX_ERROR_CHECK_TERMINATE ( error );
     
-    error  = rox_array2d_double_get_data_pointer_to_pointer( &dV, V);
-    ROX_ERROR_CHECK_TERMINATE ( error );
-
     error = rox_array2d_double_get_data_pointer_to_pointer( &dVn, Vn);
     ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -206,20 +194,25 @@ Rox_ErrorCode rox_matsl3_from_n_points_double (
     error = rox_array2d_double_mulmattransmat(M, Cn, Cn);
     ROX_ERROR_CHECK_TERMINATE(error)
 
-    // SVD
-    error = rox_array2d_double_svd(U, S, V, M);
+    // Eigenvectors of the symmetric matrix M, the solution is the one of the smallest eigenvalue
+    error = rox_array2d_double_get_data_pointer_to_pointer( &dM, M);
     ROX_ERROR_CHECK_TERMINATE(error)
 
-    error = rox_array2d_double_svd_sort(U, S, V);
+    for (Rox_Sint i = 0; i < 9; i++)
+    {
+       for (Rox_Sint j = 0; j < 9; j++) MtM[i * 9 + j] = dM[i][j];
+    }
+
+    error = rox_array_double_eigen_symm9x9(D, E, MtM);
     ROX_ERROR_CHECK_TERMINATE(error)
 
     // Build G = inv(K_cur)*[Vn(1:3,9)' ; Vn(4:6,9)' ; Vn(7:9,9)']*K_ref;
     error = rox_array2d_double_mat3x3_inverse(iKc, Kcur);
     ROX_ERROR_CHECK_TERMINATE(error)
 
-    dVn[0][0] = dV[0][8]; dVn[0][1] = dV[1][8]; dVn[0][2] = dV[2][8];
-    dVn[1][0] = dV[3][8]; dVn[1][1] = dV[4][8]; dVn[1][2] = dV[5][8];
-    dVn[2][0] = dV[6][8]; dVn[2][1] = dV[7][8]; dVn[2][2] = dV[8][8];
+    dVn[0][0] = E[0 * 9 + 8]; dVn[0][1] = E[1 * 9 + 8]; dVn[0][2] = E[2 * 9 + 8];
+    dVn[1][0] = E[3 * 9 + 8]; dVn[1][1] = E[4 * 9 + 8]; dVn[1][2] = E[5 * 9 + 8];
+    dVn[2][0] = E[6 * 9 + 8]; dVn[2][1] = E[7 * 9 + 8]; dVn[2][2] = E[8 * 9 + 8];
 
     error = rox_array2d_double_mulmatmat(VK, Vn, Kref);
     ROX_ERROR_CHECK_TERMINATE(error)
@@ -233,9 +226,6 @@ Rox_ErrorCode rox_matsl3_from_n_points_double (
 
 
 function_terminate:
-    rox_array2d_double_del(&U);
-    rox_array2d_double_del(&S);
-    rox_array2d_double_del(&V);
     rox_array2d_double_del(&Vn);
     rox_array2d_double_del(&VK);
     rox_array2d_double_del(&Cn);
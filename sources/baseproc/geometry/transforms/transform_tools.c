@@ -28,7 +28,7 @@
 #include <baseproc/array/determinant/detgl3.h>
 #include <baseproc/array/scale/scale.h>
 #include <baseproc/array/inverse/mat3x3inv.h>
-#include <baseproc/array/decomposition/svd.h>
+#include <baseproc/array/decomposition/svd3x3.h>
 #include <baseproc/array/multiply/mulmatmattrans.h>
 #include <baseproc/array/fill/fillunit.h>
 #include <baseproc/array/normalize/normalize.h>
@@ -1862,7 +1862,7 @@ Rox_ErrorCode rox_transformtools_build_pose_intermodel (
 
    //  Now He = scale * [r1 r2 0]
    //  SVD of the matrix He = U*S*V'. Ideally S = [scale, 0, 0; 0, scale, 0; 0, 0, 0]
-   error = rox_array2d_double_svd ( U, S, V, H );
+   error = rox_array2d_double_svd3x3 ( U, S, V, H );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    //  The matrix Re = U*V' is the estimated rotation
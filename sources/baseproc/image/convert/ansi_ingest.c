@@ -0,0 +1,94 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_ingest.c
+//
+//    Contents  : Implementation of ansi_ingest module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_ingest.h"
+
+int rox_ansi_ingest_row_4bytes_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int r,
+   int g,
+   int b
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      const unsigned char * rs = src + 4 * j;
+      gray[j] = (unsigned char) ((rs[r] * 0.212671f) + (rs[g] * 0.715160f) + (rs[b] * 0.072169f));
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_3bytes_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int r,
+   int g,
+   int b
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      const unsigned char * rs = src + 3 * j;
+      gray[j] = (unsigned char) ((rs[r] * 0.212671f) + (rs[g] * 0.715160f) + (rs[b] * 0.072169f));
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_4bytes_channel (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int channel
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      gray[j] = src[4 * j + channel];
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_yuv422_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      gray[j] = src[2 * j];
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_normalize (
+   float * out,
+   const unsigned char * gray,
+   int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      out[j] = (1.0f / 255.0f) * (float) gray[j];
+   }
+
+   return 0;
+}
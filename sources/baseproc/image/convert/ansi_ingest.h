@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_ingest.h
+//
+//    Contents  : API of ansi_ingest module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+// Row kernels of the frame ingest: each call converts one row of cols pixels.
+// The results are identical to the whole image converters (*_to_roxgray.c).
+
+// Luma with the BT.709 float coefficients of 4 bytes pixels, channels at offsets r, g, b
+int rox_ansi_ingest_row_4bytes_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int r,
+   int g,
+   int b
+);
+
+// Luma with the BT.709 float coefficients of 3 bytes pixels, channels at offsets r, g, b
+int rox_ansi_ingest_row_3bytes_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int r,
+   int g,
+   int b
+);
+
+// One channel of 4 bytes pixels (alpha8 stored in 32 bits)
+int rox_ansi_ingest_row_4bytes_channel (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int channel
+);
+
+// Y channel of YUYV pixel pairs
+int rox_ansi_ingest_row_yuv422_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols
+);
+
+// Gray values normalized in [0, 1]
+int rox_ansi_ingest_row_normalize (
+   float * out,
+   const unsigned char * gray,
+   int cols
+);
@@ -0,0 +1,200 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_ingest_sse.c
+//
+//    Contents  : Implementation of ansi_ingest module with SSE optimisation
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_ingest.h"
+#include <system/vectorisation/sse.h>
+
+// The vector paths convert 16 pixels per iteration, the products are computed in the same
+// order as the scalar code so that the results are identical, the remaining pixels are scalar.
+
+// Pack 4 x 4 integers in [0, 255] to 16 bytes
+static inline __m128i rox_sse_ingest_pack ( __m128i a, __m128i b, __m128i c, __m128i d )
+{
+   return _mm_packus_epi16 ( _mm_packs_epi32 ( a, b ), _mm_packs_epi32 ( c, d ) );
+}
+
+// Luma of 4 pixels given their channels as 32 bits integers
+static inline __m128i rox_sse_ingest_luma ( __m128i r, __m128i g, __m128i b )
+{
+   const __m128 cr = _mm_set1_ps ( 0.212671f );
+   const __m128 cg = _mm_set1_ps ( 0.715160f );
+   const __m128 cb = _mm_set1_ps ( 0.072169f );
+
+   __m128 y = _mm_add_ps ( _mm_mul_ps ( _mm_cvtepi32_ps ( r ), cr ), _mm_mul_ps ( _mm_cvtepi32_ps ( g ), cg ) );
+   y = _mm_add_ps ( y, _mm_mul_ps ( _mm_cvtepi32_ps ( b ), cb ) );
+
+   return _mm_cvttps_epi32 ( y );
+}
+
+// Extract the byte at a given shift of 4 pixels of 4 bytes
+static inline __m128i rox_sse_ingest_channel ( __m128i v, __m128i shift )
+{
+   return _mm_and_si128 ( _mm_srl_epi32 ( v, shift ), _mm_set1_epi32 ( 0xFF ) );
+}
+
+int rox_ansi_ingest_row_4bytes_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int r,
+   int g,
+   int b
+)
+{
+   const __m128i sr = _mm_cvtsi32_si128 ( 8 * r );
+   const __m128i sg = _mm_cvtsi32_si128 ( 8 * g );
+   const __m128i sb = _mm_cvtsi32_si128 ( 8 * b );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      __m128i y[4];
+      for ( int k = 0; k < 4; k++ )
+      {
+         const __m128i v = _mm_loadu_si128 ( (const __m128i *) ( src + 4 * j + 16 * k ) );
+         y[k] = rox_sse_ingest_luma ( rox_sse_ingest_channel ( v, sr ), rox_sse_ingest_channel ( v, sg ), rox_sse_ingest_channel ( v, sb ) );
+      }
+
+      _mm_storeu_si128 ( (__m128i *) ( gray + j ), rox_sse_ingest_pack ( y[0], y[1], y[2], y[3] ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      const unsigned char * rs = src + 4 * j;
+      gray[j] = (unsigned char) ((rs[r] * 0.212671f) + (rs[g] * 0.715160f) + (rs[b] * 0.072169f));
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_3bytes_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int r,
+   int g,
+   int b
+)
+{
+   // Shuffles moving the channel of 4 pixels of 3 bytes to the low byte of 32 bits integers
+   const __m128i mr = _mm_setr_epi8 ( r, -1, -1, -1, 3 + r, -1, -1, -1, 6 + r, -1, -1, -1, 9 + r, -1, -1, -1 );
+   const __m128i mg = _mm_setr_epi8 ( g, -1, -1, -1, 3 + g, -1, -1, -1, 6 + g, -1, -1, -1, 9 + g, -1, -1, -1 );
+   const __m128i mb = _mm_setr_epi8 ( b, -1, -1, -1, 3 + b, -1, -1, -1, 6 + b, -1, -1, -1, 9 + b, -1, -1, -1 );
+
+   int j = 0;
+
+   // The last load of 16 bytes starts at pixel j + 12, do not read after the end of the row
+   for ( ; j + 18 <= cols; j += 16 )
+   {
+      __m128i y[4];
+      for ( int k = 0; k < 4; k++ )
+      {
+         const __m128i v = _mm_loadu_si128 ( (const __m128i *) ( src + 3 * j + 12 * k ) );
+         y[k] = rox_sse_ingest_luma ( _mm_shuffle_epi8 ( v, mr ), _mm_shuffle_epi8 ( v, mg ), _mm_shuffle_epi8 ( v, mb ) );
+      }
+
+      _mm_storeu_si128 ( (__m128i *) ( gray + j ), rox_sse_ingest_pack ( y[0], y[1], y[2], y[3] ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      const unsigned char * rs = src + 3 * j;
+      gray[j] = (unsigned char) ((rs[r] * 0.212671f) + (rs[g] * 0.715160f) + (rs[b] * 0.072169f));
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_4bytes_channel (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols,
+   int channel
+)
+{
+   const __m128i shift = _mm_cvtsi32_si128 ( 8 * channel );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      __m128i y[4];
+      for ( int k = 0; k < 4; k++ )
+      {
+         const __m128i v = _mm_loadu_si128 ( (const __m128i *) ( src + 4 * j + 16 * k ) );
+         y[k] = rox_sse_ingest_channel ( v, shift );
+      }
+
+      _mm_storeu_si128 ( (__m128i *) ( gray + j ), rox_sse_ingest_pack ( y[0], y[1], y[2], y[3] ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      gray[j] = src[4 * j + channel];
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_yuv422_to_gray (
+   unsigned char * gray,
+   const unsigned char * src,
+   int cols
+)
+{
+   const __m128i mask = _mm_set1_epi16 ( 0xFF );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      const __m128i v0 = _mm_loadu_si128 ( (const __m128i *) ( src + 2 * j ) );
+      const __m128i v1 = _mm_loadu_si128 ( (const __m128i *) ( src + 2 * j + 16 ) );
+
+      _mm_storeu_si128 ( (__m128i *) ( gray + j ), _mm_packus_epi16 ( _mm_and_si128 ( v0, mask ), _mm_and_si128 ( v1, mask ) ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      gray[j] = src[2 * j];
+   }
+
+   return 0;
+}
+
+int rox_ansi_ingest_row_normalize (
+   float * out,
+   const unsigned char * gray,
+   int cols
+)
+{
+   const __m128 scale = _mm_set1_ps ( 1.0f / 255.0f );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      __m128i v = _mm_loadu_si128 ( (const __m128i *) ( gray + j ) );
+
+      for ( int k = 0; k < 4; k++ )
+      {
+         _mm_storeu_ps ( out + j + 4 * k, _mm_mul_ps ( scale, _mm_cvtepi32_ps ( _mm_cvtepu8_epi32 ( v ) ) ) );
+         v = _mm_srli_si128 ( v, 4 );
+      }
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      out[j] = (1.0f / 255.0f) * (float) gray[j];
+   }
+
+   return 0;
+}
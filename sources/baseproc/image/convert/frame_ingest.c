@@ -0,0 +1,214 @@
+//==============================================================================
+//
+//    OPENROX   : File frame_ingest.c
+//
+//    Contents  : Implementation of frame_ingest module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "frame_ingest.h"
+#include "ansi_ingest.h"
+
+#include <string.h>
+
+#include <generated/array2d_float.h>
+
+#include <inout/system/errors_print.h>
+
+//=== INTERNAL MACROS    =======================================================
+
+#ifdef ROX_USES_OPENMP
+   #define ROX_FRAME_INGEST_PARALLEL_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+   #define ROX_FRAME_INGEST_PARALLEL_FOR
+#endif
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Get the number of bytes per pixel and the vertical flip of a buffer format
+static Rox_ErrorCode rox_frame_ingest_get_layout ( Rox_Sint * bytes, Rox_Sint * flipped, const enum Rox_Image_Format format )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   *flipped = 0;
+
+   switch ( format )
+   {
+      case Rox_Image_Format_Grays:
+      case Rox_Image_Format_NV12:
+         *bytes = 1;
+         break;
+
+      case Rox_Image_Format_YUV422:
+         *bytes = 2;
+         break;
+
+      case Rox_Image_Format_BGR:
+      case Rox_Image_Format_RGB:
+         *bytes = 3;
+         break;
+
+      case Rox_Image_Format_RGBA_FlippedUpsideDown:
+      case Rox_Image_Format_Alpha8_32bits_FlippedUpsideDown:
+         *flipped = 1;
+         *bytes = 4;
+         break;
+
+      case Rox_Image_Format_RGBA:
+      case Rox_Image_Format_BGRA:
+      case Rox_Image_Format_ARGB:
+      case Rox_Image_Format_Alpha8_32bits:
+         *bytes = 4;
+         break;
+
+      default:
+         error = ROX_ERROR_INVALID_VALUE;
+         ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
+
+// Convert one row of the buffer to gray, the format has been checked
+static void rox_frame_ingest_row ( Rox_Uchar * gray, const Rox_Uchar * src, const Rox_Sint cols, const enum Rox_Image_Format format )
+{
+   switch ( format )
+   {
+      case Rox_Image_Format_YUV422:
+         rox_ansi_ingest_row_yuv422_to_gray ( gray, src, cols );
+         break;
+
+      case Rox_Image_Format_RGBA:
+      case Rox_Image_Format_RGBA_FlippedUpsideDown:
+         rox_ansi_ingest_row_4bytes_to_gray ( gray, src, cols, 0, 1, 2 );
+         break;
+
+      case Rox_Image_Format_BGRA:
+         rox_ansi_ingest_row_4bytes_to_gray ( gray, src, cols, 2, 1, 0 );
+         break;
+
+      case Rox_Image_Format_ARGB:
+         rox_ansi_ingest_row_4bytes_to_gray ( gray, src, cols, 1, 2, 3 );
+         break;
+
+      case Rox_Image_Format_BGR:
+         rox_ansi_ingest_row_3bytes_to_gray ( gray, src, cols, 2, 1, 0 );
+         break;
+
+      case Rox_Image_Format_RGB:
+         rox_ansi_ingest_row_3bytes_to_gray ( gray, src, cols, 0, 1, 2 );
+         break;
+
+      case Rox_Image_Format_Alpha8_32bits:
+      case Rox_Image_Format_Alpha8_32bits_FlippedUpsideDown:
+         rox_ansi_ingest_row_4bytes_channel ( gray, src, cols, 3 );
+         break;
+
+      default:
+         // Gray and the luma plane of NV12
+         memcpy ( gray, src, cols );
+         break;
+   }
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+Rox_ErrorCode rox_frame_ingest (
+   Rox_Image gray,
+   Rox_Image_Float gray_float,
+   Rox_Pyramid_Float pyramid,
+   const Rox_Uchar * data,
+   const Rox_Sint bytesPerRow,
+   const enum Rox_Image_Format format
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint level_rows[ROX_FRAME_INGEST_BAND_LEVELS];
+   Rox_Sint level_cols[ROX_FRAME_INGEST_BAND_LEVELS];
+   Rox_Float *** levels = NULL;
+   Rox_Float ** df = NULL;
+   Rox_Uchar ** dg = NULL;
+
+   if ( !gray || !data )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Sint rows = 0, cols = 0;
+   error = rox_image_get_size ( &rows, &cols, gray );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sint bytes = 0, flipped = 0;
+   error = rox_frame_ingest_get_layout ( &bytes, &flipped, format );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( bytesPerRow < bytes * cols )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_image_get_data_pointer_to_pointer ( &dg, gray );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( gray_float )
+   {
+      error = rox_array2d_float_check_size ( gray_float, rows, cols );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_float_get_data_pointer_to_pointer ( &df, gray_float );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   // Levels computed inside the bands
+   Rox_Sint band_levels = 0;
+   if ( pyramid )
+   {
+      error = rox_array2d_float_check_size ( pyramid->levels[0], rows, cols );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_pyramid_float_get_band_levels ( &band_levels, level_rows, level_cols, pyramid, ROX_FRAME_INGEST_BAND_LEVELS );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      levels = pyramid->fast_access;
+   }
+
+   const Rox_Sint count_bands = ( rows + ROX_FRAME_INGEST_BAND - 1 ) / ROX_FRAME_INGEST_BAND;
+
+   ROX_FRAME_INGEST_PARALLEL_FOR
+   for ( Rox_Sint band = 0; band < count_bands; band++ )
+   {
+      const Rox_Sint first = band * ROX_FRAME_INGEST_BAND;
+      Rox_Sint last = first + ROX_FRAME_INGEST_BAND;
+      if ( last > rows ) last = rows;
+
+      for ( Rox_Sint i = first; i < last; i++ )
+      {
+         const Rox_Uchar * src = data + ( flipped ? rows - 1 - i : i ) * bytesPerRow;
+
+         rox_frame_ingest_row ( dg[i], src, cols, format );
+
+         if ( df ) rox_ansi_ingest_row_normalize ( df[i], dg[i], cols );
+
+         if ( levels )
+         {
+            if ( df ) memcpy ( levels[0][i], df[i], cols * sizeof ( Rox_Float ) );
+            else rox_ansi_ingest_row_normalize ( levels[0][i], dg[i], cols );
+         }
+      }
+
+      if ( pyramid ) rox_pyramid_float_assign_band ( pyramid, level_rows, level_cols, band_levels, first, ROX_FRAME_INGEST_BAND );
+   }
+
+   // The coarse levels are small, halve them after the bands
+   if ( pyramid )
+   {
+      error = rox_pyramid_float_assign_coarse_levels ( pyramid, band_levels );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
@@ -0,0 +1,53 @@
+//==============================================================================
+//
+//    OPENROX   : File frame_ingest.h
+//
+//    Contents  : API of frame_ingest module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_FRAME_INGEST__
+#define __OPENROX_FRAME_INGEST__
+
+#include <baseproc/image/image.h>
+#include <baseproc/image/pyramid/pyramid_float.h>
+
+//! \ingroup Image
+//! \addtogroup Image_Conversion
+//! @{
+
+//! The number of rows of the bands of the source buffer converted in parallel
+#define ROX_FRAME_INGEST_BAND 64
+
+//! The number of pyramid levels (including the base level) computed inside the bands, ROX_FRAME_INGEST_BAND >> (levels - 1) >= 1
+#define ROX_FRAME_INGEST_BAND_LEVELS 7
+
+//! Convert a camera buffer to a grayscale image, the normalized float image and the box filtered float pyramid in a single pass.
+//! The buffer is processed by bands of rows in parallel: each band is converted to gray, normalized in [0, 1] and halved
+//! while it is still in cache. The results are identical to rox_image_set_data, rox_array2d_float_from_uchar_normalize
+//! and rox_pyramid_float_assign called one after the other.
+//! \param  [out]  gray           The grayscale image
+//! \param  [out]  gray_float     The grayscale image normalized in [0, 1], may be NULL
+//! \param  [out]  pyramid        The pyramid of the normalized image, may be NULL
+//! \param  [in ]  data           The pixel buffer
+//! \param  [in ]  bytesPerRow    The octet size of one buffer row (for NV12, of one row of the luma plane)
+//! \param  [in ]  format         The pixel format of the buffer
+//! \return An error code
+ROX_API Rox_ErrorCode rox_frame_ingest (
+   Rox_Image gray,
+   Rox_Image_Float gray_float,
+   Rox_Pyramid_Float pyramid,
+   const Rox_Uchar * data,
+   const Rox_Sint bytesPerRow,
+   const enum Rox_Image_Format format
+);
+
+//! @}
+
+#endif // __OPENROX_FRAME_INGEST__
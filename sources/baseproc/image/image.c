@@ -208,7 +208,9 @@ Rox_ErrorCode rox_image_set_data (
          ROX_ERROR_CHECK_TERMINATE ( error );
 
       case  Rox_Image_Format_Grays:
+      case  Rox_Image_Format_NV12:
 
+         // The gray image of NV12 is its luma plane
          error = rox_gray_to_roxgray(image, data, bytesPerRow);
          ROX_ERROR_CHECK_TERMINATE ( error );
          break;
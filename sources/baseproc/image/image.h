@@ -34,7 +34,8 @@ enum Rox_Image_Format
      Rox_Image_Format_RGB,
      Rox_Image_Format_RGBA_FlippedUpsideDown,
      Rox_Image_Format_Alpha8_32bits,                     // Alpha8 is 1 byte per pixel but stored in the alpha value of a rgba buffer (32bits)
-     Rox_Image_Format_Alpha8_32bits_FlippedUpsideDown    // Alpha8 is 1 byte per pixel but stored in the alpha value of a rgba buffer (32bits)
+     Rox_Image_Format_Alpha8_32bits_FlippedUpsideDown,   // Alpha8 is 1 byte per pixel but stored in the alpha value of a rgba buffer (32bits)
+     Rox_Image_Format_NV12                               // Luma plane of 1 byte per pixel followed by the interleaved UV plane subsampled by 2
 };
 
 //! Define the Rox_Image object : Image grays in [0, 255]
@@ -19,6 +19,7 @@
 #include <system/time/timer.h>
 #include <baseproc/image/pyramid/pyramid_tools.h>
 #include <baseproc/image/remap/remap_box_halved/remap_box_halved.h>
+#include <baseproc/image/remap/remap_box_halved/ansi_remap_box_halved.h>
 #include <baseproc/image/remap/remap_nn_halved/remap_nn_halved.h>
 #include <baseproc/image/convolve/array2d_float_symmetric_separable_convolve.h>
 #include <baseproc/maths/kernels/gaussian2d.h>
@@ -180,6 +181,65 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_pyramid_float_get_band_levels ( Rox_Sint * band_levels, Rox_Sint * level_rows, Rox_Sint * level_cols, const Rox_Pyramid_Float pyramid, const Rox_Sint max_levels )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !band_levels || !level_rows || !level_cols || !pyramid )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( max_levels < 1 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *band_levels = pyramid->nb_levels;
+   if ( *band_levels > max_levels ) *band_levels = max_levels;
+
+   for ( Rox_Sint l = 0; l < *band_levels; l++ )
+   {
+      error = rox_array2d_float_get_size ( &level_rows[l], &level_cols[l], pyramid->levels[l] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_Void rox_pyramid_float_assign_band ( Rox_Pyramid_Float pyramid, const Rox_Sint * level_rows, const Rox_Sint * level_cols, const Rox_Sint band_levels, const Rox_Sint first, const Rox_Sint band )
+{
+   Rox_Float *** levels = pyramid->fast_access;
+
+   for ( Rox_Sint l = 1; l < band_levels; l++ )
+   {
+      const Rox_Sint level_first = first >> l;
+      Rox_Sint level_last = ( first + band ) >> l;
+      if ( level_last > level_rows[l] ) level_last = level_rows[l];
+      if ( level_last <= level_first ) break;
+
+      rox_ansi_remap_box_nomask_float_to_float_halved ( levels[l] + level_first, levels[l - 1] + 2 * level_first, level_last - level_first, level_cols[l] );
+   }
+}
+
+Rox_ErrorCode rox_pyramid_float_assign_coarse_levels ( Rox_Pyramid_Float pyramid, const Rox_Sint band_levels )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !pyramid )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( band_levels < 1 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // The coarse levels are small, they are halved as a whole
+   for ( Rox_Uint l = band_levels; l < pyramid->nb_levels; l++ )
+   {
+      error = rox_remap_box_nomask_float_to_float_halved ( pyramid->levels[l], pyramid->levels[l - 1] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_pyramid_float_assign_gaussian(Rox_Pyramid_Float pyramid, const Rox_Image_Float source, const Rox_Float sigma)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -96,6 +96,31 @@ ROX_API Rox_ErrorCode rox_pyramid_float_get_image ( Rox_Image_Float * image, con
 //! \todo   To be tested
 ROX_API Rox_ErrorCode rox_pyramid_float_get_nb_levels(Rox_Sint * nb_levels, const Rox_Pyramid_Float pyramid);
 
+//! Get the levels of a pyramid computed inside the bands of rows of its base level, see rox_pyramid_float_assign_band
+//! \param  [out]  band_levels     The number of levels (including the base level) computed inside the bands
+//! \param  [out]  level_rows      The height of each of these levels, max_levels values
+//! \param  [out]  level_cols      The width of each of these levels, max_levels values
+//! \param  [in ]  pyramid         The pyramid object
+//! \param  [in ]  max_levels      The maximum number of levels computed inside the bands, band >> (max_levels - 1) >= 1
+//! \return An error code
+ROX_API Rox_ErrorCode rox_pyramid_float_get_band_levels ( Rox_Sint * band_levels, Rox_Sint * level_rows, Rox_Sint * level_cols, const Rox_Pyramid_Float pyramid, const Rox_Sint max_levels );
+
+//! Box filter the rows of a band at the levels computed inside the bands, once the band is written in the base level.
+//! The rows of the band at level l only depend on the rows of the band at level l - 1, so the bands can be filtered in parallel.
+//! \param  [in ]  pyramid         The pyramid object
+//! \param  [in ]  level_rows      The heights given by rox_pyramid_float_get_band_levels
+//! \param  [in ]  level_cols      The widths given by rox_pyramid_float_get_band_levels
+//! \param  [in ]  band_levels     The number of levels given by rox_pyramid_float_get_band_levels
+//! \param  [in ]  first           The first row of the band in the base level
+//! \param  [in ]  band            The number of rows of the bands, a multiple of 2^(band_levels - 1)
+ROX_API Rox_Void rox_pyramid_float_assign_band ( Rox_Pyramid_Float pyramid, const Rox_Sint * level_rows, const Rox_Sint * level_cols, const Rox_Sint band_levels, const Rox_Sint first, const Rox_Sint band );
+
+//! Box filter the coarse levels after the ones computed inside the bands
+//! \param  [in ]  pyramid         The pyramid object
+//! \param  [in ]  band_levels     The number of levels given by rox_pyramid_float_get_band_levels
+//! \return An error code
+ROX_API Rox_ErrorCode rox_pyramid_float_assign_coarse_levels ( Rox_Pyramid_Float pyramid, const Rox_Sint band_levels );
+
 //! @} 
 
 #endif // __OPENROX_PYRAMID_FLOAT__
@@ -0,0 +1,48 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_remap_bilinear_table.c
+//
+//    Contents  : Implementation of ansi_remap_bilinear_table module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_remap_bilinear_table.h"
+
+int rox_ansi_remap_bilinear_table_uchar_to_uchar_row (
+   unsigned char * out,
+   unsigned char ** inp,
+   const short * x,
+   const short * y,
+   const unsigned char * frac,
+   int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      if ( x[j] < 0 )
+      {
+         out[j] = 0;
+         continue;
+      }
+
+      const unsigned char * r0 = inp[y[j]] + x[j];
+      const unsigned char * r1 = inp[y[j] + 1] + x[j];
+
+      const unsigned int dx = frac[j] & 15;
+      const unsigned int dy = frac[j] >> 4;
+
+      // The weights sum to 256, the sum fits in 16 bits
+      unsigned int sum = ( 16 - dx ) * ( 16 - dy ) * r0[0] + dx * ( 16 - dy ) * r0[1];
+      sum += ( 16 - dx ) * dy * r1[0] + dx * dy * r1[1];
+
+      out[j] = (unsigned char) ( ( sum + 128 ) >> 8 );
+   }
+
+   return 0;
+}
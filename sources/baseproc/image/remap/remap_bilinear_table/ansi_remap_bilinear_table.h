@@ -0,0 +1,24 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_remap_bilinear_table.h
+//
+//    Contents  : API of ansi_remap_bilinear_table module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+// Remap one row, x < 0 marks an invalid pixel (set to 0),
+// frac holds the 4 bits fraction of v in the high nibble and the one of u in the low nibble
+int rox_ansi_remap_bilinear_table_uchar_to_uchar_row (
+   unsigned char * out,
+   unsigned char ** inp,
+   const short * x,
+   const short * y,
+   const unsigned char * frac,
+   int cols
+);
@@ -0,0 +1,373 @@
+//==============================================================================
+//
+//    OPENROX   : File remap_bilinear_table.c
+//
+//    Contents  : Implementation of remap_bilinear_table module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "remap_bilinear_table.h"
+#include "ansi_remap_bilinear_table.h"
+
+#include <math.h>
+
+#include <generated/array2d_float.h>
+#include <system/memory/memory.h>
+#include <baseproc/array/fill/fillval.h>
+#include <baseproc/geometry/pixelgrid/meshgrid2d_struct.h>
+#include <baseproc/image/convert/ansi_ingest.h>
+
+#include <inout/system/errors_print.h>
+
+//=== INTERNAL MACROS    =======================================================
+
+#ifdef ROX_USES_OPENMP
+   #define ROX_REMAP_TABLE_PARALLEL_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+   #define ROX_REMAP_TABLE_PARALLEL_FOR
+#endif
+
+//=== INTERNAL DATATYPES =======================================================
+
+struct Rox_Remap_Table_Struct
+{
+   //! The integer part of the input u coordinates, -1 for invalid pixels
+   Rox_Array2D_Sshort x;
+
+   //! The integer part of the input v coordinates
+   Rox_Array2D_Sshort y;
+
+   //! The 4 bits fractions, v in the high nibble and u in the low nibble
+   Rox_Array2D_Uchar frac;
+
+   //! The width of the input images
+   Rox_Sint cols_inp;
+
+   //! The height of the input images
+   Rox_Sint rows_inp;
+};
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Check the images given to a remap and get their row pointers
+static Rox_ErrorCode rox_remap_table_check_images (
+   Rox_Uchar *** dout,
+   Rox_Uchar *** dinp,
+   Rox_Sint * rows,
+   Rox_Sint * cols,
+   Rox_Image output,
+   const Rox_Image input,
+   const Rox_Remap_Table table
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !output || !input || !table )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( output == input )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_array2d_uchar_get_size ( rows, cols, table->frac );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uchar_check_size ( output, *rows, *cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uchar_check_size ( input, table->rows_inp, table->cols_inp );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( dout, output );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( dinp, input );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+Rox_ErrorCode rox_remap_table_new (
+   Rox_Remap_Table * table,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Remap_Table ret = NULL;
+
+   if ( !table )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *table = NULL;
+
+   if ( rows < 1 || cols < 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_Remap_Table) rox_memory_allocate ( sizeof(*ret), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->x = NULL;
+   ret->y = NULL;
+   ret->frac = NULL;
+   ret->cols_inp = 0;
+   ret->rows_inp = 0;
+
+   error = rox_array2d_sshort_new ( &ret->x, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_sshort_new ( &ret->y, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uchar_new ( &ret->frac, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_sshort_fillval ( ret->x, -1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_sshort_fillval ( ret->y, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uchar_fillval ( ret->frac, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   *table = ret;
+
+function_terminate:
+   if ( error ) rox_remap_table_del ( &ret );
+   return error;
+}
+
+Rox_ErrorCode rox_remap_table_del (
+   Rox_Remap_Table * table
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Remap_Table todel = NULL;
+
+   if ( !table )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *table;
+   *table = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_array2d_sshort_del ( &todel->x );
+   rox_array2d_sshort_del ( &todel->y );
+   rox_array2d_uchar_del ( &todel->frac );
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_remap_table_get_size (
+   Rox_Sint * rows,
+   Rox_Sint * cols,
+   const Rox_Remap_Table table
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !rows || !cols || !table )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_array2d_uchar_get_size ( rows, cols, table->frac );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_remap_table_set_meshgrid2d_float (
+   Rox_Remap_Table table,
+   const Rox_MeshGrid2D_Float grid,
+   const Rox_Sint cols_inp,
+   const Rox_Sint rows_inp
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !table || !grid )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( cols_inp < 1 || rows_inp < 1 || cols_inp > 32767 || rows_inp > 32767 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Sint rows = 0, cols = 0;
+   error = rox_array2d_uchar_get_size ( &rows, &cols, table->frac );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_check_size ( grid->u, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_check_size ( grid->v, rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float ** du = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &du, grid->u );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float ** dv = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &dv, grid->v );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sshort ** dx = NULL;
+   error = rox_array2d_sshort_get_data_pointer_to_pointer ( &dx, table->x );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sshort ** dy = NULL;
+   error = rox_array2d_sshort_get_data_pointer_to_pointer ( &dy, table->y );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Uchar ** df = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( &df, table->frac );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Upper bounds of the fixed point coordinates, the 4 neighbours must be inside the input image
+   const Rox_Sint max_u = 16 * ( cols_inp - 1 );
+   const Rox_Sint max_v = 16 * ( rows_inp - 1 );
+
+   ROX_REMAP_TABLE_PARALLEL_FOR
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         const Rox_Float u = du[i][j];
+         const Rox_Float v = dv[i][j];
+
+         dx[i][j] = -1;
+         dy[i][j] = 0;
+         df[i][j] = 0;
+
+         // Also rejects NaN
+         if ( !( u >= 0.0f && u < (Rox_Float) ( cols_inp - 1 ) && v >= 0.0f && v < (Rox_Float) ( rows_inp - 1 ) ) ) continue;
+
+         const Rox_Sint qu = (Rox_Sint) floorf ( 16.0f * u + 0.5f );
+         const Rox_Sint qv = (Rox_Sint) floorf ( 16.0f * v + 0.5f );
+         if ( qu >= max_u || qv >= max_v ) continue;
+
+         dx[i][j] = (Rox_Sshort) ( qu >> 4 );
+         dy[i][j] = (Rox_Sshort) ( qv >> 4 );
+         df[i][j] = (Rox_Uchar) ( ( ( qv & 15 ) << 4 ) | ( qu & 15 ) );
+      }
+   }
+
+   table->cols_inp = cols_inp;
+   table->rows_inp = rows_inp;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_remap_bilinear_table_uchar_to_uchar (
+   Rox_Image output,
+   const Rox_Image input,
+   const Rox_Remap_Table table
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uchar ** dout = NULL, ** dinp = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   error = rox_remap_table_check_images ( &dout, &dinp, &rows, &cols, output, input, table );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sshort ** dx = NULL;
+   error = rox_array2d_sshort_get_data_pointer_to_pointer ( &dx, table->x );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sshort ** dy = NULL;
+   error = rox_array2d_sshort_get_data_pointer_to_pointer ( &dy, table->y );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Uchar ** df = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( &df, table->frac );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   ROX_REMAP_TABLE_PARALLEL_FOR
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      rox_ansi_remap_bilinear_table_uchar_to_uchar_row ( dout[i], dinp, dx[i], dy[i], df[i], cols );
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_remap_bilinear_table_uchar_to_pyramid_float (
+   Rox_Pyramid_Float pyramid,
+   Rox_Image output,
+   const Rox_Image input,
+   const Rox_Remap_Table table
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint level_rows[ROX_REMAP_TABLE_BAND_LEVELS];
+   Rox_Sint level_cols[ROX_REMAP_TABLE_BAND_LEVELS];
+   Rox_Uchar ** dout = NULL, ** dinp = NULL;
+   Rox_Sint rows = 0, cols = 0;
+
+   if ( !pyramid )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_remap_table_check_images ( &dout, &dinp, &rows, &cols, output, input, table );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_check_size ( pyramid->levels[0], rows, cols );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sshort ** dx = NULL;
+   error = rox_array2d_sshort_get_data_pointer_to_pointer ( &dx, table->x );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sshort ** dy = NULL;
+   error = rox_array2d_sshort_get_data_pointer_to_pointer ( &dy, table->y );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Uchar ** df = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( &df, table->frac );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Levels computed inside the bands
+   Rox_Sint band_levels = 0;
+   error = rox_pyramid_float_get_band_levels ( &band_levels, level_rows, level_cols, pyramid, ROX_REMAP_TABLE_BAND_LEVELS );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Float *** levels = pyramid->fast_access;
+   const Rox_Sint count_bands = ( rows + ROX_REMAP_TABLE_BAND - 1 ) / ROX_REMAP_TABLE_BAND;
+
+   ROX_REMAP_TABLE_PARALLEL_FOR
+   for ( Rox_Sint band = 0; band < count_bands; band++ )
+   {
+      const Rox_Sint first = band * ROX_REMAP_TABLE_BAND;
+      Rox_Sint last = first + ROX_REMAP_TABLE_BAND;
+      if ( last > rows ) last = rows;
+
+      for ( Rox_Sint i = first; i < last; i++ )
+      {
+         rox_ansi_remap_bilinear_table_uchar_to_uchar_row ( dout[i], dinp, dx[i], dy[i], df[i], cols );
+         rox_ansi_ingest_row_normalize ( levels[0][i], dout[i], cols );
+      }
+
+      rox_pyramid_float_assign_band ( pyramid, level_rows, level_cols, band_levels, first, ROX_REMAP_TABLE_BAND );
+   }
+
+   // The coarse levels are small, halve them after the bands
+   error = rox_pyramid_float_assign_coarse_levels ( pyramid, band_levels );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
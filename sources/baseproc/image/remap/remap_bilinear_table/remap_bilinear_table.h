@@ -0,0 +1,112 @@
+//==============================================================================
+//
+//    OPENROX   : File remap_bilinear_table.h
+//
+//    Contents  : API of remap_bilinear_table module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_REMAP_BILINEAR_TABLE__
+#define __OPENROX_REMAP_BILINEAR_TABLE__
+
+#include <generated/array2d_uchar.h>
+#include <generated/array2d_sshort.h>
+#include <baseproc/image/image.h>
+#include <baseproc/image/pyramid/pyramid_float.h>
+#include <baseproc/geometry/pixelgrid/meshgrid2d.h>
+
+//! \ingroup Image
+//! \addtogroup Remap
+//! @{
+
+//! The number of rows of the bands remapped in parallel by rox_remap_bilinear_table_uchar_to_pyramid_float
+#define ROX_REMAP_TABLE_BAND 64
+
+//! The number of pyramid levels (including the base level) computed inside the bands, ROX_REMAP_TABLE_BAND >> (levels - 1) >= 1
+#define ROX_REMAP_TABLE_BAND_LEVELS 7
+
+//! A precomputed bilinear remap table in fixed point 12.4 (as rox_warp_grid_sl3_fixed12_4).
+//! Each output pixel stores the integer input coordinates (2 x 16 bits) and the 4 bits fractions
+//! of u and v packed in one byte, i.e. 5 bytes per pixel instead of 8 for a float meshgrid.
+typedef struct Rox_Remap_Table_Struct * Rox_Remap_Table;
+
+//! Create a new remap table, all the pixels are invalid until the table is set
+//! \param  [out]  table          The new table
+//! \param  [in ]  rows           The height of the remapped images
+//! \param  [in ]  cols           The width of the remapped images
+//! \return An error code
+ROX_API Rox_ErrorCode rox_remap_table_new (
+   Rox_Remap_Table * table,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+);
+
+//! Delete a remap table
+//! \param  [out]  table          The table to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_remap_table_del (
+   Rox_Remap_Table * table
+);
+
+//! Get the size of the remapped images
+//! \param  [out]  rows           The height
+//! \param  [out]  cols           The width
+//! \param  [in ]  table          The table
+//! \return An error code
+ROX_API Rox_ErrorCode rox_remap_table_get_size (
+   Rox_Sint * rows,
+   Rox_Sint * cols,
+   const Rox_Remap_Table table
+);
+
+//! Quantize a float map to 1/16 pixel. A pixel is valid when its rounded coordinates lie in
+//! [0, cols_inp - 1[ x [0, rows_inp - 1[ (the rule of rox_remap_bilinear_nomask_uchar_to_uchar_fixed),
+//! the other pixels are set to 0 by the remap.
+//! \param  [out]  table          The table (with the size of the grid)
+//! \param  [in ]  grid           The input coordinates of each output pixel
+//! \param  [in ]  cols_inp       The width of the input images (at most 32767)
+//! \param  [in ]  rows_inp       The height of the input images (at most 32767)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_remap_table_set_meshgrid2d_float (
+   Rox_Remap_Table table,
+   const Rox_MeshGrid2D_Float grid,
+   const Rox_Sint cols_inp,
+   const Rox_Sint rows_inp
+);
+
+//! Remap an image with bilinear interpolation on 8 bits weights
+//! \param  [out]  output         The remapped image (with the size of the table)
+//! \param  [in ]  input          The input image (with the size given to the table, different from output)
+//! \param  [in ]  table          The remap table
+//! \return An error code
+ROX_API Rox_ErrorCode rox_remap_bilinear_table_uchar_to_uchar (
+   Rox_Image output,
+   const Rox_Image input,
+   const Rox_Remap_Table table
+);
+
+//! Remap an image and build the level 0 (normalized in [0, 1]) and the box filtered levels of a pyramid in a single pass.
+//! The rows are processed by bands in parallel, each band is normalized and halved while it is still in cache.
+//! The results are identical to rox_remap_bilinear_table_uchar_to_uchar, rox_array2d_float_from_uchar_normalize
+//! and rox_pyramid_float_assign called one after the other.
+//! \param  [out]  pyramid        The pyramid (with the size of the table as base level)
+//! \param  [out]  output         The remapped image (with the size of the table)
+//! \param  [in ]  input          The input image (with the size given to the table, different from output)
+//! \param  [in ]  table          The remap table
+//! \return An error code
+ROX_API Rox_ErrorCode rox_remap_bilinear_table_uchar_to_pyramid_float (
+   Rox_Pyramid_Float pyramid,
+   Rox_Image output,
+   const Rox_Image input,
+   const Rox_Remap_Table table
+);
+
+//! @}
+
+#endif // __OPENROX_REMAP_BILINEAR_TABLE__
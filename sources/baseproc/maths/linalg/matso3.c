@@ -26,7 +26,7 @@
 #include <baseproc/geometry/transforms/transform_tools.h>
 #include <baseproc/array/transpose/transpose.h>
 #include <baseproc/maths/linalg/matrix.h>
-#include <baseproc/array/solve/svd_solve.h>
+#include <baseproc/array/decomposition/eigen_symm.h>
 
 #include <inout/numeric/array2d_save.h>
 #include <inout/numeric/array2d_print.h>
@@ -864,30 +864,21 @@ Rox_ErrorCode rox_array2d_double_logmat_so3 (
          // (S+I)/2 * u = u
          // ((S+I)/2 - I) * u = 0
          // (S-I) * u = 0
-         Rox_Matrix x = NULL;
-         Rox_Matrix A = NULL;
-
-         error = rox_matrix_new(&x, 3, 1);
-         error = rox_matrix_new(&A, 3, 3);
-         
-         Rox_Double ** dA = NULL;
-         error = rox_array2d_double_get_data_pointer_to_pointer( &dA, A);
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         // The eigenvalues of S-I are 0, -2, -2 : the axis is the eigenvector of the largest one
+         Rox_Double A[9], D[3], E[9];
 
-         dA[0][0] = 0.5*(dR[0][0]+dR[0][0])-1.0; dA[0][1] =     0.5*(dR[0][1]+dR[1][0]); dA[0][2] =     0.5*(dR[0][2]+dR[2][0]);
-         dA[1][0] =     0.5*(dR[0][1]+dR[1][0]); dA[1][1] = 0.5*(dR[1][1]+dR[1][1])-1.0; dA[1][2] =     0.5*(dR[1][2]+dR[2][1]); 
-         dA[2][0] =     0.5*(dR[0][2]+dR[2][0]); dA[2][1] =     0.5*(dR[1][2]+dR[2][1]); dA[2][2] = 0.5*(dR[2][2]+dR[2][2])-1.0; 
+         A[0] = 0.5*(dR[0][0]+dR[0][0])-1.0; A[1] =     0.5*(dR[0][1]+dR[1][0]); A[2] =     0.5*(dR[0][2]+dR[2][0]);
+         A[3] =     0.5*(dR[0][1]+dR[1][0]); A[4] = 0.5*(dR[1][1]+dR[1][1])-1.0; A[5] =     0.5*(dR[1][2]+dR[2][1]); 
+         A[6] =     0.5*(dR[0][2]+dR[2][0]); A[7] =     0.5*(dR[1][2]+dR[2][1]); A[8] = 0.5*(dR[2][2]+dR[2][2])-1.0; 
 
-         error = rox_svd_solve_homogeneous_system ( x,  A );
+         error = rox_array_double_eigen_symm3x3 ( D, E, A );
          ROX_ERROR_CHECK_TERMINATE ( error );
 
-         rox_matrix_get_value(axis_x, x, 0, 0);
-         rox_matrix_get_value(axis_y, x, 1, 0);
-         rox_matrix_get_value(axis_z, x, 2, 0);
+         *axis_x = E[0];
+         *axis_y = E[3];
+         *axis_z = E[6];
 
          *angle = ROX_PI;
-         rox_matrix_del(&x);
-         rox_matrix_del(&A);
 
       }
    }
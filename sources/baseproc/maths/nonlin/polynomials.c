@@ -28,6 +28,9 @@
 
 #include <inout/system/errors_print.h>
 
+//! The sturm sequences of the polynomials up to this degree are stored on the stack
+#define ROX_STURM_STACK_DEGREE 16
+
 Rox_ErrorCode rox_polynom_new(Rox_Polynom *obj, Rox_Uint degree)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -702,6 +705,9 @@ Rox_ErrorCode rox_polynomial_roots_sturm(Rox_Double * roots, Rox_Uint * nbroots,
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Polynom * sturmseq = NULL;
+   Rox_Polynom stack_sequence[ROX_STURM_STACK_DEGREE + 1];
+   struct Rox_Polynom_Struct stack_polynoms[ROX_STURM_STACK_DEGREE + 1];
+   Rox_Double stack_coefficients[(ROX_STURM_STACK_DEGREE + 1) * (ROX_STURM_STACK_DEGREE + 1)];
    Rox_Uint idseq, idroot;
    Rox_Sint idcoef, i;
    Rox_Uint countroot;
@@ -715,17 +721,30 @@ Rox_ErrorCode rox_polynomial_roots_sturm(Rox_Double * roots, Rox_Uint * nbroots,
 
    countroot = 0;
 
-   //Allocate sturm sequence
+   //Allocate sturm sequence, on the stack for the small degrees (the minimal solvers call this for each hypothesis)
    error = ROX_ERROR_NONE;
-   sturmseq = (Rox_Polynom *) rox_memory_allocate(sizeof(Rox_Polynom), degree + 1);
-   if (!sturmseq)
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   for (idseq = 0; idseq < degree + 1; idseq++)
+   if (degree <= ROX_STURM_STACK_DEGREE)
    {
-      error |= rox_polynom_new(&sturmseq[idseq], degree);
+      sturmseq = stack_sequence;
+      for (idseq = 0; idseq < degree + 1; idseq++)
+      {
+         stack_polynoms[idseq].order = 0;
+         stack_polynoms[idseq].coefficients = &stack_coefficients[idseq * (degree + 1)];
+         sturmseq[idseq] = &stack_polynoms[idseq];
+      }
+   }
+   else
+   {
+      sturmseq = (Rox_Polynom *) rox_memory_allocate(sizeof(Rox_Polynom), degree + 1);
+      if (!sturmseq)
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      for (idseq = 0; idseq < degree + 1; idseq++)
+      {
+         error |= rox_polynom_new(&sturmseq[idseq], degree);
+      }
+      ROX_ERROR_CHECK_TERMINATE ( error );
    }
-   ROX_ERROR_CHECK_TERMINATE ( error );
 
    //Check that the polynom is defined to the biggest order
    if (fabs(coeff[degree]) < DBL_EPSILON)
@@ -811,11 +830,14 @@ Rox_ErrorCode rox_polynomial_roots_sturm(Rox_Double * roots, Rox_Uint * nbroots,
 
 function_terminate:
    // Delete sturm sequence
-   for (idseq = 0; idseq < degree + 1; idseq++)
+   if (sturmseq && sturmseq != stack_sequence)
    {
-      rox_polynom_del(&sturmseq[idseq]);
+      for (idseq = 0; idseq < degree + 1; idseq++)
+      {
+         rox_polynom_del(&sturmseq[idseq]);
+      }
+      rox_memory_delete(sturmseq);
    }
-   rox_memory_delete(sturmseq);
 
    return error;
 }
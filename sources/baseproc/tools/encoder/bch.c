@@ -28,17 +28,26 @@ const int alpha_to_8_8[] = {1, 2, 4, 8, 16, 32, 64, 3, 6, 12, 24, 48, 96, 67, 5,
 const int alpha_to_6_2[] = {1, 2, 4, 8, 16, 5, 10, 20, 13, 26, 17, 7, 14, 28, 29, 31, 27, 19, 
                             3, 6, 12, 24, 21, 15, 30, 25, 23, 11, 22, 9, 18, 0};
 
-const int index_of_8_8[] = {-1, 2, 4, 8, 16, 32, 64, 3, 6, 12, 24, 48, 96, 67, 5, 10, 20, 40, 80, 35, 70,
-                        15, 30, 60, 120, 115, 101, 73, 17, 34, 68, 11, 22, 44, 88, 51, 102, 79, 29, 
-                        58, 116, 107, 85, 41, 82, 39, 78, 31, 62, 124, 123, 117, 105, 81, 33, 66, 7, 
-                        14, 28, 56, 112, 99, 69, 9, 18, 36, 72, 19, 38, 76, 27, 54, 108, 91, 53, 106, 
-                        87, 45, 90, 55, 110, 95, 61, 122, 119, 109, 89, 49, 98, 71, 13, 26, 52, 104, 83, 
-                        37, 74, 23, 46, 92, 59, 118, 111, 93, 57, 114, 103, 77, 25, 50, 100, 75, 21, 42, 
-                        84, 43, 86, 47, 94, 63, 126, 127, 125, 121, 113, 97, 65, 0};
-
 const int index_of_6_2[] = {-1, 0, 1, 18, 2, 5, 19, 11, 3, 29, 6, 27, 20, 8, 12, 23, 4, 10, 30, 17, 
                             7, 22, 28, 26, 21, 25, 9, 16, 13, 14, 24, 15};
 
+// The logarithms of GF(128), computed from alpha_to_8_8 by rox_bch_tables_init
+static int index_of_8_8[128];
+
+// The odd syndromes of the 64 bits codewords, byte by byte: the syndrome S_(2i+1) of a word is the xor of
+// rox_bch_syndromes_8_8[i][b][byte b of the word] over its 8 bytes (the even syndromes are their squares)
+static Rox_Uchar rox_bch_syndromes_8_8[8][8][256];
+
+// The 16 bits codewords of the 64 values
+static Rox_Ushort rox_bch_codewords_6_2[64];
+
+// The correction of the 6 data bits for each 10 bits remainder of a received word
+// divided by the generator (0xFF when more than 2 errors are detected)
+static Rox_Uchar rox_bch_corrections_6_2[1024];
+
+// Set once the tables are built, read and written with acquire and release ordering
+static Rox_Sint rox_bch_tables_ready = 0;
+
 const int g_8_8[] = {1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 
                   0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1, 1,
                   1, 1, 1, 0, 1, 1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0};
@@ -191,437 +200,246 @@ Rox_ErrorCode rox_bch_c6_e2_encode(Rox_Ushort * output, Rox_Uchar input)
    return error;
 }
 
-Rox_ErrorCode rox_bch_c8_e8_decode(Rox_Uchar *output, Rox_Ulint input)
+
+//! The maximal number of syndromes of the codes
+#define ROX_BCH_MAX_SYNDROMES 16
+
+// Find the error positions of a received word of a shortened binary BCH code from its syndromes
+// (Berlekamp-Massey algorithm then Chien search on the positions lower than length)
+static Rox_ErrorCode rox_bch_locate_errors (
+   Rox_Ulint * errors,
+   const int * syndromes,
+   const Rox_Sint t,
+   const Rox_Sint length,
+   const Rox_Sint n,
+   const int * alpha_to,
+   const int * index_of
+)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   int i, j, u, q, t2, count = 0, syn_error = 0;
-   int elp[130][128], d[130], l[130], u_lu[130], s[129];
-   int loc[200], reg[201];
-   int recd[64];
-   long bit;
-   Rox_Uchar res;
+   // The polynomials are stored in polynomial form, the syndromes are syndromes[1..2t]
+   int elp[2 * ROX_BCH_MAX_SYNDROMES + 1] = { 1 }, prev[2 * ROX_BCH_MAX_SYNDROMES + 1] = { 1 }, temp[2 * ROX_BCH_MAX_SYNDROMES + 1];
+   const Rox_Sint t2 = 2 * t;
+   Rox_Sint degree = 0, shift = 1, count = 0;
+   int prev_discrepancy = 1;
 
-   const int n = 127;
-   const int t = 8;
-   const int length = 64;
-   t2 = 2 * t;
+   *errors = 0;
 
-   // From integer to bitstring
-   for (bit = 0; bit < 64; bit++)
+   for ( Rox_Sint k = 0; k < t2; k++ )
    {
-      long pot = (1l << bit);
-      if (input & pot)
+      int discrepancy = syndromes[k + 1];
+      for ( Rox_Sint i = 1; i <= degree; i++ )
       {
-         recd[bit] = 1;
+         if ( elp[i] && syndromes[k + 1 - i] )
+         {
+            discrepancy ^= alpha_to[( index_of[elp[i]] + index_of[syndromes[k + 1 - i]] ) % n];
+         }
       }
-      else
+
+      if ( discrepancy == 0 ) { shift++; continue; }
+
+      // elp = elp - discrepancy / prev_discrepancy * x^shift * prev
+      const int scale = ( index_of[discrepancy] - index_of[prev_discrepancy] + n ) % n;
+      const Rox_Bool lengthen = ( 2 * degree <= k );
+
+      if ( lengthen )
       {
-         recd[bit] = 0;
+         for ( Rox_Sint i = 0; i <= t2; i++ ) temp[i] = elp[i];
       }
-   }
-   
-   for (i = 1; i <= t2; i++) 
-   {
-      s[i] = 0;
-      for (j = 0; j < length; j++)
+
+      for ( Rox_Sint i = 0; i + shift <= t2; i++ )
       {
-         if (recd[j] != 0)
-         {
-            s[i] ^= alpha_to_8_8[(i * j) % n];
-         }
+         if ( prev[i] ) elp[i + shift] ^= alpha_to[( scale + index_of[prev[i]] ) % n];
       }
-      if (s[i] != 0)
+
+      if ( lengthen )
       {
-         syn_error = 1;
+         degree = k + 1 - degree;
+         for ( Rox_Sint i = 0; i <= t2; i++ ) prev[i] = temp[i];
+         prev_discrepancy = discrepancy;
+         shift = 1;
+      }
+      else
+      {
+         shift++;
       }
-
-      s[i] = index_of_8_8[s[i]];
    }
 
-   if (syn_error) 
+   if ( degree > t )
+   { error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // Chien search: position j is in error if elp(alpha^-j) = 0
+   for ( Rox_Sint j = 0; j < length; j++ )
    {
-      d[0] = 0;   
-      d[1] = s[1];
-      elp[0][0] = 0;
-      elp[1][0] = 1;
-      for (i = 1; i < t2; i++) 
+      int sum = elp[0];
+      for ( Rox_Sint i = 1; i <= degree; i++ )
       {
-         elp[0][i] = -1; 
-         elp[1][i] = 0;
+         if ( elp[i] ) sum ^= alpha_to[( index_of[elp[i]] + i * ( n - j ) ) % n];
       }
 
-      l[0] = 0;
-      l[1] = 0;
-      u_lu[0] = -1;
-      u_lu[1] = 0;
-      u = 0;
- 
-      do 
+      if ( !sum )
       {
-         u++;
-         if (d[u] == -1) 
-         {
-            l[u + 1] = l[u];
-            for (i = 0; i <= l[u]; i++) 
-            {
-               elp[u + 1][i] = elp[u][i];
-               elp[u][i] = index_of_8_8[elp[u][i]];
-            }
-         } 
-         else
-         {
-            q = u - 1;
-            while ((d[q] == -1) && (q > 0))
-            {
-               q--;
-            }
+         *errors |= 1ULL << j;
+         count++;
+      }
+   }
 
-            
-            if (q > 0) 
-            {
-              j = q;
-              do 
-              {
-                j--;
-                if ((d[j] != -1) && (u_lu[q] < u_lu[j]))
-                {
-                  q = j;
-                }
-              } 
-              while (j > 0);
-            }
- 
-            if (l[u] > l[q] + u - q)
-            {
-               l[u + 1] = l[u];
-            }
-            else
-            {
-               l[u + 1] = l[q] + u - q;
-            }
- 
-            // form new elp(x) 
-            for (i = 0; i < t2; i++)
-            {
-               elp[u + 1][i] = 0;
-            }
+   // Some roots are not in the shortened word: more than t errors
+   if ( count != degree )
+   { error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+function_terminate:
+   return error;
+}
+
+// Build the tables of the decoders once
+static void rox_bch_tables_init ( )
+{
+   Rox_Sint ready = 0;
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp atomic read
+   ready = rox_bch_tables_ready;
 
-            for (i = 0; i <= l[q]; i++)
+   // Acquire: the tables are not read before the flag
+   #pragma omp flush
+#else
+   ready = rox_bch_tables_ready;
+#endif
+
+   if ( ready ) return;
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp critical (rox_bch_tables)
+#endif
+   {
+      if ( !rox_bch_tables_ready )
+      {
+         const Rox_Sint n8 = 127, n6 = 31;
+
+         index_of_8_8[0] = -1;
+         for ( Rox_Sint i = 0; i < n8; i++ ) index_of_8_8[alpha_to_8_8[i]] = i;
+
+         for ( Rox_Sint i = 0; i < 8; i++ )
+         {
+            const Rox_Sint power = 2 * i + 1;
+            for ( Rox_Sint byte = 0; byte < 8; byte++ )
             {
-               if (elp[q][i] != -1)
+               for ( Rox_Sint value = 0; value < 256; value++ )
                {
-                  elp[u + 1][i + u - q] = alpha_to_8_8[(d[u] + n - d[q] + elp[q][i]) % n];
+                  int syndrome = 0;
+                  for ( Rox_Sint bit = 0; bit < 8; bit++ )
+                  {
+                     if ( value & ( 1 << bit ) ) syndrome ^= alpha_to_8_8[( power * ( 8 * byte + bit ) ) % n8];
+                  }
+                  rox_bch_syndromes_8_8[i][byte][value] = ( Rox_Uchar ) syndrome;
                }
             }
-            for (i = 0; i <= l[u]; i++) 
-            {
-               elp[u + 1][i] ^= elp[u][i];
-               elp[u][i] = index_of_8_8[elp[u][i]];
-            }
-         }
-         u_lu[u + 1] = u - l[u + 1];
- 
-         // form (u+1)th discrepancy 
-         if (u < t2) 
-         {  
-           if (s[u + 1] != -1)
-           {
-             d[u + 1] = alpha_to_8_8[s[u + 1]];
-          }
-           else
-           {
-             d[u + 1] = 0;
-          }
-             for (i = 1; i <= l[u + 1]; i++)
-             {
-               if ((s[u + 1 - i] != -1) && (elp[u + 1][i] != 0))
-               {
-                 d[u + 1] ^= alpha_to_8_8[(s[u + 1 - i] + index_of_8_8[elp[u + 1][i]]) % n];
-              }
-           }
-           // put d[u+1] into index form 
-           d[u + 1] = index_of_8_8[d[u + 1]]; 
-         }
-      } 
-      while ((u < t2) && (l[u + 1] <= t));
- 
-      u++;
-      if (l[u] <= t) 
-      {
-         for (i = 0; i <= l[u]; i++) 
-         {
-            elp[u][i] = index_of_8_8[elp[u][i]];
          }
 
-         // Chien search: find roots of the error location polynomial 
-         for (i = 1; i <= l[u]; i++)
+         for ( Rox_Sint value = 0; value < 64; value++ )
          {
-            reg[i] = elp[u][i];
+            rox_bch_c6_e2_encode ( &rox_bch_codewords_6_2[value], ( Rox_Uchar ) value );
          }
 
-         count = 0;
-         for (i = 1; i <= n; i++) 
+         for ( Rox_Sint remainder = 0; remainder < 1024; remainder++ )
          {
-            q = 1;
-            for (j = 1; j <= l[u]; j++)
+            int syndromes[5] = { 0 };
+            Rox_Ulint errors = 0;
+
+            for ( Rox_Sint i = 1; i <= 4; i++ )
             {
-               if (reg[j] != -1) 
+               for ( Rox_Sint bit = 0; bit < 10; bit++ )
                {
-                  reg[j] = (reg[j] + j) % n;
-                  q ^= alpha_to_8_8[reg[j]];
+                  if ( remainder & ( 1 << bit ) ) syndromes[i] ^= alpha_to_6_2[( i * bit ) % n6];
                }
             }
 
-            if (!q) 
+            if ( rox_bch_locate_errors ( &errors, syndromes, 2, 16, n6, alpha_to_6_2, index_of_6_2 ) )
             {
-               loc[count] = n - i;
-               count++;
+               rox_bch_corrections_6_2[remainder] = 0xFF;
             }
-         }
-
-         if (count == l[u])   
-         {
-            for (i = 0; i < l[u]; i++)
+            else
             {
-               recd[loc[i]] ^= 1;
+               rox_bch_corrections_6_2[remainder] = ( Rox_Uchar ) ( ( errors >> 10 ) & 0x3F );
             }
          }
-         else
-         {
-            error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-      }
-   }
 
-   res = 0;
-   for (bit = 0; bit < 8; bit++)
-   {
-      if (recd[56 + bit]) 
-      {
-         res = res | (1 << bit);
+#ifdef ROX_USES_OPENMP
+         // Release: the tables are written before the flag
+         #pragma omp flush
+
+         #pragma omp atomic write
+         rox_bch_tables_ready = 1;
+#else
+         rox_bch_tables_ready = 1;
+#endif
       }
    }
-
-   *output = res;
-
-function_terminate:
-   return error;
 }
 
-Rox_ErrorCode rox_bch_c6_e2_decode(Rox_Uchar *output, Rox_Ushort input)
+Rox_ErrorCode rox_bch_c8_e8_decode(Rox_Uchar * output, Rox_Ulint input)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   int i, j, u, q, t2, count = 0, syn_error = 0;
-   int elp[18][16], d[18]= { 0 }, l[18]= { 0 }, u_lu[18]= { 0 }, s[17]= { 0 };
-   int loc[200]= { 0 }, reg[201] = { 0 };
-   int recd[64]= { 0 };
-   Rox_Ushort bit;
-   Rox_Uchar res;
+   int syndromes[ROX_BCH_MAX_SYNDROMES + 1] = { 0 };
+   Rox_Sint syn_error = 0;
+   Rox_Ulint errors = 0;
 
-   const int n = 31;
-   const int t = 2;
-   const int length = 16;
-   t2 = 2 * t;
+   const Rox_Sint n = 127;
 
-   //From integer to bitstring
-   for (bit = 0; bit < 16; bit++)
-   {
-      Rox_Ushort pot = (1 << bit);
-      if (input & pot)
-      {
-         recd[bit] = 1;
-      }
-      else
-      {
-         recd[bit] = 0;
-      }
-   }
-   
-   for (i = 1; i <= t2; i++) 
+   if (!output) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_bch_tables_init ( );
+
+   for ( Rox_Sint i = 0; i < 8; i++ )
    {
-      s[i] = 0;
-      for (j = 0; j < length; j++)
+      int syndrome = 0;
+      for ( Rox_Sint byte = 0; byte < 8; byte++ )
       {
-         if (recd[j] != 0)
-         {
-            s[i] ^= alpha_to_6_2[(i * j) % n];
-         }
+         syndrome ^= rox_bch_syndromes_8_8[i][byte][( input >> ( 8 * byte ) ) & 0xFF];
       }
-      if (s[i] != 0)
-      {
-         syn_error = 1;
-      }
-
-      s[i] = index_of_6_2[s[i]];
+      syndromes[2 * i + 1] = syndrome;
+      syn_error |= syndrome;
    }
 
-   if (syn_error) 
+   if (syn_error)
    {
-      d[0] = 0;   
-      d[1] = s[1];
-      elp[0][0] = 0;
-      elp[1][0] = 1;
-      for (i = 1; i < t2; i++) 
+      // For a binary code S_2i = S_i^2
+      for ( Rox_Sint i = 2; i <= ROX_BCH_MAX_SYNDROMES; i += 2 )
       {
-         elp[0][i] = -1; 
-         elp[1][i] = 0;
+         const int half = syndromes[i / 2];
+         syndromes[i] = half ? alpha_to_8_8[( 2 * index_of_8_8[half] ) % n] : 0;
       }
 
-      l[0] = 0;
-      l[1] = 0;
-      u_lu[0] = -1;
-      u_lu[1] = 0;
-      u = 0;
- 
-      do 
-      {
-         u++;
-         if (d[u] == -1) 
-         {
-            l[u + 1] = l[u];
-            for (i = 0; i <= l[u]; i++) 
-            {
-               elp[u + 1][i] = elp[u][i];
-               elp[u][i] = index_of_6_2[elp[u][i]];
-            }
-         } 
-         else
-         {
-            q = u - 1;
-            while ((d[q] == -1) && (q > 0))
-            {
-               q--;
-            }
+      error = rox_bch_locate_errors ( &errors, syndromes, 8, 64, n, alpha_to_8_8, index_of_8_8 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
-            
-            if (q > 0) 
-            {
-              j = q;
-              do 
-              {
-                j--;
-                if ((d[j] != -1) && (u_lu[q] < u_lu[j]))
-                {
-                  q = j;
-                }
-              } 
-              while (j > 0);
-            }
- 
-            if (l[u] > l[q] + u - q)
-            {
-               l[u + 1] = l[u];
-            }
-            else
-            {
-               l[u + 1] = l[q] + u - q;
-            }
- 
-            // form new elp(x) 
-            for (i = 0; i < t2; i++)
-            {
-               elp[u + 1][i] = 0;
-            }
+   *output = ( Rox_Uchar ) ( ( input ^ errors ) >> 56 );
 
-            for (i = 0; i <= l[q]; i++)
-            {
-               if (elp[q][i] != -1)
-               {
-                  elp[u + 1][i + u - q] = alpha_to_6_2[(d[u] + n - d[q] + elp[q][i]) % n];
-               }
-            }
-            for (i = 0; i <= l[u]; i++) 
-            {
-               elp[u + 1][i] ^= elp[u][i];
-               elp[u][i] = index_of_6_2[elp[u][i]];
-            }
-         }
-         u_lu[u + 1] = u - l[u + 1];
- 
-         // form (u+1)th discrepancy 
-         if (u < t2) 
-         {  
-           if (s[u + 1] != -1)
-           {
-             d[u + 1] = alpha_to_6_2[s[u + 1]];
-          }
-           else
-           {
-             d[u + 1] = 0;
-          }
-             for (i = 1; i <= l[u + 1]; i++)
-             {
-               if ((s[u + 1 - i] != -1) && (elp[u + 1][i] != 0))
-               {
-                 d[u + 1] ^= alpha_to_6_2[(s[u + 1 - i] + index_of_6_2[elp[u + 1][i]]) % n];
-              }
-           }
-           // put d[u+1] into index form 
-           d[u + 1] = index_of_6_2[d[u + 1]]; 
-         }
-      } 
-      while ((u < t2) && (l[u + 1] <= t));
- 
-      u++;
-      if (l[u] <= t) 
-      {
-         for (i = 0; i <= l[u]; i++) 
-         {
-            elp[u][i] = index_of_6_2[elp[u][i]];
-         }
+function_terminate:
+   return error;
+}
 
-         // Chien search: find roots of the error location polynomial 
-         for (i = 1; i <= l[u]; i++)
-         {
-            reg[i] = elp[u][i];
-         }
+Rox_ErrorCode rox_bch_c6_e2_decode(Rox_Uchar * output, Rox_Ushort input)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-         count = 0;
-         for (i = 1; i <= n; i++) 
-         {
-            q = 1;
-            for (j = 1; j <= l[u]; j++)
-            {
-               if (reg[j] != -1) 
-               {
-                  reg[j] = (reg[j] + j) % n;
-                  q ^= alpha_to_6_2[reg[j]];
-               }
-            }
+   if (!output) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-            if (!q) 
-            {
-               loc[count] = n - i;
-               count++;
-            }
-         }
+   rox_bch_tables_init ( );
 
-         if (count == l[u])   
-         {
-            for (i = 0; i < l[u]; i++)
-            {
-               recd[loc[i]] ^= 1;
-            }
-         }
-         else
-         {
-            
-            error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-      }
-   }
+   // The received word and the codeword of its data bits only differ by the remainder
+   const Rox_Uchar data = ( Rox_Uchar ) ( input >> 10 );
+   const Rox_Uchar correction = rox_bch_corrections_6_2[( input ^ rox_bch_codewords_6_2[data] ) & 0x3FF];
 
-   res = 0;
-   for (bit = 0; bit < 6; bit++)
-   {
-      if (recd[10 + bit]) 
-      {
-         res = res | (1 << bit);
-      }
-   }
+   if ( correction == 0xFF )
+   { error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   *output = res;
+   *output = data ^ correction;
 
 function_terminate:
    return error;
-}
\ No newline at end of file
+}
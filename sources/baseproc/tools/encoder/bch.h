@@ -37,17 +37,17 @@ ROX_API Rox_ErrorCode rox_bch_c8_e8_encode(Rox_Ulint * output, Rox_Uchar input);
 ROX_API Rox_ErrorCode rox_bch_c6_e2_encode(Rox_Ushort * output, Rox_Uchar input);
 
 //! Decode 8 bits with 8 errors tolerancy on a 64 bit codeword
+//! The syndromes are read in precomputed tables, byte by byte.
 //! \param  [out]  output         A pointer to the value decoded
 //! \param  [in ]  input          The value to decode
-//! \return An error code
-//! \todo   To be tested
+//! \return An error code, ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE if more than 8 errors are detected
 ROX_API Rox_ErrorCode rox_bch_c8_e8_decode(Rox_Uchar *output, Rox_Ulint input);
 
 //! Decode 6 bits with 2 errors tolerancy on a 16 bit codeword
+//! The correction is read in a precomputed table of the 1024 possible remainders.
 //! \param  [out]  output         A pointer to the value decoded
 //! \param  [in ]  input          The value to decode
-//! \return An error code
-//! \todo   To be tested
+//! \return An error code, ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE if more than 2 errors are detected
 ROX_API Rox_ErrorCode rox_bch_c6_e2_decode(Rox_Uchar *output, Rox_Ushort input);
 
 //! @} 
@@ -33,6 +33,7 @@
 #include <baseproc/array/robust/tukey.h>
 #include <baseproc/maths/maths_macros.h>
 #include <baseproc/maths/linalg/matse3.h>
+#include <system/memory/arena.h>
 
 #include <inout/system/errors_print.h>
 
@@ -277,7 +278,7 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_bundle_compute_weights(Rox_Bundle obj)
+static Rox_ErrorCode rox_bundle_compute_weights_scoped(Rox_Bundle obj)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Double dx, dy;
@@ -371,6 +372,21 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_bundle_compute_weights(Rox_Bundle obj)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   // The residual and weight buffers are temporaries of the scratch arena
+   error = rox_arena_scope_begin("bundle_compute_weights");
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bundle_compute_weights_scoped(obj);
+   rox_arena_scope_end();
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_bundle_compute_hessians(Rox_Bundle obj)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -557,7 +573,7 @@ function_terminate:
 }
 
 
-Rox_ErrorCode rox_bundle_solve_system(Rox_Bundle obj)
+static Rox_ErrorCode rox_bundle_solve_system_scoped(Rox_Bundle obj)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Uint idframe, idpoint, idmes, idmes2, i, j, k, poscam, poscam2;
@@ -892,6 +908,21 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_bundle_solve_system(Rox_Bundle obj)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   // The reduced camera system buffers are temporaries of the scratch arena
+   error = rox_arena_scope_begin("bundle_solve_system");
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_bundle_solve_system_scoped(obj);
+   rox_arena_scope_end();
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_bundle_check_thresholds(Rox_Bundle obj)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -29,6 +29,7 @@
 #include <baseproc/array/median/median.h>
 #include <baseproc/array/multiply/mulmatmat.h>
 #include <baseproc/array/solve/svd_solve.h>
+#include <baseproc/array/solve/linsys_schur.h>
 #include <baseproc/array/decomposition/cholesky.h>
 #include <baseproc/array/multiply/mulmattransmat.h>
 #include <baseproc/geometry/transforms/transform_tools.h>
@@ -1310,19 +1311,21 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear( Rox_Calibration
    Rox_ErrorCode       error = ROX_ERROR_NONE;
    Rox_Uint            nbpos, nbpts;
    Rox_Uint            miter=10,    Tddl=6,      Kddl=method;
-   Rox_Uint            start_row=0, start_col=0;
    Rox_Point2D_Double_Struct  * pc = NULL;
    Rox_Double            *zc=0;
-   Rox_Array2D_Double  JK =NULL;
-   Rox_Array2D_Double  JT =NULL;
+   Rox_ErrorCode       *errors = NULL;
+   Rox_ObjSet_Array2D_Double JK = NULL;
+   Rox_ObjSet_Array2D_Double JT = NULL;
+   Rox_ObjSet_Array2D_Double b = NULL;
+   Rox_LinSys_Schur    schur = NULL;
    Rox_Array2D_Double  xK_ddl=NULL;
    Rox_Array2D_Double  xT = NULL;
    Rox_Array2D_Double  xK = NULL;
    Rox_Array2D_Double  x = NULL;
-   Rox_Array2D_Double  A = NULL;
-   Rox_Array2D_Double  b = NULL;
+   Rox_Array2D_Double  buf = NULL;
    Rox_Double            cu = 0.0;
    Rox_Double            cv = 0.0;
+   Rox_Sint            i = 0;
 
    if ( obj == NULL ) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
    if ( method>6 || method ==0 ) {error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE(error)}
@@ -1340,12 +1343,41 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear( Rox_Calibration
    error = rox_array2d_double_new( &x, Kddl+Tddl*nbpos, 1 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new( &A, 2*nbpts*nbpos, Kddl+Tddl*nbpos );
+   // Normal equations with one 6 dof block per view, reduced on the intrinsics
+   error = rox_linsys_schur_new( &schur, Kddl, Tddl, nbpos );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new( &b, 2*nbpts*nbpos,1 );
+   // Per view jacobians and residuals, so that the views can be linearized concurrently
+   error = rox_objset_array2d_double_new( &JK, nbpos );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_objset_array2d_double_new( &JT, nbpos );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_objset_array2d_double_new( &b, nbpos );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint v = 0; v < nbpos; v++ )
+   {
+      error = rox_array2d_double_new( &buf, 2*nbpts, Kddl );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append( JK, buf );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new( &buf, 2*nbpts, Tddl );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append( JT, buf );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new( &buf, 2*nbpts, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append( b, buf );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+   }
+
    error = rox_array2d_double_get_value( &cu, obj->K, 0, 2 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -1353,64 +1385,67 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear( Rox_Calibration
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Init structures
-   pc = ( Rox_Point2D_Double  ) rox_memory_allocate( sizeof( *pc ), nbpts );
+   pc = ( Rox_Point2D_Double  ) rox_memory_allocate( sizeof( *pc ), nbpts * nbpos );
    if ( !pc ) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );}
 
-   zc = ( Rox_Double * )rox_memory_allocate( sizeof( *zc ), nbpts );
+   zc = ( Rox_Double * )rox_memory_allocate( sizeof( *zc ), nbpts * nbpos );
    if ( !zc ) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );}
 
+   errors = ( Rox_ErrorCode * ) rox_memory_allocate( sizeof( *errors ), nbpos );
+   if ( !errors ) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );}
+
    // Virtual Visual Servoing
    for (Rox_Uint k = 0; k < miter; k++ )
    {
-      // Reset normal equations A*x = b
-      error = rox_array2d_double_fillval( A, 0.0 ); ROX_ERROR_CHECK_TERMINATE ( error );
-      error = rox_array2d_double_fillval( b, 0.0 ); ROX_ERROR_CHECK_TERMINATE ( error );
+      // Reset normal equations
+      error = rox_linsys_schur_reset( schur );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-      // For each image
-      for (Rox_Uint i = 0; i < nbpos; i++ )
+      // Linearize each image independently
+      #ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+      #endif
+      for ( i = 0; i < (Rox_Sint) nbpos; i++ )
       {
-         if ( obj->valid_flags->data[i] == 0 ) continue;
+         Rox_Point2D_Double pci = pc + i * nbpts;
+         Rox_Double * zci = zc + i * nbpts;
+         Rox_Double ** db = NULL;
 
-         // Compute indexes
-         start_row = 2 * nbpts * i;
-         start_col = Kddl + Tddl * i;
+         errors[i] = ROX_ERROR_NONE;
+         if ( obj->valid_flags->data[i] == 0 ) continue;
 
          // Compute the current points and depths
-         error = rox_point2d_double_transform_project( pc, zc, obj->K, obj->poses->data[i], obj->model->data, nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_point2d_double_transform_project( pci, zci, obj->K, obj->poses->data[i], obj->model->data, nbpts );
+         if ( errors[i] ) continue;
 
          // Compute the Jacobian matrix for T
-         error = rox_array2d_double_new_subarray2d( &JT, A, start_row, start_col, 2*nbpts, Tddl );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_interaction_matse3_point2d_pix( JT, pc, zc, obj->K, nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_interaction_matse3_point2d_pix( JT->data[i], pci, zci, obj->K, nbpts );
+         if ( errors[i] ) continue;
 
          // Compute the Jacobian matrix for K
-         error = rox_array2d_double_new_subarray2d( &JK, A, start_row, 0, 2*nbpts, Kddl );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_jacobian_points_2d_campar( JK, pc, cu, cv, nbpts, Kddl );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_jacobian_points_2d_campar( JK->data[i], pci, cu, cv, nbpts, Kddl );
+         if ( errors[i] ) continue;
 
          // Build vector b
+         errors[i] = rox_array2d_double_get_data_pointer_to_pointer( &db, b->data[i] );
+         if ( errors[i] ) continue;
+
          for (Rox_Uint j = 0; j < nbpts; j++ )
          {
-            Rox_Uint row = start_row + j * 2;
-
-            error = rox_array2d_double_set_value( b, row  , 0, pc[j].u - obj->points->data[i]->data[j].u );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-
-            error = rox_array2d_double_set_value( b, row+1, 0, pc[j].v - obj->points->data[i]->data[j].v );
-            ROX_ERROR_CHECK_TERMINATE ( error );
+            db[2*j  ][0] = pci[j].u - obj->points->data[i]->data[j].u;
+            db[2*j+1][0] = pci[j].v - obj->points->data[i]->data[j].v;
          }
 
-         rox_array2d_double_del( &JK );
-         rox_array2d_double_del( &JT );
+         errors[i] = rox_linsys_schur_add_block( schur, i, JK->data[i], JT->data[i], b->data[i] );
       }
 
-      // Solve x = pinv( A )*b
-      error = rox_svd_solve( x, A, b );
+      for (Rox_Uint v = 0; v < nbpos; v++ )
+      {
+         if ( errors[v] ) { error = errors[v]; ROX_ERROR_CHECK_TERMINATE ( error ); }
+      }
+
+      // Solve x = pinv( A )*b through the reduced system on the intrinsics
+      error = rox_linsys_schur_solve( x, schur );
       ROX_ERROR_CHECK_TERMINATE ( error );
 
       // Update intrinsic parameters and poses
@@ -1431,17 +1466,17 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear( Rox_Calibration
 
       rox_array2d_double_del( &xK_ddl );
 
-      for (Rox_Uint i = 0; i < nbpos; i++ )
+      for (Rox_Uint v = 0; v < nbpos; v++ )
       {
-         if ( obj->valid_flags->data[i] == 0 ) continue;
+         if ( obj->valid_flags->data[v] == 0 ) continue;
 
-         error = rox_array2d_double_new_subarray2d( &xT, x, Kddl + 6*i, 0, Tddl, 1 );
+         error = rox_array2d_double_new_subarray2d( &xT, x, Kddl + 6*v, 0, Tddl, 1 );
          ROX_ERROR_CHECK_TERMINATE(error)
 
          error = rox_array2d_double_scale_inplace(xT, -1.0);
          ROX_ERROR_CHECK_TERMINATE( error );
 
-         error = rox_matse3_update_left ( obj->poses->data[i], xT );
+         error = rox_matse3_update_left ( obj->poses->data[v], xT );
          ROX_ERROR_CHECK_TERMINATE ( error );
 
          rox_array2d_double_del( &xT );
@@ -1452,12 +1487,14 @@ function_terminate:
    // Delete data
    rox_memory_delete( pc );
    rox_memory_delete( zc );
+   rox_memory_delete( errors );
 
-   rox_array2d_double_del( &JK );
-   rox_array2d_double_del( &JT );
+   rox_objset_array2d_double_del( &JK );
+   rox_objset_array2d_double_del( &JT );
+   rox_objset_array2d_double_del( &b );
+   rox_linsys_schur_del( &schur );
 
-   rox_array2d_double_del( &A );
-   rox_array2d_double_del( &b );
+   rox_array2d_double_del( &buf );
    rox_array2d_double_del( &x );
 
    rox_array2d_double_del( &xK_ddl );
@@ -1472,20 +1509,22 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear_normalize( Rox_C
    Rox_ErrorCode       error=ROX_ERROR_NONE;
    Rox_Uint            nbpos,       nbpts;
    Rox_Uint            miter=10,    Tddl=6,      Kddl=method;
-   Rox_Uint            start_row=0, start_col=0;
    Rox_Point2D_Double_Struct  *pr=0;
    Rox_Point2D_Double_Struct  *pc=0;
    Rox_Point2D_Double_Struct  *qc=0;
    Rox_Point2D_Double_Struct  *qr=0;
    Rox_Double            *zc=0;
-   Rox_Array2D_Double  JK=NULL;
-   Rox_Array2D_Double  JT=NULL;
+   Rox_ErrorCode       *errors = NULL;
+   Rox_ObjSet_Array2D_Double JK = NULL;
+   Rox_ObjSet_Array2D_Double JT = NULL;
+   Rox_ObjSet_Array2D_Double b = NULL;
+   Rox_LinSys_Schur    schur = NULL;
    Rox_Array2D_Double  xK_ddl=NULL;
    Rox_Array2D_Double  xT=NULL;
    Rox_Array2D_Double  xK=NULL;
    Rox_Array2D_Double  x=NULL;
-   Rox_Array2D_Double  A=NULL;
-   Rox_Array2D_Double  b=NULL;
+   Rox_Array2D_Double  buf = NULL;
+   Rox_Sint            i = 0;
 
    if ( !obj )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -1508,116 +1547,138 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear_normalize( Rox_C
    error = rox_array2d_double_new( &x, Kddl+Tddl*nbpos, 1 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new( &A, 2*nbpts*nbpos, Kddl+Tddl*nbpos );
+   // Normal equations with one 6 dof block per view, reduced on the intrinsics
+   error = rox_linsys_schur_new( &schur, Kddl, Tddl, nbpos );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // Per view jacobians and residuals, so that the views can be linearized concurrently
+   error = rox_objset_array2d_double_new( &JK, nbpos );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new( &b, 2*nbpts*nbpos,1 );
+   error = rox_objset_array2d_double_new( &JT, nbpos );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_objset_array2d_double_new( &b, nbpos );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint v = 0; v < nbpos; v++ )
+   {
+      error = rox_array2d_double_new( &buf, 2*nbpts, Kddl );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append( JK, buf );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new( &buf, 2*nbpts, Tddl );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append( JT, buf );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new( &buf, 2*nbpts, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append( b, buf );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+   }
+
    // Init structures
-   pr = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *pr ), nbpts );
+   pr = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *pr ), nbpts * nbpos );
    if ( !pr )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   pc = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *pc ), nbpts );
+   pc = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *pc ), nbpts * nbpos );
    if ( !pc )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   qr = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *qr ), nbpts );
+   qr = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *qr ), nbpts * nbpos );
    if ( !qr )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   qc = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *qc ), nbpts );
+   qc = ( Rox_Point2D_Double  )rox_memory_allocate( sizeof( *qc ), nbpts * nbpos );
    if ( !qc )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   zc = ( Rox_Double* )rox_memory_allocate( sizeof( *zc ), nbpts );
+   zc = ( Rox_Double* )rox_memory_allocate( sizeof( *zc ), nbpts * nbpos );
    if ( !zc )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   errors = ( Rox_ErrorCode * ) rox_memory_allocate( sizeof( *errors ), nbpos );
+   if ( !errors )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
    // Virtual Visual Servoing
    for (Rox_Uint k = 0; k < miter; k++ )
    {
-      // Reset normal equations A*x = b
-      error = rox_array2d_double_fillval( A, 0.0 );
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      error = rox_array2d_double_fillval( b, 0.0 );
+      // Reset normal equations
+      error = rox_linsys_schur_reset( schur );
       ROX_ERROR_CHECK_TERMINATE ( error );
 
       error = rox_array2d_double_mat3x3_inverse( obj->Kt, obj->K );
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      // For each image
-      for (Rox_Uint i = 0; i < nbpos; i++ )
+      // Linearize each image independently
+      #ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+      #endif
+      for ( i = 0; i < (Rox_Sint) nbpos; i++ )
       {
-         if ( obj->valid_flags->data[i] == 0 )
-            continue;
-
-         // Compute indexes
-         start_row = 2 * nbpts * i;
-         start_col = Kddl + Tddl * i;
+         Rox_Point2D_Double pri = pr + i * nbpts;
+         Rox_Point2D_Double pci = pc + i * nbpts;
+         Rox_Point2D_Double qri = qr + i * nbpts;
+         Rox_Point2D_Double qci = qc + i * nbpts;
+         Rox_Double * zci = zc + i * nbpts;
+         Rox_Double ** db = NULL;
+
+         errors[i] = ROX_ERROR_NONE;
+         if ( obj->valid_flags->data[i] == 0 ) continue;
 
          // Compute the reference points
-         error = rox_point2d_double_homography( pr, obj->model2D->data, obj->homographies->data[i], nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_point2d_double_homography( pri, obj->model2D->data, obj->homographies->data[i], nbpts );
+         if ( errors[i] ) continue;
 
          // Compute the current points and depths
-         error = rox_point2d_double_transform_project( pc, zc, obj->K, obj->poses->data[i], obj->model->data, nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_point2d_double_transform_project( pci, zci, obj->K, obj->poses->data[i], obj->model->data, nbpts );
+         if ( errors[i] ) continue;
 
          // Compute normalized points from points in pixels
-         error = rox_point2d_double_homography( qc, pc, obj->Kt, nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_point2d_double_homography( qci, pci, obj->Kt, nbpts );
+         if ( errors[i] ) continue;
 
-         error = rox_point2d_double_homography( qr, pr, obj->Kt, nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_point2d_double_homography( qri, pri, obj->Kt, nbpts );
+         if ( errors[i] ) continue;
 
          // Compute the Jacobian matrix for T
-         error = rox_array2d_double_new_subarray2d( &JT, A, start_row, start_col, 2*nbpts, Tddl );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_interaction_matse3_point2d_nor( JT, qc, zc, nbpts );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_interaction_matse3_point2d_nor( JT->data[i], qci, zci, nbpts );
+         if ( errors[i] ) continue;
 
          // Compute the Jacobian matrix for K
-         error = rox_array2d_double_new_subarray2d( &JK, A, start_row, 0, 2*nbpts, Kddl );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_jacobian_points_2d_campar( JK, qc, 0, 0, nbpts, Kddl );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_jacobian_points_2d_campar( JK->data[i], qci, 0, 0, nbpts, Kddl );
+         if ( errors[i] ) continue;
 
-         // Build vector b
-         error = rox_array2d_double_set_value( b, start_row+0, 0, qc[0].u - qr[0].u );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         // Build vector b, only the first four points contribute to the error
+         errors[i] = rox_array2d_double_fillval( b->data[i], 0.0 );
+         if ( errors[i] ) continue;
 
-         error = rox_array2d_double_set_value( b, start_row+1, 0, qc[0].v - qr[0].v );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_array2d_double_get_data_pointer_to_pointer( &db, b->data[i] );
+         if ( errors[i] ) continue;
 
-         error = rox_array2d_double_set_value( b, start_row+2, 0, qc[1].u - qr[1].u );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_array2d_double_set_value( b, start_row+3, 0, qc[1].v - qr[1].v );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_array2d_double_set_value( b, start_row+4, 0, qc[2].u - qr[2].u );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_array2d_double_set_value( b, start_row+5, 0, qc[2].v - qr[2].v );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_array2d_double_set_value( b, start_row+6, 0, qc[3].u - qr[3].u );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         for (Rox_Uint j = 0; j < 4 && j < nbpts; j++ )
+         {
+            db[2*j  ][0] = qci[j].u - qri[j].u;
+            db[2*j+1][0] = qci[j].v - qri[j].v;
+         }
 
-         error = rox_array2d_double_set_value( b, start_row+7, 0, qc[3].v - qr[3].v );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_linsys_schur_add_block( schur, i, JK->data[i], JT->data[i], b->data[i] );
+      }
 
-         rox_array2d_double_del( &JK );
-         rox_array2d_double_del( &JT );
+      for (Rox_Uint v = 0; v < nbpos; v++ )
+      {
+         if ( errors[v] ) { error = errors[v]; ROX_ERROR_CHECK_TERMINATE ( error ); }
       }
 
-      // Solve x = pinv( A )*b
-      error = rox_svd_solve( x, A, b );
+      // Solve x = pinv( A )*b through the reduced system on the intrinsics
+      error = rox_linsys_schur_solve( x, schur );
       ROX_ERROR_CHECK_TERMINATE ( error );
 
       // Update intrinsic parameters and poses
@@ -1638,17 +1699,17 @@ Rox_ErrorCode rox_calibration_mono_perspective_process_nolinear_normalize( Rox_C
       error = rox_array2d_double_mat3x3_inverse( obj->K, obj->Kt );
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      for ( Rox_Uint i = 0; i < nbpos; i++ )
+      for ( Rox_Uint v = 0; v < nbpos; v++ )
       {
-         if ( obj->valid_flags->data[i] == 0 ) continue;
+         if ( obj->valid_flags->data[v] == 0 ) continue;
 
-         error = rox_array2d_double_new_subarray2d( &xT, x, Kddl + 6*i, 0, Tddl, 1 );
+         error = rox_array2d_double_new_subarray2d( &xT, x, Kddl + 6*v, 0, Tddl, 1 );
          ROX_ERROR_CHECK_TERMINATE(error)
 
          error = rox_array2d_double_scale_inplace(xT, -1.0);
          ROX_ERROR_CHECK_TERMINATE( error );
 
-         error = rox_matse3_update_left( obj->poses->data[i], xT );
+         error = rox_matse3_update_left( obj->poses->data[v], xT );
          ROX_ERROR_CHECK_TERMINATE(error)
 
          rox_array2d_double_del(&xT);
@@ -1662,12 +1723,14 @@ function_terminate:
    rox_memory_delete( qr );
    rox_memory_delete( qc );
    rox_memory_delete( zc );
+   rox_memory_delete( errors );
 
-   rox_array2d_double_del( &JK );
-   rox_array2d_double_del( &JT );
+   rox_objset_array2d_double_del( &JK );
+   rox_objset_array2d_double_del( &JT );
+   rox_objset_array2d_double_del( &b );
+   rox_linsys_schur_del( &schur );
 
-   rox_array2d_double_del( &A );
-   rox_array2d_double_del( &b );
+   rox_array2d_double_del( &buf );
    rox_array2d_double_del( &x );
 
    rox_array2d_double_del( &xK_ddl );
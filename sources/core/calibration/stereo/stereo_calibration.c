@@ -23,6 +23,7 @@
 #include <baseproc/array/fill/fillval.h>
 #include <baseproc/array/inverse/svdinverse.h>
 #include <baseproc/array/solve/svd_solve.h>
+#include <baseproc/array/solve/linsys_schur.h>
 #include <baseproc/array/minmax/minmax.h>
 #include <baseproc/array/median/median.h>
 #include <baseproc/geometry/transforms/transform_tools.h>
@@ -632,185 +633,236 @@ Rox_ErrorCode rox_calibration_stereo_perspective_process_nolinear_f_cu_cv(Rox_Ca
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Uint nbimages, nbpoints;
    Rox_Uint Kdll = 3, Tdll = 6, iter = 10;
-   Rox_Uint Jcols, Jrows, start_col, start_row;
+   Rox_Uint Scols, Jcols;
    Rox_Double lambda = 0.9;
-   Rox_Array2D_Double J = 0, JKr = 0, JKl = 0, JTrl = 0, JTl = 0, JTr = 0, rTo = 0;
-   Rox_Array2D_Double b = 0, x = 0, xKl = 0, xKr = 0, xTrl = 0, xT =0, xK =0;
-   Rox_Array2D_Double Kl, Kr, lTo, rTl;
+   Rox_Array2D_Double x = 0, xKl = 0, xKr = 0, xTrl = 0, xT =0, xK =0, buf = 0;
+   Rox_ObjSet_Array2D_Double Js = NULL, Jb = NULL, b = NULL, rTo = NULL;
+   Rox_ObjSet_Array2D_Double JKl = NULL, JKr = NULL, JTrl = NULL, JTl = NULL, JTr = NULL;
+   Rox_LinSys_Schur schur = NULL;
    Rox_DynVec_Point3D_Double model;
 
    Rox_Point2D_Double cur_left = NULL;
    Rox_Point2D_Double cur_right = NULL;
    Rox_Double *zl = 0, *zr = 0;
    Rox_Double **dxK, **dxKl, **dxKr;
+   Rox_ErrorCode * errors = NULL;
+   Rox_Sint i = 0;
 
    if(!obj) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
 
    nbimages = obj->left->poses->used;
    nbpoints = obj->left->model->used;
+   model = obj->left->model;
 
-   // Allocate J
-   Jrows = 4*nbpoints * nbimages;
-   Jcols = 2*Kdll + Tdll + Tdll * nbimages; // Kl - Kr - Trl - T(1) - ... - T(nbimages)
+   // Shared parameters are Kl - Kr - Trl, then one block T(i) per image
+   Scols = 2*Kdll + Tdll;
+   Jcols = Scols + Tdll * nbimages;
 
+   error = rox_array2d_double_new(&x, Jcols, 1); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new(&rTo, 4, 4); 
+   // Allocate the vector for the algut3
+   error = rox_array2d_double_new(&xK, 6, 1); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new(&J, Jrows, Jcols); 
+   error = rox_linsys_schur_new(&schur, Scols, Tdll, nbimages);
    ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_array2d_double_new(&b, 4*nbpoints*nbimages, 1); 
+
+   // Per image jacobians (left rows then right rows) and their subviews
+   error = rox_objset_array2d_double_new(&Js, nbimages);
    ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_array2d_double_new(&x, Jcols, 1); 
+   error = rox_objset_array2d_double_new(&Jb, nbimages);
    ROX_ERROR_CHECK_TERMINATE ( error );
-
-   // Allocate the vector for the algut3
-   error = rox_array2d_double_new(&xK, 6, 1); 
+   error = rox_objset_array2d_double_new(&b, nbimages);
    ROX_ERROR_CHECK_TERMINATE ( error );
+   error = rox_objset_array2d_double_new(&rTo, nbimages);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   error = rox_objset_array2d_double_new(&JKl, nbimages);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   error = rox_objset_array2d_double_new(&JKr, nbimages);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   error = rox_objset_array2d_double_new(&JTrl, nbimages);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   error = rox_objset_array2d_double_new(&JTl, nbimages);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   error = rox_objset_array2d_double_new(&JTr, nbimages);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint v = 0; v < nbimages; v++)
+   {
+      error = rox_array2d_double_new(&buf, 4*nbpoints, Scols);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_fillval(buf, 0.0);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(Js, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new(&buf, 4*nbpoints, Tdll);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(Jb, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new(&buf, 4*nbpoints, 1);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(b, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new(&buf, 4, 4);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(rTo, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new_subarray2d(&buf, Js->data[v], 0, 0, 2*nbpoints, Kdll);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(JKl, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new_subarray2d(&buf, Js->data[v], 2*nbpoints, Kdll, 2*nbpoints, Kdll);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(JKr, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new_subarray2d(&buf, Js->data[v], 2*nbpoints, 2*Kdll, 2*nbpoints, Tdll);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(JTrl, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
 
-   cur_left  =(Rox_Point2D_Double ) rox_memory_allocate(sizeof(*cur_left), nbpoints);
+      error = rox_array2d_double_new_subarray2d(&buf, Jb->data[v], 0, 0, 2*nbpoints, Tdll);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(JTl, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+
+      error = rox_array2d_double_new_subarray2d(&buf, Jb->data[v], 2*nbpoints, 0, 2*nbpoints, Tdll);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_objset_array2d_double_append(JTr, buf);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      buf = NULL;
+   }
+
+   cur_left  =(Rox_Point2D_Double ) rox_memory_allocate(sizeof(*cur_left), nbpoints * nbimages);
    if (!cur_left)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   cur_right = (Rox_Point2D_Double ) rox_memory_allocate(sizeof(*cur_right), nbpoints);
+   cur_right = (Rox_Point2D_Double ) rox_memory_allocate(sizeof(*cur_right), nbpoints * nbimages);
    if (!cur_right)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   zl = (Rox_Double*) rox_memory_allocate(sizeof(*zl), nbpoints);
+   zl = (Rox_Double*) rox_memory_allocate(sizeof(*zl), nbpoints * nbimages);
    if (!zl)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   zr = (Rox_Double*) rox_memory_allocate(sizeof(*zr), nbpoints);
-   if (!zl)
+   zr = (Rox_Double*) rox_memory_allocate(sizeof(*zr), nbpoints * nbimages);
+   if (!zr)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   errors = (Rox_ErrorCode*) rox_memory_allocate(sizeof(*errors), nbimages);
+   if (!errors)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
    error = rox_array2d_double_get_data_pointer_to_pointer(&dxK, xK);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_array2d_double_new_subarray2d(&xKl, x, 0, 0, Kdll, 1); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   
+   error = rox_array2d_double_new_subarray2d(&xKr, x, Kdll, 0, Kdll, 1); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   
+   error = rox_array2d_double_new_subarray2d(&xTrl , x, 2*Kdll, 0, Tdll, 1); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    for(Rox_Uint k = 0; k < iter; k++)
    {
-
-      // Reset J
-
-      error = rox_array2d_double_fillval(J, 0.0); 
+      // Reset normal equations
+      error = rox_linsys_schur_reset(schur);
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      error = rox_array2d_double_fillval(x, 0.0); 
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      error = rox_array2d_double_fillval(b, 0.0); 
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      for (Rox_Uint i = 0; i < nbimages; i++)
+      // Linearize each image pair independently
+      #ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+      #endif
+      for (i = 0; i < (Rox_Sint) nbimages; i++)
       {
-         Kl = obj->left->K;
-         Kr = obj->right->K;
-         lTo = obj->left->poses->data[i];
-         rTl = obj->rTl;
-         model = obj->left->model;
+         Rox_Array2D_Double Kl = obj->left->K;
+         Rox_Array2D_Double Kr = obj->right->K;
+         Rox_Array2D_Double lTo = obj->left->poses->data[i];
+         Rox_Array2D_Double rTl = obj->rTl;
+         Rox_Point2D_Double cl = cur_left + i * nbpoints;
+         Rox_Point2D_Double cr = cur_right + i * nbpoints;
+         Rox_Double * zli = zl + i * nbpoints;
+         Rox_Double * zri = zr + i * nbpoints;
+         Rox_Double ** db = NULL;
+
+         errors[i] = ROX_ERROR_NONE;
 
          // valid images
          if(obj->left->valid_flags->data[i] == 0 || obj->right->valid_flags->data[i] == 0) continue;
 
-         // Get Jacobian subviews
-         start_col = 0;
-         start_row = 4*nbpoints*i;
-         error = rox_array2d_double_new_subarray2d(&JKl, J, start_row, start_col, 2*nbpoints, Kdll);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         start_col = Kdll;
-         start_row = 4 * nbpoints * i  + 2 *nbpoints;
-         error = rox_array2d_double_new_subarray2d(&JKr, J, start_row, start_col, 2*nbpoints, Kdll);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         start_col = 2 * Kdll;
-         start_row = 4 * nbpoints * i + 2 *nbpoints;
-         error = rox_array2d_double_new_subarray2d(&JTrl,J, start_row, start_col, 2*nbpoints, Tdll);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         start_col = 2 * Kdll + Tdll + i * Tdll;
-         start_row = 4 * nbpoints * i;
-         error = rox_array2d_double_new_subarray2d(&JTl, J, start_row, start_col, 2*nbpoints, Tdll);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         start_col = 2 * Kdll + Tdll + i * Tdll;
-         start_row = 4 * nbpoints * i + 2 *nbpoints;
-         error = rox_array2d_double_new_subarray2d(&JTr, J, start_row, start_col, 2*nbpoints, Tdll);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
          // rTo = rTl * lTo
-         error = rox_array2d_double_mulmatmat(rTo, rTl, lTo); ROX_ERROR_CHECK_TERMINATE(error)
+         errors[i] = rox_array2d_double_mulmatmat(rTo->data[i], rTl, lTo);
+         if (errors[i]) continue;
 
+         errors[i] = rox_point2d_double_transform_project(cl, zli, Kl, lTo, model->data, nbpoints); 
+         if (errors[i]) continue;
 
-         error = rox_point2d_double_transform_project(cur_left, zl, Kl, lTo, model->data, nbpoints); 
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_point2d_double_transform_project(cur_right,zr, Kr, rTo, model->data, nbpoints); 
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_point2d_double_transform_project(cr, zri, Kr, rTo->data[i], model->data, nbpoints); 
+         if (errors[i]) continue;
 
          // compute jacobians
-         error = rox_jacobian_perspective_stereo_calibration_f_cu_cv(JKl, cur_left, nbpoints); 
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_jacobian_perspective_stereo_calibration_f_cu_cv(JKl->data[i], cl, nbpoints); 
+         if (errors[i]) continue;
 
-         error = rox_jacobian_perspective_stereo_calibration_f_cu_cv(JKr, cur_right, nbpoints);
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_jacobian_perspective_stereo_calibration_f_cu_cv(JKr->data[i], cr, nbpoints);
+         if (errors[i]) continue;
 
+         errors[i] = rox_jacobian_perspective_stereo_calibration_pose_intercamera(JTrl->data[i], Kr, rTl, lTo, rTo->data[i], model->data, nbpoints); 
+         if (errors[i]) continue;
 
-         error = rox_jacobian_perspective_stereo_calibration_pose_intercamera(JTrl, Kr, rTl, lTo, rTo, model->data, nbpoints); 
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_jacobian_perspective_stereo_calibration_pose(JTl->data[i], Kl, lTo, model->data, cl, zli, nbpoints); 
+         if (errors[i]) continue;
 
-         error = rox_jacobian_perspective_stereo_calibration_pose(JTl, Kl, lTo, model->data, cur_left, zl, nbpoints); 
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         error = rox_jacobian_perspective_stereo_calibration_pose(JTr, Kr, rTo, model->data, cur_right, zr, nbpoints); 
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         errors[i] = rox_jacobian_perspective_stereo_calibration_pose(JTr->data[i], Kr, rTo->data[i], model->data, cr, zri, nbpoints); 
+         if (errors[i]) continue;
 
          // Build vector b
+         errors[i] = rox_array2d_double_get_data_pointer_to_pointer(&db, b->data[i]);
+         if (errors[i]) continue;
+
          for(Rox_Uint j = 0; j < nbpoints; j++)
          {
-               Rox_Uint row = 4 * nbpoints * i + j * 2;
-
-               error = rox_array2d_double_set_value(b, row  , 0, cur_left[j].u  - obj->left->points->data[i]->data[j].u);
-               ROX_ERROR_CHECK_TERMINATE(error)
-               error = rox_array2d_double_set_value(b, row+1, 0, cur_left[j].v  - obj->left->points->data[i]->data[j].v);
-               ROX_ERROR_CHECK_TERMINATE(error)
+            db[2*j  ][0] = cl[j].u - obj->left->points->data[i]->data[j].u;
+            db[2*j+1][0] = cl[j].v - obj->left->points->data[i]->data[j].v;
          }
 
          for(Rox_Uint j = 0; j < nbpoints; j++)
          {
-               Rox_Uint row = 4 * nbpoints * i + 2 * nbpoints + j * 2;
-
-               error = rox_array2d_double_set_value(b, row  , 0, cur_right[j].u - obj->right->points->data[i]->data[j].u);
-               error = rox_array2d_double_set_value(b, row+1, 0, cur_right[j].v - obj->right->points->data[i]->data[j].v);
+            db[2*nbpoints + 2*j  ][0] = cr[j].u - obj->right->points->data[i]->data[j].u;
+            db[2*nbpoints + 2*j+1][0] = cr[j].v - obj->right->points->data[i]->data[j].v;
          }
 
-         // Free subviews
-         rox_array2d_double_del(&JKr);
-         rox_array2d_double_del(&JKl);
-         rox_array2d_double_del(&JTr);
-         rox_array2d_double_del(&JTl);
-         rox_array2d_double_del(&JTrl);
+         errors[i] = rox_linsys_schur_add_block(schur, i, Js->data[i], Jb->data[i], b->data[i]);
       }
 
-      // Solve x = pinv(J)*b
+      for (Rox_Uint v = 0; v < nbimages; v++)
+      {
+         if (errors[v]) { error = errors[v]; ROX_ERROR_CHECK_TERMINATE ( error ); }
+      }
 
-      error = rox_svd_solve(x, J, b); 
+      // Solve x = pinv(J)*b through the reduced system on the shared parameters
+      error = rox_linsys_schur_solve(x, schur);
       ROX_ERROR_CHECK_TERMINATE ( error );
       
       error = rox_array2d_double_scale(x, x, -lambda); 
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      error = rox_array2d_double_new_subarray2d(&xKl, x, 0, 0, Kdll, 1); 
-      ROX_ERROR_CHECK_TERMINATE ( error );
-      
-      error = rox_array2d_double_new_subarray2d(&xKr, x, Kdll, 0, Kdll, 1); 
-      ROX_ERROR_CHECK_TERMINATE ( error );
-      
-      error = rox_array2d_double_new_subarray2d(&xTrl , x, 2*Kdll, 0, Tdll, 1); 
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
       // Update K and T
 
       // Build xK
@@ -851,50 +903,56 @@ Rox_ErrorCode rox_calibration_stereo_perspective_process_nolinear_f_cu_cv(Rox_Ca
       error = rox_matse3_update_right(obj->rTl, xTrl);
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      for (Rox_Uint i = 0; i < nbimages; i++)
+      for (Rox_Uint v = 0; v < nbimages; v++)
       {
          // valid images
-         if(obj->left->valid_flags->data[i] == 0 || obj->right->valid_flags->data[i] == 0) continue;
+         if(obj->left->valid_flags->data[v] == 0 || obj->right->valid_flags->data[v] == 0) continue;
 
-         error = rox_array2d_double_new_subarray2d(&xT, x, 2*Kdll + Tdll + Tdll*i, 0, Tdll, 1);
+         error = rox_array2d_double_new_subarray2d(&xT, x, Scols + Tdll*v, 0, Tdll, 1);
          ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_matse3_update_right(obj->left->poses->data[i], xT);
+         error = rox_matse3_update_right(obj->left->poses->data[v], xT);
          ROX_ERROR_CHECK_TERMINATE ( error );
          rox_array2d_double_del ( &xT );
       }
    }
 
    // Update the right poses after the visual servoing
-   for (Rox_Uint i = 0; i < nbimages; i++)
+   for (Rox_Uint v = 0; v < nbimages; v++)
    {
       // valid images
-      if(obj->left->valid_flags->data[i] == 0 || obj->right->valid_flags->data[i] == 0) continue;
+      if(obj->left->valid_flags->data[v] == 0 || obj->right->valid_flags->data[v] == 0) continue;
 
-      error = rox_array2d_double_mulmatmat(obj->right->poses->data[i], obj->rTl, obj->left->poses->data[i]);
+      error = rox_array2d_double_mulmatmat(obj->right->poses->data[v], obj->rTl, obj->left->poses->data[v]);
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
 function_terminate:
-   rox_array2d_double_del(&JKr);
-   rox_array2d_double_del(&JKl);
-   rox_array2d_double_del(&JTr);
-   rox_array2d_double_del(&JTl);
-   rox_array2d_double_del(&JTrl);
-   rox_array2d_double_del(&J);
+   // Subviews first, they reference the jacobian buffers
+   rox_objset_array2d_double_del(&JKl);
+   rox_objset_array2d_double_del(&JKr);
+   rox_objset_array2d_double_del(&JTrl);
+   rox_objset_array2d_double_del(&JTl);
+   rox_objset_array2d_double_del(&JTr);
+   rox_objset_array2d_double_del(&Js);
+   rox_objset_array2d_double_del(&Jb);
+   rox_objset_array2d_double_del(&b);
+   rox_objset_array2d_double_del(&rTo);
+   rox_linsys_schur_del(&schur);
+
+   rox_array2d_double_del(&buf);
    rox_array2d_double_del(&xT);
-   rox_array2d_double_del(&b);
-   rox_array2d_double_del(&x);
    rox_array2d_double_del(&xK);
    rox_array2d_double_del(&xKl);
    rox_array2d_double_del(&xKr);
    rox_array2d_double_del(&xTrl);
-   rox_array2d_double_del(&xT);
+   rox_array2d_double_del(&x);
 
    rox_memory_delete(cur_left);
    rox_memory_delete(cur_right);
    rox_memory_delete(zl);
    rox_memory_delete(zr);
+   rox_memory_delete(errors);
 
    return error;
 }
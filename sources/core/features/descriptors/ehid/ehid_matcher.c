@@ -22,6 +22,8 @@
 
 #include <float.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <baseproc/maths/maths_macros.h>
 #include <baseproc/maths/random/random.h>
@@ -36,117 +38,285 @@
 
 #define MIN_SCORE_MATCHING 4
 
-Rox_ErrorCode rox_ehid_matcher_new(Rox_Ehid_Matcher * ehid_matcher, Rox_Uint max_templates_detected)
+// Minimal number of primary matches in the best viewpoint of a target to verify it
+#define MIN_VOTES_VERIFICATION 6
+
+#ifdef ROX_USES_OPENMP
+   #define ROX_EHID_MATCHER_PARALLEL_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+   #define ROX_EHID_MATCHER_PARALLEL_FOR
+#endif
+
+// Sort the candidate keys by decreasing votes, then by increasing target index
+static int rox_ehid_matcher_compare_candidates(const void * one, const void * two)
 {
-   Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Ehid_Matcher ret = NULL;
+   const Rox_Slint a = *(const Rox_Slint *) one;
+   const Rox_Slint b = *(const Rox_Slint *) two;
 
+   if (a < b) return 1;
+   if (a > b) return -1;
+   return 0;
+}
 
-   if (!ehid_matcher) 
+Rox_ErrorCode rox_ehid_matcher_dispatch_matches (
+   Rox_Ehid_Matcher ehid_matcher,
+   Rox_Ehid_Database db,
+   Rox_DynVec_Ehid_Point detectedfeats
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uint idcur, idref, idtarget, idmatch;
+   Rox_Ehid_Point  cur = NULL, ref = NULL;
+   Rox_Uint score, bucket;
+   Rox_Ehid_Match_Struct match;
+   Rox_Double difangle, cosdif, sindif;
+   Rox_Uint binangle;
+
+   if (!ehid_matcher || !detectedfeats || !db)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   *ehid_matcher = NULL;
+   const Rox_Sint nb_targets = (Rox_Sint) db->_targets->used;
 
-   ret = (Rox_Ehid_Matcher)rox_memory_allocate(sizeof(struct Rox_Ehid_Matcher_Struct), 1);
+   // Reset targets, in order as each target draws its ransac seed
+   for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
+   {
+      rox_ehid_target_reset(db->_targets->data[idtarget]);
+   }
 
-   if (!ret) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   // Reset reference counter
+   for (idref = 0; idref < db->_fulllist->used; idref++)
+   {
+      db->_fulllist->data[idref].refcount = 0;
+   }
 
-   error = rox_dynvec_ehid_match_new(&ret->results, 10);
-   if (error)
+   rox_dynvec_ehid_match_reset(ehid_matcher->staged);
+   rox_dynvec_uint_reset(ehid_matcher->staged_buckets);
+
+   // Per point global matching
+   for (idcur = 0; idcur < detectedfeats->used; idcur++)
    {
-      rox_ehid_matcher_del(&ret);
-      return error;
+      cur = &(detectedfeats->data[idcur]);
+
+      error = rox_ehid_searchtree_lookup (ehid_matcher->results, db->_trees[cur->index], cur->Description);
+      if (error) continue;
+
+      for (idmatch = 0; idmatch < ehid_matcher->results->used; idmatch++)
+      {
+         idref = ehid_matcher->results->data[idmatch].dbid;
+         score = ehid_matcher->results->data[idmatch].score;
+
+         ref = &db->_fulllist->data[idref];
+         if (ref->dbid >= db->_targets->used) continue;
+
+         // If score is good enough, at least secondary match
+         if (score <= MIN_SCORE_MATCHING)
+         {
+            match.curid = idcur;
+            match.dbid = idref;
+            match.score = score;
+
+            // Compute offset for angles
+            cosdif = cur->dir.u * ref->dir.u + cur->dir.v * ref->dir.v;
+            sindif = cur->dir.u * ref->dir.v - cur->dir.v * ref->dir.u;
+            match.roterr = (Rox_Double) fast_atan2f2((Rox_Float) sindif, (Rox_Float) cosdif);
+            difangle = ROX_PI + match.roterr;
+            difangle = 18.0 * (difangle) / ROX_2PI;
+            binangle = (Rox_Uint) difangle;
+            if (binangle == 18) binangle = 0;
+
+            // Primary match if score <= 2, secondary match otherwise
+            bucket = (ref->dbid * 2 + (score > 2)) * 18 + binangle;
+
+            error = rox_dynvec_ehid_match_append(ehid_matcher->staged, &match);
+            ROX_ERROR_CHECK_TERMINATE ( error );
+
+            error = rox_dynvec_uint_append(ehid_matcher->staged_buckets, &bucket);
+            ROX_ERROR_CHECK_TERMINATE ( error );
+
+            // Increase db reference count
+            ref->refcount++;
+         }
+      }
    }
 
-   ret->max_templates_per_query = max_templates_detected;
+   // The lookup errors of single features are not reported
+   error = ROX_ERROR_NONE;
 
-   *ehid_matcher = ret;
+   // Count the matches per bucket
+   error = rox_dynvec_uint_reserve(ehid_matcher->bucket_counts, nb_targets * 36 + 1);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-function_terminate:
-   return error;
-}
+   ehid_matcher->bucket_counts->used = nb_targets * 36;
+   memset(ehid_matcher->bucket_counts->data, 0, nb_targets * 36 * sizeof(Rox_Uint));
 
-Rox_ErrorCode rox_ehid_matcher_del(Rox_Ehid_Matcher * ehid_matcher)
-{
-   Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Ehid_Matcher todel = NULL;
+   for (idmatch = 0; idmatch < ehid_matcher->staged->used; idmatch++)
+   {
+      ehid_matcher->bucket_counts->data[ehid_matcher->staged_buckets->data[idmatch]]++;
+   }
 
-   if (!ehid_matcher)
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   // Reserve the buckets once, they keep their memory from frame to frame.
+   // The cleanup moves primary matches to the secondary bucket of the same viewpoint.
+   Rox_ErrorCode reserve_error = ROX_ERROR_NONE;
 
-   todel = *ehid_matcher;
-   *ehid_matcher = NULL;
+   ROX_EHID_MATCHER_PARALLEL_FOR
+   for (Rox_Sint id = 0; id < nb_targets; id++)
+   {
+      Rox_Ehid_Target target = db->_targets->data[id];
+      const Rox_Uint * counts = &ehid_matcher->bucket_counts->data[id * 36];
 
+      for (Rox_Sint idvp = 0; idvp < 18; idvp++)
+      {
+         Rox_ErrorCode lerror = ROX_ERROR_NONE;
 
-   if (!todel) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+         lerror = rox_dynvec_ehid_match_reserve(target->primarymatches[idvp], counts[idvp] + 1);
+         if (!lerror) lerror = rox_dynvec_ehid_match_reserve(target->secondarymatches[idvp], counts[idvp] + counts[18 + idvp] + 1);
+         if (lerror || !target->primarymatches[idvp]->data || !target->secondarymatches[idvp]->data) reserve_error = ROX_ERROR_NULL_POINTER;
+      }
+   }
 
-   rox_dynvec_ehid_match_del(&todel->results);
+   error = reserve_error;
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   rox_memory_delete(todel);
+   // Scatter the matches, in the order of the detected features
+   for (idmatch = 0; idmatch < ehid_matcher->staged->used; idmatch++)
+   {
+      bucket = ehid_matcher->staged_buckets->data[idmatch];
+
+      Rox_Ehid_Target target = db->_targets->data[bucket / 36];
+      Rox_DynVec_Ehid_Match vec = (bucket % 36 < 18) ? target->primarymatches[bucket % 18] : target->secondarymatches[bucket % 18];
+
+      vec->data[vec->used++] = ehid_matcher->staged->data[idmatch];
+   }
+
+   // Clean Up initial match list, the targets are independent
+   ROX_EHID_MATCHER_PARALLEL_FOR
+   for (Rox_Sint id = 0; id < nb_targets; id++)
+   {
+      rox_ehid_target_cleanup(db->_targets->data[id], detectedfeats, db->_fulllist);
+   }
 
 function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_ehid_matcher_estimate_poses (
+// Verify the candidate targets until max_found targets are found.
+// At each round, the targets are ranked by the votes of their best viewpoint and verified concurrently,
+// each one with its own ransac state. The verifications not started yet are skipped once enough targets are confirmed.
+// camera_calib is NULL to estimate homographies instead of poses.
+static Rox_ErrorCode rox_ehid_matcher_verify_targets (
    Rox_Ehid_Matcher ehid_matcher,
    Rox_Ehid_Database db,
    Rox_DynVec_Ehid_Point detectedfeats,
-   Rox_MatUT3 camera_calib
+   Rox_MatUT3 camera_calib,
+   const Rox_Uint max_found
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint idtarget;
-   Rox_Uint besttarget, besttargetcard;
-   Rox_Uint countfound;
+   Rox_Uint idtarget, idcand;
+   Rox_Uint countfound = 0;
 
+   const Rox_Sint nb_targets = (Rox_Sint) db->_targets->used;
 
-   if (!ehid_matcher || !detectedfeats) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
+   {
+      countfound += db->_targets->data[idtarget]->posefound;
+   }
 
    // Start pose estimation, looping through possible viewpoints
-   while (1)
+   while (countfound < db->_targets->used && countfound < max_found)
    {
-      besttarget = 0;
-      besttargetcard = 0;
-      countfound = 0;
+      // Compute viewpoints statistics per target
+      ROX_EHID_MATCHER_PARALLEL_FOR
+      for (Rox_Sint id = 0; id < nb_targets; id++)
+      {
+         rox_ehid_target_compute_stats(db->_targets->data[id]);
+      }
+
+      // Rank the targets with enough votes in their best viewpoint
+      rox_dynvec_slint_reset(ehid_matcher->candidates);
 
-      //Are all the target already found ?
       for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
       {
-         countfound += db->_targets->data[idtarget]->posefound;
+         Rox_Ehid_Target target = db->_targets->data[idtarget];
+         if (target->posefound || target->bestvpcard < MIN_VOTES_VERIFICATION) continue;
+
+         Rox_Slint key = ((Rox_Slint) target->bestvpcard << 32) | (Rox_Slint) (0xFFFFFFFFu - idtarget);
+         error = rox_dynvec_slint_append(ehid_matcher->candidates, &key);
+         ROX_ERROR_CHECK_TERMINATE ( error );
       }
-      if (countfound == db->_targets->used || countfound >= ehid_matcher->max_templates_per_query) break;
 
-      //Compute viewpoints statistics per target
-      for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
+      // If no best viewpoint has enough primary matches, it's time to exit
+      const Rox_Sint nb_candidates = (Rox_Sint) ehid_matcher->candidates->used;
+      if (nb_candidates == 0) break;
+
+      qsort(ehid_matcher->candidates->data, nb_candidates, sizeof(Rox_Slint), rox_ehid_matcher_compare_candidates);
+
+      error = rox_dynvec_uint_reserve(ehid_matcher->verified, nb_candidates + 1);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      ehid_matcher->verified->used = nb_candidates;
+
+      const Rox_Uint required = max_found - countfound;
+      Rox_Uint confirmed = 0;
+
+      ROX_EHID_MATCHER_PARALLEL_FOR
+      for (Rox_Sint id = 0; id < nb_candidates; id++)
       {
-         rox_ehid_target_compute_stats(db->_targets->data[idtarget]);
+         Rox_Ehid_Target target = db->_targets->data[0xFFFFFFFFu - (Rox_Uint) (ehid_matcher->candidates->data[id] & 0xFFFFFFFF)];
+         Rox_Uint skip = 0;
 
-         // Find best target
-         if (besttargetcard < db->_targets->data[idtarget]->bestvpcard)
+#ifdef ROX_USES_OPENMP
+         #pragma omp critical (rox_ehid_matcher)
+#endif
          {
-            besttarget = idtarget;
-            besttargetcard = db->_targets->data[idtarget]->bestvpcard;
+            skip = (confirmed >= required);
          }
-      }
 
-      // If the best viewpoint primary cardinality is less than 6, it's time to exit
-      if (besttargetcard < 6) break;
+         ehid_matcher->verified->data[id] = !skip;
+         if (skip) continue;
 
-      rox_ehid_target_estimate_pose(db->_targets->data[besttarget], detectedfeats, db->_fulllist, camera_calib);
+         if (camera_calib)
+         {
+            rox_ehid_target_estimate_pose(target, detectedfeats, db->_fulllist, camera_calib);
+         }
+         else
+         {
+            rox_ehid_target_estimate_homography(target, detectedfeats, db->_fulllist);
+         }
 
-      if (!db->_targets->data[besttarget]->posefound)
-      {
-         // Pose not found, erase viewpoint and neighboors
-         rox_ehid_target_ignorebestvp(db->_targets->data[besttarget]);
+         if (target->posefound)
+         {
+#ifdef ROX_USES_OPENMP
+            #pragma omp critical (rox_ehid_matcher)
+#endif
+            {
+               confirmed++;
+            }
+         }
       }
-      else
+
+      // Apply the outcomes in the rank order
+      for (idcand = 0; idcand < (Rox_Uint) nb_candidates; idcand++)
       {
-         // Pose found, all viewpoints of the target are to be ignored
-         rox_ehid_target_ignoreallvp(db->_targets->data[besttarget]);
+         if (!ehid_matcher->verified->data[idcand]) continue;
+
+         Rox_Ehid_Target target = db->_targets->data[0xFFFFFFFFu - (Rox_Uint) (ehid_matcher->candidates->data[idcand] & 0xFFFFFFFF)];
+
+         if (!target->posefound)
+         {
+            // Pose not found, erase viewpoint and neighboors
+            rox_ehid_target_ignorebestvp(target);
+         }
+         else if (countfound < max_found)
+         {
+            // Pose found, all viewpoints of the target are to be ignored
+            rox_ehid_target_ignoreallvp(target);
+            countfound++;
+         }
+         else
+         {
+            // Verified concurrently with the last required targets, but ranked after them
+            target->posefound = 0;
+         }
       }
    }
 
@@ -154,242 +324,157 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_ehid_matcher_estimate_homographies (
-   Rox_Ehid_Matcher ehid_matcher,
-   Rox_Ehid_Database db,
-   Rox_DynVec_Ehid_Point detectedfeats
-   )
+Rox_ErrorCode rox_ehid_matcher_new(Rox_Ehid_Matcher * ehid_matcher, Rox_Uint max_templates_detected)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint besttarget = 0;
-   Rox_Uint besttargetcard = 0;
-   Rox_Uint countfound = 0;
+   Rox_Ehid_Matcher ret = NULL;
 
 
-   if (!ehid_matcher || !detectedfeats) 
+   if (!ehid_matcher) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   // Start pose estimation, looping through possible viewpoints
+   *ehid_matcher = NULL;
 
-   while (1)
-   {
-      besttarget = 0;
-      besttargetcard = 0;
-      countfound = 0;
+   ret = (Rox_Ehid_Matcher)rox_memory_allocate(sizeof(struct Rox_Ehid_Matcher_Struct), 1);
 
-      // Are all the target already found ?
-      for (Rox_Uint idtarget = 0; idtarget < db->_targets->used; idtarget++)
-      {
-         countfound += db->_targets->data[idtarget]->posefound;
-      }
+   if (!ret) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-      if (countfound == db->_targets->used) break;
+   ret->results = NULL;
+   ret->staged = NULL;
+   ret->staged_buckets = NULL;
+   ret->bucket_counts = NULL;
+   ret->candidates = NULL;
+   ret->verified = NULL;
 
-      // Compute viewpoints statistics per target
-      for (Rox_Uint idtarget = 0; idtarget < db->_targets->used; idtarget++)
-      {
-         rox_ehid_target_compute_stats(db->_targets->data[idtarget]);
+   error = rox_dynvec_ehid_match_new(&ret->results, 10);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-         //Find best target
-         if (besttargetcard < db->_targets->data[idtarget]->bestvpcard)
-         {
-            besttarget = idtarget;
-            besttargetcard = db->_targets->data[idtarget]->bestvpcard;
-         }
-      }
+   error = rox_dynvec_ehid_match_new(&ret->staged, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-      // If the best viewpoint primary cardinality is less than 6, it's time to exit
-      if (besttargetcard < 6) break;
+   error = rox_dynvec_uint_new(&ret->staged_buckets, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-      rox_ehid_target_estimate_homography(db->_targets->data[besttarget], detectedfeats, db->_fulllist);
+   error = rox_dynvec_uint_new(&ret->bucket_counts, 360);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-      if (!db->_targets->data[besttarget]->posefound)
-      {
-         // Pose not found, erase viewpoint and neighboors
-         rox_ehid_target_ignorebestvp(db->_targets->data[besttarget]);
-      }
-      else
-      {
-         // Pose found, all viewpoints of the target are to be ignored
-         rox_ehid_target_ignoreallvp(db->_targets->data[besttarget]);
-      }
-   }
+   error = rox_dynvec_slint_new(&ret->candidates, 10);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->verified, 10);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   ret->max_templates_per_query = max_templates_detected;
+
+   *ehid_matcher = ret;
 
 function_terminate:
+   if (error) rox_ehid_matcher_del(&ret);
    return error;
 }
 
-Rox_ErrorCode rox_ehid_matcher_match_se3 (
-   Rox_Ehid_Matcher ehid_matcher,
-   Rox_Ehid_Database db,
-   Rox_DynVec_Ehid_Point detectedfeats,
-   Rox_MatUT3 camera_calib
-)
+Rox_ErrorCode rox_ehid_matcher_del(Rox_Ehid_Matcher * ehid_matcher)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint idcur, idref, idtarget, idmatch;
-   Rox_Ehid_Point  cur = NULL, ref = NULL;
-   Rox_Uint score;
-   Rox_Ehid_Match_Struct match;
-   Rox_Double difangle, cosdif, sindif;
-   Rox_Uint binangle;
-
+   Rox_Ehid_Matcher todel = NULL;
 
-   if (!ehid_matcher || !detectedfeats) 
+   if (!ehid_matcher)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   // Reset targets
-   for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
-   {
-      rox_ehid_target_reset(db->_targets->data[idtarget]);
-   }
-
-   // Reset reference counter
-   for (idref = 0; idref < db->_fulllist->used; idref++)
-   {
-      db->_fulllist->data[idref].refcount = 0;
-   }
-
-   // Per point global matching
-   for (idcur = 0; idcur < detectedfeats->used; idcur++)
-   {
-      cur = &(detectedfeats->data[idcur]);
+   todel = *ehid_matcher;
+   *ehid_matcher = NULL;
 
-      error = rox_ehid_searchtree_lookup (ehid_matcher->results, db->_trees[cur->index], cur->Description);
-      if (error) continue;
 
-      for (idmatch = 0; idmatch < ehid_matcher->results->used; idmatch++)
-      {
-         idref = ehid_matcher->results->data[idmatch].dbid;
-         score = ehid_matcher->results->data[idmatch].score;
+   if (!todel) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-         ref = &db->_fulllist->data[idref];
-         if (ref->dbid >= db->_targets->used) continue;
+   rox_dynvec_ehid_match_del(&todel->results);
+   rox_dynvec_ehid_match_del(&todel->staged);
+   rox_dynvec_uint_del(&todel->staged_buckets);
+   rox_dynvec_uint_del(&todel->bucket_counts);
+   rox_dynvec_slint_del(&todel->candidates);
+   rox_dynvec_uint_del(&todel->verified);
 
-         //If score is good enough, at least secondary match
-         if (score <= MIN_SCORE_MATCHING)
-         {
-            match.curid = idcur;
-            match.dbid = idref;
-            match.score = score;
+   rox_memory_delete(todel);
 
-            //Compute offset for angles
-            cosdif = cur->dir.u * ref->dir.u + cur->dir.v * ref->dir.v;
-            sindif = cur->dir.u * ref->dir.v - cur->dir.v * ref->dir.u;
-            match.roterr = (Rox_Double) fast_atan2f2((Rox_Float) sindif, (Rox_Float) cosdif);
-            difangle = ROX_PI + match.roterr;
-            difangle = 18.0 * (difangle) / ROX_2PI;
-            binangle = (Rox_Uint)difangle;
-            if (binangle == 18) binangle = 0;
+function_terminate:
+   return error;
+}
 
-            //Store primary match
-            if (score <= 2)
-            {
-               rox_dynvec_ehid_match_append(db->_targets->data[ref->dbid]->primarymatches[binangle], &match);
-            }
-            else //Store secondary match
-            {
-               rox_dynvec_ehid_match_append(db->_targets->data[ref->dbid]->secondarymatches[binangle], &match);
-            }
+Rox_ErrorCode rox_ehid_matcher_estimate_poses (
+   Rox_Ehid_Matcher ehid_matcher,
+   Rox_Ehid_Database db,
+   Rox_DynVec_Ehid_Point detectedfeats,
+   Rox_MatUT3 camera_calib
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-            //Increase db reference count
-            ref->refcount++;
-         }
-      }
-   }
 
-   // Clean Up initial match list
-   for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
-   {
-      rox_ehid_target_cleanup(db->_targets->data[idtarget], detectedfeats, db->_fulllist);
-   }
+   if (!ehid_matcher || !detectedfeats || !db || !camera_calib) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   error = rox_ehid_matcher_estimate_poses(ehid_matcher, db, detectedfeats, camera_calib);
+   error = rox_ehid_matcher_verify_targets(ehid_matcher, db, detectedfeats, camera_calib, ehid_matcher->max_templates_per_query);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_ehid_matcher_match_sl3(Rox_Ehid_Matcher ehid_matcher, Rox_Ehid_Database db, Rox_DynVec_Ehid_Point detectedfeats)
+Rox_ErrorCode rox_ehid_matcher_estimate_homographies (
+   Rox_Ehid_Matcher ehid_matcher,
+   Rox_Ehid_Database db,
+   Rox_DynVec_Ehid_Point detectedfeats
+   )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint idcur, idref, idtarget, idmatch;
-   Rox_Ehid_Point  cur = NULL, ref = NULL;
-   Rox_Uint score;
-   Rox_Ehid_Match_Struct match;
-   Rox_Double difangle, cosdif, sindif;
-   Rox_Uint binangle;
 
 
    if (!ehid_matcher || !detectedfeats || !db) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   // Reset targets
-   for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
-   {
-      rox_ehid_target_reset(db->_targets->data[idtarget]);
-   }
+   // All the targets are searched
+   error = rox_ehid_matcher_verify_targets(ehid_matcher, db, detectedfeats, NULL, db->_targets->used);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Reset reference counter
-   for (idref = 0; idref < db->_fulllist->used; idref++)
-   {
-      db->_fulllist->data[idref].refcount = 0;
-   }
+function_terminate:
+   return error;
+}
 
-   // Per point global matching
-   for (idcur = 0; idcur < detectedfeats->used; idcur++)
-   {
-      cur = &(detectedfeats->data[idcur]);
+Rox_ErrorCode rox_ehid_matcher_match_se3 (
+   Rox_Ehid_Matcher ehid_matcher,
+   Rox_Ehid_Database db,
+   Rox_DynVec_Ehid_Point detectedfeats,
+   Rox_MatUT3 camera_calib
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-      error = rox_ehid_searchtree_lookup(ehid_matcher->results, db->_trees[cur->index], cur->Description);
-      if (error) continue;
 
-      for (idmatch = 0; idmatch < ehid_matcher->results->used; idmatch++)
-      {
-         idref = ehid_matcher->results->data[idmatch].dbid;
-         score = ehid_matcher->results->data[idmatch].score;
+   if (!ehid_matcher || !detectedfeats || !db) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-         ref = &db->_fulllist->data[idref];
-         if (ref->dbid >= db->_targets->used) continue;
+   error = rox_ehid_matcher_dispatch_matches(ehid_matcher, db, detectedfeats);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-         // If score is good enough, at least secondary match
-         if (score <= MIN_SCORE_MATCHING)
-         {
-            match.curid = idcur;
-            match.dbid = idref;
-            match.score = score;
+   error = rox_ehid_matcher_estimate_poses(ehid_matcher, db, detectedfeats, camera_calib);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-            //Compute offset for angles
-            cosdif = cur->dir.u * ref->dir.u + cur->dir.v * ref->dir.v;
-            sindif = cur->dir.u * ref->dir.v - cur->dir.v * ref->dir.u;
-            match.roterr = (Rox_Double) fast_atan2f2((Rox_Float) sindif, (Rox_Float) cosdif);
-            difangle = ROX_PI + match.roterr;
-            difangle = 18.0 * (difangle) / ROX_2PI;
-            binangle = (Rox_Uint) difangle;
-            if (binangle == 18) binangle = 0;
+function_terminate:
+   return error;
+}
 
-            // Store primary match
-            if (score <= 2)
-            {
-               rox_dynvec_ehid_match_append(db->_targets->data[ref->dbid]->primarymatches[binangle], &match);
-            }
-            else // Store secondary match
-            {
-               rox_dynvec_ehid_match_append(db->_targets->data[ref->dbid]->secondarymatches[binangle], &match);
-            }
+Rox_ErrorCode rox_ehid_matcher_match_sl3(Rox_Ehid_Matcher ehid_matcher, Rox_Ehid_Database db, Rox_DynVec_Ehid_Point detectedfeats)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-            // Increase db reference count
-            ref->refcount++;
-         }
-      }
-   }
 
-   // Clean Up initial match list
-   for (idtarget = 0; idtarget < db->_targets->used; idtarget++)
-   {
-      rox_ehid_target_cleanup(db->_targets->data[idtarget], detectedfeats, db->_fulllist);
-   }
+   if (!ehid_matcher || !detectedfeats || !db) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_ehid_matcher_dispatch_matches(ehid_matcher, db, detectedfeats);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
    error = rox_ehid_matcher_estimate_homographies(ehid_matcher, db, detectedfeats);
    ROX_ERROR_CHECK_TERMINATE ( error );
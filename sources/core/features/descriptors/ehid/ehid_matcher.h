@@ -73,6 +73,17 @@ ROX_API Rox_ErrorCode rox_ehid_matcher_match_sl3 (
    const Rox_DynVec_Ehid_Point detectedfeats
 );
 
+//! Match the detected features with the database and dispatch the matches in the viewpoint buckets of the targets
+//! \param  [out]  ehid_matcher   The matcher object
+//! \param  [in ]  db             The database to search on, its targets receive the matches
+//! \param  [in ]  detectedfeats  The list of runtime features
+//! \return An error code
+ROX_API Rox_ErrorCode rox_ehid_matcher_dispatch_matches (
+   Rox_Ehid_Matcher ehid_matcher, 
+   Rox_Ehid_Database db, 
+   Rox_DynVec_Ehid_Point detectedfeats
+);
+
 //! @} 
 
 #endif
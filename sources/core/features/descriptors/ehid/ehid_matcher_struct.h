@@ -19,9 +19,12 @@
 #include <core/features/descriptors/ehid/ehid_database.h>
 #include <generated/objset_ehid_target.h>
 #include <generated/dynvec_uint.h>
+#include <generated/dynvec_slint.h>
 #include <generated/dynvec_ehid_dbindex.h>
 
 #include <generated/dynvec_ehid_match_struct.h>
+#include <generated/dynvec_uint_struct.h>
+#include <generated/dynvec_slint_struct.h>
 
 //! \addtogroup EHID
 //! @{
@@ -34,6 +37,21 @@ struct Rox_Ehid_Matcher_Struct
 
    //! How many templates we need to find per processing 
    Rox_Uint max_templates_per_query;
+
+   //! The matches of a frame before their dispatch in the buckets of the targets
+   Rox_DynVec_Ehid_Match staged;
+
+   //! The bucket of each staged match: (target * 2 + secondary) * 18 + viewpoint
+   Rox_DynVec_Uint staged_buckets;
+
+   //! The number of staged matches per bucket
+   Rox_DynVec_Uint bucket_counts;
+
+   //! The candidate targets ranked by votes in their best viewpoint
+   Rox_DynVec_Slint candidates;
+
+   //! Was each candidate verified during the last round
+   Rox_DynVec_Uint verified;
 };
 
 //! @} 
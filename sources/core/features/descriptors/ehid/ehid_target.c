@@ -35,6 +35,13 @@
 #include <inout/system/print.h>
 #include <inout/system/errors_print.h>
 
+// Same generator as rox_rand, on the state of the target
+static Rox_Uint rox_ehid_target_rand(Rox_Ehid_Target ehid_target)
+{
+   ehid_target->seed = (ehid_target->seed * 1103515245 + 12345) & ROX_RAND_MAX;
+   return ehid_target->seed;
+}
+
 Rox_ErrorCode rox_ehid_target_new(Rox_Ehid_Target * ehid_target)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -74,6 +81,7 @@ Rox_ErrorCode rox_ehid_target_new(Rox_Ehid_Target * ehid_target)
    ret->best_homography = 0;
    ret->best_score_minimization = 0;
    ret->best_score_p3p = 0;
+   ret->seed = 1;
    ret->used_cur = 0;
 
    for ( Rox_Sint idvp = 0; idvp < 18; idvp++)
@@ -170,6 +178,9 @@ Rox_ErrorCode rox_ehid_target_reset(Rox_Ehid_Target ehid_target)
 
    ehid_target->posefound = 0;
 
+   // Draw the seed of the ransac from the global generator
+   ehid_target->seed = (Rox_Uint) rox_rand();
+
    for ( Rox_Sint idvp = 0; idvp < 18; idvp++)
    {
       rox_dynvec_ehid_match_reset(ehid_target->primarymatches[idvp]);
@@ -909,7 +920,7 @@ Rox_ErrorCode rox_ehid_target_estimate_pose (
    {
       // Choose randomly a seed point among primary matches
       // No constraint on the first point as it is alone
-      idmatch1 = rox_rand() % primary->used;
+      idmatch1 = rox_ehid_target_rand(ehid_target) % primary->used;
       curpt1 = &detectedfeats->data[primary->data[idmatch1].curid];
       refpt1 = &globaldb->data[primary->data[idmatch1].dbid];
 
@@ -923,7 +934,7 @@ Rox_ErrorCode rox_ehid_target_estimate_pose (
       for (iter_levelx = 0; iter_levelx < max_trials_levelx; iter_levelx++)
       {
          // Choose randomly a second point among primary matches
-         idmatch2 = rox_rand() % primary->used;
+         idmatch2 = rox_ehid_target_rand(ehid_target) % primary->used;
          if (idmatch2 == idmatch1) continue;
          curpt2 = &detectedfeats->data[primary->data[idmatch2].curid];
          refpt2 = &globaldb->data[primary->data[idmatch2].dbid];
@@ -970,7 +981,7 @@ Rox_ErrorCode rox_ehid_target_estimate_pose (
       for (iter_levelx = 0; iter_levelx < max_trials_levelx; iter_levelx++)
       {
          // Choose randomly a second point among primary matches
-         idmatch3 = rox_rand() % primary->used;
+         idmatch3 = rox_ehid_target_rand(ehid_target) % primary->used;
          if (idmatch3 == idmatch1 || idmatch3 == idmatch2) continue;
          curpt3 = &detectedfeats->data[primary->data[idmatch3].curid];
          refpt3 = &globaldb->data[primary->data[idmatch3].dbid];
@@ -1152,7 +1163,7 @@ Rox_ErrorCode rox_ehid_target_estimate_homography(Rox_Ehid_Target ehid_target, R
    {
       // Choose randomly a seed point among primary matches
       // No constraint on the first point as it is alone
-      idmatch1 = rox_rand() % primary->used;
+      idmatch1 = rox_ehid_target_rand(ehid_target) % primary->used;
       curpt1 = &detectedfeats->data[primary->data[idmatch1].curid];
       refpt1 = &globaldb->data[primary->data[idmatch1].dbid];
 
@@ -1166,7 +1177,7 @@ Rox_ErrorCode rox_ehid_target_estimate_homography(Rox_Ehid_Target ehid_target, R
       for (iter_levelx = 0; iter_levelx < max_trials_levelx; iter_levelx++)
       {
          // Choose randomly a second point among primary matches
-         idmatch2 = rox_rand() % primary->used;
+         idmatch2 = rox_ehid_target_rand(ehid_target) % primary->used;
          if (idmatch2 == idmatch1) continue;
          curpt2 = &detectedfeats->data[primary->data[idmatch2].curid];
          refpt2 = &globaldb->data[primary->data[idmatch2].dbid];
@@ -1213,7 +1224,7 @@ Rox_ErrorCode rox_ehid_target_estimate_homography(Rox_Ehid_Target ehid_target, R
       for (iter_levelx = 0; iter_levelx < max_trials_levelx; iter_levelx++)
       {
          // Choose randomly a second point among primary matches
-         idmatch3 = rox_rand() % primary->used;
+         idmatch3 = rox_ehid_target_rand(ehid_target) % primary->used;
          if (idmatch3 == idmatch1 || idmatch3 == idmatch2) continue;
          curpt3 = &detectedfeats->data[primary->data[idmatch3].curid];
          refpt3 = &globaldb->data[primary->data[idmatch3].dbid];
@@ -1263,7 +1274,7 @@ Rox_ErrorCode rox_ehid_target_estimate_homography(Rox_Ehid_Target ehid_target, R
       for (iter_levelx = 0; iter_levelx < max_trials_levelx; iter_levelx++)
       {
          // Choose randomly a second point among primary matches
-         idmatch4 = rox_rand() % primary->used;
+         idmatch4 = rox_ehid_target_rand(ehid_target) % primary->used;
          if (idmatch4 == idmatch1 || idmatch4 == idmatch2 || idmatch4 == idmatch3) continue;
          curpt4 = &detectedfeats->data[primary->data[idmatch4].curid];
          refpt4 = &globaldb->data[primary->data[idmatch4].dbid];
@@ -55,6 +55,9 @@ struct Rox_Ehid_Target_Struct
    //! Best last score after minimization
    Rox_Double best_score_minimization;
 
+   //! State of the random draws of the ransac, owned by the target so that targets are verified concurrently
+   Rox_Uint seed;
+
    //! List of primary matches per viewpoints
    Rox_DynVec_Ehid_Match primarymatches[18];
 
@@ -34,6 +34,7 @@
 #include <core/features/detectors/segment/fastst_score.h>
 #include <core/features/descriptors/ehid/ehid.h>
 #include <core/features/descriptors/ehid/ehid_window.h>
+#include <system/memory/arena.h>
 
 #include <inout/system/print.h>
 #include <inout/system/errors_print.h>
@@ -318,7 +319,7 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_ehid_viewpointbin_process (
+static Rox_ErrorCode rox_ehid_viewpointbin_process_scoped (
    Rox_Ehid_ViewpointBin obj, 
    const Rox_Image image
 )
@@ -488,6 +489,21 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_ehid_viewpointbin_process(Rox_Ehid_ViewpointBin obj, const Rox_Image image)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   // The grids and images of the synthetic views are temporaries of the scratch arena, each view reuses the memory of the previous one
+   error = rox_arena_scope_begin("ehid_viewpointbin_process");
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_ehid_viewpointbin_process_scoped(obj, image);
+   rox_arena_scope_end();
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_ehid_viewpointbin_test(Rox_Sint * pcount, Rox_Sint * pcount_total, Rox_Ehid_ViewpointBin obj, Rox_Image source)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -15,6 +15,7 @@
 #include "fpsm_index.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <baseproc/maths/maths_macros.h>
 #include <float.h>
 
@@ -27,6 +28,10 @@
 #include <generated/dynvec_fpsm_template_struct.h>
 
 #include <inout/system/print.h>
+
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
 #include <inout/system/errors_print.h>
 
 //#define FPSM_INDEX_DEBUG 1
@@ -47,14 +52,31 @@ Rox_ErrorCode rox_fpsm_index_new(Rox_Fpsm_Index *obj, Rox_Uint nd, Rox_Uint nthe
    ret->m = m;
    ret->width = width;
    ret->height = height;
-   ret->index = NULL;
-   ret->counters = NULL;
+   ret->maxdist = 0;
+   ret->postings = NULL;
+   ret->views = NULL;
+   ret->signatures = NULL;
+   ret->free_slots = NULL;
+   ret->object_views = NULL;
+   ret->votes = NULL;
+   ret->touched_views = NULL;
+   ret->object_votes = NULL;
+   ret->object_best = NULL;
+   ret->touched_objects = NULL;
    ret->results = NULL;
    ret->min_votes = min_votes;
 
-   CHECK_ERROR_TERMINATE(rox_objset_dynvec_fpsm_template_new(&ret->index, 10));
+   CHECK_ERROR_TERMINATE(rox_objset_dynvec_sint_new(&ret->postings, 10));
+   CHECK_ERROR_TERMINATE(rox_dynvec_fpsm_template_new(&ret->views, 100));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->signatures, 1000));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->free_slots, 10));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->object_views, 10));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->votes, 100));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->touched_views, 100));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->object_votes, 10));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->object_best, 10));
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&ret->touched_objects, 10));
    CHECK_ERROR_TERMINATE(rox_dynvec_fpsm_template_new(&ret->results, 10));
-   CHECK_ERROR_TERMINATE(rox_objset_dynvec_sint_new(&ret->counters, 10));
 
    *obj = ret;
 
@@ -76,8 +98,16 @@ Rox_ErrorCode rox_fpsm_index_del(Rox_Fpsm_Index *obj)
 
    if (!todel) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
 
-   rox_objset_dynvec_fpsm_template_del(&todel->index);
-   rox_objset_dynvec_sint_del(&todel->counters);
+   rox_objset_dynvec_sint_del(&todel->postings);
+   rox_dynvec_fpsm_template_del(&todel->views);
+   rox_dynvec_sint_del(&todel->signatures);
+   rox_dynvec_sint_del(&todel->free_slots);
+   rox_dynvec_sint_del(&todel->object_views);
+   rox_dynvec_sint_del(&todel->votes);
+   rox_dynvec_sint_del(&todel->touched_views);
+   rox_dynvec_sint_del(&todel->object_votes);
+   rox_dynvec_sint_del(&todel->object_best);
+   rox_dynvec_sint_del(&todel->touched_objects);
    rox_dynvec_fpsm_template_del(&todel->results);
    rox_memory_delete(todel);
 
@@ -88,29 +118,32 @@ function_terminate:
 Rox_ErrorCode rox_fpsm_index_init(Rox_Fpsm_Index obj)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_DynVec_Fpsm_Template toadd = NULL;
+   Rox_DynVec_Sint toadd = NULL;
 
    if (!obj) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
 
    obj->maxdist = 0;
-   rox_objset_dynvec_fpsm_template_reset(obj->index);
-   rox_objset_dynvec_sint_reset(obj->counters);
+   rox_objset_dynvec_sint_reset(obj->postings);
+   rox_dynvec_fpsm_template_reset(obj->views);
+   rox_dynvec_sint_reset(obj->signatures);
+   rox_dynvec_sint_reset(obj->free_slots);
+   rox_dynvec_sint_reset(obj->object_views);
+   rox_dynvec_sint_reset(obj->votes);
+   rox_dynvec_sint_reset(obj->touched_views);
+   rox_dynvec_sint_reset(obj->object_votes);
+   rox_dynvec_sint_reset(obj->object_best);
+   rox_dynvec_sint_reset(obj->touched_objects);
+   rox_dynvec_fpsm_template_reset(obj->results);
 
-   for (Rox_Uint i = 0; i < obj->nd; i++)
+   for (Rox_Uint i = 0; i < obj->nd * obj->ntheta * obj->m; i++)
    {
-      for (Rox_Uint j = 0; j < obj->ntheta; j++)
-      {
-         for (Rox_Uint k = 0; k < obj->m; k++)
-         {
-            CHECK_ERROR_TERMINATE(rox_dynvec_fpsm_template_new(&toadd, 10));
-            CHECK_ERROR_TERMINATE(rox_objset_dynvec_fpsm_template_append(obj->index, toadd));
-            toadd = NULL;
-         }
-      }
+      CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&toadd, 16));
+      CHECK_ERROR_TERMINATE(rox_objset_dynvec_sint_append(obj->postings, toadd));
+      toadd = NULL;
    }
 
 function_terminate:
-   rox_dynvec_fpsm_template_del(&toadd);
+   rox_dynvec_sint_del(&toadd);
 
    return error;
 }
@@ -122,32 +155,110 @@ Rox_Sint compute_pos(Rox_Sint idcell, Rox_Double angle, Rox_Double dist, Rox_Sin
    angle = (angle + ROX_PI) / (2 * ROX_PI); //beween 0 and 1
    angle = angle * nbr_angles;
    iangle = (Rox_Sint)angle;
-   if (iangle >= nbr_angles) iangle = 0;
+   if (iangle >= nbr_angles || iangle < 0) iangle = 0;
 
-   dist = dist / max_dist; //between 0 and 1;
-   dist = dist * nbr_dist;
-   idist = (Rox_Sint)dist;
-   if (idist >= nbr_dist) idist = nbr_dist - 1;
+   idist = 0;
+   if (max_dist > 0)
+   {
+      dist = dist / max_dist; //between 0 and 1;
+      dist = dist * nbr_dist;
+      idist = (Rox_Sint)dist;
+      if (idist >= nbr_dist) idist = nbr_dist - 1;
+   }
 
    pos = idcell * nbr_dist * nbr_angles + idist * nbr_angles + iangle;
 
    return pos;
 }
 
+// Grow a vector of counters with zeros up to size
+static Rox_ErrorCode rox_fpsm_index_grow_zeros(Rox_DynVec_Sint vec, Rox_Uint size)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint zero = 0;
+
+   while (vec->used < size)
+   {
+      CHECK_ERROR_TERMINATE(rox_dynvec_sint_append(vec, &zero));
+   }
+
+function_terminate:
+   return error;
+}
+
+// Maximum distance of the cells of the views of an object
+static Rox_Double rox_fpsm_index_object_maxdist(Rox_DynVec_Fpsm_Feature features, Rox_Uint m)
+{
+   Rox_Double maxdist = 0;
+
+   for (Rox_Uint idfeat = 0; idfeat < features->used; idfeat++)
+   {
+      Rox_Fpsm_Feature_Struct * feat = &features->data[idfeat];
+
+      for (Rox_Uint idcell = 0; idcell < m; idcell++)
+      {
+         Rox_Double dist = (Rox_Double)feat->distances[idcell];
+         if (dist > maxdist)
+         {
+            maxdist = dist;
+         }
+      }
+   }
+
+   return maxdist;
+}
+
+Rox_ErrorCode rox_fpsm_index_set_maxdist(Rox_Fpsm_Index obj, Rox_DynVec_Fpsm_Feature * objects, Rox_Uint count)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double maxdist = 0;
+
+   if (!obj || !objects) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
+
+   // The signatures of the views already in the index would no longer match
+   if (obj->views->used > obj->free_slots->used) {error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE(error)}
+
+   for (Rox_Uint idobj = 0; idobj < count; idobj++)
+   {
+      if (!objects[idobj]) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
+
+      Rox_Double dist = rox_fpsm_index_object_maxdist(objects[idobj], obj->m);
+      if (dist > maxdist) maxdist = dist;
+   }
+
+   if (maxdist <= 0) {error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE(error)}
+
+   obj->maxdist = maxdist;
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_fpsm_index_append_object(Rox_Fpsm_Index obj, Rox_DynVec_Fpsm_Feature features, Rox_Uint object_id)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Sint idfeat, idcell;
    Rox_Fpsm_Feature_Struct * feat;
-   Rox_Double dist;
-   Rox_Sint pos;
-   Rox_Fpsm_Template_Struct templ;
-   Rox_DynVec_Sint lcounters;
+   Rox_Double maxdist;
+   Rox_DynVec_Sint lsignatures = NULL;
 
    if (!obj || !features) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
 
-   lcounters = NULL;
-   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&lcounters, 10));
+   if (obj->postings->used != obj->nd * obj->ntheta * obj->m) {error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE(error)}
+
+   // Without rox_fpsm_index_set_maxdist, the quantization is set by the first object so that signatures never change afterwards.
+   // This object must not be appended concurrently, otherwise the signatures would depend on the scheduling of the threads.
+   if (obj->maxdist <= 0)
+   {
+#ifdef ROX_USES_OPENMP
+      if (omp_in_parallel()) {error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE(error)}
+#endif
+      obj->maxdist = rox_fpsm_index_object_maxdist(features, obj->m);
+   }
+   maxdist = obj->maxdist;
+
+   // Signatures are computed outside of the critical section
+   CHECK_ERROR_TERMINATE(rox_dynvec_sint_new(&lsignatures, features->used * obj->m + 1));
 
    for (idfeat = 0; idfeat < (Rox_Sint)features->used; idfeat++)
    {
@@ -155,100 +266,194 @@ Rox_ErrorCode rox_fpsm_index_append_object(Rox_Fpsm_Index obj, Rox_DynVec_Fpsm_F
 
       for (idcell = 0; idcell < (Rox_Sint)obj->m; idcell++)
       {
-         dist = (Rox_Double)feat->distances[idcell];
-         if (dist > obj->maxdist)
-         {
-            obj->maxdist = dist;
-         }
+         Rox_Sint pos = compute_pos(idcell, feat->angles[idcell], (Rox_Double)feat->distances[idcell], obj->nd, obj->ntheta, maxdist);
+         CHECK_ERROR_TERMINATE(rox_dynvec_sint_append(lsignatures, &pos));
       }
    }
 
-   templ.object_id = object_id;
-
-   for (idfeat = 0; idfeat < (Rox_Sint)features->used; idfeat++)
+#ifdef ROX_USES_OPENMP
+   #pragma omp critical (rox_fpsm_index)
+#endif
    {
-      feat = &features->data[idfeat];
+      Rox_ErrorCode lerror = ROX_ERROR_NONE;
 
-      templ.view_id = idfeat;
+      lerror = rox_fpsm_index_grow_zeros(obj->object_views, object_id + 1);
+      if (!lerror) lerror = rox_fpsm_index_grow_zeros(obj->object_votes, object_id + 1);
+      if (!lerror) lerror = rox_fpsm_index_grow_zeros(obj->object_best, object_id + 1);
 
-      for (idcell = 0; idcell < (Rox_Sint)obj->m; idcell++)
+      if (!lerror && obj->object_views->data[object_id] > 0) lerror = ROX_ERROR_INVALID_VALUE;
+
+      for (idfeat = 0; !lerror && idfeat < (Rox_Sint)features->used; idfeat++)
       {
-         templ.angle = feat->angles[idcell]/10000.0;//x1000 to avoid storing float
-         templ.dist = (Rox_Double)feat->distances[idcell];
-         pos = compute_pos(idcell, templ.angle, templ.dist, obj->nd, obj->ntheta, obj->maxdist);
+         Rox_Fpsm_Template_Struct templ;
+         Rox_Sint slot, zero = 0;
+
+         templ.object_id = object_id;
+         templ.view_id = idfeat;
+         templ.angle = 0;
+         templ.dist = 0;
+
+         if (obj->free_slots->used > 0)
+         {
+            obj->free_slots->used--;
+            slot = obj->free_slots->data[obj->free_slots->used];
+            obj->views->data[slot] = templ;
+         }
+         else
+         {
+            slot = obj->views->used;
+            lerror = rox_dynvec_fpsm_template_append(obj->views, &templ);
+            if (!lerror) lerror = rox_dynvec_sint_append(obj->votes, &zero);
+            if (!lerror) lerror = rox_dynvec_sint_usecells(obj->signatures, obj->m);
+         }
+
+         for (idcell = 0; !lerror && idcell < (Rox_Sint)obj->m; idcell++)
+         {
+            Rox_Sint pos = lsignatures->data[idfeat * obj->m + idcell];
+            obj->signatures->data[slot * obj->m + idcell] = pos;
+            lerror = rox_dynvec_sint_append(obj->postings->data[pos], &slot);
+         }
 
-         CHECK_ERROR_TERMINATE(rox_dynvec_fpsm_template_append(obj->index->data[pos], &templ));
+         if (!lerror) obj->object_views->data[object_id]++;
       }
 
-      CHECK_ERROR_TERMINATE(rox_dynvec_sint_append(lcounters, &idfeat));
+      error = lerror;
    }
+   ROX_ERROR_CHECK_TERMINATE(error);
 
-   CHECK_ERROR_TERMINATE(rox_objset_dynvec_sint_append(obj->counters, lcounters));
+function_terminate:
+   rox_dynvec_sint_del(&lsignatures);
 
-   lcounters = NULL;
+   return error;
+}
 
-function_terminate:
-   rox_dynvec_sint_del(&lcounters);
+Rox_ErrorCode rox_fpsm_index_remove_object(Rox_Fpsm_Index obj, Rox_Uint object_id)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!obj) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp critical (rox_fpsm_index)
+#endif
+   {
+      if (object_id >= obj->object_views->used || obj->object_views->data[object_id] == 0)
+      {
+         error = ROX_ERROR_INVALID_VALUE;
+      }
+      else
+      {
+         for (Rox_Sint slot = 0; slot < (Rox_Sint)obj->views->used && !error; slot++)
+         {
+            if (obj->views->data[slot].object_id != (Rox_Sint)object_id) continue;
+
+            // Remove the slot from the posting list of each cell, order of the lists does not matter
+            for (Rox_Uint idcell = 0; idcell < obj->m; idcell++)
+            {
+               Rox_DynVec_Sint list = obj->postings->data[obj->signatures->data[slot * obj->m + idcell]];
+
+               for (Rox_Uint id = 0; id < list->used; id++)
+               {
+                  if (list->data[id] == slot)
+                  {
+                     list->data[id] = list->data[list->used - 1];
+                     list->used--;
+                     break;
+                  }
+               }
+            }
+
+            obj->views->data[slot].object_id = -1;
+            error = rox_dynvec_sint_append(obj->free_slots, &slot);
+         }
 
+         obj->object_views->data[object_id] = 0;
+      }
+   }
+   ROX_ERROR_CHECK_TERMINATE(error);
+
+function_terminate:
    return error;
 }
 
+static int rox_fpsm_index_compare_sint(const void * a, const void * b)
+{
+   Rox_Sint va = *(const Rox_Sint *)a;
+   Rox_Sint vb = *(const Rox_Sint *)b;
+   return (va > vb) - (va < vb);
+}
+
 Rox_ErrorCode rox_fpsm_index_search(Rox_Fpsm_Index obj, Rox_Fpsm_Feature_Struct * feature)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_DynVec_Fpsm_Template templates;
    Rox_Fpsm_Template_Struct toadd;
 
    if (!obj || !feature) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error)}
 
    rox_dynvec_fpsm_template_reset(obj->results);
+   rox_dynvec_sint_reset(obj->touched_views);
+   rox_dynvec_sint_reset(obj->touched_objects);
 
-   for (Rox_Uint idobject = 0; idobject < obj->counters->used; idobject++)
-   {
-      Rox_DynVec_Sint lcounters = obj->counters->data[idobject];
+   if (obj->postings->used != obj->nd * obj->ntheta * obj->m) {error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE(error)}
 
-      for (Rox_Uint idview = 0; idview < lcounters->used; idview++)
-      {
-         lcounters->data[idview] = 0;
-      }
-   }
+   Rox_Sint * votes = obj->votes->data;
 
+   // Vote for the views sharing a signature with the query, only visited views are recorded
    for (Rox_Uint idcell = 0; idcell < obj->m; idcell++)
    {
-      Rox_Sint pos = compute_pos(idcell,  feature->angles[idcell], (Rox_Double)feature->distances[idcell], obj->nd, obj->ntheta, obj->maxdist);
-      templates = obj->index->data[pos];
+      Rox_Sint pos = compute_pos(idcell, feature->angles[idcell], (Rox_Double)feature->distances[idcell], obj->nd, obj->ntheta, obj->maxdist);
+      Rox_DynVec_Sint list = obj->postings->data[pos];
 
-      for (Rox_Uint idtmp = 0; idtmp < templates->used; idtmp++)
+      for (Rox_Uint id = 0; id < list->used; id++)
       {
-         Rox_Uint idobject = templates->data[idtmp].object_id;
-         Rox_Uint idview = templates->data[idtmp].view_id;
+         Rox_Sint slot = list->data[id];
 
-         obj->counters->data[idobject]->data[idview]++;
+         if (votes[slot]++ == 0)
+         {
+            CHECK_ERROR_TERMINATE(rox_dynvec_sint_append(obj->touched_views, &slot));
+         }
       }
    }
 
-   for (Rox_Uint idobject = 0; idobject < obj->counters->used; idobject++)
+   // Keep the best view of each object, ties are resolved with the highest view id
+   for (Rox_Uint id = 0; id < obj->touched_views->used; id++)
    {
-      Rox_DynVec_Sint lcounters = obj->counters->data[idobject];
-      Rox_Sint maxview = 0;
-      Rox_Sint maxcount = 0;
+      Rox_Sint slot = obj->touched_views->data[id];
+      Rox_Sint count = votes[slot];
+      Rox_Sint idobject = obj->views->data[slot].object_id;
+      Rox_Sint idview = obj->views->data[slot].view_id;
 
-      for (Rox_Uint idview = 0; idview < lcounters->used; idview++)
-      {
-         Rox_Sint count = lcounters->data[idview];
+      votes[slot] = 0;
 
-         if (count >= maxcount)
-         {
-            maxcount = count;
-            maxview = idview;
-         }
+      if (obj->object_votes->data[idobject] == 0)
+      {
+         CHECK_ERROR_TERMINATE(rox_dynvec_sint_append(obj->touched_objects, &idobject));
+         obj->object_votes->data[idobject] = count;
+         obj->object_best->data[idobject] = idview;
       }
+      else if (count > obj->object_votes->data[idobject] || (count == obj->object_votes->data[idobject] && idview > obj->object_best->data[idobject]))
+      {
+         obj->object_votes->data[idobject] = count;
+         obj->object_best->data[idobject] = idview;
+      }
+   }
+
+   qsort(obj->touched_objects->data, obj->touched_objects->used, sizeof(Rox_Sint), rox_fpsm_index_compare_sint);
+
+   for (Rox_Uint id = 0; id < obj->touched_objects->used; id++)
+   {
+      Rox_Sint idobject = obj->touched_objects->data[id];
+      Rox_Sint maxcount = obj->object_votes->data[idobject];
+
+      obj->object_votes->data[idobject] = 0;
 
       if (maxcount >= (Rox_Sint)obj->min_votes)
       {
          toadd.object_id = idobject;
-         toadd.view_id = maxview;
-         CHECK_ERROR_RETURN(rox_dynvec_fpsm_template_append(obj->results, &toadd));
+         toadd.view_id = obj->object_best->data[idobject];
+         toadd.angle = 0;
+         toadd.dist = 0;
+         CHECK_ERROR_TERMINATE(rox_dynvec_fpsm_template_append(obj->results, &toadd));
       }
 
 #ifdef FPSM_INDEX_DEBUG
@@ -23,11 +23,15 @@
 #include <generated/objset_dynvec_sint_struct.h>
 #include <generated/objset_dynvec_fpsm_template_struct.h>
 #include <generated/dynvec_fpsm_template_struct.h>
+#include <generated/dynvec_sint.h>
 
 //! \addtogroup FPSM
 //! @{
 
 //! The Rox_Fpsm_Index_Struct object 
+//! The index is an inverted index: each quantized cell signature (cell, distance bin, angle bin)
+//! owns a posting list of the view slots having this signature. A search only visits the
+//! posting lists of the query signatures, so its cost depends on the number of matching views.
 struct Rox_Fpsm_Index_Struct
 {
 	//! To be commented  
@@ -43,13 +47,31 @@ struct Rox_Fpsm_Index_Struct
 	//! To be commented  
 	Rox_Uint min_votes;
 
-	//! To be commented  
+	//! Maximum distance used to quantize distances, set by rox_fpsm_index_set_maxdist or by the first appended object
 	Rox_Double maxdist;
 
-	//! To be commented  
-	Rox_ObjSet_DynVec_Fpsm_Template index;
-	//! To be commented  
-	Rox_ObjSet_DynVec_Sint counters;
+	//! Posting lists of view slots, one per quantized cell signature (nd x ntheta x m lists)
+	Rox_ObjSet_DynVec_Sint postings;
+	//! Object and view identifiers of each view slot, object_id is -1 for a free slot
+	Rox_DynVec_Fpsm_Template views;
+	//! Signatures of the m cells of each view slot
+	Rox_DynVec_Sint signatures;
+	//! View slots released by removed objects
+	Rox_DynVec_Sint free_slots;
+	//! Number of views of each object identifier, 0 if the object is not in the index
+	Rox_DynVec_Sint object_views;
+
+	//! Votes of each view slot, kept to zero between searches
+	Rox_DynVec_Sint votes;
+	//! View slots which received votes during the search
+	Rox_DynVec_Sint touched_views;
+	//! Best vote of each object, kept to zero between searches
+	Rox_DynVec_Sint object_votes;
+	//! Best view of each object during the search
+	Rox_DynVec_Sint object_best;
+	//! Objects which received votes during the search
+	Rox_DynVec_Sint touched_objects;
+
 	//! To be commented  
 	Rox_DynVec_Fpsm_Template results;
 };
@@ -84,19 +106,35 @@ ROX_API Rox_ErrorCode rox_fpsm_index_del(Rox_Fpsm_Index * obj);
 //! \todo To be tested
 ROX_API Rox_ErrorCode rox_fpsm_index_init(Rox_Fpsm_Index obj);
 
-//! Append feature to index
+//! Set the maximum distance used to quantize distances from all the objects to append.
+//! Must be called before appending objects concurrently, and while the index has no view.
 //! \param[in] obj			The pointer to the object
-//! \param[in] features	The features
-//! \param[in] object_id The object ID
+//! \param[in] objects	The features of each object to append
+//! \param[in] count		The number of objects
+//! \return An error code
+ROX_API Rox_ErrorCode rox_fpsm_index_set_maxdist(Rox_Fpsm_Index obj, Rox_DynVec_Fpsm_Feature * objects, Rox_Uint count);
+
+//! Append the views of an object to index.
+//! Objects can be appended concurrently from several threads, but not during a search.
+//! If rox_fpsm_index_set_maxdist was not called, the first object sets the maximum distance and must be appended serially,
+//! otherwise ROX_ERROR_INVALID_VALUE is returned from a parallel region.
+//! \param[in] obj			The pointer to the object
+//! \param[in] features	The features, one per view
+//! \param[in] object_id The object ID, must not be already in the index
 //! \return An error code
-//! \todo To be tested
 ROX_API Rox_ErrorCode rox_fpsm_index_append_object(Rox_Fpsm_Index obj, Rox_DynVec_Fpsm_Feature features, Rox_Uint object_id);
 
-//! Append feature to index
+//! Remove the views of an object from index, its slots are reused by the next appended objects
+//! \param[in] obj			The pointer to the object
+//! \param[in] object_id The object ID
+//! \return An error code
+ROX_API Rox_ErrorCode rox_fpsm_index_remove_object(Rox_Fpsm_Index obj, Rox_Uint object_id);
+
+//! Search the best view of each object voting for a feature.
+//! Results are sorted by object ID, objects without any vote are not reported.
 //! \param[in] obj The pointer to the object
 //! \param[in] feature	The feature
 //! \return An error code
-//! \todo To be tested
 ROX_API Rox_ErrorCode rox_fpsm_index_search(Rox_Fpsm_Index obj, Rox_Fpsm_Feature_Struct * feature);
 
 //! @} 
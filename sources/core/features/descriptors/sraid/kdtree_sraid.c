@@ -60,6 +60,7 @@ Rox_ErrorCode rox_kdtree_sraid_new(Rox_Kdtree_Sraid * obj, Rox_Uint count_trees)
    ret->_roots = NULL;
    ret->_checked = NULL;
    ret->_heap = NULL;
+   ret->_stamp = 0;
    ret->_count_trees = count_trees;
 
    error = rox_dynvec_uint_new(&ret->_checked, 100);
@@ -358,6 +359,9 @@ Rox_ErrorCode rox_kdtree_sraid_build(Rox_Kdtree_Sraid obj, Rox_DynVec_SRAID_Feat
    error = rox_dynvec_uint_usecells(obj->_checked, obj->_count_leaves);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   memset(obj->_checked->data, 0, sizeof(Rox_Uint) * obj->_count_leaves);
+   obj->_stamp = 0;
+
    error = rox_heap_branch_new(&obj->_heap, obj->_count_leaves);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -384,7 +388,7 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_kdtree_sraid_search_node(Rox_SRAID_MatchResultSet results, Rox_Kdtree_Sraid_Node obj, Rox_DynVec_SRAID_Feature features, Rox_SRAID_Feature_Struct * feat, Rox_DynVec_Uint checked, Rox_Uint * checks, Rox_Uint maxchecks, Rox_Uint mindist, Rox_Heap_Branch heap)
+Rox_ErrorCode rox_kdtree_sraid_search_node(Rox_SRAID_MatchResultSet results, Rox_Kdtree_Sraid_Node obj, Rox_DynVec_SRAID_Feature features, Rox_SRAID_Feature_Struct * feat, Rox_Uint * checked, Rox_Uint stamp, Rox_Uint * checks, Rox_Uint maxchecks, Rox_Uint mindist, Rox_Heap_Branch heap)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Sint diff;
@@ -398,9 +402,9 @@ Rox_ErrorCode rox_kdtree_sraid_search_node(Rox_SRAID_MatchResultSet results, Rox
    if (obj->_child_left == NULL || obj->_child_right == NULL)
    {
       if (*checks >= maxchecks && rox_sraid_matchresultset_isfull(results)) {error = ROX_ERROR_NONE; goto function_terminate;}
-      if (checked->data[obj->_cut_index]) {error = ROX_ERROR_NONE; goto function_terminate;}
+      if (checked[obj->_cut_index] == stamp) {error = ROX_ERROR_NONE; goto function_terminate;}
 
-      checked->data[obj->_cut_index] = 1;
+      checked[obj->_cut_index] = stamp;
       *checks = (*checks) + 1;
 
       // Compute full distance between searched feature and indexed feature*/
@@ -429,11 +433,15 @@ Rox_ErrorCode rox_kdtree_sraid_search_node(Rox_SRAID_MatchResultSet results, Rox
    // Maybe considering only this dimensions guide us to a wrong subspace, keep the branch if needed in memory for more results
    dist = mindist + diff * diff;
 
-   error = rox_heap_branch_push(heap, other, dist);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // When the heap is full, the farthest branches are not explored again
+   if (heap->_count_elems < heap->_max_elems)
+   {
+      error = rox_heap_branch_push(heap, other, dist);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
    // Recurse using the best children*/
-   error = rox_kdtree_sraid_search_node(results, best, features, feat, checked, checks, maxchecks, mindist, heap);
+   error = rox_kdtree_sraid_search_node(results, best, features, feat, checked, stamp, checks, maxchecks, mindist, heap);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
@@ -441,42 +449,52 @@ function_terminate:
 }
 
 Rox_ErrorCode rox_kdtree_sraid_search(Rox_SRAID_MatchResultSet results, Rox_Kdtree_Sraid obj, Rox_DynVec_SRAID_Feature features, Rox_SRAID_Feature_Struct * feat)
+{
+   return rox_kdtree_sraid_search_checks(results, obj, features, feat, 32);
+}
+
+Rox_ErrorCode rox_kdtree_sraid_search_checks(Rox_SRAID_MatchResultSet results, Rox_Kdtree_Sraid obj, Rox_DynVec_SRAID_Feature features, Rox_SRAID_Feature_Struct * feat, Rox_Uint max_checks)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   const Rox_Uint max_checks = 32;
    Rox_Uint score;
    Rox_Uint checks;
    Rox_Kdtree_Sraid_Node node;
 
-   if (!obj || !features || !feat) 
+   if (!results || !obj || !features || !feat) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   if (!obj->_heap || features->used < obj->_count_leaves) 
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
    rox_sraid_matchresultset_clear(results);
    rox_heap_branch_reset(obj->_heap);
 
    checks = 0;
 
-   // Reset checked flags
-   memset(obj->_checked->data, 0, sizeof(Rox_Uint) * features->used);
+   // A new stamp marks the leaves checked by this search, flags are only cleared when the stamp wraps around
+   obj->_stamp++;
+   if (obj->_stamp == 0)
+   {
+      memset(obj->_checked->data, 0, sizeof(Rox_Uint) * obj->_count_leaves);
+      obj->_stamp = 1;
+   }
 
    // Try to find closest features for all trees
    for (Rox_Uint id_tree = 0; id_tree < obj->_count_trees; id_tree++)
    {
-      error = rox_kdtree_sraid_search_node(results, obj->_roots[id_tree], features, feat, obj->_checked, &checks, max_checks, 0, obj->_heap);
-      if (error) break;
+      error = rox_kdtree_sraid_search_node(results, obj->_roots[id_tree], features, feat, obj->_checked->data, obj->_stamp, &checks, max_checks, 0, obj->_heap);
+      ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
-   // Make some new trials based on potentially erroneous branching
-   error = rox_heap_branch_pop(obj->_heap, &node, &score);
-   while (error == ROX_ERROR_NONE && (rox_sraid_matchresultset_isfull(results) == 0 || checks < max_checks))
+   // Make some new trials based on potentially erroneous branching, until all the branches have been explored
+   while (obj->_heap->_count_elems > 0 && (rox_sraid_matchresultset_isfull(results) == 0 || checks < max_checks))
    {
-      error = rox_kdtree_sraid_search_node(results, node, features, feat, obj->_checked, &checks, max_checks, score, obj->_heap);
-      if (error) break;
-
       error = rox_heap_branch_pop(obj->_heap, &node, &score);
-   }
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_kdtree_sraid_search_node(results, node, features, feat, obj->_checked->data, obj->_stamp, &checks, max_checks, score, obj->_heap);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
 function_terminate:
    return error;
@@ -596,6 +614,9 @@ Rox_ErrorCode rox_kdtree_sraid_load(Rox_Kdtree_Sraid obj, char *filename)
    error = rox_dynvec_uint_usecells(obj->_checked, obj->_count_leaves);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   memset(obj->_checked->data, 0, sizeof(Rox_Uint) * obj->_count_leaves);
+   obj->_stamp = 0;
+
    error = rox_heap_branch_new(&obj->_heap, obj->_count_leaves);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -51,8 +51,10 @@ struct Rox_Kdtree_Sraid_Struct
 	Rox_Uint _count_trees;
 	//! count of trees leaves inside kdtre structure 
 	Rox_Uint _count_leaves;
-	//! Buffer 
+	//! Buffer: search stamp of the last visit of each leave
 	Rox_DynVec_Uint _checked;
+	//! Stamp of the current search
+	Rox_Uint _stamp;
 	//! Buffer 
 	Rox_Heap_Branch _heap;
 
@@ -98,6 +100,16 @@ ROX_API Rox_ErrorCode rox_kdtree_sraid_build(Rox_Kdtree_Sraid obj, Rox_DynVec_SR
 //! \todo to be tested
 ROX_API Rox_ErrorCode rox_kdtree_sraid_search(Rox_SRAID_MatchResultSet results, Rox_Kdtree_Sraid obj, Rox_DynVec_SRAID_Feature features, Rox_SRAID_Feature_Struct * feat);
 
+//! Search for features neighboors with a given number of leaves to check
+//! The search stops when the result set is full and max_checks leaves have been checked, or when all the leaves have been checked.
+//! \param [in] results the result set of closest features
+//! \param [in] obj the object  to search into
+//! \param [in] features the features to which are indexed in this tree
+//! \param [in] feat the feature to search for
+//! \param [in] max_checks the minimal number of leaves to check
+//! \return en error code
+ROX_API Rox_ErrorCode rox_kdtree_sraid_search_checks(Rox_SRAID_MatchResultSet results, Rox_Kdtree_Sraid obj, Rox_DynVec_SRAID_Feature features, Rox_SRAID_Feature_Struct * feat, Rox_Uint max_checks);
+
 //! Save the index to a file
 //! \param [in] obj the object  to save
 //! \param [in] filename the file name to save to
@@ -20,12 +20,7 @@
 #include <generated/dynvec_sraiddesc_struct.h>
 #include <generated/dynvec_point2d_float_struct.h>
 
-#include <baseproc/maths/kernels/gaussian2d.h>
-#include <baseproc/image/convolve/basic_convolve.h>
-#include <baseproc/image/convolve/array2d_float_symmetric_separable_convolve.h>
-#include <baseproc/image/pyramid/pyramid_tools.h>
-#include <baseproc/image/remap/remap_box_halved/remap_box_halved.h>
-#include <baseproc/geometry/rectangle/rectangle_struct.h>
+#include "sraid_workspace.h"
 
 #include <inout/system/errors_print.h>
 
@@ -42,19 +37,7 @@ Rox_ErrorCode rox_sraidpipeline_process (
   Rox_Uint                        object_id )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Array2D_Float buffer = NULL;
-   Rox_Array2D_Float filtered = NULL;
-   Rox_Float sigdiff;
-   Rox_Array2D_Float hfilter = NULL, vfilter = NULL, toresize = NULL;
-   Rox_Uint pyramidsize = 0;
-
-   Rox_Uint detectcount;
-   Rox_Float prelim_contrast;
-   Rox_Rect_Sint_Struct bounds;
-
-   Rox_Dog_Feature features = NULL;
-   Rox_Array2D_Float_Collection dogspace = NULL;
-   Rox_Array2D_Float_Collection scalespace = NULL;
+   Rox_SRAID_Workspace workspace = NULL;
 
    if (!sraid_output)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -66,90 +49,15 @@ Rox_ErrorCode rox_sraidpipeline_process (
    error = rox_array2d_float_get_size(&rows, &cols, input);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   if (cols < 32 || rows < 32)
-   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   bounds.x = 0;
-   bounds.y = 0;
-   bounds.height = rows;
-   bounds.width = cols;
-
-   error = rox_array2d_float_new(&buffer, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_float_new(&filtered, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   sraid_output->used = 0;
-   prelim_contrast = (Rox_Float) (0.5 * sraid_contr_thresh / sraid_invls);
-
-   // Initial image filtering
-   sigdiff = (Rox_Float) sqrt(sraid_sigma * sraid_sigma - sraid_initial_sigma * sraid_initial_sigma);
-
-   error = rox_kernelgen_gaussian2d_separable_float_new(&hfilter, &vfilter, sigdiff, cutoff);
+   // One shot workspace, callers processing many images of the same size should keep their own
+   error = rox_sraid_workspace_new(&workspace, rows, cols, sraid_max_octaves, sraid_sigma, cutoff, sraid_initial_sigma, sraid_invls);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_symmetric_seperable_convolve(filtered, input, hfilter);
+   error = rox_sraid_workspace_process(sraid_output, workspace, input, sraid_contr_thresh, sraid_curv_thresh, object_id);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   //  What is the optimal pyramid size
-   error = rox_pyramid_compute_optimal_level_count(&pyramidsize, cols, rows, 8);
-   if (error) pyramidsize = 0;
-   pyramidsize += 1; // original level = 1 more
-
-   if (pyramidsize > ((Rox_Uint) (sraid_max_octaves + 1)) && sraid_max_octaves >= 1)
-   {
-      pyramidsize = sraid_max_octaves;
-   }
-
-   // Loop over pyramid levels
-   for (Rox_Uint octave = 0; octave < pyramidsize; octave++)
-   {
-      // Create scale space for current image
-      error = rox_array2d_float_build_scale_space_new(&scalespace, filtered, sraid_invls, sraid_sigma, cutoff);
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      // Create dog space
-      error = rox_dogspace_create(&dogspace, scalespace);
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      // Detect features
-      error = rox_dogdetector_process(&features, &detectcount, dogspace, &bounds, sraid_contr_thresh, (Rox_Float) sraid_curv_thresh, prelim_contrast, sraid_invls, octave, sraid_sigma);
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      // describe features
-      error = rox_sraiddescriptor_process(sraid_output, features, detectcount, scalespace, object_id);
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      // Update size
-      cols = cols / 2;
-      rows = rows / 2;
-
-      // Create new "reference" image for next octave
-      rox_array2d_float_del(&filtered);
-      error = rox_array2d_float_new(&filtered, rows, cols);
-      ROX_ERROR_CHECK_TERMINATE(error)
-
-      toresize = rox_array2d_float_collection_get(scalespace, sraid_invls);
-      error = rox_remap_box_nomask_float_to_float_halved(filtered, toresize);
-      ROX_ERROR_CHECK_TERMINATE(error)
-
-      // Delete buffers
-      rox_memory_delete(features); features = NULL;
-      rox_array2d_float_collection_del(&dogspace);
-      rox_array2d_float_collection_del(&scalespace);
-   }
-
 function_terminate:
-   rox_array2d_float_del(&vfilter);
-   rox_array2d_float_del(&hfilter);
-
-   // DEBUG: problem when deleting NULL ?
-   rox_memory_delete(features);
-   rox_array2d_float_collection_del(&dogspace);
-   rox_array2d_float_collection_del(&scalespace);
-   rox_array2d_float_del(&buffer);
-   rox_array2d_float_del(&filtered);
+   rox_sraid_workspace_del(&workspace);
 
    return error;
 }
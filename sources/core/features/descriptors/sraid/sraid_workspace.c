@@ -0,0 +1,456 @@
+//==============================================================================
+//
+//    OPENROX   : File sraid_workspace.c
+//
+//    Contents  : Implementation of sraid_workspace module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "sraid_workspace.h"
+#include "sraiddesc.h"
+
+#include <math.h>
+
+#include <generated/dynvec_sraiddesc_struct.h>
+
+#include <baseproc/maths/kernels/gaussian2d.h>
+#include <baseproc/array/substract/substract.h>
+#include <baseproc/image/convolve/array2d_float_symmetric_separable_convolve.h>
+#include <baseproc/image/pyramid/pyramid_tools.h>
+#include <baseproc/image/remap/remap_box_halved/remap_box_halved.h>
+#include <baseproc/geometry/rectangle/rectangle_struct.h>
+
+#include <inout/system/errors_print.h>
+
+//! Number of image rows of a detection task
+#define ROX_SRAID_WORKSPACE_BAND 32
+
+//! Number of dog features of a description chunk
+#define ROX_SRAID_WORKSPACE_CHUNK 16
+
+Rox_ErrorCode rox_sraid_workspace_new (
+   Rox_SRAID_Workspace * workspace,
+   const Rox_Sint rows,
+   const Rox_Sint cols,
+   const Rox_Sint sraid_max_octaves,
+   const Rox_Float sraid_sigma,
+   const Rox_Float cutoff,
+   const Rox_Float sraid_initial_sigma,
+   const Rox_Sint sraid_invls
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_SRAID_Workspace ret = NULL;
+   Rox_Array2D_Float vfilter = NULL;
+
+   if (!workspace)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (cols < 32 || rows < 32)
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (sraid_invls < 1)
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_SRAID_Workspace) rox_memory_allocate(sizeof(*ret), 1);
+   if (!ret)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->rows = rows;
+   ret->cols = cols;
+   ret->invls = sraid_invls;
+   ret->sigma = sraid_sigma;
+   ret->count_octaves = 0;
+   ret->initial_kernel = NULL;
+   ret->level_kernels = NULL;
+   ret->scalespaces = NULL;
+   ret->dogspaces = NULL;
+   ret->count_tasks = 0;
+   ret->task_octave = NULL;
+   ret->task_slice = NULL;
+   ret->task_first_row = NULL;
+   ret->task_features = NULL;
+   ret->task_count = NULL;
+   ret->task_allocated = NULL;
+   ret->count_chunks = 0;
+   ret->allocated_chunks = 0;
+   ret->chunk_task = NULL;
+   ret->chunk_first = NULL;
+   ret->chunk_features = NULL;
+   ret->errors = NULL;
+
+   //  What is the optimal pyramid size
+   Rox_Uint pyramidsize = 0;
+   error = rox_pyramid_compute_optimal_level_count(&pyramidsize, cols, rows, 8);
+   if (error) pyramidsize = 0;
+   pyramidsize += 1; // original level = 1 more
+
+   if (pyramidsize > ((Rox_Uint) (sraid_max_octaves + 1)) && sraid_max_octaves >= 1)
+   {
+      pyramidsize = sraid_max_octaves;
+   }
+
+   // Initial image filtering
+   Rox_Float sigdiff = (Rox_Float) sqrt(sraid_sigma * sraid_sigma - sraid_initial_sigma * sraid_initial_sigma);
+
+   error = rox_kernelgen_gaussian2d_separable_float_new(&ret->initial_kernel, &vfilter, sigdiff, cutoff);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   rox_array2d_float_del(&vfilter);
+
+   // Kernels of the incremental blur chain, the same for all the octaves
+   const Rox_Uint levels = sraid_invls + 3;
+
+   ret->level_kernels = (Rox_Array2D_Float *) rox_memory_allocate(sizeof(Rox_Array2D_Float), levels);
+   if (!ret->level_kernels)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for (Rox_Uint i = 0; i < levels; i++) ret->level_kernels[i] = NULL;
+
+   Rox_Float k = (Rox_Float) pow( 2.0, 1.0 / sraid_invls );
+   for (Rox_Uint i = 1; i < levels; i++)
+   {
+      // See original lindeberg article for details on scale space computation
+      Rox_Float sigma_prev  = (Rox_Float) (pow( ( Rox_Double )k, ( int )i - 1 ) * sraid_sigma);
+      Rox_Float sigma_total = sigma_prev * k;
+      Rox_Float cur_sigma   = (Rox_Float) sqrt( sigma_total * sigma_total - sigma_prev * sigma_prev );
+
+      error = rox_kernelgen_gaussian2d_separable_float_new(&ret->level_kernels[i], &vfilter, cur_sigma, cutoff);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      rox_array2d_float_del(&vfilter);
+   }
+
+   // Scale and dog spaces of all the octaves
+   ret->scalespaces = (Rox_Array2D_Float_Collection *) rox_memory_allocate(sizeof(Rox_Array2D_Float_Collection), pyramidsize);
+   ret->dogspaces = (Rox_Array2D_Float_Collection *) rox_memory_allocate(sizeof(Rox_Array2D_Float_Collection), pyramidsize);
+   if (!ret->scalespaces || !ret->dogspaces)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for (Rox_Uint octave = 0; octave < pyramidsize; octave++)
+   {
+      ret->scalespaces[octave] = NULL;
+      ret->dogspaces[octave] = NULL;
+   }
+   ret->count_octaves = pyramidsize;
+
+   Rox_Sint octave_rows = rows, octave_cols = cols;
+   for (Rox_Uint octave = 0; octave < pyramidsize; octave++)
+   {
+      error = rox_array2d_float_collection_new(&ret->scalespaces[octave], levels, octave_rows, octave_cols);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_float_collection_new(&ret->dogspaces[octave], levels - 1, octave_rows, octave_cols);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      ret->count_tasks += sraid_invls * ((octave_rows + ROX_SRAID_WORKSPACE_BAND - 1) / ROX_SRAID_WORKSPACE_BAND);
+
+      octave_rows = octave_rows / 2;
+      octave_cols = octave_cols / 2;
+   }
+
+   // Detection tasks ordered by octave, slice and band, as a sequential detection
+   ret->task_octave = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), ret->count_tasks);
+   ret->task_slice = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), ret->count_tasks);
+   ret->task_first_row = (Rox_Sint *) rox_memory_allocate(sizeof(Rox_Sint), ret->count_tasks);
+   ret->task_features = (Rox_Dog_Feature *) rox_memory_allocate(sizeof(Rox_Dog_Feature), ret->count_tasks);
+   ret->task_count = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), ret->count_tasks);
+   ret->task_allocated = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), ret->count_tasks);
+   ret->errors = (Rox_ErrorCode *) rox_memory_allocate(sizeof(Rox_ErrorCode), ret->count_tasks + pyramidsize * levels);
+   if (!ret->task_octave || !ret->task_slice || !ret->task_first_row || !ret->task_features || !ret->task_count || !ret->task_allocated || !ret->errors)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Uint task = 0;
+   octave_rows = rows;
+   for (Rox_Uint octave = 0; octave < pyramidsize; octave++)
+   {
+      for (Rox_Uint slice = 1; slice <= (Rox_Uint) sraid_invls; slice++)
+      {
+         for (Rox_Sint first_row = 0; first_row < octave_rows; first_row += ROX_SRAID_WORKSPACE_BAND)
+         {
+            ret->task_octave[task] = octave;
+            ret->task_slice[task] = slice;
+            ret->task_first_row[task] = first_row;
+            ret->task_features[task] = NULL;
+            ret->task_count[task] = 0;
+            ret->task_allocated[task] = 0;
+            task++;
+         }
+      }
+      octave_rows = octave_rows / 2;
+   }
+
+   *workspace = ret;
+
+function_terminate:
+   if (error) rox_sraid_workspace_del(&ret);
+   return error;
+}
+
+Rox_ErrorCode rox_sraid_workspace_del (
+   Rox_SRAID_Workspace * workspace
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_SRAID_Workspace todel = NULL;
+
+   if (!workspace)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *workspace;
+   *workspace = NULL;
+
+   if (!todel)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (todel->initial_kernel) rox_array2d_float_del(&todel->initial_kernel);
+
+   if (todel->level_kernels)
+   {
+      for (Rox_Uint i = 0; i < todel->invls + 3; i++)
+      {
+         if (todel->level_kernels[i]) rox_array2d_float_del(&todel->level_kernels[i]);
+      }
+   }
+
+   for (Rox_Uint octave = 0; octave < todel->count_octaves; octave++)
+   {
+      if (todel->scalespaces[octave]) rox_array2d_float_collection_del(&todel->scalespaces[octave]);
+      if (todel->dogspaces[octave]) rox_array2d_float_collection_del(&todel->dogspaces[octave]);
+   }
+
+   if (todel->task_features)
+   {
+      for (Rox_Uint task = 0; task < todel->count_tasks; task++)
+      {
+         rox_memory_delete(todel->task_features[task]);
+      }
+   }
+
+   for (Rox_Uint chunk = 0; chunk < todel->allocated_chunks; chunk++)
+   {
+      rox_dynvec_sraiddesc_del(&todel->chunk_features[chunk]);
+   }
+
+   rox_memory_delete(todel->level_kernels);
+   rox_memory_delete(todel->scalespaces);
+   rox_memory_delete(todel->dogspaces);
+   rox_memory_delete(todel->task_octave);
+   rox_memory_delete(todel->task_slice);
+   rox_memory_delete(todel->task_first_row);
+   rox_memory_delete(todel->task_features);
+   rox_memory_delete(todel->task_count);
+   rox_memory_delete(todel->task_allocated);
+   rox_memory_delete(todel->chunk_task);
+   rox_memory_delete(todel->chunk_first);
+   rox_memory_delete(todel->chunk_features);
+   rox_memory_delete(todel->errors);
+   rox_memory_delete(todel);
+
+function_terminate:
+   return error;
+}
+
+// Make room for a given number of description chunks
+static Rox_ErrorCode rox_sraid_workspace_reserve_chunks ( Rox_SRAID_Workspace workspace, Rox_Uint count_chunks )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (count_chunks <= workspace->allocated_chunks) goto function_terminate;
+
+   Rox_Uint allocated = count_chunks + count_chunks / 2;
+   Rox_Uint * chunk_task = NULL, * chunk_first = NULL;
+   Rox_DynVec_SRAID_Feature * chunk_features = NULL;
+
+   // The chunk arrays are allocated by the first call which has features to describe
+   if (workspace->chunk_task)
+   {
+      chunk_task = (Rox_Uint *) rox_memory_reallocate(workspace->chunk_task, sizeof(Rox_Uint), allocated);
+      chunk_first = (Rox_Uint *) rox_memory_reallocate(workspace->chunk_first, sizeof(Rox_Uint), allocated);
+      chunk_features = (Rox_DynVec_SRAID_Feature *) rox_memory_reallocate(workspace->chunk_features, sizeof(Rox_DynVec_SRAID_Feature), allocated);
+   }
+   else
+   {
+      chunk_task = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), allocated);
+      chunk_first = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), allocated);
+      chunk_features = (Rox_DynVec_SRAID_Feature *) rox_memory_allocate(sizeof(Rox_DynVec_SRAID_Feature), allocated);
+   }
+
+   if (chunk_task) workspace->chunk_task = chunk_task;
+   if (chunk_first) workspace->chunk_first = chunk_first;
+   if (chunk_features) workspace->chunk_features = chunk_features;
+
+   Rox_ErrorCode * errors = (Rox_ErrorCode *) rox_memory_reallocate(workspace->errors, sizeof(Rox_ErrorCode), workspace->count_tasks + allocated);
+   if (errors) workspace->errors = errors;
+
+   if (!chunk_task || !chunk_first || !chunk_features || !errors)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for (Rox_Uint chunk = workspace->allocated_chunks; chunk < allocated; chunk++)
+   {
+      error = rox_dynvec_sraiddesc_new(&workspace->chunk_features[chunk], ROX_SRAID_WORKSPACE_CHUNK * 2);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      workspace->allocated_chunks = chunk + 1;
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_sraid_workspace_process (
+   Rox_DynVec_SRAID_Feature sraid_output,
+   Rox_SRAID_Workspace workspace,
+   const Rox_Array2D_Float input,
+   const Rox_Float sraid_contr_thresh,
+   const Rox_Sint sraid_curv_thresh,
+   const Rox_Uint object_id
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Rect_Sint_Struct bounds;
+
+   if (!sraid_output || !workspace || !input)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_array2d_float_check_size(input, workspace->rows, workspace->cols);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   bounds.x = 0;
+   bounds.y = 0;
+   bounds.height = workspace->rows;
+   bounds.width = workspace->cols;
+
+   sraid_output->used = 0;
+
+   const Rox_Uint invls = workspace->invls;
+   const Rox_Uint count_octaves = workspace->count_octaves;
+   const Rox_Float prelim_contrast = (Rox_Float) (0.5 * sraid_contr_thresh / invls);
+
+   // Incremental blur chain, each octave starts from the halved middle level of the previous one
+   for (Rox_Uint octave = 0; octave < count_octaves; octave++)
+   {
+      Rox_Array2D_Float_Collection scalespace = workspace->scalespaces[octave];
+      Rox_Array2D_Float base = rox_array2d_float_collection_get(scalespace, 0);
+
+      if (octave == 0)
+      {
+         error = rox_array2d_float_symmetric_seperable_convolve(base, input, workspace->initial_kernel);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+      else
+      {
+         Rox_Array2D_Float toresize = rox_array2d_float_collection_get(workspace->scalespaces[octave - 1], invls);
+         error = rox_remap_box_nomask_float_to_float_halved(base, toresize);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+
+      for (Rox_Uint i = 1; i < invls + 3; i++)
+      {
+         Rox_Array2D_Float one = rox_array2d_float_collection_get(scalespace, i - 1);
+         Rox_Array2D_Float two = rox_array2d_float_collection_get(scalespace, i);
+
+         error = rox_array2d_float_symmetric_seperable_convolve(two, one, workspace->level_kernels[i]);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+   }
+
+   // Dog spaces of all the octaves
+   const Rox_Sint count_dogs = count_octaves * (invls + 2);
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (Rox_Sint id = 0; id < count_dogs; id++)
+   {
+      Rox_Uint octave = id / (invls + 2);
+      Rox_Uint level = id % (invls + 2);
+
+      Rox_Array2D_Float res = rox_array2d_float_collection_get(workspace->dogspaces[octave], level);
+      Rox_Array2D_Float cur = rox_array2d_float_collection_get(workspace->scalespaces[octave], level);
+      Rox_Array2D_Float next = rox_array2d_float_collection_get(workspace->scalespaces[octave], level + 1);
+
+      workspace->errors[id] = rox_array2d_float_substract(res, next, cur);
+   }
+
+   for (Rox_Sint id = 0; id < count_dogs; id++)
+   {
+      error = workspace->errors[id];
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   // Extrema detection by octave, slice and band of rows
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (Rox_Sint task = 0; task < (Rox_Sint) workspace->count_tasks; task++)
+   {
+      Rox_Uint octave = workspace->task_octave[task];
+
+      workspace->task_count[task] = 0;
+      workspace->errors[task] = rox_dogdetector_process_band(&workspace->task_features[task], &workspace->task_count[task], &workspace->task_allocated[task], workspace->dogspaces[octave], workspace->task_slice[task], workspace->task_first_row[task], workspace->task_first_row[task] + ROX_SRAID_WORKSPACE_BAND, &bounds, sraid_contr_thresh, (Rox_Float) sraid_curv_thresh, prelim_contrast, invls, octave, workspace->sigma);
+   }
+
+   for (Rox_Uint task = 0; task < workspace->count_tasks; task++)
+   {
+      error = workspace->errors[task];
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   // Split the detected features in chunks, in the detection order
+   Rox_Uint count_chunks = 0;
+   for (Rox_Uint task = 0; task < workspace->count_tasks; task++)
+   {
+      count_chunks += (workspace->task_count[task] + ROX_SRAID_WORKSPACE_CHUNK - 1) / ROX_SRAID_WORKSPACE_CHUNK;
+   }
+
+   error = rox_sraid_workspace_reserve_chunks(workspace, count_chunks);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   workspace->count_chunks = 0;
+   for (Rox_Uint task = 0; task < workspace->count_tasks; task++)
+   {
+      for (Rox_Uint first = 0; first < workspace->task_count[task]; first += ROX_SRAID_WORKSPACE_CHUNK)
+      {
+         workspace->chunk_task[workspace->count_chunks] = task;
+         workspace->chunk_first[workspace->count_chunks] = first;
+         workspace->count_chunks++;
+      }
+   }
+
+   // Description of the chunks
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (Rox_Sint chunk = 0; chunk < (Rox_Sint) count_chunks; chunk++)
+   {
+      Rox_Uint task = workspace->chunk_task[chunk];
+      Rox_Uint first = workspace->chunk_first[chunk];
+      Rox_Uint count = workspace->task_count[task] - first;
+      if (count > ROX_SRAID_WORKSPACE_CHUNK) count = ROX_SRAID_WORKSPACE_CHUNK;
+
+      rox_dynvec_sraiddesc_reset(workspace->chunk_features[chunk]);
+      workspace->errors[chunk] = rox_sraiddescriptor_process(workspace->chunk_features[chunk], workspace->task_features[task] + first, count, workspace->scalespaces[workspace->task_octave[task]], object_id);
+   }
+
+   // Merge the chunks in a fixed order
+   for (Rox_Uint chunk = 0; chunk < count_chunks; chunk++)
+   {
+      error = workspace->errors[chunk];
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      Rox_DynVec_SRAID_Feature described = workspace->chunk_features[chunk];
+      for (Rox_Uint id = 0; id < described->used; id++)
+      {
+         error = rox_dynvec_sraiddesc_append(sraid_output, &described->data[id]);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+   }
+
+function_terminate:
+   return error;
+}
@@ -0,0 +1,147 @@
+//==============================================================================
+//
+//    OPENROX   : File sraid_workspace.h
+//
+//    Contents  : API of sraid_workspace module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_SRAID_WORKSPACE__
+#define __OPENROX_SRAID_WORKSPACE__
+
+#include <generated/array2d_float.h>
+#include <generated/dynvec_sraiddesc.h>
+#include <core/features/detectors/dog/dog.h>
+
+//! \addtogroup SRAID
+//! @{
+
+//! The buffers of the SRAID pipeline for a given image size, reused between calls
+struct Rox_SRAID_Workspace_Struct
+{
+   //! The height of the input images
+   Rox_Sint rows;
+
+   //! The width of the input images
+   Rox_Sint cols;
+
+   //! The number of octaves
+   Rox_Uint count_octaves;
+
+   //! The number of intervals of an octave
+   Rox_Uint invls;
+
+   //! The sigma of the scale space
+   Rox_Float sigma;
+
+   //! The kernel smoothing the input image from the initial sigma to sigma
+   Rox_Array2D_Float initial_kernel;
+
+   //! The kernels from a scale level to the next one (invls + 3 kernels, the first one is not used)
+   Rox_Array2D_Float * level_kernels;
+
+   //! The scale space of each octave (invls + 3 levels)
+   Rox_Array2D_Float_Collection * scalespaces;
+
+   //! The dog space of each octave (invls + 2 levels)
+   Rox_Array2D_Float_Collection * dogspaces;
+
+   //! The number of detection tasks: one per octave, dog slice and band of rows
+   Rox_Uint count_tasks;
+
+   //! The octave of each detection task
+   Rox_Uint * task_octave;
+
+   //! The dog slice of each detection task
+   Rox_Uint * task_slice;
+
+   //! The first row of each detection task
+   Rox_Sint * task_first_row;
+
+   //! The dog features detected by each task
+   Rox_Dog_Feature * task_features;
+
+   //! The number of dog features detected by each task
+   Rox_Uint * task_count;
+
+   //! The number of allocated dog features of each task
+   Rox_Uint * task_allocated;
+
+   //! The number of description chunks of the last call
+   Rox_Uint count_chunks;
+
+   //! The number of allocated description chunks
+   Rox_Uint allocated_chunks;
+
+   //! The detection task of each description chunk
+   Rox_Uint * chunk_task;
+
+   //! The first dog feature of each description chunk
+   Rox_Uint * chunk_first;
+
+   //! The described features of each description chunk
+   Rox_DynVec_SRAID_Feature * chunk_features;
+
+   //! The error of each parallel task
+   Rox_ErrorCode * errors;
+};
+
+//! Define the pointer of the Rox_SRAID_Workspace_Struct
+typedef struct Rox_SRAID_Workspace_Struct * Rox_SRAID_Workspace;
+
+//! Create a SRAID workspace: the gaussian kernels are generated and the scale and dog spaces are allocated once
+//! \param [out]  workspace            The newly created workspace
+//! \param [in]   rows                 The height of the input images
+//! \param [in]   cols                 The width of the input images
+//! \param [in]   sraid_max_octaves    The maximal number of octaves (-1 if auto)
+//! \param [in]   sraid_sigma          The sigma to apply for scale space
+//! \param [in]   cutoff               The cutoff applied to gaussian kernel
+//! \param [in]   sraid_initial_sigma  The sigma to apply to input images
+//! \param [in]   sraid_invls          Number of intervals used in dogspace
+//! \return An error code
+ROX_API Rox_ErrorCode rox_sraid_workspace_new (
+   Rox_SRAID_Workspace * workspace,
+   const Rox_Sint rows,
+   const Rox_Sint cols,
+   const Rox_Sint sraid_max_octaves,
+   const Rox_Float sraid_sigma,
+   const Rox_Float cutoff,
+   const Rox_Float sraid_initial_sigma,
+   const Rox_Sint sraid_invls
+);
+
+//! Delete a SRAID workspace
+//! \param [in]   workspace            The workspace to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_sraid_workspace_del (
+   Rox_SRAID_Workspace * workspace
+);
+
+//! Detect & describe features using SRAID method with a workspace.
+//! The dog spaces, the extrema detection (by octave, slice and band of rows) and the description (by chunk of features)
+//! are computed in parallel. The features are output in the same order as a sequential processing.
+//! \param [out]  sraid_output         The set of detected features
+//! \param [in]   workspace            The workspace, created for the size of the input image
+//! \param [in]   input                The image to detect in
+//! \param [in]   sraid_contr_thresh   Threshold for contrast around feature
+//! \param [in]   sraid_curv_thresh    Threshold for curvature in the area
+//! \param [in]   object_id            Id used for convenience.
+//! \return An error code
+ROX_API Rox_ErrorCode rox_sraid_workspace_process (
+   Rox_DynVec_SRAID_Feature sraid_output,
+   Rox_SRAID_Workspace workspace,
+   const Rox_Array2D_Float input,
+   const Rox_Float sraid_contr_thresh,
+   const Rox_Sint sraid_curv_thresh,
+   const Rox_Uint object_id
+);
+
+//! @}
+
+#endif // __OPENROX_SRAID_WORKSPACE__
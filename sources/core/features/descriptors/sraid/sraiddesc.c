@@ -159,7 +159,6 @@ rox_sraiddescriptor_process(
    Rox_Double             possibleorientations[SRAID_ORI_HIST_BINS];
    Rox_Uint             countpossibleorientations;
    Rox_Float          **dimg;
-   static int           val = 0;
 
    if (!dogfeatures) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
    if (!scalespace) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
@@ -278,9 +277,6 @@ rox_sraiddescriptor_process(
          countpossibleorientations++;
       }
 
-      val = 0;
-      val += countpossibleorientations;
-
       // Compute description histogram
       histogram_cols = SRAID_DESCR_SCL_FCTR * dogfeatures[idfeat].octave_scale;
       invhistogramcols = 1.0f / histogram_cols;
@@ -422,7 +418,6 @@ Rox_ErrorCode rox_sraiddescriptor_process_fixed(
    Rox_Double             possibleorientations[SRAID_ORI_HIST_BINS];
    Rox_Uint             countpossibleorientations;
    Rox_Float          **dimg;
-   static int           val = 0;
 
    if (!dogfeatures) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
    if (!scalespace) { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
@@ -539,9 +534,6 @@ Rox_ErrorCode rox_sraiddescriptor_process_fixed(
          countpossibleorientations++;
       }
 
-      val = 0;
-      val += countpossibleorientations;
-
       // Compute description histogram
       histogram_cols = SRAID_DESCR_SCL_FCTR * dogfeatures[idfeat].octave_scale;
       invhistogramcols = 1.0f / histogram_cols;
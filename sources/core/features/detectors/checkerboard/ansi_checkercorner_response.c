@@ -0,0 +1,92 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_checkercorner_response.c
+//
+//    Contents  : Implementation of checkercorner_response module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#include "ansi_checkercorner_response.h"
+
+int rox_ansi_checkercorner_row_scale (
+   float * out,
+   const float * in,
+   const float a,
+   const int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      out[j] = a * in[j];
+   }
+
+   return 0;
+}
+
+int rox_ansi_checkercorner_row_axpy (
+   float * out,
+   const float * in,
+   const float a,
+   const int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      out[j] += a * in[j];
+   }
+
+   return 0;
+}
+
+int rox_ansi_checkercorner_row_axpy2 (
+   float * out,
+   const float * in1,
+   const float * in2,
+   const float a,
+   const int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      out[j] += a * ( in1[j] + in2[j] );
+   }
+
+   return 0;
+}
+
+int rox_ansi_checkercorner_row_cornerness (
+   float * cornerness,
+   const float * r1,
+   const float * r2,
+   const float * r3,
+   const float * r4,
+   const int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      float mean = ( r1[j] + r2[j] + r3[j] + r4[j] ) / 4;
+      float valc = cornerness[j];
+      float val1, val2;
+
+      val1 = r1[j] - mean < r2[j] - mean ? r1[j] - mean : r2[j] - mean;
+      val2 = mean - r3[j] < mean - r4[j] ? mean - r3[j] : mean - r4[j];
+      val1 = val1 < val2 ? val1 : val2;
+      valc = valc > val1 ? valc : val1;
+
+      val1 = mean - r1[j] < mean - r2[j] ? mean - r1[j] : mean - r2[j];
+      val2 = r3[j] - mean < r4[j] - mean ? r3[j] - mean : r4[j] - mean;
+      val1 = val1 < val2 ? val1 : val2;
+      valc = valc > val1 ? valc : val1;
+
+      cornerness[j] = valc;
+   }
+
+   return 0;
+}
@@ -0,0 +1,56 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_checkercorner_response.h
+//
+//    Contents  : API of checkercorner_response module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#ifndef __OPENROX_ANSI_CHECKERCORNER_RESPONSE__
+#define __OPENROX_ANSI_CHECKERCORNER_RESPONSE__
+
+//! Row kernels of the checker corner response
+//! The ansi version and the sse version share the same interface
+
+//! Set a row to a scaled row : out = a * in
+int rox_ansi_checkercorner_row_scale (
+   float * out,
+   const float * in,
+   const float a,
+   const int cols
+);
+
+//! Accumulate a scaled row : out += a * in
+int rox_ansi_checkercorner_row_axpy (
+   float * out,
+   const float * in,
+   const float a,
+   const int cols
+);
+
+//! Accumulate the scaled sum of two rows : out += a * ( in1 + in2 )
+int rox_ansi_checkercorner_row_axpy2 (
+   float * out,
+   const float * in1,
+   const float * in2,
+   const float a,
+   const int cols
+);
+
+//! Update a row of cornerness with the responses of the 4 quadrant kernels
+int rox_ansi_checkercorner_row_cornerness (
+   float * cornerness,
+   const float * r1,
+   const float * r2,
+   const float * r3,
+   const float * r4,
+   const int cols
+);
+
+#endif
@@ -0,0 +1,148 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_checkercorner_response_sse.c
+//
+//    Contents  : Implementation of checkercorner_response module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#include "ansi_checkercorner_response.h"
+
+#include <system/vectorisation/sse.h>
+
+int rox_ansi_checkercorner_row_scale (
+   float * out,
+   const float * in,
+   const float a,
+   const int cols
+)
+{
+   int j = 0;
+   __m128 ssea = _mm_set_ps1(a);
+
+   // Rows are shifted by arbitrary offsets, use unaligned loads
+   for ( j = 0; j + 4 <= cols; j += 4 )
+   {
+      _mm_storeu_ps(&out[j], _mm_mul_ps(ssea, _mm_loadu_ps(&in[j])));
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      out[j] = a * in[j];
+   }
+
+   return 0;
+}
+
+int rox_ansi_checkercorner_row_axpy (
+   float * out,
+   const float * in,
+   const float a,
+   const int cols
+)
+{
+   int j = 0;
+   __m128 ssea = _mm_set_ps1(a);
+
+   for ( j = 0; j + 4 <= cols; j += 4 )
+   {
+      __m128 sseout = _mm_loadu_ps(&out[j]);
+      sseout = _mm_add_ps(sseout, _mm_mul_ps(ssea, _mm_loadu_ps(&in[j])));
+      _mm_storeu_ps(&out[j], sseout);
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      out[j] += a * in[j];
+   }
+
+   return 0;
+}
+
+int rox_ansi_checkercorner_row_axpy2 (
+   float * out,
+   const float * in1,
+   const float * in2,
+   const float a,
+   const int cols
+)
+{
+   int j = 0;
+   __m128 ssea = _mm_set_ps1(a);
+
+   for ( j = 0; j + 4 <= cols; j += 4 )
+   {
+      __m128 ssein = _mm_add_ps(_mm_loadu_ps(&in1[j]), _mm_loadu_ps(&in2[j]));
+      __m128 sseout = _mm_loadu_ps(&out[j]);
+      sseout = _mm_add_ps(sseout, _mm_mul_ps(ssea, ssein));
+      _mm_storeu_ps(&out[j], sseout);
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      out[j] += a * ( in1[j] + in2[j] );
+   }
+
+   return 0;
+}
+
+int rox_ansi_checkercorner_row_cornerness (
+   float * cornerness,
+   const float * r1,
+   const float * r2,
+   const float * r3,
+   const float * r4,
+   const int cols
+)
+{
+   int j = 0;
+   __m128 ssequarter = _mm_set_ps1(0.25f);
+
+   for ( j = 0; j + 4 <= cols; j += 4 )
+   {
+      __m128 sser1 = _mm_loadu_ps(&r1[j]);
+      __m128 sser2 = _mm_loadu_ps(&r2[j]);
+      __m128 sser3 = _mm_loadu_ps(&r3[j]);
+      __m128 sser4 = _mm_loadu_ps(&r4[j]);
+      __m128 ssevalc = _mm_loadu_ps(&cornerness[j]);
+
+      __m128 ssemean = _mm_mul_ps(ssequarter, _mm_add_ps(_mm_add_ps(sser1, sser2), _mm_add_ps(sser3, sser4)));
+
+      __m128 sseval1 = _mm_min_ps(_mm_sub_ps(sser1, ssemean), _mm_sub_ps(sser2, ssemean));
+      __m128 sseval2 = _mm_min_ps(_mm_sub_ps(ssemean, sser3), _mm_sub_ps(ssemean, sser4));
+      ssevalc = _mm_max_ps(ssevalc, _mm_min_ps(sseval1, sseval2));
+
+      sseval1 = _mm_min_ps(_mm_sub_ps(ssemean, sser1), _mm_sub_ps(ssemean, sser2));
+      sseval2 = _mm_min_ps(_mm_sub_ps(sser3, ssemean), _mm_sub_ps(sser4, ssemean));
+      ssevalc = _mm_max_ps(ssevalc, _mm_min_ps(sseval1, sseval2));
+
+      _mm_storeu_ps(&cornerness[j], ssevalc);
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      float mean = ( r1[j] + r2[j] + r3[j] + r4[j] ) / 4;
+      float valc = cornerness[j];
+      float val1, val2;
+
+      val1 = r1[j] - mean < r2[j] - mean ? r1[j] - mean : r2[j] - mean;
+      val2 = mean - r3[j] < mean - r4[j] ? mean - r3[j] : mean - r4[j];
+      val1 = val1 < val2 ? val1 : val2;
+      valc = valc > val1 ? valc : val1;
+
+      val1 = mean - r1[j] < mean - r2[j] ? mean - r1[j] : mean - r2[j];
+      val2 = r3[j] - mean < r4[j] - mean ? r3[j] - mean : r4[j] - mean;
+      val1 = val1 < val2 ? val1 : val2;
+      valc = valc > val1 ? valc : val1;
+
+      cornerness[j] = valc;
+   }
+
+   return 0;
+}
@@ -13,6 +13,7 @@
 //==============================================================================
 
 #include "checkercorner_detect.h"
+#include "ansi_checkercorner_response.h"
 
 #include <generated/objset_dynvec_sparse_value_struct.h>
 #include <generated/dynvec_sparse_value_struct.h>
@@ -31,6 +32,13 @@
 
 #include <baseproc/maths/maths_macros.h>
 
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
+
+//! Radiuses of the corner kernels for each blur level
+static const Rox_Sint checkercorner_radiuses[] = {4, 8, 12, 16, 20, 24, 28, 32};
+
 Rox_ErrorCode rox_checkercorner_detector_new (
    Rox_CheckerCorner_Detector * checkercorner_detector,
    Rox_Sint                     cols,
@@ -64,6 +72,37 @@ Rox_ErrorCode rox_checkercorner_detector_new (
    ret->corners       = NULL;
    ret->angles        = NULL;
    ret->magnitudes    = NULL;
+   ret->padded        = NULL;
+   ret->padded_transposed = NULL;
+   ret->hpos          = NULL;
+   ret->hneg          = NULL;
+   ret->truncated     = NULL;
+   ret->tneg          = NULL;
+   ret->tpos          = NULL;
+
+   ret->kernel_blur_levels = 1; // Default value
+   if ( ( kernel_blur_levels >= 1 ) && ( kernel_blur_levels <= 8 ) )
+   {
+      // The higher is the max the slower is the algorithm but more robust to corners which are not sharp
+      ret->kernel_blur_levels = kernel_blur_levels;
+   }
+
+   ret->score_blur_levels = 1; // Default value
+   if ( ( score_blur_levels >= 1 ) && ( score_blur_levels <= 8 ) )
+   {
+      // The higher is the max the slower is the algorithm but more robust to corners which are not sharp
+      ret->score_blur_levels = score_blur_levels;
+   }
+
+   // The padded buffers must hold the largest kernel around the whole image
+   ret->border = checkercorner_radiuses[ret->kernel_blur_levels - 1];
+   Rox_Sint border = ret->border;
+   Rox_Sint side = ROX_MAX( rows, cols );
+
+   ret->roi.x = 0;
+   ret->roi.y = 0;
+   ret->roi.width = cols;
+   ret->roi.height = rows;
 
    error = rox_array2d_float_new( &ret->source, rows, cols );      ROX_ERROR_CHECK_TERMINATE( error );
    error = rox_array2d_float_new( &ret->cornerness, rows, cols );  ROX_ERROR_CHECK_TERMINATE( error );
@@ -76,6 +115,14 @@ Rox_ErrorCode rox_checkercorner_detector_new (
    error = rox_array2d_float_new( &ret->rep3, rows, cols );        ROX_ERROR_CHECK_TERMINATE( error );
    error = rox_array2d_float_new( &ret->rep4, rows, cols );        ROX_ERROR_CHECK_TERMINATE( error );
 
+   error = rox_array2d_float_new( &ret->padded, rows + 2 * border, cols + 2 * border );            ROX_ERROR_CHECK_TERMINATE( error );
+   error = rox_array2d_float_new( &ret->padded_transposed, cols + 2 * border, rows + 2 * border ); ROX_ERROR_CHECK_TERMINATE( error );
+   error = rox_array2d_float_new( &ret->hpos, rows + 2 * border, cols );                            ROX_ERROR_CHECK_TERMINATE( error );
+   error = rox_array2d_float_new( &ret->hneg, rows + 2 * border, cols );                            ROX_ERROR_CHECK_TERMINATE( error );
+   error = rox_array2d_float_new( &ret->truncated, side, side + 2 * border );                       ROX_ERROR_CHECK_TERMINATE( error );
+   error = rox_array2d_float_new( &ret->tneg, cols, rows );                                         ROX_ERROR_CHECK_TERMINATE( error );
+   error = rox_array2d_float_new( &ret->tpos, cols, rows );                                         ROX_ERROR_CHECK_TERMINATE( error );
+
    error = rox_objset_dynvec_sparse_value_new( &ret->kernels, 16 );
    ROX_ERROR_CHECK_TERMINATE( error );
 
@@ -85,20 +132,6 @@ Rox_ErrorCode rox_checkercorner_detector_new (
    error = rox_dynvec_checkercorner_new( &ret->corners, 10 );
    ROX_ERROR_CHECK_TERMINATE( error );
 
-   ret->kernel_blur_levels = 1; // Default value
-   if ( ( kernel_blur_levels >= 1 ) && ( kernel_blur_levels <= 8 ) )
-   {
-      // The higher is the max the slower is the algorithm but more robust to corners which are not sharp
-      ret->kernel_blur_levels = kernel_blur_levels;
-   }
-
-   ret->score_blur_levels = 1; // Default value
-   if ( ( score_blur_levels >= 1 ) && ( score_blur_levels <= 8 ) )
-   {
-      // The higher is the max the slower is the algorithm but more robust to corners which are not sharp
-      ret->score_blur_levels = score_blur_levels;
-   }
-
    error = rox_checkercorner_build_kernels(ret);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -139,6 +172,13 @@ Rox_ErrorCode rox_checkercorner_detector_del( Rox_CheckerCorner_Detector * check
    rox_array2d_float_del( &todel->cornerness );
    rox_array2d_float_del( &todel->gx );
    rox_array2d_float_del( &todel->gy );
+   rox_array2d_float_del( &todel->padded );
+   rox_array2d_float_del( &todel->padded_transposed );
+   rox_array2d_float_del( &todel->hpos );
+   rox_array2d_float_del( &todel->hneg );
+   rox_array2d_float_del( &todel->truncated );
+   rox_array2d_float_del( &todel->tneg );
+   rox_array2d_float_del( &todel->tpos );
 
    rox_memory_delete( todel );
 
@@ -856,10 +896,18 @@ Rox_ErrorCode rox_checkercorner_detector_processcorners ( Rox_CheckerCorner_Dete
 
    rox_dynvec_checkercorner_reset( checkercorner_detector->corners );
 
-   // Compute gradient vectors polar
-   for ( Rox_Sint i = 0; i < rows; i++ )
+   // Compute gradient vectors polar only where the histograms of the corners can be computed
+   Rox_Sint i0 = ROX_MAX( checkercorner_detector->roi.y - (Rox_Sint) size_v, 0 );
+   Rox_Sint i1 = ROX_MIN( checkercorner_detector->roi.y + checkercorner_detector->roi.height + (Rox_Sint) size_v, rows );
+   Rox_Sint j0 = ROX_MAX( checkercorner_detector->roi.x - (Rox_Sint) size_u, 0 );
+   Rox_Sint j1 = ROX_MIN( checkercorner_detector->roi.x + checkercorner_detector->roi.width + (Rox_Sint) size_u, cols );
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = i0; i < i1; i++ )
    {
-      for ( Rox_Sint j = 0; j < cols; j++ )
+      for ( Rox_Sint j = j0; j < j1; j++ )
       {
          dm[i][j] = sqrt( dgx[i][j] * dgx[i][j] + dgy[i][j] * dgy[i][j] );
          da[i][j] = atan2( dgy[i][j], dgx[i][j] );
@@ -1008,33 +1056,149 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_checkercorner_detector_process (
-   Rox_CheckerCorner_Detector checkercorner_detector,
-   Rox_Image image )
+// Transpose a block of rows x cols values, dest[j][i] = source[i][j]
+static Rox_ErrorCode rox_checkercorner_transpose (
+   Rox_Float ** dest,
+   Rox_Float ** source,
+   const Rox_Sint rows,
+   const Rox_Sint cols
+)
 {
-   Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_DynVec_Sparse_Value * kernels = NULL;
-   Rox_Float mean = 0.0, val1 = 0.0, val2 = 0.0, valc = 0.0, maxc = 0.0;
-   Rox_Uint maxi = 0, maxj = 0;
+   // Work on small tiles to keep both reads and writes in cache
+   const Rox_Sint tile = 32;
+   const Rox_Sint tiles = ( rows + tile - 1 ) / tile;
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint ti = 0; ti < tiles; ti++ )
+   {
+      Rox_Sint i0 = ti * tile;
+      Rox_Sint i1 = ROX_MIN( i0 + tile, rows );
 
-   // Window size for local maxima was 3
-   const Rox_Sint sizen = 10;
+      for ( Rox_Sint j0 = 0; j0 < cols; j0 += tile )
+      {
+         Rox_Sint j1 = ROX_MIN( j0 + tile, cols );
 
-   if ( !checkercorner_detector || !image )
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE( error ); }
+         for ( Rox_Sint i = i0; i < i1; i++ )
+         {
+            for ( Rox_Sint j = j0; j < j1; j++ )
+            {
+               dest[j][i] = source[i][j];
+            }
+         }
+      }
+   }
 
-   rox_dynvec_checkercorner_reset( checkercorner_detector->local_corners );
+   return ROX_ERROR_NONE;
+}
 
-   // Convert uchar image to float in order to compute the gradient
-   error = rox_array2d_float_from_uchar( checkercorner_detector->source, image );
+// Response of the two opposite wedge kernels |v| < u and |v| < -u (diagonal orientation).
+// The gaussian is separable, so for each column offset m the vertical part of the wedge
+// is a gaussian truncated to |v| < m. These truncated sums are built incrementally
+// along m, so that each row only needs shifted vector additions.
+// The responses are computed for rows x cols pixels whose top left pixel is (border, border) in the padded image.
+static Rox_ErrorCode rox_checkercorner_wedges (
+   Rox_Float ** dneg,
+   Rox_Float ** dpos,
+   Rox_Float ** dtrunc,
+   Rox_Float ** dpad,
+   const Rox_Sint rows,
+   const Rox_Sint cols,
+   const Rox_Sint border,
+   const Rox_Float * gauss,
+   const Rox_Sint radius,
+   const Rox_Float scale
+)
+{
+   const Rox_Sint start = border - radius;
+   const Rox_Sint length = cols + 2 * radius;
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      Rox_Float * trunc = dtrunc[i];
+      Rox_Sint v = border + i;
+
+      // Truncated sum for m = 1 is the central row only
+      rox_ansi_checkercorner_row_scale( trunc, &dpad[v][start], gauss[0], length );
+
+      rox_ansi_checkercorner_row_scale( dpos[i], &trunc[radius + 1], gauss[1] * scale, cols );
+      rox_ansi_checkercorner_row_scale( dneg[i], &trunc[radius - 1], gauss[1] * scale, cols );
+
+      for ( Rox_Sint m = 2; m <= radius; m++ )
+      {
+         rox_ansi_checkercorner_row_axpy2( trunc, &dpad[v + m - 1][start], &dpad[v - m + 1][start], gauss[m - 1], length );
+
+         rox_ansi_checkercorner_row_axpy( dpos[i], &trunc[radius + m], gauss[m] * scale, cols );
+         rox_ansi_checkercorner_row_axpy( dneg[i], &trunc[radius - m], gauss[m] * scale, cols );
+      }
+   }
+
+   return ROX_ERROR_NONE;
+}
+
+// Copy the source around the region of interest with replicated image borders
+static Rox_ErrorCode rox_checkercorner_detector_pad (
+   Rox_CheckerCorner_Detector checkercorner_detector
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   Rox_Sint cols = 0, rows = 0;
+   error = rox_array2d_float_get_size( &rows, &cols, checkercorner_detector->source );
    ROX_ERROR_CHECK_TERMINATE( error );
 
-   error = rox_array2d_float_gradientsobel_nomask( checkercorner_detector->gx, checkercorner_detector->gy, checkercorner_detector->source );
+   Rox_Float ** ds = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &ds, checkercorner_detector->source );
    ROX_ERROR_CHECK_TERMINATE( error );
 
-   error = rox_array2d_float_from_uchar_normalize_minmax( checkercorner_detector->source, image );
+   Rox_Float ** dp = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dp, checkercorner_detector->padded );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dpt = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dpt, checkercorner_detector->padded_transposed );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Sint border = checkercorner_detector->border;
+   Rox_Sint x0 = checkercorner_detector->roi.x - border;
+   Rox_Sint y0 = checkercorner_detector->roi.y - border;
+   Rox_Sint prows = checkercorner_detector->roi.height + 2 * border;
+   Rox_Sint pcols = checkercorner_detector->roi.width + 2 * border;
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = 0; i < prows; i++ )
+   {
+      Rox_Float * row = ds[ROX_MIN( ROX_MAX( y0 + i, 0 ), rows - 1 )];
+
+      for ( Rox_Sint j = 0; j < pcols; j++ )
+      {
+         dp[i][j] = row[ROX_MIN( ROX_MAX( x0 + j, 0 ), cols - 1 )];
+      }
+   }
+
+   error = rox_checkercorner_transpose( dpt, dp, prows, pcols );
    ROX_ERROR_CHECK_TERMINATE( error );
 
+function_terminate:
+   return error;
+}
+
+// Update the cornerness in the region of interest with the kernels of one blur level
+static Rox_ErrorCode rox_checkercorner_detector_cornerness (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   const Rox_Sint radius
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float gauss[33];
+   Rox_Double sum = 0.0, sum_axis = 0.0, sum_diag = 0.0;
+
    Rox_Float ** dc = NULL;
    error = rox_array2d_float_get_data_pointer_to_pointer( &dc, checkercorner_detector->cornerness );
    ROX_ERROR_CHECK_TERMINATE( error );
@@ -1055,91 +1219,361 @@ Rox_ErrorCode rox_checkercorner_detector_process (
    error = rox_array2d_float_get_data_pointer_to_pointer( &dr4, checkercorner_detector->rep4 );
    ROX_ERROR_CHECK_TERMINATE( error );
 
-   Rox_Sint cols = 0, rows = 0;
-   error = rox_array2d_float_get_size( &rows, &cols, checkercorner_detector->source );
+   Rox_Float ** dp = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dp, checkercorner_detector->padded );
    ROX_ERROR_CHECK_TERMINATE( error );
 
-   error = rox_array2d_float_fillval( checkercorner_detector->cornerness, 0 );
+   Rox_Float ** dpt = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dpt, checkercorner_detector->padded_transposed );
    ROX_ERROR_CHECK_TERMINATE( error );
 
-   // Compute cornerness for each pixels
-   for (Rox_Uint idkernel = 0; idkernel < checkercorner_detector->kernels->used; idkernel+=4 )
+   Rox_Float ** dhpos = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dhpos, checkercorner_detector->hpos );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dhneg = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dhneg, checkercorner_detector->hneg );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dtrunc = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dtrunc, checkercorner_detector->truncated );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dtneg = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dtneg, checkercorner_detector->tneg );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dtpos = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dtpos, checkercorner_detector->tpos );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Sint border = checkercorner_detector->border;
+   Rox_Sint x0 = checkercorner_detector->roi.x;
+   Rox_Sint y0 = checkercorner_detector->roi.y;
+   Rox_Sint rows = checkercorner_detector->roi.height;
+   Rox_Sint cols = checkercorner_detector->roi.width;
+
+   if ( radius < 1 || radius > border || radius > 32 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE( error ); }
+
+   // Same gaussian as the sparse kernels, the normalization constant vanishes
+   Rox_Double sigma = radius / 2.0;
+   Rox_Double var = sigma * sigma;
+   for ( Rox_Sint m = 0; m <= radius; m++ )
    {
-      kernels = &checkercorner_detector->kernels->data[idkernel];
-      error = rox_array2d_float_convolve_with_sparse_kernel( checkercorner_detector->rep1, checkercorner_detector->source, kernels[0] );
-      ROX_ERROR_CHECK_TERMINATE( error );
+      gauss[m] = (Rox_Float) exp( -( m * m ) / ( 2.0 * var ) );
+   }
 
-      error = rox_array2d_float_convolve_with_sparse_kernel( checkercorner_detector->rep2, checkercorner_detector->source, kernels[1] );
-      ROX_ERROR_CHECK_TERMINATE( error );
+   // Sum of a quadrant and of a wedge, all kernels are normalized to 1
+   for ( Rox_Sint m = 1; m <= radius; m++ )
+   {
+      sum_axis += gauss[m];
+      sum_diag += gauss[m] * ( gauss[0] + 2.0 * sum );
+      sum += gauss[m];
+   }
+   sum_axis = sum_axis * sum_axis;
 
-      error = rox_array2d_float_convolve_with_sparse_kernel( checkercorner_detector->rep3, checkercorner_detector->source, kernels[2] );
-      ROX_ERROR_CHECK_TERMINATE( error );
+   const Rox_Float scale_axis = (Rox_Float) ( 1.0 / sum_axis );
+   const Rox_Float scale_diag = (Rox_Float) ( 1.0 / sum_diag );
 
-      error = rox_array2d_float_convolve_with_sparse_kernel( checkercorner_detector->rep4, checkercorner_detector->source, kernels[3] );
-      ROX_ERROR_CHECK_TERMINATE( error );
+   // Axis aligned quadrants are separable: horizontal half gaussians first
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = border - radius; i < border + rows + radius; i++ )
+   {
+      rox_ansi_checkercorner_row_scale( dhpos[i], &dp[i][border + 1], gauss[1], cols );
+      rox_ansi_checkercorner_row_scale( dhneg[i], &dp[i][border - 1], gauss[1], cols );
 
-      for ( Rox_Sint i = 0; i < rows; i++ )
+      for ( Rox_Sint m = 2; m <= radius; m++ )
       {
-         for ( Rox_Sint j = 0; j < cols; j++ )
-         {
-            mean = ( dr1[i][j] + dr2[i][j] + dr3[i][j] + dr4[i][j] ) / 4;
+         rox_ansi_checkercorner_row_axpy( dhpos[i], &dp[i][border + m], gauss[m], cols );
+         rox_ansi_checkercorner_row_axpy( dhneg[i], &dp[i][border - m], gauss[m], cols );
+      }
+   }
+
+   // Then vertical half gaussians, fused with the cornerness update
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      Rox_Sint v = border + i;
+
+      // Quadrants (v < 0, u > 0), (v > 0, u < 0), (v < 0, u < 0) and (v > 0, u > 0)
+      rox_ansi_checkercorner_row_scale( dr1[i], dhpos[v - 1], gauss[1] * scale_axis, cols );
+      rox_ansi_checkercorner_row_scale( dr2[i], dhneg[v + 1], gauss[1] * scale_axis, cols );
+      rox_ansi_checkercorner_row_scale( dr3[i], dhneg[v - 1], gauss[1] * scale_axis, cols );
+      rox_ansi_checkercorner_row_scale( dr4[i], dhpos[v + 1], gauss[1] * scale_axis, cols );
+
+      for ( Rox_Sint m = 2; m <= radius; m++ )
+      {
+         rox_ansi_checkercorner_row_axpy( dr1[i], dhpos[v - m], gauss[m] * scale_axis, cols );
+         rox_ansi_checkercorner_row_axpy( dr2[i], dhneg[v + m], gauss[m] * scale_axis, cols );
+         rox_ansi_checkercorner_row_axpy( dr3[i], dhneg[v - m], gauss[m] * scale_axis, cols );
+         rox_ansi_checkercorner_row_axpy( dr4[i], dhpos[v + m], gauss[m] * scale_axis, cols );
+      }
+
+      rox_ansi_checkercorner_row_cornerness( &dc[y0 + i][x0], dr1[i], dr2[i], dr3[i], dr4[i], cols );
+   }
+
+   // Diagonal wedges: right and left wedges along the rows
+   error = rox_checkercorner_wedges( dr4, dr3, dtrunc, dp, rows, cols, border, gauss, radius, scale_diag );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   // Top and bottom wedges along the rows of the transposed image
+   error = rox_checkercorner_wedges( dtneg, dtpos, dtrunc, dpt, cols, rows, border, gauss, radius, scale_diag );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   error = rox_checkercorner_transpose( dr1, dtneg, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   error = rox_checkercorner_transpose( dr2, dtpos, cols, rows );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      rox_ansi_checkercorner_row_cornerness( &dc[y0 + i][x0], dr1[i], dr2[i], dr3[i], dr4[i], cols );
+   }
+
+function_terminate:
+   return error;
+}
+
+// Extract the local maxima of the cornerness in the region of interest
+static Rox_ErrorCode rox_checkercorner_detector_local_maxima (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   const Rox_Sint sizen,
+   const Rox_Float threshold
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-            valc = dc[i][j];
+   Rox_Sint cols = 0, rows = 0;
+   error = rox_array2d_float_get_size( &rows, &cols, checkercorner_detector->cornerness );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dc = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dc, checkercorner_detector->cornerness );
+   ROX_ERROR_CHECK_TERMINATE( error );
 
-            val1 = ROX_MIN( dr1[i][j] - mean, dr2[i][j] - mean );
-            val2 = ROX_MIN( mean - dr3[i][j], mean - dr4[i][j] );
-            valc = ROX_MAX( valc, ROX_MIN( val1, val2 ) );
-            val1 = ROX_MIN( mean - dr1[i][j], mean - dr2[i][j] );
-            val2 = ROX_MIN( dr3[i][j] - mean, dr4[i][j] - mean );
-            valc = ROX_MAX( valc, ROX_MIN( val1, val2 ) );
+   // Buffers of the axis aligned kernels are reused, they have at least as many rows as the image
+   Rox_Float ** dhmax = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dhmax, checkercorner_detector->hpos );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Float ** dwmax = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer( &dwmax, checkercorner_detector->hneg );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   Rox_Sint i0 = ROX_MAX( sizen, checkercorner_detector->roi.y );
+   Rox_Sint i1 = ROX_MIN( rows - sizen, checkercorner_detector->roi.y + checkercorner_detector->roi.height );
+   Rox_Sint j0 = ROX_MAX( sizen, checkercorner_detector->roi.x );
+   Rox_Sint j1 = ROX_MIN( cols - sizen, checkercorner_detector->roi.x + checkercorner_detector->roi.width );
+
+   if ( i0 >= i1 || j0 >= j1 ) goto function_terminate;
+
+   // Separable maximum over the ( 2 * sizen + 1 ) x ( 2 * sizen + 1 ) window
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint k = i0 - sizen; k < i1 + sizen; k++ )
+   {
+      for ( Rox_Sint j = j0; j < j1; j++ )
+      {
+         Rox_Float maxc = dc[k][j - sizen];
+         for ( Rox_Sint l = j - sizen + 1; l <= j + sizen; l++ )
+         {
+            maxc = ROX_MAX( maxc, dc[k][l] );
+         }
+         dhmax[k][j] = maxc;
+      }
+   }
 
-            dc[i][j] = valc;
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint i = i0; i < i1; i++ )
+   {
+      for ( Rox_Sint j = j0; j < j1; j++ )
+      {
+         Rox_Float maxc = dhmax[i - sizen][j];
+         for ( Rox_Sint k = i - sizen + 1; k <= i + sizen; k++ )
+         {
+            maxc = ROX_MAX( maxc, dhmax[k][j] );
          }
+         dwmax[i][j] = maxc;
       }
    }
 
-   // Extract local maximas
-   for ( Rox_Sint i = sizen; i < rows - sizen; i++ )
+   // Scan in raster order to keep the order of the detected corners
+   for ( Rox_Sint i = i0; i < i1; i++ )
    {
-      for ( Rox_Sint j = sizen; j < cols - sizen; j++ )
+      for ( Rox_Sint j = j0; j < j1; j++ )
       {
-         maxi = i;
-         maxj = j;
-         maxc = dc[i][j];
+         Rox_Float valc = dc[i][j];
+         Rox_Sint unique = 1;
 
-         for ( Rox_Sint k = i - sizen; k <= i + sizen; k++ )
+         // Maximum cornerness
+         if ( valc <= threshold || valc < dwmax[i][j] ) continue;
+
+         // When equal values are found in the window, only the last one in raster order is kept
+         for ( Rox_Sint k = i; k <= i + sizen && unique; k++ )
          {
-            for ( Rox_Sint l = j - sizen; l <= j + sizen; l++ )
+            for ( Rox_Sint l = ( k == i ) ? j + 1 : j - sizen; l <= j + sizen; l++ )
             {
-               valc = dc[k][l];
-               // Test if valc is greater OR equal to maxc
-               // Test if equal avoids to duplicate points when equal
-               if ( valc >= maxc )
-               {
-                  maxi = k;
-                  maxj = l;
-                  maxc = valc;
-               }
+               if ( dc[k][l] >= valc ) { unique = 0; break; }
             }
          }
 
-         if ( maxi != i || maxj != j ) continue;
+         if ( !unique ) continue;
 
-         // Maximum cornerness
-         if ( maxc > 0.025 )
-         {
-            Rox_CheckerCorner_Struct corner;
-            corner.coords.u = j;
-            corner.coords.v = i;
+         Rox_CheckerCorner_Struct corner;
+         corner.coords.u = j;
+         corner.coords.v = i;
 
-            rox_dynvec_checkercorner_append( checkercorner_detector->local_corners, &corner );
-         }
+         error = rox_dynvec_checkercorner_append( checkercorner_detector->local_corners, &corner );
+         ROX_ERROR_CHECK_TERMINATE( error );
       }
    }
 
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_checkercorner_detector_process (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   // Window size for local maxima was 3
+   const Rox_Sint sizen = 10;
+
+   if ( !checkercorner_detector || !image )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE( error ); }
+
+   rox_dynvec_checkercorner_reset( checkercorner_detector->local_corners );
+
+   // Convert uchar image to float in order to compute the gradient
+   error = rox_array2d_float_from_uchar( checkercorner_detector->source, image );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   error = rox_array2d_float_gradientsobel_nomask( checkercorner_detector->gx, checkercorner_detector->gy, checkercorner_detector->source );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   error = rox_array2d_float_from_uchar_normalize_minmax( checkercorner_detector->source, image );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   error = rox_array2d_float_fillval( checkercorner_detector->cornerness, 0 );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   error = rox_checkercorner_detector_pad( checkercorner_detector );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   // Compute cornerness for each pixels of the region of interest
+   for ( Rox_Uint level = 0; level < checkercorner_detector->kernel_blur_levels; level++ )
+   {
+      error = rox_checkercorner_detector_cornerness( checkercorner_detector, checkercorner_radiuses[level] );
+      ROX_ERROR_CHECK_TERMINATE( error );
+   }
+
+   // Extract local maximas
+   error = rox_checkercorner_detector_local_maxima( checkercorner_detector, sizen, 0.025f );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
    error = rox_checkercorner_detector_processcorners ( checkercorner_detector );
    ROX_ERROR_CHECK_TERMINATE( error )
 
 function_terminate:
    return error;
 }
+
+Rox_ErrorCode rox_checkercorner_detector_set_roi (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   const Rox_Rect_Sint_Struct * roi
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !checkercorner_detector )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE( error ); }
+
+   Rox_Sint cols = 0, rows = 0;
+   error = rox_array2d_float_get_size( &rows, &cols, checkercorner_detector->source );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+   if ( !roi )
+   {
+      checkercorner_detector->roi.x = 0;
+      checkercorner_detector->roi.y = 0;
+      checkercorner_detector->roi.width = cols;
+      checkercorner_detector->roi.height = rows;
+      goto function_terminate;
+   }
+
+   Rox_Sint u0 = ROX_MAX( roi->x, 0 );
+   Rox_Sint v0 = ROX_MAX( roi->y, 0 );
+   Rox_Sint u1 = ROX_MIN( roi->x + roi->width, cols );
+   Rox_Sint v1 = ROX_MIN( roi->y + roi->height, rows );
+
+   if ( u1 <= u0 || v1 <= v0 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE( error ); }
+
+   checkercorner_detector->roi.x = u0;
+   checkercorner_detector->roi.y = v0;
+   checkercorner_detector->roi.width = u1 - u0;
+   checkercorner_detector->roi.height = v1 - v0;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_checkercorner_detector_set_roi_from_corners (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   const Rox_Sint margin
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Rect_Sint_Struct roi;
+
+   if ( !checkercorner_detector )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE( error ); }
+
+   if ( margin < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE( error ); }
+
+   if ( checkercorner_detector->corners->used == 0 )
+   {
+      error = rox_checkercorner_detector_set_roi( checkercorner_detector, NULL );
+      ROX_ERROR_CHECK_TERMINATE( error );
+      goto function_terminate;
+   }
+
+   Rox_Double umin = checkercorner_detector->corners->data[0].coords.u;
+   Rox_Double umax = umin;
+   Rox_Double vmin = checkercorner_detector->corners->data[0].coords.v;
+   Rox_Double vmax = vmin;
+
+   for ( Rox_Uint id = 1; id < checkercorner_detector->corners->used; id++ )
+   {
+      umin = ROX_MIN( umin, checkercorner_detector->corners->data[id].coords.u );
+      umax = ROX_MAX( umax, checkercorner_detector->corners->data[id].coords.u );
+      vmin = ROX_MIN( vmin, checkercorner_detector->corners->data[id].coords.v );
+      vmax = ROX_MAX( vmax, checkercorner_detector->corners->data[id].coords.v );
+   }
+
+   roi.x = (Rox_Sint) floor( umin ) - margin;
+   roi.y = (Rox_Sint) floor( vmin ) - margin;
+   roi.width  = (Rox_Sint) ceil( umax ) + margin + 1 - roi.x;
+   roi.height = (Rox_Sint) ceil( vmax ) + margin + 1 - roi.y;
+
+   error = rox_checkercorner_detector_set_roi( checkercorner_detector, &roi );
+   ROX_ERROR_CHECK_TERMINATE( error );
+
+function_terminate:
+   return error;
+}
@@ -22,6 +22,7 @@
 #include <generated/dynvec_checkercorner.h>
 #include <generated/objset_dynvec_sparse_value.h>
 #include <baseproc/image/image.h>
+#include <baseproc/geometry/rectangle/rectangle_struct.h>
 
 //! \ingroup Detectors
 //! \addtogroup CheckerCorner
@@ -60,6 +61,33 @@ struct Rox_CheckerCorner_Detector_Struct
    //! Image intermediate response
    Rox_Array2D_Float rep4;
 
+   //! Source around the region of interest, padded by replicating the image borders
+   Rox_Array2D_Float padded;
+
+   //! Transposed padded source
+   Rox_Array2D_Float padded_transposed;
+
+   //! Horizontal pass of the separable kernels (positive side)
+   Rox_Array2D_Float hpos;
+
+   //! Horizontal pass of the separable kernels (negative side)
+   Rox_Array2D_Float hneg;
+
+   //! Truncated gaussian sums for the diagonal kernels
+   Rox_Array2D_Float truncated;
+
+   //! Transposed response of the diagonal kernels (negative side)
+   Rox_Array2D_Float tneg;
+
+   //! Transposed response of the diagonal kernels (positive side)
+   Rox_Array2D_Float tpos;
+
+   //! Region of interest where corners are searched
+   Rox_Rect_Sint_Struct roi;
+
+   //! Border of the padded source (largest kernel radius)
+   Rox_Sint border;
+
    //! Image kernels
    Rox_ObjSet_DynVec_Sparse_Value kernels;
 
@@ -112,6 +140,26 @@ ROX_API Rox_ErrorCode rox_checkercorner_detector_process (
    const Rox_Image image
 );
 
+//! Restrict the corner search to a region of interest (e.g. predicted from the previous frame).
+//! The region is clipped to the image. It remains active for the next calls to process.
+//! \param  [out]  checkercorner_detector     The container pointer
+//! \param  [in ]  roi                        The region of interest, NULL to search the whole image
+//! \return An error code
+ROX_API Rox_ErrorCode rox_checkercorner_detector_set_roi (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   const Rox_Rect_Sint_Struct * roi
+);
+
+//! Set the region of interest to the bounding box of the last detected corners enlarged by a margin.
+//! The whole image is used if no corner was detected.
+//! \param  [out]  checkercorner_detector     The container pointer
+//! \param  [in ]  margin                     The margin in pixels added around the bounding box
+//! \return An error code
+ROX_API Rox_ErrorCode rox_checkercorner_detector_set_roi_from_corners (
+   Rox_CheckerCorner_Detector checkercorner_detector,
+   const Rox_Sint margin
+);
+
 //! Build kernels for further corner detection
 //! \param  [out]  checkercorner_detector     The container pointer to use
 //! \return An error code
@@ -163,15 +163,31 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_dogdetector_process(Rox_Dog_Feature * features, Rox_Uint * countFeatures, Rox_Array2D_Float_Collection dogspace, Rox_Rect_Sint image_bounds, Rox_Float contrast_threshold, Rox_Float curvature_threshold, Rox_Float preliminary_threshold, Rox_Uint nbintervals, Rox_Uint octave, Rox_Float sigma)
+// Clip the image bounds to the pixels where the dog extrema can be interpolated
+static Rox_Void rox_dogdetector_bounds(Rox_Sint * top, Rox_Sint * bottom, Rox_Sint * left, Rox_Sint * right, Rox_Sint rows, Rox_Sint cols, Rox_Rect_Sint image_bounds)
+{
+   *left = image_bounds->x;
+   if (*left < SRAID_IMG_BORDER) *left = SRAID_IMG_BORDER;
+   *top = image_bounds->y;
+   if (*top < SRAID_IMG_BORDER) *top = SRAID_IMG_BORDER;
+
+   *bottom = image_bounds->y + image_bounds->height - 1;
+   if (*bottom >= rows - SRAID_IMG_BORDER) *bottom = rows - SRAID_IMG_BORDER - 1;
+   if (*bottom < *top) *bottom = *top + 1;
+   *right = image_bounds->x + image_bounds->width - 1;
+   if (*right >= cols - SRAID_IMG_BORDER) *right = cols - SRAID_IMG_BORDER - 1;
+   if (*right < *left) *right = *left + 1;
+}
+
+Rox_ErrorCode rox_dogdetector_process_band(Rox_Dog_Feature * features, Rox_Uint * countFeatures, Rox_Uint * allocatedFeatures, Rox_Array2D_Float_Collection dogspace, Rox_Uint slice, Rox_Sint first_row, Rox_Sint last_row, Rox_Rect_Sint image_bounds, Rox_Float contrast_threshold, Rox_Float curvature_threshold, Rox_Float preliminary_threshold, Rox_Uint nbintervals, Rox_Uint octave, Rox_Float sigma)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint i, j, slice, isminimal;
+   Rox_Uint i, j, isminimal;
    Rox_Uint countslice;
    Rox_Float **dp, **dn, **dc;
    Rox_Float cur;
    Rox_Array2D_Float curdog, prevdog, nextdog;
-   Rox_Array2D_Double H, iH, diff, sol;
+   Rox_Array2D_Double H = NULL, iH = NULL, diff = NULL, sol = NULL;
    Rox_Uint count, allocated;
    Rox_Dog_Feature_Struct curfeat, *lfeats;
    Rox_Float curvature_adv_threshold;
@@ -179,35 +195,38 @@ Rox_ErrorCode rox_dogdetector_process(Rox_Dog_Feature * features, Rox_Uint * cou
    Rox_Sint left, right, top, bottom;
 
 
-   if (!features) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-   
-   if (!countFeatures) 
+   if (!features || !countFeatures || !allocatedFeatures || !image_bounds) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
    countslice = rox_array2d_float_collection_get_count(dogspace);
-   if (countslice < 3) { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   if (countslice < 3 || slice < 1 || slice >= countslice - 1) { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
    scale = (Rox_Float)(ROX_POWF(2.0, (int)octave));
 
-   curdog = rox_array2d_float_collection_get(dogspace, 1);
+   prevdog = rox_array2d_float_collection_get(dogspace, slice - 1);
+   curdog = rox_array2d_float_collection_get(dogspace, slice);
+   nextdog = rox_array2d_float_collection_get(dogspace, slice + 1);
 
    Rox_Sint cols = 0, rows = 0;
 
    error = rox_array2d_float_get_size(&rows, &cols, curdog); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   left = image_bounds->x;
-   if (left < SRAID_IMG_BORDER) left = SRAID_IMG_BORDER;
-   top = image_bounds->y;
-   if (top < SRAID_IMG_BORDER) top = SRAID_IMG_BORDER;
+   rox_dogdetector_bounds(&top, &bottom, &left, &right, rows, cols, image_bounds);
+   if (top < first_row) top = first_row;
+   if (bottom > last_row - 1) bottom = last_row - 1;
+
+   // The feature array is allocated by the first band
+   if (*features == NULL)
+   {
+      *allocatedFeatures = 100;
+      *countFeatures = 0;
+      *features = (Rox_Dog_Feature ) rox_memory_allocate(sizeof(Rox_Dog_Feature_Struct), *allocatedFeatures);
+      if (!*features)
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
 
-   bottom = image_bounds->y + image_bounds->height - 1;
-   if (bottom >= rows - SRAID_IMG_BORDER) bottom = rows - SRAID_IMG_BORDER - 1;
-   if (bottom < top) bottom = top + 1;
-   right = image_bounds->x + image_bounds->width - 1;
-   if (right >= cols - SRAID_IMG_BORDER) right = cols - SRAID_IMG_BORDER - 1;
-   if (right < left) right = left + 1;
+   if (top > bottom) goto function_terminate;
 
    error = rox_array2d_double_new(&H, 3, 3);
 
@@ -224,134 +243,127 @@ Rox_ErrorCode rox_dogdetector_process(Rox_Dog_Feature * features, Rox_Uint * cou
 
    curvature_adv_threshold = (Rox_Float) ((curvature_threshold + 1.0) * (curvature_threshold + 1.0) / curvature_threshold);
 
-   count = 0;
+   count = *countFeatures;
+   allocated = *allocatedFeatures;
+   lfeats = *features;
 
-   allocated = 100;
-   lfeats = (Rox_Dog_Feature ) rox_memory_allocate(sizeof(Rox_Dog_Feature_Struct), allocated);
-   if (!lfeats)
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   error = rox_array2d_float_get_data_pointer_to_pointer(&dp, prevdog); ROX_ERROR_CHECK_TERMINATE ( error ); 
+   error = rox_array2d_float_get_data_pointer_to_pointer(&dc, curdog); ROX_ERROR_CHECK_TERMINATE ( error ); 
+   error = rox_array2d_float_get_data_pointer_to_pointer(&dn, nextdog); ROX_ERROR_CHECK_TERMINATE ( error ); 
 
-   for (slice = 1; slice < countslice - 1; slice++)
+   for (i = (Rox_Uint) top; i <= (Rox_Uint)bottom; i++)
    {
-      prevdog = rox_array2d_float_collection_get(dogspace, slice - 1);
-      curdog = rox_array2d_float_collection_get(dogspace, slice);
-      nextdog = rox_array2d_float_collection_get(dogspace, slice + 1);
-
-
-      error = rox_array2d_float_get_data_pointer_to_pointer(&dp, prevdog); ROX_ERROR_CHECK_TERMINATE ( error ); 
-      error = rox_array2d_float_get_data_pointer_to_pointer(&dc, curdog); ROX_ERROR_CHECK_TERMINATE ( error ); 
-      error = rox_array2d_float_get_data_pointer_to_pointer(&dn, nextdog); ROX_ERROR_CHECK_TERMINATE ( error ); 
-
-      for (i = (Rox_Uint) top; i <= (Rox_Uint)bottom; i++)
+      for (j = (Rox_Uint) left; j <= (Rox_Uint)right; j++)
       {
-         for (j = (Rox_Uint) left; j <= (Rox_Uint)right; j++)
-         {
-            cur = dc[i][j];
+         cur = dc[i][j];
 
-            // Preliminary test
-            if (fabs(cur) <= preliminary_threshold) continue;
+         // Preliminary test
+         if (fabs(cur) <= preliminary_threshold) continue;
 
-            // Check neighboorhood for extrema validity
-            if (cur > 0.0)
-            {
-               if (cur < dp[i - 1][j - 1]) continue;
-               if (cur < dp[i - 1][j]) continue;
-               if (cur < dp[i - 1][j + 1]) continue;
-               if (cur < dp[i][j - 1]) continue;
-               if (cur < dp[i][j]) continue;
-               if (cur < dp[i][j + 1]) continue;
-               if (cur < dp[i + 1][j - 1]) continue;
-               if (cur < dp[i + 1][j]) continue;
-               if (cur < dp[i + 1][j + 1]) continue;
-
-               if (cur < dn[i - 1][j - 1]) continue;
-               if (cur < dn[i - 1][j]) continue;
-               if (cur < dn[i - 1][j + 1]) continue;
-               if (cur < dn[i][j - 1]) continue;
-               if (cur < dn[i][j]) continue;
-               if (cur < dn[i][j + 1]) continue;
-               if (cur < dn[i + 1][j - 1]) continue;
-               if (cur < dn[i + 1][j]) continue;
-               if (cur < dn[i + 1][j + 1]) continue;
-
-               if (cur < dc[i - 1][j - 1]) continue;
-               if (cur < dc[i - 1][j]) continue;
-               if (cur < dc[i - 1][j + 1]) continue;
-               if (cur < dc[i][j - 1]) continue;
-               if (cur < dc[i][j + 1]) continue;
-               if (cur < dc[i + 1][j - 1]) continue;
-               if (cur < dc[i + 1][j]) continue;
-               if (cur < dc[i + 1][j + 1]) continue;
-
-               isminimal = 1;
-            }
-            else
-            {
-               if (cur > dp[i - 1][j - 1]) continue;
-               if (cur > dp[i - 1][j]) continue;
-               if (cur > dp[i - 1][j + 1]) continue;
-               if (cur > dp[i][j - 1]) continue;
-               if (cur > dp[i][j]) continue;
-               if (cur > dp[i][j + 1]) continue;
-               if (cur > dp[i + 1][j - 1]) continue;
-               if (cur > dp[i + 1][j]) continue;
-               if (cur > dp[i + 1][j + 1]) continue;
-
-               if (cur > dn[i - 1][j - 1]) continue;
-               if (cur > dn[i - 1][j]) continue;
-               if (cur > dn[i - 1][j + 1]) continue;
-               if (cur > dn[i][j - 1]) continue;
-               if (cur > dn[i][j]) continue;
-               if (cur > dn[i][j + 1]) continue;
-               if (cur > dn[i + 1][j - 1]) continue;
-               if (cur > dn[i + 1][j]) continue;
-               if (cur > dn[i + 1][j + 1]) continue;
-
-               if (cur > dc[i - 1][j - 1]) continue;
-               if (cur > dc[i - 1][j]) continue;
-               if (cur > dc[i - 1][j + 1]) continue;
-               if (cur > dc[i][j - 1]) continue;
-               if (cur > dc[i][j + 1]) continue;
-               if (cur > dc[i + 1][j - 1]) continue;
-               if (cur > dc[i + 1][j]) continue;
-               if (cur > dc[i + 1][j + 1]) continue;
-
-               isminimal = 0;
-            }
+         // Check neighboorhood for extrema validity
+         if (cur > 0.0)
+         {
+            if (cur < dp[i - 1][j - 1]) continue;
+            if (cur < dp[i - 1][j]) continue;
+            if (cur < dp[i - 1][j + 1]) continue;
+            if (cur < dp[i][j - 1]) continue;
+            if (cur < dp[i][j]) continue;
+            if (cur < dp[i][j + 1]) continue;
+            if (cur < dp[i + 1][j - 1]) continue;
+            if (cur < dp[i + 1][j]) continue;
+            if (cur < dp[i + 1][j + 1]) continue;
+
+            if (cur < dn[i - 1][j - 1]) continue;
+            if (cur < dn[i - 1][j]) continue;
+            if (cur < dn[i - 1][j + 1]) continue;
+            if (cur < dn[i][j - 1]) continue;
+            if (cur < dn[i][j]) continue;
+            if (cur < dn[i][j + 1]) continue;
+            if (cur < dn[i + 1][j - 1]) continue;
+            if (cur < dn[i + 1][j]) continue;
+            if (cur < dn[i + 1][j + 1]) continue;
+
+            if (cur < dc[i - 1][j - 1]) continue;
+            if (cur < dc[i - 1][j]) continue;
+            if (cur < dc[i - 1][j + 1]) continue;
+            if (cur < dc[i][j - 1]) continue;
+            if (cur < dc[i][j + 1]) continue;
+            if (cur < dc[i + 1][j - 1]) continue;
+            if (cur < dc[i + 1][j]) continue;
+            if (cur < dc[i + 1][j + 1]) continue;
+
+            isminimal = 1;
+         }
+         else
+         {
+            if (cur > dp[i - 1][j - 1]) continue;
+            if (cur > dp[i - 1][j]) continue;
+            if (cur > dp[i - 1][j + 1]) continue;
+            if (cur > dp[i][j - 1]) continue;
+            if (cur > dp[i][j]) continue;
+            if (cur > dp[i][j + 1]) continue;
+            if (cur > dp[i + 1][j - 1]) continue;
+            if (cur > dp[i + 1][j]) continue;
+            if (cur > dp[i + 1][j + 1]) continue;
+
+            if (cur > dn[i - 1][j - 1]) continue;
+            if (cur > dn[i - 1][j]) continue;
+            if (cur > dn[i - 1][j + 1]) continue;
+            if (cur > dn[i][j - 1]) continue;
+            if (cur > dn[i][j]) continue;
+            if (cur > dn[i][j + 1]) continue;
+            if (cur > dn[i + 1][j - 1]) continue;
+            if (cur > dn[i + 1][j]) continue;
+            if (cur > dn[i + 1][j + 1]) continue;
+
+            if (cur > dc[i - 1][j - 1]) continue;
+            if (cur > dc[i - 1][j]) continue;
+            if (cur > dc[i - 1][j + 1]) continue;
+            if (cur > dc[i][j - 1]) continue;
+            if (cur > dc[i][j + 1]) continue;
+            if (cur > dc[i + 1][j - 1]) continue;
+            if (cur > dc[i + 1][j]) continue;
+            if (cur > dc[i + 1][j + 1]) continue;
+
+            isminimal = 0;
+         }
 
-            // Interpolation of local maxima for current feature in the 3D space of image+scale
-            error = rox_dogdetector_interpolate(&curfeat, dogspace, i, j, slice, sol, H, iH, diff, contrast_threshold, curvature_adv_threshold, nbintervals);
-            if (error) continue;
+         // Interpolation of local maxima for current feature in the 3D space of image+scale
+         error = rox_dogdetector_interpolate(&curfeat, dogspace, i, j, slice, sol, H, iH, diff, contrast_threshold, curvature_adv_threshold, nbintervals);
+         if (error) continue;
 
-            // Update feature given current octave
-            curfeat.x *= scale;
-            curfeat.y *= scale;
-            curfeat.octave = octave;
-            finter = (Rox_Float) (curfeat.flvl + curfeat.lvl);
-            curfeat.scale = (float) (sigma *  ROX_POWF(2.0f, ((float) octave) + ((float) finter) / ((float) nbintervals)));
-            curfeat.octave_scale = (float) (sigma *  ROX_POWF(2.0f, ((float) finter) / ((float) nbintervals)));
-            curfeat.isminimal = isminimal;
+         // Update feature given current octave
+         curfeat.x *= scale;
+         curfeat.y *= scale;
+         curfeat.octave = octave;
+         finter = (Rox_Float) (curfeat.flvl + curfeat.lvl);
+         curfeat.scale = (float) (sigma *  ROX_POWF(2.0f, ((float) octave) + ((float) finter) / ((float) nbintervals)));
+         curfeat.octave_scale = (float) (sigma *  ROX_POWF(2.0f, ((float) finter) / ((float) nbintervals)));
+         curfeat.isminimal = isminimal;
 
-            lfeats[count] = curfeat;
+         lfeats[count] = curfeat;
 
-            // Increase memory if needed
-            count++;
-            if (count >= allocated)
+         // Increase memory if needed
+         count++;
+         if (count >= allocated)
+         {
+            allocated += 100;
+            lfeats = (Rox_Dog_Feature )rox_memory_reallocate(lfeats, sizeof(Rox_Dog_Feature_Struct), allocated);
+            if (!lfeats)
             {
-               allocated += 100;
-               lfeats = (Rox_Dog_Feature )rox_memory_reallocate(lfeats, sizeof(Rox_Dog_Feature_Struct), allocated);
-               if (!lfeats)
-               {
-                  error = ROX_ERROR_NULL_POINTER;
-                  ROX_ERROR_CHECK_TERMINATE(error)
-               }
+               *features = NULL;
+               *countFeatures = 0;
+               *allocatedFeatures = 0;
+               error = ROX_ERROR_NULL_POINTER;
+               ROX_ERROR_CHECK_TERMINATE(error)
             }
+            *features = lfeats;
+            *allocatedFeatures = allocated;
          }
       }
    }
 
    *countFeatures = count;
-   *features = lfeats;
 
    // Do not delete the following error setting unless you know what you do
    error = ROX_ERROR_NONE;
@@ -365,6 +377,43 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_dogdetector_process(Rox_Dog_Feature * features, Rox_Uint * countFeatures, Rox_Array2D_Float_Collection dogspace, Rox_Rect_Sint image_bounds, Rox_Float contrast_threshold, Rox_Float curvature_threshold, Rox_Float preliminary_threshold, Rox_Uint nbintervals, Rox_Uint octave, Rox_Float sigma)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Dog_Feature lfeats = NULL;
+   Rox_Uint count = 0, allocated = 0;
+   Rox_Uint countslice;
+
+
+   if (!features) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   
+   if (!countFeatures) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   countslice = rox_array2d_float_collection_get_count(dogspace);
+   if (countslice < 3) { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Sint cols = 0, rows = 0;
+
+   error = rox_array2d_float_get_size(&rows, &cols, rox_array2d_float_collection_get(dogspace, 1)); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint slice = 1; slice < countslice - 1; slice++)
+   {
+      error = rox_dogdetector_process_band(&lfeats, &count, &allocated, dogspace, slice, 0, rows, image_bounds, contrast_threshold, curvature_threshold, preliminary_threshold, nbintervals, octave, sigma);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   *countFeatures = count;
+   *features = lfeats;
+   lfeats = NULL;
+
+function_terminate:
+   rox_memory_delete(lfeats);
+   return error;
+}
+
 Rox_ErrorCode rox_dogspace_create(Rox_Array2D_Float_Collection *dogspace, Rox_Array2D_Float_Collection scalespace)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -71,6 +71,25 @@ typedef struct Rox_Dog_Feature_Struct * Rox_Dog_Feature;
 //! \todo To be tested
 ROX_API Rox_ErrorCode rox_dogdetector_process(Rox_Dog_Feature * features, Rox_Uint * countFeatures, Rox_Array2D_Float_Collection dogspace, Rox_Rect_Sint image_bounds, Rox_Float contrast_threshold, Rox_Float curvature_threshold, Rox_Float preliminary_threshold, Rox_Uint nbintervals, Rox_Uint octave, Rox_Float sigma);
 
+//! Detect features using Lowe DOG method in a band of rows of one slice of a dog space.
+//! The features are appended to an array which is allocated by the first call (*features must then be NULL) and grown when needed.
+//! \param [in,out] features a pointer to the array of detected features
+//! \param [in,out] countFeatures the number of features in the array
+//! \param [in,out] allocatedFeatures the number of allocated features of the array
+//! \param [in] dogspace the input dogspace
+//! \param [in] slice the slice of the dogspace to search, between 1 and the count of slices minus 2
+//! \param [in] first_row the first row of the band
+//! \param [in] last_row the row after the last row of the band
+//! \param [in] image_bounds image rectangle wherein the features must lie
+//! \param [in] contrast_threshold threshold for contrast around feature
+//! \param [in] curvature_threshold threshold for curvature in the area
+//! \param [in] preliminary_threshold minimal dog value
+//! \param [in] nbintervals number of intervals used in dogspace
+//! \param [in] octave id of current octave
+//! \param [in] sigma the current variance
+//! \return An error code
+ROX_API Rox_ErrorCode rox_dogdetector_process_band(Rox_Dog_Feature * features, Rox_Uint * countFeatures, Rox_Uint * allocatedFeatures, Rox_Array2D_Float_Collection dogspace, Rox_Uint slice, Rox_Sint first_row, Rox_Sint last_row, Rox_Rect_Sint image_bounds, Rox_Float contrast_threshold, Rox_Float curvature_threshold, Rox_Float preliminary_threshold, Rox_Uint nbintervals, Rox_Uint octave, Rox_Float sigma);
+
 //! Create a difference of gaussian collection given a scale space collection (one output image for two input images)
 //! \param [out] dogspace a newly allocated collection of images containing the d.o.g.
 //! \param [in] scalespace a collection of images to substract two by two.
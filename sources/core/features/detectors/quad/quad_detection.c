@@ -38,16 +38,6 @@
 #define MIN_AREA_SIZE MIN_SIDE_SIZE * MIN_SIDE_SIZE
 #define MAX_AREA_SIZE MAX_SIDE_SIZE * MAX_SIDE_SIZE
 
-Rox_ErrorCode rox_dynvec_quad_searchquad (
-   Rox_DynVec_Quad quadlist,
-   Rox_Quad_Segment2D * path,
-   Rox_Uint lvl,
-   Rox_Double side_min,
-   Rox_Double side_max,
-   Rox_Double area_min,
-   Rox_Double area_max
-);
-
 Rox_Double mod2pi_pos(Rox_Double vin)
 {
    Rox_Double twopi_inv = 0.5/ROX_PI;
@@ -102,146 +92,106 @@ Rox_ErrorCode rox_quad_compute_area ( Rox_Double * area, Rox_Quad curquad )
    return error;
 }
 
-Rox_ErrorCode rox_dynvec_quad_searchquad (
-   Rox_DynVec_Quad quadlist,
-   Rox_Quad_Segment2D * path,
-   Rox_Uint lvl,
-   Rox_Double side_min,
-   Rox_Double side_max,
-   Rox_Double area_min,
-   Rox_Double area_max
-)
+// Check the winding, the area and the distances from each corner to the opposite sides of a quad
+static Rox_Bool rox_quad_check_shape ( Rox_Quad curquad, Rox_Double area_min, Rox_Double area_max )
 {
-   Rox_ErrorCode error = ROX_ERROR_NONE;
-
-   struct Rox_Quad_Struct curquad;
-
-   Rox_Double coordx = 0.0, coordy = 0.0;
    Rox_Double t1 = 0.0, t2 = 0.0, t3 = 0.0, t0 = 0.0, ttheta = 0.0;
    Rox_Double dist = 0.0;
+   Rox_Double area = 0.0;
 
+   // Check winding (no strange quads)
+   t0 = atan2(curquad->v[1] - curquad->v[0], curquad->u[1] - curquad->u[0]);
+   t1 = atan2(curquad->v[2] - curquad->v[1], curquad->u[2] - curquad->u[1]);
+   t2 = atan2(curquad->v[3] - curquad->v[2], curquad->u[3] - curquad->u[2]);
+   t3 = atan2(curquad->v[0] - curquad->v[3], curquad->u[0] - curquad->u[3]);
 
-   if (!quadlist || !path) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   ttheta = mod2pi(t1-t0) + mod2pi(t2-t1) + mod2pi(t3-t2) + mod2pi(t0-t3);
 
-   // did we arrived at the 4th level ?
-   if (lvl == 4)
-   {
-      // 4 segments
-      Rox_Bool bad = 0;
+   // Test if the total theta is between -5 and -7 radians
+   // Note that 2*pi = 6.2832 radians
+   if (ttheta < -7 || ttheta > -5) return 0;
 
-      // 5th segment must be the 1st to close
-      if (path[4] != path[0])
-      { error = ROX_ERROR_NONE; goto function_terminate; }
+   // Check bounds on area (no too small or too big quads)
+   rox_quad_compute_area(&area, curquad);
+   if ((area < area_min) || (area > area_max)) return 0;
 
-      // Retrieve the 4 coordinates which best represent the quad
-      for ( Rox_Sint i = 0; i < 4; i++)
-      {
-         if (rox_dynvec_quad_segment2d_intersect(&coordx, &coordy, path[i], path[i+1]) == 0)
-         {
-            bad = 1;
-            break;
-         }
-
-         curquad.u[i] = coordx;
-         curquad.v[i] = coordy;
-      }
+   // Check distances from each corners to each opposite segments
+   for ( Rox_Sint i = 0; i < 4; i++)
+   {
+      Rox_Sint i1 = (i + 1) % 4, i2 = (i + 2) % 4, i3 = (i + 3) % 4;
 
-      if (bad)
-      { error = ROX_ERROR_NONE; goto function_terminate; }
+      dist = rox_distance_point2d_to_segment2d_coordinates(curquad->u[i], curquad->v[i], curquad->u[i1], curquad->v[i1], curquad->u[i2], curquad->v[i2]);
+      if (dist < MIN_SIDE_SIZE) return 0;
 
-      // Check winding (no strange quads)
-      t0 = atan2(curquad.v[1] - curquad.v[0], curquad.u[1] - curquad.u[0]);
-      t1 = atan2(curquad.v[2] - curquad.v[1], curquad.u[2] - curquad.u[1]);
-      t2 = atan2(curquad.v[3] - curquad.v[2], curquad.u[3] - curquad.u[2]);
-      t3 = atan2(curquad.v[0] - curquad.v[3], curquad.u[0] - curquad.u[3]);
+      dist = rox_distance_point2d_to_segment2d_coordinates(curquad->u[i], curquad->v[i], curquad->u[i3], curquad->v[i3], curquad->u[i2], curquad->v[i2]);
+      if (dist < MIN_SIDE_SIZE) return 0;
+   }
 
-      ttheta = mod2pi(t1-t0) + mod2pi(t2-t1) + mod2pi(t3-t2) + mod2pi(t0-t3);
+   return 1;
+}
 
-      // Test if the total theta is between -5 and -7 radians
-      // Note that 2*pi = 6.2832 radians
-      if (ttheta < -7 || ttheta > -5)
-      // if (ttheta < 7 || ttheta > 5)
-      { error = ROX_ERROR_NONE; goto function_terminate; }
+// Check the length of the side between two corners of a quad
+static Rox_Bool rox_quad_check_side ( Rox_Quad curquad, Rox_Sint i, Rox_Sint j, Rox_Double side_min, Rox_Double side_max )
+{
+   Rox_Double side_size = sqrt((curquad->v[j] - curquad->v[i])*(curquad->v[j] - curquad->v[i]) + (curquad->u[j] - curquad->u[i])*(curquad->u[j] - curquad->u[i]));
+   return (side_size >= side_min) && (side_size <= side_max);
+}
 
-      // Check bounds on area (no too small or too big quads)
+// Search the closed paths of 4 segments starting from a segment, in depth first order
+// The corner between two consecutive segments and the side ending at this corner are checked as soon as the segment is added to the path,
+// so that the branches which cannot give a valid quad are not explored.
+static Rox_ErrorCode rox_dynvec_quad_searchquad (
+   Rox_DynVec_Quad quadlist,
+   Rox_Quad_Segment2D start,
+   Rox_Double side_min,
+   Rox_Double side_max,
+   Rox_Double area_min,
+   Rox_Double area_max
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-      Rox_Double area = 0.0;
-      error = rox_quad_compute_area(&area, &curquad);
-      ROX_ERROR_CHECK_TERMINATE ( error );
+   struct Rox_Quad_Struct curquad;
+   Rox_Quad_Segment2D path[5];
+   Rox_Uint iter[4] = { 0, 0, 0, 0 };
+   Rox_Sint lvl = 0;
 
-      if ((area < area_min) || (area > area_max))
-      { error = ROX_ERROR_NONE; goto function_terminate; }
+   path[0] = start;
 
-      // Check bounds on size (no too small or too big quads)
+   while (lvl >= 0)
+   {
+      if (iter[lvl] >= path[lvl]->countchildren)
       {
-         Rox_Double side_size_1 = sqrt(((curquad.v[1] - curquad.v[0])*(curquad.v[1] - curquad.v[0]) + (curquad.u[1] - curquad.u[0])*(curquad.u[1] - curquad.u[0])));
-         Rox_Double side_size_2 = sqrt(((curquad.v[2] - curquad.v[1])*(curquad.v[2] - curquad.v[1]) + (curquad.u[2] - curquad.u[1])*(curquad.u[2] - curquad.u[1])));
-         Rox_Double side_size_3 = sqrt(((curquad.v[3] - curquad.v[2])*(curquad.v[3] - curquad.v[2]) + (curquad.u[3] - curquad.u[2])*(curquad.u[3] - curquad.u[2])));
-         Rox_Double side_size_4 = sqrt(((curquad.v[0] - curquad.v[3])*(curquad.v[0] - curquad.v[3]) + (curquad.u[0] - curquad.u[3])*(curquad.u[0] - curquad.u[3])));
-         //Rox_Double diagonal_size_1 = sqrt(((curquad.v[2] - curquad.v[0])*(curquad.v[2] - curquad.v[0]) + (curquad.u[2] - curquad.u[0])*(curquad.u[2] - curquad.u[0])));
-         //Rox_Double diagonal_size_2 = sqrt(((curquad.v[3] - curquad.v[1])*(curquad.v[3] - curquad.v[1]) + (curquad.u[3] - curquad.u[1])*(curquad.u[3] - curquad.u[1])));
-
-         if ((side_size_1 < side_min) ||
-             (side_size_2 < side_min) ||
-             (side_size_3 < side_min) ||
-             (side_size_4 < side_min) ||
-             (side_size_1 > side_max) ||
-             (side_size_2 > side_max) ||
-             (side_size_3 > side_max) ||
-             (side_size_4 > side_max) )
-         {
-            error = ROX_ERROR_NONE; goto function_terminate;
-         }
+         lvl--;
+         continue;
       }
 
-      // Check sizes
-      //if (((curquad.v[1] - curquad.v[0])*(curquad.v[1] - curquad.v[0]) + (curquad.u[1] - curquad.u[0])*(curquad.u[1] - curquad.u[0])) < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-      //if (((curquad.v[2] - curquad.v[1])*(curquad.v[2] - curquad.v[1]) + (curquad.u[2] - curquad.u[1])*(curquad.u[2] - curquad.u[1])) < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-      //if (((curquad.v[3] - curquad.v[2])*(curquad.v[3] - curquad.v[2]) + (curquad.u[3] - curquad.u[2])*(curquad.u[3] - curquad.u[2])) < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-      //if (((curquad.v[0] - curquad.v[3])*(curquad.v[0] - curquad.v[3]) + (curquad.u[0] - curquad.u[3])*(curquad.u[0] - curquad.u[3])) < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-      //if (((curquad.v[2] - curquad.v[0])*(curquad.v[2] - curquad.v[0]) + (curquad.u[2] - curquad.u[0])*(curquad.u[2] - curquad.u[0])) < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-      //if (((curquad.v[3] - curquad.v[1])*(curquad.v[3] - curquad.v[1]) + (curquad.u[3] - curquad.u[1])*(curquad.u[3] - curquad.u[1])) < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-
-      // Check distances from each corners to each opposite segments
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[0], curquad.v[0], curquad.u[1], curquad.v[1], curquad.u[2], curquad.v[2]);
-      if (dist < MIN_SIDE_SIZE) { error = ROX_ERROR_NONE; goto function_terminate; }
-
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[0], curquad.v[0], curquad.u[3], curquad.v[3], curquad.u[2], curquad.v[2]);
-      if (dist < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[1], curquad.v[1], curquad.u[2], curquad.v[2], curquad.u[3], curquad.v[3]);
-      if (dist < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
+      Rox_Quad_Segment2D child = path[lvl]->child[iter[lvl]++];
 
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[1], curquad.v[1], curquad.u[3], curquad.v[3], curquad.u[0], curquad.v[0]);
-      if (dist < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[2], curquad.v[2], curquad.u[0], curquad.v[0], curquad.u[1], curquad.v[1]);
-      if (dist < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[2], curquad.v[2], curquad.u[3], curquad.v[3], curquad.u[0], curquad.v[0]);
-      if (dist < MIN_SIDE_SIZE) {error = ROX_ERROR_NONE; goto function_terminate;}
-
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[3], curquad.v[3], curquad.u[0], curquad.v[0], curquad.u[1], curquad.v[1]);
-      if (dist < MIN_SIDE_SIZE) { error = ROX_ERROR_NONE; goto function_terminate;}
+      // Force a given arbitrary order
+      if (child->theta > path[0]->theta) continue;
 
-      dist = rox_distance_point2d_to_segment2d_coordinates(curquad.u[3], curquad.v[3], curquad.u[1], curquad.v[1], curquad.u[2], curquad.v[2]);
-      if (dist < MIN_SIDE_SIZE) { error = ROX_ERROR_NONE; goto function_terminate;}
+      // 5th segment must be the 1st to close
+      if (lvl == 3 && child != path[0]) continue;
 
-      rox_dynvec_quad_append(quadlist, &curquad);
+      // The corner between the last segment and the new one
+      if (rox_dynvec_quad_segment2d_intersect(&curquad.u[lvl], &curquad.v[lvl], path[lvl], child) == 0) continue;
 
-      {error = ROX_ERROR_NONE; goto function_terminate;}
-   }
+      // Check bounds on size (no too small or too big quads)
+      if (lvl > 0 && !rox_quad_check_side(&curquad, lvl - 1, lvl, side_min, side_max)) continue;
 
-   for (Rox_Uint iter = 0; iter < path[lvl]->countchildren; iter++)
-   {
-      // Force a given arbitrary order
-      if (path[lvl]->child[iter]->theta > path[0]->theta) continue;
+      if (lvl < 3)
+      {
+         path[lvl + 1] = child;
+         lvl++;
+         iter[lvl] = 0;
+         continue;
+      }
 
-      path[lvl+1] = path[lvl]->child[iter];
+      if (!rox_quad_check_side(&curquad, 3, 0, side_min, side_max)) continue;
+      if (!rox_quad_check_shape(&curquad, area_min, area_max)) continue;
 
-      // Check this branch of the tree
-      error = rox_dynvec_quad_searchquad ( quadlist, path, lvl+1, side_min, side_max, area_min, area_max );
+      error = rox_dynvec_quad_append(quadlist, &curquad);
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
@@ -259,7 +209,6 @@ Rox_ErrorCode rox_dynvec_quad_computequads (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Quad_Segment2D path[5];
 
 
    if (!quadlist || !seglist) 
@@ -268,10 +217,8 @@ Rox_ErrorCode rox_dynvec_quad_computequads (
    rox_dynvec_quad_reset(quadlist);
    for (Rox_Uint i = 0; i < seglist->used; i++)
    {
-      path[0] = &seglist->data[i];
-
       // Search for a quad starting at this segment
-      error = rox_dynvec_quad_searchquad ( quadlist, path, 0, side_min, side_max, area_min, area_max );
+      error = rox_dynvec_quad_searchquad ( quadlist, &seglist->data[i], side_min, side_max, area_min, area_max );
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
@@ -59,6 +59,7 @@ Rox_ErrorCode rox_gradientclusterer_new(Rox_GradientClusterer *ptr, Rox_Uint iwi
    ret->nbgroups = 0;
    ret->width = iwidth;
    ret->height = iheight;
+   ret->count_bands = ( iheight + ROX_GRADIENTCLUSTERER_BAND - 1 ) / ROX_GRADIENTCLUSTERER_BAND;
 
    ret->gmag = NULL; // Rox_Uint
    ret->gmagmax = NULL; // Rox_Uint
@@ -73,6 +74,7 @@ Rox_ErrorCode rox_gradientclusterer_new(Rox_GradientClusterer *ptr, Rox_Uint iwi
    ret->edges = NULL;
    ret->sortededges = NULL;
    ret->edgecounters = NULL;
+   ret->band_nbedges = NULL;
    ret->groups = NULL;
    ret->edgedraw = NULL;
    ret->preproc = NULL;
@@ -111,14 +113,18 @@ Rox_ErrorCode rox_gradientclusterer_new(Rox_GradientClusterer *ptr, Rox_Uint iwi
    if ( !ret->edges )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
 
-   ret->sortededges = (LabelEdge) rox_memory_allocate(sizeof(struct LabelEdge_Struct), iwidth*iheight);
+   ret->sortededges = (LabelEdge) rox_memory_allocate(sizeof(struct LabelEdge_Struct), iwidth*iheight * 4);
    if ( !ret->sortededges )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
 
-   ret->edgecounters = (Rox_Uint *) rox_memory_allocate(sizeof(*ret->edgecounters), iwidth*iheight);
+   ret->edgecounters = (Rox_Uint *) rox_memory_allocate(sizeof(*ret->edgecounters), ret->count_bands * ROX_GRADIENTCLUSTERER_COSTS);
    if ( !ret->edgecounters )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
 
+   ret->band_nbedges = (Rox_Uint *) rox_memory_allocate(sizeof(*ret->band_nbedges), ret->count_bands);
+   if ( !ret->band_nbedges )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
+
    ret->groups = (Rox_DynVec_OrientedImagePoint *) rox_memory_allocate(sizeof(Rox_DynVec_OrientedImagePoint), iwidth*iheight);
    if ( !ret->groups )
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error); }
@@ -186,6 +192,9 @@ Rox_ErrorCode rox_gradientclusterer_reset(Rox_GradientClusterer ptr)
 
    if (ptr->nodes)
    {
+#ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(static)
+#endif
       for (Rox_Uint i = 0; i < basesize; i++)
       {
          ptr->nodes[i].countref = 1;
@@ -231,6 +240,7 @@ Rox_ErrorCode rox_gradientclusterer_del(Rox_GradientClusterer *ptr)
    rox_memory_delete(todel->edges);
    rox_memory_delete(todel->sortededges);
    rox_memory_delete(todel->edgecounters);
+   rox_memory_delete(todel->band_nbedges);
    rox_memory_delete(todel->groups);
 
    ROX_ERROR_CHECK(rox_edgepostproc_normal_del(&todel->normals));
@@ -271,6 +281,8 @@ Rox_Sint rox_gradientclusterer_edgecost(Rox_Double theta0, Rox_Uint mag0, Rox_Do
 }
 
 // Fast method to sort edges by their cost
+// Each band has its own counters so that the edges are placed in parallel,
+// the edges of same cost are ordered by band and the result is the same as a sequential counting sort.
 Rox_ErrorCode rox_gradientclusterer_edgesort(Rox_GradientClusterer ptr)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -281,69 +293,67 @@ Rox_ErrorCode rox_gradientclusterer_edgesort(Rox_GradientClusterer ptr)
       error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error);
    }
 
-   // Compute maximum edge cost
-   Rox_Sint maxv = -1;
-   for (Rox_Uint i = 0; i < ptr->nbedges; i++)
-   {
-      maxv = ROX_MAX(maxv, (int)ptr->edges[i].cost);
-   }
-
-   // Initialize edge counters
-   Rox_Uint clength = maxv + 2;
-   for (Rox_Uint i = 0; i < clength; i++)
-   {
-      ptr->edgecounters[i] = 0;
-   }
-
-   // For each edge cost value, count the number of edges with this value
-   for (Rox_Uint i = 0; i < ptr->nbedges; i++)
-   {
-      int w = (int)(ptr->edges[i].cost);
-      ptr->edgecounters[w + 1]++;
-   }
-
-   // Each edge bin counter is accumulated with the previous one
-   for (Rox_Uint i = 1; i < clength; i++)
+   // Each edge bin counter of each band is accumulated with the previous ones
+   Rox_Uint offset = 0;
+   for (Rox_Sint w = 0; w < ROX_GRADIENTCLUSTERER_COSTS; w++)
    {
-      ptr->edgecounters[i] += ptr->edgecounters[i - 1];
+      for (Rox_Sint b = 0; b < ptr->count_bands; b++)
+      {
+         Rox_Uint * counter = &ptr->edgecounters[b * ROX_GRADIENTCLUSTERER_COSTS + w];
+         Rox_Uint count = *counter;
+         *counter = offset;
+         offset += count;
+      }
    }
 
-   // Initialize output
-   for (Rox_Uint i = 0; i < ptr->nbedges; i++)
+   // Using these accumulated counters, we are able to quickly place edges sorted by their cost
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (Rox_Sint b = 0; b < ptr->count_bands; b++)
    {
-      ptr->sortededges[i].cur = 0;
-      ptr->sortededges[i].assoc = 0;
-      ptr->sortededges[i].cost = 0;
-   }
+      LabelEdge edges = &ptr->edges[b * ROX_GRADIENTCLUSTERER_BAND * ptr->width * 4];
+      Rox_Uint * counters = &ptr->edgecounters[b * ROX_GRADIENTCLUSTERER_COSTS];
 
-   // Using this accumulated counter, we are able to quickly place edges sorted by their cost
-   for (Rox_Uint i = 0; i < ptr->nbedges; i++)
-   {
-      int w = (int)(ptr->edges[i].cost);
-      ptr->sortededges[ptr->edgecounters[w]] = ptr->edges[i];
-      ptr->edgecounters[w]++;
+      for (Rox_Uint i = 0; i < ptr->band_nbedges[b]; i++)
+      {
+         ptr->sortededges[counters[edges[i].cost]++] = edges[i];
+      }
    }
 
 function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_gradientclusterer_computeedges(Rox_GradientClusterer ptr)
+// Store an edge of a band and count it with the edges of same cost
+static inline void rox_gradientclusterer_addedge(LabelEdge edges, Rox_Uint * nbedges, Rox_Uint * counters, Rox_Uint cur, Rox_Uint assoc, Rox_Sint cost)
 {
-   Rox_ErrorCode error = ROX_ERROR_NONE;
+   LabelEdge edge = &edges[*nbedges];
 
+   edge->cur = cur;
+   edge->assoc = assoc;
+   edge->cost = cost;
 
-   if (!ptr)
-   {
-      error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error);
-   }
+   counters[cost]++;
+   (*nbedges)++;
+}
 
+// Compute the edges of the pixels of a band of rows
+static void rox_gradientclusterer_computeedges_band(Rox_GradientClusterer ptr, Rox_Sint band)
+{
    Rox_Uint * dgm = ptr->gmag;
    Rox_Float * dgt = ptr->gtheta;
-   LabelEdge edges = ptr->edges;
+   LabelEdge edges = &ptr->edges[band * ROX_GRADIENTCLUSTERER_BAND * ptr->width * 4];
+   Rox_Uint * counters = &ptr->edgecounters[band * ROX_GRADIENTCLUSTERER_COSTS];
+   Rox_Uint nbedges = 0;
+
+   Rox_Sint first = ROX_MAX(1, band * ROX_GRADIENTCLUSTERER_BAND);
+   Rox_Sint last = ROX_MIN(ptr->height - 1, (band + 1) * ROX_GRADIENTCLUSTERER_BAND);
+
+   memset(counters, 0, ROX_GRADIENTCLUSTERER_COSTS * sizeof(*counters));
 
    // Loop over all pixels where a gradient is defined
-   for (Rox_Sint i = 1; i < ptr->height - 1; i++)
+   for (Rox_Sint i = first; i < last; i++)
    {
       for (Rox_Sint j = 1; j < ptr->width - 1; j++)
       {
@@ -379,54 +389,50 @@ Rox_ErrorCode rox_gradientclusterer_computeedges(Rox_GradientClusterer ptr)
 
          // Right pixel
          cost = rox_gradientclusterer_edgecost(theta0, mag0, dgt[id1], dgm[id1]);
-         if (cost >= 0)
-         {
-            edges->cur = idr;
-            edges->assoc = id1;
-            edges->cost = cost;
-
-            edges++;
-            ptr->nbedges++;
-         }
+         if (cost >= 0) rox_gradientclusterer_addedge(edges, &nbedges, counters, idr, id1, cost);
 
          // Bottom pixel
          cost = rox_gradientclusterer_edgecost(theta0, mag0, dgt[id2], dgm[id2]);
-         if (cost >= 0)
-         {
-            edges->cur = idr;
-            edges->assoc = id2;
-            edges->cost = cost;
-
-            edges++;
-            ptr->nbedges++;
-         }
+         if (cost >= 0) rox_gradientclusterer_addedge(edges, &nbedges, counters, idr, id2, cost);
 
          // Bottom Right pixel
          cost = rox_gradientclusterer_edgecost(theta0, mag0, dgt[id3], dgm[id3]);
-         if (cost >= 0)
-         {
-            edges->cur = idr;
-            edges->assoc = id3;
-            edges->cost = cost;
-
-            edges++;
-            ptr->nbedges++;
-         }
+         if (cost >= 0) rox_gradientclusterer_addedge(edges, &nbedges, counters, idr, id3, cost);
 
          // Bottom left pixel
-         cost = (j == 0) ? -1 : rox_gradientclusterer_edgecost(theta0, mag0, dgt[id4], dgm[id4]);
-         if (cost >= 0)
-         {
-            edges->cur = idr;
-            edges->assoc = id4;
-            edges->cost = cost;
-
-            edges++;
-            ptr->nbedges++;
-         }
+         cost = rox_gradientclusterer_edgecost(theta0, mag0, dgt[id4], dgm[id4]);
+         if (cost >= 0) rox_gradientclusterer_addedge(edges, &nbedges, counters, idr, id4, cost);
       }
    }
 
+   ptr->band_nbedges[band] = nbedges;
+}
+
+Rox_ErrorCode rox_gradientclusterer_computeedges(Rox_GradientClusterer ptr)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+
+   if (!ptr)
+   {
+      error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE(error);
+   }
+
+   // Each band stores its edges in its own part of the edge buffer
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (Rox_Sint b = 0; b < ptr->count_bands; b++)
+   {
+      rox_gradientclusterer_computeedges_band(ptr, b);
+   }
+
+   ptr->nbedges = 0;
+   for (Rox_Sint b = 0; b < ptr->count_bands; b++)
+   {
+      ptr->nbedges += ptr->band_nbedges[b];
+   }
+
 function_terminate:
    return error;
 }
@@ -586,6 +592,9 @@ Rox_ErrorCode rox_gradientclusterer_groups(Rox_GradientClusterer ptr)
 
          idx = i*ptr->width + j;
 
+         // A pixel with a weak gradient has no edge and is alone in its group
+         if (ptr->gmag[idx] < MINMAG) continue;
+
          // Get node data associated with pixel
          rep = rox_gradientclusterer_getrepresentative(ptr->nodes, idx);
          size = ptr->nodes[rep].countref;
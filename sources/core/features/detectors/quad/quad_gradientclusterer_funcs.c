@@ -63,11 +63,6 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint idx = 0;
-
-   Rox_Sint dxm = 0, dxp = 0, dym = 0, dyp = 0, dx = 0, dy = 0;
-   Rox_Float theta = 0.0;
-   Rox_Uint scale = 0;
    Rox_Sint cols = 0, rows = 0;
 
    Rox_Uchar ** src = NULL;
@@ -75,9 +70,6 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
    Rox_Uint * ptrTMag = NULL;
    Rox_Float * ptrTheta = NULL;
 
-   Rox_Uint count_filtered_1 = 0;
-   Rox_Uint count_filtered_2 = 0;
-
    // Hard coded thresholds
 
    Rox_Uint scale_threshold_1 = SQUARE_SCALE_GRADIENT_MIN;
@@ -104,6 +96,9 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
    // Ignore the borders
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
    for ( Rox_Sint i = 1; i < rows - 1; i++)
    {
       Rox_Uchar * ptrprpc = &src[i - 1][0];
@@ -118,7 +113,10 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
 
       for ( Rox_Sint j = 1; j < cols - 1; j++)
       {
-         idx = i * cols + j;
+         Rox_Uint idx = i * cols + j;
+         Rox_Sint dxm = 0, dxp = 0, dym = 0, dyp = 0, dx = 0, dy = 0;
+         Rox_Float theta = 0.0;
+         Rox_Uint scale = 0;
 
          // Compute Sobel image gradient
          dyp = 2*(*ptrnrcc) + (*ptrnrpc) + (*ptrnrnc);
@@ -150,7 +148,6 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
 #ifdef NOFILTER_ISOLATED_PIXELS
             ptrTMag[idx] = 0;
 #endif
-            count_filtered_1++;
             continue;
          }
 
@@ -171,13 +168,15 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
    // We keep only gradients that have sufficiently strong neighbors
    // so that we filter isolated points
    // We do not consider the borders ( 2 pixel on each border )
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
    for ( Rox_Sint i = 2; i < rows - 2; i++)
    {
       for ( Rox_Sint j = 2; j < cols - 2; j++)
       {
-         idx = i * cols + j;
-
-         scale = ptrMag[i][j];
+         Rox_Uint idx = i * cols + j;
+         Rox_Uint scale = ptrMag[i][j];
 
          if (scale < scale_threshold_1)
          {
@@ -198,7 +197,6 @@ Rox_ErrorCode rox_gradientclusterer_buildgradients (
 
             if (scale < scale_threshold_2)
             {
-               count_filtered_2++;
                ptrTMag[idx] = 0;
                continue;
             }
@@ -223,7 +221,6 @@ Rox_ErrorCode rox_image_gradient_angle_scale_nomask_filter_buffers(
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Sint cols = 0, rows = 0;
    Rox_Uint ** ptrMag_tmp = NULL;
-   Rox_Uint count_filtered_2 = 0;
 
 
    error = rox_array2d_uint_get_size(&rows, &cols, mag_tmp); 
@@ -237,9 +234,9 @@ Rox_ErrorCode rox_image_gradient_angle_scale_nomask_filter_buffers(
 
    // We do not consider the borders ( 2 pixels on each border )
 
-// #ifdef ROX_USES_OPENMP
-//    #pragma omp parallel for schedule(dynamic)
-// #endif
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
    for ( Rox_Sint i = 2; i < rows - 2; i++)
    {
       for ( Rox_Sint j = 2; j < cols - 2; j++)
@@ -264,7 +261,6 @@ Rox_ErrorCode rox_image_gradient_angle_scale_nomask_filter_buffers(
             {
                ptrTMag[idx] = 0;
                ptrTheta[idx] = 0;
-               count_filtered_2++;
                continue;
             }
          }
@@ -33,6 +33,12 @@
 #define MAGTHRESH 1248480000 // 1200.0 
 #define MINSEGSIZE 4
 
+//! Number of rows of the bands whose edges are computed in parallel
+#define ROX_GRADIENTCLUSTERER_BAND 128
+
+//! Number of distinct edge costs
+#define ROX_GRADIENTCLUSTERER_COSTS ( WEIGHT_SCALE + 1 )
+
 //! Structure 
 struct LabelEdge_Struct
 {
@@ -68,6 +74,12 @@ struct Rox_GradientClusterer_Struct
    //! To be commented 
    Rox_Uint nbedges;
 
+   //! The number of bands of rows processed in parallel
+   Rox_Sint count_bands;
+
+   //! The number of edges of each band, stored from the band offset band * ROX_GRADIENTCLUSTERER_BAND * width * 4 in edges
+   Rox_Uint * band_nbedges;
+
    //! This is a temporary variable used to compute the image gradient
    //! It may be embedded in the corresponding function
    //! It may also be of type Sshort 
@@ -103,7 +115,7 @@ struct Rox_GradientClusterer_Struct
    //! To be commented 
    LabelEdge sortededges;
    
-   //! To be commented 
+   //! The counters of the edges of each cost, for each band
    Rox_Uint * edgecounters;
 
    //! To be commented 
@@ -0,0 +1,50 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_codedframe_bits.c
+//
+//    Contents  : Implementation of codedframe_bits module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#include "ansi_codedframe_bits.h"
+
+int rox_ansi_codedframe_read_bits (
+   unsigned long long * bits,
+   unsigned char ** image,
+   const int rows,
+   const int cols,
+   const float * u,
+   const float * v,
+   const int count
+)
+{
+   *bits = 0;
+
+   for ( int k = 0; k < count; k++ )
+   {
+      const int cx = (int) u[k];
+      const int cy = (int) v[k];
+
+      if ( cx < 0 || cy < 0 || cx >= cols - 1 || cy >= rows - 1 ) continue;
+
+      const double dx = u[k] - (double) cx;
+      const double dy = v[k] - (double) cy;
+
+      const double b1 = (double) image[cy][cx];
+      const double b2 = (double) image[cy][cx + 1] - b1;
+      const double b3 = (double) image[cy + 1][cx] - b1;
+      const double b4 = b1 + (double) image[cy + 1][cx + 1] - (double) image[cy + 1][cx] - (double) image[cy][cx + 1];
+
+      const double val = b1 + b2 * dx + b3 * dy + b4 * dx * dy;
+
+      if ( val >= 128.0 ) *bits |= 1ULL << k;
+   }
+
+   return 0;
+}
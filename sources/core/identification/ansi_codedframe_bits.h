@@ -0,0 +1,33 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_codedframe_bits.h
+//
+//    Contents  : API of codedframe_bits module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#ifndef __OPENROX_ANSI_CODEDFRAME_BITS__
+#define __OPENROX_ANSI_CODEDFRAME_BITS__
+
+//! Read the cells of a coded frame
+//! The ansi version and the sse version share the same interface
+
+//! Bit k of bits is set if the bilinear interpolation (in double) of the image at ( u[k], v[k] ) is at least 128
+//! The cells whose 2x2 neighbourhood is not inside the image are read as 0 (count <= 64)
+int rox_ansi_codedframe_read_bits (
+   unsigned long long * bits,
+   unsigned char ** image,
+   const int rows,
+   const int cols,
+   const float * u,
+   const float * v,
+   const int count
+);
+
+#endif
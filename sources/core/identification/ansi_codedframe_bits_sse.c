@@ -0,0 +1,130 @@
+//============================================================================
+//
+//    OPENROX   : File ansi_codedframe_bits_sse.c
+//
+//    Contents  : Implementation of codedframe_bits module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//============================================================================
+
+#include "ansi_codedframe_bits.h"
+
+#include <system/vectorisation/sse.h>
+
+// Bits of two cells, the interpolation is done in double as in the ansi version so that both versions read the same bits
+static inline int rox_ansi_codedframe_read_bits_pd (
+   const __m128d sseu,
+   const __m128d ssev,
+   const __m128i ssecx,
+   const __m128i ssecy,
+   const double * p00,
+   const double * p01,
+   const double * p10,
+   const double * p11
+)
+{
+   const __m128d ssedx = _mm_sub_pd(sseu, _mm_cvtepi32_pd(ssecx));
+   const __m128d ssedy = _mm_sub_pd(ssev, _mm_cvtepi32_pd(ssecy));
+
+   const __m128d sse00 = _mm_load_pd(p00);
+   const __m128d sse01 = _mm_load_pd(p01);
+   const __m128d sse10 = _mm_load_pd(p10);
+   const __m128d sse11 = _mm_load_pd(p11);
+
+   const __m128d sseb2 = _mm_sub_pd(sse01, sse00);
+   const __m128d sseb3 = _mm_sub_pd(sse10, sse00);
+   const __m128d sseb4 = _mm_sub_pd(_mm_sub_pd(_mm_add_pd(sse00, sse11), sse10), sse01);
+
+   __m128d sseval = _mm_add_pd(sse00, _mm_mul_pd(sseb2, ssedx));
+   sseval = _mm_add_pd(sseval, _mm_mul_pd(sseb3, ssedy));
+   sseval = _mm_add_pd(sseval, _mm_mul_pd(_mm_mul_pd(sseb4, ssedx), ssedy));
+
+   return _mm_movemask_pd(_mm_cmpge_pd(sseval, _mm_set1_pd(128.0)));
+}
+
+int rox_ansi_codedframe_read_bits (
+   unsigned long long * bits,
+   unsigned char ** image,
+   const int rows,
+   const int cols,
+   const float * u,
+   const float * v,
+   const int count
+)
+{
+   int k = 0;
+   ROX_STATIC_ALIGN(16) int ix[4], iy[4];
+   ROX_STATIC_ALIGN(16) double p00[4], p01[4], p10[4], p11[4];
+
+   const __m128i ssemone = _mm_set1_epi32(-1);
+   const __m128i ssemaxx = _mm_set1_epi32(cols - 1);
+   const __m128i ssemaxy = _mm_set1_epi32(rows - 1);
+
+   *bits = 0;
+
+   // No 2x2 neighbourhood inside the image, the clamped cells below would read outside of it
+   if ( rows < 2 || cols < 2 ) return 0;
+
+   for ( k = 0; k + 4 <= count; k += 4 )
+   {
+      const __m128 sseu = _mm_loadu_ps(&u[k]);
+      const __m128 ssev = _mm_loadu_ps(&v[k]);
+
+      // Truncation as the scalar version, out of range and NaN coordinates give INT_MIN
+      __m128i ssecx = _mm_cvttps_epi32(sseu);
+      __m128i ssecy = _mm_cvttps_epi32(ssev);
+
+      __m128i ssevalid = _mm_and_si128(_mm_cmpgt_epi32(ssecx, ssemone), _mm_cmpgt_epi32(ssecy, ssemone));
+      ssevalid = _mm_and_si128(ssevalid, _mm_cmplt_epi32(ssecx, ssemaxx));
+      ssevalid = _mm_and_si128(ssevalid, _mm_cmplt_epi32(ssecy, ssemaxy));
+
+      // Invalid cells read the first pixel, their bit is cleared below
+      ssecx = _mm_and_si128(ssecx, ssevalid);
+      ssecy = _mm_and_si128(ssecy, ssevalid);
+      _mm_store_si128((__m128i *) ix, ssecx);
+      _mm_store_si128((__m128i *) iy, ssecy);
+
+      for ( int l = 0; l < 4; l++ )
+      {
+         const unsigned char * row0 = image[iy[l]] + ix[l];
+         const unsigned char * row1 = image[iy[l] + 1] + ix[l];
+         p00[l] = row0[0];
+         p01[l] = row0[1];
+         p10[l] = row1[0];
+         p11[l] = row1[1];
+      }
+
+      // Cells 0 and 1, then cells 2 and 3
+      const int masklo = rox_ansi_codedframe_read_bits_pd(_mm_cvtps_pd(sseu), _mm_cvtps_pd(ssev), ssecx, ssecy, p00, p01, p10, p11);
+      const int maskhi = rox_ansi_codedframe_read_bits_pd(_mm_cvtps_pd(_mm_movehl_ps(sseu, sseu)), _mm_cvtps_pd(_mm_movehl_ps(ssev, ssev)), _mm_srli_si128(ssecx, 8), _mm_srli_si128(ssecy, 8), p00 + 2, p01 + 2, p10 + 2, p11 + 2);
+
+      const int mask = ( masklo | ( maskhi << 2 ) ) & _mm_movemask_ps(_mm_castsi128_ps(ssevalid));
+
+      *bits |= ( (unsigned long long) mask ) << k;
+   }
+
+   for ( ; k < count; k++ )
+   {
+      const int cx = (int) u[k];
+      const int cy = (int) v[k];
+
+      if ( cx < 0 || cy < 0 || cx >= cols - 1 || cy >= rows - 1 ) continue;
+
+      const double dx = u[k] - (double) cx;
+      const double dy = v[k] - (double) cy;
+
+      const double b1 = (double) image[cy][cx];
+      const double b2 = (double) image[cy][cx + 1] - b1;
+      const double b3 = (double) image[cy + 1][cx] - b1;
+      const double b4 = b1 + (double) image[cy + 1][cx + 1] - (double) image[cy + 1][cx] - (double) image[cy][cx + 1];
+
+      if ( b1 + b2 * dx + b3 * dy + b4 * dx * dy >= 128.0 ) *bits |= 1ULL << k;
+   }
+
+   return 0;
+}
@@ -16,9 +16,9 @@
 
 #include <baseproc/array/multiply/mulmatmat.h>
 #include <baseproc/array/fill/fillunit.h>
-#include <baseproc/image/remap/remap_bilinear_onepixel/remap_bilinear_onepixel.h>
 #include <baseproc/tools/encoder/bch.h>
-#include <baseproc/geometry/point/point2d_struct.h>
+
+#include "ansi_codedframe_bits.h"
 
 #include <inout/system/errors_print.h>
 
@@ -87,121 +87,94 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_codedframe_make64(Rox_CodedFrame obj, Rox_Image image, Rox_MatSL3 H)
+// Get the image positions of the centers of the code cells, in bit order
+static void rox_codedframe_project_cells ( Rox_Float * pu, Rox_Float * pv, Rox_Double ** dh, const Rox_Sint code_bits )
 {
-   Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uchar val;
-   Rox_Double u, v, nu, nv, nw;
-   Rox_Point2D_Float_Struct pts[64];
-   Rox_Uchar values[64] = {0};
-   Rox_Ulint res = 0;
-
-   if (!obj || !image || !H)
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   // The homography H contains the position on the texture
-   // The homography G contains the shift to trasnform the origin to the top-left corner of the photoframe
-   error = rox_array2d_double_mulmatmat(obj->cH, H, obj->G);
+   Rox_Double u[64], v[64];
+   Rox_Sint count = 0;
 
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   if (code_bits == 64)
+   {
+      // Left codeblocks
+      for (Rox_Sint i = 0; i < 16; i++, count++)
+      {
+         // Get the center of the 8x8 squares (codeblock)
+         u[count] = CODES_BLOCKS_SIZE / 2 ;
+         v[count] = CODES_BLOCKS_SIZE / 2 + CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
+      }
 
-   Rox_Double ** dh = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dh, obj->cH);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      // Right codeblocks
+      for (Rox_Sint i = 0; i < 16; i++, count++)
+      {
+         u[count] = CODES_BLOCKS_SIZE / 2 + 2*CODES_TSHIFT + CODES_BLOCKS_SIZE + TEXTURE_SIZE;
+         v[count] = CODES_BLOCKS_SIZE / 2 +   CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
+      }
 
-   // Left codeblocks
-   for (Rox_Sint i = 0; i < 16; i++)
-   {
-      // Get the center of the 8x8 squares (codeblock)
-      u = CODES_BLOCKS_SIZE / 2 ;
-      v = CODES_BLOCKS_SIZE / 2 + CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
-
-      nu = dh[0][0] * u + dh[0][1] * v + dh[0][2];
-      nv = dh[1][0] * u + dh[1][1] * v + dh[1][2];
-      nw = dh[2][0] * u + dh[2][1] * v + dh[2][2];
-      pts[0 + i].u = (Rox_Float)(nu / nw);
-      pts[0 + i].v = (Rox_Float)(nv / nw);
+      // Top codeblocks
+      for (Rox_Sint i = 0; i < 16; i++, count++)
+      {
+         u[count] = CODES_BLOCKS_SIZE / 2 + CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
+         v[count] = CODES_BLOCKS_SIZE / 2 ;
+      }
    }
 
-   // Right codeblocks
-   for (Rox_Sint i = 0; i < 16; i++)
+   // Bottom codeblocks, the only ones of the 16 bits code
+   for (Rox_Sint i = 0; i < 16; i++, count++)
    {
-      u = CODES_BLOCKS_SIZE / 2 + 2*CODES_TSHIFT + CODES_BLOCKS_SIZE + TEXTURE_SIZE;
-      v = CODES_BLOCKS_SIZE / 2 +   CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
-
-      nu = dh[0][0] * u + dh[0][1] * v + dh[0][2];
-      nv = dh[1][0] * u + dh[1][1] * v + dh[1][2];
-      nw = dh[2][0] * u + dh[2][1] * v + dh[2][2];
-      pts[16 + i].u = (Rox_Float)(nu / nw);
-      pts[16 + i].v = (Rox_Float)(nv / nw);
+      u[count] = CODES_BLOCKS_SIZE / 2 +   CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
+      v[count] = CODES_BLOCKS_SIZE / 2 + 2*CODES_TSHIFT + CODES_BLOCKS_SIZE + TEXTURE_SIZE;
    }
 
-   // Top codeblocks
-   for (Rox_Sint i = 0; i < 16; i++)
+   for (Rox_Sint i = 0; i < count; i++)
    {
-      u = CODES_BLOCKS_SIZE / 2 + CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
-      v = CODES_BLOCKS_SIZE / 2 ;
-
-      nu = dh[0][0] * u + dh[0][1] * v + dh[0][2];
-      nv = dh[1][0] * u + dh[1][1] * v + dh[1][2];
-      nw = dh[2][0] * u + dh[2][1] * v + dh[2][2];
-      pts[32 + i].u = (Rox_Float)(nu / nw);
-      pts[32 + i].v = (Rox_Float)(nv / nw);
+      Rox_Double nu = dh[0][0] * u[i] + dh[0][1] * v[i] + dh[0][2];
+      Rox_Double nv = dh[1][0] * u[i] + dh[1][1] * v[i] + dh[1][2];
+      Rox_Double nw = dh[2][0] * u[i] + dh[2][1] * v[i] + dh[2][2];
+      pu[i] = (Rox_Float)(nu / nw);
+      pv[i] = (Rox_Float)(nv / nw);
    }
+}
 
-   // Bottom codeblocks
-   for (Rox_Sint i = 0; i < 16; i++)
-   {
-      u = CODES_BLOCKS_SIZE / 2 +   CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
-      v = CODES_BLOCKS_SIZE / 2 + 2*CODES_TSHIFT + CODES_BLOCKS_SIZE + TEXTURE_SIZE;
-
-      nu = dh[0][0] * u + dh[0][1] * v + dh[0][2];
-      nv = dh[1][0] * u + dh[1][1] * v + dh[1][2];
-      nw = dh[2][0] * u + dh[2][1] * v + dh[2][2];
-      pts[48 + i].u = (Rox_Float)(nu / nw);
-      pts[48 + i].v = (Rox_Float)(nv / nw);
-   }
+// Read and decode the code of a frame given the code homography cH
+static Rox_ErrorCode rox_codedframe_decode ( Rox_Uint * value, Rox_Uchar ** data, const Rox_Sint rows, const Rox_Sint cols, Rox_Double ** dh, const Rox_Sint code_bits )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   ROX_STATIC_ALIGN(16) Rox_Float u[64];
+   ROX_STATIC_ALIGN(16) Rox_Float v[64];
+   unsigned long long bits = 0;
+   Rox_Uchar val = 0;
 
-   for (Rox_Sint i = 0; i < 64; i++)
-   {
-      error = rox_remap_onepixel_bilinear_uchar(&val, image, &pts[i]);
-      if (error) val = 0;
+   rox_codedframe_project_cells ( u, v, dh, code_bits );
 
-      if (val < 128) values[i] = 0;
-      else values[i] = 1;
-   }
+   rox_ansi_codedframe_read_bits ( &bits, data, rows, cols, u, v, code_bits );
 
-   res = 0;
-   for (Rox_Sint i = 0; i < 64; i++)
+   if (code_bits == 64)
    {
-      if (values[i])
-      {
-         long bin = i;
-         res |= (Rox_Ulint) (1ULL << bin);
-      }
+      error = rox_bch_c8_e8_decode(&val, (Rox_Ulint) bits);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+   else
+   {
+      error = rox_bch_c6_e2_decode(&val, (Rox_Ushort) bits);
+      ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
-   error = rox_bch_c8_e8_decode(&val, res);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   obj->value = val;
+   *value = val;
 
 function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_codedframe_make16(Rox_CodedFrame obj, Rox_Image image, Rox_MatSL3 H)
+// Compute the code homography of a frame and decode it
+static Rox_ErrorCode rox_codedframe_make(Rox_CodedFrame obj, Rox_Image image, Rox_MatSL3 H, const Rox_Sint code_bits)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uchar val;
-   Rox_Point2D_Float_Struct pts[16];
-   Rox_Uchar values[16];
-   Rox_Ushort res = 0;
 
    if (!obj || !image || !H)
-
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   // The homography H contains the position on the texture
+   // The homography G contains the shift to trasnform the origin to the top-left corner of the photoframe
    error = rox_array2d_double_mulmatmat(obj->cH, H, obj->G);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -209,43 +182,84 @@ Rox_ErrorCode rox_codedframe_make16(Rox_CodedFrame obj, Rox_Image image, Rox_Mat
    error = rox_array2d_double_get_data_pointer_to_pointer( &dh, obj->cH);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Bottom
-   for ( Rox_Sint i = 0; i < 16; i++)
-   {
-      Rox_Double u = CODES_BLOCKS_SIZE / 2 +    CODES_TSHIFT + CODES_BLOCKS_SIZE + i * CODES_BLOCKS_SIZE;
-      Rox_Double v = CODES_BLOCKS_SIZE / 2 + 2*CODES_TSHIFT + CODES_BLOCKS_SIZE + TEXTURE_SIZE;
+   Rox_Sint rows = 0, cols = 0;
+   error = rox_image_get_size(&rows, &cols, image);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-      Rox_Double nu = dh[0][0] * u + dh[0][1] * v + dh[0][2];
-      Rox_Double nv = dh[1][0] * u + dh[1][1] * v + dh[1][2];
-      Rox_Double nw = dh[2][0] * u + dh[2][1] * v + dh[2][2];
+   Rox_Uchar ** data = NULL;
+   error = rox_image_get_data_pointer_to_pointer(&data, image);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-      pts[i].u = (Rox_Float) (nu / nw);
-      pts[i].v = (Rox_Float) (nv / nw);
-   }
+   error = rox_codedframe_decode(&obj->value, data, rows, cols, dh, code_bits);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for ( Rox_Sint i = 0; i < 16; i++)
-   {
-      error = rox_remap_onepixel_bilinear_uchar(&val, image, &pts[i]);
-      if (error) val = 0;
+function_terminate:
+   return error;
+}
 
-      if (val < 128) values[i] = 0;
-      else values[i] = 1;
-   }
+Rox_ErrorCode rox_codedframe_make64(Rox_CodedFrame obj, Rox_Image image, Rox_MatSL3 H)
+{
+   return rox_codedframe_make(obj, image, H, 64);
+}
+
+Rox_ErrorCode rox_codedframe_make16(Rox_CodedFrame obj, Rox_Image image, Rox_MatSL3 H)
+{
+   return rox_codedframe_make(obj, image, H, 16);
+}
+
+Rox_ErrorCode rox_codedframe_make_batch (
+   Rox_Sint * values,
+   const Rox_Image image,
+   const Rox_MatSL3 * homographies,
+   const Rox_Sint count,
+   const Rox_Sint code_bits
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!values || !image || !homographies)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (count < 0)
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (code_bits != 16 && code_bits != 64)
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Sint rows = 0, cols = 0;
+   error = rox_image_get_size(&rows, &cols, image);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Uchar ** data = NULL;
+   error = rox_image_get_data_pointer_to_pointer(&data, image);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   res = 0;
-   for ( Rox_Sint i = 0; i < 16; i++)
+   for (Rox_Sint k = 0; k < count; k++)
    {
-      if (values[i])
+      Rox_Double ** h = NULL;
+      Rox_Double ch[3][3];
+      Rox_Double * dh[3] = { ch[0], ch[1], ch[2] };
+      Rox_Uint value = 0;
+
+      values[k] = -1;
+
+      error = rox_array2d_double_get_data_pointer_to_pointer(&h, homographies[k]);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      // cH = H * G without the generic product, with the same rounding
+      for (Rox_Sint i = 0; i < 3; i++)
       {
-         Rox_Sint bin = i;
-         res |= (1 << bin);
+         ch[i][0] = h[i][0];
+         ch[i][1] = h[i][1];
+         ch[i][2] = h[i][0] * CODES_ORIGIN + h[i][1] * CODES_ORIGIN + h[i][2];
       }
-   }
 
-   error = rox_bch_c6_e2_decode(&val, res);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   obj->value = val;
+      // An unreadable code is not an error of the batch
+      if (rox_codedframe_decode(&value, data, rows, cols, dh, code_bits) == ROX_ERROR_NONE)
+      {
+         values[k] = (Rox_Sint) value;
+      }
+   }
 
 function_terminate:
    return error;
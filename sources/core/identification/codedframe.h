@@ -68,6 +68,15 @@ ROX_API Rox_ErrorCode rox_codedframe_make64(Rox_CodedFrame codedframe, Rox_Image
 //! \todo To be tested
 ROX_API Rox_ErrorCode rox_codedframe_make16(Rox_CodedFrame codedframe, Rox_Image image, Rox_MatSL3 homography);
 
+//! Extract the codes of several frames in one image
+//! \param [out]  values       The decoded values, -1 for the frames whose code cannot be read or corrected
+//! \param [in]   image        The image to extract the codes from
+//! \param [in]   homographies The homographies localizing the templates, as for rox_codedframe_make64
+//! \param [in]   count        The number of frames
+//! \param [in]   code_bits    The size of the codes, 16 or 64
+//! \return An error code
+ROX_API Rox_ErrorCode rox_codedframe_make_batch(Rox_Sint * values, const Rox_Image image, const Rox_MatSL3 * homographies, const Rox_Sint count, const Rox_Sint code_bits);
+
 //! Get the code from codedframe
 //! \param [out]  value       The image to extract the template from
 //! \param [in]   codedframe 	The created codedframe object
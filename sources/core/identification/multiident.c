@@ -18,6 +18,7 @@
 #include "multiident_struct.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <generated/dynvec_uint_struct.h>
 #include <generated/dynvec_point2d_float_struct.h>
 #include <generated/dynvec_point3d_float_struct.h>
@@ -31,6 +32,18 @@
 #include <inout/system/print.h>
 #include <inout/system/errors_print.h>
 
+//! Number of randomized kd-trees of the index
+#define ROX_MULTI_IDENT_TREES 4
+
+//! Number of nearest indexed features retrieved for a current feature
+#define ROX_MULTI_IDENT_NEIGHBOURS 8
+
+//! Minimal number of leaves checked by a search in the index
+#define ROX_MULTI_IDENT_CHECKS 128
+
+//! Minimal number of matches for a template to be kept (find_next_best rejects templates with at most 4 matches)
+#define ROX_MULTI_IDENT_MIN_VOTES 5
+
 Rox_ErrorCode rox_multi_ident_new(Rox_Multi_Ident *obj)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -47,6 +60,19 @@ Rox_ErrorCode rox_multi_ident_new(Rox_Multi_Ident *obj)
    ret->idents = NULL;
    ret->matcheslist = NULL;
    ret->current_features = NULL;
+   ret->compiled = 0;
+   ret->index_features = NULL;
+   ret->index_group = NULL;
+   ret->index_local = NULL;
+   ret->group_template = NULL;
+   ret->group_count = NULL;
+   ret->template_votes = NULL;
+   ret->pairs = NULL;
+   ret->pairs_sorted = NULL;
+   ret->index = NULL;
+   ret->neighbours = NULL;
+   ret->doubled = NULL;
+   ret->workspace = NULL;
 
    error = rox_objset_template_ident_new(&ret->idents, 10);
 
@@ -58,6 +84,36 @@ Rox_ErrorCode rox_multi_ident_new(Rox_Multi_Ident *obj)
    error = rox_dynvec_sraiddesc_new(&ret->current_features, 100);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_dynvec_sraiddesc_new(&ret->index_features, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->index_group, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->index_local, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->group_template, 100);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->group_count, 100);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->template_votes, 10);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->pairs, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->pairs_sorted, 1000);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_kdtree_sraid_new(&ret->index, ROX_MULTI_IDENT_TREES);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_sraid_matchresultset_new(&ret->neighbours, ROX_MULTI_IDENT_NEIGHBOURS);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    *obj = ret;
 
 function_terminate:
@@ -83,6 +139,18 @@ Rox_ErrorCode rox_multi_ident_del(Rox_Multi_Ident *obj)
    rox_dynvec_sraiddesc_del(&todel->current_features);
    rox_objset_template_ident_del(&todel->idents);
    rox_dynvec_sint_del(&todel->matcheslist);
+   rox_dynvec_sraiddesc_del(&todel->index_features);
+   rox_dynvec_uint_del(&todel->index_group);
+   rox_dynvec_uint_del(&todel->index_local);
+   rox_dynvec_uint_del(&todel->group_template);
+   rox_dynvec_uint_del(&todel->group_count);
+   rox_dynvec_uint_del(&todel->template_votes);
+   rox_dynvec_uint_del(&todel->pairs);
+   rox_dynvec_uint_del(&todel->pairs_sorted);
+   if (todel->index) rox_kdtree_sraid_del(&todel->index);
+   if (todel->neighbours) rox_sraid_matchresultset_del(&todel->neighbours);
+   if (todel->doubled) rox_array2d_float_del(&todel->doubled);
+   if (todel->workspace) rox_sraid_workspace_del(&todel->workspace);
 
    rox_memory_delete(todel);
 
@@ -116,6 +184,8 @@ Rox_ErrorCode rox_multi_ident_add_template(Rox_Multi_Ident obj, Rox_Array2D_Floa
    error = rox_objset_template_ident_append(obj->idents, toadd);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   obj->compiled = 0;
+
 function_terminate:
    if (error) rox_template_ident_del(&toadd);
 
@@ -131,6 +201,8 @@ Rox_ErrorCode rox_multi_ident_reset(Rox_Multi_Ident obj)
 
    rox_objset_template_ident_reset(obj->idents);
 
+   obj->compiled = 0;
+
 function_terminate:
    return error;
 }
@@ -142,20 +214,71 @@ Rox_ErrorCode rox_multi_ident_compile(Rox_Multi_Ident obj)
    
    if (!obj) {error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );}
 
+   obj->compiled = 0;
+
+   rox_dynvec_sraiddesc_reset(obj->index_features);
+   rox_dynvec_uint_reset(obj->index_group);
+   rox_dynvec_uint_reset(obj->index_local);
+   rox_dynvec_uint_reset(obj->group_template);
+
+   // Gather the features of all the affine views of all the templates, each affine view of a template is a group
+   for (Rox_Uint idtemplate = 0; idtemplate < obj->idents->used; idtemplate++)
+   {
+      Rox_Template_Ident tmp = obj->idents->data[idtemplate];
+
+      for (Rox_Uint idset = 0; idset < tmp->reference_features_subsets->used; idset++)
+      {
+         Rox_DynVec_SRAID_Feature ref = tmp->reference_features_subsets->data[idset];
+         if (ref->used == 0) continue;
+
+         Rox_Uint group = obj->group_template->used;
+
+         for (Rox_Uint idpt = 0; idpt < ref->used; idpt++)
+         {
+            error = rox_dynvec_sraiddesc_append(obj->index_features, &ref->data[idpt]);
+            ROX_ERROR_CHECK_TERMINATE ( error );
+
+            error = rox_dynvec_uint_append(obj->index_group, &group);
+            ROX_ERROR_CHECK_TERMINATE ( error );
+
+            error = rox_dynvec_uint_append(obj->index_local, &idpt);
+            ROX_ERROR_CHECK_TERMINATE ( error );
+         }
+
+         error = rox_dynvec_uint_append(obj->group_template, &idtemplate);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+   }
+
+   rox_kdtree_sraid_clean(obj->index);
+
+   if (obj->index_features->used > 0)
+   {
+      error = rox_kdtree_sraid_build(obj->index, obj->index_features);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   obj->compiled = 1;
+
 function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_multi_ident_make(Rox_Multi_Ident obj, Rox_Array2D_Float current_image, Rox_Uint dbl_image)
+static Rox_ErrorCode rox_multi_ident_match(Rox_Multi_Ident obj, Rox_Array2D_Float current_image, Rox_Uint dbl_image, Rox_DynVec_Point3D_Float reference_points_meters_matched, Rox_DynVec_Point3D_Double reference_points_meters_extracted)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_DynVec_SRAID_Feature ref = NULL;
-   Rox_Point2D_Float_Struct toadd;
    Rox_Array2D_Float source = NULL;
+   Rox_Point2D_Float_Struct toadd;
+   Rox_Point3D_Float_Struct point3D;
 
+   // corresponds to ratio = 0.7 in rox_sraid_matchset
+   const Rox_Float thresh = 0.7f * 0.7f;
 
-   if (!obj || !current_image) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );}
+   if (!obj->compiled)
+   {
+      error = rox_multi_ident_compile(obj);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
    Rox_Sint w = 0, h = 0;
 
@@ -164,12 +287,26 @@ Rox_ErrorCode rox_multi_ident_make(Rox_Multi_Ident obj, Rox_Array2D_Float curren
 
    if (dbl_image)
    {
-      error = rox_array2d_float_new(&source, h * 2, w * 2);
+      // The doubled image is only reallocated when the size of the current image changes
+      Rox_Sint dw = 0, dh = 0;
+      if (obj->doubled)
+      {
+         error = rox_array2d_float_get_size(&dh, &dw, obj->doubled);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
 
-      ROX_ERROR_CHECK_TERMINATE ( error );
+      if (dh != h * 2 || dw != w * 2)
+      {
+         if (obj->doubled) rox_array2d_float_del(&obj->doubled);
+
+         error = rox_array2d_float_new(&obj->doubled, h * 2, w * 2);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
 
-      error = remap_bilinear_nomask_float_to_float_doubled(source, current_image);
+      error = remap_bilinear_nomask_float_to_float_doubled(obj->doubled, current_image);
       ROX_ERROR_CHECK_TERMINATE ( error );
+
+      source = obj->doubled;
    }
    else
    {
@@ -179,8 +316,23 @@ Rox_ErrorCode rox_multi_ident_make(Rox_Multi_Ident obj, Rox_Array2D_Float curren
    // reset dynvec
    rox_dynvec_sraiddesc_reset(obj->current_features);
 
+   // The sraid workspace is only recreated when the size of the source image changes
+   Rox_Sint sw = w, sh = h;
+   if (dbl_image) { sw = w * 2; sh = h * 2; }
+
+   if (obj->workspace && (obj->workspace->rows != sh || obj->workspace->cols != sw))
+   {
+      rox_sraid_workspace_del(&obj->workspace);
+   }
+
+   if (!obj->workspace)
+   {
+      error = rox_sraid_workspace_new(&obj->workspace, sh, sw, -1, 1.6f, 3.0f, 0.5f, 3);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
    // sraid detection
-   error = rox_sraidpipeline_process(obj->current_features, source, -1, 1.6f, 3.0f, 0.5f, 3, 0.04f, 10, 0);
+   error = rox_sraid_workspace_process(obj->current_features, obj->workspace, source, 0.04f, 10, 0);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Rescale
@@ -193,7 +345,9 @@ Rox_ErrorCode rox_multi_ident_make(Rox_Multi_Ident obj, Rox_Array2D_Float curren
       }
    }
 
-   // For all reference views
+   // Reset the matches of all the templates
+   if (reference_points_meters_matched) rox_dynvec_point3d_float_reset(reference_points_meters_matched);
+
    for (Rox_Uint idtemplate = 0; idtemplate < obj->idents->used; idtemplate++)
    {
       Rox_Template_Ident tmp = obj->idents->data[idtemplate];
@@ -202,38 +356,139 @@ Rox_ErrorCode rox_multi_ident_make(Rox_Multi_Ident obj, Rox_Array2D_Float curren
       rox_dynvec_point2d_float_reset(tmp->reference_points_matched);
 
       tmp->count_matched = 0;
+   }
 
-      for (Rox_Uint idset = 0; idset < 12 + 1; idset++)
+   if (obj->index_features->used == 0) goto function_terminate;
+
+   const Rox_Uint count_groups = obj->group_template->used;
+
+   rox_dynvec_uint_reset(obj->group_count);
+   error = rox_dynvec_uint_usecells(obj->group_count, count_groups);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   memset(obj->group_count->data, 0, sizeof(Rox_Uint) * count_groups);
+
+   rox_dynvec_uint_reset(obj->template_votes);
+   error = rox_dynvec_uint_usecells(obj->template_votes, obj->idents->used);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+   memset(obj->template_votes->data, 0, sizeof(Rox_Uint) * obj->idents->used);
+
+   rox_dynvec_uint_reset(obj->pairs);
+
+   // One search in the index for each current feature
+   Rox_SRAID_MatchResult_Struct * results = obj->neighbours->results;
+
+   for (Rox_Uint idcur = 0; idcur < obj->current_features->used; idcur++)
+   {
+      error = rox_kdtree_sraid_search_checks(obj->neighbours, obj->index, obj->index_features, &obj->current_features->data[idcur], ROX_MULTI_IDENT_CHECKS);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      const Rox_Uint count = obj->neighbours->count_results;
+      const Rox_Uint full = rox_sraid_matchresultset_isfull(obj->neighbours);
+
+      for (Rox_Uint j = 0; j < count; j++)
       {
-         ref = tmp->reference_features_subsets->data[idset];
-         if (ref->used == 0) continue;
+         Rox_Uint group = obj->index_group->data[results[j].index];
 
-         // Retrieve matches between current and reference points
-         error = rox_sraid_matchset(obj->matcheslist, obj->current_features, ref);
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         // Only the nearest feature of each group is a candidate
+         Rox_Uint nearest = 1;
+         for (Rox_Uint k = 0; k < j && nearest; k++)
+         {
+            if (obj->index_group->data[results[k].index] == group) nearest = 0;
+         }
+         if (!nearest) continue;
 
-         for (Rox_Uint idmatch = 0; idmatch < obj->matcheslist->used; idmatch++)
+         // The second nearest feature of the group, bounded by the farthest neighbour when the group has no other one in the result set
+         Rox_Uint second = full ? results[count - 1].distance : ~0u;
+         for (Rox_Uint k = j + 1; k < count; k++)
          {
-            Rox_Sint idx = obj->matcheslist->data[idmatch];
+            if (obj->index_group->data[results[k].index] == group) { second = results[k].distance; break; }
+         }
 
-            if (idx < 0) continue;
-            if (idx >= (Rox_Sint)ref->used) continue;
+         // Is it far enough from the second putative match of the same template view ?
+         if (((Rox_Float) results[j].distance) >= ((Rox_Float) second) * thresh) continue;
 
-            toadd.u = ref->data[idx].x;
-            toadd.v = ref->data[idx].y;
-            rox_dynvec_point2d_float_append(tmp->reference_points_matched, &toadd);
+         Rox_Uint pair[2] = { results[j].index, idcur };
+         error = rox_dynvec_uint_append(obj->pairs, &pair[0]);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+         error = rox_dynvec_uint_append(obj->pairs, &pair[1]);
+         ROX_ERROR_CHECK_TERMINATE ( error );
 
-            toadd.u = obj->current_features->data[idmatch].x;
-            toadd.v = obj->current_features->data[idmatch].y;
-            rox_dynvec_point2d_float_append(tmp->current_points_matched, &toadd);
+         obj->group_count->data[group]++;
+         obj->template_votes->data[obj->group_template->data[group]]++;
+      }
+   }
 
-            tmp->count_matched++;
-         }
+   // Templates without enough votes are pruned, the other matches are sorted by template, view and current feature
+   Rox_Uint kept = 0;
+   for (Rox_Uint group = 0; group < count_groups; group++)
+   {
+      Rox_Uint count = obj->group_count->data[group];
+
+      if (obj->template_votes->data[obj->group_template->data[group]] < ROX_MULTI_IDENT_MIN_VOTES) count = 0;
+
+      obj->group_count->data[group] = kept;
+      kept += count;
+   }
+
+   rox_dynvec_uint_reset(obj->pairs_sorted);
+   error = rox_dynvec_uint_usecells(obj->pairs_sorted, 2 * kept);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint idpair = 0; idpair < obj->pairs->used; idpair += 2)
+   {
+      Rox_Uint group = obj->index_group->data[obj->pairs->data[idpair]];
+      if (obj->template_votes->data[obj->group_template->data[group]] < ROX_MULTI_IDENT_MIN_VOTES) continue;
+
+      Rox_Uint pos = obj->group_count->data[group]++;
+      obj->pairs_sorted->data[2 * pos] = obj->pairs->data[idpair];
+      obj->pairs_sorted->data[2 * pos + 1] = obj->pairs->data[idpair + 1];
+   }
+
+   for (Rox_Uint idpair = 0; idpair < 2 * kept; idpair += 2)
+   {
+      Rox_Uint idref = obj->pairs_sorted->data[idpair];
+      Rox_Uint idcur = obj->pairs_sorted->data[idpair + 1];
+      Rox_Template_Ident tmp = obj->idents->data[obj->group_template->data[obj->index_group->data[idref]]];
+
+      toadd.u = obj->index_features->data[idref].x;
+      toadd.v = obj->index_features->data[idref].y;
+      rox_dynvec_point2d_float_append(tmp->reference_points_matched, &toadd);
+
+      toadd.u = obj->current_features->data[idcur].x;
+      toadd.v = obj->current_features->data[idcur].y;
+      rox_dynvec_point2d_float_append(tmp->current_points_matched, &toadd);
+
+      if (reference_points_meters_matched)
+      {
+         // add the 3D point to the list
+         Rox_Uint idx = obj->index_local->data[idref];
+
+         point3D.X = (Rox_Float)reference_points_meters_extracted->data[idx].X;
+         point3D.Y = (Rox_Float)reference_points_meters_extracted->data[idx].Y;
+         point3D.Z = (Rox_Float)reference_points_meters_extracted->data[idx].Z;
+
+         rox_dynvec_point3d_float_append(reference_points_meters_matched, &point3D);
       }
+
+      tmp->count_matched++;
    }
 
 function_terminate:
-   if (dbl_image) rox_array2d_float_del(&source);
+   return error;
+}
+
+Rox_ErrorCode rox_multi_ident_make(Rox_Multi_Ident obj, Rox_Array2D_Float current_image, Rox_Uint dbl_image)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+
+   if (!obj || !current_image) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );}
+
+   error = rox_multi_ident_match(obj, current_image, dbl_image, NULL, NULL);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
    return error;
 }
 
@@ -272,108 +527,15 @@ function_terminate:
 Rox_ErrorCode rox_multi_ident_make_features ( Rox_Multi_Ident obj, Rox_Array2D_Float current_image, Rox_Uint dbl_image, Rox_DynVec_Point3D_Float reference_points_meters_matched, Rox_DynVec_Point3D_Double reference_points_meters_extracted)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Sint idx;
-   Rox_Uint idtemplate = 0;
-   Rox_Uint idset = 0;
-   Rox_Uint idmatch = 0;
-   Rox_Uint idpt = 0;
 
-   Rox_Point3D_Float_Struct point3D;
-   Rox_DynVec_SRAID_Feature ref;
-   Rox_Point2D_Float_Struct toadd;
-
-   Rox_Array2D_Float source = NULL;
 
-
-   if (!obj || !current_image) 
+   if (!obj || !current_image || !reference_points_meters_matched || !reference_points_meters_extracted) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   Rox_Sint w = 0, h = 0; 
-   error = rox_array2d_float_get_size(&h, &w, current_image); 
-   ROX_ERROR_CHECK_TERMINATE ( error ); 
-
-   if (dbl_image)
-   {
-      error = rox_array2d_float_new(&source, h * 2, w * 2);
-
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      error = remap_bilinear_nomask_float_to_float_doubled(source, current_image);
-      ROX_ERROR_CHECK_TERMINATE ( error );
-   }
-   else
-   {
-      source = current_image;
-   }
-
-   // reset dynvec
-   rox_dynvec_sraiddesc_reset(obj->current_features);
-
-   // sraid detection
-   error = rox_sraidpipeline_process(obj->current_features, source, -1, 1.6f, 3.0f, 0.5f, 3, 0.04f, 10, 0);
+   error = rox_multi_ident_match(obj, current_image, dbl_image, reference_points_meters_matched, reference_points_meters_extracted);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Rescale
-   if (dbl_image)
-   {
-      for (idpt = 0; idpt < obj->current_features->used; idpt++)
-      {
-         obj->current_features->data[idpt].x /= 2.0;
-         obj->current_features->data[idpt].y /= 2.0;
-      }
-   }
-
-   // Reset the 3D matched points
-   rox_dynvec_point3d_float_reset(reference_points_meters_matched);
-
-   // For all reference views
-   for (idtemplate = 0; idtemplate < obj->idents->used; idtemplate++)
-   {
-      Rox_Template_Ident tmp = obj->idents->data[idtemplate];
-
-      rox_dynvec_point2d_float_reset(tmp->current_points_matched);
-      rox_dynvec_point2d_float_reset(tmp->reference_points_matched);
-
-      tmp->count_matched = 0;
-
-      for (idset = 0; idset < 12 + 1; idset++)
-      {
-         ref = tmp->reference_features_subsets->data[idset];
-         if (ref->used == 0) continue;
-
-         // Retrieve matches between current and reference points
-         error = rox_sraid_matchset(obj->matcheslist, obj->current_features, ref);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         for (idmatch = 0; idmatch < obj->matcheslist->used; idmatch++)
-         {
-            idx = obj->matcheslist->data[idmatch];
-
-            if (idx < 0) continue;
-            if (idx >= (Rox_Sint)ref->used) continue;
-
-            toadd.u = ref->data[idx].x;
-            toadd.v = ref->data[idx].y;
-            rox_dynvec_point2d_float_append(tmp->reference_points_matched, &toadd);
-
-            toadd.u = obj->current_features->data[idmatch].x;
-            toadd.v = obj->current_features->data[idmatch].y;
-            rox_dynvec_point2d_float_append(tmp->current_points_matched, &toadd);
-
-            // add the 3D point to the list
-            point3D.X = (Rox_Float)reference_points_meters_extracted->data[idx].X;
-            point3D.Y = (Rox_Float)reference_points_meters_extracted->data[idx].Y;
-            point3D.Z = (Rox_Float)reference_points_meters_extracted->data[idx].Z;
-
-            rox_dynvec_point3d_float_append(reference_points_meters_matched, &point3D);
-
-            tmp->count_matched++;
-         }
-      }
-   }
-
 function_terminate:
-   if (dbl_image) rox_array2d_float_del(&source);
    return error;
 }
 
@@ -57,12 +57,16 @@ ROX_API Rox_ErrorCode rox_multi_ident_reset(Rox_Multi_Ident multi_ident);
 ROX_API Rox_ErrorCode rox_multi_ident_add_template(Rox_Multi_Ident multi_ident, Rox_Array2D_Float reference, Rox_Array2D_Double calib_template, Rox_Uint use_affine, Rox_Uint use_double_image);
 
 //! Compile templates together, must be called one after the templates have been added.
+//! Builds a single kd-tree index over the features of all the affine views of all the templates.
+//! If it is not called, the index is built by the next call to rox_multi_ident_make.
 //! \param [in] multi_ident is the created identification object to use
 //! \return An error code
 //! \todo to be tested
 ROX_API Rox_ErrorCode rox_multi_ident_compile(Rox_Multi_Ident multi_ident);
 
 //! Try to identify templates in the live image
+//! Each current feature is searched once in the index of all the templates and matched to the views
+//! where it passes the ratio test. Templates with less than 5 matches are discarded.
 //! \param [in] multi_ident is the created identification object to use
 //! \param [in] current the image to search inside
 //! \param [in] dbl_image do we double current image ?
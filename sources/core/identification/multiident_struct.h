@@ -25,6 +25,10 @@
 #include <generated/dynvec_sint_struct.h>
 #include <generated/dynvec_uint.h>
 
+#include <core/features/descriptors/sraid/kdtree_sraid.h>
+#include <core/features/descriptors/sraid/sraid_workspace.h>
+#include <core/features/descriptors/sraid/sraid_matchresultset.h>
+
 //! \addtogroup Identification
 //! @{
 
@@ -39,6 +43,45 @@ struct Rox_Multi_Ident_Struct
 
    //! A buffer for matches ids
    Rox_DynVec_Sint matcheslist;
+
+   //! The templates have been compiled since they were last modified
+   Rox_Uint compiled;
+
+   //! The reference features of all the templates and all the affine views
+   Rox_DynVec_SRAID_Feature index_features;
+
+   //! The group (a template and one of its affine views) of each indexed feature
+   Rox_DynVec_Uint index_group;
+
+   //! The position of each indexed feature in its affine view
+   Rox_DynVec_Uint index_local;
+
+   //! The template of each group
+   Rox_DynVec_Uint group_template;
+
+   //! The number of accepted matches of each group
+   Rox_DynVec_Uint group_count;
+
+   //! The number of accepted matches of each template
+   Rox_DynVec_Uint template_votes;
+
+   //! The accepted matches as pairs (indexed feature, current feature), in the order of the current features
+   Rox_DynVec_Uint pairs;
+
+   //! The accepted matches sorted by group
+   Rox_DynVec_Uint pairs_sorted;
+
+   //! The randomized kd-trees over the indexed features
+   Rox_Kdtree_Sraid index;
+
+   //! The nearest indexed features of a current feature
+   Rox_SRAID_MatchResultSet neighbours;
+
+   //! The doubled current image, kept between calls
+   Rox_Array2D_Float doubled;
+
+   //! The SRAID buffers for the size of the current source image, kept between calls
+   Rox_SRAID_Workspace workspace;
 };
 
 //! @}
@@ -26,6 +26,19 @@
 //! \addtogroup p5p
 //! @{
 
+//! The solutions of one 5 points problem
+struct Rox_Essential_Solutions_Struct
+{
+   //! The number of essential matrices found (0 if the solver failed)
+   Rox_Uint count;
+
+   //! The essential matrices, row major
+   Rox_Double essentials[10][9];
+};
+
+//! Define the structure as a value type
+typedef struct Rox_Essential_Solutions_Struct Rox_Essential_Solutions_Struct;
+
 //! This code is an implementation of Nister Essential matrix estimation
 //! from 5 calibrated points correspondance. See this paper :
 //! An Efficient Solution to the Five-Point Relative Pose Problem
@@ -43,6 +56,20 @@ ROX_API Rox_ErrorCode rox_essential_from_5_points_nister (
    const Rox_Point2D_Double  cur2D
 );
 
+//! Solve a batch of 5 points problems with rox_essential_from_5_points_nister, without any memory allocation.
+//! The solutions are the same as the ones of rox_essential_from_5_points_nister on each sample.
+//! \param  [out]  solutions      The solutions of the samples (count structures)
+//! \param  [in ]  ref2D          The 5 * count 2D reference points (right), 5 consecutive points per sample
+//! \param  [in ]  cur2D          The 5 * count 2D current points (left), 5 consecutive points per sample
+//! \param  [in ]  count          The number of samples
+//! \return An error code, the samples for which the solver fails have no solution
+ROX_API Rox_ErrorCode rox_essential_from_5_points_nister_batch (
+   Rox_Essential_Solutions_Struct * solutions, 
+   const Rox_Point2D_Double  ref2D, 
+   const Rox_Point2D_Double  cur2D, 
+   const Rox_Sint count
+);
+
 //! @} 
 
 #endif
@@ -16,10 +16,6 @@
 
 #include <system/errors/errors.h>
 
-#include <baseproc/array/decomposition/svd.h>
-#include <baseproc/array/decomposition/svdsort.h>
-#include <baseproc/array/decomposition/qr.h>
-#include <baseproc/array/decomposition/gausspivoting.h>
 #include <baseproc/maths/maths_macros.h>
 #include <baseproc/maths/nonlin/polynomials.h>
 #include <baseproc/array/fill/fillval.h>
@@ -490,103 +486,224 @@ Rox_ErrorCode rox_essential_get_basis (
   const Rox_Point2D_Double  cur2D)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Matrix A = NULL, At = NULL;
-   Rox_Double ** dA, **dV;
+   Rox_Double R[9][5], Q[9][9];
+   Rox_Double housevector[9], housebuffer[9], colnorms[5];
+   Rox_Double colnorm, pivot, scale, alpha, swap, maxcolnorm;
+   Rox_Sint k, r, c, maxcol;
    Rox_Uint idpt, idrow, i, j;
-   Rox_Matrix Q = NULL, R = NULL, U = NULL, S = NULL, V = NULL, P = NULL;
 
    if (!ref2D || !cur2D) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   //Create buffers
-   error = rox_matrix_new(&A, 5, 9);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   //Compute A' where A is such that A*vec(E)=0
+   for (idpt = 0; idpt < 5; idpt++)
+   {
+      R[0][idpt] = ref2D[idpt].u * cur2D[idpt].u;
+      R[1][idpt] = ref2D[idpt].v * cur2D[idpt].u;
+      R[2][idpt] = cur2D[idpt].u;
+      R[3][idpt] = ref2D[idpt].u * cur2D[idpt].v;
+      R[4][idpt] = ref2D[idpt].v * cur2D[idpt].v;
+      R[5][idpt] = cur2D[idpt].v;
+      R[6][idpt] = ref2D[idpt].u;
+      R[7][idpt] = ref2D[idpt].v;
+      R[8][idpt] = 1.0;
+   }
 
-   error = rox_matrix_new(&At, 9, 5);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   for (r = 0; r < 9; r++)
+   {
+      for (c = 0; c < 9; c++)
+      {
+         Q[r][c] = (r == c) ? 1.0 : 0.0;
+      }
+   }
 
-   error = rox_matrix_new(&Q, 9, 9);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // Compute the right null space of A.
+   // Because A is fat, we compute the left null space of A' which gives the same values.
+   // This is the householder QR with column pivoting of rox_array2d_double_qrp, done on the stack.
+   // The null space is given by the last 4 columns of Q (the following SVD of R does not change them).
+   for (k = 0; k < 5; k++)
+   {
+      maxcolnorm = -1;
+      maxcol = 0;
 
-   error = rox_matrix_new(&R, 9, 5);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      for (c = k; c < 5; c++)
+      {
+         colnorms[c] = 0;
 
-   error = rox_matrix_new(&P, 5, 5);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+         for (r = k; r < 9; r++)
+         {
+            colnorms[c] += R[r][c] * R[r][c];
+         }
 
-   error = rox_matrix_new(&U, 9, 9);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+         if (maxcolnorm < colnorms[c])
+         {
+            maxcol = c;
+            maxcolnorm = colnorms[c];
+         }
+      }
 
-   error = rox_matrix_new(&S, 5, 1);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      if (maxcol != k)
+      {
+         for (r = 0; r < 9; r++)
+         {
+            swap = R[r][k];
+            R[r][k] = R[r][maxcol];
+            R[r][maxcol] = swap;
+         }
+      }
 
-   error = rox_matrix_new(&V, 5, 5);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      pivot = R[k][k];
 
-   //Compute A such that A*vec(E)=0
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dA, A);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      // Current column norm
+      colnorm = 0;
+      for (r = k + 1; r < 9; r++)
+      {
+         colnorm += R[r][k] * R[r][k];
+      }
 
-   for (idpt = 0; idpt < 5; idpt++)
-   {
-      dA[idpt][0] = ref2D[idpt].u * cur2D[idpt].u;
-      dA[idpt][1] = ref2D[idpt].v * cur2D[idpt].u;
-      dA[idpt][2] = cur2D[idpt].u;
-      dA[idpt][3] = ref2D[idpt].u * cur2D[idpt].v;
-      dA[idpt][4] = ref2D[idpt].v * cur2D[idpt].v;
-      dA[idpt][5] = cur2D[idpt].v;
-      dA[idpt][6] = ref2D[idpt].u;
-      dA[idpt][7] = ref2D[idpt].v;
-      dA[idpt][8] = 1.0;
-   }
+      alpha = sqrt(colnorm + pivot * pivot);
 
-   // Compute the right null space of A.
-   // Because A is fat, we compute the left null space of A' which gives the same values
-   error = rox_array2d_double_transpose(At, A);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      // Update pivot
+      if (pivot >= 0.0) alpha = -alpha;
+      pivot = pivot + alpha;
 
-   error = rox_array2d_double_qrp(Q, R, P, At);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      colnorm = sqrt(colnorm + pivot * pivot);
+      if (colnorm < DBL_EPSILON) scale = 0.0;
+      else scale = 1.0 / colnorm;
 
-   error = rox_array2d_double_svd_jacobi(U, S, V, Q, R, P);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      // Store householder vector
+      housevector[0] = pivot * scale;
+      for (r = 1; r < 9 - k; r++)
+      {
+         housevector[r] = R[k + r][k] * scale;
+      }
+
+      // R = R - 2*housevec*(housevec'*R)
+      for (c = 0; c < 5 - k; c++)
+      {
+         housebuffer[c] = 0;
+
+         for (r = 0; r < 9 - k; r++)
+         {
+            housebuffer[c] += housevector[r] * R[k + r][k + c];
+         }
+      }
+
+      for (r = 0; r < 9 - k; r++)
+      {
+         for (c = 0; c < 5 - k; c++)
+         {
+            R[k + r][k + c] -= 2.0 * housevector[r] * housebuffer[c];
+         }
+      }
+
+      // Q = Q - 2*housevec*(housevec'*Q), Q is transposed
+      for (c = 0; c < 9; c++)
+      {
+         housebuffer[c] = 0;
+
+         for (r = 0; r < 9 - k; r++)
+         {
+            housebuffer[c] += housevector[r] * Q[k + r][c];
+         }
+      }
+
+      for (r = 0; r < 9 - k; r++)
+      {
+         for (c = 0; c < 9; c++)
+         {
+            Q[k + r][c] -= 2.0 * housevector[r] * housebuffer[c];
+         }
+      }
+   }
 
    // Null space is transformed in 4 basis of the essential matrix E1,E2,E3,E4 such that
    // E=E1*x+E2*y+E3*z+E4*w (w is set to 1, x,y,z are unknowns to compute)
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dV, U);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    idrow = 0;
    for (i = 0; i < 3; i++)
    {
       for (j = 0; j < 3; j++)
       {
-         res[i][j].x = dV[idrow][5];
-         res[i][j].y = dV[idrow][6];
-         res[i][j].z = dV[idrow][7];
-         res[i][j].w = dV[idrow][8];
+         res[i][j].x = Q[5][idrow];
+         res[i][j].y = Q[6][idrow];
+         res[i][j].z = Q[7][idrow];
+         res[i][j].w = Q[8][idrow];
          idrow++;
       }
    }
 
-   error = ROX_ERROR_NONE;
-
 function_terminate:
+   return error;
+}
 
-   rox_matrix_del(&A);
-   rox_matrix_del(&At);
-   rox_matrix_del(&Q);
-   rox_matrix_del(&R);
-   rox_matrix_del(&U);
-   rox_matrix_del(&S);
-   rox_matrix_del(&V);
-   rox_matrix_del(&P);
+//! Transform a matrix in reduced row echelon form, in place (same steps as rox_array2d_double_gauss_pivoting)
+static void rox_essential_gauss_pivoting ( Rox_Double A[10][20] )
+{
+   Rox_Uint r, c, row, col, pivot;
+   Rox_Double maxabs, swap, scale, sub;
 
-   return error;
+   r = 0;
+   for (c = 0; c < 20; c++)
+   {
+      // Find the biggest absolute value in this column under the current row
+      maxabs = 0;
+      pivot = 0;
+      for (row = r; row < 10; row++)
+      {
+         if (fabs(A[row][c]) > maxabs)
+         {
+            maxabs = fabs(A[row][c]);
+            pivot = row;
+         }
+      }
+
+      if (maxabs == 0.0)
+      {
+         // If pivot is null, nullify column
+         for (row = r; row < 10; row++)
+         {
+            A[row][c] = 0;
+         }
+      }
+      else
+      {
+         // Swap pivot row and current row
+         for (col = 0; col < 20; col++)
+         {
+            swap = A[pivot][col];
+            A[pivot][col] = A[r][col];
+            A[r][col] = swap;
+         }
+
+         // Scale row such that the diagonal is 1
+         scale = 1.0 / A[r][c];
+         for (col = 0; col < 20; col++)
+         {
+            A[r][col] = A[r][col] * scale;
+         }
+
+         // Update each rows such that the current column equals 0 (except on the current row)
+         for (row = 0; row < 10; row++)
+         {
+            if (row == r) continue;
+
+            sub = A[row][c];
+            for (col = 0; col < 20; col++)
+            {
+               A[row][col] = A[row][col] - sub * A[r][col];
+            }
+         }
+
+         // Stop if we met the bottom border
+         r++;
+         if (r == 10) break;
+      }
+   }
 }
 
-Rox_ErrorCode rox_essential_from_5_points_nister (
-  Rox_Matrix Ematrices[10],
+//! Solve one minimal problem without any allocation
+static Rox_ErrorCode rox_essential_from_5_points_nister_solve (
+  Rox_Double essentials[10][9],
   Rox_Uint * nbsolutions,
   const Rox_Point2D_Double  ref2D,
   const Rox_Point2D_Double  cur2D
@@ -599,8 +716,7 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
    Rox_Polynom_P4D2_Mat33 EEt, lambda;
    Rox_Polynom_P4D3_Mat33 eigen;
    Rox_Uint i,j,k,l;
-   Rox_Matrix A, GA;
-   Rox_Double ** dA, **dGA, **dE;
+   Rox_Double A[10][20];
    Rox_Double *rowe, *rowf, *rowg, *rowh, *rowi, *rowj;
    Rox_Polynom_P1D3_Struct B11,B12,B21,B22,B31,B32;
    Rox_Polynom_P1D4_Struct B13,B23,B33;
@@ -610,20 +726,8 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
    Rox_Double roots[10];
    Rox_Uint nbroots;
 
-   if (!Ematrices || !nbsolutions || !ref2D || !cur2D) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   //Buffers
-   A = 0;
-   GA = 0;
    *nbsolutions = 0;
 
-   error = rox_array2d_double_new(&A, 10, 20); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_new(&GA, 10, 20); 
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    //Retrieve the Basis as a 3*3 matrix of 4th degrees polynoms
    error = rox_essential_get_basis(basis, ref2D, cur2D); ROX_ERROR_CHECK_TERMINATE(error)
 
@@ -683,30 +787,28 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
    }
 
    //Fillin matrix
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dA, A);
-
    //Add determinant constraint
    i = 0;
-   dA[i][0] = det.xxx;
-   dA[i][1] = det.yyy;
-   dA[i][2] = det.xxy;
-   dA[i][3] = det.xyy;
-   dA[i][4] = det.xxz;
-   dA[i][5] = det.xxw;
-   dA[i][6] = det.yyz;
-   dA[i][7] = det.yyw;
-   dA[i][8] = det.xyz;
-   dA[i][9] = det.xyw;
-   dA[i][10] = det.xzz;
-   dA[i][11] = det.xzw;
-   dA[i][12] = det.xww;
-   dA[i][13] = det.yzz;
-   dA[i][14] = det.yzw;
-   dA[i][15] = det.yww;
-   dA[i][16] = det.zzz;
-   dA[i][17] = det.zzw;
-   dA[i][18] = det.zww;
-   dA[i][19] = det.www;
+   A[i][0] = det.xxx;
+   A[i][1] = det.yyy;
+   A[i][2] = det.xxy;
+   A[i][3] = det.xyy;
+   A[i][4] = det.xxz;
+   A[i][5] = det.xxw;
+   A[i][6] = det.yyz;
+   A[i][7] = det.yyw;
+   A[i][8] = det.xyz;
+   A[i][9] = det.xyw;
+   A[i][10] = det.xzz;
+   A[i][11] = det.xzw;
+   A[i][12] = det.xww;
+   A[i][13] = det.yzz;
+   A[i][14] = det.yzw;
+   A[i][15] = det.yww;
+   A[i][16] = det.zzz;
+   A[i][17] = det.zzw;
+   A[i][18] = det.zww;
+   A[i][19] = det.www;
 
    //Add the 9 eingen values constraints
    i = 1;
@@ -714,42 +816,41 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
    {
       for (l = 0; l < 3; l++)
       {
-         dA[i][0] = eigen[k][l].xxx;
-         dA[i][1] = eigen[k][l].yyy;
-         dA[i][2] = eigen[k][l].xxy;
-         dA[i][3] = eigen[k][l].xyy;
-         dA[i][4] = eigen[k][l].xxz;
-         dA[i][5] = eigen[k][l].xxw;
-         dA[i][6] = eigen[k][l].yyz;
-         dA[i][7] = eigen[k][l].yyw;
-         dA[i][8] = eigen[k][l].xyz;
-         dA[i][9] = eigen[k][l].xyw;
-         dA[i][10] = eigen[k][l].xzz;
-         dA[i][11] = eigen[k][l].xzw;
-         dA[i][12] = eigen[k][l].xww;
-         dA[i][13] = eigen[k][l].yzz;
-         dA[i][14] = eigen[k][l].yzw;
-         dA[i][15] = eigen[k][l].yww;
-         dA[i][16] = eigen[k][l].zzz;
-         dA[i][17] = eigen[k][l].zzw;
-         dA[i][18] = eigen[k][l].zww;
-         dA[i][19] = eigen[k][l].www;
+         A[i][0] = eigen[k][l].xxx;
+         A[i][1] = eigen[k][l].yyy;
+         A[i][2] = eigen[k][l].xxy;
+         A[i][3] = eigen[k][l].xyy;
+         A[i][4] = eigen[k][l].xxz;
+         A[i][5] = eigen[k][l].xxw;
+         A[i][6] = eigen[k][l].yyz;
+         A[i][7] = eigen[k][l].yyw;
+         A[i][8] = eigen[k][l].xyz;
+         A[i][9] = eigen[k][l].xyw;
+         A[i][10] = eigen[k][l].xzz;
+         A[i][11] = eigen[k][l].xzw;
+         A[i][12] = eigen[k][l].xww;
+         A[i][13] = eigen[k][l].yzz;
+         A[i][14] = eigen[k][l].yzw;
+         A[i][15] = eigen[k][l].yww;
+         A[i][16] = eigen[k][l].zzz;
+         A[i][17] = eigen[k][l].zzw;
+         A[i][18] = eigen[k][l].zww;
+         A[i][19] = eigen[k][l].www;
 
          i++;
       }
    }
 
    //Transform the A matrix in reduced row echelon form
-   error = rox_array2d_double_gauss_pivoting(GA, A); ROX_ERROR_CHECK_TERMINATE ( error );
+   rox_essential_gauss_pivoting(A);
 
    //Compute the B matrix using rref(A)
-   error = rox_array2d_double_get_data_pointer_to_pointer(&dGA, GA); ROX_ERROR_CHECK_TERMINATE ( error );
-   rowe = dGA[4];
-   rowf = dGA[5];
-   rowg = dGA[6];
-   rowh = dGA[7];
-   rowi = dGA[8];
-   rowj = dGA[9];
+   rowe = A[4];
+   rowf = A[5];
+   rowg = A[6];
+   rowh = A[7];
+   rowi = A[8];
+   rowj = A[9];
 
    B11.z[3] = -rowf[10];
    B11.z[2] = (rowe[10] - rowf[11]);
@@ -811,7 +912,6 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
    for (i = 0; i < nbroots; i++)
    {
       Rox_Double x,y,z,ep1,ep2,ep3;
-      error = rox_array2d_double_get_data_pointer_to_pointer( &dE, Ematrices[i]); ROX_ERROR_CHECK_TERMINATE ( error );
       z = roots[i];
 
       //Given z, estimate x and y
@@ -826,7 +926,7 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
       {
          for (l = 0; l < 3; l++)
          {
-            dE[k][l] = x * basis[k][l].x + y * basis[k][l].y + z * basis[k][l].z + basis[k][l].w;
+            essentials[i][k * 3 + l] = x * basis[k][l].x + y * basis[k][l].y + z * basis[k][l].z + basis[k][l].w;
          }
       }
    }
@@ -834,9 +934,78 @@ Rox_ErrorCode rox_essential_from_5_points_nister (
    *nbsolutions = nbroots;
 
 function_terminate:
+   return error;
+}
 
-   rox_matrix_del(&A);
-   rox_matrix_del(&GA);
+Rox_ErrorCode rox_essential_from_5_points_nister (
+  Rox_Matrix Ematrices[10],
+  Rox_Uint * nbsolutions,
+  const Rox_Point2D_Double  ref2D,
+  const Rox_Point2D_Double  cur2D
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double essentials[10][9];
+   Rox_Uint nbroots = 0;
+   Rox_Double ** dE = NULL;
 
+   if (!Ematrices || !nbsolutions || !ref2D || !cur2D) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *nbsolutions = 0;
+
+   error = rox_essential_from_5_points_nister_solve(essentials, &nbroots, ref2D, cur2D);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint i = 0; i < nbroots; i++)
+   {
+      error = rox_array2d_double_get_data_pointer_to_pointer( &dE, Ematrices[i]); ROX_ERROR_CHECK_TERMINATE ( error );
+
+      for (Rox_Uint k = 0; k < 3; k++)
+      {
+         for (Rox_Uint l = 0; l < 3; l++)
+         {
+            dE[k][l] = essentials[i][k * 3 + l];
+         }
+      }
+   }
+
+   *nbsolutions = nbroots;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_essential_from_5_points_nister_batch (
+  Rox_Essential_Solutions_Struct * solutions,
+  const Rox_Point2D_Double  ref2D,
+  const Rox_Point2D_Double  cur2D,
+  const Rox_Sint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint idsample = 0;
+
+   if (!solutions || !ref2D || !cur2D) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (count < 0) 
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // The samples are independent and solved on the stack
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (idsample = 0; idsample < count; idsample++)
+   {
+      Rox_Essential_Solutions_Struct * current = &solutions[idsample];
+
+      if (rox_essential_from_5_points_nister_solve(current->essentials, &current->count, &ref2D[5 * idsample], &cur2D[5 * idsample]))
+      {
+         current->count = 0;
+      }
+   }
+
+function_terminate:
    return error;
 }
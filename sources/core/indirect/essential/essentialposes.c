@@ -18,8 +18,7 @@
 #include <baseproc/array/fill/fillval.h>
 #include <baseproc/array/fill/fillunit.h>
 #include <baseproc/array/scale/scale.h>
-#include <baseproc/array/decomposition/svd.h>
-#include <baseproc/array/decomposition/svdsort.h>
+#include <baseproc/array/decomposition/svd3x3.h>
 #include <baseproc/array/multiply/mulmatmat.h>
 #include <baseproc/array/multiply/mulmattransmat.h>
 #include <baseproc/array/multiply/mulmatmattrans.h>
@@ -91,10 +90,8 @@ Rox_ErrorCode rox_essential_possible_poses(Rox_Array2D_Double * poses, Rox_Array
    error = rox_array2d_double_set_value(D, 1, 0, -1);
    error = rox_array2d_double_set_value(D, 2, 2, 1);
 
-   // Compute raw svd
-   error = rox_array2d_double_svd(U, S, V, essential);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_svd_sort(U, S, V); 
+   // Compute the svd, with sorted singular values
+   error = rox_array2d_double_svd3x3(U, S, V, essential);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Make determinant positive
@@ -27,8 +27,7 @@
 #include <baseproc/array/multiply/mulmattransmat.h>
 #include <baseproc/array/multiply/mulmatmat.h>
 #include <baseproc/array/solve/symm3x3solve.h>
-#include <baseproc/array/decomposition/svd.h>
-#include <baseproc/array/decomposition/svdsort.h>
+#include <baseproc/array/decomposition/eigen_symm.h>
 #include <baseproc/array/robust/tukey.h>
 #include <generated/dynvec_point3d_double_struct.h>
 #include <inout/system/errors_print.h>
@@ -181,8 +180,9 @@ function_terminate:
 Rox_ErrorCode rox_matso3_from_vectors_quaternion ( Rox_MatSO3 R, Rox_DynVec_Point3D_Double ref, Rox_DynVec_Point3D_Double cur)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Array2D_Double Q = NULL, U = NULL, S = NULL, V = NULL;
+   Rox_Array2D_Double Q = NULL;
    Rox_Array2D_Double A = NULL, Ak = NULL, As = NULL, b = NULL, bk = NULL;
+   Rox_Double N[16], D[4], E[16];
    // Rox_Array2D_Double d = NULL, w = NULL, wb1 = NULL, wb2 = NULL;
    // Rox_Double * dw = NULL;
    Rox_Double traceA;
@@ -198,15 +198,6 @@ Rox_ErrorCode rox_matso3_from_vectors_quaternion ( Rox_MatSO3 R, Rox_DynVec_Poin
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // New matrices for solving the linear system
-   error = rox_array2d_double_new(&U, 4, 4);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_array2d_double_new(&S, 4, 1);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_array2d_double_new(&V, 4, 4);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-   
    error = rox_array2d_double_new(&Q, 4, 4);
    ROX_ERROR_CHECK_TERMINATE ( error );
    
@@ -297,28 +288,21 @@ Rox_ErrorCode rox_matso3_from_vectors_quaternion ( Rox_MatSO3 R, Rox_DynVec_Poin
    Q_data[2][0] = b_data[0][1];  Q_data[2][1] = As_data[1][0];          Q_data[2][2] = As_data[1][1]-traceA;   Q_data[2][3] = As_data[1][2];
    Q_data[3][0] = b_data[0][2];  Q_data[3][1] = As_data[2][0];          Q_data[3][2] = As_data[2][1];          Q_data[3][3] = As_data[2][2]-traceA;
 
-   // Decompose the Q matrix with SVD
-   error = rox_array2d_double_svd(U, S, V, Q);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   // be sure that V is sorted
-   error = rox_array2d_double_svd_sort_SV(S, V);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // Decompose the symmetric Q matrix
+   for (Rox_Sint i = 0; i < 4; i++)
+   {
+      for (Rox_Sint j = 0; j < 4; j++) N[i * 4 + j] = Q_data[i][j];
+   }
 
-   // Get the best quaternion that is the first column of V (corresponding to the higher singular value)
-   Rox_Double ** V_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &V_data, V );
+   error = rox_array_double_eigen_symm4x4(D, E, N);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Get the rotation matrix from quaternion q = [V_data[0][0], V_data[1][0], V_data[2][0], V_data[3][0]];
-   error = rox_transformtools_rotationmatrix_from_quaternion(R, V_data[0][0], V_data[1][0], V_data[2][0], V_data[3][0]);
+   // Get the best quaternion that is the first column of E (corresponding to the largest eigenvalue)
+   error = rox_transformtools_rotationmatrix_from_quaternion(R, E[0], E[4], E[8], E[12]);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
 
-   ROX_ERROR_CHECK(rox_array2d_double_del(&U));
-   ROX_ERROR_CHECK(rox_array2d_double_del(&S));
-   ROX_ERROR_CHECK(rox_array2d_double_del(&V));
    ROX_ERROR_CHECK(rox_array2d_double_del(&Q));
    ROX_ERROR_CHECK(rox_array2d_double_del(&A));
    ROX_ERROR_CHECK(rox_array2d_double_del(&Ak));
@@ -17,51 +17,25 @@
 #include <system/errors/errors.h>
 #include <baseproc/maths/maths_macros.h>
 #include <baseproc/maths/nonlin/polynomials.h>
-#include <baseproc/array/decomposition/svd.h>
-#include <baseproc/array/multiply/mulmatmat.h>
-#include <baseproc/array/transpose/transpose.h>
-#include <baseproc/array/multiply/mulmatmattrans.h>
-#include <baseproc/array/determinant/detgl3.h>
-#include <baseproc/array/fill/fillunit.h>
 #include <baseproc/geometry/point/point2d_matsl3_transform.h>
-#include <baseproc/geometry/transforms/transform_tools.h>
 #include <baseproc/array/inverse/svdinverse.h>
+#include <baseproc/array/decomposition/eigen_symm.h>
 #include <inout/system/errors_print.h>
 
-Rox_ErrorCode rox_pose_from_two_3D_triangles (
-   Rox_MatSE3 cMo,
-   Rox_Point3D_Double pctriangle,
-   Rox_Point3D_Double potriangle
+//! Get the pose which transforms a 3D triangle in the reference frame to a 3D triangle in the current frame (row major 4x4).
+//! The rotation is the solution of the orthogonal Procrustes problem, computed with the unit quaternion method of Horn
+//! which needs no SVD and no memory allocation.
+static void rox_p3p_pose_from_triangles (
+   Rox_Double pose[16],
+   const Rox_Point3D_Double_Struct pctriangle[3],
+   const Rox_Point3D_Double_Struct potriangle[3]
 )
 {
-   Rox_ErrorCode error = ROX_ERROR_NONE;
-
    Rox_Point3D_Double_Struct baryref, barycur;
-   Rox_Array2D_Double C= NULL, U= NULL, S= NULL, V= NULL, W= NULL, T= NULL;
-   Rox_Array2D_Double R= NULL;
-   Rox_Double **dC, **dS, **dT, **dR;
-   Rox_Double det;
-   Rox_Double s1, s2, s3, mins;
-   Rox_Uint posmin;
-
    Rox_Point3D_Double_Struct ctriangle[3];
    Rox_Point3D_Double_Struct otriangle[3];
-
-
-   if (!cMo) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   error = rox_matse3_check_size ( cMo );
-   ROX_ERROR_CHECK_TERMINATE(error)
-
-   error = rox_array2d_double_fillunit(cMo);
-   ROX_ERROR_CHECK_TERMINATE(error)
-
-   error = rox_array2d_double_new_subarray2d(&R, cMo, 0, 0, 3, 3);
-   ROX_ERROR_CHECK_TERMINATE(error)
-
-   error = rox_array2d_double_new_subarray2d(&T, cMo, 0, 3, 3, 1);
-   ROX_ERROR_CHECK_TERMINATE(error)
+   Rox_Double Sxx, Sxy, Sxz, Syx, Syy, Syz, Szx, Szy, Szz;
+   Rox_Double N[16], D[4], Q[16], w, x, y, z, norm;
 
    // Compute barycenters for both sets
    barycur.X = (pctriangle[0].X + pctriangle[1].X + pctriangle[2].X) / 3.0;
@@ -82,92 +56,66 @@ Rox_ErrorCode rox_pose_from_two_3D_triangles (
       otriangle[id].Z = potriangle[id].Z - baryref.Z;
    }
 
-   // Compute Orthogonal Procrustes problem solution
-   error = rox_array2d_double_new(&C, 3, 3); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_new(&U, 3, 3); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_new(&S, 3, 1); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_new(&V, 3, 3); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_new(&W, 3, 3); ROX_ERROR_CHECK_TERMINATE ( error );
-
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dC, C); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dS, S); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dR, R); ROX_ERROR_CHECK_TERMINATE ( error );
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dT, T); ROX_ERROR_CHECK_TERMINATE ( error );
-
-   dC[0][0] = ctriangle[0].X * otriangle[0].X + ctriangle[1].X * otriangle[1].X + ctriangle[2].X * otriangle[2].X;
-   dC[0][1] = ctriangle[0].X * otriangle[0].Y + ctriangle[1].X * otriangle[1].Y + ctriangle[2].X * otriangle[2].Y;
-   dC[0][2] = ctriangle[0].X * otriangle[0].Z + ctriangle[1].X * otriangle[1].Z + ctriangle[2].X * otriangle[2].Z;
-   dC[1][0] = ctriangle[0].Y * otriangle[0].X + ctriangle[1].Y * otriangle[1].X + ctriangle[2].Y * otriangle[2].X;
-   dC[1][1] = ctriangle[0].Y * otriangle[0].Y + ctriangle[1].Y * otriangle[1].Y + ctriangle[2].Y * otriangle[2].Y;
-   dC[1][2] = ctriangle[0].Y * otriangle[0].Z + ctriangle[1].Y * otriangle[1].Z + ctriangle[2].Y * otriangle[2].Z;
-   dC[2][0] = ctriangle[0].Z * otriangle[0].X + ctriangle[1].Z * otriangle[1].X + ctriangle[2].Z * otriangle[2].X;
-   dC[2][1] = ctriangle[0].Z * otriangle[0].Y + ctriangle[1].Z * otriangle[1].Y + ctriangle[2].Z * otriangle[2].Y;
-   dC[2][2] = ctriangle[0].Z * otriangle[0].Z + ctriangle[1].Z * otriangle[1].Z + ctriangle[2].Z * otriangle[2].Z;
-
-   error = rox_array2d_double_svd(U, S, V, C);
-   ROX_ERROR_CHECK_TERMINATE(error)
-
-   // Get determinant
-   error = rox_array2d_double_mulmatmat(R, U, V);
-   ROX_ERROR_CHECK_TERMINATE(error)
-
-   error = rox_array2d_double_detgl3(&det, R);
-   ROX_ERROR_CHECK_TERMINATE(error)
-
-   // get minimal value
-   s1 = dS[0][0];
-   s2 = dS[1][0];
-   s3 = dS[2][0];
-   mins = s1;
-   posmin = 0;
-   if (s2 < mins)
-   {
-      mins = s2;
-      posmin = 1;
-   }
-   if (s3 < mins)
-   {
-      posmin = 2;
-   }
+   // Correlations between the reference (first index) and current (second index) coordinates
+   Sxx = otriangle[0].X * ctriangle[0].X + otriangle[1].X * ctriangle[1].X + otriangle[2].X * ctriangle[2].X;
+   Sxy = otriangle[0].X * ctriangle[0].Y + otriangle[1].X * ctriangle[1].Y + otriangle[2].X * ctriangle[2].Y;
+   Sxz = otriangle[0].X * ctriangle[0].Z + otriangle[1].X * ctriangle[1].Z + otriangle[2].X * ctriangle[2].Z;
+   Syx = otriangle[0].Y * ctriangle[0].X + otriangle[1].Y * ctriangle[1].X + otriangle[2].Y * ctriangle[2].X;
+   Syy = otriangle[0].Y * ctriangle[0].Y + otriangle[1].Y * ctriangle[1].Y + otriangle[2].Y * ctriangle[2].Y;
+   Syz = otriangle[0].Y * ctriangle[0].Z + otriangle[1].Y * ctriangle[1].Z + otriangle[2].Y * ctriangle[2].Z;
+   Szx = otriangle[0].Z * ctriangle[0].X + otriangle[1].Z * ctriangle[1].X + otriangle[2].Z * ctriangle[2].X;
+   Szy = otriangle[0].Z * ctriangle[0].Y + otriangle[1].Z * ctriangle[1].Y + otriangle[2].Z * ctriangle[2].Y;
+   Szz = otriangle[0].Z * ctriangle[0].Z + otriangle[1].Z * ctriangle[1].Z + otriangle[2].Z * ctriangle[2].Z;
+
+   // The optimal rotation is the unit quaternion maximizing q'*N*q
+   N[0]  = Sxx + Syy + Szz;
+   N[1]  = Syz - Szy;
+   N[2]  = Szx - Sxz;
+   N[3]  = Sxy - Syx;
+   N[5]  = Sxx - Syy - Szz;
+   N[6]  = Sxy + Syx;
+   N[7]  = Szx + Sxz;
+   N[10] = - Sxx + Syy - Szz;
+   N[11] = Syz + Szy;
+   N[15] = - Sxx - Syy + Szz;
+   N[4]  = N[1]; N[8]  = N[2]; N[12] = N[3];
+   N[9]  = N[6]; N[13] = N[7]; N[14] = N[11];
+
+   // The quaternion is the eigenvector of the largest eigenvalue, the first column of Q
+   rox_array_double_eigen_symm4x4 ( D, Q, N );
+
+   norm = sqrt(Q[0] * Q[0] + Q[4] * Q[4] + Q[8] * Q[8] + Q[12] * Q[12]);
+   w = Q[0] / norm; x = Q[4] / norm; y = Q[8] / norm; z = Q[12] / norm;
 
    // Compute Rotation
-   rox_array2d_double_fillunit(W);
-   rox_array2d_double_set_value(W, posmin, posmin, det);  // Make sure det(R) == 1
-   rox_array2d_double_mulmatmattrans(C, W, V);
-   rox_array2d_double_mulmatmat(R, U, C);
+   pose[0] = w * w + x * x - y * y - z * z;
+   pose[1] = 2.0 * (x * y - w * z);
+   pose[2] = 2.0 * (x * z + w * y);
+   pose[4] = 2.0 * (x * y + w * z);
+   pose[5] = w * w - x * x + y * y - z * z;
+   pose[6] = 2.0 * (y * z - w * x);
+   pose[8] = 2.0 * (x * z - w * y);
+   pose[9] = 2.0 * (y * z + w * x);
+   pose[10] = w * w - x * x - y * y + z * z;
 
    // Compute translation
-   dT[0][0] = barycur.X - (dR[0][0] * baryref.X + dR[0][1] * baryref.Y + dR[0][2] * baryref.Z);
-   dT[1][0] = barycur.Y - (dR[1][0] * baryref.X + dR[1][1] * baryref.Y + dR[1][2] * baryref.Z);
-   dT[2][0] = barycur.Z - (dR[2][0] * baryref.X + dR[2][1] * baryref.Y + dR[2][2] * baryref.Z);
-
-function_terminate:
-   rox_array2d_double_del(&R);
-   rox_array2d_double_del(&T);
-   rox_array2d_double_del(&C);
-   rox_array2d_double_del(&U);
-   rox_array2d_double_del(&S);
-   rox_array2d_double_del(&V);
-   rox_array2d_double_del(&W);
+   pose[3] = barycur.X - (pose[0] * baryref.X + pose[1] * baryref.Y + pose[2] * baryref.Z);
+   pose[7] = barycur.Y - (pose[4] * baryref.X + pose[5] * baryref.Y + pose[6] * baryref.Z);
+   pose[11] = barycur.Z - (pose[8] * baryref.X + pose[9] * baryref.Y + pose[10] * baryref.Z);
 
-   return error;
+   pose[12] = 0.0; pose[13] = 0.0; pose[14] = 0.0; pose[15] = 1.0;
 }
 
-Rox_ErrorCode rox_pose_from_3_points (
-   Rox_Array2D_Double_Collection poses,
+//! Solve the P3P problem for points given in normalized coordinates, without any memory allocation
+static Rox_ErrorCode rox_p3p_solve (
+   Rox_Double poses[4][16],
    Rox_Uint * validposes,
-   Rox_Point3D_Double points3D,
-   Rox_Point2D_Double points2D,
-   double fx,
-   double fy,
-   double u0,
-   double v0
-) //, Rox_Array2D_Double calib);
+   const Rox_Point3D_Double_Struct points3D[3],
+   const Rox_Point2D_Double_Struct points2D[3]
+)
 {
-   Rox_Uint id, countsol, idroot;
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Array2D_Double curpose;
-   Rox_Double ifx, ify, iu0, iv0;
+   Rox_Uint countsol;
    Rox_Point3D_Double_Struct mproj[3];
    Rox_Point3D_Double_Struct dir3D12, dir3D13, dir3D23;
    Rox_Double norme, inorme, x, y;
@@ -178,40 +126,17 @@ Rox_ErrorCode rox_pose_from_3_points (
    Rox_Complex_Struct quintic_roots[4];
    Rox_Point3D_Double_Struct possible_triangle[4][3];
 
-
-   //  Check input 
-   if (!poses)    
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-   if (!points2D) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-   if (!points3D) 
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   //  Check poses 
-   if (rox_array2d_double_collection_get_count(poses) != 4) 
-   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   curpose = rox_array2d_double_collection_get(poses, 0);
-
-   error = rox_array2d_double_check_size(curpose, 4, 4);
-   ROX_ERROR_CHECK_TERMINATE(error)
+   *validposes = 0;
 
    //  First, we need to compute all cZ to get a 3D point cloud
-   ifx = 1.0 / fx;
-   ify = 1.0 / fy;
-   iu0 = -u0 * ifx;
-   iv0 = -v0 * ify;
-
-   //  Get image points in meter space
-   for (id = 0; id < 3; id++)
+   for ( Rox_Sint id = 0; id < 3; id++)
    {
-      x = ifx * points2D[id].u + iu0;
-      y = ify * points2D[id].v + iv0;
+      //  Get image points in meter space
+      x = points2D[id].u;
+      y = points2D[id].v;
 
       norme = sqrt(x * x + y * y + 1.0);
-
-      if (ROX_IS_ZERO_DOUBLE(norme)) 
-      { error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+      if (ROX_IS_ZERO_DOUBLE(norme)) {error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE(error)}
 
       inorme = 1.0 / norme;
 
@@ -255,13 +180,11 @@ Rox_ErrorCode rox_pose_from_3_points (
    quintic_coefficients[4] = (ratio2313 * ratio2312 + ratio2313 - ratio2312) * (ratio2313 * ratio2312 + ratio2313 - ratio2312) - 4.0 * ratio2313 * ratio2313 * ratio2312 * cos13 * cos13;
 
    error = rox_quartic_roots(quintic_roots, quintic_coefficients);
-
-   if (error != ROX_ERROR_NONE) 
-   { error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Given each root, try to get a corresponding ray length for each vertex of the 2D triangle
    countsol = 0;
-   for (idroot = 0; idroot < 4; idroot++)
+   for ( Rox_Sint idroot = 0; idroot < 4; idroot++)
    {
       Rox_Double r, i;
       Rox_Double a, b, c, pc1, pc2;
@@ -323,13 +246,114 @@ Rox_ErrorCode rox_pose_from_3_points (
    }
 
    // Get the 3D transformation which transforms 3D given triangle to estimated triangle
-   for (idroot = 0; idroot < countsol; idroot++)
+   for (Rox_Uint idroot = 0; idroot < countsol; idroot++)
    {
-      curpose = rox_array2d_double_collection_get(poses, idroot);
-      error = rox_pose_from_two_3D_triangles(curpose, possible_triangle[idroot], points3D);
+      rox_p3p_pose_from_triangles(poses[idroot], possible_triangle[idroot], points3D);
+   }
+
+   *validposes = countsol;
+
+function_terminate:
+   return error;
+}
+
+//! Copy the solutions in a collection of 4 poses
+static Rox_ErrorCode rox_p3p_copy_poses (
+   Rox_Array2D_Double_Collection poses,
+   Rox_Double solutions[4][16],
+   const Rox_Uint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   for (Rox_Uint idroot = 0; idroot < count; idroot++)
+   {
+      error = rox_matse3_set_data(rox_array2d_double_collection_get(poses, idroot), solutions[idroot]);
       ROX_ERROR_CHECK_TERMINATE(error)
    }
 
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_pose_from_two_3D_triangles (
+   Rox_MatSE3 cMo,
+   Rox_Point3D_Double pctriangle,
+   Rox_Point3D_Double potriangle
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double pose[16];
+
+   if (!cMo || !pctriangle || !potriangle) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_matse3_check_size ( cMo );
+   ROX_ERROR_CHECK_TERMINATE(error)
+
+   rox_p3p_pose_from_triangles(pose, pctriangle, potriangle);
+
+   error = rox_matse3_set_data(cMo, pose);
+   ROX_ERROR_CHECK_TERMINATE(error)
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_pose_from_3_points (
+   Rox_Array2D_Double_Collection poses,
+   Rox_Uint * validposes,
+   Rox_Point3D_Double points3D,
+   Rox_Point2D_Double points2D,
+   double fx,
+   double fy,
+   double u0,
+   double v0
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Double curpose;
+   Rox_Double ifx, ify, iu0, iv0;
+   Rox_Point2D_Double_Struct points2D_nor[3];
+   Rox_Double solutions[4][16];
+   Rox_Uint countsol = 0;
+
+   //  Check input 
+   if (!poses || !validposes)    
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   if (!points2D) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   if (!points3D) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   //  Check poses 
+   if (rox_array2d_double_collection_get_count(poses) != 4) 
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   curpose = rox_array2d_double_collection_get(poses, 0);
+
+   error = rox_array2d_double_check_size(curpose, 4, 4);
+   ROX_ERROR_CHECK_TERMINATE(error)
+
+   //  Get image points in meter space
+   ifx = 1.0 / fx;
+   ify = 1.0 / fy;
+   iu0 = -u0 * ifx;
+   iv0 = -v0 * ify;
+
+   for ( Rox_Sint id = 0; id < 3; id++)
+   {
+      points2D_nor[id].u = ifx * points2D[id].u + iu0;
+      points2D_nor[id].v = ify * points2D[id].v + iv0;
+   }
+
+   error = rox_p3p_solve(solutions, &countsol, points3D, points2D_nor);
+   if (error != ROX_ERROR_NONE) 
+   { error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_p3p_copy_poses(poses, solutions, countsol);
+   ROX_ERROR_CHECK_TERMINATE(error)
+
    *validposes = countsol;
 
 function_terminate:
@@ -390,20 +414,12 @@ Rox_ErrorCode rox_pose_from_p3p_nor (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Uint countsol;
    Rox_Array2D_Double curpose = NULL;
-   Rox_Point3D_Double_Struct mproj[3];
-   Rox_Point3D_Double_Struct dir3D12, dir3D13, dir3D23;
-   Rox_Double norme, inorme, x, y;
-   Rox_Double cos12, cos13, cos23;
-   Rox_Double ds12, ds13, ds23;
-   Rox_Double ratio2313, ratio2312;
-   Rox_Double quintic_coefficients[5];
-   Rox_Complex_Struct quintic_roots[4];
-   Rox_Point3D_Double_Struct possible_triangle[4][3];
+   Rox_Double solutions[4][16];
+   Rox_Uint countsol = 0;
 
    //  Check input 
-   if (!poses)    
+   if (!poses || !validposes)    
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
    
    if (!points2D) 
@@ -420,133 +436,48 @@ Rox_ErrorCode rox_pose_from_p3p_nor (
    error = rox_array2d_double_check_size(curpose, 4, 4);
    ROX_ERROR_CHECK_TERMINATE(error)
 
-   //  First, we need to compute all cZ to get a 3D point cloud
-   for ( Rox_Sint id = 0; id < 3; id++)
-   {
-      //  Get image points in meter space
-      x = points2D[id].u;
-      y = points2D[id].v;
-
-      norme = sqrt(x * x + y * y + 1.0);
-      if (ROX_IS_ZERO_DOUBLE(norme)) {error = ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE; ROX_ERROR_CHECK_TERMINATE(error)}
-
-      inorme = 1.0 / norme;
-
-      mproj[id].X = x * inorme;
-      mproj[id].Y = y * inorme;
-      mproj[id].Z = inorme;
-   }
-
-   // Global idea : a 3D transformation (SE(3)) keeps angles and distances between points.
-   // We already know a 3D triangle in world frame (points3D).
-   // Given our 2D Triangle in image space, search for a 3D Triangle in camera space which has the same property
-   // than the given points3D triangle (angle and distances).
-   // See Random Sample Consensus: A Paradigm for Model Fitting with Applicatlons to Image Analysis and Automated Cartography.
-
-   // Get cos(angle) for 3 pairs (1;2 1;3 2;3) for 2D triangle
-   cos12 = mproj[0].X * mproj[1].X + mproj[0].Y * mproj[1].Y + mproj[0].Z * mproj[1].Z;
-   cos13 = mproj[0].X * mproj[2].X + mproj[0].Y * mproj[2].Y + mproj[0].Z * mproj[2].Z;
-   cos23 = mproj[1].X * mproj[2].X + mproj[1].Y * mproj[2].Y + mproj[1].Z * mproj[2].Z;
-
-   // Get 3D points distances squared for 3 pairs (1;2 1;3 2;3) for 3D triangle
-   dir3D12.X = points3D[1].X - points3D[0].X;
-   dir3D12.Y = points3D[1].Y - points3D[0].Y;
-   dir3D12.Z = points3D[1].Z - points3D[0].Z;
-   dir3D13.X = points3D[2].X - points3D[0].X;
-   dir3D13.Y = points3D[2].Y - points3D[0].Y;
-   dir3D13.Z = points3D[2].Z - points3D[0].Z;
-   dir3D23.X = points3D[2].X - points3D[1].X;
-   dir3D23.Y = points3D[2].Y - points3D[1].Y;
-   dir3D23.Z = points3D[2].Z - points3D[1].Z;
-   ds12 = dir3D12.X * dir3D12.X + dir3D12.Y * dir3D12.Y + dir3D12.Z * dir3D12.Z;
-   ds13 = dir3D13.X * dir3D13.X + dir3D13.Y * dir3D13.Y + dir3D13.Z * dir3D13.Z;
-   ds23 = dir3D23.X * dir3D23.X + dir3D23.Y * dir3D23.Y + dir3D23.Z * dir3D23.Z;
-
-   // Solve quartic
-   ratio2313 = ds23 / ds13;
-   ratio2312 = ds23 / ds12;
-   quintic_coefficients[0] = (ratio2313 * ratio2312 - ratio2313 - ratio2312) * (ratio2313 * ratio2312 - ratio2313 - ratio2312) - 4.0 * ratio2313 * ratio2312 * cos23 * cos23;
-   quintic_coefficients[1] = 4.0 * (ratio2313 * ratio2312 - ratio2313 - ratio2312) * ratio2312 * (1.0 - ratio2313) * cos12 + 4.0 * ratio2313 * cos23 * ((ratio2313 * ratio2312 + ratio2312 - ratio2313) * cos13 + 2.0 * ratio2312 * cos12 * cos23);
-   quintic_coefficients[2] = (2.0 * ratio2312 * (1.0 - ratio2313) * cos12) * (2.0 * ratio2312 * (1.0 - ratio2313) * cos12) + 2.0 * (ratio2313 * ratio2312 + ratio2313 - ratio2312) * (ratio2313 * ratio2312 - ratio2313 - ratio2312) + 4.0 * ratio2313 * ((ratio2313 - ratio2312) * cos23 * cos23 + (1.0 - ratio2312) * ratio2313 * cos13 * cos13 - 2.0 * ratio2312 * (1.0 + ratio2313) * cos12 * cos13 * cos23);
-   quintic_coefficients[3] = 4.0 * (ratio2313 * ratio2312 + ratio2313 - ratio2312) * ratio2312 * (1.0 - ratio2313) * cos12 + 4.0 * ratio2313 * ((ratio2313 * ratio2312 - ratio2313 + ratio2312) * cos13 * cos23 + 2.0 * ratio2313 * ratio2312 * cos12 * cos13 * cos13);
-   quintic_coefficients[4] = (ratio2313 * ratio2312 + ratio2313 - ratio2312) * (ratio2313 * ratio2312 + ratio2313 - ratio2312) - 4.0 * ratio2313 * ratio2313 * ratio2312 * cos13 * cos13;
-
-   error = rox_quartic_roots(quintic_roots, quintic_coefficients);
+   error = rox_p3p_solve(solutions, &countsol, points3D, points2D);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Given each root, try to get a corresponding ray length for each vertex of the 2D triangle
-   countsol = 0;
-   for ( Rox_Sint idroot = 0; idroot < 4; idroot++)
-   {
-      Rox_Double r, i;
-      Rox_Double a, b, c, pc1, pc2;
-      Rox_Double y, m0, m1, p0, p1, q0, q1;
-      Rox_Double base;
+   error = rox_p3p_copy_poses(poses, solutions, countsol);
+   ROX_ERROR_CHECK_TERMINATE(error)
 
-      r = quintic_roots[idroot].real;
-      i = quintic_roots[idroot].imag;
+   *validposes = countsol;
 
-      // Check if the given root is valid or not
-      if (i > 1e-8 || r < 0.0) continue;
+function_terminate:
+   return error;
+}
 
-      a = sqrt(ds12) / sqrt(r * r - 2.0 * r * cos12 + 1.0);
-      b = a * r;
-      c = -1;
+Rox_ErrorCode rox_pose_from_p3p_nor_batch (
+   Rox_P3P_Solutions_Struct * solutions,
+   const Rox_Point3D_Double points3D,
+   const Rox_Point2D_Double points2D,
+   const Rox_Sint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint idsample = 0;
 
-      m0 = 1.0 - ratio2313;
-      q0 = r * r - ratio2313;
-      p0 = 2.0 * (ratio2313 * cos13 - r * cos23);
-      m1 = 1.0;
-      q1 = r * r * (1.0 - ratio2312) + 2 * r * ratio2312 * cos12 - ratio2312;
-      p1 = -2 * r * cos23;
+   if (!solutions || !points3D || !points2D) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-      if (fabs(m1 * q0 - m0 * q1) < DBL_EPSILON)
-      {
-         base = sqrt(cos13 * cos13 + (ds13 - a * a) / (a * a));
-         pc1 = (cos13 + base) * a;
-         pc2 = (cos13 - base) * a;
+   if (count < 0) 
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-         if (fabs((b * b + pc1 * pc1 - 2.0 * b * pc1 * cos23) - (ds13)) < DBL_EPSILON)
-         {
-            c = pc1;
-         }
-         else if (fabs((b * b + pc2 * pc2 - 2.0 * b * pc2 * cos23) - (ds13)) < DBL_EPSILON)
-         {
-            c = pc2;
-         }
-      }
-      else
-      {
-         y = (p1 * q0 - p0 * q1) / (m0 * q1 - m1 * q0);
-         c = y * a;
-      }
+   // The samples are independent and solved on the stack
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for (idsample = 0; idsample < count; idsample++)
+   {
+      Rox_P3P_Solutions_Struct * current = &solutions[idsample];
 
-      if (c > 0.0)
+      if (rox_p3p_solve(current->poses, &current->count, &points3D[3 * idsample], &points2D[3 * idsample]))
       {
-         possible_triangle[countsol][0].X = mproj[0].X * a;
-         possible_triangle[countsol][0].Y = mproj[0].Y * a;
-         possible_triangle[countsol][0].Z = mproj[0].Z * a;
-         possible_triangle[countsol][1].X = mproj[1].X * b;
-         possible_triangle[countsol][1].Y = mproj[1].Y * b;
-         possible_triangle[countsol][1].Z = mproj[1].Z * b;
-         possible_triangle[countsol][2].X = mproj[2].X * c;
-         possible_triangle[countsol][2].Y = mproj[2].Y * c;
-         possible_triangle[countsol][2].Z = mproj[2].Z * c;
-
-         countsol++;
+         current->count = 0;
       }
    }
 
-   // Get the 3D transformation which transforms 3D given triangle to estimated triangle
-   for (Rox_Uint idroot = 0; idroot < countsol; idroot++)
-   {
-      curpose = rox_array2d_double_collection_get(poses, idroot);
-      error = rox_pose_from_two_3D_triangles(curpose, possible_triangle[idroot], points3D);
-      ROX_ERROR_CHECK_TERMINATE(error)
-   }
-
-   *validposes = countsol;
-
 function_terminate:
    return error;
 }
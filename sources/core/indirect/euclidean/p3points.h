@@ -27,6 +27,19 @@
 //! \addtogroup p3p
 //! @{
 
+//! The solutions of one P3P problem
+struct Rox_P3P_Solutions_Struct
+{
+   //! The number of possible poses (0 if the solver failed)
+   Rox_Uint count;
+
+   //! The possible poses cTr, row major 4x4 matrices
+   Rox_Double poses[4][16];
+};
+
+//! Define the structure as a value type
+typedef struct Rox_P3P_Solutions_Struct Rox_P3P_Solutions_Struct;
+
 //! Estimate the transformation between reference and current frame using known 3 pairs of 3D points in both frames
 //! \param  [out]  cTr                Estimated pose
 //! \param  [in ]  ctriangle          Array of three points in 3D current frame
@@ -91,6 +104,20 @@ ROX_API Rox_ErrorCode rox_pose_from_p3p_pix (
    Rox_MatUT3 calib
 );
 
+//! Solve a batch of P3P problems with rox_pose_from_p3p_nor, without any memory allocation.
+//! The possible poses of each sample are the same as the ones of rox_pose_from_p3p_nor.
+//! \param  [out]  solutions            The solutions of the samples (count structures)
+//! \param  [in ]  points3D             Array of 3 * count 3D points (meters) in reference frame, 3 consecutive points per sample
+//! \param  [in ]  points2D             Array of 3 * count 2D points (normal) in current frame, 3 consecutive points per sample
+//! \param  [in ]  count                The number of samples
+//! \return An error code, the samples for which the solver fails have no solution
+ROX_API Rox_ErrorCode rox_pose_from_p3p_nor_batch (
+   Rox_P3P_Solutions_Struct * solutions, 
+   const Rox_Point3D_Double points3D, 
+   const Rox_Point2D_Double points2D, 
+   const Rox_Sint count
+);
+
 //! @}
 
 #endif
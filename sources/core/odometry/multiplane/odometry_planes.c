@@ -14,6 +14,8 @@
 
 #include "odometry_planes.h"
 
+#include <float.h>
+
 #include <generated/objset_patchplane_pyramid_struct.h>
 
 #include <baseproc/array/conversion/array2d_float_from_uchar.h>
@@ -28,6 +30,7 @@
 #include <baseproc/geometry/transforms/transform_tools.h>
 #include <baseproc/geometry/pixelgrid/warp_grid_matsl3.h>
 #include <baseproc/image/imask/imask.h>
+#include <baseproc/image/gradient/basegradient.h>
 
 #include <core/patch/patchplane.h>
 #include <baseproc/calculus/linsys/linsys_se3_light_affine_premul_left.h>
@@ -48,6 +51,224 @@
 
 // static int count_iter = 0;
 
+// Mean squared gradient of the reference of a patch on its mask
+static Rox_ErrorCode rox_odometry_planes_reference_gradient (
+   Rox_Double * gradient,
+   Rox_PatchPlane patch
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float ** gx_data = NULL, ** gy_data = NULL;
+   Rox_Uint ** mask_data = NULL;
+   Rox_Double sum = 0.0;
+   Rox_Sint count = 0;
+
+   // The gradient buffers of the patch are overwritten at each warp, use them as scratch
+   error = rox_array2d_float_basegradient ( patch->gx, patch->gy, patch->gradient_mask, patch->reference, patch->reference_mask );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &gx_data, patch->gx );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &gy_data, patch->gy );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &mask_data, patch->gradient_mask );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for ( Rox_Sint i = 0; i < patch->height; i++ )
+   {
+      for ( Rox_Sint j = 0; j < patch->width; j++ )
+      {
+         if ( !mask_data[i][j] ) continue;
+
+         sum += gx_data[i][j] * gx_data[i][j] + gy_data[i][j] * gy_data[i][j];
+         count++;
+      }
+   }
+
+   *gradient = count > 0 ? sum / count : 0.0;
+
+function_terminate:
+   return error;
+}
+
+// Check if a patch warped by an homography is entirely out of the image.
+// Only the planes in front of the camera are checked: the image of the patch is then the convex hull of its warped corners
+static Rox_Sint rox_odometry_planes_is_out_of_view (
+   const Rox_MatSL3 homography,
+   const Rox_Sint width,
+   const Rox_Sint height,
+   const Rox_Sint image_rows,
+   const Rox_Sint image_cols
+)
+{
+   Rox_Double ** H = NULL;
+   Rox_Double umin = DBL_MAX, umax = -DBL_MAX, vmin = DBL_MAX, vmax = -DBL_MAX;
+   const Rox_Double corners[4][2] = { { 0, 0 }, { width - 1, 0 }, { width - 1, height - 1 }, { 0, height - 1 } };
+
+   if ( rox_array2d_double_get_data_pointer_to_pointer ( &H, homography ) ) return 0;
+
+   for ( Rox_Sint k = 0; k < 4; k++ )
+   {
+      Rox_Double u = corners[k][0], v = corners[k][1];
+      Rox_Double w = H[2][0] * u + H[2][1] * v + H[2][2];
+      if ( w <= DBL_EPSILON ) return 0;
+
+      Rox_Double nu = ( H[0][0] * u + H[0][1] * v + H[0][2] ) / w;
+      Rox_Double nv = ( H[1][0] * u + H[1][1] * v + H[1][2] ) / w;
+
+      if ( nu < umin ) umin = nu;
+      if ( nu > umax ) umax = nu;
+      if ( nv < vmin ) vmin = nv;
+      if ( nv > vmax ) vmax = nv;
+   }
+
+   return ( umax < 0 || vmax < 0 || umin > image_cols - 1 || vmin > image_rows - 1 );
+}
+
+// Build the homography of a plane for a given level and warp the current image on its patch.
+// The plane is culled before warping if its reference lacks texture or if it is out of the image
+static Rox_ErrorCode rox_odometry_planes_warp_plane (
+   Rox_Sint * valid,
+   Rox_Odometry_Planes odometry_planes,
+   const Rox_Model_Single_Plane curmodel,
+   const Rox_Array2D_Float source,
+   const Rox_Sint level,
+   const Rox_Uint idpatch
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_PatchPlane patch = odometry_planes->patches->data[idpatch]->levels[level];
+   Rox_MatUT3 calib_zoom = odometry_planes->plane_zoom[idpatch];
+   Rox_MatSL3 homography = odometry_planes->plane_homography[idpatch];
+   Rox_MatSL3 c_G_o = NULL;
+
+   *valid = 0;
+
+   if ( odometry_planes->reference_gradient[idpatch * odometry_planes->min_level + level] < odometry_planes->min_gradient ) goto function_terminate;
+
+   // Set the zoom calibration matrix for the given level
+   error = rox_transformtools_matrix33_left_pyramidzoom ( calib_zoom, curmodel->calibration_template, level );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( POSE_SHIFT_TZ1 == 1 )
+   {
+      // Build homography for current view/patch
+      error = rox_transformtools_build_homography ( homography, curmodel->c_T_z1, odometry_planes->calib_camera, calib_zoom, 0, 0, 1, -1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+   else
+   {
+      // New code to replace rox_transformtools_build_homography function
+      error = rox_matsl3_new ( &c_G_o ) ;
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_transformtools_build_model_to_image_homography ( c_G_o, odometry_planes->calib_camera, curmodel->c_T_z0 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_matsl3_mulmatinv ( homography, c_G_o, calib_zoom );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   Rox_Sint image_rows = 0, image_cols = 0;
+   error = rox_array2d_float_get_size ( &image_rows, &image_cols, source );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( rox_odometry_planes_is_out_of_view ( homography, patch->width, patch->height, image_rows, image_cols ) ) goto function_terminate;
+
+   error = rox_patchplane_prepare_sl3 ( patch, homography, source );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_patchplane_prepare_finish ( patch );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Sint valid_pixels = 0;
+   error = rox_imask_count_valid ( &valid_pixels, patch->current_mask );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   *valid = ( valid_pixels > 0 );
+
+function_terminate:
+   rox_matsl3_del ( &c_G_o );
+   return error;
+}
+
+// Warp a plane and compute the J'*J and J'*f of its patch
+static Rox_ErrorCode rox_odometry_planes_linearize_plane (
+   Rox_Odometry_Planes odometry_planes,
+   const Rox_Model_Multi_Plane model_multi_plane,
+   const Rox_Array2D_Float source,
+   const Rox_Sint level,
+   const Rox_Uint idpatch
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_PatchPlane patch = odometry_planes->patches->data[idpatch]->levels[level];
+   Rox_Model_Single_Plane curmodel = model_multi_plane->planes->data[idpatch];
+   Rox_Sint valid = 0;
+
+   odometry_planes->plane_valid[idpatch] = 0;
+
+   error = rox_odometry_planes_warp_plane ( &valid, odometry_planes, curmodel, source, level, idpatch );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( !valid ) goto function_terminate;
+
+   // J'*J of the plane: from 0 to 5 is the pose, 6 is alpha, 7 is beta
+   if ( POSE_SHIFT_TZ1 == 1 )
+   {
+      error = rox_jacobian_se3_z1_light_affine_premul_left ( odometry_planes->plane_JtJ[idpatch], odometry_planes->plane_Jtf[idpatch], patch->gx, patch->gy, patch->mean, patch->difference, patch->gradient_mask, curmodel->c_T_z1, odometry_planes->plane_zoom[idpatch] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+   else
+   {
+      error = rox_jacobian_se3_light_affine_premul_left ( odometry_planes->plane_JtJ[idpatch], odometry_planes->plane_Jtf[idpatch], patch->gx, patch->gy, patch->mean, patch->difference, patch->gradient_mask, curmodel->c_T_z0, odometry_planes->plane_zoom[idpatch] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   odometry_planes->plane_valid[idpatch] = 1;
+
+function_terminate:
+   return error;
+}
+
+// Add the system of a plane to the global one ( same pose, same beta but different alpha )
+static Rox_Void rox_odometry_planes_accumulate (
+   Rox_Double ** LtL_data,
+   Rox_Double ** Lte_data,
+   Rox_Double ** local_LtL_data,
+   Rox_Double ** local_Lte_data,
+   const Rox_Sint current_pos
+)
+{
+   for ( Rox_Sint k = 0; k < 6; k++ )
+   {
+      for ( Rox_Sint l = 0; l < 6; l++ )
+      {
+         LtL_data[k][l] += local_LtL_data[k][l];
+      }
+
+      Lte_data[k][0] += local_Lte_data[k][0];
+   }
+
+   for ( Rox_Sint k = 0; k < 6; k++ )
+   {
+      LtL_data[ 6               ][ k               ] += local_LtL_data[ 7 ][ k ];
+      LtL_data[ k               ][ 6               ] += local_LtL_data[ 7 ][ k ];
+      LtL_data[ 7 + current_pos ][ k               ] += local_LtL_data[ 6 ][ k ];
+      LtL_data[ k               ][ 7 + current_pos ] += local_LtL_data[ 6 ][ k ];
+   }
+
+   // ( We inverse alpha and beta order so that the common beta come first, the the alpha of each plane
+   LtL_data[ 7 + current_pos ][ 7 + current_pos ] += local_LtL_data[ 6 ][ 6 ];
+   LtL_data[ 7 + current_pos ][ 6               ] += local_LtL_data[ 6 ][ 7 ];
+   LtL_data[ 6               ][ 7 + current_pos ] += local_LtL_data[ 7 ][ 6 ];
+   LtL_data[ 6               ][ 6               ] += local_LtL_data[ 7 ][ 7 ];
+   Lte_data[ 7 + current_pos ][ 0               ] += local_Lte_data[ 6 ][ 0 ];
+   Lte_data[ 6               ][ 0               ] += local_Lte_data[ 7 ][ 0 ];
+}
+
 Rox_ErrorCode rox_odometry_planes_new (
    Rox_Odometry_Planes * odometry_planes,
    const Rox_Model_Multi_Plane model_multi_plane
@@ -76,6 +297,17 @@ Rox_ErrorCode rox_odometry_planes_new (
    ret->min_level = 1000;
    ret->predicter = NULL;
 
+   ret->count_planes       = 0;
+   ret->plane_JtJ          = NULL;
+   ret->plane_Jtf          = NULL;
+   ret->plane_homography   = NULL;
+   ret->plane_zoom         = NULL;
+   ret->plane_valid        = NULL;
+   ret->plane_score        = NULL;
+   ret->plane_errors       = NULL;
+   ret->reference_gradient = NULL;
+   ret->min_gradient       = 0.0;
+
    // Reset current score to 0
    ret->score = 0.0;
 
@@ -98,13 +330,42 @@ Rox_ErrorCode rox_odometry_planes_new (
    error = rox_array2d_double_new( &ret->homography, 3, 3 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   ret->localJtJ     = NULL;
-   error = rox_array2d_double_new ( &ret->localJtJ, 8, 8 );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // Buffers of each plane, so that the planes can be processed concurrently
+   Rox_Uint count_planes   = model_multi_plane->planes->used;
+   ret->plane_JtJ          = (Rox_Matrix *) rox_memory_allocate ( sizeof(Rox_Matrix), count_planes );
+   ret->plane_Jtf          = (Rox_Matrix *) rox_memory_allocate ( sizeof(Rox_Matrix), count_planes );
+   ret->plane_homography   = (Rox_MatSL3 *) rox_memory_allocate ( sizeof(Rox_MatSL3), count_planes );
+   ret->plane_zoom         = (Rox_MatUT3 *) rox_memory_allocate ( sizeof(Rox_MatUT3), count_planes );
+   ret->plane_valid        = (Rox_Sint *) rox_memory_allocate ( sizeof(Rox_Sint), count_planes );
+   ret->plane_score        = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), count_planes );
+   ret->plane_errors       = (Rox_ErrorCode *) rox_memory_allocate ( sizeof(Rox_ErrorCode), count_planes );
+
+   if ( !ret->plane_JtJ || !ret->plane_Jtf || !ret->plane_homography || !ret->plane_zoom || !ret->plane_valid || !ret->plane_score || !ret->plane_errors )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   ret->localJtf     = NULL;
-   error = rox_array2d_double_new ( &ret->localJtf, 8, 1 );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   for ( Rox_Uint id = 0; id < count_planes; id++ )
+   {
+      ret->plane_JtJ[id] = NULL;
+      ret->plane_Jtf[id] = NULL;
+      ret->plane_homography[id] = NULL;
+      ret->plane_zoom[id] = NULL;
+   }
+   ret->count_planes = count_planes;
+
+   for ( Rox_Uint id = 0; id < ret->count_planes; id++ )
+   {
+      error = rox_matrix_new ( &ret->plane_JtJ[id], 8, 8 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_matrix_new ( &ret->plane_Jtf[id], 8, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_matsl3_new ( &ret->plane_homography[id] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_matut3_new ( &ret->plane_zoom[id] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
    ret->patches      = NULL;
    error = rox_objset_patchplane_pyramid_new ( &ret->patches, 5 );
@@ -143,6 +404,20 @@ Rox_ErrorCode rox_odometry_planes_new (
       pyramid = NULL;
    }
 
+   // Texture of the references at each level, used to skip the planes without enough gradient
+   ret->reference_gradient = (Rox_Double *) rox_memory_allocate ( sizeof(Rox_Double), ret->count_planes * ret->min_level );
+   if ( !ret->reference_gradient )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Uint id = 0; id < ret->count_planes; id++ )
+   {
+      for ( Rox_Uint level = 0; level < ret->min_level; level++ )
+      {
+         error = rox_odometry_planes_reference_gradient ( &ret->reference_gradient[id * ret->min_level + level], ret->patches->data[id]->levels[level] );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+   }
+
    ret->prediction_radius = 16;
    ret->max_iterations = 10;
    ret->score_threshold = 0.89;
@@ -202,8 +477,22 @@ Rox_ErrorCode rox_odometry_planes_del (
    rox_matut3_del ( &todel->calib_camera );
    rox_matut3_del ( &todel->calib_zoom );
    rox_matsl3_del ( &todel->homography );
-   rox_matrix_del ( &todel->localJtJ );
-   rox_matrix_del ( &todel->localJtf );
+
+   for ( Rox_Uint id = 0; id < todel->count_planes; id++ )
+   {
+      if ( todel->plane_JtJ ) rox_matrix_del ( &todel->plane_JtJ[id] );
+      if ( todel->plane_Jtf ) rox_matrix_del ( &todel->plane_Jtf[id] );
+      if ( todel->plane_homography ) rox_matsl3_del ( &todel->plane_homography[id] );
+      if ( todel->plane_zoom ) rox_matut3_del ( &todel->plane_zoom[id] );
+   }
+   rox_memory_delete ( todel->plane_JtJ );
+   rox_memory_delete ( todel->plane_Jtf );
+   rox_memory_delete ( todel->plane_homography );
+   rox_memory_delete ( todel->plane_zoom );
+   rox_memory_delete ( todel->plane_valid );
+   rox_memory_delete ( todel->plane_score );
+   rox_memory_delete ( todel->plane_errors );
+   rox_memory_delete ( todel->reference_gradient );
 
    for ( Rox_Uint id = 0; id < todel->patches->used; id++ )
    {
@@ -243,16 +532,19 @@ Rox_ErrorCode rox_odometry_planes_optim_esm (
    Rox_Array2D_Double subsol_vt = NULL;
    Rox_Array2D_Double subsol_vr = NULL;
 
+   Rox_Array2D_Double iLtL_sub = NULL;
+   Rox_Array2D_Double LtL_sub = NULL;
+   Rox_Array2D_Double Lte_sub = NULL;
+   Rox_Array2D_Double sol_sub = NULL;
+
+   const Rox_Sint count_planes = (Rox_Sint) model_multi_plane->planes->used;
+
    // Compute number of visible patches, this can be done before optimisation because
    // we suppose the minimization will not severely impact visibility of planes
-   Rox_Sint * visibility_list = (Rox_Sint *) rox_memory_allocate ( sizeof(Rox_Sint), model_multi_plane->planes->used );
-
    count_visibles = 0;
-   for ( Rox_Uint idpatch = 0; idpatch < model_multi_plane->planes->used; idpatch++ )
+   for ( Rox_Sint idpatch = 0; idpatch < count_planes; idpatch++ )
    {
-      visibility_list[idpatch] = 0;
       if ( model_multi_plane->planes->data[idpatch]->is_potentially_visible == 0 ) continue;
-      visibility_list[idpatch] = 1;
       count_visibles++;
    }
 
@@ -276,14 +568,6 @@ Rox_ErrorCode rox_odometry_planes_optim_esm (
    error = rox_matrix_new ( &sol, 7 + count_visibles, 1 );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Double ** local_LtL_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &local_LtL_data, odometry_planes->localJtJ );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Double ** local_Lte_data = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer ( &local_Lte_data,  odometry_planes->localJtf );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    Rox_Double ** LtL_data = NULL;
    error  = rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data,  LtL );
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -304,208 +588,110 @@ Rox_ErrorCode rox_odometry_planes_optim_esm (
       error  = rox_array2d_double_fillval ( Lte, 0 );
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      // Loop over patches to fill jacobian
-      for ( Rox_Uint idpatch = 0; idpatch < model_multi_plane->planes->used; idpatch++ )
+      // The planes are independent until the reduction: warp and linearize them concurrently
+#ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for ( Rox_Sint idpatch = 0; idpatch < count_planes; idpatch++ )
       {
+         odometry_planes->plane_valid[idpatch] = 0;
+         odometry_planes->plane_errors[idpatch] = ROX_ERROR_NONE;
+
          // Avoid hidden surfaces
          if ( model_multi_plane->planes->data[idpatch]->is_potentially_visible == 0 ) continue;
 
-         Rox_PatchPlane_Pyramid pyramid = odometry_planes->patches->data[idpatch];
-         Rox_PatchPlane patch = pyramid->levels[level];
-         Rox_Model_Single_Plane curmodel = model_multi_plane->planes->data[idpatch];
+         odometry_planes->plane_errors[idpatch] = rox_odometry_planes_linearize_plane ( odometry_planes, model_multi_plane, source, level, idpatch );
+      }
 
-         // Set the zoom calibration matrix for the given level
-         error = rox_transformtools_matrix33_left_pyramidzoom ( odometry_planes->calib_zoom, curmodel->calibration_template, level );
+      // Append per patch jacobian to global jacobian, in the order of the planes
+      for ( Rox_Sint idpatch = 0; idpatch < count_planes; idpatch++ )
+      {
+         error = odometry_planes->plane_errors[idpatch];
          ROX_ERROR_CHECK_TERMINATE ( error );
 
-         if ( POSE_SHIFT_TZ1 == 1 )
-         {
-            // Build homography for current view/patch
-            error = rox_transformtools_build_homography ( odometry_planes->homography, curmodel->c_T_z1, odometry_planes->calib_camera, odometry_planes->calib_zoom, 0, 0, 1, -1 );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-         else
-         {
-            // New code to replace rox_transformtools_build_homography function
-
-            Rox_MatUT3 Kc    = odometry_planes->calib_camera;
-            Rox_MatSE3 c_T_o = curmodel->c_T_z0;
-            Rox_MatSL3 t_G_o = odometry_planes->calib_zoom;
-            Rox_MatSL3 c_G_t = odometry_planes->homography;
-            Rox_MatSL3 c_G_o = NULL; // should be permanently stored in the odometry object ?
-
-            error = rox_matsl3_new ( &c_G_o ) ;
-            ROX_ERROR_CHECK_TERMINATE ( error );
-
-            error = rox_transformtools_build_model_to_image_homography ( c_G_o, Kc, c_T_o );
-            ROX_ERROR_CHECK_TERMINATE ( error );
+         if ( odometry_planes->plane_valid[idpatch] == 0 ) continue;
 
-            error = rox_matsl3_mulmatinv ( c_G_t, c_G_o, t_G_o );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-
-            rox_matsl3_del ( &c_G_o );
-         }
-
-         // Compute jacobian for this patch only
-         error = rox_patchplane_prepare_sl3 ( patch, odometry_planes->homography, source );
+         Rox_Double ** local_LtL_data = NULL;
+         error = rox_array2d_double_get_data_pointer_to_pointer ( &local_LtL_data, odometry_planes->plane_JtJ[idpatch] );
          ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_patchplane_prepare_finish ( patch );
+         Rox_Double ** local_Lte_data = NULL;
+         error = rox_array2d_double_get_data_pointer_to_pointer ( &local_Lte_data, odometry_planes->plane_Jtf[idpatch] );
          ROX_ERROR_CHECK_TERMINATE ( error );
 
-         Rox_Sint valid_pixels = 0;
-         error = rox_imask_count_valid ( &valid_pixels, patch->current_mask );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         if (valid_pixels == 0)
-         {
-            visibility_list[idpatch] = 0;
-            continue;
-         }
+         rox_odometry_planes_accumulate ( LtL_data, Lte_data, local_LtL_data, local_Lte_data, current_pos );
 
-         // localJtJ: from 0 to 5 is the pose, 6 is beta, from 7 to 7 + nbpatch is alpha
-         if ( POSE_SHIFT_TZ1 == 1)
-         {
-            error = rox_jacobian_se3_z1_light_affine_premul_left ( odometry_planes->localJtJ,
-                                                                      odometry_planes->localJtf,
-                                                                      patch->gx,
-                                                                      patch->gy,
-                                                                      patch->mean,
-                                                                      patch->difference,
-                                                                      patch->gradient_mask,
-                                                                      curmodel->c_T_z1,
-                                                                      odometry_planes->calib_zoom );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-         else
-         {
-            error = rox_jacobian_se3_light_affine_premul_left ( odometry_planes->localJtJ,
-                                                                  odometry_planes->localJtf,
-                                                                   patch->gx,
-                                                                   patch->gy,
-                                                                   patch->mean,
-                                                                   patch->difference,
-                                                                   patch->gradient_mask,
-                                                                   curmodel->c_T_z0,
-                                                                   odometry_planes->calib_zoom );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-
-         // Append per patch jacobian to global jacobian ( same pose, same beta but different alpha )
-         for ( Rox_Sint k = 0; k < 6; k++ )
-         {
-            for ( Rox_Sint l = 0; l < 6; l++ )
-            {
-               LtL_data[k][l] += local_LtL_data[k][l];
-            }
-
-            Lte_data[k][0] += local_Lte_data[k][0];
-         }
-
-           for ( Rox_Sint k = 0; k < 6; k++ )
-            {
-               LtL_data[ 6               ][ k               ] += local_LtL_data[ 7 ][ k ];
-               LtL_data[ k               ][ 6               ] += local_LtL_data[ 7 ][ k ];
-               LtL_data[ 7 + current_pos ][ k               ] += local_LtL_data[ 6 ][ k ];
-               LtL_data[ k               ][ 7 + current_pos ] += local_LtL_data[ 6 ][ k ];
-            }
-
-            // ( We inverse alpha and beta order so that the common beta come first, the the alpha of each plane
-            LtL_data[ 7 + current_pos ][ 7 + current_pos ] += local_LtL_data[ 6 ][ 6 ];
-            LtL_data[ 7 + current_pos ][ 6               ] += local_LtL_data[ 6 ][ 7 ];
-            LtL_data[ 6               ][ 7 + current_pos ] += local_LtL_data[ 7 ][ 6 ];
-            LtL_data[ 6               ][ 6               ] += local_LtL_data[ 7 ][ 7 ];
-            Lte_data[ 7 + current_pos ][ 0               ] += local_Lte_data[ 6 ][ 0 ];
-            Lte_data[ 6               ][ 0               ] += local_Lte_data[ 7 ][ 0 ];
-
-            current_pos++;
-         }
-
-         // create submatrix of appropriate size depending on visible patches
-
-         Rox_Array2D_Double iLtL_sub = NULL;
-         error = rox_array2d_double_new_subarray2d (&iLtL_sub, iLtL, 0, 0, 7+current_pos, 7+current_pos);
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-         Rox_Array2D_Double LtL_sub = NULL;
-         error = rox_array2d_double_new_subarray2d (&LtL_sub, LtL, 0, 0, 7+current_pos, 7+current_pos);
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         current_pos++;
+      }
 
-         Rox_Array2D_Double Lte_sub = NULL;
-         error = rox_array2d_double_new_subarray2d (&Lte_sub, Lte, 0, 0, 7+current_pos, 1);
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      // create submatrix of appropriate size depending on visible patches
 
-         Rox_Array2D_Double sol_sub = NULL;
-         error = rox_array2d_double_new_subarray2d (&sol_sub, sol, 0, 0, 7+current_pos, 1);
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_new_subarray2d (&iLtL_sub, iLtL, 0, 0, 7+current_pos, 7+current_pos);
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         Rox_Double ** dsol = NULL;
-         error = rox_array2d_double_get_data_pointer_to_pointer( &dsol, sol_sub );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_new_subarray2d (&LtL_sub, LtL, 0, 0, 7+current_pos, 7+current_pos);
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_array2d_double_new_subarray2d( &subsol, sol_sub, 0, 0, 6, 1 );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_new_subarray2d (&Lte_sub, Lte, 0, 0, 7+current_pos, 1);
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_array2d_double_new_subarray2d( &subsol_vt, sol_sub, 0, 0, 3, 1 );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_new_subarray2d (&sol_sub, sol, 0, 0, 7+current_pos, 1);
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_array2d_double_new_subarray2d( &subsol_vr, sol_sub, 3, 0, 3, 1 );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      Rox_Double ** dsol = NULL;
+      error = rox_array2d_double_get_data_pointer_to_pointer( &dsol, sol_sub );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         // Update solution to the left ( reference frame is different for each patch, impossible to update to the right )
-         error = rox_array2d_double_svdinverse( iLtL_sub, LtL_sub );
-         if (error == ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE)
-         {
-            //rox_log("ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE \n");
-         }
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_new_subarray2d( &subsol, sol_sub, 0, 0, 6, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_array2d_double_mulmatmat( sol_sub, iLtL_sub, Lte_sub );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_new_subarray2d( &subsol_vt, sol_sub, 0, 0, 3, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         // error = rox_array2d_double_scale_inplace ( subsol, -1.0 );
-         // ROX_ERROR_CHECK_TERMINATE( error );
+      error = rox_array2d_double_new_subarray2d( &subsol_vr, sol_sub, 3, 0, 3, 1 );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         error = rox_matse3_update_left ( odometry_planes->pose, subsol );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      // Update solution to the left ( reference frame is different for each patch, impossible to update to the right )
+      error = rox_array2d_double_svdinverse( iLtL_sub, LtL_sub );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         // Update model pose
-         error = rox_model_multi_plane_set_currentpose ( model_multi_plane, odometry_planes->pose );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_array2d_double_mulmatmat( sol_sub, iLtL_sub, Lte_sub );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         // Update patch lighting parameters
-         current_pos = 0;
-         for ( Rox_Uint idpatch = 0; idpatch < model_multi_plane->planes->used; idpatch++ )
-         {
-            if ( model_multi_plane->planes->data[idpatch]->is_potentially_visible == 0 ) continue;
+      error = rox_matse3_update_left ( odometry_planes->pose, subsol );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-            if ( visibility_list[idpatch] == 0) { continue; }
-            Rox_PatchPlane_Pyramid pyramid  = odometry_planes->patches->data[idpatch];
-            pyramid->levels[level]->beta  += (Rox_Float) dsol[ 6               ][ 0 ];
-            pyramid->levels[level]->alpha += (Rox_Float) dsol[ 7 + current_pos ][ 0 ];
-            current_pos++;
-         }
+      // Update model pose
+      error = rox_model_multi_plane_set_currentpose ( model_multi_plane, odometry_planes->pose );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         // Convergence test
-         //error = rox_array2d_double_norm2sq ( &norm, subsol );
-         // ROX_ERROR_CHECK_TERMINATE ( error );
+      // Update patch lighting parameters
+      current_pos = 0;
+      for ( Rox_Sint idpatch = 0; idpatch < count_planes; idpatch++ )
+      {
+         if ( odometry_planes->plane_valid[idpatch] == 0 ) continue;
 
-         error = rox_array2d_double_norm2sq ( &norm_vt, subsol_vt );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-         
-         error = rox_array2d_double_norm2sq ( &norm_vr, subsol_vr );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         Rox_PatchPlane_Pyramid pyramid  = odometry_planes->patches->data[idpatch];
+         pyramid->levels[level]->beta  += (Rox_Float) dsol[ 6               ][ 0 ];
+         pyramid->levels[level]->alpha += (Rox_Float) dsol[ 7 + current_pos ][ 0 ];
+         current_pos++;
+      }
 
-         rox_matrix_del ( &subsol    );
-         rox_matrix_del ( &subsol_vt );
-         rox_matrix_del ( &subsol_vr );
+      // Convergence test
+      error = rox_array2d_double_norm2sq ( &norm_vt, subsol_vt );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      
+      error = rox_array2d_double_norm2sq ( &norm_vr, subsol_vr );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-         rox_matrix_del ( &sol_sub  );
-         rox_matrix_del ( &iLtL_sub );
-         rox_matrix_del ( &Lte_sub  );
-         rox_matrix_del ( &LtL_sub  );
+      rox_matrix_del ( &subsol    );
+      rox_matrix_del ( &subsol_vt );
+      rox_matrix_del ( &subsol_vr );
 
-      // count_iter++;
+      rox_matrix_del ( &sol_sub  );
+      rox_matrix_del ( &iLtL_sub );
+      rox_matrix_del ( &Lte_sub  );
+      rox_matrix_del ( &LtL_sub  );
 
       if (( norm_vt < CONV_THRESH_VT ) && ( norm_vr < CONV_THRESH_VR ))
       {
@@ -523,8 +709,10 @@ function_terminate:
    rox_matrix_del( &subsol );
    rox_matrix_del( &subsol_vt );
    rox_matrix_del( &subsol_vr );
-
-   rox_memory_delete(visibility_list);
+   rox_matrix_del( &sol_sub );
+   rox_matrix_del( &iLtL_sub );
+   rox_matrix_del( &Lte_sub );
+   rox_matrix_del( &LtL_sub );
 
    return error;
 
@@ -631,7 +819,6 @@ Rox_ErrorCode rox_odometry_planes_make (
 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Double score = 0.0;
    Rox_Sint countvalid = 0;
 
    Rox_MatSE3 pred_pose = NULL;
@@ -735,68 +922,41 @@ Rox_ErrorCode rox_odometry_planes_make (
       error = rox_model_multi_plane_set_currentpose ( model_multi_plane, odometry_planes->pose );
       ROX_ERROR_CHECK_TERMINATE(error)
 
-      // Compare reference and current for each patch
-      countvalid = 0;
-      odometry_planes->score = 0.0;
-      for ( Rox_Uint idpatch = 0; idpatch < model_multi_plane->planes->used; idpatch++ )
+      // Compare reference and current for each patch, concurrently
+#ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for ( Rox_Sint idpatch = 0; idpatch < (Rox_Sint) model_multi_plane->planes->used; idpatch++ )
       {
-         if ( model_multi_plane->planes->data[idpatch]->is_potentially_visible == 0 ) continue;
+         Rox_Sint valid = 0;
 
-         Rox_PatchPlane_Pyramid pyramid = odometry_planes->patches->data[idpatch];
-         Rox_PatchPlane patch = pyramid->levels[level];
+         odometry_planes->plane_score[idpatch] = 0.0;
+         odometry_planes->plane_errors[idpatch] = ROX_ERROR_NONE;
 
-         // Reproject current image on reference space
-         error = rox_transformtools_matrix33_left_pyramidzoom ( odometry_planes->calib_zoom, model_multi_plane->planes->data[idpatch]->calibration_template, level );
-         ROX_ERROR_CHECK_TERMINATE ( error );
-
-
-         if(POSE_SHIFT_TZ1 == 1)
-         {
-            error = rox_transformtools_build_homography ( odometry_planes->homography,
-                                                      model_multi_plane->planes->data[idpatch]->c_T_z1,
-                                                      odometry_planes->calib_camera,
-                                                      odometry_planes->calib_zoom,
-                                                      0, 0, 1, -1 );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-         }
-         else
-         {
-            // New code to replace rox_transformtools_build_homography function
-
-            Rox_MatUT3 Kc    = odometry_planes->calib_camera;
-            Rox_MatSE3 c_T_o = model_multi_plane->planes->data[idpatch]->c_T_z0;
-            Rox_MatSL3 t_G_o = odometry_planes->calib_zoom;
-            Rox_MatSL3 c_G_t = odometry_planes->homography;
-            Rox_MatSL3 c_G_o = NULL; // should be permanently stored in the odometry object ?
-
-            error = rox_matsl3_new ( &c_G_o ) ;
-            ROX_ERROR_CHECK_TERMINATE ( error );
-
-            error = rox_transformtools_build_model_to_image_homography ( c_G_o, Kc, c_T_o );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-
-            error = rox_matsl3_mulmatinv ( c_G_t, c_G_o, t_G_o );
-            ROX_ERROR_CHECK_TERMINATE ( error );
-
-            rox_matsl3_del ( &c_G_o );
-         }
-
-         error = rox_patchplane_prepare_sl3 ( patch, odometry_planes->homography, source );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         if ( model_multi_plane->planes->data[idpatch]->is_potentially_visible == 0 ) continue;
 
-         error = rox_patchplane_prepare_finish ( patch );
-         ROX_ERROR_CHECK_TERMINATE ( error );
+         // Reproject current image on reference space
+         odometry_planes->plane_errors[idpatch] = rox_odometry_planes_warp_plane ( &valid, odometry_planes, model_multi_plane->planes->data[idpatch], source, level, idpatch );
+         if ( odometry_planes->plane_errors[idpatch] || !valid ) continue;
 
          // Compute normalized ZNCC score between 0 and 1
-         error = rox_patchplane_compute_score ( &score, patch );
+         odometry_planes->plane_errors[idpatch] = rox_patchplane_compute_score ( &odometry_planes->plane_score[idpatch], odometry_planes->patches->data[idpatch]->levels[level] );
+      }
+
+      countvalid = 0;
+      odometry_planes->score = 0.0;
+      for ( Rox_Uint idpatch = 0; idpatch < model_multi_plane->planes->used; idpatch++ )
+      {
+         error = odometry_planes->plane_errors[idpatch];
          ROX_ERROR_CHECK_TERMINATE ( error );
 
+         if ( model_multi_plane->planes->data[idpatch]->is_potentially_visible == 0 ) continue;
 
          // If current is similar to reference, consider it valid and increment valid counter
-         if ( score > odometry_planes->score_threshold )
+         if ( odometry_planes->plane_score[idpatch] > odometry_planes->score_threshold )
          {
             countvalid++;
-            odometry_planes->score += score;
+            odometry_planes->score += odometry_planes->plane_score[idpatch];
          }
          else
          {
@@ -947,3 +1107,18 @@ Rox_ErrorCode rox_odometry_planes_set_camera_calibration (
 function_terminate:
    return error;
 }
+
+Rox_ErrorCode rox_odometry_planes_set_min_gradient (
+   Rox_Odometry_Planes odometry_planes,
+   const Rox_Double min_gradient )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if( !odometry_planes )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   odometry_planes->min_gradient = min_gradient;
+
+function_terminate:
+   return error;
+}
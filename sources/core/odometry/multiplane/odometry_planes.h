@@ -118,6 +118,16 @@ ROX_API Rox_ErrorCode rox_odometry_planes_set_camera_calibration (
    const Rox_MatUT3 calibration_camera 
 );
 
+//! Set the minimal mean squared gradient of the plane references.
+//! Planes with less texture are skipped before being warped (by default no plane is skipped)
+//! \param  [in ]  odometry_planes           The tracking object
+//! \param  [in ]  min_gradient              The minimal mean squared gradient (reference images are normalized in [0, 1])
+//! \return An error code
+ROX_API Rox_ErrorCode rox_odometry_planes_set_min_gradient ( 
+   Rox_Odometry_Planes odometry_planes, 
+   const Rox_Double min_gradient 
+);
+
 //! @}
 
 #endif
@@ -34,11 +34,35 @@
 //! Multiple plane odometry structure
 struct Rox_Odometry_Planes_Struct
 {
-   //! J'*J buffer
-   Rox_Matrix localJtJ;
+   //! Number of planes of the model
+   Rox_Uint count_planes;
 
-   //! J'*f buffer
-   Rox_Matrix localJtf;
+   //! J'*J buffer of each plane
+   Rox_Matrix * plane_JtJ;
+
+   //! J'*f buffer of each plane
+   Rox_Matrix * plane_Jtf;
+
+   //! Homography matrix of each plane
+   Rox_MatSL3 * plane_homography;
+
+   //! Intrinsics of the template camera of each plane, depending on the level of the pyramid
+   Rox_MatUT3 * plane_zoom;
+
+   //! Is each plane seen in the current image (not culled and with valid pixels)
+   Rox_Sint * plane_valid;
+
+   //! ZNCC score of each plane
+   Rox_Double * plane_score;
+
+   //! Error of each plane task
+   Rox_ErrorCode * plane_errors;
+
+   //! Mean squared gradient of the reference of each plane at each level ( plane * min_level + level )
+   Rox_Double * reference_gradient;
+
+   //! Planes whose reference mean squared gradient is lower than this value are not tracked
+   Rox_Double min_gradient;
 
    //! Estimated pose
    Rox_MatSE3 pose;
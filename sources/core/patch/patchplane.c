@@ -68,6 +68,9 @@ Rox_ErrorCode rox_patchplane_new ( Rox_PatchPlane *patch_plane, Rox_Sint height,
    ret->mean = NULL;
    ret->mean_lum = NULL;
 
+   // Inverse compositional
+   ret->steepest = NULL;
+
    error = rox_array2d_float_new(&ret->reference, height, width); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -141,6 +144,7 @@ Rox_ErrorCode rox_patchplane_del ( Rox_PatchPlane * patch_plane )
    rox_array2d_float_del(&todel->difference);
    rox_array2d_float_del(&todel->mean);
    rox_array2d_float_del(&todel->mean_lum);
+   if (todel->steepest) rox_linsys_steepest_descent_del(&todel->steepest);
    rox_memory_delete(todel);
 
 function_terminate:
@@ -164,6 +168,9 @@ Rox_ErrorCode rox_patchplane_set_reference (
    error = rox_array2d_uint_copy(patch_plane->reference_mask, sourcemask); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_patchplane_update_inverse_compositional(patch_plane);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
 function_terminate:
    return error;
 }
@@ -222,8 +229,8 @@ Rox_ErrorCode rox_patchplane_prepare_finish ( Rox_PatchPlane patch_plane )
    if ( !patch_plane ) 
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   // Luminance
-   error = rox_array2d_float_scaleshift ( patch_plane->warped_lum, patch_plane->current, patch_plane->alpha, patch_plane->beta); 
+   // Luminance and difference
+   error = rox_patchplane_prepare_difference ( patch_plane );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Mean
@@ -233,12 +240,76 @@ Rox_ErrorCode rox_patchplane_prepare_finish ( Rox_PatchPlane patch_plane )
    error = rox_array2d_float_mean ( patch_plane->mean_lum, patch_plane->reference, patch_plane->warped_lum); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   // Gradient
+   error = rox_array2d_float_basegradient ( patch_plane->gx, patch_plane->gy, patch_plane->gradient_mask, patch_plane->mean_lum, patch_plane->current_mask); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_patchplane_prepare_difference ( Rox_PatchPlane patch_plane )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !patch_plane ) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // Luminance
+   error = rox_array2d_float_scaleshift ( patch_plane->warped_lum, patch_plane->current, patch_plane->alpha, patch_plane->beta); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    // Difference
    error = rox_array2d_float_substract ( patch_plane->difference, patch_plane->reference, patch_plane->warped_lum); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Gradient
-   error = rox_array2d_float_basegradient ( patch_plane->gx, patch_plane->gy, patch_plane->gradient_mask, patch_plane->mean_lum, patch_plane->current_mask); 
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_patchplane_set_inverse_compositional ( 
+   Rox_PatchPlane patch_plane, 
+   enum Rox_Linsys_Steepest_Descent_Model model 
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !patch_plane ) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( patch_plane->steepest && patch_plane->steepest->model != model )
+   {
+      error = rox_linsys_steepest_descent_del ( &patch_plane->steepest );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   if ( !patch_plane->steepest )
+   {
+      error = rox_linsys_steepest_descent_new ( &patch_plane->steepest, model, patch_plane->height, patch_plane->width );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   error = rox_patchplane_update_inverse_compositional ( patch_plane );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_patchplane_update_inverse_compositional ( Rox_PatchPlane patch_plane )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !patch_plane ) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( !patch_plane->steepest ) goto function_terminate;
+
+   // The gradient buffers are not used by the inverse compositional trackers
+   error = rox_array2d_float_basegradient ( patch_plane->gx, patch_plane->gy, patch_plane->gradient_mask, patch_plane->reference, patch_plane->reference_mask ); 
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_linsys_steepest_descent_set_reference ( patch_plane->steepest, patch_plane->reference, patch_plane->gx, patch_plane->gy, patch_plane->gradient_mask );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
@@ -20,6 +20,7 @@
 #include <baseproc/geometry/pixelgrid/meshgrid2d.h>
 #include <baseproc/maths/linalg/matsl3.h>
 #include <baseproc/image/imask/imask.h>
+#include <baseproc/calculus/linsys/linsys_steepest_descent.h>
 
 //! \ingroup Patch
 //! \addtogroup PatchPlane
@@ -80,6 +81,10 @@ struct Rox_PatchPlane_Struct
 
    //! The mean of the reference template and the current template 
    Rox_Array2D_Float mean_lum;
+
+   // Inverse compositional
+   //! The steepest descent images of the reference, NULL if the inverse compositional mode is not used
+   Rox_Linsys_Steepest_Descent steepest;
 };
 
 //! Define the pointer of the Rox_PatchPlane_Struct 
@@ -131,6 +136,22 @@ ROX_API Rox_ErrorCode rox_patchplane_prepare_sl3(Rox_PatchPlane obj, Rox_MatSL3
 //! \todo   To be tested
 ROX_API Rox_ErrorCode rox_patchplane_prepare_finish(Rox_PatchPlane obj);
 
+//! Compute only the luminance corrected current template and the difference with the reference
+//! \param  [out]  obj            The patch
+//! \return An error code
+ROX_API Rox_ErrorCode rox_patchplane_prepare_difference(Rox_PatchPlane obj);
+
+//! Use the inverse compositional mode: the steepest descent images and the hessian are computed once on the reference
+//! \param  [out]  obj            The patch
+//! \param  [in ]  model          The motion model of the tracker
+//! \return An error code
+ROX_API Rox_ErrorCode rox_patchplane_set_inverse_compositional(Rox_PatchPlane obj, enum Rox_Linsys_Steepest_Descent_Model model);
+
+//! Update the steepest descent images after a change of the reference (nothing is done if the inverse compositional mode is not used)
+//! \param  [out]  obj            The patch
+//! \return An error code
+ROX_API Rox_ErrorCode rox_patchplane_update_inverse_compositional(Rox_PatchPlane obj);
+
 //! Compute zncc between reference and current buffers
 //! \param  [out]  score          Pointer to the result
 //! \param  [in ]  obj            The patch
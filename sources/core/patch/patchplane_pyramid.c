@@ -134,6 +134,29 @@ Rox_ErrorCode rox_patchplane_pyramid_apply(Rox_PatchPlane_Pyramid obj, Rox_Array
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
+   for (Rox_Uint i = 0; i < obj->count; i++)
+   {
+      error = rox_patchplane_update_inverse_compositional(obj->levels[i]);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_patchplane_pyramid_set_inverse_compositional(Rox_PatchPlane_Pyramid obj, enum Rox_Linsys_Steepest_Descent_Model model)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!obj) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for (Rox_Uint i = 0; i < obj->count; i++)
+   {
+      error = rox_patchplane_set_inverse_compositional(obj->levels[i], model);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
 function_terminate:
    return error;
 }
@@ -59,6 +59,12 @@ ROX_API Rox_ErrorCode rox_patchplane_pyramid_del(Rox_PatchPlane_Pyramid * patchp
 //! \todo   To be tested
 ROX_API Rox_ErrorCode rox_patchplane_pyramid_apply(Rox_PatchPlane_Pyramid patchplane_pyramid, Rox_Array2D_Float source, Rox_Imask mask);
 
+//! Use the inverse compositional mode on all the levels
+//! \param  [out] patchplane_pyramid         The patch object
+//! \param  [in]  model                      The motion model of the tracker
+//! \return An error code
+ROX_API Rox_ErrorCode rox_patchplane_pyramid_set_inverse_compositional(Rox_PatchPlane_Pyramid patchplane_pyramid, enum Rox_Linsys_Steepest_Descent_Model model);
+
 //! Reset luminosity model information
 //! \param  [out] patchplane_pyramid         The patch object
 //! \return An error code
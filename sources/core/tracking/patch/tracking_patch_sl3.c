@@ -130,11 +130,23 @@ Rox_ErrorCode rox_tracking_patch_sl3_make (
       error = rox_patchplane_prepare_sl3(patch, obj->homography, source); 
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      error = rox_patchplane_prepare_finish(patch);
-      ROX_ERROR_CHECK_TERMINATE ( error );
-
-      error = linsys_texture_matsl3_light_affine(obj->JtJ, obj->Jtf, patch->mean, patch->difference, patch->gx, patch->gy, patch->gradient_mask);
-      ROX_ERROR_CHECK_TERMINATE ( error );
+      if (patch->steepest)
+      {
+         // Inverse compositional: the jacobian and the hessian have been computed on the reference
+         error = rox_patchplane_prepare_difference(patch);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+
+         error = rox_linsys_steepest_descent_make(obj->JtJ, obj->Jtf, patch->steepest, patch->difference, patch->current_mask);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+      else
+      {
+         error = rox_patchplane_prepare_finish(patch);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+
+         error = linsys_texture_matsl3_light_affine(obj->JtJ, obj->Jtf, patch->mean, patch->difference, patch->gx, patch->gy, patch->gradient_mask);
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
 
       // Compute update to solution
       error = rox_array2d_double_svdinverse(obj->iJtJ, obj->JtJ);
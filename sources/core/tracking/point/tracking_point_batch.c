@@ -0,0 +1,529 @@
+//==============================================================================
+//
+//    OPENROX   : File tracking_point_batch.c
+//
+//    Contents  : Implementation of tracking_point_batch module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "tracking_point_batch.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include <system/memory/memory.h>
+#include <baseproc/geometry/point/point2d_struct.h>
+#include <baseproc/image/pyramid/pyramid_uchar_struct.h>
+
+#include <inout/system/errors_print.h>
+
+//=== INTERNAL MACROS    =======================================================
+
+#ifdef ROX_USES_OPENMP
+   #define ROX_TRACKING_POINT_BATCH_PARALLEL_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+   #define ROX_TRACKING_POINT_BATCH_PARALLEL_FOR
+#endif
+
+//! The maximal number of pixels of a patch with its border
+#define ROX_TRACKING_POINT_BATCH_MAX_PIXELS ((ROX_TRACKING_POINT_BATCH_MAX_SIZE + 2) * (ROX_TRACKING_POINT_BATCH_MAX_SIZE + 2))
+
+//! The number of iterations of the minimization at each level
+#define ROX_TRACKING_POINT_BATCH_ITERATIONS 8
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//! The batch of point trackers
+struct Rox_Tracking_Point_Batch_Struct
+{
+   //! The patch size without the border
+   Rox_Sint size;
+
+   //! The patch size with the border
+   Rox_Sint bigsize;
+
+   //! The number of pyramid levels
+   Rox_Sint nb_levels;
+
+   //! The maximal number of points
+   Rox_Sint max_points;
+
+   //! The number of points set
+   Rox_Sint count;
+
+   //! The distance between two pixels of the reference patches (max_points rounded to the lanes)
+   Rox_Sint stride;
+
+   //! The reference patches: for each level, for each pixel, the points
+   Rox_Float * references;
+
+   //! Whether the reference patch of a point exists: for each level, the points
+   Rox_Uchar * valid;
+
+   //! The luminosity offset of each point
+   Rox_Float * luminosity_beta;
+
+   //! The height of the levels of the current pyramid
+   Rox_Sint * level_rows;
+
+   //! The width of the levels of the current pyramid
+   Rox_Sint * level_cols;
+};
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Track a block of points from the coarsest level to the base level
+static void rox_tracking_point_batch_track_block (
+   Rox_Point2D_Double points,
+   Rox_ErrorCode * status,
+   Rox_Double * scores,
+   const Rox_Tracking_Point_Batch batch,
+   const Rox_Pyramid_Uchar current,
+   const Rox_Double minscore,
+   const Rox_Sint first
+)
+{
+   enum { L = ROX_TRACKING_POINT_BATCH_LANES };
+
+   // Current patch, difference to the reference and sum with the reference: for each pixel, the lanes
+   Rox_Float cur[ROX_TRACKING_POINT_BATCH_MAX_PIXELS * L];
+   Rox_Float diff[ROX_TRACKING_POINT_BATCH_MAX_PIXELS * L];
+   Rox_Float sum[ROX_TRACKING_POINT_BATCH_MAX_PIXELS * L];
+
+   // Normal equations of the lanes
+   Rox_Double a00[L], a01[L], a02[L], a11[L], a12[L], a22[L], b0[L], b1[L], b2[L];
+
+   // Position of the patch (top-left without the border), luminosity offset and state of the lanes
+   Rox_Double pos_u[L], pos_v[L], start_u[L], start_v[L];
+   Rox_Float beta[L], start_beta[L];
+   Rox_Sint active[L], failed[L];
+
+   const Rox_Sint bigsize = batch->bigsize;
+   const Rox_Sint pixels = bigsize * bigsize;
+   const Rox_Sint half = ( batch->size - 1 ) / 2;
+   const Rox_Sint top = batch->nb_levels - 1;
+
+   Rox_Sint lanes = batch->count - first;
+   if ( lanes > L ) lanes = L;
+
+   memset ( cur, 0, sizeof ( Rox_Float ) * pixels * L );
+   memset ( diff, 0, sizeof ( Rox_Float ) * pixels * L );
+   memset ( sum, 0, sizeof ( Rox_Float ) * pixels * L );
+
+   for ( Rox_Sint q = 0; q < lanes; q++ )
+   {
+      // Center of the pixel (u, v) at the coarsest level
+      Rox_Double cu = points[first + q].u, cv = points[first + q].v;
+      if ( top > 0 )
+      {
+         cu = ldexp ( cu + 0.5, -top ) - 0.5;
+         cv = ldexp ( cv + 0.5, -top ) - 0.5;
+      }
+
+      pos_u[q] = cu - half;
+      pos_v[q] = cv - half;
+      beta[q] = batch->luminosity_beta[first + q];
+      failed[q] = 0;
+   }
+
+   for ( Rox_Sint level = top; level >= 0; level-- )
+   {
+      Rox_Uchar ** ds = current->fast_access[level];
+      const Rox_Sint rows = batch->level_rows[level];
+      const Rox_Sint cols = batch->level_cols[level];
+      const Rox_Float * ref = batch->references + level * pixels * batch->stride + first;
+      const Rox_Uchar * valid = batch->valid + level * batch->stride + first;
+
+      for ( Rox_Sint q = 0; q < L; q++ )
+      {
+         active[q] = ( q < lanes ) && valid[q];
+         if ( q < lanes && !active[q] && level == 0 ) failed[q] = 1;
+         if ( q >= lanes ) continue;
+
+         start_u[q] = pos_u[q];
+         start_v[q] = pos_v[q];
+         start_beta[q] = beta[q];
+      }
+
+      for ( Rox_Sint iter = 0; iter < ROX_TRACKING_POINT_BATCH_ITERATIONS; iter++ )
+      {
+         Rox_Sint count_active = 0;
+
+         // Bilinear sampling of the patches, the gathers are scalar
+         for ( Rox_Sint q = 0; q < lanes; q++ )
+         {
+            if ( !active[q] ) continue;
+
+            const Rox_Double tx = pos_u[q] - 1;
+            const Rox_Double ty = pos_v[q] - 1;
+            const Rox_Sint itx = (Rox_Sint) tx;
+            const Rox_Sint ity = (Rox_Sint) ty;
+
+            if ( tx < 0 || ty < 0 || itx + bigsize >= cols - 1 || ity + bigsize >= rows - 1 )
+            {
+               active[q] = 0;
+               failed[q] = 1;
+               continue;
+            }
+
+            const Rox_Float dx = (Rox_Float) ( tx - (Rox_Float) itx );
+            const Rox_Float dy = (Rox_Float) ( ty - (Rox_Float) ity );
+            const Rox_Float w1 = (Rox_Float) ( ( 1.0 - dx ) * ( 1.0 - dy ) );
+            const Rox_Float w2 = (Rox_Float) ( dx * ( 1.0 - dy ) );
+            const Rox_Float w3 = (Rox_Float) ( ( 1.0 - dx ) * dy );
+            const Rox_Float w4 = dx * dy;
+
+            for ( Rox_Sint i = 0; i < bigsize; i++ )
+            {
+               const Rox_Uchar * r0 = ds[i + ity] + itx;
+               const Rox_Uchar * r1 = ds[i + ity + 1] + itx;
+
+               for ( Rox_Sint j = 0; j < bigsize; j++ )
+               {
+                  const Rox_Sint k = ( i * bigsize + j );
+                  const Rox_Float val = w1 * (Rox_Float) r0[j] + w2 * (Rox_Float) r0[j + 1] + w3 * (Rox_Float) r1[j] + w4 * (Rox_Float) r1[j + 1];
+                  const Rox_Float r = ref[k * batch->stride + q];
+
+                  diff[k * L + q] = r - val - beta[q];
+                  sum[k * L + q] = r + val;
+                  cur[k * L + q] = val;
+               }
+            }
+
+            count_active++;
+         }
+
+         if ( count_active == 0 ) break;
+
+         for ( Rox_Sint q = 0; q < L; q++ )
+         {
+            a00[q] = 0; a01[q] = 0; a02[q] = 0; a11[q] = 0; a12[q] = 0; a22[q] = 0;
+            b0[q] = 0; b1[q] = 0; b2[q] = 0;
+         }
+
+         // Normal equations of all the lanes at once
+         for ( Rox_Sint i = 1; i < bigsize - 1; i++ )
+         {
+            for ( Rox_Sint j = 1; j < bigsize - 1; j++ )
+            {
+               const Rox_Sint k = i * bigsize + j;
+               const Rox_Float * sl = sum + ( k - 1 ) * L;
+               const Rox_Float * sr = sum + ( k + 1 ) * L;
+               const Rox_Float * su = sum + ( k - bigsize ) * L;
+               const Rox_Float * sd = sum + ( k + bigsize ) * L;
+               const Rox_Float * dk = diff + k * L;
+
+               for ( Rox_Sint q = 0; q < L; q++ )
+               {
+                  const Rox_Float gx = 0.25f * ( sr[q] - sl[q] );
+                  const Rox_Float gy = 0.25f * ( sd[q] - su[q] );
+                  const Rox_Float d = dk[q];
+
+                  a00[q] += gx * gx;
+                  a01[q] += gx * gy;
+                  a02[q] += gx;
+                  a11[q] += gy * gy;
+                  a12[q] += gy;
+                  a22[q] += 1.0;
+                  b0[q] += gx * d;
+                  b1[q] += gy * d;
+                  b2[q] += d;
+               }
+            }
+         }
+
+         // Solve the symmetric 3x3 systems as rox_array2d_double_symm3x3_solve
+         for ( Rox_Sint q = 0; q < lanes; q++ )
+         {
+            if ( !active[q] ) continue;
+
+            const Rox_Double t1 = a12[q] * a12[q];
+            const Rox_Double t6 = a01[q] * a01[q];
+            const Rox_Double t7 = a02[q] * a02[q];
+            Rox_Double t8 = -t7 * a11[q] + 2.0 * a02[q] * a01[q] * a12[q] + ( -t6 + a00[q] * a11[q] ) * a22[q] - a00[q] * t1;
+
+            if ( fabs ( t8 ) < DBL_EPSILON )
+            {
+               active[q] = 0;
+               failed[q] = 1;
+               continue;
+            }
+
+            const Rox_Double t2 = b1[q] * a02[q];
+            const Rox_Double t3 = b2[q] * a01[q];
+            const Rox_Double t4 = b0[q] * a22[q];
+            const Rox_Double t5 = b1[q] * a22[q];
+            const Rox_Double t9 = b0[q] * a12[q];
+
+            t8 = 1.0 / t8;
+
+            const Rox_Double s0 = ( ( t4 - b2[q] * a02[q] ) * a11[q] - b0[q] * t1 + ( t2 + t3 ) * a12[q] - t5 * a01[q] ) * t8;
+            const Rox_Double s1 = - ( ( -t5 + b2[q] * a12[q] ) * a00[q] + b1[q] * t7 + ( -t9 - t3 ) * a02[q] + t4 * a01[q] ) * t8;
+            const Rox_Double s2 = ( ( -b1[q] * a12[q] + b2[q] * a11[q] ) * a00[q] - b2[q] * t6 + ( t9 + t2 ) * a01[q] - b0[q] * a02[q] * a11[q] ) * t8;
+
+            pos_u[q] += s0;
+            pos_v[q] += s1;
+            beta[q] += (Rox_Float) s2;
+
+            if ( s0 * s0 + s1 * s1 < 0.001 ) active[q] = 0;
+         }
+      }
+
+      if ( level == 0 ) break;
+
+      // A point lost at a coarse level restarts from its position before the level, then go to the finer level
+      for ( Rox_Sint q = 0; q < lanes; q++ )
+      {
+         if ( failed[q] )
+         {
+            pos_u[q] = start_u[q];
+            pos_v[q] = start_v[q];
+            beta[q] = start_beta[q];
+            failed[q] = 0;
+         }
+
+         pos_u[q] = 2.0 * ( pos_u[q] + half ) + 0.5 - half;
+         pos_v[q] = 2.0 * ( pos_v[q] + half ) + 0.5 - half;
+      }
+   }
+
+   // Score of the last sampled patches as rox_array2d_float_zncc_nomask_normalizedscore
+   const Rox_Float * ref = batch->references + first;
+   for ( Rox_Sint q = 0; q < lanes; q++ )
+   {
+      Rox_Double score = 0.0;
+
+      if ( !failed[q] )
+      {
+         Rox_Float sum1 = 0, sum2 = 0, sumsq1 = 0, sumsq2 = 0, gcc = 0;
+         for ( Rox_Sint k = 0; k < pixels; k++ )
+         {
+            const Rox_Float c = cur[k * L + q];
+            const Rox_Float r = ref[k * batch->stride + q];
+            sum1 += c;
+            sum2 += r;
+            sumsq1 += c * c;
+            sumsq2 += r * r;
+            gcc += c * r;
+         }
+
+         const Rox_Double mean1 = ( (Rox_Double) sum1 ) / ( (Rox_Double) pixels );
+         const Rox_Double mean2 = ( (Rox_Double) sum2 ) / ( (Rox_Double) pixels );
+         const Rox_Double nom = ( (Rox_Double) gcc ) - mean1 * mean2 * (Rox_Double) pixels;
+         const Rox_Double denom1 = (Rox_Double) sumsq1 - mean1 * mean1 * (Rox_Double) pixels;
+         const Rox_Double denom2 = (Rox_Double) sumsq2 - mean2 * mean2 * (Rox_Double) pixels;
+
+         if ( denom1 >= DBL_EPSILON && denom2 >= DBL_EPSILON )
+         {
+            score = ( 1.0 + nom / ( sqrt ( denom1 ) * sqrt ( denom2 ) ) ) * 0.5;
+         }
+
+         if ( score < minscore ) failed[q] = 1;
+      }
+
+      points[first + q].u = pos_u[q] + half;
+      points[first + q].v = pos_v[q] + half;
+      batch->luminosity_beta[first + q] = beta[q];
+      status[first + q] = failed[q] ? ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE : ROX_ERROR_NONE;
+      if ( scores ) scores[first + q] = score;
+   }
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+Rox_ErrorCode rox_tracking_point_batch_new (
+   Rox_Tracking_Point_Batch * batch,
+   const Rox_Sint size,
+   const Rox_Sint max_points,
+   const Rox_Sint nb_levels
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Tracking_Point_Batch ret = NULL;
+
+   if ( !batch )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *batch = NULL;
+
+   if ( size < 3 || size % 2 != 1 || size > ROX_TRACKING_POINT_BATCH_MAX_SIZE || max_points < 1 || nb_levels < 1 )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_Tracking_Point_Batch) rox_memory_allocate ( sizeof ( *ret ), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->size = size;
+   ret->bigsize = size + 2;
+   ret->nb_levels = nb_levels;
+   ret->max_points = max_points;
+   ret->count = 0;
+   ret->stride = ( ( max_points + ROX_TRACKING_POINT_BATCH_LANES - 1 ) / ROX_TRACKING_POINT_BATCH_LANES ) * ROX_TRACKING_POINT_BATCH_LANES;
+
+   ret->references = (Rox_Float *) rox_memory_allocate ( sizeof ( Rox_Float ), nb_levels * ret->bigsize * ret->bigsize * ret->stride );
+   ret->valid = (Rox_Uchar *) rox_memory_allocate ( sizeof ( Rox_Uchar ), nb_levels * ret->stride );
+   ret->luminosity_beta = (Rox_Float *) rox_memory_allocate ( sizeof ( Rox_Float ), ret->stride );
+   ret->level_rows = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), nb_levels );
+   ret->level_cols = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), nb_levels );
+
+   if ( !ret->references || !ret->valid || !ret->luminosity_beta || !ret->level_rows || !ret->level_cols )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // The padding points are never tracked
+   memset ( ret->references, 0, sizeof ( Rox_Float ) * nb_levels * ret->bigsize * ret->bigsize * ret->stride );
+   memset ( ret->valid, 0, sizeof ( Rox_Uchar ) * nb_levels * ret->stride );
+
+   *batch = ret;
+
+function_terminate:
+   if ( error ) rox_tracking_point_batch_del ( &ret );
+   return error;
+}
+
+Rox_ErrorCode rox_tracking_point_batch_del (
+   Rox_Tracking_Point_Batch * batch
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Tracking_Point_Batch todel = NULL;
+
+   if ( !batch )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *batch;
+   *batch = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_memory_delete ( todel->references );
+   rox_memory_delete ( todel->valid );
+   rox_memory_delete ( todel->luminosity_beta );
+   rox_memory_delete ( todel->level_rows );
+   rox_memory_delete ( todel->level_cols );
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_tracking_point_batch_set_reference (
+   Rox_Tracking_Point_Batch batch,
+   const Rox_Pyramid_Uchar reference,
+   const Rox_Point2D_Double points,
+   const Rox_Sint count
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !batch || !reference || !points )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( count < 0 || count > batch->max_points || (Rox_Sint) reference->nb_levels < batch->nb_levels )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   const Rox_Sint bigsize = batch->bigsize;
+   const Rox_Sint pixels = bigsize * bigsize;
+   const Rox_Sint half = ( batch->size - 1 ) / 2;
+
+   for ( Rox_Sint level = 0; level < batch->nb_levels; level++ )
+   {
+      Rox_Sint rows = 0, cols = 0;
+      error = rox_image_get_size ( &rows, &cols, reference->levels[level] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      Rox_Uchar ** ds = reference->fast_access[level];
+      Rox_Float * ref = batch->references + level * pixels * batch->stride;
+      Rox_Uchar * valid = batch->valid + level * batch->stride;
+
+      ROX_TRACKING_POINT_BATCH_PARALLEL_FOR
+      for ( Rox_Sint p = 0; p < count; p++ )
+      {
+         Rox_Double cu = points[p].u, cv = points[p].v;
+         if ( level > 0 )
+         {
+            cu = ldexp ( cu + 0.5, -level ) - 0.5;
+            cv = ldexp ( cv + 0.5, -level ) - 0.5;
+         }
+
+         // Top-left of the patch with its border, bilinear interpolation as rox_remap_bilinear_trans_uchar_to_float
+         const Rox_Float tx = (Rox_Float) ( cu - half - 1 );
+         const Rox_Float ty = (Rox_Float) ( cv - half - 1 );
+         const Rox_Sint itx = (Rox_Sint) tx;
+         const Rox_Sint ity = (Rox_Sint) ty;
+
+         valid[p] = ( tx >= 0 && ty >= 0 && itx + bigsize < cols && ity + bigsize < rows );
+         if ( !valid[p] ) continue;
+
+         const Rox_Float dx = tx - (Rox_Float) itx;
+         const Rox_Float dy = ty - (Rox_Float) ity;
+         const Rox_Float w1 = (Rox_Float) ( ( 1.0 - dx ) * ( 1.0 - dy ) );
+         const Rox_Float w2 = (Rox_Float) ( dx * ( 1.0 - dy ) );
+         const Rox_Float w3 = (Rox_Float) ( ( 1.0 - dx ) * dy );
+         const Rox_Float w4 = dx * dy;
+
+         for ( Rox_Sint i = 0; i < bigsize; i++ )
+         {
+            const Rox_Uchar * r0 = ds[i + ity] + itx;
+            const Rox_Uchar * r1 = ds[i + ity + 1] + itx;
+
+            for ( Rox_Sint j = 0; j < bigsize; j++ )
+            {
+               ref[( i * bigsize + j ) * batch->stride + p] = w1 * (Rox_Float) r0[j] + w2 * (Rox_Float) r0[j + 1] + w3 * (Rox_Float) r1[j] + w4 * (Rox_Float) r1[j + 1];
+            }
+         }
+      }
+
+      // Points removed since the previous reference are not tracked anymore
+      for ( Rox_Sint p = count; p < batch->count; p++ ) valid[p] = 0;
+   }
+
+   for ( Rox_Sint p = 0; p < count; p++ ) batch->luminosity_beta[p] = 0.0f;
+
+   batch->count = count;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_tracking_point_batch_track (
+   Rox_Point2D_Double points,
+   Rox_ErrorCode * status,
+   Rox_Double * scores,
+   Rox_Tracking_Point_Batch batch,
+   const Rox_Pyramid_Uchar current,
+   const Rox_Double minscore
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !points || !status || !batch || !current )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( (Rox_Sint) current->nb_levels < batch->nb_levels )
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Sint level = 0; level < batch->nb_levels; level++ )
+   {
+      error = rox_image_get_size ( &batch->level_rows[level], &batch->level_cols[level], current->levels[level] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   const Rox_Sint count_blocks = ( batch->count + ROX_TRACKING_POINT_BATCH_LANES - 1 ) / ROX_TRACKING_POINT_BATCH_LANES;
+
+   ROX_TRACKING_POINT_BATCH_PARALLEL_FOR
+   for ( Rox_Sint block = 0; block < count_blocks; block++ )
+   {
+      rox_tracking_point_batch_track_block ( points, status, scores, batch, current, minscore, block * ROX_TRACKING_POINT_BATCH_LANES );
+   }
+
+function_terminate:
+   return error;
+}
@@ -0,0 +1,91 @@
+//==============================================================================
+//
+//    OPENROX   : File tracking_point_batch.h
+//
+//    Contents  : API of tracking_point_batch module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_TRACKING_POINT_BATCH__
+#define __OPENROX_TRACKING_POINT_BATCH__
+
+#include <baseproc/geometry/point/point2d.h>
+#include <baseproc/image/pyramid/pyramid_uchar.h>
+
+//! \ingroup Tracking
+//! \addtogroup Point
+//! @{
+
+//! The number of points tracked together, the loops over the points of a block are vectorized
+#define ROX_TRACKING_POINT_BATCH_LANES 8
+
+//! The maximal patch size (without the border)
+#define ROX_TRACKING_POINT_BATCH_MAX_SIZE 15
+
+//! Pointer to the structure
+typedef struct Rox_Tracking_Point_Batch_Struct * Rox_Tracking_Point_Batch;
+
+//! Create a batch of point trackers sharing the same image pyramids.
+//! The reference patches of all the points and all the levels are stored in one buffer, pixel after pixel,
+//! with the points of a pixel contiguous. The blocks of ROX_TRACKING_POINT_BATCH_LANES points are tracked in parallel.
+//! \param  [out]  batch          The pointer to the newly created object
+//! \param  [in ]  size           The patch size without the border (odd, 9 and 11 as rox_tracking_point_9x9 and rox_tracking_point_11x11)
+//! \param  [in ]  max_points     The maximal number of points
+//! \param  [in ]  nb_levels      The number of pyramid levels used for the coarse to fine tracking
+//! \return An error code
+ROX_API Rox_ErrorCode rox_tracking_point_batch_new (
+   Rox_Tracking_Point_Batch * batch,
+   const Rox_Sint size,
+   const Rox_Sint max_points,
+   const Rox_Sint nb_levels
+);
+
+//! Delete a batch of point trackers
+//! \param  [out]  batch          The pointer to the object
+//! \return An error code
+ROX_API Rox_ErrorCode rox_tracking_point_batch_del (
+   Rox_Tracking_Point_Batch * batch
+);
+
+//! Set the reference patches of the points at all the levels
+//! \param  [out]  batch          The batch object
+//! \param  [in ]  reference      The pyramid of the reference image, with at least nb_levels levels
+//! \param  [in ]  points         The coordinates of the points (center of the patches) at the base level
+//! \param  [in ]  count          The number of points
+//! \return An error code
+ROX_API Rox_ErrorCode rox_tracking_point_batch_set_reference (
+   Rox_Tracking_Point_Batch batch,
+   const Rox_Pyramid_Uchar reference,
+   const Rox_Point2D_Double points,
+   const Rox_Sint count
+);
+
+//! Track all the points from coarse to fine.
+//! At each level, the translation and the luminosity offset of each point are estimated as rox_tracking_point_9x9_track.
+//! A point lost at a coarse level keeps its position of the previous level. At the base level, a point is lost when
+//! it leaves the image, the system is singular or the final score is below minscore.
+//! \param  [out]  points         The predicted coordinates of the points (center of the patches) as input, the tracked coordinates as output
+//! \param  [out]  status         The status of each point: ROX_ERROR_NONE if tracked, ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE if lost
+//! \param  [out]  scores         The normalized zncc score of each point in [0, 1], may be NULL
+//! \param  [in ]  batch          The batch object
+//! \param  [in ]  current        The pyramid of the current image, with at least nb_levels levels
+//! \param  [in ]  minscore       The minimum score after minimization
+//! \return An error code
+ROX_API Rox_ErrorCode rox_tracking_point_batch_track (
+   Rox_Point2D_Double points,
+   Rox_ErrorCode * status,
+   Rox_Double * scores,
+   Rox_Tracking_Point_Batch batch,
+   const Rox_Pyramid_Uchar current,
+   const Rox_Double minscore
+);
+
+//! @}
+
+#endif // __OPENROX_TRACKING_POINT_BATCH__
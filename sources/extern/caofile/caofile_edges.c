@@ -13,6 +13,7 @@
 //==============================================================================
 
 #include "caofile_edges.h"
+#include "caofile_visibility.h"
 
 #include <stdio.h>
 #include <ctype.h>
@@ -45,6 +46,7 @@
 
 //serialization needed
 #include <generated/dynvec_point3d_double_struct.h>
+#include <generated/dynvec_uint_struct.h>
 
 #include <generated/objset_dynvec_point3d_double_struct.h>
 #include <generated/objset_ellipse3d_struct.h>
@@ -132,6 +134,21 @@ struct Rox_CaoFile_Edges_Struct
 
    //! Results of visibility tests
    Rox_ObjSet_Cylinder3D              visible_cylinders;
+
+   //! Face hierarchy and cached visibility of the segments
+   Rox_CaoFile_Visibility             visibility;
+
+   //! 1 when visible_segments holds the last visibility result
+   Rox_Uint                           visible_segments_valid;
+
+   //! Indices of the visible ellipses, the copies are rebuilt only when they change
+   Rox_DynVec_Uint                    visible_ellipses_indices;
+
+   //! Indices of the visible cylinders, the copies are rebuilt only when they change
+   Rox_DynVec_Uint                    visible_cylinders_indices;
+
+   //! Indices computed by the current visibility test
+   Rox_DynVec_Uint                    indices;
 };
 
 #ifdef OPENROX_DISPLAY
@@ -210,6 +227,18 @@ Rox_ErrorCode rox_caofile_edges_new(Rox_CaoFile_Edges * caofile_edges)
    error = rox_objset_cylinder3d_new(&ret->visible_cylinders, 100);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_caofile_visibility_new(&ret->visibility);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->visible_ellipses_indices, 100);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->visible_cylinders_indices, 100);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new(&ret->indices, 100);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    *caofile_edges = ret;
 
 function_terminate:
@@ -253,6 +282,18 @@ Rox_ErrorCode rox_caofile_edges_del(Rox_CaoFile_Edges * caofile_edges)
    error = rox_dynvec_point3d_double_del(&todel->visible_segments);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_caofile_visibility_del(&todel->visibility);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_del(&todel->visible_ellipses_indices);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_del(&todel->visible_cylinders_indices);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_del(&todel->indices);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    rox_memory_delete(todel);
 
 function_terminate:
@@ -261,6 +302,36 @@ function_terminate:
 
 
 
+//!forwards the image size to the visibility tests
+Rox_ErrorCode rox_caofile_edges_set_image_size(Rox_CaoFile_Edges caofile_edges, const Rox_Sint cols, const Rox_Sint rows)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!caofile_edges)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_caofile_visibility_set_image_size(caofile_edges->visibility, cols, rows);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+//!forwards the pose change thresholds to the visibility tests
+Rox_ErrorCode rox_caofile_edges_set_visibility_coherence(Rox_CaoFile_Edges caofile_edges, const Rox_Double max_translation, const Rox_Double max_rotation)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!caofile_edges)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_caofile_visibility_set_coherence(caofile_edges->visibility, max_translation, max_rotation);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
 //!ignores cao file comments
 Rox_ErrorCode rox_cao_strip_comments(FILE * input)
 {
@@ -1347,12 +1418,9 @@ Rox_ErrorCode rox_caofile_edges_estimate_segments(Rox_CaoFile_Edges caofile_edge
       error = ROX_ERROR_NULL_POINTER; goto function_terminate;
    }
 
-   Rox_Uint nbr_polys = 0, each_poly = 0, nbr_segments = 0;
+   Rox_Uint nbr_polys = 0, nbr_built = 0, changed = 0, nbr_segments = 0, each_segment = 0;
    Rox_DynVec_Point3D_Double* poly_segments_data = NULL;
-
-   // Reset visible segments
-   error = rox_dynvec_point3d_double_reset(caofile_edges->visible_segments);
-   if (error) goto function_terminate;
+   const Rox_Uchar * visible = NULL;
 
    // get cao file read data
    error = rox_objset_dynvec_point3d_double_get_used(&nbr_polys, caofile_edges->poly_segments);
@@ -1361,144 +1429,49 @@ Rox_ErrorCode rox_caofile_edges_estimate_segments(Rox_CaoFile_Edges caofile_edge
    error  = rox_objset_dynvec_point3d_double_get_data_pointer ( &poly_segments_data, caofile_edges->poly_segments);
    if (error) goto function_terminate;
 
-   // go through all poly_lines and compute visibility from this pose/intrinsics parameters
-   for (each_poly = 0; each_poly < nbr_polys; ++each_poly)
-   {
-      Rox_Uint nbr_points = 0, each_point = 0;
-      error = rox_dynvec_point3d_double_get_used(&nbr_points, poly_segments_data[each_poly]);
-      if (error) goto function_terminate;
+   // The loaders only append polylines, the hierarchy is rebuilt when the model grew
+   error = rox_caofile_visibility_get_polylines_count(&nbr_built, caofile_edges->visibility);
+   if (error) goto function_terminate;
 
-      Rox_Point3D_Double_Struct * points_data = NULL;
-      error = rox_dynvec_point3d_double_get_data_pointer(&points_data, poly_segments_data[each_poly]);
+   if (nbr_built != nbr_polys)
+   {
+      error = rox_caofile_visibility_build(caofile_edges->visibility, caofile_edges->poly_segments);
       if (error) goto function_terminate;
+   }
 
-      //polylines with only two points are always visible
-      if (nbr_points == 2)
-      {
-         error = rox_dynvec_point3d_double_append(caofile_edges->visible_segments, &points_data[0]);
-         if (error) goto function_terminate;
-
-         error = rox_dynvec_point3d_double_append(caofile_edges->visible_segments, &points_data[1]);
-         if (error) goto function_terminate;
-      }
-      else //test for polylines made of multiple segments
-      {
-         Rox_Point3D_Double_Struct faceNormal = { 0.0, 0.0, 0.0 };
-         Rox_Point3D_Double_Struct currentVertex = { 0.0, 0.0, 0.0 }, nextVertex = { 0.0, 0.0, 0.0 };
-         Rox_Point3D_Double_Struct sum = { 0.0, 0.0, 0.0 };
-         Rox_Point3D_Double_Struct e4 = { 0.0, 0.0, 0.0 };
-         Rox_Double length = 0.0, dot = 0.0, angle = 0.0;
-
-         //transform each point in camera frame
-         Rox_DynVec_Point3D_Double points_transformed = NULL;
-         Rox_Point3D_Double_Struct* points_transformed_data = NULL;
-
-         error = rox_dynvec_point3d_double_new(&points_transformed, nbr_points);
-         if (error) { rox_dynvec_point3d_double_del(&points_transformed);  goto function_terminate; }
-
-         error = rox_dynvec_point3d_double_get_data_pointer(&points_transformed_data, points_transformed);
-
-         error = rox_point3d_double_transform(points_transformed_data, pose, points_data, nbr_points);
-         if (error) { rox_dynvec_point3d_double_del(&points_transformed);  goto function_terminate; }
-
-         //Check visibility from normal
-         //Newell's Method for calculating the normal of an arbitrary 3D polygon
-         //https://www.opengl.org/wiki/Calculating_a_Surface_Normal
-         for (each_point = 0; each_point < nbr_points; ++each_point)
-         {
-            // Sum it
-            sum.X = sum.X + points_transformed_data[each_point].X;
-            sum.Y = sum.Y + points_transformed_data[each_point].Y;
-            sum.Z = sum.Z + points_transformed_data[each_point].Z;
-
-            // Don't process last
-            if (each_point == nbr_points - 1)
-               continue;
-
-            //process face normal
-            currentVertex = points_transformed_data[each_point];
-            nextVertex = points_transformed_data[each_point + 1];
-
-            faceNormal.X += (currentVertex.Y - nextVertex.Y) * (currentVertex.Z + nextVertex.Z);
-            faceNormal.Y += (currentVertex.Z - nextVertex.Z) * (currentVertex.X + nextVertex.X);
-            faceNormal.Z += (currentVertex.X - nextVertex.X) * (currentVertex.Y + nextVertex.Y);
-         }
-
-         //not needed anymore
-         rox_dynvec_point3d_double_del(&points_transformed);
-
-         //normalize faceNormal
-         length = faceNormal.X*faceNormal.X + faceNormal.Y*faceNormal.Y + faceNormal.Z*faceNormal.Z;
-
-         if (length > 0)
-         {
-            length = sqrt(length);
-            faceNormal.X = faceNormal.X / length;
-            faceNormal.Y = faceNormal.Y / length;
-            faceNormal.Z = faceNormal.Z / length;
-         }
-         else
-         {
-            error = ROX_ERROR_INVALID_VALUE; goto function_terminate;
-         }
-
-         if (nbr_points == 0)
-         {
-            error = ROX_ERROR_BAD_SIZE; goto function_terminate;
-         }
-
-         e4.X = -sum.X / nbr_points;
-         e4.Y = -sum.Y / nbr_points;
-         e4.Z = -sum.Z / nbr_points;
+   // Culling, back-face and occlusion tests, skipped when the pose barely moved
+   error = rox_caofile_visibility_update(&changed, caofile_edges->visibility, pose, fu, fv, cu, cv);
+   if (error) goto function_terminate;
 
-         //normalize e4
-         length = e4.X*e4.X + e4.Y*e4.Y + e4.Z*e4.Z;
-         if (length > 0)
-         {
-            length = sqrt(length);
-            e4.X = e4.X / length;
-            e4.Y = e4.Y / length;
-            e4.Z = e4.Z / length;
-         }
-         else
-         {
-            error = ROX_ERROR_INVALID_VALUE; goto function_terminate;
-         }
+   if (!changed && caofile_edges->visible_segments_valid) goto function_terminate;
 
-         dot = e4.X*faceNormal.X + e4.Y*faceNormal.Y + e4.Z*faceNormal.Z;
-         angle = acos(dot);
+   error = rox_caofile_visibility_get_segments(&visible, &nbr_segments, caofile_edges->visibility);
+   if (error) goto function_terminate;
 
-         if (angle < ROX_PI / 2)
-         {
-            //std::vector<Segment3D<Rox_Double> > poly_seg;
-            //err = it->getSegments(poly_seg);
-            //if (err) return err;
+   // Reset visible segments
+   error = rox_dynvec_point3d_double_reset(caofile_edges->visible_segments);
+   if (error) goto function_terminate;
 
-            ////Add to results
-            //_visibility_results.push_back(std::make_pair(_pose, poly_seg));
+   for (Rox_Uint each_poly = 0; each_poly < nbr_polys; ++each_poly)
+   {
+      const Rox_Uint nbr_points = poly_segments_data[each_poly]->used;
+      Rox_Point3D_Double_Struct * points_data = poly_segments_data[each_poly]->data;
 
-            for (each_point = 0; each_point < nbr_points; ++each_point)
-            {
-               //don't process last
-               if (each_point == nbr_points - 1)
-                  continue;
-
-               error = rox_dynvec_point3d_double_append(caofile_edges->visible_segments, &points_data[each_point]);
-               if (error)goto function_terminate;
-               error = rox_dynvec_point3d_double_append(caofile_edges->visible_segments, &points_data[each_point + 1]);
-               if (error)goto function_terminate;
-            }
-         }
+      for (Rox_Uint each_point = 0; each_point + 1 < nbr_points; ++each_point, ++each_segment)
+      {
+         if (!visible[each_segment]) continue;
 
+         error = rox_dynvec_point3d_double_append(caofile_edges->visible_segments, &points_data[each_point]);
+         if (error) goto function_terminate;
+         error = rox_dynvec_point3d_double_append(caofile_edges->visible_segments, &points_data[each_point + 1]);
+         if (error) goto function_terminate;
       }
-
    }
 
-   // Dbg
-   error = rox_dynvec_point3d_double_get_used(&nbr_segments, caofile_edges->visible_segments);
-   if (error) goto function_terminate;
+   caofile_edges->visible_segments_valid = 1;
 
 function_terminate:
+   if (error && caofile_edges) caofile_edges->visible_segments_valid = 0;
    return error;
 }
 
@@ -1511,7 +1484,8 @@ Rox_ErrorCode rox_caofile_edges_estimate_all_segments(Rox_CaoFile_Edges caofile_
    Rox_Uint nbr_polys = 0, each_poly = 0, nbr_segments = 0;
    Rox_DynVec_Point3D_Double* poly_segments_data = NULL;
 
-   // Reset visible segments
+   // Reset visible segments, the next visibility test refills them
+   caofile_edges->visible_segments_valid = 0;
    error = rox_dynvec_point3d_double_reset(caofile_edges->visible_segments);
    if (error) goto function_terminate;
 
@@ -1565,17 +1539,59 @@ function_terminate:
    return error;
 }
 
+// Compare the visible indices of the current test with the ones of the copies, and keep the current ones
+static Rox_ErrorCode rox_caofile_edges_swap_indices(Rox_Uint * changed, Rox_DynVec_Uint visible_indices, Rox_DynVec_Uint indices)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   *changed = visible_indices->used != indices->used || memcmp(visible_indices->data, indices->data, indices->used * sizeof(Rox_Uint));
+   if (!*changed) goto function_terminate;
+
+   error = rox_dynvec_uint_reset(visible_indices);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint i = 0; i < indices->used; i++)
+   {
+      error = rox_dynvec_uint_append(visible_indices, &indices->data[i]);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   return error;
+}
+
+// Frustum test of the bounding sphere of a primitive centered on the origin of oTe
+static Rox_ErrorCode rox_caofile_edges_test_sphere(Rox_Uint * inside, Rox_CaoFile_Visibility visibility, Rox_Array2D_Double pose, Rox_MatSE3 oTe, Rox_Double radius, Rox_Double fu, Rox_Double fv, Rox_Double cu, Rox_Double cv)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** cTo = NULL, ** T = NULL;
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&cTo, pose);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&T, oTe);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double center[3];
+   for (Rox_Sint k = 0; k < 3; k++)
+   {
+      center[k] = cTo[k][0] * T[0][3] + cTo[k][1] * T[1][3] + cTo[k][2] * T[2][3] + cTo[k][3];
+   }
+
+   error = rox_caofile_visibility_test_sphere(inside, visibility, center, radius, fu, fv, cu, cv);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_caofile_edges_estimate_visible_ellipses(Rox_CaoFile_Edges caofile_edges, Rox_Array2D_Double pose, Rox_Double fu, Rox_Double fv, Rox_Double cu, Rox_Double cv, Rox_Uint minimal_segment_size)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    if (!caofile_edges || !pose)
    { error = ROX_ERROR_NULL_POINTER; goto function_terminate; }
 
-   Rox_Uint nbr_ellipses = 0;
-
-   // Reset visible ellipses
-   error = rox_objset_ellipse3d_reset(caofile_edges->visible_ellipses);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   Rox_Uint nbr_ellipses = 0, changed = 0;
 
    error = rox_objset_ellipse3d_get_used(&nbr_ellipses, caofile_edges->ellipses);
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -1584,25 +1600,52 @@ Rox_ErrorCode rox_caofile_edges_estimate_visible_ellipses(Rox_CaoFile_Edges caof
    error = rox_objset_ellipse3d_get_data_pointer(&ellipses, caofile_edges->ellipses);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Get cao file read data (without visibility test at the moment)
-   for(Rox_Uint i = 0; i<nbr_ellipses; i++)
+   // Frustum test of the bounding spheres (all the ellipses while the image size is unknown)
+   error = rox_dynvec_uint_reset(caofile_edges->indices);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint i = 0; i < nbr_ellipses; i++)
    {
-      Rox_Ellipse3D ellipse3d_toadd = NULL;
-      error = rox_ellipse3d_new(&ellipse3d_toadd);
+      Rox_Uint inside = 0;
+      error = rox_caofile_edges_test_sphere(&inside, caofile_edges->visibility, pose, ellipses[i]->Te, ROX_MAX(ellipses[i]->a, ellipses[i]->b), fu, fv, cu, cv);
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      error = rox_ellipse3d_copy(ellipse3d_toadd, ellipses[i]);
-      ROX_ERROR_CHECK_TERMINATE ( error );
+      if (!inside) continue;
 
-      error = rox_objset_ellipse3d_append(caofile_edges->visible_ellipses, ellipse3d_toadd);
+      error = rox_dynvec_uint_append(caofile_edges->indices, &i);
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
-   // Dbg
-   error = rox_objset_ellipse3d_get_used(&nbr_ellipses, caofile_edges->visible_ellipses);
+   // The copies are kept while the visible ellipses do not change
+   error = rox_caofile_edges_swap_indices(&changed, caofile_edges->visible_ellipses_indices, caofile_edges->indices);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   if (!changed && caofile_edges->visible_ellipses->used == caofile_edges->visible_ellipses_indices->used) goto function_terminate;
+
+   // Reset visible ellipses
+   error = rox_objset_ellipse3d_reset(caofile_edges->visible_ellipses);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for(Rox_Uint i = 0; i < caofile_edges->visible_ellipses_indices->used; i++)
+   {
+      Rox_Ellipse3D ellipse3d_toadd = NULL;
+      error = rox_ellipse3d_new(&ellipse3d_toadd);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_ellipse3d_copy(ellipse3d_toadd, ellipses[caofile_edges->visible_ellipses_indices->data[i]]);
+      if (error) { rox_ellipse3d_del(&ellipse3d_toadd); ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_objset_ellipse3d_append(caofile_edges->visible_ellipses, ellipse3d_toadd);
+      if (error) { rox_ellipse3d_del(&ellipse3d_toadd); ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
+
 function_terminate:
+   // Force a rebuild of the copies at the next call
+   if (error && caofile_edges)
+   {
+      rox_dynvec_uint_reset(caofile_edges->visible_ellipses_indices);
+      rox_objset_ellipse3d_reset(caofile_edges->visible_ellipses);
+   }
    return error;
 }
 
@@ -1613,11 +1656,7 @@ Rox_ErrorCode rox_caofile_edges_estimate_visible_cylinders(Rox_CaoFile_Edges cao
    if (!caofile_edges || !pose)
    { error = ROX_ERROR_NULL_POINTER; goto function_terminate; }
 
-   // Reset visible cylinders
-   error = rox_objset_cylinder3d_reset(caofile_edges->visible_cylinders);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
-   Rox_Uint nbr_cylinders = 0;
+   Rox_Uint nbr_cylinders = 0, changed = 0;
    error = rox_objset_cylinder3d_get_used(&nbr_cylinders, caofile_edges->cylinders);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -1625,25 +1664,55 @@ Rox_ErrorCode rox_caofile_edges_estimate_visible_cylinders(Rox_CaoFile_Edges cao
    error = rox_objset_cylinder3d_get_data_pointer (&cylinders, caofile_edges->cylinders);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Get cao file read data (without visibility test at the moment)
-   for(Rox_Uint i = 0; i<nbr_cylinders; i++)
+   // Frustum test of the bounding spheres (all the cylinders while the image size is unknown)
+   error = rox_dynvec_uint_reset(caofile_edges->indices);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for (Rox_Uint i = 0; i < nbr_cylinders; i++)
    {
-      Rox_Cylinder3D cylinder3d_toadd = NULL;
-      error = rox_cylinder3d_new(&cylinder3d_toadd);
-      ROX_ERROR_CHECK_TERMINATE ( error );
+      const Rox_Double radius = ROX_MAX(cylinders[i]->a, cylinders[i]->b);
+      Rox_Uint inside = 0;
 
-      error = rox_cylinder3d_copy(cylinder3d_toadd, cylinders[i]);
+      // The cylinder frame is at the middle of the axis
+      error = rox_caofile_edges_test_sphere(&inside, caofile_edges->visibility, pose, cylinders[i]->T, sqrt(radius * radius + 0.25 * cylinders[i]->h * cylinders[i]->h), fu, fv, cu, cv);
       ROX_ERROR_CHECK_TERMINATE ( error );
 
-      error = rox_objset_cylinder3d_append(caofile_edges->visible_cylinders, cylinder3d_toadd);
+      if (!inside) continue;
+
+      error = rox_dynvec_uint_append(caofile_edges->indices, &i);
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
-   // Dbg
-   error = rox_objset_cylinder3d_get_used(&nbr_cylinders, caofile_edges->visible_cylinders);
+   // The copies are kept while the visible cylinders do not change
+   error = rox_caofile_edges_swap_indices(&changed, caofile_edges->visible_cylinders_indices, caofile_edges->indices);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   if (!changed && caofile_edges->visible_cylinders->used == caofile_edges->visible_cylinders_indices->used) goto function_terminate;
+
+   // Reset visible cylinders
+   error = rox_objset_cylinder3d_reset(caofile_edges->visible_cylinders);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   for(Rox_Uint i = 0; i < caofile_edges->visible_cylinders_indices->used; i++)
+   {
+      Rox_Cylinder3D cylinder3d_toadd = NULL;
+      error = rox_cylinder3d_new(&cylinder3d_toadd);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_cylinder3d_copy(cylinder3d_toadd, cylinders[caofile_edges->visible_cylinders_indices->data[i]]);
+      if (error) { rox_cylinder3d_del(&cylinder3d_toadd); ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_objset_cylinder3d_append(caofile_edges->visible_cylinders, cylinder3d_toadd);
+      if (error) { rox_cylinder3d_del(&cylinder3d_toadd); ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
+
 function_terminate:
+   // Force a rebuild of the copies at the next call
+   if (error && caofile_edges)
+   {
+      rox_dynvec_uint_reset(caofile_edges->visible_cylinders_indices);
+      rox_objset_cylinder3d_reset(caofile_edges->visible_cylinders);
+   }
    return error;
 }
 
@@ -52,6 +52,21 @@ ROX_API Rox_ErrorCode rox_caofile_edges_load_cao(Rox_CaoFile_Edges obj, const Ro
 ROX_API Rox_ErrorCode rox_caofile_edges_load_cao_from_string(Rox_CaoFile_Edges obj, const Rox_Char * inline_model_string);
 
 
+//! Set the image size used by rox_caofile_edges_estimate_segments and the visible ellipses and cylinders.
+//! Once set, the primitives out of the view frustum are culled and the segments hidden by the front faces of the model are removed.
+//! \param [in,out] obj the caofile structure
+//! \param [in] cols the image width in pixels, 0 to disable the frustum and occlusion tests
+//! \param [in] rows the image height in pixels, 0 to disable the frustum and occlusion tests
+//! \return an error code
+ROX_API Rox_ErrorCode rox_caofile_edges_set_image_size(Rox_CaoFile_Edges obj, const Rox_Sint cols, const Rox_Sint rows);
+
+//! Set the pose change under which rox_caofile_edges_estimate_segments keeps the previous visible segments
+//! \param [in,out] obj the caofile structure
+//! \param [in] max_translation the maximal translation change in model units, 0 to always test
+//! \param [in] max_rotation the maximal rotation change in radians, 0 to always test
+//! \return an error code
+ROX_API Rox_ErrorCode rox_caofile_edges_set_visibility_coherence(Rox_CaoFile_Edges obj, const Rox_Double max_translation, const Rox_Double max_rotation);
+
 //!For debug purposes
 //!\param [in] obj the caofile structure
 //!\return an error code
@@ -0,0 +1,844 @@
+//==============================================================================
+//
+//    OPENROX   : File caofile_visibility.c
+//
+//    Contents  : Implementation of caofile_visibility module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "caofile_visibility.h"
+
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include <baseproc/geometry/point/point3d.h>
+#include <generated/dynvec_point3d_double_struct.h>
+#include <generated/objset_dynvec_point3d_double_struct.h>
+
+#include <system/memory/memory.h>
+#include <baseproc/maths/maths_macros.h>
+#include <inout/system/errors_print.h>
+
+//! The kinds of faces
+enum Rox_CaoFile_Visibility_Face_Kind
+{
+   //! A polyline of 2 points, visible when it is seen
+   Rox_CaoFile_Visibility_Face_Line = 0,
+
+   //! A closed polygon, back-face culled in the object frame and used as occluder
+   Rox_CaoFile_Visibility_Face_Closed = 1,
+
+   //! An open polyline, tested in the camera frame
+   Rox_CaoFile_Visibility_Face_Open = 2
+};
+
+//! A face of the model
+typedef struct Rox_CaoFile_Visibility_Face_Struct
+{
+   //! The points of the polyline in the object frame
+   Rox_Point3D_Double points;
+
+   //! The number of points
+   Rox_Uint nb_points;
+
+   //! The index of the first segment of the polyline
+   Rox_Uint first_segment;
+
+   //! The kind of face
+   Rox_Sint kind;
+
+   //! The mean of the points in the object frame
+   Rox_Double centroid[3];
+
+   //! The Newell normal in the object frame (not normalized)
+   Rox_Double normal[3];
+
+   //! The bounding box in the object frame
+   Rox_Double bmin[3], bmax[3];
+} Rox_CaoFile_Visibility_Face_Struct;
+
+//! A node of the bounding volume hierarchy
+typedef struct Rox_CaoFile_Visibility_Node_Struct
+{
+   //! The bounding box of the faces of the node in the object frame
+   Rox_Double bmin[3], bmax[3];
+
+   //! The first face of a leaf in the face order
+   Rox_Uint first;
+
+   //! The number of faces of a leaf, 0 for an inner node
+   Rox_Uint count;
+
+   //! The index of the first child of an inner node, the second child follows
+   Rox_Uint child;
+} Rox_CaoFile_Visibility_Node_Struct;
+
+//! Structure
+struct Rox_CaoFile_Visibility_Struct
+{
+   //! The faces, one per polyline
+   Rox_CaoFile_Visibility_Face_Struct * faces;
+
+   //! The number of faces
+   Rox_Uint nb_faces;
+
+   //! The face indices sorted by leaf
+   Rox_Uint * order;
+
+   //! The nodes of the hierarchy, the root first
+   Rox_CaoFile_Visibility_Node_Struct * nodes;
+
+   //! The number of nodes
+   Rox_Uint nb_nodes;
+
+   //! The faces kept by the culling of the current update
+   Rox_Uint * candidates;
+
+   //! The number of segments
+   Rox_Uint nb_segments;
+
+   //! The visibility of the segments
+   Rox_Uchar * flags;
+
+   //! The visibility of the segments at the previous update
+   Rox_Uchar * previous;
+
+   //! The image size, 0 when unknown
+   Rox_Sint cols, rows;
+
+   //! The subsampled depth buffer
+   Rox_Float * depth;
+
+   //! The size of the depth buffer
+   Rox_Sint depth_cols, depth_rows;
+
+   //! The coherence thresholds
+   Rox_Double max_translation, max_rotation;
+
+   //! 1 when the last result can be reused
+   Rox_Uint valid;
+
+   //! The pose of the last computed update, rotation rows then translation
+   Rox_Double last_R[3][3], last_t[3];
+
+   //! The intrinsics of the last computed update
+   Rox_Double last_K[4];
+};
+
+//! The relative depth tolerance of the occlusion test
+#define ROX_CAOFILE_VISIBILITY_DEPTH_TOLERANCE 0.01
+
+//! The maximal number of samples along a segment for the occlusion test
+#define ROX_CAOFILE_VISIBILITY_MAX_SAMPLES 256
+
+//! The maximal depth of the hierarchy traversal, median splits give less than 33 levels
+#define ROX_CAOFILE_VISIBILITY_STACK_SIZE 64
+
+#ifdef ROX_USES_OPENMP
+#define CAOFILE_VISIBILITY_PARALLEL_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+#define CAOFILE_VISIBILITY_PARALLEL_FOR
+#endif
+
+static void rox_caofile_visibility_free_model(Rox_CaoFile_Visibility visibility)
+{
+   rox_memory_delete(visibility->faces);
+   rox_memory_delete(visibility->order);
+   rox_memory_delete(visibility->nodes);
+   rox_memory_delete(visibility->candidates);
+   rox_memory_delete(visibility->flags);
+   rox_memory_delete(visibility->previous);
+
+   visibility->faces = NULL;
+   visibility->order = NULL;
+   visibility->nodes = NULL;
+   visibility->candidates = NULL;
+   visibility->flags = NULL;
+   visibility->previous = NULL;
+   visibility->nb_faces = 0;
+   visibility->nb_nodes = 0;
+   visibility->nb_segments = 0;
+   visibility->valid = 0;
+}
+
+// Partial sort of order[left..right] so that order[nth] has the median key along axis
+static void rox_caofile_visibility_select(Rox_Uint * order, const Rox_CaoFile_Visibility_Face_Struct * faces, Rox_Sint left, Rox_Sint right, const Rox_Sint nth, const Rox_Sint axis)
+{
+   while (right > left)
+   {
+      const Rox_Uint pivot_face = order[(left + right) / 2];
+      const Rox_Double pivot = faces[pivot_face].bmin[axis] + faces[pivot_face].bmax[axis];
+      Rox_Sint i = left, j = right;
+
+      while (i <= j)
+      {
+         while (faces[order[i]].bmin[axis] + faces[order[i]].bmax[axis] < pivot) i++;
+         while (faces[order[j]].bmin[axis] + faces[order[j]].bmax[axis] > pivot) j--;
+         if (i <= j)
+         {
+            const Rox_Uint tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+            i++;
+            j--;
+         }
+      }
+
+      if (nth <= j) right = j;
+      else if (nth >= i) left = i;
+      else break;
+   }
+}
+
+// Test a box against planes given in the same frame, returns 0 if the box is outside one plane
+static Rox_Uint rox_caofile_visibility_box_inside(const Rox_Double bmin[3], const Rox_Double bmax[3], Rox_Double planes[5][4])
+{
+   for (Rox_Sint k = 0; k < 5; k++)
+   {
+      const Rox_Double * p = planes[k];
+      const Rox_Double x = p[0] >= 0.0 ? bmax[0] : bmin[0];
+      const Rox_Double y = p[1] >= 0.0 ? bmax[1] : bmin[1];
+      const Rox_Double z = p[2] >= 0.0 ? bmax[2] : bmin[2];
+      if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0) return 0;
+   }
+   return 1;
+}
+
+// The normalized planes of the view frustum in the camera frame, a point is inside when all the planes give a positive value
+static void rox_caofile_visibility_frustum(Rox_Double planes[5][4], const Rox_Sint cols, const Rox_Sint rows, const Rox_Double fu, const Rox_Double fv, const Rox_Double cu, const Rox_Double cv)
+{
+   const Rox_Double raw[5][4] =
+   {
+      { 0.0, 0.0, 1.0, -ROX_CAOFILE_VISIBILITY_NEAR },
+      { fu, 0.0, cu, 0.0 },
+      { -fu, 0.0, cols - cu, 0.0 },
+      { 0.0, fv, cv, 0.0 },
+      { 0.0, -fv, rows - cv, 0.0 }
+   };
+
+   for (Rox_Sint k = 0; k < 5; k++)
+   {
+      const Rox_Double norm = sqrt(raw[k][0] * raw[k][0] + raw[k][1] * raw[k][1] + raw[k][2] * raw[k][2]);
+      for (Rox_Sint l = 0; l < 4; l++) planes[k][l] = raw[k][l] / norm;
+   }
+}
+
+// Rasterize a triangle of vertices (x, y, 1/Z) in the depth buffer
+static void rox_caofile_visibility_raster_triangle(Rox_Float * depth, const Rox_Sint cols, const Rox_Sint rows, const Rox_Double a[3], const Rox_Double b[3], const Rox_Double c[3])
+{
+   const Rox_Double area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+   if (fabs(area) < 1e-12) return;
+
+   Rox_Double xmin = ROX_MIN(a[0], ROX_MIN(b[0], c[0])), xmax = ROX_MAX(a[0], ROX_MAX(b[0], c[0]));
+   Rox_Double ymin = ROX_MIN(a[1], ROX_MIN(b[1], c[1])), ymax = ROX_MAX(a[1], ROX_MAX(b[1], c[1]));
+
+   // Clamp before the conversion, the vertices close to the near plane are far outside
+   xmin = ROX_MAX(xmin, 0.0); ymin = ROX_MAX(ymin, 0.0);
+   xmax = ROX_MIN(xmax, cols - 1.0); ymax = ROX_MIN(ymax, rows - 1.0);
+   if (xmin > xmax || ymin > ymax) return;
+
+   const Rox_Double inv_area = 1.0 / area;
+
+   for (Rox_Sint y = (Rox_Sint) ymin; y <= (Rox_Sint) ymax; y++)
+   {
+      const Rox_Double py = y + 0.5;
+      Rox_Float * row = depth + y * cols;
+
+      for (Rox_Sint x = (Rox_Sint) xmin; x <= (Rox_Sint) xmax; x++)
+      {
+         const Rox_Double px = x + 0.5;
+         const Rox_Double w0 = ((c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0])) * inv_area;
+         const Rox_Double w1 = ((a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0])) * inv_area;
+         const Rox_Double w2 = 1.0 - w0 - w1;
+         if (w0 < 0.0 || w1 < 0.0 || w2 < 0.0) continue;
+
+         const Rox_Double w = w0 * a[2] + w1 * b[2] + w2 * c[2];
+         if (w <= 0.0) continue;
+
+         const Rox_Float z = (Rox_Float) (1.0 / w);
+         if (z < row[x]) row[x] = z;
+      }
+   }
+}
+
+Rox_ErrorCode rox_caofile_visibility_new(Rox_CaoFile_Visibility * visibility)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CaoFile_Visibility ret = NULL;
+
+   if (!visibility)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *visibility = NULL;
+
+   ret = (Rox_CaoFile_Visibility) rox_memory_allocate(sizeof(*ret), 1);
+   if (!ret)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset(ret, 0, sizeof(*ret));
+
+   *visibility = ret;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_del(Rox_CaoFile_Visibility * visibility)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CaoFile_Visibility todel = NULL;
+
+   if (!visibility)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *visibility;
+   *visibility = NULL;
+
+   if (!todel)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_caofile_visibility_free_model(todel);
+   rox_memory_delete(todel->depth);
+   rox_memory_delete(todel);
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_build(Rox_CaoFile_Visibility visibility, const Rox_ObjSet_DynVec_Point3D_Double polylines)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!visibility || !polylines)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_caofile_visibility_free_model(visibility);
+
+   const Rox_Uint nb_faces = polylines->used;
+   const Rox_Uint capacity = nb_faces > 0 ? nb_faces : 1;
+
+   visibility->faces = (Rox_CaoFile_Visibility_Face_Struct *) rox_memory_allocate(sizeof(Rox_CaoFile_Visibility_Face_Struct), capacity);
+   visibility->order = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), capacity);
+   visibility->candidates = (Rox_Uint *) rox_memory_allocate(sizeof(Rox_Uint), capacity);
+   visibility->nodes = (Rox_CaoFile_Visibility_Node_Struct *) rox_memory_allocate(sizeof(Rox_CaoFile_Visibility_Node_Struct), 2 * capacity);
+   if (!visibility->faces || !visibility->order || !visibility->candidates || !visibility->nodes)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // Faces
+   Rox_Uint nb_segments = 0;
+   for (Rox_Uint f = 0; f < nb_faces; f++)
+   {
+      Rox_CaoFile_Visibility_Face_Struct * face = &visibility->faces[f];
+      const Rox_DynVec_Point3D_Double polyline = polylines->data[f];
+      const Rox_Point3D_Double points = polyline->data;
+      const Rox_Uint n = polyline->used;
+
+      memset(face, 0, sizeof(*face));
+      face->points = points;
+      face->nb_points = n;
+      face->first_segment = nb_segments;
+      nb_segments += n > 1 ? n - 1 : 0;
+
+      if (n == 2) face->kind = Rox_CaoFile_Visibility_Face_Line;
+      else if (n > 3 && points[0].X == points[n - 1].X && points[0].Y == points[n - 1].Y && points[0].Z == points[n - 1].Z) face->kind = Rox_CaoFile_Visibility_Face_Closed;
+      else face->kind = Rox_CaoFile_Visibility_Face_Open;
+
+      face->bmin[0] = face->bmin[1] = face->bmin[2] = DBL_MAX;
+      face->bmax[0] = face->bmax[1] = face->bmax[2] = -DBL_MAX;
+
+      for (Rox_Uint p = 0; p < n; p++)
+      {
+         const Rox_Double v[3] = { points[p].X, points[p].Y, points[p].Z };
+         for (Rox_Sint k = 0; k < 3; k++)
+         {
+            face->centroid[k] += v[k];
+            face->bmin[k] = ROX_MIN(face->bmin[k], v[k]);
+            face->bmax[k] = ROX_MAX(face->bmax[k], v[k]);
+         }
+
+         // Newell's method over the consecutive points, as the camera frame test
+         if (p + 1 < n)
+         {
+            const Rox_Point3D_Double_Struct * cur = &points[p], * next = &points[p + 1];
+            face->normal[0] += (cur->Y - next->Y) * (cur->Z + next->Z);
+            face->normal[1] += (cur->Z - next->Z) * (cur->X + next->X);
+            face->normal[2] += (cur->X - next->X) * (cur->Y + next->Y);
+         }
+      }
+
+      if (n > 0)
+      {
+         for (Rox_Sint k = 0; k < 3; k++) face->centroid[k] /= n;
+      }
+      else
+      {
+         for (Rox_Sint k = 0; k < 3; k++) face->bmin[k] = face->bmax[k] = 0.0;
+      }
+
+      visibility->order[f] = f;
+   }
+
+   visibility->nb_faces = nb_faces;
+   visibility->nb_segments = nb_segments;
+
+   visibility->flags = (Rox_Uchar *) rox_memory_allocate(sizeof(Rox_Uchar), nb_segments > 0 ? nb_segments : 1);
+   visibility->previous = (Rox_Uchar *) rox_memory_allocate(sizeof(Rox_Uchar), nb_segments > 0 ? nb_segments : 1);
+   if (!visibility->flags || !visibility->previous)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset(visibility->flags, 0, nb_segments);
+
+   if (nb_faces == 0) goto function_terminate;
+
+   // Hierarchy, the nodes are split in creation order so that no stack is needed
+   visibility->nodes[0].first = 0;
+   visibility->nodes[0].count = nb_faces;
+   visibility->nb_nodes = 1;
+
+   for (Rox_Uint k = 0; k < visibility->nb_nodes; k++)
+   {
+      Rox_CaoFile_Visibility_Node_Struct * node = &visibility->nodes[k];
+      Rox_Double cmin[3] = { DBL_MAX, DBL_MAX, DBL_MAX }, cmax[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+
+      for (Rox_Sint l = 0; l < 3; l++) { node->bmin[l] = DBL_MAX; node->bmax[l] = -DBL_MAX; }
+
+      for (Rox_Uint i = node->first; i < node->first + node->count; i++)
+      {
+         const Rox_CaoFile_Visibility_Face_Struct * face = &visibility->faces[visibility->order[i]];
+         for (Rox_Sint l = 0; l < 3; l++)
+         {
+            const Rox_Double center = face->bmin[l] + face->bmax[l];
+            node->bmin[l] = ROX_MIN(node->bmin[l], face->bmin[l]);
+            node->bmax[l] = ROX_MAX(node->bmax[l], face->bmax[l]);
+            cmin[l] = ROX_MIN(cmin[l], center);
+            cmax[l] = ROX_MAX(cmax[l], center);
+         }
+      }
+
+      if (node->count <= ROX_CAOFILE_VISIBILITY_LEAF_SIZE) continue;
+
+      // Median split along the longest extent of the face centers
+      Rox_Sint axis = 0;
+      if (cmax[1] - cmin[1] > cmax[axis] - cmin[axis]) axis = 1;
+      if (cmax[2] - cmin[2] > cmax[axis] - cmin[axis]) axis = 2;
+      if (cmax[axis] - cmin[axis] <= 0.0) continue;
+
+      const Rox_Uint first = node->first, count = node->count, half = count / 2;
+      rox_caofile_visibility_select(visibility->order, visibility->faces, first, first + count - 1, first + half, axis);
+
+      const Rox_Uint child = visibility->nb_nodes;
+      visibility->nodes[child].first = first;
+      visibility->nodes[child].count = half;
+      visibility->nodes[child + 1].first = first + half;
+      visibility->nodes[child + 1].count = count - half;
+      visibility->nb_nodes += 2;
+
+      node->count = 0;
+      node->child = child;
+   }
+
+function_terminate:
+   if (error && visibility) rox_caofile_visibility_free_model(visibility);
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_get_polylines_count(Rox_Uint * count, const Rox_CaoFile_Visibility visibility)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!count || !visibility)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *count = visibility->nb_faces;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_set_image_size(Rox_CaoFile_Visibility visibility, const Rox_Sint cols, const Rox_Sint rows)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!visibility)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (cols < 0 || rows < 0)
+   { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (cols == visibility->cols && rows == visibility->rows) goto function_terminate;
+
+   rox_memory_delete(visibility->depth);
+   visibility->depth = NULL;
+   visibility->depth_cols = 0;
+   visibility->depth_rows = 0;
+   visibility->cols = 0;
+   visibility->rows = 0;
+   visibility->valid = 0;
+
+   if (cols == 0 || rows == 0) goto function_terminate;
+
+   const Rox_Sint depth_cols = (cols + ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING - 1) / ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING;
+   const Rox_Sint depth_rows = (rows + ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING - 1) / ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING;
+
+   visibility->depth = (Rox_Float *) rox_memory_allocate(sizeof(Rox_Float), depth_cols * depth_rows);
+   if (!visibility->depth)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   visibility->depth_cols = depth_cols;
+   visibility->depth_rows = depth_rows;
+   visibility->cols = cols;
+   visibility->rows = rows;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_set_coherence(Rox_CaoFile_Visibility visibility, const Rox_Double max_translation, const Rox_Double max_rotation)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!visibility)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (max_translation < 0.0 || max_rotation < 0.0)
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   visibility->max_translation = max_translation;
+   visibility->max_rotation = max_rotation;
+
+function_terminate:
+   return error;
+}
+
+// Test the segments of a visible face against the depth buffer
+static void rox_caofile_visibility_test_face_segments(Rox_CaoFile_Visibility visibility, const Rox_CaoFile_Visibility_Face_Struct * face, Rox_Double R[3][3], const Rox_Double t[3], const Rox_Double K[4])
+{
+   const Rox_Double scale = 1.0 / ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING;
+   const Rox_Sint cols = visibility->depth_cols, rows = visibility->depth_rows;
+   const Rox_Float * depth = visibility->depth;
+
+   for (Rox_Uint s = 0; s + 1 < face->nb_points; s++)
+   {
+      const Rox_Point3D_Double_Struct * p[2] = { &face->points[s], &face->points[s + 1] };
+      Rox_Double a[3], b[3];
+      Rox_Uchar visible = 0;
+
+      for (Rox_Sint k = 0; k < 3; k++)
+      {
+         a[k] = R[k][0] * p[0]->X + R[k][1] * p[0]->Y + R[k][2] * p[0]->Z + t[k];
+         b[k] = R[k][0] * p[1]->X + R[k][1] * p[1]->Y + R[k][2] * p[1]->Z + t[k];
+      }
+
+      // Clip against the near plane
+      if (a[2] < ROX_CAOFILE_VISIBILITY_NEAR && b[2] < ROX_CAOFILE_VISIBILITY_NEAR)
+      {
+         visibility->flags[face->first_segment + s] = 0;
+         continue;
+      }
+
+      if (a[2] < ROX_CAOFILE_VISIBILITY_NEAR || b[2] < ROX_CAOFILE_VISIBILITY_NEAR)
+      {
+         Rox_Double * behind = a[2] < ROX_CAOFILE_VISIBILITY_NEAR ? a : b;
+         const Rox_Double * front = a[2] < ROX_CAOFILE_VISIBILITY_NEAR ? b : a;
+         const Rox_Double lambda = (front[2] - ROX_CAOFILE_VISIBILITY_NEAR) / (front[2] - behind[2]);
+         for (Rox_Sint k = 0; k < 3; k++) behind[k] = front[k] + lambda * (behind[k] - front[k]);
+      }
+
+      // One sample per depth pixel along the projected segment
+      const Rox_Double ua = (K[0] * a[0] / a[2] + K[2]) * scale, va = (K[1] * a[1] / a[2] + K[3]) * scale;
+      const Rox_Double ub = (K[0] * b[0] / b[2] + K[2]) * scale, vb = (K[1] * b[1] / b[2] + K[3]) * scale;
+      const Rox_Double length = sqrt((ub - ua) * (ub - ua) + (vb - va) * (vb - va));
+      const Rox_Sint nb_samples = (Rox_Sint) ROX_MIN(length + 2.0, (Rox_Double) ROX_CAOFILE_VISIBILITY_MAX_SAMPLES);
+
+      for (Rox_Sint k = 0; k < nb_samples && !visible; k++)
+      {
+         const Rox_Double lambda = (k + 0.5) / nb_samples;
+         const Rox_Double X = a[0] + lambda * (b[0] - a[0]);
+         const Rox_Double Y = a[1] + lambda * (b[1] - a[1]);
+         const Rox_Double Z = a[2] + lambda * (b[2] - a[2]);
+         const Rox_Double u = (K[0] * X / Z + K[2]) * scale;
+         const Rox_Double v = (K[1] * Y / Z + K[3]) * scale;
+         if (u < 0.0 || v < 0.0 || u >= cols || v >= rows) continue;
+
+         const Rox_Sint x = (Rox_Sint) u, y = (Rox_Sint) v;
+         const Rox_Float limit = (Rox_Float) (Z / (1.0 + ROX_CAOFILE_VISIBILITY_DEPTH_TOLERANCE));
+
+         // The edges lie on the border of their own faces, a neighbour in front is enough
+         for (Rox_Sint i = ROX_MAX(y - 1, 0); i <= ROX_MIN(y + 1, rows - 1) && !visible; i++)
+         {
+            for (Rox_Sint j = ROX_MAX(x - 1, 0); j <= ROX_MIN(x + 1, cols - 1); j++)
+            {
+               if (depth[i * cols + j] >= limit) { visible = 1; break; }
+            }
+         }
+      }
+
+      visibility->flags[face->first_segment + s] = visible;
+   }
+}
+
+Rox_ErrorCode rox_caofile_visibility_update(Rox_Uint * changed, Rox_CaoFile_Visibility visibility, const Rox_Array2D_Double pose, const Rox_Double fu, const Rox_Double fv, const Rox_Double cu, const Rox_Double cv)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double ** T = NULL;
+
+   if (!changed || !visibility || !pose)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *changed = 0;
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&T, pose);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   Rox_Double R[3][3] = { { T[0][0], T[0][1], T[0][2] }, { T[1][0], T[1][1], T[1][2] }, { T[2][0], T[2][1], T[2][2] } };
+   const Rox_Double t[3] = { T[0][3], T[1][3], T[2][3] };
+   const Rox_Double K[4] = { fu, fv, cu, cv };
+
+   // Keep the previous result for a small pose change
+   if (visibility->valid && (visibility->max_translation > 0.0 || visibility->max_rotation > 0.0) && !memcmp(K, visibility->last_K, sizeof(K)))
+   {
+      Rox_Double trace = 0.0, dt = 0.0;
+      for (Rox_Sint i = 0; i < 3; i++)
+      {
+         for (Rox_Sint j = 0; j < 3; j++) trace += visibility->last_R[i][j] * R[i][j];
+         dt += (t[i] - visibility->last_t[i]) * (t[i] - visibility->last_t[i]);
+      }
+
+      const Rox_Double cosangle = ROX_MAX(-1.0, ROX_MIN(1.0, 0.5 * (trace - 1.0)));
+      if (sqrt(dt) <= visibility->max_translation && acos(cosangle) <= visibility->max_rotation) goto function_terminate;
+   }
+
+   // The previous flags are kept to report the changes
+   Rox_Uchar * swap = visibility->previous;
+   visibility->previous = visibility->flags;
+   visibility->flags = swap;
+   memset(visibility->flags, 0, visibility->nb_segments);
+
+   // The camera center in the object frame
+   const Rox_Double C[3] =
+   {
+      -(R[0][0] * t[0] + R[1][0] * t[1] + R[2][0] * t[2]),
+      -(R[0][1] * t[0] + R[1][1] * t[1] + R[2][1] * t[2]),
+      -(R[0][2] * t[0] + R[1][2] * t[1] + R[2][2] * t[2])
+   };
+
+   // Frustum culling through the hierarchy, with the planes moved to the object frame
+   const Rox_Uint use_frustum = visibility->cols > 0 && visibility->rows > 0;
+   Rox_Uint nb_candidates = 0;
+
+   if (use_frustum && visibility->nb_nodes > 0)
+   {
+      Rox_Double planes[5][4], object_planes[5][4];
+      Rox_Uint stack[ROX_CAOFILE_VISIBILITY_STACK_SIZE];
+      Rox_Sint top = 0;
+
+      rox_caofile_visibility_frustum(planes, visibility->cols, visibility->rows, fu, fv, cu, cv);
+      for (Rox_Sint k = 0; k < 5; k++)
+      {
+         for (Rox_Sint l = 0; l < 3; l++) object_planes[k][l] = R[0][l] * planes[k][0] + R[1][l] * planes[k][1] + R[2][l] * planes[k][2];
+         object_planes[k][3] = planes[k][0] * t[0] + planes[k][1] * t[1] + planes[k][2] * t[2] + planes[k][3];
+      }
+
+      stack[top++] = 0;
+      while (top > 0)
+      {
+         const Rox_CaoFile_Visibility_Node_Struct * node = &visibility->nodes[stack[--top]];
+         if (!rox_caofile_visibility_box_inside(node->bmin, node->bmax, object_planes)) continue;
+
+         if (node->count == 0)
+         {
+            stack[top++] = node->child;
+            stack[top++] = node->child + 1;
+            continue;
+         }
+
+         for (Rox_Uint i = node->first; i < node->first + node->count; i++)
+         {
+            const Rox_Uint f = visibility->order[i];
+            if (rox_caofile_visibility_box_inside(visibility->faces[f].bmin, visibility->faces[f].bmax, object_planes)) visibility->candidates[nb_candidates++] = f;
+         }
+      }
+   }
+   else if (!use_frustum)
+   {
+      for (Rox_Uint f = 0; f < visibility->nb_faces; f++) visibility->candidates[nb_candidates++] = f;
+   }
+
+   // Back-face culling, the front faces are compacted at the beginning of the candidates
+   Rox_Uint nb_front = 0;
+   for (Rox_Uint c = 0; c < nb_candidates; c++)
+   {
+      const Rox_CaoFile_Visibility_Face_Struct * face = &visibility->faces[visibility->candidates[c]];
+      Rox_Double normal[3], view[3];
+
+      if (face->nb_points < 2) continue;
+
+      if (face->kind == Rox_CaoFile_Visibility_Face_Line)
+      {
+         visibility->candidates[nb_front++] = visibility->candidates[c];
+         continue;
+      }
+
+      if (face->kind == Rox_CaoFile_Visibility_Face_Closed)
+      {
+         // The Newell normal of a closed polygon is transformed as a vector, the test is done in the object frame
+         for (Rox_Sint k = 0; k < 3; k++)
+         {
+            normal[k] = face->normal[k];
+            view[k] = C[k] - face->centroid[k];
+         }
+      }
+      else
+      {
+         Rox_Double previous[3] = { 0.0, 0.0, 0.0 }, sum[3] = { 0.0, 0.0, 0.0 };
+         normal[0] = normal[1] = normal[2] = 0.0;
+
+         for (Rox_Uint p = 0; p < face->nb_points; p++)
+         {
+            const Rox_Point3D_Double_Struct * point = &face->points[p];
+            Rox_Double current[3];
+            for (Rox_Sint k = 0; k < 3; k++)
+            {
+               current[k] = R[k][0] * point->X + R[k][1] * point->Y + R[k][2] * point->Z + t[k];
+               sum[k] += current[k];
+            }
+
+            if (p > 0)
+            {
+               normal[0] += (previous[1] - current[1]) * (previous[2] + current[2]);
+               normal[1] += (previous[2] - current[2]) * (previous[0] + current[0]);
+               normal[2] += (previous[0] - current[0]) * (previous[1] + current[1]);
+            }
+
+            previous[0] = current[0]; previous[1] = current[1]; previous[2] = current[2];
+         }
+
+         for (Rox_Sint k = 0; k < 3; k++) view[k] = -sum[k] / face->nb_points;
+      }
+
+      if (normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] <= 0.0)
+      { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      if (view[0] * view[0] + view[1] * view[1] + view[2] * view[2] <= 0.0)
+      { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      if (normal[0] * view[0] + normal[1] * view[1] + normal[2] * view[2] > 0.0)
+      {
+         visibility->candidates[nb_front++] = visibility->candidates[c];
+      }
+   }
+
+   if (use_frustum)
+   {
+      // Depth buffer of the front closed polygons fully in front of the near plane
+      const Rox_Double scale = 1.0 / ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING;
+      const Rox_Sint size = visibility->depth_cols * visibility->depth_rows;
+      for (Rox_Sint i = 0; i < size; i++) visibility->depth[i] = FLT_MAX;
+
+      for (Rox_Uint c = 0; c < nb_front; c++)
+      {
+         const Rox_CaoFile_Visibility_Face_Struct * face = &visibility->faces[visibility->candidates[c]];
+         if (face->kind != Rox_CaoFile_Visibility_Face_Closed) continue;
+
+         Rox_Uint in_front = 1;
+         for (Rox_Uint p = 0; p + 1 < face->nb_points && in_front; p++)
+         {
+            const Rox_Point3D_Double_Struct * point = &face->points[p];
+            in_front = R[2][0] * point->X + R[2][1] * point->Y + R[2][2] * point->Z + t[2] >= ROX_CAOFILE_VISIBILITY_NEAR;
+         }
+         if (!in_front) continue;
+
+         Rox_Double first[3] = { 0.0, 0.0, 0.0 }, previous[3] = { 0.0, 0.0, 0.0 }, current[3];
+         for (Rox_Uint p = 0; p + 1 < face->nb_points; p++)
+         {
+            const Rox_Point3D_Double_Struct * point = &face->points[p];
+            const Rox_Double X = R[0][0] * point->X + R[0][1] * point->Y + R[0][2] * point->Z + t[0];
+            const Rox_Double Y = R[1][0] * point->X + R[1][1] * point->Y + R[1][2] * point->Z + t[1];
+            const Rox_Double Z = R[2][0] * point->X + R[2][1] * point->Y + R[2][2] * point->Z + t[2];
+
+            current[0] = (fu * X / Z + cu) * scale;
+            current[1] = (fv * Y / Z + cv) * scale;
+            current[2] = 1.0 / Z;
+
+            // Fan triangulation from the first point
+            if (p == 0) { first[0] = current[0]; first[1] = current[1]; first[2] = current[2]; }
+            else if (p > 1) rox_caofile_visibility_raster_triangle(visibility->depth, visibility->depth_cols, visibility->depth_rows, first, previous, current);
+
+            previous[0] = current[0]; previous[1] = current[1]; previous[2] = current[2];
+         }
+      }
+
+      // Occlusion test of the segments of the front faces
+      CAOFILE_VISIBILITY_PARALLEL_FOR
+      for (Rox_Sint c = 0; c < (Rox_Sint) nb_front; c++)
+      {
+         rox_caofile_visibility_test_face_segments(visibility, &visibility->faces[visibility->candidates[c]], R, t, K);
+      }
+   }
+   else
+   {
+      for (Rox_Uint c = 0; c < nb_front; c++)
+      {
+         const Rox_CaoFile_Visibility_Face_Struct * face = &visibility->faces[visibility->candidates[c]];
+         memset(visibility->flags + face->first_segment, 1, face->nb_points - 1);
+      }
+   }
+
+   *changed = !visibility->valid || memcmp(visibility->flags, visibility->previous, visibility->nb_segments) != 0;
+
+   memcpy(visibility->last_R, R, sizeof(R));
+   memcpy(visibility->last_t, t, sizeof(t));
+   memcpy(visibility->last_K, K, sizeof(K));
+   visibility->valid = 1;
+
+function_terminate:
+   // A failed update leaves no result to reuse
+   if (error && visibility) visibility->valid = 0;
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_get_segments(const Rox_Uchar ** flags, Rox_Uint * count, const Rox_CaoFile_Visibility visibility)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!flags || !count || !visibility)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *flags = visibility->flags;
+   *count = visibility->nb_segments;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_caofile_visibility_test_sphere(Rox_Uint * inside, const Rox_CaoFile_Visibility visibility, const Rox_Double center[3], const Rox_Double radius, const Rox_Double fu, const Rox_Double fv, const Rox_Double cu, const Rox_Double cv)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double planes[5][4];
+
+   if (!inside || !visibility || !center)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *inside = 1;
+   if (visibility->cols == 0 || visibility->rows == 0) goto function_terminate;
+
+   rox_caofile_visibility_frustum(planes, visibility->cols, visibility->rows, fu, fv, cu, cv);
+   for (Rox_Sint k = 0; k < 5; k++)
+   {
+      if (planes[k][0] * center[0] + planes[k][1] * center[1] + planes[k][2] * center[2] + planes[k][3] < -radius)
+      {
+         *inside = 0;
+         break;
+      }
+   }
+
+function_terminate:
+   return error;
+}
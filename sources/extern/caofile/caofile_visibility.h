@@ -0,0 +1,108 @@
+//==============================================================================
+//
+//    OPENROX   : File caofile_visibility.h
+//
+//  	Contents  : API of caofile_visibility module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license S.A.S.
+//
+//==============================================================================
+
+#ifndef __OPENROX_CAOFILE_VISIBILITY__
+#define __OPENROX_CAOFILE_VISIBILITY__
+
+#include <generated/array2d_double.h>
+#include <generated/objset_dynvec_point3d_double.h>
+
+#include <system/memory/datatypes.h>
+
+//!\addtogroup 3dfile
+//!@{
+
+//! The maximal number of faces in a leaf of the bounding volume hierarchy
+#define ROX_CAOFILE_VISIBILITY_LEAF_SIZE 4
+
+//! The depth buffer of the occlusion test is subsampled by this factor with respect to the image
+#define ROX_CAOFILE_VISIBILITY_DEPTH_SUBSAMPLING 4
+
+//! The distance of the near clipping plane to the camera, in model units
+#define ROX_CAOFILE_VISIBILITY_NEAR 1e-3
+
+typedef struct Rox_CaoFile_Visibility_Struct * Rox_CaoFile_Visibility;
+
+//! Create a new visibility structure
+//! \param  [out]  visibility     The new object
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_new(Rox_CaoFile_Visibility * visibility);
+
+//! Delete a visibility structure
+//! \param  [out]  visibility     The object to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_del(Rox_CaoFile_Visibility * visibility);
+
+//! Build the faces and the bounding volume hierarchy of a model.
+//! Each polyline gives one face: 2 points are a line (always visible), a polyline whose last point is the first one
+//! is a closed polygon (back-face culled and occluder), any other polyline is tested as rox_caofile_edges_estimate_segments did.
+//! The segments are numbered polyline after polyline, a polyline of n points having n - 1 segments.
+//! \param  [out]  visibility     The visibility structure
+//! \param  [in ]  polylines      The polylines of the model in the object frame
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_build(Rox_CaoFile_Visibility visibility, const Rox_ObjSet_DynVec_Point3D_Double polylines);
+
+//! Get the number of polylines of the last build
+//! \param  [out]  count          The number of polylines
+//! \param  [in ]  visibility     The visibility structure
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_get_polylines_count(Rox_Uint * count, const Rox_CaoFile_Visibility visibility);
+
+//! Set the image size. The frustum culling and the occlusion test are disabled while the size is zero (default).
+//! \param  [out]  visibility     The visibility structure
+//! \param  [in ]  cols           The image width in pixels
+//! \param  [in ]  rows           The image height in pixels
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_set_image_size(Rox_CaoFile_Visibility visibility, const Rox_Sint cols, const Rox_Sint rows);
+
+//! Set the pose change under which the previous result is kept without any test. Zero thresholds (default) disable the reuse.
+//! \param  [out]  visibility     The visibility structure
+//! \param  [in ]  max_translation The maximal translation change, in model units
+//! \param  [in ]  max_rotation   The maximal rotation change, in radians
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_set_coherence(Rox_CaoFile_Visibility visibility, const Rox_Double max_translation, const Rox_Double max_rotation);
+
+//! Update the visibility of the segments for a pose
+//! \param  [out]  changed        1 if the visible segments differ from the previous update, 0 otherwise
+//! \param  [out]  visibility     The visibility structure
+//! \param  [in ]  pose           The pose of the object in the camera frame (cTo)
+//! \param  [in ]  fu             The focal length in pixels
+//! \param  [in ]  fv             The focal length in pixels
+//! \param  [in ]  cu             The offaxis u parameters
+//! \param  [in ]  cv             The offaxis v parameters
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_update(Rox_Uint * changed, Rox_CaoFile_Visibility visibility, const Rox_Array2D_Double pose, const Rox_Double fu, const Rox_Double fv, const Rox_Double cu, const Rox_Double cv);
+
+//! Get the visibility flags of the segments computed by the last update
+//! \param  [out]  flags          The pointer to the flags, 1 for a visible segment
+//! \param  [out]  count          The number of segments
+//! \param  [in ]  visibility     The visibility structure
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_get_segments(const Rox_Uchar ** flags, Rox_Uint * count, const Rox_CaoFile_Visibility visibility);
+
+//! Test if a sphere intersects the view frustum. Always true while the image size is zero.
+//! \param  [out]  inside         1 if the sphere may be seen, 0 otherwise
+//! \param  [in ]  visibility     The visibility structure
+//! \param  [in ]  center         The center of the sphere in the camera frame
+//! \param  [in ]  radius         The radius of the sphere
+//! \param  [in ]  fu             The focal length in pixels
+//! \param  [in ]  fv             The focal length in pixels
+//! \param  [in ]  cu             The offaxis u parameters
+//! \param  [in ]  cv             The offaxis v parameters
+//! \return An error code
+ROX_API Rox_ErrorCode rox_caofile_visibility_test_sphere(Rox_Uint * inside, const Rox_CaoFile_Visibility visibility, const Rox_Double center[3], const Rox_Double radius, const Rox_Double fu, const Rox_Double fv, const Rox_Double cu, const Rox_Double cv);
+
+//! @}
+
+#endif //__OPENROX_CAOFILE_VISIBILITY__
@@ -20,6 +20,7 @@
 #include <inout/numeric/array2d_serialize.h>
 #include <inout/numeric/objset_dynvec_serialize.h>
 #include <inout/numeric/dynvec_serialize.h>
+#include <generated/dynvec_sint_struct.h>
 #include <inout/features/edge_serialize.h>
 #include <inout/system/errors_print.h>
 
@@ -162,10 +163,19 @@ Rox_ErrorCode rox_fpsm_index_serialize(FILE* out, Rox_Fpsm_Index input)
    if(!write_res) {error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE(error)}
 
    //write struct data
-   error = rox_objset_dynvec_fpsm_template_serialize(out, input->index);
+   error = rox_objset_dynvec_sint_serialize(out, input->postings);
    ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_objset_dynvec_sint_serialize(out, input->counters);
+
+   error = rox_dynvec_fpsm_template_serialize(out, input->views);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_sint_serialize(out, input->signatures);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_sint_serialize(out, input->free_slots);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_sint_serialize(out, input->object_views);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    error = rox_dynvec_fpsm_template_serialize(out, input->results);
@@ -218,16 +228,51 @@ Rox_ErrorCode rox_fpsm_index_deserialize(Rox_Fpsm_Index output, FILE* in)
    read_res = (Rox_Sint) fread(&output->maxdist, sizeof(Rox_Double), 1, in);
    if(!read_res) {error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE(error)}
 
-   //read struct data
-   error = rox_objset_dynvec_fpsm_template_deserialize(output->index, in);
+   //read struct data, the search buffers are rebuilt empty
+   rox_objset_dynvec_sint_reset(output->postings);
+   rox_dynvec_fpsm_template_reset(output->views);
+   rox_dynvec_sint_reset(output->signatures);
+   rox_dynvec_sint_reset(output->free_slots);
+   rox_dynvec_sint_reset(output->object_views);
+   rox_dynvec_sint_reset(output->votes);
+   rox_dynvec_sint_reset(output->object_votes);
+   rox_dynvec_sint_reset(output->object_best);
+   rox_dynvec_fpsm_template_reset(output->results);
+
+   error = rox_objset_dynvec_sint_deserialize(output->postings, in);
    ROX_ERROR_CHECK_TERMINATE ( error );
-   
-   error = rox_objset_dynvec_sint_deserialize(output->counters, in);
+
+   error = rox_dynvec_fpsm_template_deserialize(output->views, in);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_sint_deserialize(output->signatures, in);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_sint_deserialize(output->free_slots, in);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_sint_deserialize(output->object_views, in);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    error = rox_dynvec_fpsm_template_deserialize(output->results, in);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   for (Rox_Uint id = 0; id < output->views->used; id++)
+   {
+      Rox_Sint zero = 0;
+      error = rox_dynvec_sint_append(output->votes, &zero);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   for (Rox_Uint id = 0; id < output->object_views->used; id++)
+   {
+      Rox_Sint zero = 0;
+      error = rox_dynvec_sint_append(output->object_votes, &zero);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_dynvec_sint_append(output->object_best, &zero);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
 function_terminate:
    return error;
 }
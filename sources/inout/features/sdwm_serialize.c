@@ -150,8 +150,7 @@ Rox_ErrorCode rox_sdwn_deserialize(Rox_Sdwm output, FILE* in)
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
-   //this object has a special treatment as it is initialized in rox_sdwm_new(), reset it before deserialize it
-   rox_objset_dynvec_fpsm_template_reset(output->index->index);
+   //this object is initialized in rox_sdwm_new(), its deserialization resets it
    error = rox_fpsm_index_deserialize(output->index, in);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -0,0 +1,55 @@
+//==============================================================================
+//
+//    OPENROX   : File arena_print.c
+//
+//    Contents  : Implementation of arena_print module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include "arena_print.h"
+
+#include <inout/system/errors_print.h>
+#include <inout/system/print.h>
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+Rox_ErrorCode rox_arena_print ( const Rox_Arena arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Size used = 0, peak = 0, capacity = 0;
+   Rox_Uint heap_allocations = 0, count = 0;
+
+   error = rox_arena_get_usage ( &used, &peak, &capacity, arena );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_arena_get_heap_allocations ( &heap_allocations, arena );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_arena_get_pipelines_count ( &count, arena );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   rox_log ( "Arena : %lu bytes used, %lu bytes peak, %lu bytes in %u heap allocations\n", (unsigned long) used, (unsigned long) peak, (unsigned long) capacity, heap_allocations );
+
+   for ( Rox_Uint k = 0; k < count; k++ )
+   {
+      const char * name = NULL;
+      Rox_Size pipeline_peak = 0;
+      Rox_Uint scopes = 0;
+
+      error = rox_arena_get_pipeline ( &name, &pipeline_peak, &scopes, arena, k );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      rox_log ( "   %s : %lu bytes peak over %u scopes\n", name, (unsigned long) pipeline_peak, scopes );
+   }
+
+function_terminate:
+   return error;
+}
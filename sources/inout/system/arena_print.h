@@ -0,0 +1,30 @@
+//==============================================================================
+//
+//    OPENROX   : File arena_print.h
+//
+//    Contents  : API of arena_print module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ARENA_PRINT__
+#define __OPENROX_ARENA_PRINT__
+
+#include <system/memory/arena.h>
+
+//! \addtogroup Arena
+//! @{
+
+//! Display the usage of an arena and the peak size of each pipeline
+//! \param  [in ]  arena          The arena to print
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_print ( const Rox_Arena arena );
+
+//! @}
+
+#endif // __OPENROX_ARENA_PRINT__
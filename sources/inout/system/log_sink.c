@@ -0,0 +1,834 @@
+//==============================================================================
+//
+//    OPENROX   : File log_sink.c
+//
+//    Contents  : Implementation of log_sink module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "log_sink.h"
+#include "print.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <system/memory/memory.h>
+#include <inout/system/errors_print.h>
+
+#if ( defined(ROX_IS_LINUX) || defined(ROX_IS_MACOSX) ) && defined(__GNUC__)
+   // The events are queued in lock-free rings and formatted by a posix thread
+   #define ROX_LOG_SINK_ASYNC
+   #include <pthread.h>
+   #include <sched.h>
+   #include <sys/time.h>
+#endif
+
+#ifdef __GNUC__
+   #define rox_log_load(P)              __atomic_load_n ( (P), __ATOMIC_ACQUIRE )
+   #define rox_log_store(P, V)          __atomic_store_n ( (P), (V), __ATOMIC_RELEASE )
+   #define rox_log_load_seq(P)          __atomic_load_n ( (P), __ATOMIC_SEQ_CST )
+   #define rox_log_store_seq(P, V)      __atomic_store_n ( (P), (V), __ATOMIC_SEQ_CST )
+   #define rox_log_fetch_add(P, V)      __atomic_fetch_add ( (P), (V), __ATOMIC_RELAXED )
+   #define rox_log_exchange(P, V)       __atomic_exchange_n ( (P), (V), __ATOMIC_RELAXED )
+   #define rox_log_cas(P, E, V)         __atomic_compare_exchange_n ( (P), (E), (V), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE )
+#else
+   // Without atomics the sink is synchronous, and the rate limiting counters are approximate between threads
+   #define rox_log_load(P)              (*(P))
+   #define rox_log_store(P, V)          (*(P) = (V))
+   #define rox_log_load_seq(P)          (*(P))
+   #define rox_log_store_seq(P, V)      (*(P) = (V))
+   #define rox_log_fetch_add(P, V)      ((*(P) += (V)) - (V))
+   static Rox_Sint rox_log_exchange_plain ( Rox_Sint * p, Rox_Sint v ) { Rox_Sint old = *p; *p = v; return old; }
+   #define rox_log_exchange(P, V)       rox_log_exchange_plain ( (P), (V) )
+   static Rox_Sint rox_log_cas_plain ( Rox_Sint * p, Rox_Sint * e, Rox_Sint v ) { if ( *p != *e ) { *e = *p; return 0; } *p = v; return 1; }
+   #define rox_log_cas(P, E, V)         rox_log_cas_plain ( (P), (E), (V) )
+#endif
+
+//! The number of events of a ring, a power of two
+#define ROX_LOG_RING_SIZE 128
+
+//! The number of threads with a ring, the other threads write their messages immediately
+#define ROX_LOG_MAX_THREADS 32
+
+//! The bytes of an event available to copy the string arguments, or the message formatted by rox_log
+#define ROX_LOG_TEXT_SIZE 128
+
+//! The size of a formatted message
+#define ROX_LOG_MESSAGE_SIZE 2048
+
+//! Type of the arguments, as read by va_arg
+enum Rox_Log_Arg
+{
+   ROX_LOG_ARG_UNSUPPORTED = 0,
+   ROX_LOG_ARG_PERCENT,
+   ROX_LOG_ARG_INT,
+   ROX_LOG_ARG_UINT,
+   ROX_LOG_ARG_LONG,
+   ROX_LOG_ARG_ULONG,
+   ROX_LOG_ARG_LLONG,
+   ROX_LOG_ARG_ULLONG,
+   ROX_LOG_ARG_SIZE,
+   ROX_LOG_ARG_INTMAX,
+   ROX_LOG_ARG_UINTMAX,
+   ROX_LOG_ARG_PTRDIFF,
+   ROX_LOG_ARG_DOUBLE,
+   ROX_LOG_ARG_STRING,
+   ROX_LOG_ARG_POINTER
+};
+
+//! A conversion specification of a printf format
+typedef struct Rox_Log_Conversion_Struct
+{
+   //! The position of the '%'
+   const Rox_Char * start;
+
+   //! The number of characters of the specification
+   Rox_Sint length;
+
+   //! The type of the argument
+   Rox_Sint kind;
+} Rox_Log_Conversion;
+
+//! An argument copied in an event
+typedef union Rox_Log_Value_Union
+{
+   long long i;
+   unsigned long long u;
+   double d;
+   const void * p;
+   Rox_Sint offset;
+} Rox_Log_Value;
+
+//! A deferred message
+typedef struct Rox_Log_Event_Struct
+{
+   //! The format, the arguments are read with the kinds of its conversions, NULL if text is the formatted message
+   const Rox_Char * format;
+
+   //! The number of messages of the call site discarded by the rate limiting before this one
+   Rox_Sint suppressed;
+
+   //! The arguments
+   Rox_Log_Value args[ROX_LOG_MAX_ARGS];
+
+   //! The copies of the string arguments, or the formatted message
+   Rox_Char text[ROX_LOG_TEXT_SIZE];
+} Rox_Log_Event;
+
+//! The indices of a single producer single consumer ring, on their own cache line
+typedef struct Rox_Log_Ring_Struct
+{
+   //! The number of events written, only modified by the owner thread
+   Rox_Uint head;
+
+   //! The number of events formatted, only modified by the consumer
+   Rox_Uint tail;
+
+   //! The number of events lost because the ring was full
+   Rox_Sint dropped;
+
+   //! The owner thread is writing an event
+   Rox_Sint busy;
+
+   Rox_Uchar padding[64 - 4 * sizeof ( Rox_Sint )];
+} Rox_Log_Ring;
+
+static Rox_Sint rox_log_level = ROX_LOG_LEVEL_DEBUG;
+static Rox_Sint rox_log_burst = 0;
+static Rox_Sint rox_log_period_ms = 1000;
+
+#ifdef ROX_LOG_SINK_ASYNC
+
+static ROX_STATIC_ALIGN(64) Rox_Log_Ring rox_log_rings[ROX_LOG_MAX_THREADS];
+static Rox_Log_Event * rox_log_events = NULL;
+static Rox_Sint rox_log_active = 0;
+static Rox_Sint rox_log_threads = 0;
+static Rox_Sint rox_log_dropped_reported = 0;
+static ROX_THREAD_LOCAL Rox_Sint rox_log_thread_slot = -1;
+
+static pthread_mutex_t rox_log_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rox_log_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t rox_log_thread;
+static Rox_Sint rox_log_threaded = 0;
+static Rox_Sint rox_log_stop = 0;
+static Rox_Sint rox_log_flush_period_ms = 0;
+
+#endif
+
+// Parse the conversion starting at the '%' of a format, returns the position after it
+static const Rox_Char * rox_log_parse_conversion ( Rox_Log_Conversion * conversion, const Rox_Char * start )
+{
+   const Rox_Char * cur = start + 1;
+   Rox_Sint length = 0;
+
+   conversion->start = start;
+   conversion->kind = ROX_LOG_ARG_UNSUPPORTED;
+
+   if ( *cur == '%' )
+   {
+      conversion->kind = ROX_LOG_ARG_PERCENT;
+      conversion->length = 2;
+      return cur + 1;
+   }
+
+   // Flags, width and precision, the '*' ones would add arguments to the conversion
+   while ( *cur && strchr ( "-+ #0'", *cur ) ) cur++;
+   while ( *cur >= '0' && *cur <= '9' ) cur++;
+   if ( *cur == '.' ) { cur++; while ( *cur >= '0' && *cur <= '9' ) cur++; }
+
+   // Length modifiers : 1 h, 2 hh, 3 l, 4 ll, 5 z, 6 j, 7 t, 8 L
+   if      ( cur[0] == 'h' && cur[1] == 'h' ) { length = 2; cur += 2; }
+   else if ( cur[0] == 'l' && cur[1] == 'l' ) { length = 4; cur += 2; }
+   else if ( *cur == 'h' ) { length = 1; cur++; }
+   else if ( *cur == 'l' ) { length = 3; cur++; }
+   else if ( *cur == 'z' ) { length = 5; cur++; }
+   else if ( *cur == 'j' ) { length = 6; cur++; }
+   else if ( *cur == 't' ) { length = 7; cur++; }
+   else if ( *cur == 'L' ) { length = 8; cur++; }
+
+   switch ( *cur )
+   {
+      case 'd': case 'i':
+         if ( length <= 2 ) conversion->kind = ROX_LOG_ARG_INT;
+         else if ( length == 3 ) conversion->kind = ROX_LOG_ARG_LONG;
+         else if ( length == 4 ) conversion->kind = ROX_LOG_ARG_LLONG;
+         else if ( length == 5 ) conversion->kind = ROX_LOG_ARG_SIZE;
+         else if ( length == 6 ) conversion->kind = ROX_LOG_ARG_INTMAX;
+         else if ( length == 7 ) conversion->kind = ROX_LOG_ARG_PTRDIFF;
+         break;
+
+      case 'u': case 'o': case 'x': case 'X':
+         if ( length <= 2 ) conversion->kind = ROX_LOG_ARG_UINT;
+         else if ( length == 3 ) conversion->kind = ROX_LOG_ARG_ULONG;
+         else if ( length == 4 ) conversion->kind = ROX_LOG_ARG_ULLONG;
+         else if ( length == 5 ) conversion->kind = ROX_LOG_ARG_SIZE;
+         else if ( length == 6 ) conversion->kind = ROX_LOG_ARG_UINTMAX;
+         else if ( length == 7 ) conversion->kind = ROX_LOG_ARG_PTRDIFF;
+         break;
+
+      case 'c':
+         if ( length == 0 ) conversion->kind = ROX_LOG_ARG_INT;
+         break;
+
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+         if ( length == 0 || length == 3 ) conversion->kind = ROX_LOG_ARG_DOUBLE;
+         break;
+
+      case 's':
+         if ( length == 0 ) conversion->kind = ROX_LOG_ARG_STRING;
+         break;
+
+      case 'p':
+         if ( length == 0 ) conversion->kind = ROX_LOG_ARG_POINTER;
+         break;
+
+      default:
+         break;
+   }
+
+   if ( *cur ) cur++;
+   conversion->length = (Rox_Sint) ( cur - start );
+
+   return cur;
+}
+
+// Get the argument kinds of a format, returns their number, or -1 if the format can not be deferred
+static Rox_Sint rox_log_parse_format ( Rox_Uchar kinds[ROX_LOG_MAX_ARGS], const Rox_Char * format )
+{
+   Rox_Log_Conversion conversion;
+   Rox_Sint nargs = 0;
+   const Rox_Char * cur = format;
+
+   while ( ( cur = strchr ( cur, '%' ) ) != NULL )
+   {
+      cur = rox_log_parse_conversion ( &conversion, cur );
+
+      if ( conversion.kind == ROX_LOG_ARG_PERCENT ) continue;
+      if ( conversion.kind == ROX_LOG_ARG_UNSUPPORTED || nargs == ROX_LOG_MAX_ARGS ) return -1;
+
+      kinds[nargs++] = (Rox_Uchar) conversion.kind;
+   }
+
+   return nargs;
+}
+
+// Get the argument kinds of a call site, parsed once and shared by the threads
+static Rox_Sint rox_log_site_kinds ( Rox_Uchar kinds[ROX_LOG_MAX_ARGS], Rox_Log_Site * site )
+{
+   Rox_Sint nargs = 0;
+   Rox_Sint expected = 0;
+
+   if ( rox_log_load ( &site->state ) == 2 )
+   {
+      memcpy ( kinds, site->kinds, sizeof ( site->kinds ) );
+      return site->nargs;
+   }
+
+   nargs = rox_log_parse_format ( kinds, site->format );
+
+   // Only the thread which claimed the site publishes the kinds, the others use their own copy
+   if ( rox_log_cas ( &site->state, &expected, 1 ) )
+   {
+      memcpy ( site->kinds, kinds, sizeof ( site->kinds ) );
+      site->nargs = nargs;
+      rox_log_store ( &site->state, 2 );
+   }
+
+   return nargs;
+}
+
+// Monotonic time in milliseconds, only used for the rate limiting
+static long long rox_log_time_ms ( )
+{
+#ifdef ROX_LOG_SINK_ASYNC
+   struct timespec now;
+   clock_gettime ( CLOCK_MONOTONIC, &now );
+   return (long long) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#else
+   return (long long) clock ( ) * 1000 / CLOCKS_PER_SEC;
+#endif
+}
+
+// Check the rate limit of a call site, returns 1 if the message must be discarded
+static Rox_Sint rox_log_site_limited ( Rox_Log_Site * site, Rox_Sint burst, Rox_Sint period_ms )
+{
+   const Rox_Sint window = (Rox_Sint) ( rox_log_time_ms ( ) / period_ms );
+   Rox_Sint current = rox_log_load ( &site->window );
+
+   // The first thread seeing a new window resets the count
+   if ( current != window && rox_log_cas ( &site->window, &current, window ) )
+   {
+      rox_log_store ( &site->count, 0 );
+   }
+
+   if ( rox_log_fetch_add ( &site->count, 1 ) < burst ) return 0;
+
+   rox_log_fetch_add ( &site->suppressed, 1 );
+   return 1;
+}
+
+// Write the number of messages discarded by the rate limiting before a message
+static void rox_log_write_suppressed ( Rox_Sint suppressed )
+{
+   Rox_Char buffer[64];
+
+   if ( suppressed <= 0 ) return;
+
+   snprintf ( buffer, sizeof ( buffer ), "(%d similar messages suppressed)\n", suppressed );
+   rox_log_write ( buffer );
+}
+
+#ifdef ROX_LOG_SINK_ASYNC
+
+// Copy the arguments of a message in an event
+static void rox_log_event_fill ( Rox_Log_Event * event, const Rox_Log_Site * site, const Rox_Uchar * kinds, const Rox_Sint nargs, va_list args )
+{
+   Rox_Sint used = 0;
+
+   event->format = site->format;
+
+   for ( Rox_Sint k = 0; k < nargs; k++ )
+   {
+      Rox_Log_Value * value = &event->args[k];
+
+      switch ( kinds[k] )
+      {
+         case ROX_LOG_ARG_INT:     value->i = va_arg ( args, int ); break;
+         case ROX_LOG_ARG_UINT:    value->u = va_arg ( args, unsigned int ); break;
+         case ROX_LOG_ARG_LONG:    value->i = va_arg ( args, long ); break;
+         case ROX_LOG_ARG_ULONG:   value->u = va_arg ( args, unsigned long ); break;
+         case ROX_LOG_ARG_LLONG:   value->i = va_arg ( args, long long ); break;
+         case ROX_LOG_ARG_ULLONG:  value->u = va_arg ( args, unsigned long long ); break;
+         case ROX_LOG_ARG_SIZE:    value->u = va_arg ( args, size_t ); break;
+         case ROX_LOG_ARG_INTMAX:  value->i = va_arg ( args, intmax_t ); break;
+         case ROX_LOG_ARG_UINTMAX: value->u = va_arg ( args, uintmax_t ); break;
+         case ROX_LOG_ARG_PTRDIFF: value->i = va_arg ( args, ptrdiff_t ); break;
+         case ROX_LOG_ARG_DOUBLE:  value->d = va_arg ( args, double ); break;
+         case ROX_LOG_ARG_POINTER: value->p = va_arg ( args, void * ); break;
+
+         case ROX_LOG_ARG_STRING:
+         {
+            // The string may not outlive the call, it is copied and truncated to the space left
+            const Rox_Char * string = va_arg ( args, const Rox_Char * );
+            Rox_Sint length = 0;
+
+            if ( !string ) string = "(null)";
+            while ( string[length] && used + length < ROX_LOG_TEXT_SIZE - 1 ) length++;
+
+            memcpy ( &event->text[used], string, length );
+            event->text[used + length] = 0;
+            value->offset = used;
+            used += length + ( used + length < ROX_LOG_TEXT_SIZE - 1 );
+            break;
+         }
+
+         default:
+            break;
+      }
+   }
+}
+
+// Format an event, the kinds come from the format itself
+static void rox_log_event_format ( Rox_Char * buffer, const Rox_Sint size, const Rox_Log_Event * event )
+{
+   Rox_Log_Conversion conversion;
+   Rox_Char spec[32];
+   const Rox_Char * cur = event->format;
+   Rox_Sint used = 0, arg = 0;
+
+   buffer[0] = 0;
+
+   while ( *cur && used < size - 1 )
+   {
+      const Rox_Char * next = strchr ( cur, '%' );
+      Rox_Sint written = 0;
+
+      if ( !next )
+      {
+         snprintf ( &buffer[used], size - used, "%s", cur );
+         break;
+      }
+
+      // Literal text before the conversion
+      if ( next > cur )
+      {
+         Rox_Sint length = (Rox_Sint) ( next - cur );
+         if ( length > size - 1 - used ) length = size - 1 - used;
+         memcpy ( &buffer[used], cur, length );
+         used += length;
+         buffer[used] = 0;
+      }
+
+      cur = rox_log_parse_conversion ( &conversion, next );
+
+      if ( conversion.kind == ROX_LOG_ARG_PERCENT )
+      {
+         if ( used < size - 1 ) { buffer[used++] = '%'; buffer[used] = 0; }
+         continue;
+      }
+
+      if ( conversion.length >= (Rox_Sint) sizeof ( spec ) || arg >= ROX_LOG_MAX_ARGS ) break;
+
+      memcpy ( spec, conversion.start, conversion.length );
+      spec[conversion.length] = 0;
+
+      {
+         const Rox_Log_Value * value = &event->args[arg++];
+         Rox_Char * out = &buffer[used];
+         const size_t left = (size_t) ( size - used );
+
+         switch ( conversion.kind )
+         {
+            case ROX_LOG_ARG_INT:     written = snprintf ( out, left, spec, (int) value->i ); break;
+            case ROX_LOG_ARG_UINT:    written = snprintf ( out, left, spec, (unsigned int) value->u ); break;
+            case ROX_LOG_ARG_LONG:    written = snprintf ( out, left, spec, (long) value->i ); break;
+            case ROX_LOG_ARG_ULONG:   written = snprintf ( out, left, spec, (unsigned long) value->u ); break;
+            case ROX_LOG_ARG_LLONG:   written = snprintf ( out, left, spec, (long long) value->i ); break;
+            case ROX_LOG_ARG_ULLONG:  written = snprintf ( out, left, spec, (unsigned long long) value->u ); break;
+            case ROX_LOG_ARG_SIZE:    written = snprintf ( out, left, spec, (size_t) value->u ); break;
+            case ROX_LOG_ARG_INTMAX:  written = snprintf ( out, left, spec, (intmax_t) value->i ); break;
+            case ROX_LOG_ARG_UINTMAX: written = snprintf ( out, left, spec, (uintmax_t) value->u ); break;
+            case ROX_LOG_ARG_PTRDIFF: written = snprintf ( out, left, spec, (ptrdiff_t) value->i ); break;
+            case ROX_LOG_ARG_DOUBLE:  written = snprintf ( out, left, spec, value->d ); break;
+            case ROX_LOG_ARG_POINTER: written = snprintf ( out, left, spec, value->p ); break;
+            case ROX_LOG_ARG_STRING:  written = snprintf ( out, left, spec, &event->text[value->offset] ); break;
+            default: break;
+         }
+      }
+
+      if ( written > 0 ) used += ( written < size - 1 - used ) ? written : size - 1 - used;
+   }
+}
+
+// Format and write the pending events of all the rings, the caller holds rox_log_mutex
+static void rox_log_drain ( )
+{
+   Rox_Char buffer[ROX_LOG_MESSAGE_SIZE];
+   const Rox_Sint threads = rox_log_load ( &rox_log_threads );
+   Rox_Sint dropped = 0;
+
+   if ( !rox_log_events ) return;
+
+   for ( Rox_Sint slot = 0; slot < threads && slot < ROX_LOG_MAX_THREADS; slot++ )
+   {
+      Rox_Log_Ring * ring = &rox_log_rings[slot];
+      const Rox_Uint head = rox_log_load ( &ring->head );
+      Rox_Uint tail = ring->tail;
+
+      for ( ; tail != head; tail++ )
+      {
+         const Rox_Log_Event * event = &rox_log_events[slot * ROX_LOG_RING_SIZE + ( tail & ( ROX_LOG_RING_SIZE - 1 ) )];
+
+         rox_log_write_suppressed ( event->suppressed );
+
+         if ( event->format )
+         {
+            rox_log_event_format ( buffer, sizeof ( buffer ), event );
+            rox_log_write ( buffer );
+         }
+         else
+         {
+            rox_log_write ( event->text );
+         }
+      }
+
+      rox_log_store ( &ring->tail, tail );
+      dropped += rox_log_load ( &ring->dropped );
+   }
+
+   if ( dropped > rox_log_dropped_reported )
+   {
+      snprintf ( buffer, sizeof ( buffer ), "(%d log messages lost, the ring of a thread was full)\n", dropped - rox_log_dropped_reported );
+      rox_log_write ( buffer );
+      rox_log_dropped_reported = dropped;
+   }
+}
+
+// Background thread formatting the events periodically
+static void * rox_log_worker ( void * data )
+{
+   (void) data;
+
+   pthread_mutex_lock ( &rox_log_mutex );
+
+   while ( !rox_log_stop )
+   {
+      struct timeval now;
+      struct timespec deadline;
+      long long nsec = 0;
+
+      rox_log_drain ( );
+
+      gettimeofday ( &now, NULL );
+      nsec = (long long) now.tv_usec * 1000 + (long long) rox_log_flush_period_ms * 1000000;
+      deadline.tv_sec = now.tv_sec + (time_t) ( nsec / 1000000000 );
+      deadline.tv_nsec = (long) ( nsec % 1000000000 );
+
+      pthread_cond_timedwait ( &rox_log_cond, &rox_log_mutex, &deadline );
+   }
+
+   pthread_mutex_unlock ( &rox_log_mutex );
+
+   return NULL;
+}
+
+// Get the ring slot of the calling thread, ROX_LOG_MAX_THREADS if it must write immediately
+static Rox_Sint rox_log_get_thread_slot ( )
+{
+   Rox_Sint slot = rox_log_thread_slot;
+
+   if ( slot < 0 )
+   {
+      // The slots are never released, the threads beyond the capacity write immediately
+      slot = rox_log_fetch_add ( &rox_log_threads, 1 );
+      if ( slot >= ROX_LOG_MAX_THREADS ) slot = ROX_LOG_MAX_THREADS;
+      rox_log_thread_slot = slot;
+   }
+
+   return slot;
+}
+
+// Queue an event in the ring of the calling thread, returns 0 if it must be written immediately
+static Rox_Sint rox_log_enqueue ( Rox_Log_Site * site, const Rox_Uchar * kinds, const Rox_Sint nargs, const Rox_Sint suppressed, va_list args )
+{
+   const Rox_Sint slot = rox_log_get_thread_slot ( );
+   Rox_Sint queued = 0;
+   Rox_Log_Ring * ring = NULL;
+
+   if ( slot >= ROX_LOG_MAX_THREADS ) return 0;
+
+   ring = &rox_log_rings[slot];
+
+   // The sink can not release the events while a thread is busy after having seen it active
+   rox_log_store_seq ( &ring->busy, 1 );
+
+   if ( rox_log_load_seq ( &rox_log_active ) )
+   {
+      const Rox_Uint head = ring->head;
+
+      if ( head - rox_log_load ( &ring->tail ) < ROX_LOG_RING_SIZE )
+      {
+         Rox_Log_Event * event = &rox_log_events[slot * ROX_LOG_RING_SIZE + ( head & ( ROX_LOG_RING_SIZE - 1 ) )];
+
+         rox_log_event_fill ( event, site, kinds, nargs, args );
+         event->suppressed = suppressed;
+         rox_log_store ( &ring->head, head + 1 );
+      }
+      else
+      {
+         rox_log_store ( &ring->dropped, ring->dropped + 1 );
+      }
+
+      queued = 1;
+   }
+
+   rox_log_store_seq ( &ring->busy, 0 );
+
+   return queued;
+}
+
+// Format a message directly in an event of the ring of the calling thread,
+// returns 0 if it must be written immediately (no ring, or message longer than an event)
+static Rox_Sint rox_log_enqueue_formatted ( const Rox_Char * format, va_list args )
+{
+   const Rox_Sint slot = rox_log_get_thread_slot ( );
+   Rox_Sint queued = 0;
+   Rox_Log_Ring * ring = NULL;
+
+   if ( slot >= ROX_LOG_MAX_THREADS ) return 0;
+
+   ring = &rox_log_rings[slot];
+
+   rox_log_store_seq ( &ring->busy, 1 );
+
+   if ( rox_log_load_seq ( &rox_log_active ) )
+   {
+      const Rox_Uint head = ring->head;
+
+      if ( head - rox_log_load ( &ring->tail ) < ROX_LOG_RING_SIZE )
+      {
+         Rox_Log_Event * event = &rox_log_events[slot * ROX_LOG_RING_SIZE + ( head & ( ROX_LOG_RING_SIZE - 1 ) )];
+         const Rox_Sint length = vsnprintf ( event->text, ROX_LOG_TEXT_SIZE, format, args );
+
+         // The event is published only if the whole message fits in it
+         if ( length >= 0 && length < ROX_LOG_TEXT_SIZE )
+         {
+            event->format = NULL;
+            event->suppressed = 0;
+            rox_log_store ( &ring->head, head + 1 );
+            queued = 1;
+         }
+      }
+      else
+      {
+         rox_log_store ( &ring->dropped, ring->dropped + 1 );
+         queued = 1;
+      }
+   }
+
+   rox_log_store_seq ( &ring->busy, 0 );
+
+   return queued;
+}
+
+#endif
+
+void rox_log_record ( Rox_Log_Site * site, ... )
+{
+   Rox_Uchar kinds[ROX_LOG_MAX_ARGS];
+   Rox_Sint nargs = 0, suppressed = 0, burst = 0;
+   va_list args;
+
+   if ( !site || site->level < rox_log_load ( &rox_log_level ) ) return;
+
+   burst = rox_log_load ( &rox_log_burst );
+   if ( burst > 0 )
+   {
+      if ( rox_log_site_limited ( site, burst, rox_log_load ( &rox_log_period_ms ) ) ) return;
+      suppressed = rox_log_exchange ( &site->suppressed, 0 );
+   }
+
+   nargs = rox_log_site_kinds ( kinds, site );
+
+#ifdef ROX_LOG_SINK_ASYNC
+   if ( nargs >= 0 && rox_log_load ( &rox_log_active ) )
+   {
+      Rox_Sint queued = 0;
+
+      va_start ( args, site );
+      queued = rox_log_enqueue ( site, kinds, nargs, suppressed, args );
+      va_end ( args );
+
+      if ( queued ) return;
+   }
+#endif
+
+   {
+      Rox_Char buffer[ROX_LOG_MESSAGE_SIZE];
+
+      va_start ( args, site );
+      vsnprintf ( buffer, sizeof ( buffer ), site->format, args );
+      va_end ( args );
+
+      rox_log_write_suppressed ( suppressed );
+      rox_log_write ( buffer );
+   }
+}
+
+void rox_log_record_formatted ( const Rox_Char * format, va_list args )
+{
+   Rox_Char buffer[ROX_LOG_MESSAGE_SIZE];
+
+   if ( !format || ROX_LOG_LEVEL_INFO < rox_log_load ( &rox_log_level ) ) return;
+
+#ifdef ROX_LOG_SINK_ASYNC
+   if ( rox_log_load ( &rox_log_active ) )
+   {
+      Rox_Sint queued = 0;
+      va_list copy;
+
+      // The arguments are read again if the message has to be written immediately
+      va_copy ( copy, args );
+      queued = rox_log_enqueue_formatted ( format, copy );
+      va_end ( copy );
+
+      if ( queued ) return;
+   }
+#endif
+
+   vsnprintf ( buffer, sizeof ( buffer ), format, args );
+   rox_log_write ( buffer );
+}
+
+Rox_ErrorCode rox_log_set_level ( const enum Rox_Log_Level level )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( level < ROX_LOG_LEVEL_DEBUG || level > ROX_LOG_LEVEL_NONE )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_log_store ( &rox_log_level, (Rox_Sint) level );
+
+function_terminate:
+   return error;
+}
+
+enum Rox_Log_Level rox_log_get_level ( )
+{
+   return (enum Rox_Log_Level) rox_log_load ( &rox_log_level );
+}
+
+Rox_ErrorCode rox_log_set_rate_limit ( const Rox_Sint burst, const Rox_Sint period_ms )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( burst < 0 || period_ms <= 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   rox_log_store ( &rox_log_period_ms, period_ms );
+   rox_log_store ( &rox_log_burst, burst );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_log_sink_start ( const Rox_Sint flush_period_ms )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( flush_period_ms < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+#ifdef ROX_LOG_SINK_ASYNC
+   pthread_mutex_lock ( &rox_log_mutex );
+
+   if ( rox_log_events )
+   {
+      pthread_mutex_unlock ( &rox_log_mutex );
+      error = ROX_ERROR_INVALID; ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   rox_log_events = (Rox_Log_Event *) rox_memory_allocate ( sizeof ( Rox_Log_Event ), ROX_LOG_MAX_THREADS * ROX_LOG_RING_SIZE );
+   if ( !rox_log_events )
+   {
+      pthread_mutex_unlock ( &rox_log_mutex );
+      error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   // The rings are empty, the threads keep their slots from a previous start
+   for ( Rox_Sint slot = 0; slot < ROX_LOG_MAX_THREADS; slot++ )
+   {
+      rox_log_rings[slot].tail = rox_log_rings[slot].head;
+      rox_log_rings[slot].dropped = 0;
+   }
+   rox_log_dropped_reported = 0;
+
+   rox_log_stop = 0;
+   rox_log_flush_period_ms = flush_period_ms;
+   rox_log_store_seq ( &rox_log_active, 1 );
+
+   // Without a thread the events are formatted on rox_log_flush
+   rox_log_threaded = ( flush_period_ms > 0 ) && !pthread_create ( &rox_log_thread, NULL, rox_log_worker, NULL );
+
+   pthread_mutex_unlock ( &rox_log_mutex );
+#else
+   error = ROX_ERROR_NOT_IMPLEMENTED; ROX_ERROR_CHECK_TERMINATE ( error );
+#endif
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_log_sink_stop ( )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+#ifdef ROX_LOG_SINK_ASYNC
+   rox_log_store_seq ( &rox_log_active, 0 );
+
+   pthread_mutex_lock ( &rox_log_mutex );
+   rox_log_stop = 1;
+   pthread_cond_broadcast ( &rox_log_cond );
+   pthread_mutex_unlock ( &rox_log_mutex );
+
+   if ( rox_log_threaded ) pthread_join ( rox_log_thread, NULL );
+   rox_log_threaded = 0;
+
+   // Wait for the threads which saw the sink active to finish their event
+   for ( Rox_Sint slot = 0; slot < ROX_LOG_MAX_THREADS; slot++ )
+   {
+      while ( rox_log_load_seq ( &rox_log_rings[slot].busy ) ) sched_yield ( );
+   }
+
+   pthread_mutex_lock ( &rox_log_mutex );
+   rox_log_drain ( );
+   rox_memory_delete ( rox_log_events );
+   rox_log_events = NULL;
+   pthread_mutex_unlock ( &rox_log_mutex );
+#endif
+
+   return error;
+}
+
+Rox_ErrorCode rox_log_flush ( )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+#ifdef ROX_LOG_SINK_ASYNC
+   pthread_mutex_lock ( &rox_log_mutex );
+   rox_log_drain ( );
+   pthread_mutex_unlock ( &rox_log_mutex );
+#endif
+
+   return error;
+}
+
+Rox_ErrorCode rox_log_get_dropped ( Rox_Sint * dropped )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !dropped )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *dropped = 0;
+
+#ifdef ROX_LOG_SINK_ASYNC
+   for ( Rox_Sint slot = 0; slot < ROX_LOG_MAX_THREADS; slot++ )
+   {
+      *dropped += rox_log_load ( &rox_log_rings[slot].dropped );
+   }
+#endif
+
+function_terminate:
+   return error;
+}
@@ -0,0 +1,153 @@
+//==============================================================================
+//
+//    OPENROX   : File log_sink.h
+//
+//    Contents  : API of log_sink module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_LOG_SINK__
+#define __OPENROX_LOG_SINK__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+   #include <system/arch/compiler.h>
+   #include <system/memory/datatypes.h>
+   #include <system/errors/errors.h>
+   #include <stdarg.h>
+
+   //! \ingroup InOut System
+   //! @defgroup Log_Sink Log_Sink
+   //! \brief Deferred logging : the messages are recorded as compact binary events
+   //! (format and arguments) in per-thread lock-free rings, and formatted later
+   //! by a background thread or by an explicit flush.
+   //! @{
+
+   //! Severity of a log message
+   enum Rox_Log_Level
+   {
+      ROX_LOG_LEVEL_DEBUG = 0,
+      ROX_LOG_LEVEL_INFO = 1,
+      ROX_LOG_LEVEL_WARNING = 2,
+      ROX_LOG_LEVEL_ERROR = 3,
+      ROX_LOG_LEVEL_NONE = 4
+   };
+
+   //! The messages below this level are removed at compile time
+   #ifndef ROX_LOG_COMPILED_LEVEL
+      #define ROX_LOG_COMPILED_LEVEL ROX_LOG_LEVEL_DEBUG
+   #endif
+
+   //! The maximum number of arguments of a deferred message (more are formatted synchronously)
+   #define ROX_LOG_MAX_ARGS 8
+
+   //! Call site of a log message, one static instance per ROX_LOG_* macro expansion
+   typedef struct Rox_Log_Site_Struct
+   {
+      //! The format, a string literal whose address identifies the message
+      const Rox_Char * format;
+
+      //! The severity of the message
+      Rox_Sint level;
+
+      //! 0 until the format is parsed, 2 once nargs and kinds are valid
+      Rox_Sint state;
+
+      //! The number of arguments, -1 if the format can not be deferred
+      Rox_Sint nargs;
+
+      //! The type of each argument
+      Rox_Uchar kinds[ROX_LOG_MAX_ARGS];
+
+      //! The current rate limiting window
+      Rox_Sint window;
+
+      //! The number of messages recorded in the current window
+      Rox_Sint count;
+
+      //! The number of messages discarded by the rate limiting since the last recorded one
+      Rox_Sint suppressed;
+   } Rox_Log_Site;
+
+   //! Record a message with a printf format (string literal) and a severity.
+   //! The integer, floating point, pointer and string arguments are copied in the event,
+   //! strings are truncated to the space left in the event.
+   #define ROX_LOG_EVENT(LEVEL, FORMAT, ...) do {\
+      if ( (LEVEL) >= ROX_LOG_COMPILED_LEVEL ) {\
+         static Rox_Log_Site rox_log_site = { "" FORMAT "", (LEVEL) };\
+         rox_log_record ( &rox_log_site, ##__VA_ARGS__ ); } } while (0)
+
+   //! Debug message
+   #define ROX_LOG_DEBUG(FORMAT, ...) ROX_LOG_EVENT ( ROX_LOG_LEVEL_DEBUG, FORMAT, ##__VA_ARGS__ )
+   //! Information message
+   #define ROX_LOG_INFO(FORMAT, ...) ROX_LOG_EVENT ( ROX_LOG_LEVEL_INFO, FORMAT, ##__VA_ARGS__ )
+   //! Warning message
+   #define ROX_LOG_WARNING(FORMAT, ...) ROX_LOG_EVENT ( ROX_LOG_LEVEL_WARNING, FORMAT, ##__VA_ARGS__ )
+   //! Error message
+   #define ROX_LOG_ERROR(FORMAT, ...) ROX_LOG_EVENT ( ROX_LOG_LEVEL_ERROR, FORMAT, ##__VA_ARGS__ )
+
+   //! Record a message of a call site, use the ROX_LOG_* macros rather than this function.
+   //! Without a started sink, or when the format can not be deferred, the message is written immediately.
+   //! \param  [in ]  site           The call site
+   //! \param  [in ]  ...            The arguments of the format
+   ROX_API void rox_log_record ( Rox_Log_Site * site, ... );
+
+   //! Record an information message of rox_log.
+   //! The format may not outlive the call, so the message is formatted immediately in the ring
+   //! of the calling thread and only written later. Without a started sink, or when the message
+   //! is longer than an event, it is written immediately.
+   //! \param  [in ]  format         The printf format
+   //! \param  [in ]  args           The arguments of the format
+   ROX_API void rox_log_record_formatted ( const Rox_Char * format, va_list args );
+
+   //! Set the minimum severity of the messages recorded at runtime (also applies to rox_log, as information messages)
+   //! \param  [in ]  level          The minimum severity, ROX_LOG_LEVEL_NONE discards all the messages
+   //! \return An error code
+   ROX_API Rox_ErrorCode rox_log_set_level ( const enum Rox_Log_Level level );
+
+   //! Get the minimum severity of the messages recorded at runtime
+   //! \return The minimum severity
+   ROX_API enum Rox_Log_Level rox_log_get_level ( );
+
+   //! Limit the number of messages recorded by a call site.
+   //! The number of discarded messages is reported with the next recorded one.
+   //! \param  [in ]  burst          The maximum number of messages per period, 0 to disable the rate limiting
+   //! \param  [in ]  period_ms      The period in milliseconds
+   //! \return An error code
+   ROX_API Rox_ErrorCode rox_log_set_rate_limit ( const Rox_Sint burst, const Rox_Sint period_ms );
+
+   //! Start to defer the messages recorded by the ROX_LOG_* macros and rox_log.
+   //! The order of the messages is kept for each thread, not between threads.
+   //! \param  [in ]  flush_period_ms   The period of the background thread formatting the messages,
+   //!                                  0 to format them only on rox_log_flush
+   //! \return An error code
+   ROX_API Rox_ErrorCode rox_log_sink_start ( const Rox_Sint flush_period_ms );
+
+   //! Format and write all the pending messages, then write the following ones immediately
+   //! \return An error code
+   ROX_API Rox_ErrorCode rox_log_sink_stop ( );
+
+   //! Format and write the pending messages
+   //! \return An error code
+   ROX_API Rox_ErrorCode rox_log_flush ( );
+
+   //! Get the number of messages lost because a ring was full, since the start of the sink
+   //! \param  [out]  dropped        The number of lost messages
+   //! \return An error code
+   ROX_API Rox_ErrorCode rox_log_get_dropped ( Rox_Sint * dropped );
+
+   //! @}
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif // __OPENROX_LOG_SINK__
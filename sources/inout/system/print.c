@@ -13,6 +13,7 @@
 //==============================================================================
 
 #include "print.h"
+#include "log_sink.h"
 
 #include <stdarg.h>
 #include <stdio.h>
@@ -25,30 +26,31 @@ rox_log_callback _log_callback = NULL;
 
 void rox_log(const char *fmt, ...)
 {
-   char buffer[2048];
    va_list args;
+
    va_start(args, fmt);
-   snprintf(buffer, sizeof(buffer), fmt, args);
+   rox_log_record_formatted(fmt, args);
+   va_end(args);
+}
+
+void rox_log_write(const char *message)
+{
    if (_log_callback != NULL)
    {
-      _log_callback(buffer);
+      _log_callback(message);
+      return;
    }
-   else
-   {
+
 #ifdef ROX_LOGS
    #ifdef ANDROID
-         __android_log_print(ANDROID_LOG_INFO, "OPENROX", "%s", buffer);
+   __android_log_print(ANDROID_LOG_INFO, "OPENROX", "%s", message);
    #else
-         vprintf(fmt, args);
+   fputs(message, stdout);
    #endif
-#else
-
 #endif
-   }
-   va_end(args);
 }
 
 void rox_log_set_callback(rox_log_callback callback)
 {
    _log_callback = callback;
-}
\ No newline at end of file
+}
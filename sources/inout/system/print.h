@@ -37,7 +37,7 @@ extern "C" {
    typedef void(* rox_log_callback)(const char* message);
 
    //! Allows to log message on any type of devices
-   //! using printf format
+   //! using printf format, the message is written by the log sink once it is started
    //! \param fmt Format
    //! \param ... Additional message (printf-like)
    ROX_API void rox_log(const char *fmt, ...);
@@ -45,6 +45,10 @@ extern "C" {
    //! Allows to specify a function to use to log any messages 
    ROX_API void rox_log_set_callback(rox_log_callback callback);
 
+   //! Write an already formatted message on the log output (callback, or standard output)
+   //! \param message The formatted message
+   ROX_API void rox_log_write(const char *message);
+
 //! @} 
 
 #ifdef __cplusplus
@@ -0,0 +1,727 @@
+//==============================================================================
+//
+//    OPENROX   : File frame_source.c
+//
+//    Contents  : Implementation of frame_source module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "frame_source.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <system/memory/memory.h>
+#include <inout/image/pgm/pgmfile.h>
+#include <inout/system/errors_print.h>
+
+#if defined(ROX_IS_LINUX) || defined(ROX_IS_MACOSX)
+   // Files are mapped in memory and decoded by a posix thread
+   #define ROX_FRAME_SOURCE_POSIX
+   #include <pthread.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+#endif
+
+//! The state of an image of the pool
+enum Rox_Frame_Source_Slot
+{
+   //! In the stack of the free images
+   Rox_Frame_Source_Slot_Free = 0,
+
+   //! A file is being decoded in the image
+   Rox_Frame_Source_Slot_Decoding,
+
+   //! In the queue of the decoded images
+   Rox_Frame_Source_Slot_Ready,
+
+   //! Owned by the caller until it is released
+   Rox_Frame_Source_Slot_Acquired
+};
+
+//! Frame source
+struct Rox_Frame_Source_Struct
+{
+   //! The pattern of the file names
+   Rox_Char * pattern;
+
+   //! The index of the last file (-1 to read until a file is missing)
+   Rox_Sint last;
+
+   //! The index of the next file to decode
+   Rox_Sint next;
+
+   //! The files are pgm files, raw buffers otherwise
+   Rox_Sint is_pgm;
+
+   //! The image width
+   Rox_Sint cols;
+
+   //! The image height
+   Rox_Sint rows;
+
+   //! The stride of raw buffers
+   Rox_Sint bytes_per_row;
+
+   //! The pixel format of raw buffers
+   enum Rox_Image_Format format;
+
+   //! The number of images of the pool
+   Rox_Sint buffers;
+
+   //! The images of the pool
+   Rox_Image * images;
+
+   //! The state of each image of the pool
+   enum Rox_Frame_Source_Slot * states;
+
+   //! The stack of the free images of the pool
+   Rox_Sint * free_slots;
+
+   //! The number of free images
+   Rox_Sint nb_free;
+
+   //! The circular queue of the decoded images
+   Rox_Sint * ready_slots;
+
+   //! The file index of each decoded image
+   Rox_Sint * ready_index;
+
+   //! The position of the oldest decoded image in the queue
+   Rox_Sint ready_first;
+
+   //! The number of decoded images
+   Rox_Sint nb_ready;
+
+   //! The number of images owned by the caller
+   Rox_Sint nb_acquired;
+
+   //! No more frame will be decoded
+   Rox_Sint finished;
+
+   //! The code returned once all the decoded images have been acquired
+   Rox_ErrorCode status;
+
+   //! Read buffer for raw files when they can not be mapped
+   Rox_Uchar * raw;
+
+   //! The frames are decoded by a background thread
+   Rox_Sint threaded;
+
+   //! The background thread must stop
+   Rox_Sint stop;
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+   //! The decoding thread
+   pthread_t thread;
+
+   //! Protects the pool and the queue
+   pthread_mutex_t mutex;
+
+   //! Signaled when a frame is decoded or the sequence is finished
+   pthread_cond_t cond_ready;
+
+   //! Signaled when an image is released or the source is deleted
+   pthread_cond_t cond_free;
+#endif
+};
+
+static void frame_source_lock ( Rox_Frame_Source obj )
+{
+#ifdef ROX_FRAME_SOURCE_POSIX
+   if ( obj->threaded ) pthread_mutex_lock ( &obj->mutex );
+#endif
+}
+
+static void frame_source_unlock ( Rox_Frame_Source obj )
+{
+#ifdef ROX_FRAME_SOURCE_POSIX
+   if ( obj->threaded ) pthread_mutex_unlock ( &obj->mutex );
+#endif
+}
+
+static Rox_ErrorCode frame_source_pgm_header (
+   Rox_Size * offset,
+   Rox_Sint * rows,
+   Rox_Sint * cols,
+   const Rox_Uchar * data,
+   const Rox_Size size
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint values[3] = { 0, 0, 0 };
+   Rox_Size pos = 2;
+
+   if ( size < 2 || data[0] != 'P' || data[1] != '5' )
+   { error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // Width, height and maximal value, separated by spaces and comments
+   for ( Rox_Sint k = 0; k < 3; k++ )
+   {
+      while ( pos < size && ( isspace ( data[pos] ) || data[pos] == '#' ) )
+      {
+         if ( data[pos] == '#' )
+         {
+            while ( pos < size && data[pos] != '\n' ) pos++;
+         }
+         else
+         {
+            pos++;
+         }
+      }
+
+      if ( pos >= size || !isdigit ( data[pos] ) )
+      { error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      while ( pos < size && isdigit ( data[pos] ) && values[k] < 1000000 )
+      {
+         values[k] = 10 * values[k] + ( data[pos] - '0' );
+         pos++;
+      }
+   }
+
+   // A single space before the pixels
+   if ( pos >= size || !isspace ( data[pos] ) )
+   { error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   pos++;
+
+   if ( values[0] < 1 || values[1] < 1 || values[2] < 1 || values[2] > 255 )
+   { error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *cols = values[0];
+   *rows = values[1];
+   *offset = pos;
+
+function_terminate:
+   return error;
+}
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+
+static Rox_ErrorCode frame_source_map ( const Rox_Uchar ** data, Rox_Size * size, const Rox_Char * path )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   struct stat status;
+   void * map = NULL;
+
+   Rox_Sint fd = open ( path, O_RDONLY );
+   if ( fd < 0 )
+   { error = ROX_ERROR_FILE_NOT_FOUND; goto function_terminate; }
+
+   if ( fstat ( fd, &status ) || status.st_size <= 0 )
+   { error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   map = mmap ( NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   if ( map == MAP_FAILED )
+   { error = ROX_ERROR_BAD_IOSTREAM; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *data = (const Rox_Uchar *) map;
+   *size = (Rox_Size) status.st_size;
+
+function_terminate:
+   if ( fd >= 0 ) close ( fd );
+   return error;
+}
+
+static void frame_source_unmap ( const Rox_Uchar * data, const Rox_Size size )
+{
+   munmap ( (void *) data, (size_t) size );
+}
+
+#endif
+
+static Rox_ErrorCode frame_source_decode ( Rox_Frame_Source obj, Rox_Image image, const Rox_Sint index )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Char path[FILENAME_MAX];
+   Rox_Sint rows = 0, cols = 0;
+
+   snprintf ( path, FILENAME_MAX, obj->pattern, index );
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+   const Rox_Uchar * data = NULL;
+   Rox_Size size = 0, offset = 0;
+
+   error = frame_source_map ( &data, &size, path );
+   if ( error ) goto function_terminate;
+
+   if ( obj->is_pgm )
+   {
+      error = frame_source_pgm_header ( &offset, &rows, &cols, data, size );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      if ( rows != obj->rows || cols != obj->cols || size - offset < (Rox_Size) rows * cols )
+      { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_image_set_data ( image, data + offset, cols, Rox_Image_Format_Grays );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+   else
+   {
+      if ( size < (Rox_Size) obj->rows * obj->bytes_per_row )
+      { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_image_set_data ( image, data, obj->bytes_per_row, obj->format );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+#else
+   FILE * file = fopen ( path, "rb" );
+   if ( !file )
+   { error = ROX_ERROR_FILE_NOT_FOUND; goto function_terminate; }
+
+   if ( obj->is_pgm )
+   {
+      Rox_Sint max = 0;
+
+      error = rox_pgm_read_header ( file, &rows, &cols, &max );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      if ( rows != obj->rows || cols != obj->cols )
+      { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      Rox_Uchar ** rows_ptr = NULL;
+      error = rox_array2d_uchar_get_data_pointer_to_pointer ( &rows_ptr, image );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_pgm_read_content ( rows_ptr, file, cols, rows );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+   else
+   {
+      Rox_Size nb = (Rox_Size) obj->rows * obj->bytes_per_row;
+      if ( fread ( obj->raw, 1, nb, file ) != nb )
+      { error = ROX_ERROR_BAD_SIZE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      error = rox_image_set_data ( image, obj->raw, obj->bytes_per_row, obj->format );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+#endif
+
+function_terminate:
+#ifdef ROX_FRAME_SOURCE_POSIX
+   if ( data ) frame_source_unmap ( data, size );
+#else
+   if ( file ) fclose ( file );
+#endif
+   return error;
+}
+
+// Decode the next file in a free image, called with the lock held and at least one free image
+static void frame_source_produce ( Rox_Frame_Source obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   Rox_Sint slot = obj->free_slots[--obj->nb_free];
+   Rox_Sint index = obj->next++;
+
+   obj->states[slot] = Rox_Frame_Source_Slot_Decoding;
+
+   // The caller can acquire the previous frames during the decoding
+   frame_source_unlock ( obj );
+   error = frame_source_decode ( obj, obj->images[slot], index );
+   frame_source_lock ( obj );
+
+   if ( error )
+   {
+      obj->free_slots[obj->nb_free++] = slot;
+      obj->states[slot] = Rox_Frame_Source_Slot_Free;
+      obj->finished = 1;
+
+      // A missing file ends an unbounded sequence
+      if ( error == ROX_ERROR_FILE_NOT_FOUND && obj->last < 0 )
+      {
+         obj->status = ROX_ERROR_EMPTY_BUFFER;
+      }
+      else
+      {
+         obj->status = error;
+      }
+   }
+   else
+   {
+      Rox_Sint pos = ( obj->ready_first + obj->nb_ready ) % obj->buffers;
+      obj->ready_slots[pos] = slot;
+      obj->ready_index[pos] = index;
+      obj->states[slot] = Rox_Frame_Source_Slot_Ready;
+      obj->nb_ready++;
+
+      if ( obj->last >= 0 && obj->next > obj->last )
+      {
+         obj->finished = 1;
+      }
+   }
+}
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+
+static void * frame_source_worker ( void * arg )
+{
+   Rox_Frame_Source obj = (Rox_Frame_Source) arg;
+
+   pthread_mutex_lock ( &obj->mutex );
+
+   while ( !obj->stop && !obj->finished )
+   {
+      if ( obj->nb_free == 0 )
+      {
+         pthread_cond_wait ( &obj->cond_free, &obj->mutex );
+         continue;
+      }
+
+      frame_source_produce ( obj );
+      pthread_cond_broadcast ( &obj->cond_ready );
+   }
+
+   pthread_mutex_unlock ( &obj->mutex );
+
+   return NULL;
+}
+
+#endif
+
+static Rox_ErrorCode frame_source_new (
+   Rox_Frame_Source * obj,
+   const Rox_Char * pattern,
+   const Rox_Sint first,
+   const Rox_Sint last,
+   const Rox_Sint cols,
+   const Rox_Sint rows,
+   const Rox_Sint buffers
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source ret = NULL;
+
+   if ( !obj || !pattern )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( buffers < 2 || cols < 1 || rows < 1 || first < 0 || ( last >= 0 && last < first ) )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_Frame_Source) rox_memory_allocate ( sizeof ( *ret ), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset ( ret, 0, sizeof ( *ret ) );
+
+   ret->last = last;
+   ret->next = first;
+   ret->cols = cols;
+   ret->rows = rows;
+   ret->buffers = buffers;
+   ret->status = ROX_ERROR_EMPTY_BUFFER;
+
+   ret->images = (Rox_Image *) rox_memory_allocate ( sizeof ( Rox_Image ), buffers );
+   if ( !ret->images )
+   { rox_frame_source_del ( &ret ); error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // The images are deleted with the source if any allocation below fails
+   for ( Rox_Sint k = 0; k < buffers; k++ )
+   {
+      ret->images[k] = NULL;
+   }
+
+   ret->pattern     = (Rox_Char *) rox_memory_allocate ( sizeof ( Rox_Char ), strlen ( pattern ) + 1 );
+   ret->states      = (enum Rox_Frame_Source_Slot *) rox_memory_allocate ( sizeof ( enum Rox_Frame_Source_Slot ), buffers );
+   ret->free_slots  = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), buffers );
+   ret->ready_slots = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), buffers );
+   ret->ready_index = (Rox_Sint *) rox_memory_allocate ( sizeof ( Rox_Sint ), buffers );
+
+   if ( !ret->pattern || !ret->states || !ret->free_slots || !ret->ready_slots || !ret->ready_index )
+   { rox_frame_source_del ( &ret ); error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   strcpy ( ret->pattern, pattern );
+
+   for ( Rox_Sint k = 0; k < buffers; k++ )
+   {
+      error = rox_image_new ( &ret->images[k], cols, rows );
+      if ( error ) { rox_frame_source_del ( &ret ); ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      // The first images are used first
+      ret->free_slots[k] = buffers - 1 - k;
+      ret->states[k] = Rox_Frame_Source_Slot_Free;
+   }
+   ret->nb_free = buffers;
+
+   *obj = ret;
+
+function_terminate:
+   return error;
+}
+
+static Rox_ErrorCode frame_source_start ( Rox_Frame_Source obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+   if ( pthread_mutex_init ( &obj->mutex, NULL ) )
+   { error = ROX_ERROR_EXTERNAL; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( pthread_cond_init ( &obj->cond_ready, NULL ) )
+   { pthread_mutex_destroy ( &obj->mutex ); error = ROX_ERROR_EXTERNAL; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( pthread_cond_init ( &obj->cond_free, NULL ) )
+   {
+      pthread_cond_destroy ( &obj->cond_ready );
+      pthread_mutex_destroy ( &obj->mutex );
+      error = ROX_ERROR_EXTERNAL; ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   obj->threaded = 1;
+
+   // Without a thread the frames are decoded on demand
+   if ( pthread_create ( &obj->thread, NULL, frame_source_worker, obj ) )
+   {
+      pthread_cond_destroy ( &obj->cond_free );
+      pthread_cond_destroy ( &obj->cond_ready );
+      pthread_mutex_destroy ( &obj->mutex );
+      obj->threaded = 0;
+   }
+#else
+   if ( !obj->is_pgm )
+   {
+      obj->raw = (Rox_Uchar *) rox_memory_allocate ( sizeof ( Rox_Uchar ), (Rox_Size) obj->rows * obj->bytes_per_row );
+      if ( !obj->raw )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
+#endif
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_frame_source_new_pgm (
+   Rox_Frame_Source * obj,
+   const Rox_Char * pattern,
+   const Rox_Sint first,
+   const Rox_Sint last,
+   const Rox_Sint buffers
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source ret = NULL;
+   Rox_Char path[FILENAME_MAX];
+   Rox_Sint rows = 0, cols = 0, max = 0;
+
+   if ( !obj || !pattern )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // The size of the images is given by the first file
+   snprintf ( path, FILENAME_MAX, pattern, first );
+
+   FILE * file = fopen ( path, "rb" );
+   if ( !file )
+   { error = ROX_ERROR_FILE_NOT_FOUND; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_pgm_read_header ( file, &rows, &cols, &max );
+   fclose ( file );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = frame_source_new ( &ret, pattern, first, last, cols, rows, buffers );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   ret->is_pgm = 1;
+   ret->bytes_per_row = cols;
+   ret->format = Rox_Image_Format_Grays;
+
+   error = frame_source_start ( ret );
+   if ( error ) { rox_frame_source_del ( &ret ); ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *obj = ret;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_frame_source_new_raw (
+   Rox_Frame_Source * obj,
+   const Rox_Char * pattern,
+   const Rox_Sint first,
+   const Rox_Sint last,
+   const Rox_Sint cols,
+   const Rox_Sint rows,
+   const Rox_Sint bytes_per_row,
+   const enum Rox_Image_Format format,
+   const Rox_Sint buffers
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source ret = NULL;
+
+   if ( bytes_per_row < cols )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = frame_source_new ( &ret, pattern, first, last, cols, rows, buffers );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   ret->is_pgm = 0;
+   ret->bytes_per_row = bytes_per_row;
+   ret->format = format;
+
+   error = frame_source_start ( ret );
+   if ( error ) { rox_frame_source_del ( &ret ); ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *obj = ret;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_frame_source_del ( Rox_Frame_Source * obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source todel = NULL;
+
+   if ( !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   todel = *obj;
+   *obj = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+   if ( todel->threaded )
+   {
+      pthread_mutex_lock ( &todel->mutex );
+      todel->stop = 1;
+      pthread_cond_broadcast ( &todel->cond_free );
+      pthread_mutex_unlock ( &todel->mutex );
+
+      pthread_join ( todel->thread, NULL );
+
+      pthread_cond_destroy ( &todel->cond_free );
+      pthread_cond_destroy ( &todel->cond_ready );
+      pthread_mutex_destroy ( &todel->mutex );
+   }
+#endif
+
+   if ( todel->images )
+   {
+      for ( Rox_Sint k = 0; k < todel->buffers; k++ )
+      {
+         rox_image_del ( &todel->images[k] );
+      }
+   }
+
+   rox_memory_delete ( todel->raw );
+   rox_memory_delete ( todel->ready_index );
+   rox_memory_delete ( todel->ready_slots );
+   rox_memory_delete ( todel->free_slots );
+   rox_memory_delete ( todel->states );
+   rox_memory_delete ( todel->images );
+   rox_memory_delete ( todel->pattern );
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_frame_source_get_size ( Rox_Sint * rows, Rox_Sint * cols, const Rox_Frame_Source obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !rows || !cols || !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *rows = obj->rows;
+   *cols = obj->cols;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_frame_source_acquire ( Rox_Image * image, Rox_Sint * index, Rox_Frame_Source obj )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !image || !obj )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   frame_source_lock ( obj );
+
+   // Waiting would never end if the caller holds all the images
+   if ( obj->nb_ready == 0 && obj->nb_acquired == obj->buffers )
+   { frame_source_unlock ( obj ); error = ROX_ERROR_FULL_BUFFER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   while ( obj->nb_ready == 0 && !obj->finished )
+   {
+#ifdef ROX_FRAME_SOURCE_POSIX
+      if ( obj->threaded )
+      {
+         pthread_cond_wait ( &obj->cond_ready, &obj->mutex );
+         continue;
+      }
+#endif
+      frame_source_produce ( obj );
+   }
+
+   if ( obj->nb_ready == 0 )
+   {
+      // Reported silently, the end of the sequence is not a failure
+      error = obj->status;
+      frame_source_unlock ( obj );
+      goto function_terminate;
+   }
+
+   Rox_Sint slot = obj->ready_slots[obj->ready_first];
+   if ( index ) *index = obj->ready_index[obj->ready_first];
+
+   obj->ready_first = ( obj->ready_first + 1 ) % obj->buffers;
+   obj->nb_ready--;
+   obj->nb_acquired++;
+   obj->states[slot] = Rox_Frame_Source_Slot_Acquired;
+
+   *image = obj->images[slot];
+
+   frame_source_unlock ( obj );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_frame_source_release ( Rox_Frame_Source obj, Rox_Image image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint slot = -1;
+
+   if ( !obj || !image )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Sint k = 0; k < obj->buffers; k++ )
+   {
+      if ( obj->images[k] == image ) slot = k;
+   }
+
+   if ( slot < 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   frame_source_lock ( obj );
+
+   // Only acquired images can be released, not the free, decoded or decoding ones
+   if ( obj->states[slot] != Rox_Frame_Source_Slot_Acquired )
+   { frame_source_unlock ( obj ); error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   obj->free_slots[obj->nb_free++] = slot;
+   obj->states[slot] = Rox_Frame_Source_Slot_Free;
+   obj->nb_acquired--;
+
+#ifdef ROX_FRAME_SOURCE_POSIX
+   if ( obj->threaded ) pthread_cond_signal ( &obj->cond_free );
+#endif
+
+   frame_source_unlock ( obj );
+
+function_terminate:
+   return error;
+}
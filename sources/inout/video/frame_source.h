@@ -0,0 +1,99 @@
+//==============================================================================
+//
+//    OPENROX   : File frame_source.h
+//
+//    Contents  : API of frame_source module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_FRAME_SOURCE__
+#define __OPENROX_FRAME_SOURCE__
+
+#include <baseproc/image/image.h>
+
+//! \ingroup File
+//! \addtogroup Video
+//! \brief Read image sequences stored on disk
+//! @{
+
+//! Sequence of frames read from numbered files.
+//! Files are mapped in memory and converted to grayscale images by a background thread
+//! (when the platform supports it) while the caller processes the previous frames.
+//! Images are taken from a pool of pre-allocated buffers which is also the bound of the queue of decoded frames.
+typedef struct Rox_Frame_Source_Struct * Rox_Frame_Source;
+
+//! Create a source reading a sequence of binary PGM files.
+//! The image size is given by the first file, all the files must have the same size.
+//! \param  [out]  obj            The created object
+//! \param  [in ]  pattern        The printf-like pattern of the file names with one integer (e.g. "seq/img%04d.pgm")
+//! \param  [in ]  first          The index of the first file
+//! \param  [in ]  last           The index of the last file, -1 to read until a file is missing
+//! \param  [in ]  buffers        The number of images of the pool (at least 2)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_frame_source_new_pgm (
+   Rox_Frame_Source * obj,
+   const Rox_Char * pattern,
+   const Rox_Sint first,
+   const Rox_Sint last,
+   const Rox_Sint buffers
+);
+
+//! Create a source reading a sequence of raw files (e.g. frames dumped from a camera driver).
+//! \param  [out]  obj            The created object
+//! \param  [in ]  pattern        The printf-like pattern of the file names with one integer (e.g. "seq/img%04d.raw")
+//! \param  [in ]  first          The index of the first file
+//! \param  [in ]  last           The index of the last file, -1 to read until a file is missing
+//! \param  [in ]  cols           The image width in pixels
+//! \param  [in ]  rows           The image height in pixels
+//! \param  [in ]  bytes_per_row  The stride of the raw buffers in bytes
+//! \param  [in ]  format         The pixel format of the raw buffers
+//! \param  [in ]  buffers        The number of images of the pool (at least 2)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_frame_source_new_raw (
+   Rox_Frame_Source * obj,
+   const Rox_Char * pattern,
+   const Rox_Sint first,
+   const Rox_Sint last,
+   const Rox_Sint cols,
+   const Rox_Sint rows,
+   const Rox_Sint bytes_per_row,
+   const enum Rox_Image_Format format,
+   const Rox_Sint buffers
+);
+
+//! Stop the background thread and delete the source.
+//! All the acquired images must have been released before.
+//! \param  [out]  obj            The object to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_frame_source_del ( Rox_Frame_Source * obj );
+
+//! Get the size of the images
+//! \param  [out]  rows           The image height in pixels
+//! \param  [out]  cols           The image width in pixels
+//! \param  [in ]  obj            The source
+//! \return An error code
+ROX_API Rox_ErrorCode rox_frame_source_get_size ( Rox_Sint * rows, Rox_Sint * cols, const Rox_Frame_Source obj );
+
+//! Wait for the next frame of the sequence.
+//! The image belongs to the source and must be given back with rox_frame_source_release.
+//! \param  [out]  image          The next image
+//! \param  [out]  index          The index of the file of the image (may be NULL)
+//! \param  [in ]  obj            The source
+//! \return ROX_ERROR_EMPTY_BUFFER at the end of the sequence, an error code otherwise
+ROX_API Rox_ErrorCode rox_frame_source_acquire ( Rox_Image * image, Rox_Sint * index, Rox_Frame_Source obj );
+
+//! Give back an image to the pool of the source
+//! \param  [out]  obj            The source
+//! \param  [in ]  image          An image returned by rox_frame_source_acquire
+//! \return ROX_ERROR_INVALID_VALUE if the image is not owned by the caller, an error code otherwise
+ROX_API Rox_ErrorCode rox_frame_source_release ( Rox_Frame_Source obj, Rox_Image image );
+
+//! @}
+
+#endif
@@ -62,6 +62,17 @@
    #endif
 #endif
 
+//!Declare that this static variable has one instance per thread
+#ifndef ROX_THREAD_LOCAL
+   #if defined(_MSC_VER)
+      #define ROX_THREAD_LOCAL __declspec(thread)
+   #elif defined(__GNUC__)
+      #define ROX_THREAD_LOCAL __thread
+   #else
+      error
+   #endif
+#endif
+
 //!Declare attribute for C++ inclusion
 #ifndef ROX_EXTERN_C
    #ifdef __cplusplus
@@ -0,0 +1,590 @@
+//==============================================================================
+//
+//    OPENROX   : File arena.c
+//
+//    Contents  : Implementation of arena module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include "arena.h"
+#include "memory.h"
+
+#include <string.h>
+#include <inout/system/errors_print.h>
+
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
+
+//=== INTERNAL MACROS    =======================================================
+
+//! The alignment of the allocations (and of their headers)
+#define ROX_ARENA_ALIGNMENT 16
+
+//! Round a size up to the alignment
+#define ROX_ARENA_ALIGN(A) (((A) + ROX_ARENA_ALIGNMENT - 1) & ~((Rox_Size) ROX_ARENA_ALIGNMENT - 1))
+
+//! The size of the header stored before each allocation
+#define ROX_ARENA_HEADER_SIZE ROX_ARENA_ALIGN(sizeof(Rox_Arena_Header_Struct))
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+typedef struct Rox_Arena_Block_Struct Rox_Arena_Block_Struct;
+typedef struct Rox_Arena_Header_Struct Rox_Arena_Header_Struct;
+
+//=== INTERNAL DATATYPES =======================================================
+
+//! A heap block of an arena
+struct Rox_Arena_Block_Struct
+{
+   //! The memory of the block, aligned
+   Rox_Uchar * data;
+   //! The size of the block in bytes
+   Rox_Size size;
+   //! The bytes used in the block
+   Rox_Size used;
+   //! The total size of the blocks before this one
+   Rox_Size offset;
+   //! The next block, kept when the arena is released
+   Rox_Arena_Block_Struct * next;
+};
+
+//! The header of an allocation, it allows to give back the last allocations before the end of a scope
+struct Rox_Arena_Header_Struct
+{
+   //! The previous allocation
+   Rox_Arena_Header_Struct * prev;
+   //! The block of the allocation
+   Rox_Arena_Block_Struct * block;
+   //! The bytes used in the block before the allocation
+   Rox_Size used;
+   //! The size of the allocation in bytes
+   Rox_Size size;
+   //! 1 if the allocation has been deleted
+   Rox_Uint freed;
+};
+
+//! An open scope of a thread arena
+typedef struct Rox_Arena_Scope_Struct
+{
+   //! The position of the arena at the opening
+   Rox_Arena_Mark_Struct mark;
+   //! The floor of the enclosing scope
+   Rox_Arena_Header_Struct * floor;
+   //! The peak of the enclosing scope
+   Rox_Size peak;
+   //! The index of the pipeline, -1 if the statistics table is full
+   Rox_Sint pipeline;
+   //! The OpenMP nesting level at the opening
+   Rox_Sint level;
+} Rox_Arena_Scope_Struct;
+
+//! The statistics of a pipeline
+typedef struct Rox_Arena_Pipeline_Struct
+{
+   //! The name given to rox_arena_scope_begin
+   const char * name;
+   //! The maximal number of bytes used by a scope
+   Rox_Size peak;
+   //! The number of closed scopes
+   Rox_Uint scopes;
+} Rox_Arena_Pipeline_Struct;
+
+struct Rox_Arena_Struct
+{
+   //! The first block
+   Rox_Arena_Block_Struct * first;
+   //! The block in use
+   Rox_Arena_Block_Struct * current;
+   //! The last allocation
+   Rox_Arena_Header_Struct * top;
+   //! The last allocation of the enclosing scope, deletes do not pop it
+   Rox_Arena_Header_Struct * floor;
+   //! The maximal number of bytes used since the creation
+   Rox_Size peak;
+   //! The maximal number of bytes used since the opening of the last scope
+   Rox_Size scope_peak;
+   //! The number of blocks allocated on the heap
+   Rox_Uint heap_allocations;
+   //! The number of open scopes
+   Rox_Uint depth;
+   //! The open scopes
+   Rox_Arena_Scope_Struct scopes[ROX_ARENA_MAX_SCOPES];
+   //! The number of pipelines
+   Rox_Uint pipelines_count;
+   //! The statistics of the pipelines
+   Rox_Arena_Pipeline_Struct pipelines[ROX_ARENA_MAX_PIPELINES];
+};
+
+//=== INTERNAL VARIABLES =======================================================
+
+//! The arena of each thread
+static ROX_THREAD_LOCAL Rox_Arena rox_arena_of_thread = NULL;
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// The blocks are taken directly from the system since rox_memory_allocate may be redirected to the arena itself
+static Rox_Arena_Block_Struct * rox_arena_block_new ( const Rox_Size size )
+{
+   Rox_Uchar * base = (Rox_Uchar *) malloc ( sizeof(Rox_Arena_Block_Struct) + ROX_ARENA_ALIGNMENT + size );
+   if ( !base ) return NULL;
+
+   Rox_Arena_Block_Struct * block = (Rox_Arena_Block_Struct *) base;
+   block->data = (Rox_Uchar *) ROX_ARENA_ALIGN ( (Rox_Size) ( base + sizeof(Rox_Arena_Block_Struct) ) );
+   block->size = size;
+   block->used = 0;
+   block->offset = 0;
+   block->next = NULL;
+
+   return block;
+}
+
+static Rox_Size rox_arena_footprint ( const Rox_Arena arena )
+{
+   return arena->current->offset + arena->current->used;
+}
+
+static void * rox_arena_push ( Rox_Arena arena, const Rox_Size size )
+{
+   Rox_Arena_Block_Struct * block = arena->current;
+   Rox_Size start = ROX_ARENA_ALIGN ( block->used );
+   const Rox_Size need = ROX_ARENA_HEADER_SIZE + size;
+
+   if ( start + need > block->size )
+   {
+      // Continue in the next block, a kept block too small for the request is replaced by a larger one
+      Rox_Arena_Block_Struct * next = block->next;
+
+      if ( next && next->size < need )
+      {
+         block->next = next->next;
+         free ( next );
+         next = NULL;
+      }
+
+      if ( !next )
+      {
+         Rox_Size grown = 2 * block->size;
+         if ( grown < need ) grown = ROX_ARENA_ALIGN ( need );
+
+         next = rox_arena_block_new ( grown );
+         if ( !next ) return NULL;
+
+         next->next = block->next;
+         block->next = next;
+         arena->heap_allocations++;
+      }
+
+      next->offset = block->offset + block->size;
+      next->used = 0;
+      arena->current = block = next;
+      start = 0;
+   }
+
+   Rox_Arena_Header_Struct * header = (Rox_Arena_Header_Struct *) ( block->data + start );
+   header->prev = arena->top;
+   header->block = block;
+   header->used = block->used;
+   header->size = size;
+   header->freed = 0;
+
+   block->used = start + need;
+   arena->top = header;
+
+   const Rox_Size footprint = rox_arena_footprint ( arena );
+   if ( footprint > arena->peak ) arena->peak = footprint;
+   if ( footprint > arena->scope_peak ) arena->scope_peak = footprint;
+
+   return (Rox_Uchar *) header + ROX_ARENA_HEADER_SIZE;
+}
+
+// Give back the deleted allocations on top of the arena, down to the floor of the current scope
+static void rox_arena_pop ( Rox_Arena arena )
+{
+   while ( arena->top != arena->floor && arena->top->freed )
+   {
+      Rox_Arena_Header_Struct * header = arena->top;
+      header->block->used = header->used;
+      arena->current = header->block;
+      arena->top = header->prev;
+   }
+}
+
+static Rox_Arena_Header_Struct * rox_arena_header ( const void * pointer )
+{
+   return (Rox_Arena_Header_Struct *) ( (Rox_Uchar *) pointer - ROX_ARENA_HEADER_SIZE );
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+Rox_ErrorCode rox_arena_new ( Rox_Arena * arena, const Rox_Size size )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Arena ret = NULL;
+
+   if ( !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *arena = NULL;
+
+   if ( size == 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret = (Rox_Arena) rox_memory_allocate ( sizeof(*ret), 1 );
+   if ( !ret )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   memset ( ret, 0, sizeof(*ret) );
+
+   ret->first = rox_arena_block_new ( ROX_ARENA_ALIGN ( size ) );
+   if ( !ret->first )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   ret->current = ret->first;
+   ret->heap_allocations = 1;
+
+   *arena = ret;
+
+function_terminate:
+   if ( error ) rox_arena_del ( &ret );
+   return error;
+}
+
+Rox_ErrorCode rox_arena_del ( Rox_Arena * arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Arena todel = *arena;
+   *arena = NULL;
+
+   if ( !todel )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   Rox_Arena_Block_Struct * block = todel->first;
+   while ( block )
+   {
+      Rox_Arena_Block_Struct * next = block->next;
+      free ( block );
+      block = next;
+   }
+
+   rox_memory_delete ( todel );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_allocate ( void ** pointer, Rox_Arena arena, const Rox_Size size )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !pointer || !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *pointer = NULL;
+
+   if ( size == 0 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *pointer = rox_arena_push ( arena, size );
+   if ( !*pointer )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_mark ( Rox_Arena_Mark mark, const Rox_Arena arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !mark || !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   mark->block = arena->current;
+   mark->used = arena->current->used;
+   mark->top = arena->top;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_release ( Rox_Arena arena, const Rox_Arena_Mark mark )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !mark || !arena || !mark->block )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   arena->current = (Rox_Arena_Block_Struct *) mark->block;
+   arena->current->used = mark->used;
+   arena->top = (Rox_Arena_Header_Struct *) mark->top;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_get_usage ( Rox_Size * used, Rox_Size * peak, Rox_Size * capacity, const Rox_Arena arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !used || !peak || !capacity || !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *used = rox_arena_footprint ( arena );
+   *peak = arena->peak;
+   *capacity = 0;
+
+   for ( Rox_Arena_Block_Struct * block = arena->first; block; block = block->next )
+   {
+      *capacity += block->size;
+   }
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_get_heap_allocations ( Rox_Uint * count, const Rox_Arena arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !count || !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *count = arena->heap_allocations;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_get_pipelines_count ( Rox_Uint * count, const Rox_Arena arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !count || !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *count = arena->pipelines_count;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_get_pipeline ( const char ** name, Rox_Size * peak, Rox_Uint * scopes, const Rox_Arena arena, const Rox_Uint index )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !name || !peak || !scopes || !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( index >= arena->pipelines_count )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   *name = arena->pipelines[index].name;
+   *peak = arena->pipelines[index].peak;
+   *scopes = arena->pipelines[index].scopes;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_get_thread ( Rox_Arena * arena )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !arena )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( !rox_arena_of_thread )
+   {
+      error = rox_arena_new ( &rox_arena_of_thread, ROX_ARENA_DEFAULT_SIZE );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   *arena = rox_arena_of_thread;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_thread_del ( )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !rox_arena_of_thread ) goto function_terminate;
+
+   if ( rox_arena_of_thread->depth > 0 )
+   { error = ROX_ERROR_INVALID; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_arena_del ( &rox_arena_of_thread );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_scope_begin ( const char * pipeline )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Arena arena = NULL;
+
+   if ( !pipeline )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_arena_get_thread ( &arena );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   if ( arena->depth >= ROX_ARENA_MAX_SCOPES )
+   { error = ROX_ERROR_TOO_LARGE_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // Find the statistics of the pipeline
+   Rox_Sint index = -1;
+   for ( Rox_Uint k = 0; k < arena->pipelines_count; k++ )
+   {
+      if ( arena->pipelines[k].name == pipeline || !strcmp ( arena->pipelines[k].name, pipeline ) )
+      {
+         index = k;
+         break;
+      }
+   }
+
+   if ( index < 0 && arena->pipelines_count < ROX_ARENA_MAX_PIPELINES )
+   {
+      index = arena->pipelines_count++;
+      arena->pipelines[index].name = pipeline;
+      arena->pipelines[index].peak = 0;
+      arena->pipelines[index].scopes = 0;
+   }
+
+   Rox_Arena_Scope_Struct * scope = &arena->scopes[arena->depth];
+   rox_arena_mark ( &scope->mark, arena );
+   scope->floor = arena->floor;
+   scope->peak = arena->scope_peak;
+   scope->pipeline = index;
+#ifdef ROX_USES_OPENMP
+   scope->level = omp_get_level ( );
+#else
+   scope->level = 0;
+#endif
+
+   arena->floor = arena->top;
+   arena->scope_peak = rox_arena_footprint ( arena );
+   arena->depth++;
+
+function_terminate:
+   return error;
+}
+
+Rox_ErrorCode rox_arena_scope_end ( )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Arena arena = rox_arena_of_thread;
+
+   if ( !arena || arena->depth == 0 )
+   { error = ROX_ERROR_INVALID; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   arena->depth--;
+   Rox_Arena_Scope_Struct * scope = &arena->scopes[arena->depth];
+
+   if ( scope->pipeline >= 0 )
+   {
+      const Rox_Arena_Block_Struct * block = (const Rox_Arena_Block_Struct *) scope->mark.block;
+      const Rox_Size used = arena->scope_peak - ( block->offset + scope->mark.used );
+
+      Rox_Arena_Pipeline_Struct * stats = &arena->pipelines[scope->pipeline];
+      if ( used > stats->peak ) stats->peak = used;
+      stats->scopes++;
+   }
+
+   rox_arena_release ( arena, &scope->mark );
+   arena->floor = scope->floor;
+   if ( scope->peak > arena->scope_peak ) arena->scope_peak = scope->peak;
+
+function_terminate:
+   return error;
+}
+
+void * rox_arena_thread_allocate ( const Rox_Size size )
+{
+   Rox_Arena arena = rox_arena_of_thread;
+
+   if ( !arena || arena->depth == 0 || size == 0 ) return NULL;
+
+#ifdef ROX_USES_OPENMP
+   // Inside a parallel region opened in the scope, the master thread shares its objects with the team: use the heap
+   if ( omp_get_level ( ) != arena->scopes[arena->depth - 1].level ) return NULL;
+#endif
+
+   return rox_arena_push ( arena, size );
+}
+
+Rox_Bool rox_arena_thread_owns ( const void * pointer )
+{
+   const Rox_Arena arena = rox_arena_of_thread;
+
+   if ( !arena || !pointer ) return 0;
+
+   for ( const Rox_Arena_Block_Struct * block = arena->first; block; block = block->next )
+   {
+      if ( (const Rox_Uchar *) pointer >= block->data && (const Rox_Uchar *) pointer < block->data + block->size ) return 1;
+   }
+
+   return 0;
+}
+
+void * rox_arena_thread_reallocate ( void * pointer, const Rox_Size size )
+{
+   Rox_Arena arena = rox_arena_of_thread;
+   Rox_Arena_Header_Struct * header = rox_arena_header ( pointer );
+   Rox_Arena_Block_Struct * block = header->block;
+
+   // The last allocation grows in place when its block is large enough
+   if ( header == arena->top && block == arena->current )
+   {
+      const Rox_Size start = (Rox_Uchar *) pointer - block->data;
+
+      if ( start + size <= block->size )
+      {
+         header->size = size;
+         block->used = start + size;
+
+         const Rox_Size footprint = rox_arena_footprint ( arena );
+         if ( footprint > arena->peak ) arena->peak = footprint;
+         if ( footprint > arena->scope_peak ) arena->scope_peak = footprint;
+
+         return pointer;
+      }
+   }
+
+   void * moved = rox_arena_push ( arena, size );
+   if ( !moved ) return NULL;
+
+   memcpy ( moved, pointer, header->size < size ? header->size : size );
+   header->freed = 1;
+
+   return moved;
+}
+
+void rox_arena_thread_delete ( void * pointer )
+{
+   Rox_Arena arena = rox_arena_of_thread;
+
+   // Once all the scopes are closed, the memory has already been given back
+   if ( !arena || arena->depth == 0 ) return;
+
+   rox_arena_header ( pointer )->freed = 1;
+   rox_arena_pop ( arena );
+}
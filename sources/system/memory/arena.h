@@ -0,0 +1,170 @@
+//==============================================================================
+//
+//    OPENROX   : File arena.h
+//
+//    Contents  : API of arena module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ARENA__
+#define __OPENROX_ARENA__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <system/arch/compiler.h>
+#include <system/memory/datatypes.h>
+#include <system/errors/errors.h>
+#include <generated/config.h>
+
+//! \ingroup System
+//! @defgroup Arena Arena
+//! \brief Bump pointer scratch memory for the temporaries of the hot functions.
+//! @{
+
+//! The size of the first block of the thread arenas in bytes
+#define ROX_ARENA_DEFAULT_SIZE 65536
+
+//! The maximal number of nested scopes of a thread
+#define ROX_ARENA_MAX_SCOPES 16
+
+//! The maximal number of pipelines whose statistics are kept by an arena
+#define ROX_ARENA_MAX_PIPELINES 32
+
+//! An arena is a chain of heap blocks filled by a bump pointer. The blocks are kept when the arena is released,
+//! so once the arena has grown to the peak need of a pipeline, its allocations do not call the heap anymore.
+typedef struct Rox_Arena_Struct * Rox_Arena;
+
+//! A position in an arena
+struct Rox_Arena_Mark_Struct
+{
+   //! The block in use
+   void * block;
+   //! The bytes used in the block
+   Rox_Size used;
+   //! The last allocation
+   void * top;
+};
+
+//! Define the structure as a value type
+typedef struct Rox_Arena_Mark_Struct Rox_Arena_Mark_Struct;
+
+//! Define the pointer to the structure
+typedef struct Rox_Arena_Mark_Struct * Rox_Arena_Mark;
+
+//! Create a new arena
+//! \param  [out]  arena          The new arena
+//! \param  [in ]  size           The size of the first block in bytes
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_new ( Rox_Arena * arena, const Rox_Size size );
+
+//! Delete an arena and its blocks
+//! \param  [out]  arena          The arena to delete
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_del ( Rox_Arena * arena );
+
+//! Allocate memory aligned on 16 bytes in an arena
+//! \param  [out]  pointer        The allocated memory
+//! \param  [in ]  arena          The arena
+//! \param  [in ]  size           The size in bytes
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_allocate ( void ** pointer, Rox_Arena arena, const Rox_Size size );
+
+//! Store the current position of an arena
+//! \param  [out]  mark           The position
+//! \param  [in ]  arena          The arena
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_mark ( Rox_Arena_Mark mark, const Rox_Arena arena );
+
+//! Free in O(1) all the memory allocated in an arena since a mark
+//! \param  [out]  arena          The arena
+//! \param  [in ]  mark           A position stored by rox_arena_mark, still valid (not released by an older mark)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_release ( Rox_Arena arena, const Rox_Arena_Mark mark );
+
+//! Get the memory usage of an arena
+//! \param  [out]  used           The bytes used (including the unused ends of the previous blocks)
+//! \param  [out]  peak           The maximal number of bytes used since the creation of the arena
+//! \param  [out]  capacity       The total size of the blocks
+//! \param  [in ]  arena          The arena
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_get_usage ( Rox_Size * used, Rox_Size * peak, Rox_Size * capacity, const Rox_Arena arena );
+
+//! Get the number of blocks allocated on the heap by an arena since its creation
+//! \param  [out]  count          The number of heap allocations
+//! \param  [in ]  arena          The arena
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_get_heap_allocations ( Rox_Uint * count, const Rox_Arena arena );
+
+//! Get the number of pipelines which have opened a scope on an arena
+//! \param  [out]  count          The number of pipelines
+//! \param  [in ]  arena          The arena
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_get_pipelines_count ( Rox_Uint * count, const Rox_Arena arena );
+
+//! Get the statistics of a pipeline
+//! \param  [out]  name           The name of the pipeline (the string given to rox_arena_scope_begin)
+//! \param  [out]  peak           The maximal number of bytes used by one scope of the pipeline
+//! \param  [out]  scopes         The number of scopes closed by the pipeline
+//! \param  [in ]  arena          The arena
+//! \param  [in ]  index          The index of the pipeline, lower than the pipelines count
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_get_pipeline ( const char ** name, Rox_Size * peak, Rox_Uint * scopes, const Rox_Arena arena, const Rox_Uint index );
+
+//! Get the arena of the calling thread, created at the first call
+//! \param  [out]  arena          The arena of the thread
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_get_thread ( Rox_Arena * arena );
+
+//! Delete the arena of the calling thread. No scope must be open.
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_thread_del ( );
+
+//! Open a scope on the arena of the calling thread. Until the matching rox_arena_scope_end,
+//! rox_memory_allocate (and thus rox_array2d_*_new, rox_dynvec_*_new, rox_meshgrid2d_*_new...) called by this thread
+//! takes its memory in the arena instead of the heap, except inside the OpenMP parallel regions opened in the scope.
+//! rox_memory_delete of the last allocation gives its memory back immediately, the other ones are given back with it.
+//! The objects created in a scope are temporaries: they must not be kept after rox_arena_scope_end,
+//! and they must be deleted by this thread. Objects created before the scope keep using the heap when they are resized.
+//! \param  [in ]  pipeline       The name of the pipeline for the statistics, a string which must live as long as the arena
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_scope_begin ( const char * pipeline );
+
+//! Close the last scope of the calling thread and free in O(1) all the memory allocated in it
+//! \return An error code
+ROX_API Rox_ErrorCode rox_arena_scope_end ( );
+
+//! Allocate memory in the arena of the calling thread if a scope is open (used by rox_memory_allocate)
+//! \param  [in ]  size           The size in bytes
+//! \return The allocated memory, or NULL if the allocation must be done on the heap
+ROX_API void * rox_arena_thread_allocate ( const Rox_Size size );
+
+//! Test if memory belongs to the arena of the calling thread (used by rox_memory_reallocate and rox_memory_delete)
+//! \param  [in ]  pointer        The memory
+//! \return 1 if the memory was allocated by rox_arena_thread_allocate, 0 otherwise
+ROX_API Rox_Bool rox_arena_thread_owns ( const void * pointer );
+
+//! Resize memory allocated by rox_arena_thread_allocate, in place if it is the last allocation
+//! \param  [in ]  pointer        The memory
+//! \param  [in ]  size           The new size in bytes
+//! \return The resized memory, or NULL if the allocation failed
+ROX_API void * rox_arena_thread_reallocate ( void * pointer, const Rox_Size size );
+
+//! Give back memory allocated by rox_arena_thread_allocate
+//! \param  [in ]  pointer        The memory
+ROX_API void rox_arena_thread_delete ( void * pointer );
+
+//! @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __OPENROX_ARENA__
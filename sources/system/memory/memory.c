@@ -13,12 +13,13 @@
 //==============================================================================
 
 #include "memory.h"
+#include "arena.h"
 #include <string.h>
 #include <limits.h>
 #include <system/errors/errors.h>
 #include <inout/system/memory_print.h>
 
-void * rox_memory_allocate(const Rox_Size element_size, const Rox_Size element_count)
+static void * rox_memory_heap_allocate(const Rox_Size element_size, const Rox_Size element_count)
 {
    void *ret_ptr = NULL;
 
@@ -37,6 +38,18 @@ function_terminate:
    return ret_ptr;
 }
 
+void * rox_memory_allocate(const Rox_Size element_size, const Rox_Size element_count)
+{
+   // Temporaries of an arena scope opened by this thread
+   if ((Rox_Double)element_count * (Rox_Double)element_size < (Rox_Double)SIZE_MAX)
+   {
+      void * ret_ptr = rox_arena_thread_allocate(element_count * element_size);
+      if (ret_ptr) return ret_ptr;
+   }
+
+   return rox_memory_heap_allocate(element_size, element_count);
+}
+
 void * rox_memory_reallocate(void *pointer, const Rox_Size element_size, const Rox_Size element_count)
 {
    void *ret_ptr = NULL;
@@ -46,6 +59,13 @@ void * rox_memory_reallocate(void *pointer, const Rox_Size element_size, const R
    if (element_count * element_size == 0) goto function_terminate;
    if ((Rox_Double)element_count * (Rox_Double)element_size >= (Rox_Double)SIZE_MAX)goto function_terminate;
 
+   // Memory of the thread arena stays in the arena, and heap memory stays on the heap
+   if (rox_arena_thread_owns(pointer))
+   {
+      ret_ptr = rox_arena_thread_reallocate(pointer, element_size * element_count);
+      goto function_terminate;
+   }
+
    // We simply use realloc to reallocate memory
    ret_ptr = realloc(pointer, element_size * element_count);
 
@@ -62,6 +82,12 @@ void rox_memory_delete(void * pointer)
    // Check if pointer is valid
    if (pointer)
    {
+      if (rox_arena_thread_owns(pointer))
+      {
+         rox_arena_thread_delete(pointer);
+         return;
+      }
+
 #ifdef OPENROX_LOGMEMORY
       rox_memory_log_delete(pointer);
 #endif
@@ -117,7 +143,10 @@ void * rox_memory_reallocate_aligned ( void **aligned_adress, void *oldpointer,
    alignment = alignment_bytes - 1;
    // Array allocated is bigger than needed to allow shifting of start pointers for alignment
    total_alloc = element_size * element_count + alignment;
-   base_ptr = rox_memory_allocate(total_alloc, 1);
+
+   // The new array is taken where the old one was
+   if (rox_arena_thread_owns(oldpointer ? oldpointer : oldaligned)) base_ptr = rox_memory_allocate(total_alloc, 1);
+   else base_ptr = rox_memory_heap_allocate(total_alloc, 1);
 
    // Exit if error in allocate
    if (!base_ptr) goto function_terminate;
@@ -13,6 +13,7 @@
 //==============================================================================
 
 #include "memory.h"
+#include "arena.h"
 #include <string.h>
 #include <system/errors/errors.h>
 #include <inout/system/memory_print.h>
@@ -138,7 +139,7 @@ void* next_free(void** blocks_addr, Rox_Bool* blocks_occupation)
    return blocks_addr[i];
 }
 
-void * rox_memory_allocate(const Rox_Size element_size, const Rox_Size element_count)
+static void * rox_memory_pool_allocate(const Rox_Size element_size, const Rox_Size element_count)
 {
    void *ret_ptr = NULL;
 
@@ -282,6 +283,18 @@ function_terminate:
    return ret_ptr;
 }
 
+void * rox_memory_allocate(const Rox_Size element_size, const Rox_Size element_count)
+{
+   // Temporaries of an arena scope opened by this thread
+   if ((Rox_Double)element_count * (Rox_Double)element_size < (Rox_Double)SIZE_MAX)
+   {
+      void * ret_ptr = rox_arena_thread_allocate(element_count * element_size);
+      if (ret_ptr) return ret_ptr;
+   }
+
+   return rox_memory_pool_allocate(element_size, element_count);
+}
+
 void * rox_memory_reallocate(void *pointer, const Rox_Size element_size, const Rox_Size element_count)
 {
    void *ret_ptr = NULL;
@@ -293,6 +306,13 @@ void * rox_memory_reallocate(void *pointer, const Rox_Size element_size, const R
    if (element_count * element_size == 0)goto function_terminate;
    if ((Rox_Double) element_count * (Rox_Double)element_size >= (Rox_Double)SIZE_MAX)goto function_terminate;
 
+   // Memory of the thread arena stays in the arena, and pool memory stays in the pool
+   if (rox_arena_thread_owns(pointer))
+   {
+      ret_ptr = rox_arena_thread_reallocate(pointer, element_size * element_count);
+      goto function_terminate;
+   }
+
    if (!blocks_ready)
    {
       rox_memory_pool_init();
@@ -404,7 +424,7 @@ void * rox_memory_reallocate(void *pointer, const Rox_Size element_size, const R
 #ifdef OPENROX_LOGMEMORY
          rox_memory_log_delete(pointer);
 #endif
-         ret_ptr = rox_memory_allocate(element_size, element_count);
+         ret_ptr = rox_memory_pool_allocate(element_size, element_count);
 
          //if previous block is bigger, copy the new size (rest of data is left behind)
          if (previous_block_size > element_size*element_count)
@@ -437,6 +457,12 @@ void rox_memory_delete(void * pointer)
    // Check if pointer is valid
    if (pointer)
    {
+      if (rox_arena_thread_owns(pointer))
+      {
+         rox_arena_thread_delete(pointer);
+         return;
+      }
+
 #ifdef OPENROX_LOGMEMORY
       rox_memory_log_delete(pointer);
 #endif
@@ -555,7 +581,10 @@ void *rox_memory_reallocate_aligned(void **aligned_adress, void *oldpointer, voi
    alignment = alignment_bytes - 1;
    // Array allocated is bigger than needed to allow shifting of start pointers for alignment
    total_alloc = element_size * element_count + alignment;
-   base_ptr = rox_memory_allocate(total_alloc, 1);
+
+   // The new array is taken where the old one was
+   if (rox_arena_thread_owns(oldpointer)) base_ptr = rox_memory_allocate(total_alloc, 1);
+   else base_ptr = rox_memory_pool_allocate(total_alloc, 1);
 
    // Exit if error in allocate
    if (!base_ptr) goto function_terminate;
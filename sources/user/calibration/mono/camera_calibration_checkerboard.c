@@ -26,6 +26,10 @@
 
 #include <inout/system/errors_print.h>
 
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
+
 Rox_ErrorCode rox_camera_calibration_checkerboard_new (
    Rox_Camera_Calibration_Checkerboard * obj,
    const Rox_Model_CheckerBoard model )
@@ -54,6 +58,7 @@ Rox_ErrorCode rox_camera_calibration_checkerboard_new (
    ret->ref_pts3D       = NULL;
    ret->detected_pts    = NULL;
    ret->checkerdetector = NULL;
+   ret->model           = NULL;
 
    ret->nbpts = model->height * model->width;
 
@@ -84,6 +89,13 @@ Rox_ErrorCode rox_camera_calibration_checkerboard_new (
    error = rox_ident_checkerboard_set_model( ret->checkerdetector, model ); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   // Keep a copy of the model for the detectors of rox_camera_calibration_checkerboard_add_images
+   error = rox_model_checkerboard_new( &ret->model );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_model_checkerboard_set_template( ret->model, model->width, model->height, model->sizx, model->sizy );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    // Define the model
    for (Rox_Sint i = 0; i < model->height; i++ )
    {
@@ -136,6 +148,7 @@ Rox_ErrorCode rox_camera_calibration_checkerboard_del ( Rox_Camera_Calibration_C
    rox_matut3_del( &todel->intrinsics );
    rox_calibration_mono_perspective_del( &todel->calib );
    rox_ident_checkerboard_del( &todel->checkerdetector );
+   rox_model_checkerboard_del( &todel->model );
 
    rox_memory_delete( todel->ref_pts2D );
    rox_memory_delete( todel->detected_pts );
@@ -177,6 +190,107 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_camera_calibration_checkerboard_add_images (
+   Rox_Camera_Calibration_Checkerboard obj,
+   const Rox_Image * images,
+   const Rox_Sint nbimages
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint nbthreads = 1;
+   Rox_Ident_CheckerBoard * detectors = NULL;
+   Rox_Point2D_Double detected = NULL;
+   Rox_ErrorCode * errors = NULL;
+
+   if ( !obj || !images )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if ( nbimages < 1 )
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Sint k = 0; k < nbimages; k++ )
+   {
+      if ( !images[k] )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   }
+
+#ifdef ROX_USES_OPENMP
+   nbthreads = omp_get_max_threads();
+#endif
+   if ( nbthreads > nbimages ) nbthreads = nbimages;
+
+   detectors = ( Rox_Ident_CheckerBoard * ) rox_memory_allocate( sizeof( *detectors ), nbthreads );
+   if ( !detectors )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   for ( Rox_Sint t = 0; t < nbthreads; t++ ) detectors[t] = NULL;
+
+   // The detector of the first thread is the object detector, the others are created with the same model
+   detectors[0] = obj->checkerdetector;
+   for ( Rox_Sint t = 1; t < nbthreads; t++ )
+   {
+      error = rox_ident_checkerboard_new( &detectors[t] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_ident_checkerboard_set_model( detectors[t], obj->model );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   detected = ( Rox_Point2D_Double ) rox_memory_allocate( sizeof( *detected ), obj->nbpts * nbimages );
+   if ( !detected )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   errors = ( Rox_ErrorCode * ) rox_memory_allocate( sizeof( *errors ), nbimages );
+   if ( !errors )
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   // Detect the grids concurrently
+   #ifdef ROX_USES_OPENMP
+   #pragma omp parallel num_threads(nbthreads)
+   #endif
+   {
+      Rox_Sint k = 0, t = 0;
+      #ifdef ROX_USES_OPENMP
+      t = omp_get_thread_num();
+      #pragma omp for schedule(dynamic) private(k)
+      #endif
+      for ( k = 0; k < nbimages; k++ )
+      {
+         errors[k] = rox_ident_checkerboard_make( &detected[k * obj->nbpts], detectors[t], images[k] );
+      }
+   }
+
+   // Add the detected grids in the input order
+   for ( Rox_Sint k = 0; k < nbimages; k++ )
+   {
+      error = errors[k];
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_matsl3_from_n_points_double( obj->G, obj->ref_pts2D, &detected[k * obj->nbpts], obj->nbpts );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_calibration_mono_perspective_add_current_points( obj->calib, &detected[k * obj->nbpts], obj->nbpts );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_calibration_mono_perspective_add_homography( obj->calib, obj->G );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_image_get_size( &obj->image_height, &obj->image_width, images[k] );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+function_terminate:
+   if ( detectors )
+   {
+      for ( Rox_Sint t = 1; t < nbthreads; t++ ) rox_ident_checkerboard_del( &detectors[t] );
+   }
+   rox_memory_delete( detectors );
+   rox_memory_delete( detected );
+   rox_memory_delete( errors );
+
+   return error;
+}
+
 Rox_ErrorCode rox_camera_calibration_checkerboard_add_points(
    Rox_Camera_Calibration_Checkerboard obj,
    const Rox_Sint n_points,
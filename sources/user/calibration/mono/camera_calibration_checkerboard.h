@@ -62,6 +62,9 @@ struct Rox_Camera_Calibration_Checkerboard_Struct
 
    //! The checkerboard detector
    Rox_Ident_CheckerBoard checkerdetector;
+
+   //! A copy of the checkerboard model, used to create the detectors of the batched detection
+   Rox_Model_CheckerBoard model;
 };
 
 //! Define the pointer of the rox_camera_calibration_checkerboard_Struct 
@@ -95,6 +98,21 @@ ROX_API Rox_ErrorCode rox_camera_calibration_checkerboard_add_image (
    const Rox_Image image
 );
 
+//! Add a set of images to the calibration set.
+//! The grids are detected concurrently (one detector per thread),
+//! then the images are added in the given order as with rox_camera_calibration_checkerboard_add_image.
+//! The detection is a batch step: the refinement of rox_camera_calibration_checkerboard_make needs all the views and runs after it.
+//! If a detection fails, the images preceding it are added and its error is returned.
+//! \param  [out]  calibration    Calibration object
+//! \param  [in ]  images         Calibration images with a visible grid
+//! \param  [in ]  nbimages       Number of images
+//! \return An error code
+ROX_API Rox_ErrorCode rox_camera_calibration_checkerboard_add_images (
+   Rox_Camera_Calibration_Checkerboard calibration, 
+   const Rox_Image * images,
+   const Rox_Sint nbimages
+);
+
 //! Add externally detected points to the calibration set
 //! \param [in]  calibration      Calibration object
 //! \param [in]  n_points         number of points externally detected
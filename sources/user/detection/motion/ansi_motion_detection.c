@@ -0,0 +1,92 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_motion_detection.c
+//
+//    Contents  : Implementation of ansi_motion_detection module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_motion_detection.h"
+
+int rox_ansi_motion_difference_row (
+   float * difference,
+   const unsigned char * model,
+   const unsigned char * image,
+   int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      difference[j] = (float) ( (int) model[j] - (int) image[j] );
+   }
+
+   return 0;
+}
+
+int rox_ansi_motion_threshold_row (
+   unsigned char * binary,
+   const float * values,
+   float threshold,
+   int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      const float value = values[j] < 0.0f ? -values[j] : values[j];
+      binary[j] = ( value > threshold ) ? 255 : 0;
+   }
+
+   return 0;
+}
+
+int rox_ansi_motion_erode3x3_row (
+   unsigned char * eroded,
+   const unsigned char * above,
+   const unsigned char * row,
+   const unsigned char * below,
+   int cols
+)
+{
+   for ( int j = 1; j < cols - 1; j++ )
+   {
+      unsigned char value = row[j];
+
+      for ( int k = j - 1; k <= j + 1; k++ )
+      {
+         if ( above[k] < value ) value = above[k];
+         if ( row[k] < value ) value = row[k];
+         if ( below[k] < value ) value = below[k];
+      }
+
+      eroded[j] = value;
+   }
+
+   eroded[0] = 0;
+   if ( cols > 1 ) eroded[cols - 1] = 0;
+
+   return 0;
+}
+
+int rox_ansi_motion_model_update_row (
+   unsigned char * model,
+   const unsigned char * image,
+   const unsigned char * motion,
+   int cols
+)
+{
+   for ( int j = 0; j < cols; j++ )
+   {
+      if ( motion[j] ) continue;
+
+      if ( image[j] > model[j] ) model[j]++;
+      else if ( image[j] < model[j] ) model[j]--;
+   }
+
+   return 0;
+}
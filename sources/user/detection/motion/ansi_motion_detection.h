@@ -0,0 +1,60 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_motion_detection.h
+//
+//    Contents  : API of ansi_motion_detection module
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#ifndef __OPENROX_ANSI_MOTION_DETECTION__
+#define __OPENROX_ANSI_MOTION_DETECTION__
+
+#include <system/arch/compiler.h>
+#include <system/arch/platform.h>
+#include <generated/config.h>
+
+// Row kernels of the motion detection: each call processes one row of cols pixels.
+// The SSE versions give the same results as the scalar ones.
+
+// Difference model - image of gray levels
+ROX_API int rox_ansi_motion_difference_row (
+   float * difference,
+   const unsigned char * model,
+   const unsigned char * image,
+   int cols
+);
+
+// 255 where the absolute value is above the threshold, 0 elsewhere
+ROX_API int rox_ansi_motion_threshold_row (
+   unsigned char * binary,
+   const float * values,
+   float threshold,
+   int cols
+);
+
+// Erosion of a binary row with a 3x3 square: minimum of the rows above, at and below,
+// the first and last pixels are set to 0
+ROX_API int rox_ansi_motion_erode3x3_row (
+   unsigned char * eroded,
+   const unsigned char * above,
+   const unsigned char * row,
+   const unsigned char * below,
+   int cols
+);
+
+// Approximate median background: the model moves by one gray level towards the image,
+// except on the pixels detected as moving
+ROX_API int rox_ansi_motion_model_update_row (
+   unsigned char * model,
+   const unsigned char * image,
+   const unsigned char * motion,
+   int cols
+);
+
+#endif // __OPENROX_ANSI_MOTION_DETECTION__
@@ -0,0 +1,157 @@
+//==============================================================================
+//
+//    OPENROX   : File ansi_motion_detection_sse.c
+//
+//    Contents  : Implementation of ansi_motion_detection module with SSE optimisation
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+#include "ansi_motion_detection.h"
+#include <system/vectorisation/sse.h>
+
+// The vector paths process 16 pixels per iteration, the remaining pixels are scalar.
+
+int rox_ansi_motion_difference_row (
+   float * difference,
+   const unsigned char * model,
+   const unsigned char * image,
+   int cols
+)
+{
+   const __m128i zero = _mm_setzero_si128 ( );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      const __m128i m = _mm_loadu_si128 ( (const __m128i *) ( model + j ) );
+      const __m128i i = _mm_loadu_si128 ( (const __m128i *) ( image + j ) );
+
+      // Differences of 16 bits integers, exact in [-255, 255]
+      const __m128i lo = _mm_sub_epi16 ( _mm_unpacklo_epi8 ( m, zero ), _mm_unpacklo_epi8 ( i, zero ) );
+      const __m128i hi = _mm_sub_epi16 ( _mm_unpackhi_epi8 ( m, zero ), _mm_unpackhi_epi8 ( i, zero ) );
+
+      // Sign extension to 32 bits
+      _mm_storeu_ps ( difference + j,      _mm_cvtepi32_ps ( _mm_srai_epi32 ( _mm_unpacklo_epi16 ( lo, lo ), 16 ) ) );
+      _mm_storeu_ps ( difference + j + 4,  _mm_cvtepi32_ps ( _mm_srai_epi32 ( _mm_unpackhi_epi16 ( lo, lo ), 16 ) ) );
+      _mm_storeu_ps ( difference + j + 8,  _mm_cvtepi32_ps ( _mm_srai_epi32 ( _mm_unpacklo_epi16 ( hi, hi ), 16 ) ) );
+      _mm_storeu_ps ( difference + j + 12, _mm_cvtepi32_ps ( _mm_srai_epi32 ( _mm_unpackhi_epi16 ( hi, hi ), 16 ) ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      difference[j] = (float) ( (int) model[j] - (int) image[j] );
+   }
+
+   return 0;
+}
+
+int rox_ansi_motion_threshold_row (
+   unsigned char * binary,
+   const float * values,
+   float threshold,
+   int cols
+)
+{
+   const __m128 abs_mask = _mm_castsi128_ps ( _mm_set1_epi32 ( 0x7FFFFFFF ) );
+   const __m128 t = _mm_set1_ps ( threshold );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      // Comparison masks are all ones (-1) or zero, packed with saturation to 0xFF or 0
+      const __m128i c0 = _mm_castps_si128 ( _mm_cmpgt_ps ( _mm_and_ps ( _mm_loadu_ps ( values + j      ), abs_mask ), t ) );
+      const __m128i c1 = _mm_castps_si128 ( _mm_cmpgt_ps ( _mm_and_ps ( _mm_loadu_ps ( values + j + 4  ), abs_mask ), t ) );
+      const __m128i c2 = _mm_castps_si128 ( _mm_cmpgt_ps ( _mm_and_ps ( _mm_loadu_ps ( values + j + 8  ), abs_mask ), t ) );
+      const __m128i c3 = _mm_castps_si128 ( _mm_cmpgt_ps ( _mm_and_ps ( _mm_loadu_ps ( values + j + 12 ), abs_mask ), t ) );
+
+      _mm_storeu_si128 ( (__m128i *) ( binary + j ), _mm_packs_epi16 ( _mm_packs_epi32 ( c0, c1 ), _mm_packs_epi32 ( c2, c3 ) ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      const float value = values[j] < 0.0f ? -values[j] : values[j];
+      binary[j] = ( value > threshold ) ? 255 : 0;
+   }
+
+   return 0;
+}
+
+int rox_ansi_motion_erode3x3_row (
+   unsigned char * eroded,
+   const unsigned char * above,
+   const unsigned char * row,
+   const unsigned char * below,
+   int cols
+)
+{
+   int j = 1;
+   for ( ; j + 17 <= cols; j += 16 )
+   {
+      // Vertical minimum at the columns j - 1, j and j + 1
+      const __m128i l = _mm_min_epu8 ( _mm_min_epu8 ( _mm_loadu_si128 ( (const __m128i *) ( above + j - 1 ) ), _mm_loadu_si128 ( (const __m128i *) ( row + j - 1 ) ) ), _mm_loadu_si128 ( (const __m128i *) ( below + j - 1 ) ) );
+      const __m128i c = _mm_min_epu8 ( _mm_min_epu8 ( _mm_loadu_si128 ( (const __m128i *) ( above + j     ) ), _mm_loadu_si128 ( (const __m128i *) ( row + j     ) ) ), _mm_loadu_si128 ( (const __m128i *) ( below + j     ) ) );
+      const __m128i r = _mm_min_epu8 ( _mm_min_epu8 ( _mm_loadu_si128 ( (const __m128i *) ( above + j + 1 ) ), _mm_loadu_si128 ( (const __m128i *) ( row + j + 1 ) ) ), _mm_loadu_si128 ( (const __m128i *) ( below + j + 1 ) ) );
+
+      _mm_storeu_si128 ( (__m128i *) ( eroded + j ), _mm_min_epu8 ( _mm_min_epu8 ( l, c ), r ) );
+   }
+
+   for ( ; j < cols - 1; j++ )
+   {
+      unsigned char value = row[j];
+
+      for ( int k = j - 1; k <= j + 1; k++ )
+      {
+         if ( above[k] < value ) value = above[k];
+         if ( row[k] < value ) value = row[k];
+         if ( below[k] < value ) value = below[k];
+      }
+
+      eroded[j] = value;
+   }
+
+   eroded[0] = 0;
+   if ( cols > 1 ) eroded[cols - 1] = 0;
+
+   return 0;
+}
+
+int rox_ansi_motion_model_update_row (
+   unsigned char * model,
+   const unsigned char * image,
+   const unsigned char * motion,
+   int cols
+)
+{
+   const __m128i zero = _mm_setzero_si128 ( );
+   const __m128i one = _mm_set1_epi8 ( 1 );
+
+   int j = 0;
+   for ( ; j + 16 <= cols; j += 16 )
+   {
+      const __m128i m = _mm_loadu_si128 ( (const __m128i *) ( model + j ) );
+      const __m128i i = _mm_loadu_si128 ( (const __m128i *) ( image + j ) );
+      const __m128i still = _mm_cmpeq_epi8 ( _mm_loadu_si128 ( (const __m128i *) ( motion + j ) ), zero );
+
+      // Steps of one gray level: the saturated differences are non zero only in their direction
+      const __m128i up = _mm_and_si128 ( _mm_min_epu8 ( _mm_subs_epu8 ( i, m ), one ), still );
+      const __m128i down = _mm_and_si128 ( _mm_min_epu8 ( _mm_subs_epu8 ( m, i ), one ), still );
+
+      _mm_storeu_si128 ( (__m128i *) ( model + j ), _mm_sub_epi8 ( _mm_add_epi8 ( m, up ), down ) );
+   }
+
+   for ( ; j < cols; j++ )
+   {
+      if ( motion[j] ) continue;
+
+      if ( image[j] > model[j] ) model[j]++;
+      else if ( image[j] < model[j] ) model[j]--;
+   }
+
+   return 0;
+}
@@ -15,13 +15,16 @@
 #include "cluster.h"
 #include "cluster_struct.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <generated/array2d_sint.h>
 
 #include <system/memory/memory.h>
 
+#include <baseproc/maths/maths_macros.h>
 #include <baseproc/array/fill/fillval.h>
+#include <baseproc/geometry/connectivity/unionfind.h>
 
 #include <inout/system/errors_print.h>
 
@@ -41,6 +44,9 @@ Rox_ErrorCode rox_cluster_new ( Rox_Cluster * cluster )
    }
    
    ret->count = 0;
+   ret->parent = NULL;
+   ret->order = NULL;
+   ret->allocated = 0;
    ret->bounds = (Rox_Sint *) rox_memory_allocate(4*ROX_MAX_CLUSTER*sizeof(Rox_Sint), 1);
    if(ret->bounds == 0)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -64,6 +70,8 @@ Rox_Void rox_cluster_del ( Rox_Cluster * cluster )
       if(todel != 0)
       {
          rox_memory_delete(todel->bounds);
+         rox_memory_delete(todel->parent);
+         rox_memory_delete(todel->order);
          rox_memory_delete(todel);
       }
    }
@@ -314,4 +322,113 @@ Rox_ErrorCode rox_cluster_binary ( Rox_Cluster cluster, Rox_Image source, Rox_Si
 function_terminate:
       rox_array2d_sint_del(&modes);
       return error;
-}
\ No newline at end of file
+}
+
+static int rox_cluster_compare_order ( const void * a, const void * b )
+{
+   const Rox_Ulint ka = *(const Rox_Ulint *) a;
+   const Rox_Ulint kb = *(const Rox_Ulint *) b;
+
+   return ( ka > kb ) - ( ka < kb );
+}
+
+Rox_ErrorCode rox_cluster_binary_components ( Rox_Cluster cluster, Rox_Connected_Components ccl, const Rox_Image image, const Rox_Sint bandwidth[2] )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uint count = 0;
+   Rox_Uint * index = NULL;
+
+   if (!cluster || !cluster->bounds || !ccl || !image || !bandwidth)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   error = rox_connected_components_make ( ccl, image, 8 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   count = ccl->count;
+   cluster->count = 0;
+
+   if ( count > cluster->allocated )
+   {
+      rox_memory_delete ( cluster->parent );
+      rox_memory_delete ( cluster->order );
+      cluster->order = NULL;
+      cluster->allocated = 0;
+
+      // The parents are followed by the cluster index of each root
+      cluster->parent = (Rox_Uint *) rox_memory_allocate ( sizeof ( Rox_Uint ), 2 * (Rox_Size) count );
+      if ( !cluster->parent )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      cluster->order = (Rox_Ulint *) rox_memory_allocate ( sizeof ( Rox_Ulint ), count );
+      if ( !cluster->order )
+      { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+      cluster->allocated = count;
+   }
+
+   index = cluster->parent + count;
+
+   for ( Rox_Uint k = 0; k < count; k++ )
+   {
+      cluster->parent[k] = k;
+      cluster->order[k] = ( (Rox_Ulint) ccl->components[k].u_min << 32 ) | k;
+   }
+
+   if ( count > 1 ) qsort ( cluster->order, count, sizeof ( Rox_Ulint ), rox_cluster_compare_order );
+
+   // The components separated by less than the bandwidth along both axes belong to the same cluster.
+   // Sweep along the columns : once a box starts too far after the end of the current one, so do the next ones.
+   // The roots are the lowest indices whatever the order of the unions, so the clusters do not depend on the sweep.
+   for ( Rox_Uint p = 0; p < count; p++ )
+   {
+      const Rox_Uint i = (Rox_Uint) ( cluster->order[p] & 0xFFFFFFFF );
+      const Rox_Connected_Component_Struct * a = &ccl->components[i];
+
+      for ( Rox_Uint q = p + 1; q < count; q++ )
+      {
+         const Rox_Uint j = (Rox_Uint) ( cluster->order[q] & 0xFFFFFFFF );
+         const Rox_Connected_Component_Struct * b = &ccl->components[j];
+
+         if ( b->u_min - a->u_max > bandwidth[1] ) break;
+
+         const Rox_Sint gap_v = ROX_MAX ( a->v_min, b->v_min ) - ROX_MIN ( a->v_max, b->v_max );
+         const Rox_Sint gap_u = ROX_MAX ( a->u_min, b->u_min ) - ROX_MIN ( a->u_max, b->u_max );
+
+         if ( gap_v <= bandwidth[0] && gap_u <= bandwidth[1] ) rox_unionfind_union ( cluster->parent, i, j );
+      }
+   }
+
+   // The clusters are numbered in the order of their first component, the roots come first
+   for ( Rox_Uint k = 0; k < count; k++ )
+   {
+      const Rox_Connected_Component_Struct * component = &ccl->components[k];
+      const Rox_Uint root = rox_unionfind_find ( cluster->parent, k );
+      Rox_Sint * bounds = NULL;
+
+      if ( root == k )
+      {
+         if ( cluster->count >= ROX_MAX_CLUSTER ) { index[k] = ROX_MAX_CLUSTER; continue; }
+
+         index[k] = cluster->count++;
+         bounds = &cluster->bounds[4 * index[k]];
+
+         bounds[0] = component->u_min;
+         bounds[1] = component->v_min;
+         bounds[2] = component->u_max;
+         bounds[3] = component->v_max;
+         continue;
+      }
+
+      if ( index[root] >= ROX_MAX_CLUSTER ) continue;
+
+      bounds = &cluster->bounds[4 * index[root]];
+
+      if ( component->u_min < bounds[0] ) bounds[0] = component->u_min;
+      if ( component->v_min < bounds[1] ) bounds[1] = component->v_min;
+      if ( component->u_max > bounds[2] ) bounds[2] = component->u_max;
+      if ( component->v_max > bounds[3] ) bounds[3] = component->v_max;
+   }
+
+function_terminate:
+   return error;
+}
@@ -22,6 +22,7 @@ extern "C" {
 // ====== INCLUDED HEADERS   ================================================
 
 #include <baseproc/image/image.h>
+#include <baseproc/geometry/connectivity/connected_components.h>
 
 // ====== EXPORTED TYPESDEFS ================================================
 
@@ -83,6 +84,16 @@ ROX_API Rox_Sint * rox_cluster_get_bounds(Rox_Cluster cluster);
 //! \return Success
 ROX_API Rox_ErrorCode rox_cluster_binary(Rox_Cluster cluster, Rox_Image image, Rox_Sint bandwidth[2]);
 
+//! \ingroup Cluster
+//! \brief Determine clusters of binary image by labelling its connected components (union-find),
+//! then grouping the components whose bounding boxes are closer than the bandwidth
+//! \param[out] cluster Cluster instance
+//! \param[out] ccl Connected components object of the image size, reused between calls
+//! \param[in]  image Binary image
+//! \param[in]  bandwidth Largest gap between the boxes of a cluster, along the rows then the columns as in #rox_cluster_binary
+//! \return Success
+ROX_API Rox_ErrorCode rox_cluster_binary_components(Rox_Cluster cluster, Rox_Connected_Components ccl, const Rox_Image image, const Rox_Sint bandwidth[2]);
+
 // ====== INTERNAL FUNCTIONS =================================================
 
 #ifdef __cplusplus
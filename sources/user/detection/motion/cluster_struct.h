@@ -34,6 +34,15 @@ struct Rox_Cluster_Struct
      
 	//! Bounds of each cluster 
    Rox_Sint * bounds; 
+
+   //! Union-find parents of the connected components, then their cluster indices, reused between calls
+   Rox_Uint * parent;
+
+   //! Connected components sorted by their first column (first column in the high bits, index in the low bits)
+   Rox_Ulint * order;
+
+   //! Number of connected components the parents can hold
+   Rox_Uint allocated;
 };
 
 #ifdef __cplusplus
@@ -26,8 +26,9 @@
 #include <baseproc/maths/kernels/gaussian2d.h>
 #include <baseproc/image/convolve/array2d_float_symmetric_separable_convolve.h>
 #include <baseproc/array/fill/fillval.h>
-#include <baseproc/array/substract/substract.h>
-#include <baseproc/array/conversion/array2d_uchar_from_float.h>
+#include <baseproc/geometry/connectivity/connected_components.h>
+
+#include <user/detection/motion/ansi_motion_detection.h>
 
 #include <inout/system/errors_print.h>
 
@@ -48,6 +49,31 @@ struct Rox_Detection_Motion_Params_Struct
    Rox_Uchar sensitivity;
 };
 
+//! \ingroup Detection_Motion
+//! \brief Workspace of a region processed independently of the others
+struct Rox_Detection_Motion_Region_Struct
+{
+   //! Window of the mask, clipped to the image
+   Rox_Rect_Sint_Struct window;
+   //! Window with a margin for the filtering and the erosion, clipped to the image
+   Rox_Rect_Sint_Struct area;
+   //! The mask must be applied (user defined mask)
+   Rox_Sint masked;
+   //! Difference between the model and the image on the area
+   Rox_Array2D_Float difference;
+   //! Filtered difference
+   Rox_Array2D_Float filtered;
+   //! Thresholded difference
+   Rox_Image binary;
+   //! Eroded threshold: the moving pixels
+   Rox_Image moving;
+   //! Error of the last processing
+   Rox_ErrorCode error;
+};
+
+//! Define the Rox_Detection_Motion_Region_Struct type
+typedef struct Rox_Detection_Motion_Region_Struct Rox_Detection_Motion_Region_Struct;
+
 //! \ingroup Detection_Motion
 //! \brief Motion detection structure
 struct Rox_Detection_Motion_Struct
@@ -65,16 +91,30 @@ struct Rox_Detection_Motion_Struct
 
    //! model image
    Rox_Image     model;
-   //! To be commented
-   Rox_Array2D_Float     Id;
-   //! Current image
+   //! Moving pixels of the last processed image (255), 0 elsewhere
    Rox_Image     Ic;
    //! To be commented
    Rox_Imask      M;
-   //! To be commented
+   //! Clusters of the moving pixels
    Rox_Cluster      cluster;
-   //! To be commented
+   //! Connected components of the moving pixels
+   Rox_Connected_Components ccl;
+   //! Windows of the mask, empty if the mask is user defined
    Rox_DynVec_Rect_Sint  windows;
+   //! Horizontal gaussian filter
+   Rox_Array2D_Float hfilter;
+   //! Vertical gaussian filter
+   Rox_Array2D_Float vfilter;
+   //! Processed regions, one per window or the whole image
+   Rox_Detection_Motion_Region_Struct * regions;
+   //! Number of processed regions
+   Rox_Sint count_regions;
+   //! The regions must be rebuilt after a change of the mask
+   Rox_Sint regions_dirty;
+   //! Number of processed images between two updates of the model, 0 for a fixed model
+   Rox_Sint adaptation_period;
+   //! Number of processed images since the last update of the model
+   Rox_Sint adaptation_frames;
 };
 
 Rox_ErrorCode
@@ -83,12 +123,6 @@ rox_points2d_get_center_rect(Rox_DynVec_Point2D_Float center_list, Rox_DynVec_Re
 Rox_ErrorCode
 rox_rect_list_set_cluster(Rox_DynVec_Rect_Sint list, Rox_Cluster cluster);
 
-Rox_ErrorCode
-rox_array2d_float_erode(Rox_Array2D_Float output, Rox_Array2D_Float input, Rox_Float threshold);
-
-Rox_ErrorCode
-rox_array2d_uchar_apply_mask(Rox_Image out, Rox_Imask mask);
-
 Rox_ErrorCode
 rox_array2d_uint_set_ones_rectangle(Rox_Imask mask, Rox_Sint posu, Rox_Sint posv, Rox_Sint sizu, Rox_Sint sizv);
 
@@ -113,136 +147,210 @@ Rox_ErrorCode rox_points2d_get_center_rect(Rox_DynVec_Point2D_Float center_list,
    return error;
 }
 
-Rox_ErrorCode rox_array2d_float_erode(Rox_Array2D_Float output, Rox_Array2D_Float input, Rox_Float threshold)
+Rox_ErrorCode rox_array2d_uint_set_ones_rectangle(Rox_Imask mask, Rox_Sint posu, Rox_Sint posv, Rox_Sint sizu, Rox_Sint sizv)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
 
-   if (!output || !input)
+   if (mask == NULL)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   if (threshold < 0 || threshold > 1)
-   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
-
-   error = rox_array2d_float_match_size(output, input);
+   Rox_Sint cols = 0, rows = 0;
+   error = rox_array2d_uint_get_size(&rows, &cols, mask);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Sint rows = 0, cols = 0;
-   error = rox_array2d_float_get_size(&rows, &cols, input);
+   Rox_Uint ** mask_data = NULL;
+   error = rox_array2d_uint_get_data_pointer_to_pointer(&mask_data, mask);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Float ** inp_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &inp_data, input);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   if (posu > cols || posv > rows)
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   Rox_Float ** out_data = NULL;
-   error = rox_array2d_float_get_data_pointer_to_pointer( &out_data, output);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // Fill mask, the rectangles of a list are accumulated
+   Rox_Sint end_cols = posu + sizu;
+   Rox_Sint end_rows = posv + sizv;
 
-   Rox_Float s = threshold * 255.0f;
-   for ( Rox_Sint r = 1; r < rows-1; r++)
+   if(end_cols > cols) end_cols = cols;
+   if(end_rows > rows) end_rows = rows;
+   if(posu < 0) posu = 0;
+   if(posv < 0) posv = 0;
+
+   for ( Rox_Sint r = posv; r < end_rows; r++)
    {
-      for ( Rox_Sint c = 1; c < cols-1; c++)
+      for ( Rox_Sint c = posu; c < end_cols; c++)
       {
-         if(   (fabs(inp_data[r-1][c-1])>s) && (fabs(inp_data[r-1][c])>s) && (fabs(inp_data[r-1][c+1])>s)
-            && (fabs(inp_data[r][c-1])>s)   && (fabs(inp_data[r][c])>s)   && (fabs(inp_data[r][c+1])>s)
-            && (fabs(inp_data[r+1][c-1])>s) && (fabs(inp_data[r+1][c])>s) && (fabs(inp_data[r+1][c+1])>s))
-         {
-            out_data[r][c] = 255.0;
-         }
-         else
-         {
-            out_data[r][c] = 0.0;
-         }
+         mask_data[r][c] = ~0;
       }
    }
 
-   // Fill first and last rows with 0
-   memset(out_data[0], 0, cols * sizeof(Rox_Float));
-   memset(out_data[rows-1], 0, cols * sizeof(Rox_Float));
+function_terminate:
+   return error;
+}
 
-   // Fill first and last cols with 0
-   for ( Rox_Sint r = 0; r < rows; r++)
+static Rox_Void rox_detection_motion_regions_del(Rox_Detection_Motion motion)
+{
+   if (!motion->regions) return;
+
+   for ( Rox_Sint k = 0; k < motion->count_regions; k++)
    {
-      out_data[r][0] = 0.0;
-      out_data[r][cols -1] = 0.0;
+      Rox_Detection_Motion_Region_Struct * region = &motion->regions[k];
+
+      rox_array2d_float_del(&region->difference);
+      rox_array2d_float_del(&region->filtered);
+      rox_array2d_uchar_del(&region->binary);
+      rox_array2d_uchar_del(&region->moving);
    }
 
-function_terminate:
-   return error;
+   rox_memory_delete(motion->regions);
+   motion->regions = NULL;
+   motion->count_regions = 0;
 }
 
-Rox_ErrorCode rox_array2d_uchar_apply_mask(Rox_Image out, Rox_Imask mask)
+static Rox_ErrorCode rox_detection_motion_regions_make(Rox_Detection_Motion motion)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint rows = 0, cols = 0;
+   Rox_Sint krows = 0, kcols = 0;
+   Rox_Sint count = 0;
 
-   if(!out || !mask)
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   rox_detection_motion_regions_del(motion);
 
-   error = rox_array2d_match_size((Rox_Array2D)out, (Rox_Array2D)mask);
+   error = rox_array2d_uchar_get_size(&rows, &cols, motion->model);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Sint cols = 0, rows = 0;
-
-   error = rox_array2d_uchar_get_size(&rows, &cols, out);
+   error = rox_array2d_float_get_size(&krows, &kcols, motion->hfilter);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uchar ** data_out = NULL;
-   error = rox_array2d_uchar_get_data_pointer_to_pointer ( &data_out, out);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // The filtered differences are exact in the windows if the area also holds
+   // the half kernel and the neighbours of the erosion
+   const Rox_Sint margin = kcols / 2 + 1;
 
-   Rox_Uint ** data_mask = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer ( &data_mask, mask);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // One region per window, or the whole image if the mask is user defined
+   count = motion->windows->used > 0 ? (Rox_Sint) motion->windows->used : 1;
 
-   if(!data_out || !data_mask)
+   motion->regions = (Rox_Detection_Motion_Region_Struct *) rox_memory_allocate(sizeof(Rox_Detection_Motion_Region_Struct), count);
+   if (!motion->regions)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   for ( Rox_Sint i = 0; i < rows; i++)
+   memset(motion->regions, 0, count * sizeof(Rox_Detection_Motion_Region_Struct));
+   motion->count_regions = count;
+
+   for ( Rox_Sint k = 0; k < count; k++)
    {
-      for ( Rox_Sint j = 0; j < cols; j++)
+      Rox_Detection_Motion_Region_Struct * region = &motion->regions[k];
+      Rox_Sint u0 = 0, v0 = 0, u1 = cols, v1 = rows;
+
+      if (motion->windows->used > 0)
+      {
+         const Rox_Rect_Sint_Struct * window = &motion->windows->data[k];
+
+         u0 = ROX_MAX(window->x, 0);
+         v0 = ROX_MAX(window->y, 0);
+         u1 = ROX_MIN(window->x + window->width, cols);
+         v1 = ROX_MIN(window->y + window->height, rows);
+      }
+      else
       {
-         if(data_mask[i][j] == 0) data_out[i][j] = 0;
+         region->masked = 1;
       }
+
+      // Windows outside the image are not processed
+      if (u1 <= u0 || v1 <= v0) continue;
+
+      region->window.x = u0;
+      region->window.y = v0;
+      region->window.width = u1 - u0;
+      region->window.height = v1 - v0;
+
+      region->area.x = ROX_MAX(u0 - margin, 0);
+      region->area.y = ROX_MAX(v0 - margin, 0);
+      region->area.width = ROX_MIN(u1 + margin, cols) - region->area.x;
+      region->area.height = ROX_MIN(v1 + margin, rows) - region->area.y;
+
+      error = rox_array2d_float_new(&region->difference, region->area.height, region->area.width);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_float_new(&region->filtered, region->area.height, region->area.width);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_uchar_new(&region->binary, region->area.height, region->area.width);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_array2d_uchar_new(&region->moving, region->area.height, region->area.width);
+      ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
+   motion->regions_dirty = 0;
+
 function_terminate:
+   if (error != ROX_ERROR_NONE) rox_detection_motion_regions_del(motion);
    return error;
 }
 
-Rox_ErrorCode rox_array2d_uint_set_ones_rectangle(Rox_Imask mask, Rox_Sint posu, Rox_Sint posv, Rox_Sint sizu, Rox_Sint sizv)
+static Rox_ErrorCode rox_detection_motion_region_process (
+   Rox_Detection_Motion_Region_Struct * region,
+   Rox_Array2D_Float hfilter,
+   Rox_Uchar ** model_data,
+   Rox_Uchar ** image_data,
+   Rox_Uint ** mask_data,
+   const Rox_Float threshold
+)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
 
-   if (mask == NULL)
-   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   const Rox_Sint u0 = region->area.x;
+   const Rox_Sint v0 = region->area.y;
+   const Rox_Sint rows = region->area.height;
+   const Rox_Sint cols = region->area.width;
 
-   Rox_Sint cols = 0, rows = 0;
-   error = rox_array2d_uint_get_size(&rows, &cols, mask);
+   Rox_Float ** difference_data = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer(&difference_data, region->difference);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   Rox_Uint ** mask_data = NULL;
-   error = rox_array2d_uint_get_data_pointer_to_pointer(&mask_data, mask);
+   Rox_Float ** filtered_data = NULL;
+   error = rox_array2d_float_get_data_pointer_to_pointer(&filtered_data, region->filtered);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   if (posu > cols || posv > rows)
-   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   Rox_Uchar ** binary_data = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer(&binary_data, region->binary);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // reset mask
-   error = rox_array2d_uint_fillval(mask, 0);
-   ROX_ERROR_CHECK_TERMINATE(error)
+   Rox_Uchar ** moving_data = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer(&moving_data, region->moving);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Fill mask
-   Rox_Sint end_cols = posu + sizu;
-   Rox_Sint end_rows = posv + sizv;
+   // Difference between the model and the current image
+   for ( Rox_Sint r = 0; r < rows; r++)
+   {
+      rox_ansi_motion_difference_row(difference_data[r], &model_data[v0 + r][u0], &image_data[v0 + r][u0], cols);
+   }
 
-   if(end_cols > cols) end_cols = cols;
-   if(end_rows > rows) end_rows = rows;
+   // Filtering to remove noise
+   error = rox_array2d_float_symmetric_seperable_convolve(region->filtered, region->difference, hfilter);
+   ROX_ERROR_CHECK_TERMINATE ( error );
 
-   for ( Rox_Sint r = posv; r < end_rows; r++)
+   for ( Rox_Sint r = 0; r < rows; r++)
    {
-      for ( Rox_Sint c = posu; c < end_cols; c++)
+      rox_ansi_motion_threshold_row(binary_data[r], filtered_data[r], threshold, cols);
+   }
+
+   // Erode the thresholded image, the borders of the area are either out of the window or on the image borders
+   memset(moving_data[0], 0, cols * sizeof(Rox_Uchar));
+   memset(moving_data[rows - 1], 0, cols * sizeof(Rox_Uchar));
+
+   for ( Rox_Sint r = 1; r < rows - 1; r++)
+   {
+      rox_ansi_motion_erode3x3_row(moving_data[r], binary_data[r - 1], binary_data[r], binary_data[r + 1], cols);
+   }
+
+   // Apply mask
+   if (region->masked)
+   {
+      for ( Rox_Sint r = 0; r < rows; r++)
       {
-         mask_data[r][c] = ~0;
+         for ( Rox_Sint c = 0; c < cols; c++)
+         {
+            if (mask_data[v0 + r][u0 + c] == 0) moving_data[r][c] = 0;
+         }
       }
    }
 
@@ -327,6 +435,7 @@ Rox_ErrorCode rox_detection_motion_new(Rox_Detection_Motion * motion, Rox_Image
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    Rox_Detection_Motion ret = NULL;
+   Rox_Float sigma = 1.5;
 
    if (!motion || !model)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -335,6 +444,8 @@ Rox_ErrorCode rox_detection_motion_new(Rox_Detection_Motion * motion, Rox_Image
    if(!ret)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   memset(ret, 0, sizeof(*ret));
+
    Rox_Sint cols = 0, rows = 0;
    error = rox_array2d_uchar_get_size(&rows, &cols, model);
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -345,9 +456,6 @@ Rox_ErrorCode rox_detection_motion_new(Rox_Detection_Motion * motion, Rox_Image
    error = rox_array2d_uchar_copy(ret->model, model);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_new(&ret->Id, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    error = rox_array2d_uchar_new(&ret->Ic, rows, cols);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -357,9 +465,23 @@ Rox_ErrorCode rox_detection_motion_new(Rox_Detection_Motion * motion, Rox_Image
    error = rox_array2d_uint_fillval(ret->M, 0);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_cluster_new(&ret->cluster);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_connected_components_new(&ret->ccl, rows, cols);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_rect_sint_new(&ret->windows, 10);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_kernelgen_gaussian2d_separable_float_new(&ret->hfilter, &ret->vfilter, sigma, 3 * sigma);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
    error = rox_detection_motion_params_new(&ret->params);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   ret->regions_dirty = 1;
+
    *motion = ret;
 
 function_terminate:
@@ -394,63 +516,104 @@ Rox_ErrorCode rox_detection_motion_set_window_list (
    Rox_DynVec_Rect_Sint list, Rox_Detection_Motion motion, Rox_Image image)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Cluster cluster = NULL;
-   Rox_Float sensitivity = 0.0;
-   Rox_Float sigma = 1.5;
-
-   Rox_Array2D_Float hfilter = NULL;
-   Rox_Array2D_Float vfilter = NULL;
-   Rox_Array2D_Float If = NULL;
+   Rox_Float threshold = 0.0;
 
    if(!list || !motion || !image)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   sensitivity = (50.0f - 30.0f * motion->params->sensitivity) / 255.0f;
-
-   error = rox_cluster_new(&cluster);
+   error = rox_array2d_uchar_match_size(image, motion->model);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Difference between the current image and the model
-   error = rox_array2d_float_substract_uchar(motion->Id, motion->model, image);
+   // Threshold on the absolute filtered difference in gray levels
+   threshold = 50.0f - 30.0f * motion->params->sensitivity;
+
+   if (motion->regions_dirty)
+   {
+      error = rox_detection_motion_regions_make(motion);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
-   // Filtering to remove noise
    Rox_Sint cols = 0, rows = 0;
-   error = rox_array2d_float_get_size(&rows, &cols, motion->Id);
+   error = rox_array2d_uchar_get_size(&rows, &cols, image);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_new(&If, rows, cols);
+   Rox_Uchar ** image_data = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer(&image_data, image);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_kernelgen_gaussian2d_separable_float_new(&hfilter, &vfilter, sigma, 3 * sigma);
+   Rox_Uchar ** model_data = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer(&model_data, motion->model);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_float_symmetric_seperable_convolve(If, motion->Id, hfilter);
+   Rox_Uint ** mask_data = NULL;
+   error = rox_array2d_uint_get_data_pointer_to_pointer(&mask_data, motion->M);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Erode filtered image
-   error = rox_array2d_float_erode(motion->Id, If, sensitivity);
+   Rox_Uchar ** moving_data = NULL;
+   error = rox_array2d_uchar_get_data_pointer_to_pointer(&moving_data, motion->Ic);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Conversion float to uchar
-   error = rox_array2d_uchar_from_float(motion->Ic, motion->Id);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   // The windows are independent: each one is filtered and eroded on its own area
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(dynamic)
+#endif
+   for ( Rox_Sint k = 0; k < motion->count_regions; k++)
+   {
+      if (!motion->regions[k].moving) continue;
+      motion->regions[k].error = rox_detection_motion_region_process(&motion->regions[k], motion->hfilter, model_data, image_data, mask_data, threshold);
+   }
 
-   // Apply mask
-   error = rox_array2d_uchar_apply_mask(motion->Ic, motion->M);
+   for ( Rox_Sint k = 0; k < motion->count_regions; k++)
+   {
+      error = motion->regions[k].error;
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   // Gather the moving pixels of the windows, the overlapping windows hold the same values
+   error = rox_array2d_uchar_fillval(motion->Ic, 0);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_cluster_binary(cluster, motion->Ic, motion->params->bandwidth);
+   for ( Rox_Sint k = 0; k < motion->count_regions; k++)
+   {
+      Rox_Detection_Motion_Region_Struct * region = &motion->regions[k];
+      if (!region->moving) continue;
+
+      Rox_Uchar ** region_data = NULL;
+      error = rox_array2d_uchar_get_data_pointer_to_pointer(&region_data, region->moving);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      const Rox_Sint du = region->window.x - region->area.x;
+      const Rox_Sint dv = region->window.y - region->area.y;
+
+      for ( Rox_Sint r = 0; r < region->window.height; r++)
+      {
+         memcpy(&moving_data[region->window.y + r][region->window.x], &region_data[dv + r][du], region->window.width * sizeof(Rox_Uchar));
+      }
+   }
+
+   // Group the connected components of the moving pixels
+   error = rox_cluster_binary_components(motion->cluster, motion->ccl, motion->Ic, motion->params->bandwidth);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
    // Convert cluster to window
-   error = rox_rect_list_set_cluster(list, cluster);
+   error = rox_rect_list_set_cluster(list, motion->cluster);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   // Approximate median background: the model follows the image out of the moving pixels
+   if (motion->adaptation_period > 0 && ++motion->adaptation_frames >= motion->adaptation_period)
+   {
+      motion->adaptation_frames = 0;
+
+#ifdef ROX_USES_OPENMP
+      #pragma omp parallel for schedule(static)
+#endif
+      for ( Rox_Sint r = 0; r < rows; r++)
+      {
+         rox_ansi_motion_model_update_row(model_data[r], image_data[r], moving_data[r], cols);
+      }
+   }
+
 function_terminate:
-   rox_array2d_float_del(&If);
-   rox_cluster_del(&cluster);
-   rox_array2d_float_del(&vfilter);
-   rox_array2d_float_del(&hfilter);
    return error;
 }
 
@@ -503,11 +666,16 @@ Rox_Void rox_detection_motion_del(Rox_Detection_Motion * motion)
 
       if(todel != 0)
       {
+         rox_detection_motion_regions_del(todel);
          rox_detection_motion_params_del(&todel->params);
          rox_array2d_uchar_del(&todel->model);
-         rox_array2d_float_del(&todel->Id);
          rox_array2d_uint_del(&todel->M);
          rox_array2d_uchar_del(&todel->Ic);
+         rox_cluster_del(&todel->cluster);
+         rox_connected_components_del(&todel->ccl);
+         rox_dynvec_rect_sint_del(&todel->windows);
+         rox_array2d_float_del(&todel->hfilter);
+         rox_array2d_float_del(&todel->vfilter);
          rox_memory_delete(todel);
       }
    }
@@ -520,9 +688,19 @@ Rox_ErrorCode rox_detection_motion_set_imask_window_list(Rox_Detection_Motion mo
    if (!motion || !list)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   // The mask is the union of the windows
+   error = rox_array2d_uint_fillval(motion->M, 0);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   rox_dynvec_rect_sint_reset(motion->windows);
+   motion->regions_dirty = 1;
+
    for ( Rox_Uint i = 0; i < list->used; i++)
    {
-      error = rox_detection_motion_set_imask_window(motion, &list->data[i]);
+      error = rox_array2d_uint_set_ones_rectangle(motion->M, list->data[i].x, list->data[i].y, list->data[i].width, list->data[i].height);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_dynvec_rect_sint_append(motion->windows, &list->data[i]);
       ROX_ERROR_CHECK_TERMINATE ( error );
    }
 
@@ -554,6 +732,10 @@ Rox_ErrorCode rox_detection_motion_set_imask(Rox_Detection_Motion motion, Rox_Im
    error = rox_array2d_uint_copy(motion->M, mask);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   // The whole image is processed with the user defined mask
+   rox_dynvec_rect_sint_reset(motion->windows);
+   motion->regions_dirty = 1;
+
 function_terminate:
    return error;
 }
@@ -562,12 +744,21 @@ Rox_ErrorCode rox_detection_motion_set_imask_window(Rox_Detection_Motion motion,
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
 
-   if (!motion)
+   if (!motion || !window)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   error = rox_array2d_uint_fillval(motion->M, 0);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   rox_dynvec_rect_sint_reset(motion->windows);
+   motion->regions_dirty = 1;
+
    error = rox_array2d_uint_set_ones_rectangle(motion->M, window->x, window->y, window->width, window->height);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   error = rox_dynvec_rect_sint_append(motion->windows, window);
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
 function_terminate:
    return error;
 }
@@ -602,6 +793,23 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_detection_motion_set_adaptation(Rox_Detection_Motion motion, const Rox_Sint period)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!motion)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   if (period < 0)
+   { error = ROX_ERROR_INVALID_VALUE; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
+   motion->adaptation_period = period;
+   motion->adaptation_frames = 0;
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_rect_list_set_cluster(Rox_DynVec_Rect_Sint window_list, Rox_Cluster cluster)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -119,6 +119,16 @@ ROX_API Rox_ErrorCode rox_detection_motion_set_sensitivity (
    const Rox_Float sensitivity
 );
 
+//! Set the update period of the background model. Every period images, each pixel of the model
+//! not detected as moving steps by one gray level towards the image (approximate median).
+//! \param  [out]  motion      Motion Detection object
+//! \param  [in ]  period      Number of images between two updates, 0 for a fixed model (default)
+//! \return An error code
+ROX_API Rox_ErrorCode rox_detection_motion_set_adaptation (
+   Rox_Detection_Motion motion,
+   const Rox_Sint period
+);
+
 // ====== INTERNAL FUNCTIONS =================================================
 
 //! Create and allocate the motion detection structure.
@@ -31,6 +31,7 @@
 #include <core/model/model_single_plane_struct.h>
 
 #include <inout/system/print.h>
+#include <inout/system/log_sink.h>
 #include <inout/system/errors_print.h>
 
 #include <user/sensor/camera/camera_struct.h>
@@ -764,7 +765,7 @@ Rox_ErrorCode rox_ident_photoframe_se3_get_vvs_result (
          error = rox_objset_matse3_append( oTb, oTb_k );
          ROX_ERROR_CHECK_TERMINATE ( error );
 
-         rox_log("Adding photoframe id %d, with score = %f \n", k, score); 
+         ROX_LOG_INFO ( "Adding photoframe id %d, with score = %f \n", k, score );
 
          if (score > *best_score)
          {
@@ -31,6 +31,7 @@
 #include <baseproc/array/transpose/transpose.h>
 #include <baseproc/array/robust/tukey.h>
 #include <baseproc/array/robust/huber.h>
+#include <system/memory/arena.h>
 
 //#include <core/odometry/edge/odometry_segments.h>
 //#include <core/odometry/edge/odometry_ellipses.h>
@@ -1156,7 +1157,7 @@ function_terminate:
    return error;
 }
 
-Rox_ErrorCode rox_odometry_cadmodel_estimate_pose(Rox_Odometry_CadModel odometry_cadmodel, const Rox_Sint max_iters)
+static Rox_ErrorCode rox_odometry_cadmodel_estimate_pose_scoped(Rox_Odometry_CadModel odometry_cadmodel, const Rox_Sint max_iters)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
    // Rox_Array2D_Double verr= NULL, wb1= NULL, wb2= NULL, vw= NULL;
@@ -1473,6 +1474,21 @@ function_terminate:
    return error;
 }
 
+Rox_ErrorCode rox_odometry_cadmodel_estimate_pose(Rox_Odometry_CadModel odometry_cadmodel, const Rox_Sint max_iters)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   // The error, weight and normal equations buffers of the iterations are temporaries of the scratch arena
+   error = rox_arena_scope_begin("odometry_cadmodel_estimate_pose");
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_odometry_cadmodel_estimate_pose_scoped(odometry_cadmodel, max_iters);
+   rox_arena_scope_end();
+
+function_terminate:
+   return error;
+}
+
 Rox_ErrorCode rox_odometry_cadmodel_get_score(Rox_Double * score, Rox_Odometry_CadModel odometry_cadmodel)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
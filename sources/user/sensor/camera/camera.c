@@ -15,6 +15,8 @@
 #include "camera.h"
 #include "camera_struct.h"
 
+#include <string.h>
+
 #include <system/memory/memory.h>
 
 #include <baseproc/array/conversion/array2d_uchar_from_float.h>
@@ -23,8 +25,7 @@
 #include <baseproc/array/fill/fillval.h>
 #include <baseproc/geometry/transforms/transform_tools.h>
 #include <baseproc/geometry/pixelgrid/warp_grid_distortion.h>
-#include <baseproc/image/remap/remap_bilinear_float_to_float/remap_bilinear_float_to_float.h>
-#include <baseproc/image/imask/imask.h>
+#include <baseproc/image/remap/remap_bilinear_table/remap_bilinear_table.h>
 #include <baseproc/geometry/calibration/optimalcalib.h>
 
 #include <inout/image/pgm/pgmfile.h>
@@ -54,7 +55,8 @@ Rox_ErrorCode rox_camera_new ( Rox_Camera * camera, const Rox_Sint cols, const R
    ret->image        = NULL;
    ret->calib_camera = NULL;
    ret->pose         = NULL;
-   ret->grid_undistort = NULL;
+   ret->table_undistort = NULL;
+   ret->image_distorted = NULL;
 
    error = rox_image_new(&ret->image, cols, rows);
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -65,9 +67,6 @@ Rox_ErrorCode rox_camera_new ( Rox_Camera * camera, const Rox_Sint cols, const R
    error = rox_matse3_new ( &ret->pose );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_meshgrid2d_float_new ( &ret->grid_undistort, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    error = rox_transformtools_build_calibration_matrix ( ret->calib_camera, fu, fv, cu, cv );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
@@ -95,7 +94,8 @@ Rox_ErrorCode rox_camera_del ( Rox_Camera * camera )
    rox_image_del(&todel->image);
    rox_matut3_del(&todel->calib_camera);
    rox_matse3_del(&todel->pose);
-   rox_meshgrid2d_float_del(&todel->grid_undistort);
+   rox_remap_table_del(&todel->table_undistort);
+   rox_image_del(&todel->image_distorted);
    rox_memory_delete(todel);
 
 function_terminate:
@@ -119,7 +119,8 @@ Rox_ErrorCode rox_camera_new_read_pgm(Rox_Camera * camera, const char * filename
    ret->image = NULL;
    ret->calib_camera = NULL;
    ret->pose = NULL;
-   ret->grid_undistort = NULL;
+   ret->table_undistort = NULL;
+   ret->image_distorted = NULL;
 
    error = rox_image_new_read_pgm(&ret->image, filename);
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -134,9 +135,6 @@ Rox_ErrorCode rox_camera_new_read_pgm(Rox_Camera * camera, const char * filename
    error = rox_matsl3_new ( &ret->pose );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_meshgrid2d_float_new(&ret->grid_undistort, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    // default intrinsics parameters
    Rox_Double fu = 1000.0, fv = 1000.0, cu = (Rox_Double) (cols-1) / 2.0, cv = (Rox_Double) (rows-1) / 2.0;
 
@@ -310,6 +308,7 @@ Rox_ErrorCode rox_camera_set_params_undistort (
 
    Rox_Array2D_Double dist = NULL;
    Rox_MatUT3 calib = NULL, caliboptim = NULL;
+   Rox_MeshGrid2D_Float grid = NULL;
 
    if (!camera || !K || !radial || !tangential)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
@@ -323,9 +322,6 @@ Rox_ErrorCode rox_camera_set_params_undistort (
    error = rox_matut3_check_size ( K );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_meshgrid2d_float_del ( &camera->grid_undistort );
-   ROX_ERROR_CHECK_TERMINATE ( error );
-
    Rox_Sint cols = 0, rows = 0;
    error = rox_image_get_size ( &rows, &cols, camera->image );
    ROX_ERROR_CHECK_TERMINATE ( error );
@@ -346,131 +342,152 @@ Rox_ErrorCode rox_camera_set_params_undistort (
    error = rox_array2d_double_get_data_pointer_to_pointer( &dR, radial );
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_double_new(&dist, 5, 1);
-   ROX_ERROR_CHECK_TERMINATE(error)
+   Rox_Double params[14] = { dK[0][0], dK[0][1], dK[0][2], dK[1][0], dK[1][1], dK[1][2], dK[2][0], dK[2][1], dK[2][2],
+                             dR[0][0], dR[1][0], dR[2][0], dT[0][0], dT[1][0] };
 
-   error = rox_matut3_new ( &calib );
-   ROX_ERROR_CHECK_TERMINATE(error)
+   // Keep the table when the parameters and the image size did not change
+   Rox_Sint table_rows = 0, table_cols = 0;
+   if ( camera->table_undistort )
+   {
+      error = rox_remap_table_get_size ( &table_rows, &table_cols, camera->table_undistort );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
-   error = rox_matut3_new ( &caliboptim );
-   ROX_ERROR_CHECK_TERMINATE(error)
+   if ( table_rows != rows || table_cols != cols || memcmp ( params, camera->params_undistort, sizeof(params) ) )
+   {
+      error = rox_array2d_double_new(&dist, 5, 1);
+      ROX_ERROR_CHECK_TERMINATE(error)
 
-   Rox_Double ** ddist  = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &ddist, dist );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_matut3_new ( &calib );
+      ROX_ERROR_CHECK_TERMINATE(error)
 
-   Rox_Double ** dcalib = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dcalib, calib );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      error = rox_matut3_new ( &caliboptim );
+      ROX_ERROR_CHECK_TERMINATE(error)
 
-   Rox_Double ** dcaliboptim = NULL;
-   error = rox_array2d_double_get_data_pointer_to_pointer( &dcaliboptim, caliboptim );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      Rox_Double ** ddist  = NULL;
+      error = rox_array2d_double_get_data_pointer_to_pointer( &ddist, dist );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-   ddist[0][0] = dR[0][0];
-   ddist[1][0] = dR[1][0];
+      Rox_Double ** dcalib = NULL;
+      error = rox_array2d_double_get_data_pointer_to_pointer( &dcalib, calib );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-   ddist[2][0] = dT[0][0];
-   ddist[3][0] = dT[1][0];
-   ddist[4][0] = dR[2][0];
+      Rox_Double ** dcaliboptim = NULL;
+      error = rox_array2d_double_get_data_pointer_to_pointer( &dcaliboptim, caliboptim );
+      ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Copy K into calib
-   dcalib[0][0] = dK[0][0];
-   dcalib[0][1] = dK[0][1];
-   dcalib[0][2] = dK[0][2];
-   dcalib[1][0] = dK[1][0];
-   dcalib[1][1] = dK[1][1];
-   dcalib[1][2] = dK[1][2];
-   dcalib[2][0] = dK[2][0];
-   dcalib[2][1] = dK[2][1];
-   dcalib[2][2] = dK[2][2];
+      ddist[0][0] = dR[0][0];
+      ddist[1][0] = dR[1][0];
 
-   // Compute the optimal view for the undistorted image
-   error = rox_calibration_optimalview ( caliboptim, calib, dist, cols, rows );
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      ddist[2][0] = dT[0][0];
+      ddist[3][0] = dT[1][0];
+      ddist[4][0] = dR[2][0];
 
-   error = rox_meshgrid2d_float_new ( &camera->grid_undistort, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      // Copy K into calib
+      for ( Rox_Sint k = 0; k < 9; k++ ) dcalib[k / 3][k % 3] = params[k];
 
-   // Compute the distortion map
-   error = rox_warp_grid_distortion_float ( camera->grid_undistort, caliboptim, calib, dist);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+      // Compute the optimal view for the undistorted image
+      error = rox_calibration_optimalview ( caliboptim, calib, dist, cols, rows );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      // Compute the distortion map in float then quantize it, only the table is kept
+      error = rox_meshgrid2d_float_new ( &grid, rows, cols );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      error = rox_warp_grid_distortion_float ( grid, caliboptim, calib, dist );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      if ( table_rows != rows || table_cols != cols )
+      {
+         rox_remap_table_del ( &camera->table_undistort );
+
+         error = rox_remap_table_new ( &camera->table_undistort, rows, cols );
+         ROX_ERROR_CHECK_TERMINATE ( error );
+      }
+
+      // Invalidate the cache until the table is complete
+      memset ( camera->params_undistort, 0, sizeof(camera->params_undistort) );
+
+      error = rox_remap_table_set_meshgrid2d_float ( camera->table_undistort, grid, cols, rows );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+
+      for ( Rox_Sint k = 0; k < 9; k++ ) camera->calib_undistort[k] = dcaliboptim[k / 3][k % 3];
+      memcpy ( camera->params_undistort, params, sizeof(params) );
+   }
 
    // Copy caliboptim into camera->calib_camera
-   dok[0][0] = dcaliboptim[0][0];
-   dok[0][1] = dcaliboptim[0][1];
-   dok[0][2] = dcaliboptim[0][2];
-   dok[1][0] = dcaliboptim[1][0];
-   dok[1][1] = dcaliboptim[1][1];
-   dok[1][2] = dcaliboptim[1][2];
-   dok[2][0] = dcaliboptim[2][0];
-   dok[2][1] = dcaliboptim[2][1];
-   dok[2][2] = dcaliboptim[2][2];
+   for ( Rox_Sint k = 0; k < 9; k++ ) dok[k / 3][k % 3] = camera->calib_undistort[k];
 
 function_terminate:
+   rox_meshgrid2d_float_del(&grid);
    rox_array2d_double_del(&dist);
    rox_matut3_del(&calib);
    rox_matut3_del(&caliboptim);
    return error;
 }
 
-
-Rox_ErrorCode rox_camera_undistort_image(Rox_Camera camera)
+// Move the camera image to the distorted image buffer
+static Rox_ErrorCode rox_camera_undistort_prepare ( Rox_Camera camera )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
-   Rox_Array2D_Float source = NULL;
-   Rox_Array2D_Float undist = NULL;
-   Rox_Imask maski = NULL, omasko = NULL, omaski = NULL;
 
    if (!camera)
    { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
+   if (!camera->table_undistort)
+   { error = ROX_ERROR_INVALID; ROX_ERROR_CHECK_TERMINATE ( error ); }
+
    Rox_Sint cols = 0, rows = 0;
    error = rox_image_get_size(&rows, &cols, camera->image);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_match_size((Rox_Array2D) camera->image, (Rox_Array2D) camera->grid_undistort);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   if (camera->image_distorted && rox_array2d_uchar_check_size(camera->image_distorted, rows, cols))
+   {
+      rox_image_del(&camera->image_distorted);
+   }
 
-   error = rox_array2d_float_new(&source, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+   if (!camera->image_distorted)
+   {
+      error = rox_image_new(&camera->image_distorted, cols, rows);
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
 
-   error = rox_array2d_float_new(&undist, rows, cols);
+   error = rox_image_copy(camera->image_distorted, camera->image);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_imask_new(&maski, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+function_terminate:
+   return error;
+}
 
-   error = rox_imask_new(&omaski, rows, cols);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+Rox_ErrorCode rox_camera_undistort_image(Rox_Camera camera)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-   error = rox_imask_new(&omasko, rows, cols);
+   error = rox_camera_undistort_prepare(camera);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_uint_fillval(maski, ~0);
+   // warp the distorted image using the fixed point table
+   error = rox_remap_bilinear_table_uchar_to_uchar(camera->image, camera->image_distorted, camera->table_undistort);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   error = rox_array2d_uint_fillval(omaski, ~0);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+function_terminate:
+   return error;
+}
 
-   // uchar to float conversion
-   error = rox_array2d_float_from_uchar(source, camera->image);
-   ROX_ERROR_CHECK_TERMINATE ( error );
+Rox_ErrorCode rox_camera_undistort_image_to_pyramid(Rox_Pyramid_Float pyramid, Rox_Camera camera)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if (!pyramid)
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
 
-   // warp source image using distortion map in camera->grid_undistort
-   error = rox_remap_bilinear_float_to_float(undist, omasko, omaski, source, maski, camera->grid_undistort);
+   error = rox_camera_undistort_prepare(camera);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
-   // Convert the undistorted image into the camera image
-   error = rox_array2d_uchar_from_float(camera->image, undist);
+   error = rox_remap_bilinear_table_uchar_to_pyramid_float(pyramid, camera->image, camera->image_distorted, camera->table_undistort);
    ROX_ERROR_CHECK_TERMINATE ( error );
 
 function_terminate:
-   rox_array2d_float_del(&source);
-   rox_array2d_float_del(&undist);
-   rox_imask_del(&omaski);
-   rox_imask_del(&omasko);
-   rox_imask_del(&maski);
    return error;
 }
 
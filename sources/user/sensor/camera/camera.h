@@ -20,6 +20,7 @@
 #include "baseproc/image/image.h"
 #include <baseproc/maths/linalg/matut3.h>
 #include <baseproc/maths/linalg/matse3.h>
+#include <baseproc/image/pyramid/pyramid_float.h>
 
 //! \defgroup Sensor Sensor
 //! \brief Sensor structures and methods.
@@ -69,7 +70,7 @@ ROX_API Rox_ErrorCode rox_camera_read_pgm ( Rox_Camera camera, const char * path
 //! \todo   To be tested
 ROX_API Rox_ErrorCode rox_camera_save_pgm ( const char * filename, const Rox_Camera camera);
 
-//! Set distortion parameters
+//! Set distortion parameters. The undistortion table is only rebuilt when K, the distortion or the image size change.
 //! \param  [out]  camera           Camera object with intrinsics camera parameters
 //! \param  [in ]  K                Perspective camera intrinsic parameters matrix
 //! \param  [in ]  radial           A 3*1 vector with radial parameters (Cf. Bouguet Matlab calibration toolbox, k1,k2,k5).
@@ -112,12 +113,21 @@ ROX_API Rox_ErrorCode rox_camera_set_image_data ( Rox_Camera camera, const Rox_U
 //! \todo   To be tested
 ROX_API Rox_ErrorCode rox_camera_get_image_data ( Rox_Uchar * data, const Rox_Camera camera );
 
-//! Compute an undistorted image accordingly to intrinsics camera parameters and given distortion parameters
+//! Compute an undistorted image accordingly to intrinsics camera parameters and given distortion parameters.
+//! The image is remapped with the fixed point table (1/16 pixel) built by rox_camera_set_params_undistort,
+//! the pixels without distorted counterpart are set to 0.
 //! \param  [out]  camera           The camera object with intrinsics camera parameters
 //! \return An error code
 //! \todo   To be tested
 ROX_API Rox_ErrorCode rox_camera_undistort_image ( Rox_Camera camera );
 
+//! Undistort the camera image as rox_camera_undistort_image and build the box filtered pyramid
+//! of the normalized undistorted image in the same pass
+//! \param  [out]  pyramid          The pyramid (with the image size as base level)
+//! \param  [out]  camera           The camera object with intrinsics camera parameters
+//! \return An error code
+ROX_API Rox_ErrorCode rox_camera_undistort_image_to_pyramid ( Rox_Pyramid_Float pyramid, Rox_Camera camera );
+
 //! Get a copy of intrinsic parameters
 //! \param  [out]  calib            The copy of the intrinsic parameters
 //! \param  [in ]  camera           The camera object
@@ -20,7 +20,7 @@
 #include <baseproc/image/image.h>
 #include <baseproc/maths/linalg/matut3.h>
 #include <baseproc/maths/linalg/matse3.h>
-#include <baseproc/geometry/pixelgrid/meshgrid2d.h>
+#include <baseproc/image/remap/remap_bilinear_table/remap_bilinear_table.h>
 
 //! \addtogroup Camera
 //! @{
@@ -37,8 +37,17 @@ struct Rox_Camera_Struct
    //! Extrinsic parameters w.r.t. an arbitrary coordinate origin
    Rox_MatSE3 pose;
 
-   //! The Undistort LUT
-   Rox_MeshGrid2D_Float grid_undistort;
+   //! The fixed point undistortion table, NULL until the distortion parameters are set
+   Rox_Remap_Table table_undistort;
+
+   //! The distorted image kept between two undistortions
+   Rox_Image image_distorted;
+
+   //! The parameters of the current table: K (row major), radial, tangential
+   Rox_Double params_undistort[14];
+
+   //! The optimal intrinsic parameters of the current table (row major)
+   Rox_Double calib_undistort[9];
 };
 
 //! @}
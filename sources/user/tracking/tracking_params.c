@@ -40,6 +40,7 @@ Rox_ErrorCode rox_tracking_params_new (
    ret->init_pyr = ~0;
    ret->stop_pyr = 0;
    ret->usecase = Rox_Tracking_UseCase_SL3;
+   ret->inverse_compositional = 0;
 
    *params = ret;
 
@@ -134,3 +135,19 @@ Rox_ErrorCode rox_tracking_params_set_usecase (
 function_terminate:
    return error;
 }
+
+Rox_ErrorCode rox_tracking_params_set_inverse_compositional (
+   Rox_Tracking_Params params, 
+   const Rox_Bool inverse_compositional
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( !params ) 
+   { error = ROX_ERROR_NULL_POINTER; ROX_ERROR_CHECK_TERMINATE ( error ); }
+   
+   params->inverse_compositional = inverse_compositional;
+
+function_terminate:
+   return error;
+}
@@ -49,6 +49,9 @@ struct Rox_Tracking_Params_Struct
 
    //! The predefined usecase 
    enum Rox_Tracking_UseCase usecase;
+
+   //! Use the inverse compositional mode (jacobian and hessian precomputed on the reference) instead of the ESM 
+   Rox_Bool inverse_compositional;
 };
 
 //! Define the pointer of the Rox_Tracking_Params_Struct 
@@ -106,6 +109,17 @@ ROX_API Rox_ErrorCode rox_tracking_params_set_usecase (
    enum Rox_Tracking_UseCase usecase
 );
 
+//! Use the inverse compositional mode instead of the ESM.
+//! The jacobian and the hessian are computed once on the reference templates, each iteration only
+//! warps the current image and computes J'*e. The iterations are faster but converge slightly less precisely.
+//! \param  [out]  params                  The parameters object
+//! \param  [in ]  inverse_compositional   Enable (1) or disable (0, default) the inverse compositional mode
+//! \return An error code
+ROX_API Rox_ErrorCode rox_tracking_params_set_inverse_compositional (
+   Rox_Tracking_Params params, 
+   const Rox_Bool inverse_compositional
+);
+
 //! @} 
 
 #endif
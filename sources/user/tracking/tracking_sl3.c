@@ -63,6 +63,12 @@ Rox_ErrorCode rox_tracking_sl3_new ( Rox_Tracking_SL3 * tracking, Rox_Tracking_P
    error = rox_tracking_patch_sl3_new ( &ret->tracker ); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   if ( params->inverse_compositional )
+   {
+      error = rox_patchplane_pyramid_set_inverse_compositional ( ret->pyramid, Rox_Linsys_Steepest_Descent_Model_SL3_Light_Affine );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
    // Check init_pyr and stop_pyr parameters
    if (ret->parent.init_pyr > (Rox_Sint) (ret->pyramid->count - 1)) ret->parent.init_pyr = (Rox_Sint) (ret->pyramid->count - 1);
    if (ret->parent.init_pyr < 0) ret->parent.init_pyr = 0;// (Rox_Sint) (ret->pyramid->count - 1);
@@ -192,7 +198,7 @@ Rox_ErrorCode rox_tracking_sl3_make ( Rox_Tracking_SL3 tracking, const Rox_Image
       error = rox_patchplane_prepare_sl3 ( patch, tracking->tracker->homography, tracking->parent.normalized_cur ); 
       ROX_ERROR_CHECK_TERMINATE ( error );
       
-      error = rox_patchplane_prepare_finish ( patch ); 
+      error = rox_patchplane_prepare_difference ( patch ); 
       ROX_ERROR_CHECK_TERMINATE ( error );
           
       error = rox_patchplane_compute_score ( &prev_score, patch ); 
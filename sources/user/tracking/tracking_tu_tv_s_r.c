@@ -61,6 +61,12 @@ Rox_ErrorCode rox_tracking_tu_tv_s_r_new(Rox_Tracking_tu_tv_s_r * tracking, Rox_
    error = rox_tracking_patch_tu_tv_s_r_new(&ret->tracker); 
    ROX_ERROR_CHECK_TERMINATE ( error );
 
+   if ( params->inverse_compositional )
+   {
+      error = rox_patchplane_pyramid_set_inverse_compositional ( ret->pyramid, Rox_Linsys_Steepest_Descent_Model_tu_tv_s_r_Light_Affine );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
    // Check init_pyr and stop_pyr parameters
    if (ret->parent.init_pyr > (Rox_Sint) (ret->pyramid->count - 1)) ret->parent.init_pyr = (Rox_Sint)(ret->pyramid->count - 1);
    if (ret->parent.init_pyr < 0) ret->parent.init_pyr = 0;
@@ -199,7 +205,7 @@ Rox_ErrorCode rox_tracking_tu_tv_s_r_make(Rox_Tracking_tu_tv_s_r tracking, Rox_I
       error = rox_patchplane_prepare_sl3(patch, tracking->parent.zoom_homography, tracking->parent.normalized_cur); 
       ROX_ERROR_CHECK_TERMINATE ( error );
       
-      error = rox_patchplane_prepare_finish(patch); 
+      error = rox_patchplane_prepare_difference(patch); 
       ROX_ERROR_CHECK_TERMINATE ( error );
       
       error = rox_patchplane_compute_score(&prev_score, patch); 
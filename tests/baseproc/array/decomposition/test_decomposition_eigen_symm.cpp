@@ -0,0 +1,147 @@
+//==============================================================================
+//
+//    OPENROX   : File test_decomposition_eigen_symm.cpp
+//
+//    Contents  : Tests for eigen_symm.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+
+extern "C"
+{
+   #include <baseproc/array/decomposition/eigen_symm.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( eigen_symm )
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// S = C^T * C - shift * I, with C a deterministic n x n matrix
+static void build ( Rox_Double * S, const Rox_Sint n, const Rox_Double shift )
+{
+   for ( Rox_Sint i = 0; i < n; i++ )
+   {
+      for ( Rox_Sint j = 0; j < n; j++ )
+      {
+         Rox_Double sum = 0.0;
+
+         for ( Rox_Sint k = 0; k < n; k++ ) sum += sin ( 1.0 + 3.0 * k + 7.0 * i ) * sin ( 1.0 + 3.0 * k + 7.0 * j );
+         S[i * n + j] = sum - ( i == j ? shift : 0.0 );
+      }
+   }
+}
+
+// The errors of S = V * diag(D) * V^T and V^T * V = I, and the number of eigenvalues out of the decreasing order
+static void residuals ( Rox_Double * reconstruction, Rox_Double * orthogonality, Rox_Sint * unsorted, const Rox_Double * S, const Rox_Double * D, const Rox_Double * V, const Rox_Sint n )
+{
+   *reconstruction = 0.0;
+   *orthogonality = 0.0;
+   *unsorted = 0;
+
+   for ( Rox_Sint i = 0; i < n; i++ )
+   {
+      for ( Rox_Sint j = 0; j < n; j++ )
+      {
+         Rox_Double value = 0.0, dot = 0.0;
+
+         for ( Rox_Sint k = 0; k < n; k++ )
+         {
+            value += V[i * n + k] * D[k] * V[j * n + k];
+            dot += V[k * n + i] * V[k * n + j];
+         }
+
+         *reconstruction = fmax ( *reconstruction, fabs ( value - S[i * n + j] ) );
+         *orthogonality = fmax ( *orthogonality, fabs ( dot - ( i == j ? 1.0 : 0.0 ) ) );
+      }
+   }
+
+   for ( Rox_Sint k = 1; k < n; k++ ) if ( D[k - 1] < D[k] ) ( *unsorted )++;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_eigen_symm_fixed_sizes )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double S3[9], S4[16], S9[81], D[9], V[81];
+   Rox_Double reconstruction = 0.0, orthogonality = 0.0;
+   Rox_Sint unsorted = 0;
+
+   build ( S3, 3, 1.0 );
+   error = rox_array_double_eigen_symm3x3 ( D, V, S3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   residuals ( &reconstruction, &orthogonality, &unsorted, S3, D, V, 3 );
+   ROX_TEST_CHECK_SMALL ( reconstruction, 1e-12 );
+   ROX_TEST_CHECK_SMALL ( orthogonality, 1e-13 );
+   ROX_TEST_CHECK_EQUAL ( unsorted, 0 );
+
+   // Indefinite matrix : the order is the one of the values, not of the magnitudes
+   build ( S4, 4, 2.5 );
+   error = rox_array_double_eigen_symm4x4 ( D, V, S4 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   residuals ( &reconstruction, &orthogonality, &unsorted, S4, D, V, 4 );
+   ROX_TEST_CHECK_SMALL ( reconstruction, 1e-12 );
+   ROX_TEST_CHECK_SMALL ( orthogonality, 1e-13 );
+   ROX_TEST_CHECK_EQUAL ( unsorted, 0 );
+   ROX_TEST_CHECK_EQUAL ( D[3] < 0.0, 1 );
+
+   build ( S9, 9, 0.0 );
+   error = rox_array_double_eigen_symm9x9 ( D, V, S9 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   residuals ( &reconstruction, &orthogonality, &unsorted, S9, D, V, 9 );
+   ROX_TEST_CHECK_SMALL ( reconstruction, 1e-12 );
+   ROX_TEST_CHECK_SMALL ( orthogonality, 1e-13 );
+   ROX_TEST_CHECK_EQUAL ( unsorted, 0 );
+
+   error = rox_array_double_eigen_symm4x4 ( D, NULL, S4 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_eigen_symm_batch )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double S[5 * 16], D[5 * 4], V[5 * 16], Ds[4], Vs[16];
+
+   for ( Rox_Sint m = 0; m < 5; m++ ) build ( &S[16 * m], 4, 0.5 * m );
+
+   error = rox_array_double_eigen_symm_batch ( D, V, S, 4, 5 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The batch gives the same decompositions as the single matrix function
+   for ( Rox_Sint m = 0; m < 5; m++ )
+   {
+      rox_array_double_eigen_symm4x4 ( Ds, Vs, &S[16 * m] );
+
+      for ( Rox_Sint k = 0; k < 4; k++ ) ROX_TEST_CHECK_EQUAL ( D[4 * m + k], Ds[k] );
+      for ( Rox_Sint k = 0; k < 16; k++ ) ROX_TEST_CHECK_EQUAL ( V[16 * m + k], Vs[k] );
+   }
+
+   error = rox_array_double_eigen_symm_batch ( D, V, S, 10, 5 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   error = rox_array_double_eigen_symm_batch ( D, V, S, 4, -1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+}
+
+ROX_TEST_SUITE_END ( )
@@ -0,0 +1,169 @@
+//==============================================================================
+//
+//    OPENROX   : File test_decomposition_svd3x3.cpp
+//
+//    Contents  : Tests for svd3x3.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+
+extern "C"
+{
+   #include <baseproc/array/decomposition/svd3x3.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( svd3x3 )
+
+#define COUNT 7
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+// Full rank, rank 2 (skew matrix), rank 1, zero, reflection, near rotation, diagonal with repeated values
+static const Rox_Double matrices[COUNT][9] = {
+   {  8.79,  9.93,  9.83,  6.11,  6.91,  5.04, -9.15, -7.93,  4.86 },
+   {  0.0, -0.0951803965236873, 0.0, 0.0951803965236873, 0.0, -0.9954600404424047, 0.0, 0.9954600404424047, 0.0 },
+   {  1.0,  2.0, -1.0,  2.0,  4.0, -2.0,  0.5,  1.0, -0.5 },
+   {  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0 },
+   { -1.0,  0.0,  0.0,  0.0,  1.0,  0.0,  0.0,  0.0,  1.0 },
+   {  0.9998,  -0.0199, 0.0101, 0.0201, 0.9997, -0.0098, -0.0099, 0.0102, 1.0003 },
+   {  2.0,  0.0,  0.0,  0.0,  3.0,  0.0,  0.0,  0.0,  2.0 } };
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// The largest error of M^T * M = I
+static Rox_Double orthogonality ( const Rox_Double M[9] )
+{
+   Rox_Double error = 0.0;
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         const Rox_Double value = M[i] * M[j] + M[3 + i] * M[3 + j] + M[6 + i] * M[6 + j];
+         error = fmax ( error, fabs ( value - ( i == j ? 1.0 : 0.0 ) ) );
+      }
+   }
+
+   return error;
+}
+
+static Rox_Double determinant ( const Rox_Double M[9] )
+{
+   return M[0] * (M[4] * M[8] - M[5] * M[7]) - M[1] * (M[3] * M[8] - M[5] * M[6]) + M[2] * (M[3] * M[7] - M[4] * M[6]);
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_svd3x3_batch )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double U[COUNT * 9], S[COUNT * 3], V[COUNT * 9];
+   Rox_Array2D_Double Um = NULL, Sm = NULL, Vm = NULL, Am = NULL;
+   Rox_Double ** dU = NULL, ** dS = NULL, ** dV = NULL, ** dA = NULL;
+
+   error = rox_array_double_svd3x3_batch ( U, S, V, &matrices[0][0], COUNT );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_double_new ( &Um, 3, 3 );
+   rox_array2d_double_new ( &Sm, 3, 1 );
+   rox_array2d_double_new ( &Vm, 3, 3 );
+   rox_array2d_double_new ( &Am, 3, 3 );
+   rox_array2d_double_get_data_pointer_to_pointer ( &dU, Um );
+   rox_array2d_double_get_data_pointer_to_pointer ( &dS, Sm );
+   rox_array2d_double_get_data_pointer_to_pointer ( &dV, Vm );
+   rox_array2d_double_get_data_pointer_to_pointer ( &dA, Am );
+
+   for ( Rox_Sint m = 0; m < COUNT; m++ )
+   {
+      const Rox_Double * u = &U[9 * m], * s = &S[3 * m], * v = &V[9 * m];
+
+      // A = U * diag(S) * V^T
+      for ( Rox_Sint i = 0; i < 3; i++ )
+      {
+         for ( Rox_Sint j = 0; j < 3; j++ )
+         {
+            const Rox_Double value = u[i * 3 + 0] * s[0] * v[j * 3 + 0] + u[i * 3 + 1] * s[1] * v[j * 3 + 1] + u[i * 3 + 2] * s[2] * v[j * 3 + 2];
+            ROX_TEST_CHECK_SMALL ( value - matrices[m][i * 3 + j], 1e-12 );
+         }
+      }
+
+      ROX_TEST_CHECK_SMALL ( orthogonality ( u ), 1e-14 );
+      ROX_TEST_CHECK_SMALL ( orthogonality ( v ), 1e-14 );
+      ROX_TEST_CHECK_CLOSE ( determinant ( v ), 1.0, 1e-14 );
+      ROX_TEST_CHECK_EQUAL ( s[0] >= s[1] && s[1] >= s[2] && s[2] >= 0.0, 1 );
+
+      // The single matrix function gives the same decomposition as the batch
+      for ( Rox_Sint k = 0; k < 9; k++ ) dA[k / 3][k % 3] = matrices[m][k];
+
+      error = rox_array2d_double_svd3x3 ( Um, Sm, Vm, Am );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      for ( Rox_Sint k = 0; k < 9; k++ )
+      {
+         ROX_TEST_CHECK_EQUAL ( dU[k / 3][k % 3], u[k] );
+         ROX_TEST_CHECK_EQUAL ( dV[k / 3][k % 3], v[k] );
+      }
+      for ( Rox_Sint k = 0; k < 3; k++ ) ROX_TEST_CHECK_EQUAL ( dS[k][0], s[k] );
+   }
+
+   // Singular values of the skew matrix of a unit vector
+   ROX_TEST_CHECK_CLOSE ( S[3], 1.0, 1e-14 );
+   ROX_TEST_CHECK_CLOSE ( S[4], 1.0, 1e-14 );
+   ROX_TEST_CHECK_SMALL ( S[5], 1e-14 );
+
+   error = rox_array2d_double_svd3x3 ( Um, Sm, Um, Sm );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   error = rox_array_double_svd3x3_batch ( U, S, V, &matrices[0][0], -1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   rox_array2d_double_del ( &Um );
+   rox_array2d_double_del ( &Sm );
+   rox_array2d_double_del ( &Vm );
+   rox_array2d_double_del ( &Am );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_polar3x3_batch )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Double R[COUNT * 9];
+
+   error = rox_array_double_polar3x3_batch ( R, &matrices[0][0], COUNT );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint m = 0; m < COUNT; m++ )
+   {
+      ROX_TEST_CHECK_SMALL ( orthogonality ( &R[9 * m] ), 1e-14 );
+      ROX_TEST_CHECK_CLOSE ( determinant ( &R[9 * m] ), 1.0, 1e-14 );
+   }
+
+   // The rotation nearest to a diagonal matrix with positive values is the identity
+   for ( Rox_Sint k = 0; k < 9; k++ ) ROX_TEST_CHECK_SMALL ( R[9 * 6 + k] - ( k % 4 == 0 ? 1.0 : 0.0 ), 1e-15 );
+
+   // The rotation nearest to a rotation with small noise is close to it
+   for ( Rox_Sint k = 0; k < 9; k++ ) ROX_TEST_CHECK_SMALL ( R[9 * 5 + k] - matrices[5][k], 1e-3 );
+
+   error = rox_array_double_polar3x3_batch ( NULL, &matrices[0][0], COUNT );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+}
+
+ROX_TEST_SUITE_END ( )
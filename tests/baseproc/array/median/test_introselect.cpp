@@ -0,0 +1,184 @@
+//==============================================================================
+//
+//    OPENROX   : File test_introselect.cpp
+//
+//    Contents  : Tests for introselect.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <stdlib.h>
+#include <math.h>
+
+extern "C"
+{
+   #include <baseproc/array/median/introselect.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( introselect )
+
+#define MAX_SIZE 2001
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+static Rox_Double data[MAX_SIZE];
+static Rox_Double sorted[MAX_SIZE];
+static Rox_Double work[MAX_SIZE];
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+static int compare ( const void * one, const void * two )
+{
+   const Rox_Double a = *( const Rox_Double * ) one, b = *( const Rox_Double * ) two;
+   return ( a > b ) - ( a < b );
+}
+
+// Fill data with a pattern: 0 uniform, 1 few distinct values, 2 sorted, 3 reversed, 4 organ pipe, 5 heavy tailed
+static void fill ( Rox_Uint size, Rox_Uint pattern, Rox_Uint seed )
+{
+   Rox_Uint state = seed * 2654435761u + 1u;
+   for ( Rox_Uint i = 0; i < size; i++ )
+   {
+      state = state * 1664525u + 1013904223u;
+      const Rox_Double u = ( state >> 8 ) / 16777216.0;
+
+      switch ( pattern )
+      {
+         case 0: data[i] = u; break;
+         case 1: data[i] = ( Rox_Double ) ( ( state >> 12 ) % 5 ); break;
+         case 2: data[i] = i; break;
+         case 3: data[i] = size - i; break;
+         case 4: data[i] = ( i < size / 2 ) ? i : size - i; break;
+         default: data[i] = ( u < 0.2 ) ? 1000.0 * u : 0.01 * u - 0.005; break;
+      }
+   }
+}
+
+static Rox_Double sorted_median ( Rox_Uint size )
+{
+   return ( size % 2 ) ? sorted[size / 2] : 0.5 * ( sorted[size / 2 - 1] + sorted[size / 2] );
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_double_introselect )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   const Rox_Uint sizes[] = { 1, 2, 3, 16, 17, 18, 100, 257, 1000, 2001 };
+   Rox_Uint failures = 0;
+
+   for ( Rox_Uint k = 0; k < sizeof ( sizes ) / sizeof ( sizes[0] ); k++ )
+   {
+      const Rox_Uint size = sizes[k];
+      for ( Rox_Uint pattern = 0; pattern < 6; pattern++ )
+      {
+         fill ( size, pattern, k );
+         for ( Rox_Uint i = 0; i < size; i++ ) sorted[i] = data[i];
+         qsort ( sorted, size, sizeof ( Rox_Double ), compare );
+
+         // Some ranks including the extremes
+         const Rox_Uint ranks[] = { 0, size / 3, size / 2, size - 1 };
+         for ( Rox_Uint r = 0; r < 4; r++ )
+         {
+            Rox_Double value = 0.0;
+            for ( Rox_Uint i = 0; i < size; i++ ) work[i] = data[i];
+
+            error = rox_double_introselect ( &value, work, size, ranks[r] );
+            ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+            if ( value != sorted[ranks[r]] ) failures++;
+
+            // The vector is partitioned around the rank
+            for ( Rox_Uint i = 0; i < size; i++ )
+            {
+               if ( i < ranks[r] && work[i] > value ) failures++;
+               if ( i > ranks[r] && work[i] < value ) failures++;
+            }
+         }
+
+         Rox_Double median = 0.0, mad = 0.0;
+         for ( Rox_Uint i = 0; i < size; i++ ) work[i] = data[i];
+         error = rox_double_median_introselect ( &median, work, size );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+         if ( median != sorted_median ( size ) ) failures++;
+
+         error = rox_double_median_mad_introselect ( &median, &mad, work, data, size );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+         if ( median != sorted_median ( size ) ) failures++;
+
+         for ( Rox_Uint i = 0; i < size; i++ ) sorted[i] = fabs ( data[i] - median );
+         qsort ( sorted, size, sizeof ( Rox_Double ), compare );
+         if ( mad != sorted_median ( size ) ) failures++;
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+
+   Rox_Double value = 0.0;
+   error = rox_double_introselect ( &value, work, 10, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   error = rox_double_median_introselect ( &value, NULL, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_double_median_mad_histogram )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   const Rox_Uint sizes[] = { 1, 2, 17, 18, 1000, 2001 };
+   Rox_Uint failures = 0;
+
+   for ( Rox_Uint k = 0; k < sizeof ( sizes ) / sizeof ( sizes[0] ); k++ )
+   {
+      const Rox_Uint size = sizes[k];
+      for ( Rox_Uint pattern = 0; pattern < 6; pattern++ )
+      {
+         Rox_Double median = 0.0, mad = 0.0, exact_median = 0.0, exact_mad = 0.0;
+         Rox_Double median_bound = 0.0, mad_bound = 0.0;
+
+         fill ( size, pattern, k );
+
+         error = rox_double_median_mad_introselect ( &exact_median, &exact_mad, work, data, size );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+         error = rox_double_median_mad_histogram ( &median, &median_bound, &mad, &mad_bound, data, size );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+         Rox_Double low = data[0], high = data[0];
+         for ( Rox_Uint i = 0; i < size; i++ )
+         {
+            if ( data[i] < low ) low = data[i];
+            if ( data[i] > high ) high = data[i];
+         }
+
+         // The errors are within the bounds, the median bound is within the resolution of two histogram levels
+         const Rox_Double resolution = ( high - low ) / ( ROX_INTROSELECT_HISTOGRAM_BINS * ROX_INTROSELECT_HISTOGRAM_BINS );
+         if ( fabs ( median - exact_median ) > median_bound + 1e-12 ) failures++;
+         if ( fabs ( mad - exact_mad ) > mad_bound + 1e-12 ) failures++;
+         if ( median_bound > resolution ) failures++;
+
+         // Values taken by few distinct elements are exact
+         if ( pattern == 1 && ( median_bound != 0.0 || median != exact_median ) ) failures++;
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+}
+
+ROX_TEST_SUITE_END ( )
@@ -0,0 +1,272 @@
+//==============================================================================
+//
+//    OPENROX   : File test_morphology.cpp
+//
+//    Contents  : Tests for morphology.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+extern "C"
+{
+   #include <baseproc/array/morphological/morphology.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( morphology )
+
+#define ROWS 37
+#define COLS 301
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+// The radii (vertical, horizontal) of the tested elements, the last ones are larger than the image
+static const Rox_Sint radii[][2] = { { 0, 0 }, { 1, 1 }, { 2, 3 }, { 5, 0 }, { 0, 7 }, { 4, 10 }, { 40, 2 }, { 3, 350 } };
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Extremum on the element clipped to the image
+template < typename T > static void brute_force ( T ** out, T ** in, Rox_Sint rv, Rox_Sint ru, bool dilate )
+{
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         T value = in[i][j];
+         for ( Rox_Sint k = i - rv; k <= i + rv; k++ )
+         {
+            for ( Rox_Sint l = j - ru; l <= j + ru; l++ )
+            {
+               if ( k < 0 || l < 0 || k >= ROWS || l >= COLS ) continue;
+               if ( dilate && in[k][l] > value ) value = in[k][l];
+               if ( !dilate && in[k][l] < value ) value = in[k][l];
+            }
+         }
+         out[i][j] = value;
+      }
+   }
+}
+
+// Number of different pixels
+template < typename T > static Rox_Uint count_differences ( T ** a, T ** b )
+{
+   Rox_Uint count = 0;
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         if ( a[i][j] != b[i][j] ) count++;
+      }
+   }
+   return count;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_array2d_uchar_morphology_rectangle )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Uchar input = NULL, res = NULL, ref = NULL, tmp = NULL;
+   Rox_Uchar ** input_data = NULL, ** res_data = NULL, ** ref_data = NULL, ** tmp_data = NULL;
+
+   error = rox_array2d_uchar_new ( &input, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uchar_new ( &res, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uchar_new ( &ref, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uchar_new ( &tmp, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &input_data, input );
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &res_data, res );
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &ref_data, ref );
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &tmp_data, tmp );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+         input_data[i][j] = ( Rox_Uchar ) ( ( i * 37 + j * 101 + i * j ) % 251 );
+
+   for ( Rox_Uint k = 0; k < sizeof ( radii ) / sizeof ( radii[0] ); k++ )
+   {
+      const Rox_Sint rv = radii[k][0], ru = radii[k][1];
+
+      error = rox_array2d_uchar_erode_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( ref_data, input_data, rv, ru, false );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_array2d_uchar_dilate_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( ref_data, input_data, rv, ru, true );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_array2d_uchar_open_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( tmp_data, input_data, rv, ru, false );
+      brute_force ( ref_data, tmp_data, rv, ru, true );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_array2d_uchar_close_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( tmp_data, input_data, rv, ru, true );
+      brute_force ( ref_data, tmp_data, rv, ru, false );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+   }
+
+   // In place
+   brute_force ( ref_data, input_data, 2, 3, true );
+   error = rox_array2d_uchar_dilate_rectangle ( input, input, 2, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( count_differences ( input_data, ref_data ), 0u );
+
+   error = rox_array2d_uchar_erode_rectangle ( res, input, -1, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_array2d_uchar_erode_rectangle ( NULL, input, 1, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_array2d_uchar_del ( &input );
+   rox_array2d_uchar_del ( &res );
+   rox_array2d_uchar_del ( &ref );
+   rox_array2d_uchar_del ( &tmp );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_array2d_float_morphology_rectangle )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Float input = NULL, res = NULL, ref = NULL, tmp = NULL, small = NULL;
+   Rox_Float ** input_data = NULL, ** res_data = NULL, ** ref_data = NULL, ** tmp_data = NULL;
+
+   error = rox_array2d_float_new ( &input, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &res, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &ref, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &tmp, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &small, ROWS - 1, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_float_get_data_pointer_to_pointer ( &input_data, input );
+   rox_array2d_float_get_data_pointer_to_pointer ( &res_data, res );
+   rox_array2d_float_get_data_pointer_to_pointer ( &ref_data, ref );
+   rox_array2d_float_get_data_pointer_to_pointer ( &tmp_data, tmp );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+         input_data[i][j] = ( Rox_Float ) ( ( i * 13 + j * 29 + i * j ) % 97 ) / 7.0f - 5.0f;
+
+   for ( Rox_Uint k = 0; k < sizeof ( radii ) / sizeof ( radii[0] ); k++ )
+   {
+      const Rox_Sint rv = radii[k][0], ru = radii[k][1];
+
+      error = rox_array2d_float_erode_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( ref_data, input_data, rv, ru, false );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_array2d_float_dilate_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( ref_data, input_data, rv, ru, true );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_array2d_float_open_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( tmp_data, input_data, rv, ru, false );
+      brute_force ( ref_data, tmp_data, rv, ru, true );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_array2d_float_close_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( tmp_data, input_data, rv, ru, true );
+      brute_force ( ref_data, tmp_data, rv, ru, false );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+   }
+
+   error = rox_array2d_float_dilate_rectangle ( small, input, 1, 1 );
+   ROX_TEST_CHECK_NOT_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_float_del ( &input );
+   rox_array2d_float_del ( &res );
+   rox_array2d_float_del ( &ref );
+   rox_array2d_float_del ( &tmp );
+   rox_array2d_float_del ( &small );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_imask_morphology_rectangle )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Imask input = NULL, res = NULL, ref = NULL, tmp = NULL;
+   Rox_Uint ** input_data = NULL, ** res_data = NULL, ** ref_data = NULL, ** tmp_data = NULL;
+
+   error = rox_imask_new ( &input, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_imask_new ( &res, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_imask_new ( &ref, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_imask_new ( &tmp, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_uint_get_data_pointer_to_pointer ( &input_data, input );
+   rox_array2d_uint_get_data_pointer_to_pointer ( &res_data, res );
+   rox_array2d_uint_get_data_pointer_to_pointer ( &ref_data, ref );
+   rox_array2d_uint_get_data_pointer_to_pointer ( &tmp_data, tmp );
+
+   // Mostly valid mask with holes and a few isolated valid pixels
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+         input_data[i][j] = ( ( i * 7 + j * 3 ) % 11 < 8 ) ? ~0u : 0u;
+
+   for ( Rox_Uint k = 0; k < sizeof ( radii ) / sizeof ( radii[0] ); k++ )
+   {
+      const Rox_Sint rv = radii[k][0], ru = radii[k][1];
+
+      error = rox_imask_erode_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( ref_data, input_data, rv, ru, false );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_imask_dilate_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( ref_data, input_data, rv, ru, true );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_imask_open_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( tmp_data, input_data, rv, ru, false );
+      brute_force ( ref_data, tmp_data, rv, ru, true );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+
+      error = rox_imask_close_rectangle ( res, input, rv, ru );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      brute_force ( tmp_data, input_data, rv, ru, true );
+      brute_force ( ref_data, tmp_data, rv, ru, false );
+      ROX_TEST_CHECK_EQUAL ( count_differences ( res_data, ref_data ), 0u );
+   }
+
+   rox_imask_del ( &input );
+   rox_imask_del ( &res );
+   rox_imask_del ( &ref );
+   rox_imask_del ( &tmp );
+}
+
+ROX_TEST_SUITE_END ( )
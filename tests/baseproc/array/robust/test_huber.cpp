@@ -16,6 +16,8 @@
 
 #include <openrox_tests.hpp>
 
+#include <math.h>
+
 extern "C"
 {
 	#include <baseproc/array/robust/huber.h>
@@ -94,4 +96,69 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_huber)
 
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_huber_weights)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint nbp = 501;
+   Rox_Double sigma = 0.0, sigma_histogram = 0.0;
+   Rox_Uint differences = 0;
+
+   Rox_Array2D_Double weight = NULL;
+   Rox_Array2D_Double weight_fused = NULL;
+   Rox_Array2D_Double work1 = NULL;
+   Rox_Array2D_Double work2 = NULL;
+   Rox_Array2D_Double dist = NULL;
+
+   error = rox_array2d_double_new ( &weight, nbp, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &weight_fused, nbp, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &work1, nbp, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &work2, nbp, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &dist, nbp, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Small residuals with one outlier out of ten
+   Rox_Double * dd = NULL;
+   error = rox_array2d_double_get_data_pointer ( &dd, dist );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   for ( Rox_Sint i = 0; i < nbp; i++ )
+   {
+      dd[i] = ( i % 10 == 0 ) ? 5.0 + i * 0.01 : 0.1 * sin ( i * 1.7 );
+   }
+
+   error = rox_array2d_double_huber_bounded ( weight, work1, work2, dist, 0.0, 10.0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The exact fused computation gives the same weights
+   error = rox_array2d_double_huber_weights ( weight_fused, &sigma, dist, 0.0, 10.0, Rox_MAD_Method_Exact );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Double * dw = NULL, * dwf = NULL;
+   rox_array2d_double_get_data_pointer ( &dw, weight );
+   rox_array2d_double_get_data_pointer ( &dwf, weight_fused );
+   for ( Rox_Sint i = 0; i < nbp; i++ )
+   {
+      if ( dw[i] != dwf[i] ) differences++;
+   }
+   ROX_TEST_CHECK_EQUAL ( differences, 0u );
+   ROX_TEST_CHECK_SUPERIOR ( sigma, 0.0 );
+
+   // The outliers are down weighted
+   ROX_TEST_CHECK_SMALL ( dwf[100], 0.2 );
+
+   // The histogram approximation gives a close scale
+   error = rox_array2d_double_huber_weights ( weight_fused, &sigma_histogram, dist, 0.0, 10.0, Rox_MAD_Method_Histogram );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_CLOSE ( sigma_histogram, sigma, 1e-3 );
+
+   rox_array2d_double_del ( &weight );
+   rox_array2d_double_del ( &weight_fused );
+   rox_array2d_double_del ( &work1 );
+   rox_array2d_double_del ( &work2 );
+   rox_array2d_double_del ( &dist );
+}
+
 ROX_TEST_SUITE_END()
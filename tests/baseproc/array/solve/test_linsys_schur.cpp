@@ -0,0 +1,150 @@
+//==============================================================================
+//
+//    OPENROX   : File test_linsys_schur.cpp
+//
+//    Contents  : Tests for linsys_schur.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+extern "C"
+{
+   #include <baseproc/array/solve/linsys_schur.h>
+   #include <baseproc/array/solve/svd_solve.h>
+   #include <baseproc/array/fill/fillval.h>
+   #include <inout/numeric/array2d_print.h>
+   #include <inout/system/print.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN(linsys_schur)
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_linsys_schur_solve)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   const Rox_Sint ns = 2, nb = 2, blocks = 3, rows = 5;
+   const Rox_Sint cols = ns + nb * blocks;
+
+   Rox_LinSys_Schur schur = NULL;
+   Rox_Array2D_Double J = NULL, r = NULL, x_grt = NULL, x_mes = NULL;
+   Rox_Array2D_Double Js = NULL, Jb = NULL, rb = NULL;
+   Rox_Double ** dJ = NULL, ** dr = NULL, ** dx_grt = NULL, ** dx_mes = NULL;
+
+   error = rox_array2d_double_new(&J, rows * blocks, cols);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_new(&r, rows * blocks, 1);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_new(&x_grt, cols, 1);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_new(&x_mes, cols, 1);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_fillval(J, 0.0);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&dJ, J);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&dr, r);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Block arrow jacobian: shared columns plus one block of columns per group of rows
+   for (Rox_Sint k = 0; k < blocks; k++)
+   {
+      for (Rox_Sint i = 0; i < rows; i++)
+      {
+         Rox_Sint row = k * rows + i;
+
+         for (Rox_Sint j = 0; j < ns; j++)
+            dJ[row][j] = cos(1.0 + row * 0.7 + j * 1.3);
+
+         for (Rox_Sint j = 0; j < nb; j++)
+            dJ[row][ns + k * nb + j] = sin(2.0 + row * 0.9 + j * 2.1);
+
+         dr[row][0] = 0.1 * row - 0.5;
+      }
+   }
+
+   // Dense reference solution
+   error = rox_svd_solve(x_grt, J, r);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_schur_new(&schur, ns, nb, blocks);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_schur_reset(schur);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for (Rox_Sint k = 0; k < blocks; k++)
+   {
+      error = rox_array2d_double_new_subarray2d(&Js, J, k * rows, 0, rows, ns);
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_array2d_double_new_subarray2d(&Jb, J, k * rows, ns + k * nb, rows, nb);
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_array2d_double_new_subarray2d(&rb, r, k * rows, 0, rows, 1);
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_linsys_schur_add_block(schur, k, Js, Jb, rb);
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      rox_array2d_double_del(&Js);
+      rox_array2d_double_del(&Jb);
+      rox_array2d_double_del(&rb);
+   }
+
+   error = rox_linsys_schur_solve(x_mes, schur);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_log("Measure: \n");
+   rox_array2d_double_print(x_mes);
+   rox_log("Ground truth: \n");
+   rox_array2d_double_print(x_grt);
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&dx_grt, x_grt);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer(&dx_mes, x_mes);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for (Rox_Sint j = 0; j < cols; j++)
+   {
+      ROX_TEST_CHECK_CLOSE ( dx_mes[j][0], dx_grt[j][0], 1e-9 );
+   }
+
+   error = rox_linsys_schur_del(&schur);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_double_del(&J);
+   rox_array2d_double_del(&r);
+   rox_array2d_double_del(&x_grt);
+   rox_array2d_double_del(&x_mes);
+}
+
+ROX_TEST_SUITE_END()
@@ -0,0 +1,188 @@
+//==============================================================================
+//
+//    OPENROX   : File test_linsys_accumulator.cpp
+//
+//    Contents  : Tests for linsys_accumulator.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =====================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+
+extern "C"
+{
+   #include <baseproc/calculus/linsys/linsys_accumulator.h>
+}
+
+//=== INTERNAL MACROS    =====================================================
+
+ROX_TEST_SUITE_BEGIN ( linsys_accumulator )
+
+#define ROWS 37
+#define COLS 301
+
+//=== INTERNAL TYPESDEFS =====================================================
+
+//=== INTERNAL DATATYPES =====================================================
+
+//=== INTERNAL VARIABLES =====================================================
+
+//=== INTERNAL FUNCTDEFS =====================================================
+
+//=== INTERNAL FUNCTIONS =====================================================
+
+// Deterministic jacobian value of parameter k for pixel (i,j)
+static Rox_Float jacobian_value ( Rox_Sint k, Rox_Sint i, Rox_Sint j )
+{
+   return (Rox_Float) ( ( ( i * 31 + j * 17 + k * 7 ) % 23 ) - 11 ) / 8.0f;
+}
+
+static Rox_Float error_value ( Rox_Sint i, Rox_Sint j )
+{
+   return (Rox_Float) ( ( ( i * 13 + j * 5 ) % 19 ) - 9 ) / 4.0f;
+}
+
+// Odd rows skip every third pixel
+static Rox_Sint is_masked ( Rox_Sint i, Rox_Sint j )
+{
+   return ( i % 2 ) && ( j % 3 == 0 );
+}
+
+static Rox_ErrorCode test_row ( Rox_Float ** J, Rox_Float * e, Rox_Sint * count, const Rox_Sint i, const Rox_Void * params )
+{
+   const Rox_Sint n = *(const Rox_Sint *) params;
+   Rox_Sint p = 0;
+
+   for ( Rox_Sint j = 0; j < COLS; j++ )
+   {
+      if ( is_masked ( i, j ) ) continue;
+
+      for ( Rox_Sint k = 0; k < n; k++ ) J[k][p] = jacobian_value ( k, i, j );
+      e[p] = error_value ( i, j );
+      p++;
+   }
+
+   *count = p;
+   return ROX_ERROR_NONE;
+}
+
+static Rox_ErrorCode overflow_row ( Rox_Float ** J, Rox_Float * e, Rox_Sint * count, const Rox_Sint i, const Rox_Void * params )
+{
+   *count = COLS + 1;
+   return ROX_ERROR_NONE;
+}
+
+// Accumulate a system of size n and get the largest deviation from the system summed in double
+static Rox_ErrorCode accumulate_and_compare ( Rox_Double * deviation, Rox_Sint n )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Matrix LtL = NULL, Lte = NULL;
+   Rox_Double ** LtL_data = NULL, ** Lte_data = NULL;
+
+   // Reference system summed in double
+   Rox_Double ref_LtL[16][16] = { { 0.0 } };
+   Rox_Double ref_Lte[16] = { 0.0 };
+
+   error = rox_array2d_double_new ( &LtL, n, n );
+   if ( error ) goto function_terminate;
+
+   error = rox_array2d_double_new ( &Lte, n, 1 );
+   if ( error ) goto function_terminate;
+
+   error = rox_linsys_accumulate_rows ( LtL, Lte, ROWS, COLS, test_row, &n );
+   if ( error ) goto function_terminate;
+
+   rox_array2d_double_get_data_pointer_to_pointer ( &LtL_data, LtL );
+   rox_array2d_double_get_data_pointer_to_pointer ( &Lte_data, Lte );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         if ( is_masked ( i, j ) ) continue;
+
+         for ( Rox_Sint k = 0; k < n; k++ )
+         {
+            for ( Rox_Sint l = 0; l < n; l++ )
+            {
+               ref_LtL[k][l] += jacobian_value ( k, i, j ) * jacobian_value ( l, i, j );
+            }
+            ref_Lte[k] += jacobian_value ( k, i, j ) * error_value ( i, j );
+         }
+      }
+   }
+
+   *deviation = 0.0;
+   for ( Rox_Sint k = 0; k < n; k++ )
+   {
+      for ( Rox_Sint l = 0; l < n; l++ )
+      {
+         *deviation = fmax ( *deviation, fabs ( LtL_data[k][l] - ref_LtL[k][l] ) );
+      }
+      *deviation = fmax ( *deviation, fabs ( Lte_data[k][0] - ref_Lte[k] ) );
+   }
+
+function_terminate:
+   rox_array2d_double_del ( &LtL );
+   rox_array2d_double_del ( &Lte );
+   return error;
+}
+
+//=== EXPORTED FUNCTIONS =====================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_linsys_accumulate_rows )
+{
+   // Unrolled kernels and generic kernel
+   const Rox_Sint sizes[5] = { 6, 8, 10, 3, 16 };
+
+   for ( Rox_Sint s = 0; s < 5; s++ )
+   {
+      Rox_Double deviation = 1.0;
+
+      Rox_ErrorCode error = accumulate_and_compare ( &deviation, sizes[s] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      // Values are multiples of 1/64, so that block sums in float are exact
+      ROX_TEST_CHECK_SMALL ( deviation, 1e-12 );
+   }
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_linsys_accumulate_rows_errors )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Matrix LtL = NULL, Lte = NULL, big = NULL;
+   Rox_Sint n = 8;
+
+   error = rox_array2d_double_new ( &LtL, n, n );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_new ( &Lte, n, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_new ( &big, 17, 17 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_accumulate_rows ( NULL, Lte, ROWS, COLS, test_row, &n );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   error = rox_linsys_accumulate_rows ( big, Lte, ROWS, COLS, test_row, &n );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   error = rox_linsys_accumulate_rows ( LtL, Lte, ROWS, COLS, overflow_row, &n );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_TOO_LARGE_VALUE );
+
+   rox_array2d_double_del ( &LtL );
+   rox_array2d_double_del ( &Lte );
+   rox_array2d_double_del ( &big );
+}
+
+ROX_TEST_SUITE_END()
@@ -0,0 +1,214 @@
+//==============================================================================
+//
+//    OPENROX   : File test_linsys_steepest_descent.cpp
+//
+//    Contents  : Tests for linsys_steepest_descent.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =====================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+
+extern "C"
+{
+   #include <baseproc/calculus/linsys/linsys_steepest_descent.h>
+   #include <baseproc/calculus/linsys/linsys_texture_matsl3_light_affine.h>
+   #include <baseproc/calculus/linsys/linsys_texture_tutvsr_light_affine_model2d.h>
+}
+
+//=== INTERNAL MACROS    =====================================================
+
+ROX_TEST_SUITE_BEGIN ( linsys_steepest_descent )
+
+#define ROWS 41
+#define COLS 53
+
+//=== INTERNAL TYPESDEFS =====================================================
+
+//=== INTERNAL DATATYPES =====================================================
+
+//=== INTERNAL VARIABLES =====================================================
+
+//=== INTERNAL FUNCTDEFS =====================================================
+
+//=== INTERNAL FUNCTIONS =====================================================
+
+// Fill the reference, its gradients, the error and the masks with deterministic values
+static Rox_ErrorCode fill_images (
+   Rox_Array2D_Float Ia,
+   Rox_Array2D_Float Iu,
+   Rox_Array2D_Float Iv,
+   Rox_Array2D_Float Id,
+   Rox_Imask Im_ref,
+   Rox_Imask Im_cur,
+   Rox_Imask Im_both
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float ** Ia_data = NULL, ** Iu_data = NULL, ** Iv_data = NULL, ** Id_data = NULL;
+   Rox_Uint ** Im_ref_data = NULL, ** Im_cur_data = NULL, ** Im_both_data = NULL;
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Ia_data, Ia ); if ( error ) return error;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iu_data, Iu ); if ( error ) return error;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Iv_data, Iv ); if ( error ) return error;
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &Id_data, Id ); if ( error ) return error;
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &Im_ref_data, Im_ref ); if ( error ) return error;
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &Im_cur_data, Im_cur ); if ( error ) return error;
+   error = rox_array2d_uint_get_data_pointer_to_pointer ( &Im_both_data, Im_both ); if ( error ) return error;
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         Ia_data[i][j] = (Rox_Float) ( ( i * 7 + j * 3 ) % 17 ) / 16.0f;
+         Iu_data[i][j] = (Rox_Float) ( ( ( i * 5 + j * 11 ) % 13 ) - 6 ) / 32.0f;
+         Iv_data[i][j] = (Rox_Float) ( ( ( i * 3 + j * 7 ) % 11 ) - 5 ) / 32.0f;
+         Id_data[i][j] = (Rox_Float) ( ( ( i * 13 + j * 5 ) % 19 ) - 9 ) / 64.0f;
+
+         // The border is not a reference pixel, a block of the reference is not visible
+         Im_ref_data[i][j] = ( i > 0 && j > 0 && i < ROWS - 1 && j < COLS - 1 ) ? ~0 : 0;
+         Im_cur_data[i][j] = ( i > 25 && j > 30 ) ? 0 : ~0;
+         Im_both_data[i][j] = Im_ref_data[i][j] & Im_cur_data[i][j];
+      }
+   }
+
+   return error;
+}
+
+// Maximal absolute difference between two matrices relatively to the largest element of the second one
+static Rox_Double relative_deviation ( Rox_Array2D_Double A, Rox_Array2D_Double B )
+{
+   Rox_Double ** A_data = NULL, ** B_data = NULL;
+   Rox_Sint rows = 0, cols = 0;
+   Rox_Double dev = 0.0, scale = 0.0;
+
+   rox_array2d_double_get_size ( &rows, &cols, A );
+   rox_array2d_double_get_data_pointer_to_pointer ( &A_data, A );
+   rox_array2d_double_get_data_pointer_to_pointer ( &B_data, B );
+
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         if ( fabs ( A_data[i][j] - B_data[i][j] ) > dev ) dev = fabs ( A_data[i][j] - B_data[i][j] );
+         if ( fabs ( B_data[i][j] ) > scale ) scale = fabs ( B_data[i][j] );
+      }
+   }
+
+   return dev / scale;
+}
+
+//=== EXPORTED FUNCTIONS =====================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_linsys_steepest_descent_make )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Float Ia = NULL, Iu = NULL, Iv = NULL, Id = NULL;
+   Rox_Imask Im_ref = NULL, Im_cur = NULL, Im_both = NULL;
+   Rox_Linsys_Steepest_Descent steepest = NULL;
+   Rox_Array2D_Double LtL = NULL, Lte = NULL, LtL_forward = NULL, Lte_forward = NULL;
+
+   error = rox_array2d_float_new ( &Ia, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &Iu, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &Iv, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_float_new ( &Id, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uint_new ( &Im_ref, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uint_new ( &Im_cur, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uint_new ( &Im_both, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = fill_images ( Ia, Iu, Iv, Id, Im_ref, Im_cur, Im_both );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // SL3 model against the forward builder on the valid pixels
+   error = rox_array2d_double_new ( &LtL, 10, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &Lte, 10, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &LtL_forward, 10, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &Lte_forward, 10, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_steepest_descent_new ( &steepest, Rox_Linsys_Steepest_Descent_Model_SL3_Light_Affine, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_steepest_descent_set_reference ( steepest, Ia, Iu, Iv, Im_ref );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( steepest->count, ( ROWS - 2 ) * ( COLS - 2 ) );
+
+   error = rox_linsys_steepest_descent_make ( LtL, Lte, steepest, Id, Im_cur );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = linsys_texture_matsl3_light_affine ( LtL_forward, Lte_forward, Ia, Id, Iu, Iv, Im_both );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_TEST_CHECK_SMALL ( relative_deviation ( LtL, LtL_forward ), 1e-6 );
+   ROX_TEST_CHECK_SMALL ( relative_deviation ( Lte, Lte_forward ), 1e-6 );
+
+   rox_array2d_double_del ( &LtL );
+   rox_array2d_double_del ( &Lte );
+   rox_array2d_double_del ( &LtL_forward );
+   rox_array2d_double_del ( &Lte_forward );
+   rox_linsys_steepest_descent_del ( &steepest );
+
+   // tu_tv_s_r model against the forward builder on the valid pixels
+   error = rox_array2d_double_new ( &LtL, 6, 6 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &Lte, 6, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &LtL_forward, 6, 6 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_double_new ( &Lte_forward, 6, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_steepest_descent_new ( &steepest, Rox_Linsys_Steepest_Descent_Model_tu_tv_s_r_Light_Affine, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_steepest_descent_set_reference ( steepest, Ia, Iu, Iv, Im_ref );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_linsys_steepest_descent_make ( LtL, Lte, steepest, Id, Im_cur );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_jacobian_tutvsr_light_affine_premul ( LtL_forward, Lte_forward, Ia, Id, Iu, Iv, Im_both );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_TEST_CHECK_SMALL ( relative_deviation ( LtL, LtL_forward ), 1e-6 );
+   ROX_TEST_CHECK_SMALL ( relative_deviation ( Lte, Lte_forward ), 1e-6 );
+
+   // Missing steepest descent object
+   error = rox_linsys_steepest_descent_make ( LtL, Lte, NULL, Id, Im_cur );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_array2d_double_del ( &LtL );
+   rox_array2d_double_del ( &Lte );
+   rox_array2d_double_del ( &LtL_forward );
+   rox_array2d_double_del ( &Lte_forward );
+   rox_linsys_steepest_descent_del ( &steepest );
+
+   rox_array2d_float_del ( &Ia );
+   rox_array2d_float_del ( &Iu );
+   rox_array2d_float_del ( &Iv );
+   rox_array2d_float_del ( &Id );
+   rox_array2d_uint_del ( &Im_ref );
+   rox_array2d_uint_del ( &Im_cur );
+   rox_array2d_uint_del ( &Im_both );
+}
+
+ROX_TEST_SUITE_END ( )
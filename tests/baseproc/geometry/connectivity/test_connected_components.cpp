@@ -0,0 +1,254 @@
+//==============================================================================
+//
+//    OPENROX   : File test_connected_components.cpp
+//
+//    Contents  : Tests for connected_components.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <vector>
+
+extern "C"
+{
+   #include <baseproc/geometry/connectivity/connected_components.h>
+   #include <baseproc/geometry/connectivity/connectivity.h>
+   #include <generated/dynvec_point2d_sint_struct.h>
+   #include <generated/objset_dynvec_point2d_sint_struct.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( connected_components )
+
+// More than two bands of rows labelled in parallel
+#define ROWS 203
+#define COLS 157
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Random image of values in [0, levels], a pixel is 0 with probability density
+static void fill ( Rox_Uint ** data, Rox_Uint levels, Rox_Uint density, Rox_Uint seed )
+{
+   Rox_Uint state = seed * 2654435761u + 1u;
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         state = state * 1664525u + 1013904223u;
+         const Rox_Uint r = ( state >> 8 ) % 100;
+         data[i][j] = ( r < density ) ? 0 : 1 + ( state >> 20 ) % levels;
+      }
+   }
+}
+
+// Flood fill labelling, components numbered in the order of their first pixel
+static Rox_Uint flood_fill ( std::vector<Rox_Uint> & labels, Rox_Uint ** data, Rox_Sint connectivity )
+{
+   std::vector<Rox_Sint> stack;
+   Rox_Uint count = 0;
+
+   labels.assign ( ROWS * COLS, 0 );
+
+   for ( Rox_Sint s = 0; s < ROWS * COLS; s++ )
+   {
+      if ( data[s / COLS][s % COLS] == 0 || labels[s] ) continue;
+
+      const Rox_Uint value = data[s / COLS][s % COLS];
+      labels[s] = ++count;
+      stack.push_back ( s );
+
+      while ( !stack.empty ( ) )
+      {
+         const Rox_Sint p = stack.back ( );
+         stack.pop_back ( );
+
+         for ( Rox_Sint di = -1; di <= 1; di++ )
+         {
+            for ( Rox_Sint dj = -1; dj <= 1; dj++ )
+            {
+               if ( connectivity == 4 && di != 0 && dj != 0 ) continue;
+
+               const Rox_Sint i = p / COLS + di, j = p % COLS + dj;
+               if ( i < 0 || i >= ROWS || j < 0 || j >= COLS ) continue;
+               if ( data[i][j] != value || labels[i * COLS + j] ) continue;
+
+               labels[i * COLS + j] = count;
+               stack.push_back ( i * COLS + j );
+            }
+         }
+      }
+   }
+
+   return count;
+}
+
+// Compare the labels and statistics with the flood fill
+static Rox_Uint compare ( Rox_Connected_Components ccl, Rox_Uint ** data, Rox_Sint connectivity )
+{
+   std::vector<Rox_Uint> labels;
+   Rox_Uint failures = 0;
+   Rox_Uint ** dl = NULL;
+
+   const Rox_Uint count = flood_fill ( labels, data, connectivity );
+   if ( count != ccl->count ) return 1;
+
+   rox_array2d_uint_get_data_pointer_to_pointer ( &dl, ccl->labels );
+
+   std::vector<Rox_Uint> area ( count + 1, 0 );
+   std::vector<Rox_Double> sum_u ( count + 1, 0.0 ), sum_uv ( count + 1, 0.0 );
+   std::vector<Rox_Sint> v_max ( count + 1, -1 );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         const Rox_Uint l = labels[i * COLS + j];
+         if ( dl[i][j] != l ) failures++;
+
+         area[l]++;
+         sum_u[l] += j;
+         sum_uv[l] += i * j;
+         v_max[l] = i;
+      }
+   }
+
+   for ( Rox_Uint l = 1; l <= count; l++ )
+   {
+      const Rox_Connected_Component_Struct * stats = &ccl->components[l - 1];
+      if ( stats->area != area[l] ) failures++;
+      if ( stats->sum_u != sum_u[l] ) failures++;
+      if ( stats->sum_uv != sum_uv[l] ) failures++;
+      if ( stats->v_max != v_max[l] ) failures++;
+      if ( stats->u_min > stats->u_max || stats->v_min > stats->v_max ) failures++;
+   }
+
+   return failures;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_connected_components_make )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Connected_Components ccl = NULL;
+   Rox_Array2D_Uint values = NULL;
+   Rox_Array2D_Uchar binary = NULL;
+   Rox_Uint ** dv = NULL;
+   Rox_Uchar ** db = NULL;
+   Rox_Uint failures = 0;
+
+   error = rox_connected_components_new ( &ccl, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uint_new ( &values, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uchar_new ( &binary, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_uint_get_data_pointer_to_pointer ( &dv, values );
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &db, binary );
+
+   // Densities around the percolation threshold give components crossing many bands
+   const Rox_Uint densities[] = { 0, 30, 45, 60, 100 };
+   for ( Rox_Uint k = 0; k < sizeof ( densities ) / sizeof ( densities[0] ); k++ )
+   {
+      for ( Rox_Sint connectivity = 4; connectivity <= 8; connectivity += 4 )
+      {
+         fill ( dv, 1, densities[k], k );
+         for ( Rox_Sint i = 0; i < ROWS; i++ )
+            for ( Rox_Sint j = 0; j < COLS; j++ )
+               db[i][j] = ( Rox_Uchar ) ( 255 * dv[i][j] );
+
+         error = rox_connected_components_make ( ccl, binary, connectivity );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+         failures += compare ( ccl, dv, connectivity );
+
+         fill ( dv, 3, densities[k] / 2, k );
+
+         error = rox_connected_components_make_value ( ccl, values, connectivity );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+         failures += compare ( ccl, dv, connectivity );
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+
+   error = rox_connected_components_make ( ccl, binary, 6 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_connected_components_make ( ccl, NULL, 8 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_array2d_uchar_del ( &binary );
+   rox_array2d_uint_del ( &values );
+   rox_connected_components_del ( &ccl );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_connectivity_lists )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ObjSet_DynVec_Point2D_Sint lists = NULL;
+   Rox_Array2D_Uint values = NULL;
+   Rox_Uint ** dv = NULL;
+   std::vector<Rox_Uint> labels;
+   Rox_Uint failures = 0;
+   const Rox_Uint min_length = 3;
+
+   error = rox_objset_dynvec_point2d_sint_new ( &lists, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uint_new ( &values, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_uint_get_data_pointer_to_pointer ( &dv, values );
+   fill ( dv, 2, 40, 7 );
+
+   error = rox_array2d_uint_connectivity_value ( lists, values, min_length );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The lists are the components larger than min_length, in the order of their first pixel
+   const Rox_Uint count = flood_fill ( labels, dv, 8 );
+   std::vector<Rox_Uint> area ( count + 1, 0 );
+   for ( Rox_Sint s = 0; s < ROWS * COLS; s++ ) area[labels[s]]++;
+
+   Rox_Uint index = 0;
+   for ( Rox_Uint l = 1; l <= count; l++ )
+   {
+      if ( area[l] <= min_length ) continue;
+      if ( index >= lists->used ) { failures++; break; }
+
+      Rox_DynVec_Point2D_Sint list = lists->data[index++];
+      if ( list->used != area[l] ) failures++;
+      for ( Rox_Uint p = 0; p < list->used; p++ )
+      {
+         if ( labels[list->data[p].v * COLS + list->data[p].u] != l ) failures++;
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( index, lists->used );
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+
+   rox_array2d_uint_del ( &values );
+   rox_objset_dynvec_point2d_sint_del ( &lists );
+}
+
+ROX_TEST_SUITE_END ( )
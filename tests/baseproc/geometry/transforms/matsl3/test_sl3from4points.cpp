@@ -21,6 +21,7 @@ extern "C"
    #include <baseproc/geometry/point/point2d_struct.h>
 	#include <baseproc/geometry/transforms/matsl3/sl3from4points.h>
    #include <inout/numeric/array2d_print.h>
+   #include <baseproc/maths/linalg/matsl3.h>
 }
 
 //=== INTERNAL MACROS    =======================================================
@@ -104,4 +105,63 @@ terminate:
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_sl3_from_4_points_double_batch)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   const Rox_Sint count = 5;
+   Rox_Point2D_Double_Struct source[4 * count];
+   Rox_Point2D_Double_Struct dest[4 * count];
+   Rox_Double homographies[9 * count];
+   Rox_Double data[9];
+   Rox_Sint valid[count];
+   Rox_MatSL3 homography = NULL;
+
+   error = rox_matsl3_new ( &homography );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < count; k++ )
+   {
+      for ( Rox_Sint i = 0; i < 4; i++ )
+      {
+         source[4 * k + i].u = 100.0 * ( i % 2 ) + 3.0 * k + 10.0;
+         source[4 * k + i].v = 80.0 * ( i / 2 ) - 2.0 * k + 20.0;
+         dest[4 * k + i].u = 1.1 * source[4 * k + i].u + 0.05 * source[4 * k + i].v + 7.0 * i - 4.0 * k;
+         dest[4 * k + i].v = 0.9 * source[4 * k + i].v - 0.02 * source[4 * k + i].u + 3.0 * k;
+      }
+   }
+
+   // A degenerate sample
+   for ( Rox_Sint i = 0; i < 4; i++ ) source[4 * 3 + i] = source[4 * 3];
+
+   error = rox_matsl3_from_4_points_double_batch ( homographies, valid, source, dest, count );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The batch gives the same homographies as the sample by sample function
+   for ( Rox_Sint k = 0; k < count; k++ )
+   {
+      error = rox_matsl3_from_4_points_double ( homography, &source[4 * k], &dest[4 * k] );
+      ROX_TEST_CHECK_EQUAL ( valid[k], error == ROX_ERROR_NONE ? 1 : 0 );
+      if ( error ) continue;
+
+      rox_matsl3_get_data ( data, homography );
+      for ( Rox_Sint i = 0; i < 9; i++ ) ROX_TEST_CHECK_EQUAL ( homographies[9 * k + i], data[i] );
+
+      // The source points are transformed to the destination points
+      for ( Rox_Sint i = 0; i < 4; i++ )
+      {
+         const Rox_Double u = source[4 * k + i].u, v = source[4 * k + i].v;
+         const Rox_Double w = data[6] * u + data[7] * v + data[8];
+         ROX_TEST_CHECK_CLOSE ( ( data[0] * u + data[1] * v + data[2] ) / w, dest[4 * k + i].u, 1e-6 );
+         ROX_TEST_CHECK_CLOSE ( ( data[3] * u + data[4] * v + data[5] ) / w, dest[4 * k + i].v, 1e-6 );
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( valid[3], 0 );
+
+   error = rox_matsl3_from_4_points_double_batch ( homographies, valid, source, dest, -1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   rox_matsl3_del ( &homography );
+}
+
 ROX_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+//==============================================================================
+//
+//    OPENROX   : File test_frame_ingest.cpp
+//
+//    Contents  : Tests for frame_ingest.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <vector>
+
+extern "C"
+{
+   #include <baseproc/image/convert/frame_ingest.h>
+   #include <baseproc/image/pyramid/pyramid_float.h>
+   #include <baseproc/array/conversion/array2d_float_from_uchar.h>
+   #include <generated/array2d_float.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( frame_ingest )
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+static Rox_Uint compare_float ( Rox_Image_Float one, Rox_Image_Float two )
+{
+   Rox_Sint rows = 0, cols = 0;
+   Rox_Float ** d1 = NULL, ** d2 = NULL;
+   Rox_Uint failures = 0;
+
+   rox_array2d_float_get_size ( &rows, &cols, one );
+   rox_array2d_float_get_data_pointer_to_pointer ( &d1, one );
+   rox_array2d_float_get_data_pointer_to_pointer ( &d2, two );
+
+   for ( Rox_Sint i = 0; i < rows; i++ )
+      for ( Rox_Sint j = 0; j < cols; j++ )
+         if ( d1[i][j] != d2[i][j] ) failures++;
+
+   return failures;
+}
+
+// Compare the fused ingest with the converter, the normalization and the pyramid called one after the other
+static Rox_Uint check_ingest ( Rox_Sint rows, Rox_Sint cols, const enum Rox_Image_Format format, Rox_Sint bytes )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image gray = NULL, gray_ref = NULL;
+   Rox_Image_Float gray_float = NULL, gray_float_ref = NULL;
+   Rox_Pyramid_Float pyramid = NULL, pyramid_ref = NULL, pyramid_only = NULL;
+   Rox_Uchar ** dg = NULL, ** dr = NULL;
+   Rox_Uint failures = 0;
+
+   // Random buffer with a padded stride
+   const Rox_Sint stride = bytes * cols + 13;
+   std::vector<Rox_Uchar> buffer ( stride * rows * 3 / 2 );
+   Rox_Uint state = rows * 2654435761u + cols;
+   for ( size_t k = 0; k < buffer.size ( ); k++ )
+   {
+      state = state * 1664525u + 1013904223u;
+      buffer[k] = ( Rox_Uchar ) ( state >> 24 );
+   }
+
+   rox_image_new ( &gray, cols, rows );
+   rox_image_new ( &gray_ref, cols, rows );
+   rox_array2d_float_new ( &gray_float, rows, cols );
+   rox_array2d_float_new ( &gray_float_ref, rows, cols );
+   rox_pyramid_float_new ( &pyramid, cols, rows, 20, 2 );
+   rox_pyramid_float_new ( &pyramid_ref, cols, rows, 20, 2 );
+   rox_pyramid_float_new ( &pyramid_only, cols, rows, 20, 2 );
+
+   error = rox_image_set_data ( gray_ref, &buffer[0], stride, format );
+   if ( error ) failures++;
+
+   rox_array2d_float_from_uchar_normalize ( gray_float_ref, gray_ref );
+   rox_pyramid_float_assign ( pyramid_ref, gray_float_ref );
+
+   error = rox_frame_ingest ( gray, gray_float, pyramid, &buffer[0], stride, format );
+   if ( error ) failures++;
+
+   rox_image_get_data_pointer_to_pointer ( &dg, gray );
+   rox_image_get_data_pointer_to_pointer ( &dr, gray_ref );
+
+   // The last column of YUV422 is not set by the reference converter for odd widths
+   const Rox_Sint checked_cols = ( format == Rox_Image_Format_YUV422 ) ? 2 * ( cols / 2 ) : cols;
+   for ( Rox_Sint i = 0; i < rows; i++ )
+      for ( Rox_Sint j = 0; j < checked_cols; j++ )
+         if ( dg[i][j] != dr[i][j] ) failures++;
+
+   if ( format != Rox_Image_Format_YUV422 || checked_cols == cols )
+   {
+      failures += compare_float ( gray_float, gray_float_ref );
+      for ( Rox_Uint l = 0; l < pyramid_ref->nb_levels; l++ )
+         failures += compare_float ( pyramid->levels[l], pyramid_ref->levels[l] );
+
+      // Pyramid without the normalized image
+      error = rox_frame_ingest ( gray, NULL, pyramid_only, &buffer[0], stride, format );
+      if ( error ) failures++;
+
+      for ( Rox_Uint l = 0; l < pyramid_ref->nb_levels; l++ )
+         failures += compare_float ( pyramid_only->levels[l], pyramid_ref->levels[l] );
+   }
+
+   rox_pyramid_float_del ( &pyramid_only );
+   rox_pyramid_float_del ( &pyramid_ref );
+   rox_pyramid_float_del ( &pyramid );
+   rox_array2d_float_del ( &gray_float_ref );
+   rox_array2d_float_del ( &gray_float );
+   rox_image_del ( &gray_ref );
+   rox_image_del ( &gray );
+
+   return failures;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_frame_ingest )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   const enum Rox_Image_Format formats[] =
+   {
+      Rox_Image_Format_Grays, Rox_Image_Format_YUV422, Rox_Image_Format_RGBA, Rox_Image_Format_BGRA,
+      Rox_Image_Format_ARGB, Rox_Image_Format_BGR, Rox_Image_Format_RGB, Rox_Image_Format_RGBA_FlippedUpsideDown,
+      Rox_Image_Format_Alpha8_32bits, Rox_Image_Format_Alpha8_32bits_FlippedUpsideDown, Rox_Image_Format_NV12
+   };
+   const Rox_Sint bytes[] = { 1, 2, 4, 4, 4, 3, 3, 4, 4, 4, 1 };
+
+   // Odd sizes, and a pyramid with more levels than computed inside the bands
+   const Rox_Sint sizes[][2] = { { 203, 157 }, { 97, 64 }, { 600, 640 } };
+
+   for ( Rox_Uint s = 0; s < sizeof ( sizes ) / sizeof ( sizes[0] ); s++ )
+   {
+      for ( Rox_Uint f = 0; f < sizeof ( formats ) / sizeof ( formats[0] ); f++ )
+      {
+         ROX_TEST_CHECK_EQUAL ( check_ingest ( sizes[s][0], sizes[s][1], formats[f], bytes[f] ), 0u );
+      }
+   }
+
+   Rox_Image gray = NULL;
+   Rox_Uchar buffer[64 * 4] = { 0 };
+   rox_image_new ( &gray, 8, 8 );
+
+   error = rox_frame_ingest ( gray, NULL, NULL, buffer, 4, Rox_Image_Format_RGBA );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_frame_ingest ( gray, NULL, NULL, NULL, 32, Rox_Image_Format_RGBA );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_image_del ( &gray );
+}
+
+ROX_TEST_SUITE_END ( )
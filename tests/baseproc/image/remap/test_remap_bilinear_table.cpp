@@ -0,0 +1,219 @@
+//==============================================================================
+//
+//    OPENROX   : File test_remap_bilinear_table.cpp
+//
+//    Contents  : Tests for remap_bilinear_table.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+#include <stdlib.h>
+
+extern "C"
+{
+   #include <baseproc/maths/linalg/matsl3.h>
+   #include <baseproc/geometry/pixelgrid/meshgrid2d_struct.h>
+   #include <baseproc/geometry/pixelgrid/warp_grid_matsl3.h>
+   #include <baseproc/array/conversion/array2d_float_from_uchar.h>
+   #include <baseproc/image/pyramid/pyramid_float.h>
+   #include <baseproc/image/remap/remap_bilinear_nomask_uchar_to_uchar/remap_bilinear_nomask_uchar_to_uchar.h>
+   #include <baseproc/image/remap/remap_bilinear_table/remap_bilinear_table.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( remap_bilinear_table )
+
+#define ROWS 243
+#define COLS 317
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Smooth texture
+static void fill ( Rox_Image image )
+{
+   Rox_Uchar ** data = NULL;
+   rox_image_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         const Rox_Double value = 128.0 + 60.0 * sin ( 0.11 * j + 0.2 * sin ( 0.05 * i ) ) + 50.0 * sin ( 0.09 * i + 0.07 * j );
+         data[i][j] = ( Rox_Uchar ) value;
+      }
+   }
+}
+
+// Grid of a homography close to the identity, partly outside the input image
+static void warp ( Rox_MeshGrid2D_Float grid )
+{
+   Rox_MatSL3 homography = NULL;
+   rox_matsl3_new ( &homography );
+
+   rox_array2d_double_set_value ( homography, 0, 0, 1.05 );
+   rox_array2d_double_set_value ( homography, 0, 1, 0.04 );
+   rox_array2d_double_set_value ( homography, 0, 2, -7.3 );
+   rox_array2d_double_set_value ( homography, 1, 0, -0.03 );
+   rox_array2d_double_set_value ( homography, 1, 1, 0.97 );
+   rox_array2d_double_set_value ( homography, 1, 2, 5.6 );
+   rox_array2d_double_set_value ( homography, 2, 0, 1e-4 );
+
+   rox_warp_grid_sl3_float ( grid, homography );
+   rox_matsl3_del ( &homography );
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_remap_bilinear_table_uchar_to_uchar )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image input = NULL, output = NULL, reference = NULL;
+   Rox_MeshGrid2D_Float grid = NULL;
+   Rox_Remap_Table table = NULL;
+   Rox_Uint count_valid = 0, count_far = 0, count_invalid = 0;
+
+   rox_image_new ( &input, COLS, ROWS );
+   rox_image_new ( &output, COLS, ROWS );
+   rox_image_new ( &reference, COLS, ROWS );
+   rox_meshgrid2d_float_new ( &grid, ROWS, COLS );
+   fill ( input );
+   warp ( grid );
+
+   error = rox_remap_table_new ( &table, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_remap_table_set_meshgrid2d_float ( table, grid, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_remap_bilinear_table_uchar_to_uchar ( output, input, table );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_remap_bilinear_nomask_uchar_to_uchar ( reference, input, grid );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Uchar ** dout = NULL, ** dref = NULL;
+   Rox_Float ** du = NULL, ** dv = NULL;
+   rox_image_get_data_pointer_to_pointer ( &dout, output );
+   rox_image_get_data_pointer_to_pointer ( &dref, reference );
+   rox_array2d_float_get_data_pointer_to_pointer ( &du, grid->u );
+   rox_array2d_float_get_data_pointer_to_pointer ( &dv, grid->v );
+
+   // The 1/16 pixel quantization moves the result by at most one or two gray levels on this texture
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         const Rox_Float u = du[i][j], v = dv[i][j];
+
+         if ( u < -0.5f || v < -0.5f || u > COLS - 1 || v > ROWS - 1 )
+         {
+            if ( dout[i][j] != 0 ) count_invalid++;
+            continue;
+         }
+
+         if ( u < 0.0f || v < 0.0f || u > COLS - 1.5f || v > ROWS - 1.5f ) continue;
+
+         count_valid++;
+         if ( abs ( dout[i][j] - dref[i][j] ) > 2 ) count_far++;
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( count_valid > ROWS * COLS / 2, 1 );
+   ROX_TEST_CHECK_EQUAL ( count_far, 0u );
+   ROX_TEST_CHECK_EQUAL ( count_invalid, 0u );
+
+   // Sizes are checked
+   error = rox_remap_bilinear_table_uchar_to_uchar ( input, input, table );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_remap_table_set_meshgrid2d_float ( table, grid, 40000, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   rox_remap_table_del ( &table );
+   rox_meshgrid2d_float_del ( &grid );
+   rox_image_del ( &reference );
+   rox_image_del ( &output );
+   rox_image_del ( &input );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_remap_bilinear_table_uchar_to_pyramid_float )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image input = NULL, output = NULL, output_fused = NULL;
+   Rox_Image_Float normalized = NULL;
+   Rox_MeshGrid2D_Float grid = NULL;
+   Rox_Remap_Table table = NULL;
+   Rox_Pyramid_Float pyramid = NULL, pyramid_fused = NULL;
+
+   rox_image_new ( &input, COLS, ROWS );
+   rox_image_new ( &output, COLS, ROWS );
+   rox_image_new ( &output_fused, COLS, ROWS );
+   rox_array2d_float_new ( &normalized, ROWS, COLS );
+   rox_meshgrid2d_float_new ( &grid, ROWS, COLS );
+   rox_pyramid_float_new ( &pyramid, COLS, ROWS, 5, 8 );
+   rox_pyramid_float_new ( &pyramid_fused, COLS, ROWS, 5, 8 );
+   fill ( input );
+   warp ( grid );
+
+   rox_remap_table_new ( &table, ROWS, COLS );
+   rox_remap_table_set_meshgrid2d_float ( table, grid, COLS, ROWS );
+
+   // Sequential reference
+   rox_remap_bilinear_table_uchar_to_uchar ( output, input, table );
+   rox_array2d_float_from_uchar_normalize ( normalized, output );
+   rox_pyramid_float_assign ( pyramid, normalized );
+
+   error = rox_remap_bilinear_table_uchar_to_pyramid_float ( pyramid_fused, output_fused, input, table );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Uint failures = 0;
+   Rox_Uchar ** d = NULL, ** df = NULL;
+   rox_image_get_data_pointer_to_pointer ( &d, output );
+   rox_image_get_data_pointer_to_pointer ( &df, output_fused );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+         if ( d[i][j] != df[i][j] ) failures++;
+
+   for ( Rox_Uint l = 0; l < pyramid->nb_levels; l++ )
+   {
+      Rox_Sint rows = 0, cols = 0;
+      rox_array2d_float_get_size ( &rows, &cols, pyramid->levels[l] );
+
+      for ( Rox_Sint i = 0; i < rows; i++ )
+         for ( Rox_Sint j = 0; j < cols; j++ )
+            if ( pyramid->fast_access[l][i][j] != pyramid_fused->fast_access[l][i][j] ) failures++;
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+
+   rox_remap_table_del ( &table );
+   rox_pyramid_float_del ( &pyramid_fused );
+   rox_pyramid_float_del ( &pyramid );
+   rox_meshgrid2d_float_del ( &grid );
+   rox_array2d_float_del ( &normalized );
+   rox_image_del ( &output_fused );
+   rox_image_del ( &output );
+   rox_image_del ( &input );
+}
+
+ROX_TEST_SUITE_END ( )
@@ -36,42 +36,131 @@ ROX_TEST_SUITE_BEGIN(bch)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Deterministic pseudo-random numbers
+static Rox_Ulint next_random ( Rox_Ulint * state )
+{
+   *state ^= *state << 13;
+   *state ^= *state >> 7;
+   *state ^= *state << 17;
+   return *state;
+}
+
+// Random error pattern with a given number of errors on the first length bits
+static Rox_Ulint random_errors ( Rox_Ulint * state, const Rox_Sint errors, const Rox_Sint length )
+{
+   Rox_Ulint pattern = 0;
+   Rox_Sint count = 0;
+
+   while ( count < errors )
+   {
+      const Rox_Ulint bit = 1ULL << ( next_random ( state ) % length );
+      if ( pattern & bit ) continue;
+      pattern |= bit;
+      count++;
+   }
+
+   return pattern;
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_bch_c8_e8_encode)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
-
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ulint codeword = 0;
 
+   error = rox_bch_c8_e8_encode ( &codeword, 0 );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( codeword, 0ULL );
+
+   // The code is systematic, the data are the 8 most significant bits
+   for ( Rox_Sint value = 0; value < 256; value++ )
+   {
+      error = rox_bch_c8_e8_encode ( &codeword, ( Rox_Uchar ) value );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( ( Rox_Sint ) ( codeword >> 56 ), value );
+   }
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_bch_c8_e8_decode)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
-
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-
-   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ulint state = 88172645463325252ULL;
+   Rox_Uint failures = 0;
+
+   for ( Rox_Sint value = 0; value < 256; value++ )
+   {
+      Rox_Ulint codeword = 0;
+      rox_bch_c8_e8_encode ( &codeword, ( Rox_Uchar ) value );
+
+      // Up to 8 errors are corrected
+      for ( Rox_Sint errors = 0; errors <= 8; errors++ )
+      {
+         for ( Rox_Sint trial = 0; trial < 10; trial++ )
+         {
+            Rox_Uchar decoded = 0;
+            error = rox_bch_c8_e8_decode ( &decoded, codeword ^ random_errors ( &state, errors, 64 ) );
+            if ( error || decoded != value ) failures++;
+         }
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+
+   error = rox_bch_c8_e8_decode ( NULL, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_bch_c6_e2_encode)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
-
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-
-   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ushort codeword = 0;
+
+   for ( Rox_Sint value = 0; value < 64; value++ )
+   {
+      error = rox_bch_c6_e2_encode ( &codeword, ( Rox_Uchar ) value );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( codeword >> 10, value );
+   }
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_bch_c6_e2_decode)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
-
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-
-   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Uint failures = 0, detected = 0;
+   Rox_Ulint state = 2463534242ULL;
+
+   for ( Rox_Sint value = 0; value < 64; value++ )
+   {
+      Rox_Ushort codeword = 0;
+      rox_bch_c6_e2_encode ( &codeword, ( Rox_Uchar ) value );
+
+      // All the patterns of at most 2 errors are corrected
+      for ( Rox_Sint first = -1; first < 16; first++ )
+      {
+         for ( Rox_Sint second = first + 1; second <= 16; second++ )
+         {
+            Rox_Ushort pattern = 0;
+            if ( first >= 0 ) pattern |= 1 << first;
+            if ( second < 16 ) pattern |= 1 << second;
+
+            Rox_Uchar decoded = 0;
+            error = rox_bch_c6_e2_decode ( &decoded, codeword ^ pattern );
+            if ( error || decoded != value ) failures++;
+         }
+      }
+
+      // Most of the patterns of 3 errors are detected
+      for ( Rox_Sint trial = 0; trial < 10; trial++ )
+      {
+         Rox_Uchar decoded = 0;
+         error = rox_bch_c6_e2_decode ( &decoded, codeword ^ ( Rox_Ushort ) random_errors ( &state, 3, 16 ) );
+         if ( error ) detected++;
+      }
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+   ROX_TEST_CHECK_EQUAL ( detected > 320u, 1 );
 }
 
 ROX_TEST_SUITE_END()
@@ -18,7 +18,12 @@
 
 extern "C"
 {
+	#include <math.h>
 	#include <system/memory/datatypes.h>
+	#include <baseproc/geometry/point/point3d_struct.h>
+	#include <baseproc/maths/linalg/matse3.h>
+	#include <baseproc/maths/linalg/matsl3.h>
+	#include <baseproc/maths/linalg/matut3.h>
 	#include <core/calibration/stereo/stereo_calibration.h>
 }
 
@@ -26,16 +31,88 @@ extern "C"
 
 ROX_TEST_SUITE_BEGIN(stereo_calibration)
 
+#define GRID_WIDTH  8
+#define GRID_HEIGHT 6
+#define GRID_SIZE   0.03
+#define NB_VIEWS    6
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
 
 //=== INTERNAL VARIABLES =======================================================
 
+// Intrinsics f, cu, cv of the left and right cameras
+static const Rox_Double Kl_ref[3] = { 800.0, 322.0, 236.0 };
+static const Rox_Double Kr_ref[3] = { 780.0, 316.0, 244.0 };
+
+// Rotations around the x and y axes in radians, the grid is seen from about 0.5 m
+static const Rox_Double view_angles[NB_VIEWS][2] =
+{
+   {  0.35,  0.00 }, { -0.35,  0.10 }, {  0.00,  0.40 },
+   {  0.10, -0.40 }, {  0.30,  0.30 }, { -0.25, -0.30 }
+};
+
 //=== INTERNAL FUNCTDEFS =======================================================
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Pose of the grid in the left camera frame
+static void left_pose ( Rox_Double R[3][3], Rox_Double t[3], const Rox_Sint view )
+{
+   const Rox_Double a = view_angles[view][0], b = view_angles[view][1];
+   const Rox_Double cx = 0.5 * ( GRID_WIDTH - 1 ) * GRID_SIZE, cy = 0.5 * ( GRID_HEIGHT - 1 ) * GRID_SIZE;
+
+   // R = Rx(a) * Ry(b), the center of the grid is on the optical axis at 0.5 m
+   R[0][0] = cos(b);            R[0][1] = 0.0;    R[0][2] = sin(b);
+   R[1][0] = sin(a) * sin(b);   R[1][1] = cos(a); R[1][2] = -sin(a) * cos(b);
+   R[2][0] = -cos(a) * sin(b);  R[2][1] = sin(a); R[2][2] = cos(a) * cos(b);
+
+   for ( Rox_Sint k = 0; k < 3; k++ ) t[k] = - R[k][0] * cx - R[k][1] * cy;
+   t[2] += 0.5;
+}
+
+// Pose of the left camera in the right camera frame, a 12 cm baseline with a small vergence
+static void stereo_pose ( Rox_Double R[3][3], Rox_Double t[3] )
+{
+   const Rox_Double b = 0.05;
+
+   R[0][0] = cos(b);  R[0][1] = 0.0; R[0][2] = sin(b);
+   R[1][0] = 0.0;     R[1][1] = 1.0; R[1][2] = 0.0;
+   R[2][0] = -sin(b); R[2][1] = 0.0; R[2][2] = cos(b);
+
+   t[0] = -0.12; t[1] = 0.005; t[2] = 0.01;
+}
+
+// Homography from the grid plane (meters) to the image (pixels) and projection of the grid
+static void project_grid ( Rox_MatSL3 G, Rox_Point2D_Double_Struct * points, const Rox_Double f[3], Rox_Double R[3][3], Rox_Double t[3] )
+{
+   Rox_Double ** dg = NULL;
+   const Rox_Double K[3][3] = { { f[0], 0.0, f[1] }, { 0.0, f[0], f[2] }, { 0.0, 0.0, 1.0 } };
+   const Rox_Double M[3][3] = { { R[0][0], R[0][1], t[0] }, { R[1][0], R[1][1], t[1] }, { R[2][0], R[2][1], t[2] } };
+
+   rox_array2d_double_get_data_pointer_to_pointer ( &dg, G );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         dg[i][j] = K[i][0] * M[0][j] + K[i][1] * M[1][j] + K[i][2] * M[2][j];
+      }
+   }
+
+   for ( Rox_Sint i = 0; i < GRID_HEIGHT; i++ )
+   {
+      for ( Rox_Sint j = 0; j < GRID_WIDTH; j++ )
+      {
+         const Rox_Double X = j * GRID_SIZE, Y = i * GRID_SIZE;
+         const Rox_Double w = dg[2][0] * X + dg[2][1] * Y + dg[2][2];
+         points[i * GRID_WIDTH + j].u = ( dg[0][0] * X + dg[0][1] * Y + dg[0][2] ) / w;
+         points[i * GRID_WIDTH + j].v = ( dg[1][0] * X + dg[1][1] * Y + dg[1][2] ) / w;
+      }
+   }
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_calibration_stereo_perspective_new)
@@ -112,11 +189,112 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_calibration_stereo_perspective_proc
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_calibration_stereo_perspective_make)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Calibration_Stereo_Perspective calibration = NULL;
+   Rox_MatSL3 Gl = NULL, Gr = NULL;
+   Rox_MatUT3 Kl = NULL, Kr = NULL;
+   Rox_MatSE3 pose = NULL;
+   Rox_Point3D_Double_Struct model[GRID_WIDTH * GRID_HEIGHT];
+   Rox_Point2D_Double_Struct left[GRID_WIDTH * GRID_HEIGHT], right[GRID_WIDTH * GRID_HEIGHT];
+   Rox_Double Rs[3][3], ts[3];
+   Rox_Double ** dkl = NULL, ** dkr = NULL, ** dp = NULL;
+
+   error = rox_calibration_stereo_perspective_new ( &calibration );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   for ( Rox_Sint i = 0; i < GRID_HEIGHT; i++ )
+   {
+      for ( Rox_Sint j = 0; j < GRID_WIDTH; j++ )
+      {
+         model[i * GRID_WIDTH + j].X = j * GRID_SIZE;
+         model[i * GRID_WIDTH + j].Y = i * GRID_SIZE;
+         model[i * GRID_WIDTH + j].Z = 0.0;
+      }
+   }
+
+   error = rox_calibration_stereo_perspective_set_model_points ( calibration, model, GRID_WIDTH * GRID_HEIGHT );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
+   error = rox_matsl3_new ( &Gl );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matsl3_new ( &Gr );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   stereo_pose ( Rs, ts );
+
+   // Exact projections of the grid in both cameras
+   for ( Rox_Sint k = 0; k < NB_VIEWS; k++ )
+   {
+      Rox_Double Rl[3][3], tl[3], Rr[3][3], tr[3];
+
+      left_pose ( Rl, tl, k );
+
+      for ( Rox_Sint i = 0; i < 3; i++ )
+      {
+         tr[i] = ts[i];
+         for ( Rox_Sint j = 0; j < 3; j++ )
+         {
+            Rr[i][j] = Rs[i][0] * Rl[0][j] + Rs[i][1] * Rl[1][j] + Rs[i][2] * Rl[2][j];
+            tr[i] += Rs[i][j] * tl[j];
+         }
+      }
+
+      project_grid ( Gl, left, Kl_ref, Rl, tl );
+      project_grid ( Gr, right, Kr_ref, Rr, tr );
+
+      error = rox_calibration_stereo_perspective_add_current_points ( calibration, left, right, GRID_WIDTH * GRID_HEIGHT );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_calibration_stereo_perspective_add_current_homographies ( calibration, Gl, Gr );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   // The linear estimation and the Schur reduced refinement recover the intrinsics and the stereo pose
+   error = rox_calibration_stereo_perspective_make ( calibration );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matut3_new ( &Kl );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matut3_new ( &Kr );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matse3_new ( &pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_calibration_stereo_perspective_get_results ( Kl, Kr, pose, calibration );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_double_get_data_pointer_to_pointer ( &dkl, Kl );
+   rox_array2d_double_get_data_pointer_to_pointer ( &dkr, Kr );
+   rox_array2d_double_get_data_pointer_to_pointer ( &dp, pose );
+
+   ROX_TEST_CHECK_CLOSE ( dkl[0][0], Kl_ref[0], 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dkl[1][1], Kl_ref[0], 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dkl[0][2], Kl_ref[1], 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dkl[1][2], Kl_ref[2], 1e-4 );
+
+   ROX_TEST_CHECK_CLOSE ( dkr[0][0], Kr_ref[0], 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dkr[1][1], Kr_ref[0], 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dkr[0][2], Kr_ref[1], 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dkr[1][2], Kr_ref[2], 1e-4 );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         ROX_TEST_CHECK_CLOSE ( dp[i][j], Rs[i][j], 1e-6 );
+      }
+      ROX_TEST_CHECK_CLOSE ( dp[i][3], ts[i], 1e-6 );
+   }
+
+   rox_matsl3_del ( &Gl );
+   rox_matsl3_del ( &Gr );
+   rox_matut3_del ( &Kl );
+   rox_matut3_del ( &Kr );
+   rox_matse3_del ( &pose );
+   rox_calibration_stereo_perspective_del ( &calibration );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_calibration_stereo_perspective_set_resolution)
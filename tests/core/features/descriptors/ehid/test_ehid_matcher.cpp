@@ -16,61 +16,453 @@
 
 #include <openrox_tests.hpp>
 
+#include <math.h>
+#include <vector>
+
 extern "C"
 {
 	#include <core/features/descriptors/ehid/ehid_matcher.h>
+	#include <core/features/descriptors/ehid/ehid_matcher_struct.h>
+	#include <core/features/descriptors/ehid/ehid_compiler.h>
+	#include <core/features/descriptors/ehid/ehid_database_struct.h>
+	#include <core/features/descriptors/ehid/ehid_target.h>
+	#include <core/features/descriptors/ehid/ehid_target_struct.h>
+	#include <core/features/descriptors/ehid/ehid_match_struct.h>
+	#include <core/features/descriptors/ehid/ehid_searchtree.h>
+	#include <generated/dynvec_ehid_point_struct.h>
+	#include <generated/dynvec_ehid_dbindex_struct.h>
+	#include <generated/objset_ehid_target_struct.h>
+	#include <baseproc/maths/maths_macros.h>
+	#include <baseproc/maths/base/basemaths.h>
+	#include <baseproc/maths/linalg/matut3.h>
+	#include <baseproc/geometry/transforms/transform_tools.h>
 }
 
 //=== INTERNAL MACROS    =======================================================
 
 ROX_TEST_SUITE_BEGIN(ehid_matcher)
 
+#define NB_TARGETS 5
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
 
 //=== INTERNAL VARIABLES =======================================================
 
+// Number of points per target, the targets are ranked 1, 3, 2, 4, 0 by votes (ties by index)
+static const Rox_Uint target_sizes[NB_TARGETS] = { 8, 20, 16, 20, 12 };
+
 //=== INTERNAL FUNCTDEFS =======================================================
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Deterministic 64 bits generator for the descriptions
+static Rox_Ulint next_random ( Rox_Ulint * state )
+{
+   *state ^= *state << 13;
+   *state ^= *state >> 7;
+   *state ^= *state << 17;
+   return *state;
+}
+
+// Compile a database of 640x480 pixels (0.64x0.48 meters) targets with random descriptions
+static Rox_ErrorCode build_database ( Rox_Ehid_Database db )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ehid_Compiler compiler = NULL;
+   Rox_DynVec_Ehid_Point points = NULL;
+   Rox_DynVec_Ehid_DbIndex indices = NULL;
+   Rox_Ulint state = 88172645463325252ull;
+   Rox_Uint uid = 0;
+
+   error = rox_ehid_compiler_new ( &compiler );
+   if ( error ) goto function_terminate;
+
+   error = rox_dynvec_ehid_point_new ( &points, 32 );
+   if ( error ) goto function_terminate;
+
+   error = rox_dynvec_ehid_dbindex_new ( &indices, 32 );
+   if ( error ) goto function_terminate;
+
+   for ( Rox_Uint idtarget = 0; idtarget < NB_TARGETS; idtarget++ )
+   {
+      rox_dynvec_ehid_point_reset ( points );
+      rox_dynvec_ehid_dbindex_reset ( indices );
+
+      for ( Rox_Uint k = 0; k < target_sizes[idtarget]; k++, uid++ )
+      {
+         Rox_Ehid_Point_Struct point;
+         Rox_Ehid_DbIndex_Struct index;
+
+         // Well spread points of a 6 columns grid
+         point.pos.u = 60.0 + 100.0 * ( k % 6 ) + 7.0 * idtarget;
+         point.pos.v = 60.0 + 90.0 * ( k / 6 ) + 5.0 * idtarget;
+         point.dir.u = 1.0;
+         point.dir.v = 0.0;
+         point.scale = 1.0;
+         point.refcount = 0;
+         point.index = uid % INDEX_MAX_VAL;
+
+         for ( Rox_Sint w = 0; w < 5; w++ ) point.Description[w] = (Rox_Int64) next_random ( &state );
+         point.Description[5] = 0;
+
+         memset ( index.flag_indices, 0, sizeof ( index.flag_indices ) );
+         index.flag_indices[point.index] = 1;
+
+         error = rox_dynvec_ehid_point_append ( points, &point );
+         if ( error ) goto function_terminate;
+
+         error = rox_dynvec_ehid_dbindex_append ( indices, &index );
+         if ( error ) goto function_terminate;
+      }
+
+      error = rox_ehid_compiler_add_db ( compiler, points, indices, 640, 480, 0.64, 0.48 );
+      if ( error ) goto function_terminate;
+   }
+
+   error = rox_ehid_compiler_compile ( db, compiler );
+
+function_terminate:
+   rox_dynvec_ehid_point_del ( &points );
+   rox_dynvec_ehid_dbindex_del ( &indices );
+   rox_ehid_compiler_del ( &compiler );
+   return error;
+}
+
+// Detected feature seen at the position of a reference point, the score is the number of bits shared with the reference
+static void make_detected ( Rox_Ehid_Point_Struct * cur, const Rox_Ehid_Point_Struct * ref, const Rox_Double angle, const Rox_Uint score )
+{
+   *cur = *ref;
+   cur->dir.u = cos ( angle ) * ref->dir.u - sin ( angle ) * ref->dir.v;
+   cur->dir.v = sin ( angle ) * ref->dir.u + cos ( angle ) * ref->dir.v;
+
+   for ( Rox_Sint w = 0; w < 5; w++ ) cur->Description[w] = ~ref->Description[w];
+   cur->Description[5] = 0;
+
+   // Share the lowest set bits of the first word
+   Rox_Ulint word = (Rox_Ulint) ref->Description[0];
+   for ( Rox_Uint k = 0; k < score && word; k++ )
+   {
+      const Rox_Ulint bit = word & ( ~word + 1 );
+      cur->Description[0] |= (Rox_Int64) bit;
+      word &= ~bit;
+   }
+}
+
+// Index of the target of a ranked candidate
+static Rox_Uint candidate_target ( const Rox_Ehid_Matcher matcher, const Rox_Uint rank )
+{
+   return 0xFFFFFFFFu - (Rox_Uint) ( matcher->candidates->data[rank] & 0xFFFFFFFF );
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_ehid_matcher_new)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ehid_Matcher matcher = NULL;
+
+   error = rox_ehid_matcher_new ( NULL, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   error = rox_ehid_matcher_new ( &matcher, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( matcher->max_templates_per_query, 2u );
 
+   error = rox_ehid_matcher_del ( &matcher );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_ehid_matcher_del)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ehid_Matcher matcher = NULL;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   error = rox_ehid_matcher_del ( NULL );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   error = rox_ehid_matcher_del ( &matcher );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+}
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_ehid_matcher_dispatch_matches)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ehid_Database db = NULL;
+   Rox_Ehid_Matcher matcher = NULL;
+   Rox_DynVec_Ehid_Point detected = NULL;
+   Rox_DynVec_Ehid_Match results = NULL;
+   std::vector<Rox_Ehid_Match_Struct> buckets[NB_TARGETS][36];
+
+   error = rox_ehid_database_new ( &db );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
+   error = build_database ( db );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_ehid_matcher_new ( &matcher, NB_TARGETS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_ehid_point_new ( &detected, 100 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_ehid_match_new ( &results, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Rotated features spread over the viewpoints, some secondary matches and some features seen three times
+   for ( Rox_Uint idref = 0; idref < db->_fulllist->used; idref++ )
+   {
+      Rox_Ehid_Point_Struct cur;
+      const Rox_Double angle = fmod ( 0.37 * idref, ROX_2PI ) - ROX_PI;
+      const Rox_Uint score = ( idref % 5 == 0 ) ? 3 : ( idref % 3 == 0 ? 1 : 0 );
+      const Rox_Uint copies = ( idref % 7 == 0 ) ? 3 : 1;
+
+      make_detected ( &cur, &db->_fulllist->data[idref], angle, score );
+
+      for ( Rox_Uint k = 0; k < copies; k++ )
+      {
+         error = rox_dynvec_ehid_point_append ( detected, &cur );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      }
+   }
+
+   error = rox_ehid_matcher_dispatch_matches ( matcher, db, detected );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Uint total = 0;
+   for ( Rox_Uint idtarget = 0; idtarget < NB_TARGETS; idtarget++ )
+   {
+      Rox_Ehid_Target target = db->_targets->data[idtarget];
+      for ( Rox_Sint idvp = 0; idvp < 18; idvp++ )
+      {
+         Rox_DynVec_Ehid_Match primary = target->primarymatches[idvp];
+         Rox_DynVec_Ehid_Match secondary = target->secondarymatches[idvp];
+         buckets[idtarget][idvp].assign ( primary->data, primary->data + primary->used );
+         buckets[idtarget][18 + idvp].assign ( secondary->data, secondary->data + secondary->used );
+         total += primary->used + secondary->used;
+      }
+   }
+
+   // Every detected feature found its reference
+   ROX_TEST_CHECK_EQUAL ( total, detected->used );
+
+   // Reference: the matches appended one by one to the buckets of their target, then cleaned up
+   for ( Rox_Uint idtarget = 0; idtarget < NB_TARGETS; idtarget++ )
+   {
+      rox_ehid_target_reset ( db->_targets->data[idtarget] );
+   }
+
+   for ( Rox_Uint idref = 0; idref < db->_fulllist->used; idref++ )
+   {
+      db->_fulllist->data[idref].refcount = 0;
+   }
+
+   for ( Rox_Uint idcur = 0; idcur < detected->used; idcur++ )
+   {
+      Rox_Ehid_Point cur = &detected->data[idcur];
+
+      if ( rox_ehid_searchtree_lookup ( results, db->_trees[cur->index], cur->Description ) ) continue;
+
+      for ( Rox_Uint idmatch = 0; idmatch < results->used; idmatch++ )
+      {
+         Rox_Ehid_Match_Struct match;
+         Rox_Ehid_Point ref = &db->_fulllist->data[results->data[idmatch].dbid];
+
+         if ( results->data[idmatch].score > 4 ) continue;
+
+         match.curid = idcur;
+         match.dbid = results->data[idmatch].dbid;
+         match.score = results->data[idmatch].score;
+
+         const Rox_Double cosdif = cur->dir.u * ref->dir.u + cur->dir.v * ref->dir.v;
+         const Rox_Double sindif = cur->dir.u * ref->dir.v - cur->dir.v * ref->dir.u;
+         match.roterr = (Rox_Double) fast_atan2f2 ( (Rox_Float) sindif, (Rox_Float) cosdif );
+
+         Rox_Uint binangle = (Rox_Uint) ( 18.0 * ( ROX_PI + match.roterr ) / ROX_2PI );
+         if ( binangle == 18 ) binangle = 0;
+
+         Rox_Ehid_Target target = db->_targets->data[ref->dbid];
+         if ( match.score <= 2 )
+         {
+            rox_dynvec_ehid_match_append ( target->primarymatches[binangle], &match );
+         }
+         else
+         {
+            rox_dynvec_ehid_match_append ( target->secondarymatches[binangle], &match );
+         }
+
+         ref->refcount++;
+      }
+   }
+
+   for ( Rox_Uint idtarget = 0; idtarget < NB_TARGETS; idtarget++ )
+   {
+      rox_ehid_target_cleanup ( db->_targets->data[idtarget], detected, db->_fulllist );
+   }
+
+   // Same content in the same order
+   Rox_Uint used_viewpoints = 0, secondaries = 0;
+   for ( Rox_Uint idtarget = 0; idtarget < NB_TARGETS; idtarget++ )
+   {
+      Rox_Ehid_Target target = db->_targets->data[idtarget];
+      for ( Rox_Sint idbucket = 0; idbucket < 36; idbucket++ )
+      {
+         Rox_DynVec_Ehid_Match vec = ( idbucket < 18 ) ? target->primarymatches[idbucket] : target->secondarymatches[idbucket - 18];
+         const std::vector<Rox_Ehid_Match_Struct> & dispatched = buckets[idtarget][idbucket];
+
+         ROX_TEST_CHECK_EQUAL ( (size_t) vec->used, dispatched.size ( ) );
+         if ( vec->used != dispatched.size ( ) ) continue;
+
+         for ( Rox_Uint idmatch = 0; idmatch < vec->used; idmatch++ )
+         {
+            ROX_TEST_CHECK_EQUAL ( vec->data[idmatch].curid, dispatched[idmatch].curid );
+            ROX_TEST_CHECK_EQUAL ( vec->data[idmatch].dbid, dispatched[idmatch].dbid );
+            ROX_TEST_CHECK_EQUAL ( vec->data[idmatch].score, dispatched[idmatch].score );
+            ROX_TEST_CHECK_EQUAL ( vec->data[idmatch].roterr, dispatched[idmatch].roterr );
+         }
+
+         used_viewpoints += ( vec->used > 0 );
+         if ( idbucket >= 18 ) secondaries += vec->used;
+      }
+   }
+
+   // The data covers several viewpoints and both kinds of matches
+   ROX_TEST_CHECK ( used_viewpoints > 20 );
+   ROX_TEST_CHECK ( secondaries > 0 );
+
+   rox_dynvec_ehid_match_del ( &results );
+   rox_dynvec_ehid_point_del ( &detected );
+   rox_ehid_matcher_del ( &matcher );
+   rox_ehid_database_del ( &db );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_ehid_matcher_match_se3)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ehid_Database db = NULL;
+   Rox_Ehid_Matcher matcher = NULL;
+   Rox_DynVec_Ehid_Point detected = NULL;
+   Rox_MatUT3 calib = NULL;
+   const Rox_Uint ranking[NB_TARGETS] = { 1, 3, 2, 4, 0 };
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   error = rox_ehid_database_new ( &db );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = build_database ( db );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
+   error = rox_dynvec_ehid_point_new ( &detected, 100 );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // All the targets are seen in front of the camera, with the calibration of the templates
+   for ( Rox_Uint idref = 0; idref < db->_fulllist->used; idref++ )
+   {
+      Rox_Ehid_Point_Struct cur;
+      make_detected ( &cur, &db->_fulllist->data[idref], 0.0, 0 );
+
+      error = rox_dynvec_ehid_point_append ( detected, &cur );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_matut3_new ( &calib );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_transformtools_build_calibration_matrix_for_template ( calib, 640, 480, 0.64, 0.48 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Uint max_found = 1; max_found <= 3; max_found++ )
+   {
+      error = rox_ehid_matcher_new ( &matcher, max_found );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_ehid_matcher_match_se3 ( matcher, db, detected, calib );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      // The first round ranked all the targets by votes, then by index
+      ROX_TEST_CHECK_EQUAL ( matcher->candidates->used, (Rox_Uint) NB_TARGETS );
+      for ( Rox_Uint rank = 0; rank < matcher->candidates->used && rank < NB_TARGETS; rank++ )
+      {
+         ROX_TEST_CHECK_EQUAL ( candidate_target ( matcher, rank ), ranking[rank] );
+      }
+
+      // The best ranked targets were verified and the search stopped at max_found targets
+      for ( Rox_Uint rank = 0; rank < NB_TARGETS; rank++ )
+      {
+         Rox_Ehid_Target target = db->_targets->data[ranking[rank]];
+
+         if ( rank < max_found )
+         {
+            ROX_TEST_CHECK_EQUAL ( matcher->verified->data[rank], 1u );
+            ROX_TEST_CHECK_EQUAL ( target->posefound, 1u );
+
+            // The viewpoints of a found target are ignored
+            rox_ehid_target_compute_stats ( target );
+            ROX_TEST_CHECK_EQUAL ( target->bestvpcard, 0u );
+         }
+         else
+         {
+            ROX_TEST_CHECK_EQUAL ( target->posefound, 0u );
+
+            // The targets ranked after the last required one keep their votes
+            rox_ehid_target_compute_stats ( target );
+            ROX_TEST_CHECK_EQUAL ( target->bestvpcard, target_sizes[ranking[rank]] );
+         }
+      }
+
+      error = rox_ehid_matcher_del ( &matcher );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   rox_matut3_del ( &calib );
+   rox_dynvec_ehid_point_del ( &detected );
+   rox_ehid_database_del ( &db );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_ehid_matcher_match_sl3)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Ehid_Database db = NULL;
+   Rox_Ehid_Matcher matcher = NULL;
+   Rox_DynVec_Ehid_Point detected = NULL;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   error = rox_ehid_database_new ( &db );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = build_database ( db );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_ehid_point_new ( &detected, 100 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Only the targets 1 and 4 are seen
+   for ( Rox_Uint idref = 0; idref < db->_fulllist->used; idref++ )
+   {
+      Rox_Ehid_Point_Struct cur;
+      const Rox_Uint idtarget = db->_fulllist->data[idref].dbid;
+      if ( idtarget != 1 && idtarget != 4 ) continue;
 
+      make_detected ( &cur, &db->_fulllist->data[idref], 0.0, 0 );
+
+      error = rox_dynvec_ehid_point_append ( detected, &cur );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   // The homographies are searched for all the targets, whatever the maximum of the se3 search
+   error = rox_ehid_matcher_new ( &matcher, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_ehid_matcher_match_sl3 ( matcher, db, detected );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Uint idtarget = 0; idtarget < NB_TARGETS; idtarget++ )
+   {
+      ROX_TEST_CHECK_EQUAL ( db->_targets->data[idtarget]->posefound, ( idtarget == 1 || idtarget == 4 ) ? 1u : 0u );
+   }
+
+   rox_ehid_matcher_del ( &matcher );
+   rox_dynvec_ehid_point_del ( &detected );
+   rox_ehid_database_del ( &db );
 }
 
 ROX_TEST_SUITE_END()
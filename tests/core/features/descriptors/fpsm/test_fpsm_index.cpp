@@ -16,10 +16,22 @@
 
 #include <openrox_tests.hpp>
 
-#include <core/features/descriptors/fpsm/fpsm_index.h>
+extern "C"
+{
+   #include <core/features/descriptors/fpsm/fpsm_index.h>
+   #include <generated/dynvec_fpsm_feature_struct.h>
+   #include <generated/dynvec_sint_struct.h>
+   #include <baseproc/maths/maths_macros.h>
+}
+
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
 
 //=== INTERNAL MACROS    =======================================================
 
+#define NB_OBJECTS 8
+
 ROX_TEST_SUITE_BEGIN(fpsm_index)
 
 //=== INTERNAL TYPESDEFS =======================================================
@@ -32,51 +44,268 @@ ROX_TEST_SUITE_BEGIN(fpsm_index)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
-//=== EXPORTED FUNCTIONS =======================================================
+// Deterministic pseudo random features, seed identifies the view
+static void make_feature ( Rox_Fpsm_Feature_Struct * feature, Rox_Uint m, Rox_Uint seed )
+{
+   Rox_Uint state = 1013904223u * ( seed + 1 );
+
+   feature->top = 0;
+   feature->left = 0;
 
+   for ( Rox_Uint i = 0; i < m; i++ )
+   {
+      state = state * 1664525u + 1013904223u;
+      feature->angles[i] = ( ( state >> 8 ) / 16777216.0 ) * 2.0 * ROX_PI - ROX_PI;
+      state = state * 1664525u + 1013904223u;
+      feature->distances[i] = ( ( state >> 8 ) / 16777216.0 ) * 10.0;
+   }
+}
 
-ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_new)
+static Rox_ErrorCode make_object ( Rox_DynVec_Fpsm_Feature features, Rox_Uint m, Rox_Uint nbviews, Rox_Uint seed, Rox_Double scale = 1.0 )
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Fpsm_Feature_Struct feature;
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
-   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_dynvec_fpsm_feature_reset ( features );
+   for ( Rox_Uint i = 0; i < nbviews; i++ )
+   {
+      make_feature ( &feature, m, seed + i );
+      for ( Rox_Uint k = 0; k < m; k++ ) feature.distances[k] *= scale;
+      error = rox_dynvec_fpsm_feature_append ( features, &feature );
+      if ( error ) return error;
+   }
+
+   return error;
 }
 
-ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_del)
+//=== EXPORTED FUNCTIONS =======================================================
+
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_new_del)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Fpsm_Index index = NULL;
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
+   error = rox_fpsm_index_new ( NULL, 4, 8, 16, 10, 32, 32 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   error = rox_fpsm_index_new ( &index, 4, 8, 16, 10, 32, 32 );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
-}
 
-ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_init)
-{
-   Rox_ErrorCode error = ROX_ERROR_NONE;
+   error = rox_fpsm_index_init ( index );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->postings->used, 4u * 8u * 16u );
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
+   error = rox_fpsm_index_del ( &index );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_del ( &index );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
 }
 
-ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_append_object)
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_append_search_remove)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Fpsm_Index index = NULL;
+   Rox_DynVec_Fpsm_Feature features = NULL;
+   Rox_Fpsm_Feature_Struct query;
+   const Rox_Uint m = 16;
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
+   error = rox_fpsm_index_new ( &index, 4, 8, m, 10, 32, 32 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_init ( index );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_fpsm_feature_new ( &features, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Three objects with views generated from distinct seeds
+   for ( Rox_Uint idobject = 0; idobject < 3; idobject++ )
+   {
+      error = make_object ( features, m, 3 + idobject, 100 * idobject );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_fpsm_index_append_object ( index, features, idobject );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   // An object can not be appended twice
+   error = rox_fpsm_index_append_object ( index, features, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   // A view of the database gets all the votes of its cells
+   make_feature ( &query, m, 101 );
+   error = rox_fpsm_index_search ( index, &query );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->results->used, 1u );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].object_id, 1 );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].view_id, 1 );
+
+   // Votes are cleared between searches
+   make_feature ( &query, m, 202 );
+   error = rox_fpsm_index_search ( index, &query );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->results->used, 1u );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].object_id, 2 );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].view_id, 2 );
+
+   // Removed objects are no longer found
+   error = rox_fpsm_index_remove_object ( index, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_remove_object ( index, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   make_feature ( &query, m, 101 );
+   error = rox_fpsm_index_search ( index, &query );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->results->used, 0u );
+
+   // A new object reuses the released slots
+   Rox_Uint nbslots = index->views->used;
+
+   error = make_object ( features, m, 4, 300 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_append_object ( index, features, 7 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->views->used, nbslots + 0 );
+
+   make_feature ( &query, m, 303 );
+   error = rox_fpsm_index_search ( index, &query );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->results->used, 1u );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].object_id, 7 );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].view_id, 3 );
+
+   // The first object is still there
+   make_feature ( &query, m, 0 );
+   error = rox_fpsm_index_search ( index, &query );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index->results->used, 1u );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].object_id, 0 );
+   ROX_TEST_CHECK_EQUAL ( index->results->data[0].view_id, 0 );
+
+   error = rox_dynvec_fpsm_feature_del ( &features );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_del ( &index );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
-ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_search)
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_fpsm_index_append_parallel)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Fpsm_Index serial = NULL, parallel = NULL;
+   Rox_DynVec_Fpsm_Feature objects[NB_OBJECTS] = { NULL };
+   const Rox_Uint m = 16;
+
+   error = rox_fpsm_index_new ( &serial, 4, 8, m, 10, 32, 32 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_new ( &parallel, 4, 8, m, 10, 32, 32 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_init ( serial );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_fpsm_index_init ( parallel );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The objects have different distance scales, so the first appended one would give a different quantization
+   for ( Rox_Uint idobject = 0; idobject < NB_OBJECTS; idobject++ )
+   {
+      error = rox_dynvec_fpsm_feature_new ( &objects[idobject], 10 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = make_object ( objects[idobject], m, 3, 100 * idobject, 1.0 + idobject );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+#ifdef ROX_USES_OPENMP
+   // Without a scale, the first object can not be appended concurrently
+   Rox_ErrorCode errors[2] = { ROX_ERROR_NONE, ROX_ERROR_NONE };
+
+   #pragma omp parallel num_threads(2)
+   {
+      if ( omp_get_num_threads ( ) == 2 ) errors[omp_get_thread_num ( )] = rox_fpsm_index_append_object ( parallel, objects[omp_get_thread_num ( )], omp_get_thread_num ( ) );
+   }
+   ROX_TEST_CHECK_EQUAL ( errors[0], ROX_ERROR_INVALID_VALUE );
+   ROX_TEST_CHECK_EQUAL ( errors[1], ROX_ERROR_INVALID_VALUE );
+   ROX_TEST_CHECK_EQUAL ( parallel->views->used, 0u );
+#endif
+
+   error = rox_fpsm_index_set_maxdist ( serial, objects, NB_OBJECTS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The scale is the largest distance of all the objects
+   Rox_Double maxdist = 0;
+   for ( Rox_Uint idobject = 0; idobject < NB_OBJECTS; idobject++ )
+      for ( Rox_Uint idview = 0; idview < objects[idobject]->used; idview++ )
+         for ( Rox_Uint k = 0; k < m; k++ )
+            if ( objects[idobject]->data[idview].distances[k] > maxdist ) maxdist = objects[idobject]->data[idview].distances[k];
+
+   ROX_TEST_CHECK_EQUAL ( serial->maxdist, maxdist );
+
+   error = rox_fpsm_index_set_maxdist ( parallel, objects, NB_OBJECTS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The last object is appended first in the serial index
+   for ( Rox_Sint idobject = NB_OBJECTS - 1; idobject >= 0; idobject-- )
+   {
+      error = rox_fpsm_index_append_object ( serial, objects[idobject], idobject );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   Rox_ErrorCode parallel_errors[NB_OBJECTS];
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for num_threads(4) schedule(dynamic)
+#endif
+   for ( Rox_Sint idobject = 0; idobject < NB_OBJECTS; idobject++ )
+   {
+      parallel_errors[idobject] = rox_fpsm_index_append_object ( parallel, objects[idobject], idobject );
+   }
+
+   for ( Rox_Sint idobject = 0; idobject < NB_OBJECTS; idobject++ )
+   {
+      ROX_TEST_CHECK_EQUAL ( parallel_errors[idobject], ROX_ERROR_NONE );
+   }
+
+   // The scale can not change once views are indexed
+   error = rox_fpsm_index_set_maxdist ( parallel, objects, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   // Each view has the same signatures in both indexes, whatever the slot it was given
+   ROX_TEST_CHECK_EQUAL ( serial->views->used, parallel->views->used );
+
+   Rox_Uint nbdiff = 0;
+   for ( Rox_Uint slot = 0; slot < parallel->views->used; slot++ )
+   {
+      for ( Rox_Uint other = 0; other < serial->views->used; other++ )
+      {
+         if ( serial->views->data[other].object_id != parallel->views->data[slot].object_id ) continue;
+         if ( serial->views->data[other].view_id != parallel->views->data[slot].view_id ) continue;
+
+         for ( Rox_Uint k = 0; k < m; k++ )
+         {
+            if ( serial->signatures->data[other * m + k] != parallel->signatures->data[slot * m + k] ) nbdiff++;
+         }
+      }
+   }
+   ROX_TEST_CHECK_EQUAL ( nbdiff, 0u );
+
+   for ( Rox_Uint idobject = 0; idobject < NB_OBJECTS; idobject++ )
+   {
+      error = rox_dynvec_fpsm_feature_del ( &objects[idobject] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_fpsm_index_del ( &serial );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
+   error = rox_fpsm_index_del ( &parallel );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
@@ -16,12 +16,21 @@
 
 #include <openrox_tests.hpp>
 
-#include <core/features/descriptors/sraid/kdtree_sraid.h>
+#include <string.h>
+
+extern "C"
+{
+   #include <generated/dynvec_sraiddesc_struct.h>
+   #include <core/features/descriptors/sraid/kdtree_sraid.h>
+   #include <core/features/descriptors/sraid/sraiddesc_struct.h>
+}
 
 //=== INTERNAL MACROS    =======================================================
 
 ROX_TEST_SUITE_BEGIN(kdtree_sraid)
 
+#define COUNT_FEATURES 500
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
@@ -32,6 +41,30 @@ ROX_TEST_SUITE_BEGIN(kdtree_sraid)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Fill a set of features with pseudo random descriptors
+static Rox_ErrorCode fill_features ( Rox_DynVec_SRAID_Feature features, Rox_Uint count )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_SRAID_Feature_Struct feat;
+   Rox_Uint seed = 12345;
+
+   memset ( &feat, 0, sizeof ( feat ) );
+
+   for ( Rox_Uint i = 0; i < count; i++ )
+   {
+      for ( Rox_Uint k = 0; k < ROX_SRAID_DESCRIPTOR_SIZE; k++ )
+      {
+         seed = seed * 1103515245u + 12345u;
+         feat.descriptor[k] = ( seed >> 16 ) & 0xFF;
+      }
+
+      error = rox_dynvec_sraiddesc_append ( features, &feat );
+      if ( error ) return error;
+   }
+
+   return error;
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 
@@ -74,10 +107,48 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_kdtree_sraid_build)
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_kdtree_sraid_search)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_DynVec_SRAID_Feature features = NULL;
+   Rox_Kdtree_Sraid kdtree = NULL;
+   Rox_SRAID_MatchResultSet results = NULL;
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
+   error = rox_dynvec_sraiddesc_new ( &features, 100 );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = fill_features ( features, COUNT_FEATURES );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_kdtree_sraid_new ( &kdtree, 4 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_kdtree_sraid_build ( kdtree, features );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_sraid_matchresultset_new ( &results, 8 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Each indexed feature is its own nearest neighbour
+   Rox_Uint found = 0;
+   for ( Rox_Uint i = 0; i < COUNT_FEATURES; i++ )
+   {
+      error = rox_kdtree_sraid_search ( results, kdtree, features, &features->data[i] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      if ( results->count_results > 0 && results->results[0].index == i && results->results[0].distance == 0 ) found++;
+   }
+   ROX_TEST_CHECK_EQUAL ( found, (Rox_Uint) COUNT_FEATURES );
+
+   // Checking more leaves than the heap can hold branches must not fail
+   error = rox_kdtree_sraid_search_checks ( results, kdtree, features, &features->data[0], 4 * COUNT_FEATURES );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( results->count_results, 8u );
+   ROX_TEST_CHECK_EQUAL ( results->results[0].index, 0u );
+
+   error = rox_kdtree_sraid_search_checks ( NULL, kdtree, features, &features->data[0], 32 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_sraid_matchresultset_del ( &results );
+   rox_kdtree_sraid_del ( &kdtree );
+   rox_dynvec_sraiddesc_del ( &features );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_kdtree_sraid_save)
@@ -16,13 +16,31 @@
 
 #include <openrox_tests.hpp>
 
-#include <system/memory/datatypes.h>
-#include <core/features/descriptors/sraid/sraid.h>
+#include <math.h>
+
+extern "C"
+{
+   #include <system/memory/datatypes.h>
+   #include <generated/dynvec_sraiddesc_struct.h>
+   #include <core/features/descriptors/sraid/sraid.h>
+   #include <core/features/descriptors/sraid/sraid_workspace.h>
+   #include <core/features/descriptors/sraid/sraiddesc.h>
+   #include <core/features/detectors/dog/dog.h>
+   #include <baseproc/maths/kernels/gaussian2d.h>
+   #include <baseproc/image/convolve/array2d_float_symmetric_separable_convolve.h>
+   #include <baseproc/image/pyramid/pyramid_tools.h>
+   #include <baseproc/image/remap/remap_box_halved/remap_box_halved.h>
+   #include <baseproc/geometry/rectangle/rectangle_struct.h>
+   #include <system/memory/memory.h>
+}
 
 //=== INTERNAL MACROS    =======================================================
 
 ROX_TEST_SUITE_BEGIN(sraid)
 
+#define ROWS 180
+#define COLS 240
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
@@ -33,15 +51,216 @@ ROX_TEST_SUITE_BEGIN(sraid)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Check that two sets of features are identical, in the same order
+static Rox_Sint same_features ( Rox_DynVec_SRAID_Feature a, Rox_DynVec_SRAID_Feature b )
+{
+   if ( a->used != b->used ) return 0;
+
+   for ( Rox_Uint i = 0; i < a->used; i++ )
+   {
+      if ( a->data[i].x != b->data[i].x || a->data[i].y != b->data[i].y ) return 0;
+      if ( a->data[i].level != b->data[i].level || a->data[i].ori != b->data[i].ori ) return 0;
+
+      for ( Rox_Sint k = 0; k < 128; k++ )
+      {
+         if ( a->data[i].descriptor[k] != b->data[i].descriptor[k] ) return 0;
+      }
+   }
+
+   return 1;
+}
+
+// Draw pseudo random blobs on a uniform background
+static Rox_ErrorCode draw_texture ( Rox_Array2D_Float image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float ** data = NULL;
+   Rox_Uint seed = 4321;
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &data, image );
+   if ( error ) return error;
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+         data[i][j] = 0.5f;
+
+   for ( Rox_Sint blob = 0; blob < 80; blob++ )
+   {
+      seed = seed * 1103515245u + 12345u; Rox_Float u = (Rox_Float) ( ( seed >> 16 ) % COLS );
+      seed = seed * 1103515245u + 12345u; Rox_Float v = (Rox_Float) ( ( seed >> 16 ) % ROWS );
+      seed = seed * 1103515245u + 12345u; Rox_Float r = 2.0f + (Rox_Float) ( ( seed >> 16 ) % 8 );
+      seed = seed * 1103515245u + 12345u; Rox_Float a = ( ( seed >> 16 ) % 2 ) ? 0.4f : -0.4f;
+
+      for ( Rox_Sint i = 0; i < ROWS; i++ )
+      {
+         for ( Rox_Sint j = 0; j < COLS; j++ )
+         {
+            Rox_Float d2 = ( ( i - v ) * ( i - v ) + ( j - u ) * ( j - u ) ) / ( r * r );
+            if ( d2 < 9.0f ) data[i][j] += a * expf ( -d2 );
+         }
+      }
+   }
+
+   return error;
+}
+
+// The sequential pipeline, one octave after the other, with the scale and dog spaces allocated for each octave
+static Rox_ErrorCode reference_process (
+   Rox_DynVec_SRAID_Feature sraid_output,
+   Rox_Array2D_Float input,
+   Rox_Sint sraid_max_octaves,
+   Rox_Float sraid_sigma,
+   Rox_Float cutoff,
+   Rox_Float sraid_initial_sigma,
+   Rox_Uint sraid_invls,
+   Rox_Float sraid_contr_thresh,
+   Rox_Uint sraid_curv_thresh,
+   Rox_Uint object_id )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Float filtered = NULL, hfilter = NULL, vfilter = NULL;
+   Rox_Array2D_Float_Collection scalespace = NULL, dogspace = NULL;
+   Rox_Dog_Feature features = NULL;
+   Rox_Uint detectcount = 0, pyramidsize = 0;
+   Rox_Sint rows = ROWS, cols = COLS;
+   Rox_Rect_Sint_Struct bounds = { 0, 0, COLS, ROWS };
+
+   const Rox_Float prelim_contrast = (Rox_Float) ( 0.5 * sraid_contr_thresh / sraid_invls );
+   const Rox_Float sigdiff = (Rox_Float) sqrt ( sraid_sigma * sraid_sigma - sraid_initial_sigma * sraid_initial_sigma );
+
+   sraid_output->used = 0;
+
+   error = rox_array2d_float_new ( &filtered, rows, cols );
+   if ( error ) goto function_terminate;
+
+   error = rox_kernelgen_gaussian2d_separable_float_new ( &hfilter, &vfilter, sigdiff, cutoff );
+   if ( error ) goto function_terminate;
+
+   error = rox_array2d_float_symmetric_seperable_convolve ( filtered, input, hfilter );
+   if ( error ) goto function_terminate;
+
+   if ( rox_pyramid_compute_optimal_level_count ( &pyramidsize, cols, rows, 8 ) ) pyramidsize = 0;
+   pyramidsize += 1;
+
+   if ( pyramidsize > ( (Rox_Uint) ( sraid_max_octaves + 1 ) ) && sraid_max_octaves >= 1 ) pyramidsize = sraid_max_octaves;
+
+   for ( Rox_Uint octave = 0; octave < pyramidsize; octave++ )
+   {
+      error = rox_array2d_float_build_scale_space_new ( &scalespace, filtered, sraid_invls, sraid_sigma, cutoff );
+      if ( error ) goto function_terminate;
+
+      error = rox_dogspace_create ( &dogspace, scalespace );
+      if ( error ) goto function_terminate;
+
+      error = rox_dogdetector_process ( &features, &detectcount, dogspace, &bounds, sraid_contr_thresh, (Rox_Float) sraid_curv_thresh, prelim_contrast, sraid_invls, octave, sraid_sigma );
+      if ( error ) goto function_terminate;
+
+      error = rox_sraiddescriptor_process ( sraid_output, features, detectcount, scalespace, object_id );
+      if ( error ) goto function_terminate;
+
+      // Halve the last scale for the next octave
+      cols = cols / 2;
+      rows = rows / 2;
+
+      rox_array2d_float_del ( &filtered );
+      error = rox_array2d_float_new ( &filtered, rows, cols );
+      if ( error ) goto function_terminate;
+
+      error = rox_remap_box_nomask_float_to_float_halved ( filtered, rox_array2d_float_collection_get ( scalespace, sraid_invls ) );
+      if ( error ) goto function_terminate;
+
+      rox_memory_delete ( features ); features = NULL;
+      rox_array2d_float_collection_del ( &dogspace );
+      rox_array2d_float_collection_del ( &scalespace );
+   }
+
+function_terminate:
+   rox_memory_delete ( features );
+   rox_array2d_float_collection_del ( &dogspace );
+   rox_array2d_float_collection_del ( &scalespace );
+   rox_array2d_float_del ( &hfilter );
+   rox_array2d_float_del ( &vfilter );
+   rox_array2d_float_del ( &filtered );
+   return error;
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_sraidpipeline_process)
 {
    Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Float image = NULL;
+   Rox_DynVec_SRAID_Feature features = NULL;
 
-   ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
-   
+   error = rox_array2d_float_new ( &image, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = draw_texture ( image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_sraiddesc_new ( &features, 100 );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_sraidpipeline_process ( features, image, -1, 1.6f, 3.0f, 0.5f, 3, 0.04f, 10, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The blobs are detected at several scales
+   ROX_TEST_CHECK_EQUAL ( features->used > 50, 1 );
+
+   rox_dynvec_sraiddesc_del ( &features );
+   rox_array2d_float_del ( &image );
+}
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_sraid_workspace_process)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Float image = NULL, small = NULL;
+   Rox_DynVec_SRAID_Feature features = NULL, features_workspace = NULL;
+   Rox_SRAID_Workspace workspace = NULL;
+
+   error = rox_array2d_float_new ( &image, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = draw_texture ( image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_sraiddesc_new ( &features, 100 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_sraiddesc_new ( &features_workspace, 100 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = reference_process ( features, image, -1, 1.6f, 3.0f, 0.5f, 3, 0.04f, 10, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( features->used > 50, 1 );
+
+   // Too small images are rejected
+   error = rox_sraid_workspace_new ( &workspace, 31, COLS, -1, 1.6f, 3.0f, 0.5f, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   error = rox_sraid_workspace_new ( &workspace, ROWS, COLS, -1, 1.6f, 3.0f, 0.5f, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The workspace gives the features of the sequential pipeline and is reused without changing them
+   for ( Rox_Sint iter = 0; iter < 2; iter++ )
+   {
+      error = rox_sraid_workspace_process ( features_workspace, workspace, image, 0.04f, 10, 0 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( same_features ( features, features_workspace ), 1 );
+   }
+
+   // The image size must be the one of the workspace
+   error = rox_array2d_float_new ( &small, ROWS / 2, COLS / 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_sraid_workspace_process ( features_workspace, workspace, small, 0.04f, 10, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   rox_sraid_workspace_del ( &workspace );
+   rox_dynvec_sraiddesc_del ( &features );
+   rox_dynvec_sraiddesc_del ( &features_workspace );
+   rox_array2d_float_del ( &image );
+   rox_array2d_float_del ( &small );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_sraid_populate_pointlist)
@@ -19,6 +19,10 @@
 extern "C"
 {
 	#include <core/features/detectors/checkerboard/checkercorner_detect.h>
+	#include <core/features/detectors/checkerboard/checkercorner_struct.h>
+	#include <generated/dynvec_sparse_value_struct.h>
+	#include <generated/objset_dynvec_sparse_value_struct.h>
+	#include <baseproc/maths/maths_macros.h>
 }
 
 //=== INTERNAL MACROS    =======================================================
@@ -38,6 +42,68 @@ ROX_TEST_SUITE_BEGIN(checkercorner_detect)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Synthetic checkerboard with squares of 'square' pixels, the first corner is at (offset, offset)
+static Rox_ErrorCode make_checkerboard ( Rox_Image image, Rox_Sint offset, Rox_Sint square )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Sint cols = 0, rows = 0;
+   Rox_Uchar ** data = NULL;
+
+   error = rox_image_get_size ( &rows, &cols, image );
+   if ( error ) return error;
+
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+   if ( error ) return error;
+
+   for ( Rox_Sint i = 0; i < rows; i++ )
+   {
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         Rox_Sint si = ( i - offset + 10 * square ) / square;
+         Rox_Sint sj = ( j - offset + 10 * square ) / square;
+         data[i][j] = ( ( si + sj ) % 2 ) ? 200 : 40;
+      }
+   }
+
+   return error;
+}
+
+// Cornerness computed with the sparse kernels, valid far from the image borders
+static Rox_Float reference_cornerness ( Rox_CheckerCorner_Detector detector, Rox_Sint i, Rox_Sint j )
+{
+   Rox_Float ** src = NULL;
+   Rox_Float cornerness = 0;
+
+   rox_array2d_float_get_data_pointer_to_pointer ( &src, detector->source );
+
+   for ( Rox_Uint idkernel = 0; idkernel < detector->kernels->used; idkernel += 4 )
+   {
+      Rox_Float rep[4];
+
+      for ( Rox_Uint k = 0; k < 4; k++ )
+      {
+         Rox_DynVec_Sparse_Value kernel = detector->kernels->data[idkernel + k];
+         Rox_Double sum = 0.0;
+
+         for ( Rox_Uint id = 0; id < kernel->used; id++ )
+         {
+            sum += src[i + (Rox_Sint) kernel->data[id].v][j + (Rox_Sint) kernel->data[id].u] * kernel->data[id].value;
+         }
+         rep[k] = (Rox_Float) sum;
+      }
+
+      Rox_Float mean = ( rep[0] + rep[1] + rep[2] + rep[3] ) / 4;
+      Rox_Float val1 = ROX_MIN( rep[0] - mean, rep[1] - mean );
+      Rox_Float val2 = ROX_MIN( mean - rep[2], mean - rep[3] );
+      cornerness = ROX_MAX( cornerness, ROX_MIN( val1, val2 ) );
+      val1 = ROX_MIN( mean - rep[0], mean - rep[1] );
+      val2 = ROX_MIN( rep[2] - mean, rep[3] - mean );
+      cornerness = ROX_MAX( cornerness, ROX_MIN( val1, val2 ) );
+   }
+
+   return cornerness;
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_checkercorner_detector_new_del)
@@ -56,6 +122,135 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_checkercorner_detector_new_del)
    ROX_TEST_CHECK_EQUAL(error, ROX_ERROR_BAD_SIZE);
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_checkercorner_detector_synthetic)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CheckerCorner_Detector checkercorner_detector = NULL;
+   Rox_Image image = NULL;
+   Rox_Sint cols = 320, rows = 240;
+   Rox_Sint offset = 45, square = 30;
+   Rox_Uint kernel_blur_levels = 2;
+   Rox_Uint score_blur_levels = 1;
+   Rox_Float ** dc = NULL;
+   Rox_Double maxerr = 0.0;
+
+   error = rox_image_new ( &image, cols, rows );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = make_checkerboard ( image, offset, square );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_checkercorner_detector_new ( &checkercorner_detector, cols, rows, kernel_blur_levels, score_blur_levels );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_checkercorner_detector_process ( checkercorner_detector, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The row based response must match the sparse kernels where they do not touch the borders
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &dc, checkercorner_detector->cornerness );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint i = 8; i < rows - 8; i += 3 )
+   {
+      for ( Rox_Sint j = 8; j < cols - 8; j += 3 )
+      {
+         maxerr = ROX_MAX( maxerr, fabs( dc[i][j] - reference_cornerness ( checkercorner_detector, i, j ) ) );
+      }
+   }
+   ROX_TEST_CHECK_SMALL ( maxerr, 1e-5 );
+
+   // Detected corners lie on the checkerboard corners
+   Rox_Uint nbcorners = checkercorner_detector->corners->used;
+   ROX_TEST_CHECK_SUPERIOR ( nbcorners, 0u );
+
+   for ( Rox_Uint id = 0; id < nbcorners; id++ )
+   {
+      Rox_Double u = checkercorner_detector->corners->data[id].coords.u - offset;
+      Rox_Double v = checkercorner_detector->corners->data[id].coords.v - offset;
+      ROX_TEST_CHECK_SMALL ( fabs( u - square * floor( u / square + 0.5 ) ), 1.0 );
+      ROX_TEST_CHECK_SMALL ( fabs( v - square * floor( v / square + 0.5 ) ), 1.0 );
+   }
+
+   error = rox_checkercorner_detector_del ( &checkercorner_detector );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_image_del ( &image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_checkercorner_detector_roi)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CheckerCorner_Detector checkercorner_detector = NULL;
+   Rox_Image image = NULL;
+   Rox_Sint cols = 320, rows = 240;
+   Rox_Rect_Sint_Struct roi;
+
+   error = rox_image_new ( &image, cols, rows );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = make_checkerboard ( image, 45, 30 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_checkercorner_detector_new ( &checkercorner_detector, cols, rows, 1, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_checkercorner_detector_set_roi ( NULL, &roi );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   // Region outside of the image
+   roi.x = cols; roi.y = 0; roi.width = 10; roi.height = 10;
+   error = rox_checkercorner_detector_set_roi ( checkercorner_detector, &roi );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   error = rox_checkercorner_detector_process ( checkercorner_detector, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   Rox_Uint nbfull = checkercorner_detector->corners->used;
+
+   // Only the corners of the region are searched, the region is clipped to the image
+   roi.x = 100; roi.y = 90; roi.width = 300; roi.height = 70;
+   error = rox_checkercorner_detector_set_roi ( checkercorner_detector, &roi );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( checkercorner_detector->roi.width, cols - 100 );
+
+   error = rox_checkercorner_detector_process ( checkercorner_detector, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Uint nbroi = checkercorner_detector->corners->used;
+   ROX_TEST_CHECK_SUPERIOR ( nbroi, 0u );
+   ROX_TEST_CHECK_INFERIOR ( nbroi, nbfull );
+
+   for ( Rox_Uint id = 0; id < nbroi; id++ )
+   {
+      Rox_Point2D_Double_Struct coords = checkercorner_detector->corners->data[id].coords;
+      ROX_TEST_CHECK_SUPERIOR ( coords.u, 99.0 );
+      ROX_TEST_CHECK_SUPERIOR ( coords.v, 89.0 );
+      ROX_TEST_CHECK_INFERIOR ( coords.v, 161.0 );
+   }
+
+   // Predict the next region from the detected corners
+   error = rox_checkercorner_detector_set_roi_from_corners ( checkercorner_detector, 20 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_checkercorner_detector_process ( checkercorner_detector, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( checkercorner_detector->corners->used, nbroi );
+
+   // Back to the whole image
+   error = rox_checkercorner_detector_set_roi ( checkercorner_detector, NULL );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_checkercorner_detector_process ( checkercorner_detector, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( checkercorner_detector->corners->used, nbfull );
+
+   error = rox_checkercorner_detector_del ( &checkercorner_detector );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_image_del ( &image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_checkercorner_detector_process)
 {
 	Rox_ErrorCode error = ROX_ERROR_NONE;
@@ -26,9 +26,16 @@ extern "C"
    #include <baseproc/image/draw/draw_polygon.h>
    #include <baseproc/image/image.h>
    #include <baseproc/image/image_rgba.h>
+   #include <baseproc/image/convert/roxgray_to_roxrgba.h>
+   #include <baseproc/geometry/measures/distance_point_to_segment.h>
+   #include <baseproc/maths/maths_macros.h>
    #include <inout/image/ppm/ppmfile.h>
+   #include <inout/image/pgm/pgmfile.h>
 
    #include <core/features/detectors/quad/quad_detection.h>
+   #include <core/features/detectors/quad/quad_detection_struct.h>
+   #include <core/features/detectors/quad/quad_segment2d.h>
+   #include <core/features/detectors/quad/quad_struct.h>
 
    #include <inout/geometry/point/point2d_print.h>
    #include <inout/system/print.h>
@@ -46,6 +53,14 @@ ROX_TEST_SUITE_BEGIN(quad_detection)
 // #define IMAGE_PATH ROX_DATA_HOME"/regression_tests/openrox/image/test_image_random_1920x1080.pgm"
 // #define IMAGE_PATH ROX_DATA_HOME"/regression_tests/openrox/image/test_image_random_640x480.pgm"
 
+// Size of the synthetic image used when the regression data are not available
+#define SYNTHETIC_COLS 640
+#define SYNTHETIC_ROWS 480
+
+// Bounds of the quads as set by default in the quad detector
+#define MIN_SIDE_SIZE 10
+#define MAX_SIDE_SIZE 1000
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
@@ -56,6 +71,154 @@ ROX_TEST_SUITE_BEGIN(quad_detection)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Render dark squares on a white background, one of them with a white square inside
+// The squares are rotated, have different sizes and some of them overlap the bands of rows of the gradient clusterer
+static void render_quads ( Rox_Image image )
+{
+   // Center u, center v, half side, angle
+   const Rox_Double squares[5][4] = {
+      { 160.0, 120.0, 60.0,  0.0 },
+      { 460.0, 120.0, 50.0,  0.3 },
+      { 160.0, 350.0, 70.0, -0.2 },
+      { 320.0, 250.0, 45.0,  0.15 },
+      { 470.0, 350.0, 60.0,  0.7 } };
+
+   Rox_Uchar ** data = NULL;
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < SYNTHETIC_ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < SYNTHETIC_COLS; j++ )
+      {
+         Rox_Sint sum = 0;
+         for ( Rox_Sint si = 0; si < 4; si++ )
+         {
+            for ( Rox_Sint sj = 0; sj < 4; sj++ )
+            {
+               const Rox_Double u = j + ( sj + 0.5 ) / 4.0, v = i + ( si + 0.5 ) / 4.0;
+
+               Rox_Sint level = 255;
+               for ( Rox_Sint k = 0; k < 5; k++ )
+               {
+                  const Rox_Double c = cos ( squares[k][3] ), s = sin ( squares[k][3] );
+                  const Rox_Double x =  c * ( u - squares[k][0] ) + s * ( v - squares[k][1] );
+                  const Rox_Double y = -s * ( u - squares[k][0] ) + c * ( v - squares[k][1] );
+
+                  if ( fabs ( x ) < squares[k][2] && fabs ( y ) < squares[k][2] )
+                  {
+                     level = 0;
+                     if ( k == 0 && fabs ( x ) < 0.5 * squares[k][2] && fabs ( y ) < 0.5 * squares[k][2] ) level = 255;
+                  }
+               }
+               sum += level;
+            }
+         }
+         data[i][j] = (Rox_Uchar) ( ( sum + 8 ) / 16 );
+      }
+   }
+}
+
+// Read the test image, or render the synthetic quads when the regression data are not available
+static Rox_ErrorCode read_or_render_image ( Rox_Image * image, const Rox_Char * filename )
+{
+   Rox_ErrorCode error = rox_image_new_read_pgm ( image, filename );
+   if ( error == ROX_ERROR_NONE ) return error;
+
+   rox_log ( "cannot read file %s, using a synthetic image\n", filename );
+
+   error = rox_image_new ( image, SYNTHETIC_COLS, SYNTHETIC_ROWS );
+   if ( error ) return error;
+
+   render_quads ( *image );
+   return error;
+}
+
+static Rox_Double reference_mod2pi ( Rox_Double vin )
+{
+   const Rox_Double sign = vin < 0 ? -1.0 : 1.0;
+   const Rox_Double a = fabs ( vin );
+   const Rox_Sint qi = (Rox_Sint) ( a * 0.5 / ROX_PI + 0.5 );
+
+   return sign * ( a - qi * 2.0 * ROX_PI );
+}
+
+// The recursive quad search which the iterative search of quad_detection.c replaces
+// All the checks are done once the path of 5 segments is closed
+static Rox_ErrorCode reference_searchquad (
+   Rox_DynVec_Quad quadlist,
+   Rox_Quad_Segment2D * path,
+   Rox_Uint lvl,
+   Rox_Double side_min,
+   Rox_Double side_max,
+   Rox_Double area_min,
+   Rox_Double area_max
+)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   if ( lvl == 4 )
+   {
+      Rox_Quad_Struct curquad;
+
+      // 5th segment must be the 1st to close
+      if ( path[4] != path[0] ) return ROX_ERROR_NONE;
+
+      for ( Rox_Sint i = 0; i < 4; i++ )
+      {
+         if ( rox_dynvec_quad_segment2d_intersect ( &curquad.u[i], &curquad.v[i], path[i], path[i+1] ) == 0 ) return ROX_ERROR_NONE;
+      }
+
+      // Winding
+      Rox_Double ttheta = 0.0;
+      for ( Rox_Sint i = 0; i < 4; i++ )
+      {
+         const Rox_Sint i1 = ( i + 1 ) % 4, i2 = ( i + 2 ) % 4;
+         const Rox_Double t0 = atan2 ( curquad.v[i1] - curquad.v[i], curquad.u[i1] - curquad.u[i] );
+         const Rox_Double t1 = atan2 ( curquad.v[i2] - curquad.v[i1], curquad.u[i2] - curquad.u[i1] );
+         ttheta += reference_mod2pi ( t1 - t0 );
+      }
+      if ( ttheta < -7 || ttheta > -5 ) return ROX_ERROR_NONE;
+
+      // Area
+      Rox_Double area = 0.0;
+      for ( Rox_Sint i = 0; i < 4; i++ )
+      {
+         const Rox_Sint i1 = ( i + 1 ) % 4;
+         area += curquad.u[i] * curquad.v[i1] - curquad.v[i] * curquad.u[i1];
+      }
+      area = 0.5 * fabs ( area );
+      if ( area < area_min || area > area_max ) return ROX_ERROR_NONE;
+
+      // Sides and distances from each corner to the opposite sides
+      for ( Rox_Sint i = 0; i < 4; i++ )
+      {
+         const Rox_Sint i1 = ( i + 1 ) % 4, i2 = ( i + 2 ) % 4, i3 = ( i + 3 ) % 4;
+         const Rox_Double du = curquad.u[i1] - curquad.u[i], dv = curquad.v[i1] - curquad.v[i];
+         const Rox_Double side_size = sqrt ( dv * dv + du * du );
+
+         if ( side_size < side_min || side_size > side_max ) return ROX_ERROR_NONE;
+
+         if ( rox_distance_point2d_to_segment2d_coordinates ( curquad.u[i], curquad.v[i], curquad.u[i1], curquad.v[i1], curquad.u[i2], curquad.v[i2] ) < MIN_SIDE_SIZE ) return ROX_ERROR_NONE;
+         if ( rox_distance_point2d_to_segment2d_coordinates ( curquad.u[i], curquad.v[i], curquad.u[i3], curquad.v[i3], curquad.u[i2], curquad.v[i2] ) < MIN_SIDE_SIZE ) return ROX_ERROR_NONE;
+      }
+
+      return rox_dynvec_quad_append ( quadlist, &curquad );
+   }
+
+   for ( Rox_Uint iter = 0; iter < path[lvl]->countchildren; iter++ )
+   {
+      // Force a given arbitrary order
+      if ( path[lvl]->child[iter]->theta > path[0]->theta ) continue;
+
+      path[lvl+1] = path[lvl]->child[iter];
+
+      error = reference_searchquad ( quadlist, path, lvl + 1, side_min, side_max, area_min, area_max );
+      if ( error ) return error;
+   }
+
+   return error;
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_new_del)
@@ -97,7 +260,7 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_process_image)
 
    sprintf(filename, "%s", IMAGE_PATH);
 
-   error = rox_image_new_read_pgm(&image, filename);
+   error = read_or_render_image(&image, filename);
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
    error = rox_image_get_cols(&cols, image);
@@ -143,7 +306,10 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_process_image)
 
    Rox_Image_RGBA image_display = NULL;
 
-   error = rox_image_rgba_new_read_pgm ( &image_display, filename );
+   error = rox_image_rgba_new ( &image_display, cols, rows );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_roxgray_to_roxrgba ( image_display, image );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
    for ( Rox_Sint i=0; i < detected_quads; i++)
@@ -208,7 +374,7 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_process_image_ac)
 
    sprintf(filename, "%s", IMAGE_PATH);
    
-   error = rox_image_new_read_pgm(&image, filename);
+   error = read_or_render_image(&image, filename);
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
    error = rox_image_get_cols(&cols, image);
@@ -254,7 +420,10 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_process_image_ac)
 
    Rox_Array2D_Uint image_display = NULL;
 
-   error = rox_image_rgba_new_read_pgm(&image_display, filename);
+   error = rox_image_rgba_new(&image_display, cols, rows);
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_roxgray_to_roxrgba(image_display, image);
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
    for(Rox_Sint i=0; i<detected_quads; i++)
@@ -318,6 +487,84 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_compute_quads)
 
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_compute_quads_recursive)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   Rox_QuadDetector quad_detector = NULL;
+   Rox_DynVec_Quad reference = NULL;
+   Rox_Quad_Segment2D path[5];
+
+   Rox_Image image = NULL;
+   Rox_Imask mask = NULL;
+
+   error = rox_image_new ( &image, SYNTHETIC_COLS, SYNTHETIC_ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   render_quads ( image );
+
+   error = rox_imask_new ( &mask, SYNTHETIC_COLS, SYNTHETIC_ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_imask_set_ones ( mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_quaddetector_new ( &quad_detector, SYNTHETIC_COLS, SYNTHETIC_ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_quad_new ( &reference, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Both quad colors, so that the dark squares and the white square inside the first one are searched
+   for ( Rox_Uint black_to_white = 0; black_to_white < 2; black_to_white++ )
+   {
+      error = rox_quaddetector_set_quad_color ( quad_detector, black_to_white );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_quaddetector_process_image ( quad_detector, image, mask );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      Rox_DynVec_Quad_Segment2D segments = quad_detector->segments;
+      Rox_DynVec_Quad quads = quad_detector->quads;
+
+      rox_log ( "color %d : %d segments, %d quads\n", black_to_white, segments->used, quads->used );
+      ROX_TEST_CHECK ( quads->used > 0 );
+
+      // The recursive search on the same graph of segments
+      rox_dynvec_quad_reset ( reference );
+      for ( Rox_Uint i = 0; i < segments->used; i++ )
+      {
+         path[0] = &segments->data[i];
+
+         error = reference_searchquad ( reference, path, 0, quad_detector->side_min, quad_detector->side_max, quad_detector->area_min, quad_detector->area_max );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      }
+
+      // Same quads in the same order
+      ROX_TEST_CHECK_EQUAL ( quads->used, reference->used );
+      for ( Rox_Uint i = 0; i < quads->used && i < reference->used; i++ )
+      {
+         for ( Rox_Sint k = 0; k < 4; k++ )
+         {
+            ROX_TEST_CHECK_CLOSE ( quads->data[i].u[k], reference->data[i].u[k], 1e-12 );
+            ROX_TEST_CHECK_CLOSE ( quads->data[i].v[k], reference->data[i].v[k], 1e-12 );
+         }
+      }
+   }
+
+   error = rox_dynvec_quad_del ( &reference );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_quaddetector_del ( &quad_detector );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_imask_del ( &mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_image_del ( &image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_quaddetector_get_quad_count)
 {
 	Rox_ErrorCode error = ROX_ERROR_NONE;
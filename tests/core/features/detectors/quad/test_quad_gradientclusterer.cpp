@@ -19,6 +19,7 @@
 extern "C"
 {
    #include <string.h>
+   #include <math.h>
 
    #include <generated/array2d_uchar.h>
 
@@ -26,6 +27,7 @@ extern "C"
    #include <baseproc/image/imask/imask.h>
 
 	 #include <core/features/detectors/quad/quad_gradientclusterer.h>
+   #include <core/features/detectors/quad/quad_gradientclusterer_struct.h>
    #include <inout/numeric/array_save.h>
    #include <inout/numeric/array2d_save.h>
    #include <inout/image/pgm/pgmfile.h>
@@ -42,6 +44,10 @@ ROX_TEST_SUITE_BEGIN(quad_gradientclusterer)
 // #define TEST_IMG     ROX_DATA_HOME"/regression_tests/openrox/image/test_image_random_640x480.pgm"
 //#define TEST_IMG ROX_DATA_HOME"/regression_tests/openrox/detection/quad/image_quad_centered_1.pgm"
 
+// Size of the synthetic image used when the regression data are not available, with several bands of rows
+#define SYNTHETIC_COLS 640
+#define SYNTHETIC_ROWS 480
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
@@ -52,6 +58,140 @@ ROX_TEST_SUITE_BEGIN(quad_gradientclusterer)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Render rotated dark squares on a white background, some of them overlapping the bands of rows
+static void render_quads ( Rox_Array2D_Uchar image )
+{
+   // Center u, center v, half side, angle
+   const Rox_Double squares[5][4] = {
+      { 160.0, 120.0, 60.0,  0.0 },
+      { 460.0, 120.0, 50.0,  0.3 },
+      { 160.0, 350.0, 70.0, -0.2 },
+      { 320.0, 250.0, 45.0,  0.15 },
+      { 470.0, 350.0, 60.0,  0.7 } };
+
+   Rox_Uchar ** data = NULL;
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < SYNTHETIC_ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < SYNTHETIC_COLS; j++ )
+      {
+         Rox_Sint sum = 0;
+         for ( Rox_Sint si = 0; si < 4; si++ )
+         {
+            for ( Rox_Sint sj = 0; sj < 4; sj++ )
+            {
+               const Rox_Double u = j + ( sj + 0.5 ) / 4.0, v = i + ( si + 0.5 ) / 4.0;
+
+               Rox_Sint level = 255;
+               for ( Rox_Sint k = 0; k < 5; k++ )
+               {
+                  const Rox_Double c = cos ( squares[k][3] ), s = sin ( squares[k][3] );
+                  const Rox_Double x =  c * ( u - squares[k][0] ) + s * ( v - squares[k][1] );
+                  const Rox_Double y = -s * ( u - squares[k][0] ) + c * ( v - squares[k][1] );
+
+                  if ( fabs ( x ) < squares[k][2] && fabs ( y ) < squares[k][2] ) level = 0;
+               }
+               sum += level;
+            }
+         }
+         data[i][j] = (Rox_Uchar) ( ( sum + 8 ) / 16 );
+      }
+   }
+}
+
+// Read the test image, or render the synthetic quads when the regression data are not available
+static Rox_ErrorCode read_or_render_image ( Rox_Array2D_Uchar * image, const Rox_Char * filename )
+{
+   Rox_ErrorCode error = rox_array2d_uchar_new_pgm ( image, filename );
+   if ( error == ROX_ERROR_NONE ) return error;
+
+   rox_log ( "cannot read file %s, using a synthetic image\n", filename );
+
+   error = rox_array2d_uchar_new ( image, SYNTHETIC_ROWS, SYNTHETIC_COLS );
+   if ( error ) return error;
+
+   render_quads ( *image );
+   return error;
+}
+
+// The edges of the whole image in row order, as computed by a single sequential pass
+static Rox_Uint reference_computeedges ( LabelEdge edges, const Rox_GradientClusterer ptr )
+{
+   Rox_Uint nbedges = 0;
+
+   for ( Rox_Sint i = 1; i < ptr->height - 1; i++ )
+   {
+      for ( Rox_Sint j = 1; j < ptr->width - 1; j++ )
+      {
+         const Rox_Sint idr = i * ptr->width + j;
+         const Rox_Sint neighbors[4] = { idr + 1, idr + ptr->width, idr + ptr->width + 1, idr + ptr->width - 1 };
+
+         if ( ptr->gmag[idr] < MINMAG ) continue;
+
+         for ( Rox_Sint k = 0; k < 4; k++ )
+         {
+            const Rox_Sint id = neighbors[k];
+            const Rox_Sint cost = rox_gradientclusterer_edgecost ( ptr->gtheta[idr], ptr->gmag[idr], ptr->gtheta[id], ptr->gmag[id] );
+            if ( cost < 0 ) continue;
+
+            edges[nbedges].cur = idr;
+            edges[nbedges].assoc = id;
+            edges[nbedges].cost = cost;
+            nbedges++;
+         }
+      }
+   }
+
+   return nbedges;
+}
+
+// Sequential counting sort of the edges by cost
+static void reference_edgesort ( LabelEdge sorted, const LabelEdge edges, const Rox_Uint nbedges )
+{
+   Rox_Uint counters[ROX_GRADIENTCLUSTERER_COSTS] = { 0 };
+   Rox_Uint offset = 0;
+
+   for ( Rox_Uint i = 0; i < nbedges; i++ ) counters[edges[i].cost]++;
+
+   for ( Rox_Sint w = 0; w < ROX_GRADIENTCLUSTERER_COSTS; w++ )
+   {
+      const Rox_Uint count = counters[w];
+      counters[w] = offset;
+      offset += count;
+   }
+
+   for ( Rox_Uint i = 0; i < nbedges; i++ ) sorted[counters[edges[i].cost]++] = edges[i];
+}
+
+// Compute the gradients and the edges of the synthetic image
+static Rox_ErrorCode make_edges ( Rox_GradientClusterer * clusterer, Rox_Array2D_Uchar * image, Rox_Array2D_Uint * mask )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   error = rox_array2d_uchar_new ( image, SYNTHETIC_ROWS, SYNTHETIC_COLS );
+   if ( error ) return error;
+
+   render_quads ( *image );
+
+   error = rox_array2d_uint_new ( mask, SYNTHETIC_ROWS, SYNTHETIC_COLS );
+   if ( error ) return error;
+
+   error = rox_imask_set_ones ( *mask );
+   if ( error ) return error;
+
+   error = rox_gradientclusterer_new ( clusterer, SYNTHETIC_COLS, SYNTHETIC_ROWS );
+   if ( error ) return error;
+
+   error = rox_gradientclusterer_reset ( *clusterer );
+   if ( error ) return error;
+
+   error = rox_gradientclusterer_buildgradients ( (*clusterer)->gmagval, (*clusterer)->gmag, (*clusterer)->gtheta, *image, *mask );
+   if ( error ) return error;
+
+   return rox_gradientclusterer_computeedges ( *clusterer );
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_gradientclusterer_new)
@@ -236,7 +376,7 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_gradientclusterer_buildgradients_pe
    sprintf(filename, "%s", TEST_IMG);
    rox_log("read file %s\n", filename);
 
-   error = rox_array2d_uchar_new_pgm(&image_gray, filename);
+   error = read_or_render_image(&image_gray, filename);
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
    error = rox_array2d_uchar_get_size(&rows, &cols, image_gray);
@@ -317,19 +457,89 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_gradientclusterer_edgecost)
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_gradientclusterer_edgesort)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   Rox_GradientClusterer clusterer = NULL;
+   Rox_Array2D_Uchar image_gray = NULL;
+   Rox_Array2D_Uint image_mask = NULL;
+
+   error = make_edges ( &clusterer, &image_gray, &image_mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   LabelEdge edges = (LabelEdge) rox_memory_allocate ( sizeof(struct LabelEdge_Struct), SYNTHETIC_COLS * SYNTHETIC_ROWS * 4 );
+   LabelEdge sorted = (LabelEdge) rox_memory_allocate ( sizeof(struct LabelEdge_Struct), SYNTHETIC_COLS * SYNTHETIC_ROWS * 4 );
+
+   const Rox_Uint nbedges = reference_computeedges ( edges, clusterer );
+   reference_edgesort ( sorted, edges, nbedges );
+
+   error = rox_gradientclusterer_edgesort ( clusterer );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The edges of the bands sorted in parallel are in the order of the sequential counting sort
+   ROX_TEST_CHECK_EQUAL ( clusterer->nbedges, nbedges );
 
+   Rox_Uint nbdiff = 0;
+   for ( Rox_Uint i = 0; i < nbedges && i < clusterer->nbedges; i++ )
+   {
+      const LabelEdge edge = &clusterer->sortededges[i];
+      if ( edge->cur != sorted[i].cur || edge->assoc != sorted[i].assoc || edge->cost != sorted[i].cost ) nbdiff++;
+   }
+   ROX_TEST_CHECK_EQUAL ( nbdiff, 0u );
+
+   rox_memory_delete ( edges );
+   rox_memory_delete ( sorted );
+
+   error = rox_gradientclusterer_del ( &clusterer );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uchar_del ( &image_gray );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uint_del ( &image_mask );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_gradientclusterer_computeedges)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   Rox_GradientClusterer clusterer = NULL;
+   Rox_Array2D_Uchar image_gray = NULL;
+   Rox_Array2D_Uint image_mask = NULL;
+
+   error = make_edges ( &clusterer, &image_gray, &image_mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   LabelEdge edges = (LabelEdge) rox_memory_allocate ( sizeof(struct LabelEdge_Struct), SYNTHETIC_COLS * SYNTHETIC_ROWS * 4 );
+
+   const Rox_Uint nbedges = reference_computeedges ( edges, clusterer );
+   ROX_TEST_CHECK ( nbedges > 0 );
+   ROX_TEST_CHECK ( clusterer->count_bands > 1 );
+   ROX_TEST_CHECK_EQUAL ( clusterer->nbedges, nbedges );
+
+   // The bands put end to end give the edges of the sequential pass
+   Rox_Uint id = 0, nbdiff = 0;
+   for ( Rox_Sint b = 0; b < clusterer->count_bands; b++ )
+   {
+      const LabelEdge band = &clusterer->edges[b * ROX_GRADIENTCLUSTERER_BAND * SYNTHETIC_COLS * 4];
+
+      for ( Rox_Uint i = 0; i < clusterer->band_nbedges[b] && id < nbedges; i++, id++ )
+      {
+         if ( band[i].cur != edges[id].cur || band[i].assoc != edges[id].assoc || band[i].cost != edges[id].cost ) nbdiff++;
+      }
+   }
+   ROX_TEST_CHECK_EQUAL ( id, nbedges );
+   ROX_TEST_CHECK_EQUAL ( nbdiff, 0u );
+
+   rox_memory_delete ( edges );
+
+   error = rox_gradientclusterer_del ( &clusterer );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
+   error = rox_array2d_uchar_del ( &image_gray );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uint_del ( &image_mask );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
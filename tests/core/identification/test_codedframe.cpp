@@ -19,6 +19,9 @@
 extern "C"
 {
 	#include <core/identification/codedframe.h>
+	#include <baseproc/maths/linalg/matsl3.h>
+	#include <baseproc/tools/encoder/bch.h>
+	#include <baseproc/array/fill/fillval.h>
 }
 
 //=== INTERNAL MACROS    =======================================================
@@ -35,6 +38,47 @@ ROX_TEST_SUITE_BEGIN(codedframe)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+#define SCALE  2
+#define SHIFT  40
+#define SIZE   ( 144 * SCALE + 2 * SHIFT )
+
+// Draw the code cells of a frame seen by the homography [SCALE 0 SHIFT; 0 SCALE SHIFT; 0 0 1]
+// The cells are 8x8 squares of the code frame, which starts 8 pixels before the 128x128 texture
+static void draw_code ( Rox_Image image, const Rox_Ulint bits, const Rox_Sint code_bits )
+{
+   Rox_Uchar ** data = NULL;
+   rox_image_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint y = 0; y < SIZE; y++ )
+   {
+      for ( Rox_Sint x = 0; x < SIZE; x++ )
+      {
+         const Rox_Sint x0 = SHIFT - 8 * SCALE;
+         const Rox_Sint cell_u = ( x < x0 ) ? -1 : ( x - x0 ) / ( 8 * SCALE );
+         const Rox_Sint cell_v = ( y < x0 ) ? -1 : ( y - x0 ) / ( 8 * SCALE );
+         Rox_Sint bit = -1;
+
+         if ( cell_u == 0 && cell_v >= 1 && cell_v <= 16 ) bit = cell_v - 1;
+         if ( cell_u == 17 && cell_v >= 1 && cell_v <= 16 ) bit = 16 + cell_v - 1;
+         if ( cell_v == 0 && cell_u >= 1 && cell_u <= 16 ) bit = 32 + cell_u - 1;
+         if ( cell_v == 17 && cell_u >= 1 && cell_u <= 16 ) bit = 48 + cell_u - 1;
+
+         // The 16 bits code only uses the bottom cells
+         if ( code_bits == 16 ) bit = ( bit >= 48 ) ? bit - 48 : -1;
+
+         data[y][x] = ( bit >= 0 && ( bits >> bit ) & 1 ) ? 255 : 0;
+      }
+   }
+}
+
+static void set_homography ( Rox_MatSL3 homography, const Rox_Double du, const Rox_Double dv )
+{
+   rox_array2d_double_set_value ( homography, 0, 0, SCALE );
+   rox_array2d_double_set_value ( homography, 0, 2, SHIFT + du );
+   rox_array2d_double_set_value ( homography, 1, 1, SCALE );
+   rox_array2d_double_set_value ( homography, 1, 2, SHIFT + dv );
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_new)
@@ -57,20 +101,166 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_del)
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_make64)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CodedFrame codedframe = NULL;
+   Rox_Image image = NULL;
+   Rox_MatSL3 homography = NULL;
+   Rox_Ulint codeword = 0;
+   Rox_Sint value = 0;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   rox_image_new ( &image, SIZE, SIZE );
+   rox_matsl3_new ( &homography );
+   set_homography ( homography, 0.0, 0.0 );
 
+   error = rox_codedframe_new ( &codedframe );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // 6 cells are wrong
+   rox_bch_c8_e8_encode ( &codeword, 173 );
+   draw_code ( image, codeword ^ 0x0100200004008201ULL, 64 );
+
+   error = rox_codedframe_make64 ( codedframe, image, homography );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_codedframe_get_value ( &value, codedframe );
+   ROX_TEST_CHECK_EQUAL ( value, 173 );
+
+   rox_codedframe_del ( &codedframe );
+   rox_matsl3_del ( &homography );
+   rox_image_del ( &image );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_make16)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CodedFrame codedframe = NULL;
+   Rox_Image image = NULL;
+   Rox_MatSL3 homography = NULL;
+   Rox_Ushort codeword = 0;
+   Rox_Sint value = 0;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   rox_image_new ( &image, SIZE, SIZE );
+   rox_matsl3_new ( &homography );
+   set_homography ( homography, 0.0, 0.0 );
+   rox_codedframe_new ( &codedframe );
+
+   // 2 cells are wrong
+   rox_bch_c6_e2_encode ( &codeword, 45 );
+   draw_code ( image, codeword ^ 0x081, 16 );
+
+   error = rox_codedframe_make16 ( codedframe, image, homography );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_codedframe_get_value ( &value, codedframe );
+   ROX_TEST_CHECK_EQUAL ( value, 45 );
+
+   // 4 cells are wrong
+   draw_code ( image, codeword ^ 0x8181, 16 );
+
+   error = rox_codedframe_make16 ( codedframe, image, homography );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NUMERICAL_ALGORITHM_FAILURE );
+
+   rox_codedframe_del ( &codedframe );
+   rox_matsl3_del ( &homography );
+   rox_image_del ( &image );
+}
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_make_batch)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CodedFrame codedframe = NULL;
+   Rox_Image image = NULL;
+   Rox_MatSL3 homographies[40];
+   Rox_Sint values[40];
+   Rox_Ulint codeword = 0;
+   Rox_Uint failures = 0;
+
+   rox_image_new ( &image, SIZE, SIZE );
+   rox_codedframe_new ( &codedframe );
 
+   rox_bch_c8_e8_encode ( &codeword, 92 );
+   draw_code ( image, codeword, 64 );
+
+   // Shifted frames: the small shifts read the code, the large ones read other cells or outside of the image
+   for ( Rox_Sint k = 0; k < 40; k++ )
+   {
+      rox_matsl3_new ( &homographies[k] );
+      set_homography ( homographies[k], 0.75 * k - 3.0, 1.5 * ( k % 7 ) - 4.5 );
+   }
+
+   error = rox_codedframe_make_batch ( values, image, homographies, 40, 64 );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_TEST_CHECK_EQUAL ( values[4], 92 );
+
+   // The batch gives the results of the frame by frame decoding
+   for ( Rox_Sint k = 0; k < 40; k++ )
+   {
+      Rox_Sint value = -1;
+      if ( rox_codedframe_make64 ( codedframe, image, homographies[k] ) == ROX_ERROR_NONE )
+      {
+         rox_codedframe_get_value ( &value, codedframe );
+      }
+      if ( value != values[k] ) failures++;
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+
+   error = rox_codedframe_make_batch ( values, image, homographies, 40, 32 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   for ( Rox_Sint k = 0; k < 40; k++ ) rox_matsl3_del ( &homographies[k] );
+   rox_codedframe_del ( &codedframe );
+   rox_image_del ( &image );
+}
+
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_make_batch_small_image)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image black = NULL;
+   Rox_MatSL3 homographies[8];
+   Rox_Sint expected[8], values[8];
+   const Rox_Sint sizes[3][2] = { { 1, 1 }, { SIZE, 1 }, { 1, SIZE } };
+
+   // No cell can be read in an image without a 2x2 neighbourhood, all the bits are 0 as in a black image
+   error = rox_image_new ( &black, SIZE, SIZE );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uchar_fillval ( black, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < 8; k++ )
+   {
+      rox_matsl3_new ( &homographies[k] );
+      set_homography ( homographies[k], 0.5 * k, 0.25 * k );
+   }
+
+   for ( Rox_Sint code_bits = 16; code_bits <= 64; code_bits += 48 )
+   {
+      error = rox_codedframe_make_batch ( expected, black, homographies, 8, code_bits );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      for ( Rox_Sint s = 0; s < 3; s++ )
+      {
+         Rox_Image image = NULL;
+
+         error = rox_image_new ( &image, sizes[s][0], sizes[s][1] );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+         error = rox_array2d_uchar_fillval ( image, 255 );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+         error = rox_codedframe_make_batch ( values, image, homographies, 8, code_bits );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+         for ( Rox_Sint k = 0; k < 8; k++ ) ROX_TEST_CHECK_EQUAL ( values[k], expected[k] );
+
+         rox_image_del ( &image );
+      }
+   }
+
+   for ( Rox_Sint k = 0; k < 8; k++ ) rox_matsl3_del ( &homographies[k] );
+   rox_image_del ( &black );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_codedframe_get_value)
@@ -16,15 +16,24 @@
 
 #include <openrox_tests.hpp>
 
+#include <math.h>
+
 extern "C"
 {
 	#include <core/identification/multiident.h>
+	#include <core/identification/multiident_struct.h>
+	#include <generated/dynvec_point2d_float_struct.h>
+	#include <baseproc/array/fill/fillval.h>
+
 }
 
 //=== INTERNAL MACROS    =======================================================
 
 ROX_TEST_SUITE_BEGIN(multiident)
 
+#define TEMPLATES 4
+#define SIZE 160
+
 //=== INTERNAL TYPESDEFS =======================================================
 
 //=== INTERNAL DATATYPES =======================================================
@@ -35,6 +44,39 @@ ROX_TEST_SUITE_BEGIN(multiident)
 
 //=== INTERNAL FUNCTIONS =======================================================
 
+// Draw pseudo random blobs in a block of an image
+static Rox_ErrorCode draw_texture ( Rox_Array2D_Float image, Rox_Sint top, Rox_Sint left, Rox_Uint seed )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float ** data = NULL;
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &data, image );
+   if ( error ) return error;
+
+   for ( Rox_Sint i = 0; i < SIZE; i++ )
+      for ( Rox_Sint j = 0; j < SIZE; j++ )
+         data[top + i][left + j] = 0.5f;
+
+   for ( Rox_Sint blob = 0; blob < 60; blob++ )
+   {
+      seed = seed * 1103515245u + 12345u; Rox_Float u = (Rox_Float) ( ( seed >> 16 ) % SIZE );
+      seed = seed * 1103515245u + 12345u; Rox_Float v = (Rox_Float) ( ( seed >> 16 ) % SIZE );
+      seed = seed * 1103515245u + 12345u; Rox_Float r = 2.0f + (Rox_Float) ( ( seed >> 16 ) % 6 );
+      seed = seed * 1103515245u + 12345u; Rox_Float a = ( ( seed >> 16 ) % 2 ) ? 0.4f : -0.4f;
+
+      for ( Rox_Sint i = 0; i < SIZE; i++ )
+      {
+         for ( Rox_Sint j = 0; j < SIZE; j++ )
+         {
+            Rox_Float d2 = ( ( i - v ) * ( i - v ) + ( j - u ) * ( j - u ) ) / ( r * r );
+            if ( d2 < 9.0f ) data[top + i][left + j] += a * expf ( -d2 );
+         }
+      }
+   }
+
+   return error;
+}
+
 //=== EXPORTED FUNCTIONS =======================================================
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_multiident_new)
@@ -85,10 +127,82 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_multiident_compile)
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_multiident_make)
 {
 	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Multi_Ident multi_ident = NULL;
+   Rox_Array2D_Float model = NULL, current = NULL;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   error = rox_multi_ident_new ( &multi_ident );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Uint k = 0; k < TEMPLATES; k++ )
+   {
+      error = rox_array2d_float_new ( &model, SIZE, SIZE );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = draw_texture ( model, 0, 0, 1000 + k );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_multi_ident_add_template ( multi_ident, model, NULL, 0, 0 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      rox_array2d_float_del ( &model );
+   }
 
+   error = rox_multi_ident_compile ( multi_ident );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( multi_ident->compiled, 1u );
+
+   // The third template is seen in a larger image
+   error = rox_array2d_float_new ( &current, SIZE + 60, SIZE + 80 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_float_fillval ( current, 0.5f );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = draw_texture ( current, 23, 37, 1002 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Twice, the doubled image is reused by the second call
+   for ( Rox_Sint trial = 0; trial < 2; trial++ )
+   {
+      Rox_Uint id = 100;
+
+      error = rox_multi_ident_make ( multi_ident, current, 1 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      // The seen template has most of the matches, at the right place
+      Rox_Template_Ident seen = multi_ident->idents->data[2];
+      ROX_TEST_CHECK_EQUAL ( ( seen->count_matched > 20 ), true );
+      for ( Rox_Uint k = 0; k < TEMPLATES; k++ )
+      {
+         if ( k != 2 ) ROX_TEST_CHECK_EQUAL ( ( multi_ident->idents->data[k]->count_matched * 2 < seen->count_matched ), true );
+      }
+
+      Rox_Sint inliers = 0;
+      for ( Rox_Sint i = 0; i < seen->count_matched; i++ )
+      {
+         Rox_Float du = seen->current_points_matched->data[i].u - seen->reference_points_matched->data[i].u - 37.0f;
+         Rox_Float dv = seen->current_points_matched->data[i].v - seen->reference_points_matched->data[i].v - 23.0f;
+         if ( fabsf ( du ) < 1.0f && fabsf ( dv ) < 1.0f ) inliers++;
+      }
+      ROX_TEST_CHECK_EQUAL ( ( inliers * 4 >= seen->count_matched * 3 ), true );
+
+      error = rox_multi_ident_find_next_best ( &id, multi_ident );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( id, 2u );
+   }
+
+   // Adding a template invalidates the index, which is rebuilt by make
+   error = rox_multi_ident_add_template ( multi_ident, current, NULL, 0, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( multi_ident->compiled, 0u );
+
+   error = rox_multi_ident_make ( multi_ident, current, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( multi_ident->compiled, 1u );
+   ROX_TEST_CHECK_EQUAL ( ( multi_ident->idents->data[TEMPLATES]->count_matched > 10 ), true );
+
+   rox_array2d_float_del ( &current );
+   rox_multi_ident_del ( &multi_ident );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_multiident_find_next_best)
@@ -18,7 +18,9 @@
 
 extern "C"
 {
+	#include <baseproc/geometry/point/point2d_struct.h>
 	#include <core/indirect/essential/e5points.h>
+	#include <math.h>
 }
 
 //=== INTERNAL MACROS    =====================================================
@@ -47,4 +49,94 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_essential_from_5_points_nister)
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_essential_from_5_points_nister_batch)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Essential_Solutions_Struct solutions[2];
+   Rox_Point2D_Double_Struct ref2D[10], cur2D[10];
+   Rox_Matrix Ematrices[10];
+   Rox_Uint nbsolutions = 0;
+   Rox_Double ** dE = NULL;
+
+   // Rotation of about 0.1 rad around (1,2,3)/sqrt(14) and translation
+   const Rox_Double R[9] = {  0.995346653, -0.079488138,  0.054395154,
+                              0.080863940,  0.996462530, -0.023330560,
+                             -0.052348418,  0.027626476,  0.998246667 };
+   const Rox_Double t[3] = { 0.3, -0.1, 0.05 };
+
+   const Rox_Double X[10][3] = { { -0.5,  0.3, 4.0 }, {  0.4,  0.2, 3.5 }, {  0.1, -0.6, 5.0 }, { -0.3, -0.2, 3.0 }, {  0.6,  0.5, 4.5 },
+                                 {  0.2,  0.7, 6.0 }, { -0.7,  0.1, 5.5 }, {  0.5, -0.4, 4.2 }, { -0.1, -0.5, 3.8 }, {  0.3,  0.1, 2.5 } };
+
+   for ( Rox_Sint i = 0; i < 10; i++ )
+   {
+      const Rox_Double Xc = R[0] * X[i][0] + R[1] * X[i][1] + R[2] * X[i][2] + t[0];
+      const Rox_Double Yc = R[3] * X[i][0] + R[4] * X[i][1] + R[5] * X[i][2] + t[1];
+      const Rox_Double Zc = R[6] * X[i][0] + R[7] * X[i][1] + R[8] * X[i][2] + t[2];
+
+      ref2D[i].u = X[i][0] / X[i][2];
+      ref2D[i].v = X[i][1] / X[i][2];
+      cur2D[i].u = Xc / Zc;
+      cur2D[i].v = Yc / Zc;
+   }
+
+   for ( Rox_Sint k = 0; k < 10; k++ )
+   {
+      error = rox_array2d_double_new ( &Ematrices[k], 3, 3 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_essential_from_5_points_nister_batch ( solutions, ref2D, cur2D, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint s = 0; s < 2; s++ )
+   {
+      Rox_Double best = 1e10;
+
+      // The batch gives the same solutions as the sample by sample function
+      error = rox_essential_from_5_points_nister ( Ematrices, &nbsolutions, &ref2D[5 * s], &cur2D[5 * s] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( solutions[s].count, nbsolutions );
+      ROX_TEST_CHECK_EQUAL ( nbsolutions > 0, 1 );
+
+      for ( Rox_Uint id = 0; id < nbsolutions; id++ )
+      {
+         const Rox_Double * E = solutions[s].essentials[id];
+         Rox_Double norm = 0.0, residual = 0.0;
+
+         rox_array2d_double_get_data_pointer_to_pointer ( &dE, Ematrices[id] );
+         for ( Rox_Sint i = 0; i < 9; i++ ) ROX_TEST_CHECK_EQUAL ( E[i], dE[i / 3][i % 3] );
+
+         for ( Rox_Sint i = 0; i < 9; i++ ) norm += E[i] * E[i];
+         norm = sqrt ( norm );
+
+         // Epipolar constraint on the 10 points
+         for ( Rox_Sint i = 0; i < 10; i++ )
+         {
+            const Rox_Double r[3] = { ref2D[i].u, ref2D[i].v, 1.0 };
+            const Rox_Double c[3] = { cur2D[i].u, cur2D[i].v, 1.0 };
+            Rox_Double value = 0.0;
+
+            for ( Rox_Sint k = 0; k < 3; k++ )
+               for ( Rox_Sint l = 0; l < 3; l++ )
+                  value += c[k] * E[k * 3 + l] * r[l];
+
+            residual = fmax ( residual, fabs ( value ) / norm );
+         }
+
+         best = fmin ( best, residual );
+      }
+
+      // One of the solutions is the true essential matrix
+      ROX_TEST_CHECK_SMALL ( best, 1e-6 );
+   }
+
+   error = rox_essential_from_5_points_nister_batch ( NULL, ref2D, cur2D, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   error = rox_essential_from_5_points_nister_batch ( solutions, ref2D, cur2D, -1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   for ( Rox_Sint k = 0; k < 10; k++ ) rox_array2d_double_del ( &Ematrices[k] );
+}
+
 ROX_TEST_SUITE_END()
@@ -23,6 +23,7 @@ extern "C"
    #include <baseproc/geometry/transforms/transform_tools.h>
    #include <baseproc/geometry/point/point2d_matsl3_transform.h>
    #include <inout/system/print.h>
+   #include <math.h>
 }
 
 //=== INTERNAL MACROS    =======================================================
@@ -148,4 +149,78 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_pose_from_3_points)
 
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_pose_from_p3p_nor_batch)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Double_Collection possible_poses = NULL;
+   Rox_P3P_Solutions_Struct solutions[2];
+   Rox_Point3D_Double_Struct points3D_met[6];
+   Rox_Point2D_Double_Struct points2D_nor[6];
+   Rox_Uint validposes = 0;
+   Rox_Double data[16];
+
+   // True pose
+   const Rox_Double cTo[12] = { 0.675548777432067, -0.729902581358856, 0.104288403169853, 0.629928806492942,
+                                0.734135403681394,  0.678995087003757, -0.003298618850060, 0.300760910946984,
+                               -0.068403642970219,  0.078790186891761,  0.994541627121743, 2.000000000000000 };
+
+   error = rox_array2d_double_collection_new(&possible_poses, 4, 4, 4); 
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   points3D_met[0].X=-0.10; points3D_met[1].X=+0.10; points3D_met[2].X=0.10;
+   points3D_met[0].Y=-0.10; points3D_met[1].Y=-0.10; points3D_met[2].Y=0.10;
+   points3D_met[0].Z=+0.01; points3D_met[1].Z=+0.00; points3D_met[2].Z=0.01;
+   points3D_met[3].X=-0.05; points3D_met[4].X=+0.12; points3D_met[5].X=-0.08;
+   points3D_met[3].Y=+0.07; points3D_met[4].Y=+0.02; points3D_met[5].Y=-0.11;
+   points3D_met[3].Z=+0.03; points3D_met[4].Z=-0.02; points3D_met[5].Z=0.00;
+
+   // Project the points with the true pose
+   for ( Rox_Sint i = 0; i < 6; i++ )
+   {
+      const Rox_Point3D_Double_Struct * m = &points3D_met[i];
+      const Rox_Double X = cTo[0] * m->X + cTo[1] * m->Y + cTo[2]  * m->Z + cTo[3];
+      const Rox_Double Y = cTo[4] * m->X + cTo[5] * m->Y + cTo[6]  * m->Z + cTo[7];
+      const Rox_Double Z = cTo[8] * m->X + cTo[9] * m->Y + cTo[10] * m->Z + cTo[11];
+      points2D_nor[i].u = X / Z;
+      points2D_nor[i].v = Y / Z;
+   }
+
+   error = rox_pose_from_p3p_nor_batch ( solutions, points3D_met, points2D_nor, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < 2; k++ )
+   {
+      Rox_Double best = 1e10;
+
+      // The batch gives the same poses as the sample by sample function
+      error = rox_pose_from_p3p_nor ( possible_poses, &validposes, &points3D_met[3 * k], &points2D_nor[3 * k] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( solutions[k].count, validposes );
+      ROX_TEST_CHECK_EQUAL ( validposes > 0, 1 );
+
+      for ( Rox_Uint id_pose = 0; id_pose < validposes; id_pose++ )
+      {
+         Rox_Double distance = 0.0;
+
+         rox_matse3_get_data ( data, rox_array2d_double_collection_get ( possible_poses, id_pose ) );
+         for ( Rox_Sint i = 0; i < 16; i++ ) ROX_TEST_CHECK_EQUAL ( solutions[k].poses[id_pose][i], data[i] );
+
+         for ( Rox_Sint i = 0; i < 12; i++ ) distance = fmax ( distance, fabs ( data[i] - cTo[i] ) );
+         best = fmin ( best, distance );
+      }
+
+      // The true pose is one of the solutions
+      ROX_TEST_CHECK_SMALL ( best, 1e-6 );
+   }
+
+   error = rox_pose_from_p3p_nor_batch ( NULL, points3D_met, points2D_nor, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   error = rox_pose_from_p3p_nor_batch ( solutions, points3D_met, points2D_nor, -1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_array2d_double_collection_del(&possible_poses); 
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
 ROX_TEST_SUITE_END()
@@ -16,9 +16,13 @@
 
 #include <openrox_tests.hpp>
 
+#include <math.h>
+
 extern "C"
 {
 	#include <core/odometry/multiplane/odometry_planes.h>
+	#include <baseproc/maths/linalg/matse3.h>
+	#include <baseproc/maths/linalg/matut3.h>
 }
 
 //=== INTERNAL MACROS    =====================================================
@@ -39,6 +43,16 @@ ROX_TEST_SUITE_BEGIN(odometry_planes)
 #define CU_M2D 255.5
 #define CV_M2D 255.5
 
+// A wall of 5 x 4 textured planes of 0.04 x 0.04 m seen fronto-parallel at 0.5 m
+#define GRID_COLS 5
+#define GRID_ROWS 4
+#define PLANE_SIZE 0.04
+#define DEPTH 0.5
+#define FOCAL 600.0
+#define IMG_ROWS 240
+#define IMG_COLS 320
+#define TEMPLATE_SIZE 128
+
 //=== INTERNAL TYPESDEFS =====================================================
 
 //=== INTERNAL DATATYPES =====================================================
@@ -49,6 +63,88 @@ ROX_TEST_SUITE_BEGIN(odometry_planes)
 
 //=== INTERNAL FUNCTIONS =====================================================
 
+// Smooth texture of the wall, in meters in the object frame
+static Rox_Double wall_texture ( Rox_Double X, Rox_Double Y )
+{
+   return 0.5 + 0.2 * sin ( 90.0 * X ) * cos ( 70.0 * Y ) + 0.15 * sin ( 55.0 * X + 80.0 * Y );
+}
+
+// Append the planes of the wall to a model, each template samples the texture of its plane
+static Rox_ErrorCode build_wall_model ( Rox_Model_Multi_Plane model )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image image_template = NULL;
+   Rox_Uchar ** data = NULL;
+   Rox_Point3D_Double_Struct vertices[4];
+
+   error = rox_array2d_uchar_new ( &image_template, TEMPLATE_SIZE, TEMPLATE_SIZE );
+   if ( error ) return error;
+
+   error = rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image_template );
+   if ( error ) return error;
+
+   for ( Rox_Sint r = 0; r < GRID_ROWS; r++ )
+   {
+      for ( Rox_Sint c = 0; c < GRID_COLS; c++ )
+      {
+         Rox_Double x0 = ( c - GRID_COLS * 0.5 ) * PLANE_SIZE;
+         Rox_Double y0 = ( r - GRID_ROWS * 0.5 ) * PLANE_SIZE;
+
+         vertices[0].X = x0;              vertices[0].Y = y0;              vertices[0].Z = 0;
+         vertices[1].X = x0 + PLANE_SIZE; vertices[1].Y = y0;              vertices[1].Z = 0;
+         vertices[2].X = x0 + PLANE_SIZE; vertices[2].Y = y0 + PLANE_SIZE; vertices[2].Z = 0;
+         vertices[3].X = x0;              vertices[3].Y = y0 + PLANE_SIZE; vertices[3].Z = 0;
+
+         // The edges of the template pixels are mapped on the vertices
+         for ( Rox_Sint i = 0; i < TEMPLATE_SIZE; i++ )
+         {
+            for ( Rox_Sint j = 0; j < TEMPLATE_SIZE; j++ )
+            {
+               Rox_Double X = x0 + ( j + 0.5 ) * PLANE_SIZE / TEMPLATE_SIZE;
+               Rox_Double Y = y0 + ( i + 0.5 ) * PLANE_SIZE / TEMPLATE_SIZE;
+               data[i][j] = (Rox_Uchar) ( 255.0 * wall_texture ( X, Y ) + 0.5 );
+            }
+         }
+
+         error = rox_model_multi_plane_append_plane ( model, image_template, vertices );
+         if ( error ) break;
+      }
+   }
+
+   rox_array2d_uchar_del ( &image_template );
+   return error;
+}
+
+// Render the wall seen at the identity rotation and a depth of DEPTH
+static Rox_ErrorCode render_wall ( Rox_Array2D_Float image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Float ** data = NULL;
+
+   error = rox_array2d_float_get_data_pointer_to_pointer ( &data, image );
+   if ( error ) return error;
+
+   for ( Rox_Sint i = 0; i < IMG_ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < IMG_COLS; j++ )
+      {
+         Rox_Double X = ( j - ( IMG_COLS - 1 ) * 0.5 ) * DEPTH / FOCAL;
+         Rox_Double Y = ( i - ( IMG_ROWS - 1 ) * 0.5 ) * DEPTH / FOCAL;
+
+         if ( fabs ( X ) < GRID_COLS * PLANE_SIZE * 0.5 && fabs ( Y ) < GRID_ROWS * PLANE_SIZE * 0.5 )
+         {
+            data[i][j] = (Rox_Float) wall_texture ( X, Y );
+         }
+         else
+         {
+            data[i][j] = 0.5f;
+         }
+      }
+   }
+
+   return error;
+}
+
 //=== EXPORTED FUNCTIONS =====================================================
 
 
@@ -63,11 +159,96 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_odometry_planes_new_del)
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_odometry_planes_make)
 {
-	Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Odometry_Planes odometry_planes = NULL;
+   Rox_Model_Multi_Plane model = NULL;
+   Rox_Array2D_Float image = NULL;
+   Rox_MatUT3 K = NULL;
+   Rox_MatSE3 pose = NULL;
+   Rox_Double ** K_data = NULL, ** pose_data = NULL;
+   Rox_Double score = 0.0;
+   Rox_Sint is_tracked = 0;
 
-	ROX_TEST_MESSAGE ( "This test has not been implemented yet !!! \n" );
+   error = rox_model_multi_plane_new ( &model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = build_wall_model ( model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_float_new ( &image, IMG_ROWS, IMG_COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = render_wall ( image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 
+   error = rox_matut3_new ( &K );
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &K_data, K );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   K_data[0][0] = FOCAL; K_data[0][2] = ( IMG_COLS - 1 ) * 0.5;
+   K_data[1][1] = FOCAL; K_data[1][2] = ( IMG_ROWS - 1 ) * 0.5;
+
+   error = rox_matse3_new ( &pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &pose_data, pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The wall is tracked from a shifted pose
+   for ( Rox_Sint trial = 0; trial < 2; trial++ )
+   {
+      error = rox_odometry_planes_new ( &odometry_planes, model );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_odometry_planes_set_camera_calibration ( odometry_planes, K );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      // The second trial culls all the planes for lack of texture
+      if ( trial == 1 )
+      {
+         error = rox_odometry_planes_set_min_gradient ( odometry_planes, 1.0 );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      }
+
+      error = rox_matse3_set_unit ( pose );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      pose_data[0][3] = 0.004;
+      pose_data[1][3] = -0.003;
+      pose_data[2][3] = DEPTH + 0.01;
+
+      error = rox_odometry_planes_set_pose ( odometry_planes, pose );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_odometry_planes_make ( odometry_planes, model, image );
+
+      if ( trial == 0 )
+      {
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+         error = rox_odometry_planes_get_result ( &is_tracked, &score, pose, odometry_planes );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+         ROX_TEST_CHECK_EQUAL ( is_tracked, 1 );
+
+         ROX_TEST_CHECK_SMALL ( pose_data[0][3], 1e-3 );
+         ROX_TEST_CHECK_SMALL ( pose_data[1][3], 1e-3 );
+         ROX_TEST_CHECK_CLOSE ( pose_data[2][3], DEPTH, 1e-3 );
+      }
+      else
+      {
+         ROX_TEST_CHECK_NOT_EQUAL ( error, ROX_ERROR_NONE );
+      }
+
+      error = rox_odometry_planes_del ( &odometry_planes );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   rox_matse3_del ( &pose );
+   rox_matut3_del ( &K );
+   rox_array2d_float_del ( &image );
+   rox_model_multi_plane_del ( &model );
 }
 
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_odometry_planes_set_pose)
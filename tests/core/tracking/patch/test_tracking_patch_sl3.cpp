@@ -19,8 +19,12 @@
 extern "C"
 {
 	#include <core/tracking/patch/tracking_patch_sl3.h>
+	#include <core/patch/patchplane.h>
+	#include <baseproc/array/fill/fillval.h>
 }
 
+#include <math.h>
+
 //=== INTERNAL MACROS    =====================================================
 
 ROX_TEST_SUITE_BEGIN(tracking_patch_sl3)
@@ -35,6 +39,12 @@ ROX_TEST_SUITE_BEGIN(tracking_patch_sl3)
 
 //=== INTERNAL FUNCTIONS =====================================================
 
+// Smooth synthetic texture
+static Rox_Float texture ( Rox_Double u, Rox_Double v )
+{
+   return (Rox_Float) ( 0.5 + 0.2 * sin ( u / 5.0 ) + 0.2 * cos ( v / 7.0 ) + 0.1 * sin ( ( u + v ) / 9.0 ) );
+}
+
 //=== EXPORTED FUNCTIONS =====================================================
 
 
@@ -65,6 +75,81 @@ ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_tracking_patch_sl3_make)
    ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
 }
 
+ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_tracking_patch_sl3_make_inverse_compositional)
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Float image = NULL, reference = NULL;
+   Rox_Imask reference_mask = NULL;
+   Rox_PatchPlane patch = NULL;
+   Rox_Tracking_Patch_SL3 tracker = NULL;
+   Rox_MatSL3 homography = NULL;
+   Rox_Float ** image_data = NULL, ** reference_data = NULL;
+   Rox_Double ** H = NULL;
+
+   error = rox_array2d_float_new ( &image, 120, 120 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_float_new ( &reference, 40, 40 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uint_new ( &reference_mask, 40, 40 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_uint_fillval ( reference_mask, ~0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The reference is the image translated by (40,40)
+   rox_array2d_float_get_data_pointer_to_pointer ( &image_data, image );
+   rox_array2d_float_get_data_pointer_to_pointer ( &reference_data, reference );
+
+   for ( Rox_Sint i = 0; i < 120; i++ )
+      for ( Rox_Sint j = 0; j < 120; j++ )
+         image_data[i][j] = texture ( j, i );
+
+   for ( Rox_Sint i = 0; i < 40; i++ )
+      for ( Rox_Sint j = 0; j < 40; j++ )
+         reference_data[i][j] = texture ( j + 40, i + 40 );
+
+   error = rox_patchplane_new ( &patch, 40, 40 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_patchplane_set_reference ( patch, reference, reference_mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_patchplane_set_inverse_compositional ( patch, Rox_Linsys_Steepest_Descent_Model_SL3_Light_Affine );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_tracking_patch_sl3_new ( &tracker );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Start 1.5 pixels away from the solution
+   error = rox_matsl3_new ( &homography );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_double_get_data_pointer_to_pointer ( &H, homography );
+   H[0][2] = 41.5;
+   H[1][2] = 39.0;
+
+   error = rox_tracking_patch_sl3_set_homography ( tracker, homography );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_tracking_patch_sl3_make ( tracker, patch, image, 30 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_tracking_patch_sl3_get_homography ( homography, tracker );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_TEST_CHECK_CLOSE ( H[0][2] / H[2][2], 40.0, 0.1 );
+   ROX_TEST_CHECK_CLOSE ( H[1][2] / H[2][2], 40.0, 0.1 );
+
+   rox_matsl3_del ( &homography );
+   rox_tracking_patch_sl3_del ( &tracker );
+   rox_patchplane_del ( &patch );
+   rox_array2d_uint_del ( &reference_mask );
+   rox_array2d_float_del ( &reference );
+   rox_array2d_float_del ( &image );
+}
+
 ROX_TEST_CASE_DECLARE(rox::OpenROXTest, test_tracking_patch_sl3_set_homography)
 {
 	Rox_ErrorCode error = ROX_ERROR_NONE;
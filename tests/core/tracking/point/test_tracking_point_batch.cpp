@@ -0,0 +1,235 @@
+//==============================================================================
+//
+//    OPENROX   : File test_tracking_point_batch.cpp
+//
+//    Contents  : Tests for tracking_point_batch.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+#include <vector>
+
+extern "C"
+{
+   #include <core/tracking/point/tracking_point_batch.h>
+   #include <core/tracking/point/tracking_point_9x9.h>
+   #include <core/tracking/point/tracking_point_11x11.h>
+   #include <baseproc/geometry/point/point2d_struct.h>
+   #include <baseproc/image/pyramid/pyramid_uchar.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( tracking_point_batch )
+
+#define ROWS 240
+#define COLS 320
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Smooth texture translated by (tu, tv)
+static void fill ( Rox_Image image, Rox_Double tu, Rox_Double tv )
+{
+   Rox_Uchar ** data = NULL;
+   rox_image_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         const Rox_Double u = j - tu, v = i - tv;
+         const Rox_Double value = 128.0 + 45.0 * sin ( 0.21 * u + 0.3 * sin ( 0.05 * v ) ) + 40.0 * sin ( 0.17 * v + 0.11 * u ) + 30.0 * sin ( 0.07 * u - 0.13 * v );
+         data[i][j] = ( Rox_Uchar ) value;
+      }
+   }
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_tracking_point_batch_single_level )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image reference = NULL, current = NULL;
+   Rox_Pyramid_Uchar pyramid_reference = NULL, pyramid_current = NULL;
+   Rox_Uint failures = 0;
+   const Rox_Sint count = 203;
+
+   rox_image_new ( &reference, COLS, ROWS );
+   rox_image_new ( &current, COLS, ROWS );
+   fill ( reference, 0.0, 0.0 );
+   fill ( current, 1.3, -0.7 );
+
+   rox_pyramid_uchar_new ( &pyramid_reference, COLS, ROWS, 1, 16 );
+   rox_pyramid_uchar_new ( &pyramid_current, COLS, ROWS, 1, 16 );
+   rox_pyramid_uchar_assign ( pyramid_reference, reference );
+   rox_pyramid_uchar_assign ( pyramid_current, current );
+
+   // Points on a grid, some of them too close to the border
+   std::vector<Rox_Point2D_Double_Struct> points ( count ), tracked ( count );
+   for ( Rox_Sint p = 0; p < count; p++ )
+   {
+      points[p].u = 2.0 + ( p * 37 ) % ( COLS - 4 ) + 0.25;
+      points[p].v = 2.0 + ( p * 53 ) % ( ROWS - 4 ) + 0.5;
+   }
+
+   std::vector<Rox_ErrorCode> status ( count );
+   std::vector<Rox_Double> scores ( count );
+
+   // The batch gives the same results as the single point trackers
+   for ( Rox_Sint size = 9; size <= 11; size += 2 )
+   {
+      Rox_Tracking_Point_Batch batch = NULL;
+
+      error = rox_tracking_point_batch_new ( &batch, size, count, 1 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_tracking_point_batch_set_reference ( batch, pyramid_reference, &points[0], count );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      for ( Rox_Sint p = 0; p < count; p++ )
+      {
+         tracked[p].u = points[p].u + 1.0;
+         tracked[p].v = points[p].v - 1.0;
+      }
+
+      error = rox_tracking_point_batch_track ( &tracked[0], &status[0], &scores[0], batch, pyramid_current, 0.9 );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      Rox_Uint count_tracked = 0, count_inaccurate = 0;
+      const Rox_Sint half = ( size - 1 ) / 2;
+
+      for ( Rox_Sint p = 0; p < count; p++ )
+      {
+         Rox_ErrorCode single_error = ROX_ERROR_NONE;
+         Rox_Double u = 0.0, v = 0.0;
+
+         if ( size == 9 )
+         {
+            Rox_Tracking_Point_9x9 single = NULL;
+            rox_tracking_point_9x9_new ( &single );
+            single_error = rox_tracking_point_9x9_set_reference ( single, reference, points[p].u - half, points[p].v - half );
+            if ( !single_error )
+            {
+               rox_tracking_point_9x9_set_predicted_position ( single, points[p].u - half + 1.0, points[p].v - half - 1.0 );
+               single_error = rox_tracking_point_9x9_track ( single, current, 0.9 );
+               rox_tracking_point_9x9_get_current ( &u, &v, single );
+            }
+            rox_tracking_point_9x9_del ( &single );
+         }
+         else
+         {
+            Rox_Tracking_Point_11x11 single = NULL;
+            rox_tracking_point_11x11_new ( &single );
+            single_error = rox_tracking_point_11x11_set_reference ( single, reference, points[p].u - half, points[p].v - half );
+            if ( !single_error )
+            {
+               rox_tracking_point_11x11_set_predicted_position ( single, points[p].u - half + 1.0, points[p].v - half - 1.0 );
+               single_error = rox_tracking_point_11x11_track ( single, current, 0.9 );
+               rox_tracking_point_11x11_get_current ( &u, &v, single );
+            }
+            rox_tracking_point_11x11_del ( &single );
+         }
+
+         if ( ( single_error == ROX_ERROR_NONE ) != ( status[p] == ROX_ERROR_NONE ) ) failures++;
+         if ( single_error != ROX_ERROR_NONE ) continue;
+
+         count_tracked++;
+         if ( fabs ( u + half - tracked[p].u ) > 1e-9 || fabs ( v + half - tracked[p].v ) > 1e-9 ) failures++;
+         if ( fabs ( tracked[p].u - points[p].u - 1.3 ) > 0.1 || fabs ( tracked[p].v - points[p].v + 0.7 ) > 0.1 ) count_inaccurate++;
+      }
+
+      ROX_TEST_CHECK_EQUAL ( failures, 0u );
+      ROX_TEST_CHECK_EQUAL ( count_tracked > 150, 1 );
+      ROX_TEST_CHECK_EQUAL ( count_inaccurate < count_tracked / 20, 1 );
+
+      rox_tracking_point_batch_del ( &batch );
+   }
+
+   rox_pyramid_uchar_del ( &pyramid_current );
+   rox_pyramid_uchar_del ( &pyramid_reference );
+   rox_image_del ( &current );
+   rox_image_del ( &reference );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_tracking_point_batch_pyramid )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image reference = NULL, current = NULL;
+   Rox_Pyramid_Uchar pyramid_reference = NULL, pyramid_current = NULL;
+   Rox_Tracking_Point_Batch batch = NULL;
+   Rox_Uint count_tracked = 0, failures = 0;
+   const Rox_Sint count = 100;
+
+   // A large motion only recovered from the coarse levels
+   rox_image_new ( &reference, COLS, ROWS );
+   rox_image_new ( &current, COLS, ROWS );
+   fill ( reference, 0.0, 0.0 );
+   fill ( current, 6.4, -4.8 );
+
+   rox_pyramid_uchar_new ( &pyramid_reference, COLS, ROWS, 3, 16 );
+   rox_pyramid_uchar_new ( &pyramid_current, COLS, ROWS, 3, 16 );
+   rox_pyramid_uchar_assign ( pyramid_reference, reference );
+   rox_pyramid_uchar_assign ( pyramid_current, current );
+
+   std::vector<Rox_Point2D_Double_Struct> points ( count ), tracked ( count );
+   for ( Rox_Sint p = 0; p < count; p++ )
+   {
+      points[p].u = 40.0 + ( p % 10 ) * 24.0;
+      points[p].v = 40.0 + ( p / 10 ) * 16.0;
+      tracked[p] = points[p];
+   }
+
+   std::vector<Rox_ErrorCode> status ( count );
+
+   error = rox_tracking_point_batch_new ( &batch, 9, count, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_tracking_point_batch_set_reference ( batch, pyramid_reference, &points[0], count );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_tracking_point_batch_track ( &tracked[0], &status[0], NULL, batch, pyramid_current, 0.9 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint p = 0; p < count; p++ )
+   {
+      if ( status[p] != ROX_ERROR_NONE ) continue;
+      count_tracked++;
+      if ( fabs ( tracked[p].u - points[p].u - 6.4 ) > 0.2 || fabs ( tracked[p].v - points[p].v + 4.8 ) > 0.2 ) failures++;
+   }
+
+   ROX_TEST_CHECK_EQUAL ( failures, 0u );
+   ROX_TEST_CHECK_EQUAL ( count_tracked > 90, 1 );
+
+   error = rox_tracking_point_batch_set_reference ( batch, pyramid_reference, &points[0], count + 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   Rox_Tracking_Point_Batch even = NULL;
+   error = rox_tracking_point_batch_new ( &even, 8, count, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_BAD_SIZE );
+
+   rox_tracking_point_batch_del ( &batch );
+   rox_pyramid_uchar_del ( &pyramid_current );
+   rox_pyramid_uchar_del ( &pyramid_reference );
+   rox_image_del ( &current );
+   rox_image_del ( &reference );
+}
+
+ROX_TEST_SUITE_END ( )
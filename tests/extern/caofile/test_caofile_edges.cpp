@@ -0,0 +1,265 @@
+//==============================================================================
+//
+//    OPENROX   : File test_caofile_edges.cpp
+//
+//    Contents  : Tests for caofile_edges.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+#include <vector>
+
+extern "C"
+{
+   #include <extern/caofile/caofile_edges.h>
+   #include <baseproc/maths/linalg/matse3.h>
+   #include <inout/system/errors_print.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( caofile_edges )
+
+#define COLS 640
+#define ROWS 480
+#define FU   500.0
+#define FV   500.0
+#define CU   320.0
+#define CV   240.0
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+// Seen from the camera at the origin looking along z:
+// A front square at z = 5 hiding the smaller front square B at z = 10,
+// C a front square out of the image, D a front square at z = 10 beside A,
+// E a back face, F a line in the image, G a line out of the image,
+// H a line just beyond the right border of the image,
+// one circle and one cylinder in the image, one circle and one cylinder out of it.
+static const char * model =
+   "V1\n"
+   "36\n"
+   "-1 -1 5\n" "-1 1 5\n" "1 1 5\n" "1 -1 5\n"
+   "-0.5 -0.5 10\n" "-0.5 0.5 10\n" "0.5 0.5 10\n" "0.5 -0.5 10\n"
+   "20 -1 5\n" "20 1 5\n" "22 1 5\n" "22 -1 5\n"
+   "3 -0.5 10\n" "3 0.5 10\n" "4 0.5 10\n" "4 -0.5 10\n"
+   "-3 -1 6\n" "-2 -1 6\n" "-2 1 6\n" "-3 1 6\n"
+   "0 2.2 5\n" "0.5 2.2 5\n"
+   "-30 0 5\n" "-29 0 5\n"
+   "3.21 0 5\n" "3.5 0 5\n"
+   "0 -1.6 5\n" "0.2 -1.6 5\n" "0 -1.4 5\n"
+   "-25 0 5\n" "-24.8 0 5\n" "-25 0.2 5\n"
+   "2 2 8\n" "2.5 2 8\n"
+   "25 25 8\n" "25.5 25 8\n"
+   "23\n"
+   "0 1 a\n" "1 2 a\n" "2 3 a\n" "3 0 a\n"
+   "4 5 b\n" "5 6 b\n" "6 7 b\n" "7 4 b\n"
+   "8 9 c\n" "9 10 c\n" "10 11 c\n" "11 8 c\n"
+   "12 13 d\n" "13 14 d\n" "14 15 d\n" "15 12 d\n"
+   "16 17 e\n" "17 18 e\n" "18 19 e\n" "19 16 e\n"
+   "20 21 f\n"
+   "22 23 g\n"
+   "24 25 h\n"
+   "5\n"
+   "4 0 1 2 3 a\n"
+   "4 4 5 6 7 b\n"
+   "4 8 9 10 11 c\n"
+   "4 12 13 14 15 d\n"
+   "4 16 17 18 19 e\n"
+   "0\n"
+   "2\n"
+   "32 33 0.1\n"
+   "34 35 0.1\n"
+   "2\n"
+   "0.2 26 27 28\n"
+   "0.2 29 30 31\n";
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Copy of the current contours, the pointer of the library changes with the next estimation
+static std::vector<Rox_Segment3D_Struct> get_contours ( Rox_CaoFile_Edges caofile )
+{
+   Rox_Segment3D_Struct * contours = NULL;
+   Rox_Uint count = 0;
+
+   rox_caofile_edges_get_contours ( &contours, &count, caofile );
+   return std::vector<Rox_Segment3D_Struct> ( contours, contours + count );
+}
+
+static bool same_point ( const Rox_Point3D_Double_Struct & a, const Rox_Point3D_Double_Struct & b )
+{
+   return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+}
+
+static bool contains ( const std::vector<Rox_Segment3D_Struct> & list, const Rox_Segment3D_Struct & segment )
+{
+   for ( size_t k = 0; k < list.size(); k++ )
+   {
+      if ( same_point ( list[k].points[0], segment.points[0] ) && same_point ( list[k].points[1], segment.points[1] ) ) return true;
+   }
+   return false;
+}
+
+// Segments of the faces B (hidden), C (out of the image) and of the lines G and H (out of the image)
+static bool is_culled ( const Rox_Segment3D_Struct & segment )
+{
+   const Rox_Point3D_Double_Struct & p = segment.points[0];
+   const bool hidden = p.Z == 10.0 && fabs ( p.X ) <= 0.5;
+   const bool outside = p.X >= 20.0 || p.X <= -29.0 || ( p.Z == 5.0 && p.X >= 3.21 );
+   return hidden || outside;
+}
+
+static Rox_ErrorCode estimate_all ( Rox_CaoFile_Edges caofile, Rox_MatSE3 pose )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   error = rox_caofile_edges_estimate_segments ( caofile, pose, FU, FV, CU, CV, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_caofile_edges_estimate_visible_ellipses ( caofile, pose, FU, FV, CU, CV, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_caofile_edges_estimate_visible_cylinders ( caofile, pose, FU, FV, CU, CV, 0 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   return error;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_caofile_edges_visibility )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_CaoFile_Edges brute = NULL, culled = NULL;
+   Rox_MatSE3 pose = NULL;
+   Rox_Ellipse3D * ellipses = NULL;
+   Rox_Cylinder3D * cylinders = NULL;
+   Rox_Uint nb_brute = 0, nb_culled = 0;
+   Rox_Double ** T = NULL;
+
+   error = rox_matse3_new ( &pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_array2d_double_get_data_pointer_to_pointer ( &T, pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Without image size, every front face is kept as before the hierarchy
+   error = rox_caofile_edges_new ( &brute );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_caofile_edges_load_cao_from_string ( brute, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_caofile_edges_new ( &culled );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_caofile_edges_load_cao_from_string ( culled, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_caofile_edges_set_image_size ( culled, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = estimate_all ( brute, pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = estimate_all ( culled, pose );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Faces: the back face E is removed by both, the culled set is the brute force one without B, C, G and H
+   std::vector<Rox_Segment3D_Struct> brute_segments = get_contours ( brute );
+   std::vector<Rox_Segment3D_Struct> culled_segments = get_contours ( culled );
+
+   ROX_TEST_CHECK_EQUAL ( brute_segments.size(), (size_t) 19 );
+   ROX_TEST_CHECK_EQUAL ( culled_segments.size(), (size_t) 9 );
+
+   for ( size_t k = 0; k < culled_segments.size(); k++ )
+   {
+      ROX_TEST_CHECK ( contains ( brute_segments, culled_segments[k] ) );
+   }
+
+   for ( size_t k = 0; k < brute_segments.size(); k++ )
+   {
+      ROX_TEST_CHECK_EQUAL ( contains ( culled_segments, brute_segments[k] ), !is_culled ( brute_segments[k] ) );
+   }
+
+   // Ellipses and cylinders: only the ones in the image are kept
+   error = rox_caofile_edges_get_visible_ellipses ( &ellipses, &nb_brute, brute );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( nb_brute, 2u );
+
+   error = rox_caofile_edges_get_visible_ellipses ( &ellipses, &nb_culled, culled );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( nb_culled, 1u );
+
+   Rox_Double ** Te = NULL;
+   rox_array2d_double_get_data_pointer_to_pointer ( &Te, ellipses[0]->Te );
+   ROX_TEST_CHECK_CLOSE ( Te[0][3], 0.0, 1e-12 );
+   ROX_TEST_CHECK_CLOSE ( Te[1][3], -1.6, 1e-12 );
+
+   error = rox_caofile_edges_get_visible_cylinders ( &cylinders, &nb_brute, brute );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( nb_brute, 2u );
+
+   error = rox_caofile_edges_get_visible_cylinders ( &cylinders, &nb_culled, culled );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( nb_culled, 1u );
+
+   Rox_Double ** Tc = NULL;
+   rox_array2d_double_get_data_pointer_to_pointer ( &Tc, cylinders[0]->T );
+   ROX_TEST_CHECK_CLOSE ( Tc[0][3], 2.25, 1e-12 );
+   ROX_TEST_CHECK_CLOSE ( Tc[1][3], 2.0, 1e-12 );
+
+   // A small move to the left brings H in the image, the previous result is kept below the coherence thresholds
+   error = rox_caofile_edges_set_visibility_coherence ( culled, 0.5, 0.1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   T[0][3] = -0.2;
+
+   error = rox_caofile_edges_estimate_segments ( culled, pose, FU, FV, CU, CV, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   std::vector<Rox_Segment3D_Struct> reused_segments = get_contours ( culled );
+   ROX_TEST_CHECK_EQUAL ( reused_segments.size(), culled_segments.size() );
+
+   for ( size_t k = 0; k < reused_segments.size(); k++ )
+   {
+      ROX_TEST_CHECK ( contains ( culled_segments, reused_segments[k] ) );
+   }
+
+   // Without reuse the same pose is tested again and H is seen
+   error = rox_caofile_edges_set_visibility_coherence ( culled, 0.0, 0.0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_caofile_edges_estimate_segments ( culled, pose, FU, FV, CU, CV, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   std::vector<Rox_Segment3D_Struct> moved_segments = get_contours ( culled );
+   ROX_TEST_CHECK_EQUAL ( moved_segments.size(), (size_t) 10 );
+
+   for ( size_t k = 0; k < culled_segments.size(); k++ )
+   {
+      ROX_TEST_CHECK ( contains ( moved_segments, culled_segments[k] ) );
+   }
+
+   rox_caofile_edges_del ( &brute );
+   rox_caofile_edges_del ( &culled );
+   rox_matse3_del ( &pose );
+}
+
+ROX_TEST_SUITE_END ( )
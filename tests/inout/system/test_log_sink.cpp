@@ -0,0 +1,246 @@
+//==============================================================================
+//
+//    OPENROX   : File test_log_sink.cpp
+//
+//    Contents  : Tests for log_sink.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//====== INCLUDED HEADERS   ====================================================
+
+#include <openrox_tests.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#ifdef ROX_USES_OPENMP
+   #include <omp.h>
+#endif
+
+extern "C"
+{
+   #include <inout/system/print.h>
+   #include <inout/system/log_sink.h>
+}
+
+// ====== INTERNAL MACROS    ===================================================
+
+ROX_TEST_SUITE_BEGIN(log_sink)
+
+// ====== INTERNAL TYPESDEFS ===================================================
+
+// ====== INTERNAL DATATYPES ===================================================
+
+// ====== INTERNAL VARIABLES ===================================================
+
+static std::vector<std::string> messages;
+
+// ====== INTERNAL FUNCTDEFS ===================================================
+
+// ====== INTERNAL FUNCTIONS ===================================================
+
+static void collect ( const char * message )
+{
+   #pragma omp critical (test_log_sink)
+   messages.push_back ( message );
+}
+
+// A single call site for all the calls, as in a loop
+static void log_repeated ( Rox_Sint k )
+{
+   ROX_LOG_WARNING ( "repeated %d\n", k );
+}
+
+static Rox_Sint thread_number ( )
+{
+#ifdef ROX_USES_OPENMP
+   return omp_get_thread_num ( );
+#else
+   return 0;
+#endif
+}
+
+// ====== EXPORTED FUNCTIONS ===================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_log_sink_immediate )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+
+   messages.clear ( );
+   rox_log_set_callback ( collect );
+
+   // Without a started sink the messages are written immediately
+   ROX_LOG_INFO ( "value %d, %5.2f, %s, %c, %lu, %%\n", -3, 1.5, "text", 'x', 7ul );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 1u );
+   ROX_TEST_CHECK_EQUAL ( messages[0] == "value -3,  1.50, text, x, 7, %\n", true );
+
+   rox_log ( "legacy %d %s\n", 12, "call" );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 2u );
+   ROX_TEST_CHECK_EQUAL ( messages[1] == "legacy 12 call\n", true );
+
+   // Runtime severity filter
+   error = rox_log_set_level ( ROX_LOG_LEVEL_WARNING );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_LOG_INFO ( "discarded\n" );
+   rox_log ( "discarded\n" );
+   ROX_LOG_ERROR ( "kept\n" );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 3u );
+   ROX_TEST_CHECK_EQUAL ( messages[2] == "kept\n", true );
+
+   error = rox_log_set_level ( ROX_LOG_LEVEL_DEBUG );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Rate limiting : only the first messages of a call site are kept in a period
+   error = rox_log_set_rate_limit ( 2, 1000000 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < 5; k++ ) log_repeated ( k );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 5u );
+   ROX_TEST_CHECK_EQUAL ( messages[4] == "repeated 1\n", true );
+
+   // In the next period the first message of the call site reports the discarded ones
+   error = rox_log_set_rate_limit ( 2, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   std::this_thread::sleep_for ( std::chrono::milliseconds ( 5 ) );
+
+   log_repeated ( 5 );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 7u );
+   ROX_TEST_CHECK_EQUAL ( messages[5] == "(3 similar messages suppressed)\n", true );
+   ROX_TEST_CHECK_EQUAL ( messages[6] == "repeated 5\n", true );
+
+   error = rox_log_set_rate_limit ( 0, 1000 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_log_set_rate_limit ( -1, 1000 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   rox_log_set_callback ( NULL );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_log_sink_deferred )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Char name[16];
+   Rox_Sint dropped = -1;
+
+   messages.clear ( );
+   rox_log_set_callback ( collect );
+
+   error = rox_log_sink_start ( 0 );
+#if ( defined(ROX_IS_LINUX) || defined(ROX_IS_MACOSX) ) && defined(__GNUC__)
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_log_sink_start ( 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID );
+
+   // The string arguments are copied when the message is recorded
+   strcpy ( name, "first" );
+   ROX_LOG_INFO ( "frame %d of %s, score %.3f, size %zu\n", 4, name, 0.25, (size_t) 640 );
+   strcpy ( name, "second" );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 0u );
+
+   error = rox_log_flush ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 1u );
+   ROX_TEST_CHECK_EQUAL ( messages[0] == "frame 4 of first, score 0.250, size 640\n", true );
+
+   // The messages of rox_log are formatted when recorded, the format itself may not outlive the call
+   messages.clear ( );
+   Rox_Char format[32];
+   strcpy ( format, "legacy %d %s\n" );
+   rox_log ( format, 12, name );
+   strcpy ( format, "changed\n" );
+   strcpy ( name, "third" );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 0u );
+
+   // A message longer than an event is written immediately
+   std::string longer ( 300, 'x' );
+   rox_log ( "%s\n", longer.c_str ( ) );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 1u );
+   ROX_TEST_CHECK_EQUAL ( messages[0] == longer + "\n", true );
+
+   error = rox_log_flush ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 2u );
+   ROX_TEST_CHECK_EQUAL ( messages[1] == "legacy 12 second\n", true );
+
+   // The messages of each thread are kept in order
+   messages.clear ( );
+
+#ifdef ROX_USES_OPENMP
+   #pragma omp parallel for schedule(static)
+#endif
+   for ( Rox_Sint k = 0; k < 100; k++ )
+   {
+      ROX_LOG_DEBUG ( "event %d %d\n", thread_number ( ), k );
+   }
+
+   error = rox_log_sink_stop ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 100u );
+
+   // Each thread logs increasing events with the static schedule, they must be written in this order
+   std::vector<Rox_Sint> last ( 256, -1 );
+   std::vector<Rox_Sint> seen ( 100, 0 );
+   Rox_Sint ordered = 1;
+
+   for ( size_t m = 0; m < messages.size ( ); m++ )
+   {
+      Rox_Sint thread = -1, k = -1;
+      if ( sscanf ( messages[m].c_str ( ), "event %d %d", &thread, &k ) != 2 || thread < 0 || thread >= 256 || k < 0 || k >= 100 )
+      {
+         ordered = 0;
+         continue;
+      }
+
+      if ( k <= last[thread] ) ordered = 0;
+      last[thread] = k;
+      seen[k]++;
+   }
+
+   ROX_TEST_CHECK_EQUAL ( ordered, 1 );
+   for ( Rox_Sint k = 0; k < 100; k++ ) ROX_TEST_CHECK_EQUAL ( seen[k], 1 );
+
+   error = rox_log_get_dropped ( &dropped );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( dropped, 0 );
+
+   // Once stopped the messages are written immediately again
+   messages.clear ( );
+   ROX_LOG_INFO ( "after %s\n", "stop" );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 1u );
+
+   // Background thread
+   messages.clear ( );
+   error = rox_log_sink_start ( 5 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < 10; k++ ) ROX_LOG_INFO ( "background %d\n", k );
+
+   error = rox_log_sink_stop ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( messages.size ( ), 10u );
+   ROX_TEST_CHECK_EQUAL ( messages[9] == "background 9\n", true );
+#else
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NOT_IMPLEMENTED );
+#endif
+
+   error = rox_log_get_dropped ( NULL );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_log_set_callback ( NULL );
+}
+
+ROX_TEST_SUITE_END()
@@ -0,0 +1,337 @@
+//==============================================================================
+//
+//    OPENROX   : File test_frame_source.cpp
+//
+//    Contents  : Tests for frame_source.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//====== INCLUDED HEADERS   ====================================================
+
+#include <openrox_tests.hpp>
+
+#include <stdio.h>
+
+extern "C"
+{
+   #include <inout/video/frame_source.h>
+   #include <inout/image/pgm/pgmfile.h>
+   #include <inout/system/print.h>
+}
+
+// ====== INTERNAL MACROS    ===================================================
+
+ROX_TEST_SUITE_BEGIN(frame_source)
+
+#define PGM_PATTERN "test_frame_source_%03d.pgm"
+#define RAW_PATTERN "test_frame_source_%03d.raw"
+#define NB_FRAMES 6
+#define COLS 37
+#define ROWS 23
+
+// ====== INTERNAL TYPESDEFS ===================================================
+
+// ====== INTERNAL DATATYPES ===================================================
+
+// ====== INTERNAL VARIABLES ===================================================
+
+// ====== INTERNAL FUNCTDEFS ===================================================
+
+// ====== INTERNAL FUNCTIONS ===================================================
+
+static Rox_Uchar pixel_value ( Rox_Sint index, Rox_Sint i, Rox_Sint j )
+{
+   return (Rox_Uchar) ( 17 * index + 3 * i + j );
+}
+
+static Rox_ErrorCode write_pgm_sequence ( )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Char path[FILENAME_MAX];
+   Rox_Image image = NULL;
+   Rox_Uchar ** data = NULL;
+
+   error = rox_image_new ( &image, COLS, ROWS );
+   if ( error ) return error;
+
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint index = 0; index < NB_FRAMES; index++ )
+   {
+      for ( Rox_Sint i = 0; i < ROWS; i++ )
+         for ( Rox_Sint j = 0; j < COLS; j++ )
+            data[i][j] = pixel_value ( index, i, j );
+
+      sprintf ( path, PGM_PATTERN, index );
+      error = rox_array2d_uchar_save_pgm ( path, image );
+      if ( error ) break;
+   }
+
+   rox_image_del ( &image );
+   return error;
+}
+
+static Rox_Sint check_frame ( Rox_Image image, Rox_Sint index )
+{
+   Rox_Uchar ** data = NULL;
+   Rox_Sint wrong = 0;
+
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+         if ( data[i][j] != pixel_value ( index, i, j ) ) wrong++;
+
+   return wrong;
+}
+
+// ====== EXPORTED FUNCTIONS ===================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_frame_source_pgm_sequence )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source source = NULL;
+   Rox_Image image = NULL;
+   Rox_Sint rows = 0, cols = 0, index = -1;
+
+   error = write_pgm_sequence ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_new_pgm ( &source, PGM_PATTERN, 1, -1, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_frame_source_new_pgm ( &source, "test_frame_source_missing_%03d.pgm", 0, -1, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_FILE_NOT_FOUND );
+
+   // Unbounded sequence starting at the second file
+   error = rox_frame_source_new_pgm ( &source, PGM_PATTERN, 1, -1, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_get_size ( &rows, &cols, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( rows, ROWS );
+   ROX_TEST_CHECK_EQUAL ( cols, COLS );
+
+   for ( Rox_Sint k = 1; k < NB_FRAMES; k++ )
+   {
+      error = rox_frame_source_acquire ( &image, &index, source );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( index, k );
+      ROX_TEST_CHECK_EQUAL ( check_frame ( image, k ), 0 );
+
+      error = rox_frame_source_release ( source, image );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      // An image is released only once
+      error = rox_frame_source_release ( source, image );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+   }
+
+   // The sequence ends on the first missing file
+   error = rox_frame_source_acquire ( &image, &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_EMPTY_BUFFER );
+
+   error = rox_frame_source_del ( &source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_frame_source_pool )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source source = NULL;
+   Rox_Image image[3] = { NULL, NULL, NULL };
+   Rox_Sint index = -1;
+
+   error = write_pgm_sequence ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Bounded sequence with two images in the pool
+   error = rox_frame_source_new_pgm ( &source, PGM_PATTERN, 0, 3, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_acquire ( &image[0], &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index, 0 );
+
+   error = rox_frame_source_acquire ( &image[1], &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index, 1 );
+   ROX_TEST_CHECK_EQUAL ( image[0] != image[1], 1 );
+
+   // All the images are owned by the caller
+   error = rox_frame_source_acquire ( &image[2], &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_FULL_BUFFER );
+
+   // Released images are recycled
+   error = rox_frame_source_release ( source, image[0] );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_acquire ( &image[2], &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index, 2 );
+   ROX_TEST_CHECK_EQUAL ( image[2] == image[0], 1 );
+   ROX_TEST_CHECK_EQUAL ( check_frame ( image[1], 1 ), 0 );
+   ROX_TEST_CHECK_EQUAL ( check_frame ( image[2], 2 ), 0 );
+
+   error = rox_frame_source_release ( source, image[1] );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_release ( source, image[2] );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_acquire ( &image[0], &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( index, 3 );
+   ROX_TEST_CHECK_EQUAL ( check_frame ( image[0], 3 ), 0 );
+
+   error = rox_frame_source_release ( source, image[0] );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The last file is reached
+   error = rox_frame_source_acquire ( &image[0], &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_EMPTY_BUFFER );
+
+   error = rox_frame_source_del ( &source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Deleting a source with pending frames stops the decoding
+   error = rox_frame_source_new_pgm ( &source, PGM_PATTERN, 0, -1, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_del ( &source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_frame_source_release_not_acquired )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source source = NULL;
+   Rox_Image image[3] = { NULL, NULL, NULL };
+   Rox_Image current = NULL;
+   Rox_Sint index = -1;
+
+   error = write_pgm_sequence ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_frame_source_new_pgm ( &source, PGM_PATTERN, 0, NB_FRAMES - 1, 3 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Get all the images of the pool
+   for ( Rox_Sint k = 0; k < 3; k++ )
+   {
+      error = rox_frame_source_acquire ( &image[k], &index, source );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( index, k );
+   }
+
+   for ( Rox_Sint k = 0; k < 3; k++ )
+   {
+      error = rox_frame_source_release ( source, image[k] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   for ( Rox_Sint k = 3; k < NB_FRAMES; k++ )
+   {
+      error = rox_frame_source_acquire ( &current, &index, source );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( index, k );
+
+      // The other images are free, decoded or being decoded, whatever the progress of the decoding
+      for ( Rox_Sint l = 0; l < 3; l++ )
+      {
+         if ( image[l] == current ) continue;
+
+         error = rox_frame_source_release ( source, image[l] );
+         ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+      }
+
+      ROX_TEST_CHECK_EQUAL ( check_frame ( current, k ), 0 );
+
+      error = rox_frame_source_release ( source, current );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_frame_source_acquire ( &current, &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_EMPTY_BUFFER );
+
+   error = rox_frame_source_del ( &source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_frame_source_raw_bgra )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Frame_Source source = NULL;
+   Rox_Image image = NULL, expected = NULL;
+   Rox_Char path[FILENAME_MAX];
+   Rox_Sint index = -1;
+
+   // BGRA buffers with some padding at the end of the rows
+   const Rox_Sint stride = 4 * COLS + 12;
+   Rox_Uchar buffer[ROWS * ( 4 * COLS + 12 )];
+
+   error = rox_image_new ( &expected, COLS, ROWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < 2; k++ )
+   {
+      for ( Rox_Sint i = 0; i < ROWS * stride; i++ )
+      {
+         buffer[i] = (Rox_Uchar) ( 31 * k + 7 * i );
+      }
+
+      sprintf ( path, RAW_PATTERN, k );
+      FILE * file = fopen ( path, "wb" );
+      ROX_TEST_CHECK_EQUAL ( file != NULL, 1 );
+      fwrite ( buffer, 1, ROWS * stride, file );
+      fclose ( file );
+   }
+
+   error = rox_frame_source_new_raw ( &source, RAW_PATTERN, 0, 1, COLS, ROWS, stride, Rox_Image_Format_BGRA, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < 2; k++ )
+   {
+      for ( Rox_Sint i = 0; i < ROWS * stride; i++ )
+      {
+         buffer[i] = (Rox_Uchar) ( 31 * k + 7 * i );
+      }
+
+      error = rox_image_set_data ( expected, buffer, stride, Rox_Image_Format_BGRA );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      error = rox_frame_source_acquire ( &image, &index, source );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      ROX_TEST_CHECK_EQUAL ( index, k );
+
+      Rox_Uchar ** data = NULL, ** data_expected = NULL;
+      rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+      rox_array2d_uchar_get_data_pointer_to_pointer ( &data_expected, expected );
+
+      Rox_Sint wrong = 0;
+      for ( Rox_Sint i = 0; i < ROWS; i++ )
+         for ( Rox_Sint j = 0; j < COLS; j++ )
+            if ( data[i][j] != data_expected[i][j] ) wrong++;
+
+      ROX_TEST_CHECK_EQUAL ( wrong, 0 );
+
+      error = rox_frame_source_release ( source, image );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_frame_source_acquire ( &image, &index, source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_EMPTY_BUFFER );
+
+   error = rox_frame_source_del ( &source );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_image_del ( &expected );
+}
+
+ROX_TEST_SUITE_END()
@@ -0,0 +1,258 @@
+//==============================================================================
+//
+//    OPENROX   : File test_arena.cpp
+//
+//    Contents  : Tests for arena.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+extern "C"
+{
+   #include <string.h>
+   #include <system/memory/memory.h>
+   #include <system/memory/arena.h>
+   #include <generated/array2d_double.h>
+   #include <generated/dynvec_uint.h>
+   #include <generated/dynvec_uint_struct.h>
+   #include <baseproc/geometry/pixelgrid/meshgrid2d.h>
+   #include <inout/system/arena_print.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( arena )
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// The temporaries of one iteration of a tracker
+static Rox_ErrorCode frame ( Rox_DynVec_Uint persistent, Rox_Uint id )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Array2D_Double JtJ = NULL, Jte = NULL, weights = NULL;
+   Rox_MeshGrid2D_Float grid = NULL;
+   Rox_DynVec_Uint indices = NULL;
+
+   error = rox_arena_scope_begin ( "frame" );
+   if ( error ) return error;
+
+   error = rox_array2d_double_new ( &JtJ, 6, 6 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_new ( &Jte, 6, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_array2d_double_new ( &weights, 500, 1 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_meshgrid2d_float_new ( &grid, 48, 64 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   error = rox_dynvec_uint_new ( &indices, 4 );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+   // The temporary vector grows in the arena, the persistent one stays on the heap
+   for ( Rox_Uint k = 0; k < 100; k++ )
+   {
+      error = rox_dynvec_uint_append ( indices, &k );
+      ROX_ERROR_CHECK_TERMINATE ( error );
+   }
+
+   error = rox_dynvec_uint_append ( persistent, &id );
+   ROX_ERROR_CHECK_TERMINATE ( error );
+
+function_terminate:
+   rox_dynvec_uint_del ( &indices );
+   rox_meshgrid2d_float_del ( &grid );
+   rox_array2d_double_del ( &weights );
+   rox_array2d_double_del ( &Jte );
+   rox_array2d_double_del ( &JtJ );
+   rox_arena_scope_end ( );
+   return error;
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_arena_mark_release )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Arena arena = NULL;
+   Rox_Arena_Mark_Struct mark;
+   void * a = NULL, * b = NULL, * c = NULL;
+   Rox_Size used = 0, peak = 0, capacity = 0, used_mark = 0;
+   Rox_Uint heap = 0;
+
+   error = rox_arena_new ( &arena, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_arena_new ( &arena, 256 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_arena_allocate ( &a, arena, 40 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( ( (Rox_Size) a ) % 16, 0u );
+
+   error = rox_arena_mark ( &mark, arena );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_arena_get_usage ( &used_mark, &peak, &capacity, arena );
+
+   // The second allocation does not fit in the first block
+   error = rox_arena_allocate ( &b, arena, 100 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_arena_allocate ( &c, arena, 1000 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( ( (Rox_Size) c ) % 16, 0u );
+   memset ( c, 0xAB, 1000 );
+
+   rox_arena_get_heap_allocations ( &heap, arena );
+   ROX_TEST_CHECK_EQUAL ( heap, 2u );
+
+   error = rox_arena_release ( arena, &mark );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_arena_get_usage ( &used, &peak, &capacity, arena );
+   ROX_TEST_CHECK_EQUAL ( used, used_mark );
+   ROX_TEST_CHECK_EQUAL ( peak >= 1100, 1 );
+
+   // The released memory is reused without new blocks
+   for ( Rox_Uint k = 0; k < 10; k++ )
+   {
+      rox_arena_mark ( &mark, arena );
+      rox_arena_allocate ( &b, arena, 100 );
+      rox_arena_allocate ( &c, arena, 1000 );
+      rox_arena_release ( arena, &mark );
+   }
+
+   rox_arena_get_heap_allocations ( &heap, arena );
+   ROX_TEST_CHECK_EQUAL ( heap, 2u );
+
+   error = rox_arena_del ( &arena );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_arena_scope )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Arena arena = NULL;
+   Rox_DynVec_Uint persistent = NULL;
+   Rox_Uint heap = 0, heap_warm = 0, count = 0, scopes = 0;
+   Rox_Size used = 0, used_start = 0, peak = 0, capacity = 0, pipeline_peak = 0;
+   const char * name = NULL;
+
+   error = rox_arena_scope_end ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID );
+
+   error = rox_dynvec_uint_new ( &persistent, 2 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_arena_get_thread ( &arena );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_arena_get_usage ( &used_start, &peak, &capacity, arena );
+
+   // Warm up
+   error = frame ( persistent, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_arena_get_heap_allocations ( &heap_warm, arena );
+
+   // Steady state
+   for ( Rox_Uint id = 1; id < 50; id++ )
+   {
+      error = frame ( persistent, id );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   rox_arena_get_heap_allocations ( &heap, arena );
+   ROX_TEST_CHECK_EQUAL ( heap, heap_warm );
+
+   rox_arena_get_usage ( &used, &peak, &capacity, arena );
+   ROX_TEST_CHECK_EQUAL ( used, used_start );
+
+   // The persistent vector created outside the scope has kept its content
+   ROX_TEST_CHECK_EQUAL ( persistent->used, 50u );
+   ROX_TEST_CHECK_EQUAL ( rox_arena_thread_owns ( persistent->data ), 0 );
+   for ( Rox_Uint id = 0; id < 50; id++ ) ROX_TEST_CHECK_EQUAL ( persistent->data[id], id );
+
+   rox_arena_get_pipelines_count ( &count, arena );
+   ROX_TEST_CHECK_EQUAL ( count, 1u );
+
+   error = rox_arena_get_pipeline ( &name, &pipeline_peak, &scopes, arena, 0 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( strcmp ( name, "frame" ), 0 );
+   ROX_TEST_CHECK_EQUAL ( scopes, 50u );
+   ROX_TEST_CHECK_EQUAL ( pipeline_peak > 500 * sizeof(Rox_Double) + 2 * 48 * 64 * sizeof(Rox_Float), 1 );
+
+   error = rox_arena_print ( arena );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_dynvec_uint_del ( &persistent );
+
+   error = rox_arena_thread_del ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_arena_scope_delete )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Arena arena = NULL;
+   Rox_Size used = 0, used_start = 0, peak = 0, capacity = 0;
+
+   error = rox_arena_scope_begin ( "delete" );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_arena_get_thread ( &arena );
+   rox_arena_get_usage ( &used_start, &peak, &capacity, arena );
+
+   Rox_Uchar * a = (Rox_Uchar *) rox_memory_allocate ( 1, 100 );
+   Rox_Uchar * b = (Rox_Uchar *) rox_memory_allocate ( 1, 100 );
+   ROX_TEST_CHECK_EQUAL ( rox_arena_thread_owns ( a ), 1 );
+   memset ( b, 7, 100 );
+
+   // The last allocation grows in place
+   Rox_Uchar * c = (Rox_Uchar *) rox_memory_reallocate ( b, 1, 200 );
+   ROX_TEST_CHECK_EQUAL ( c == b, 1 );
+   ROX_TEST_CHECK_EQUAL ( c[99], 7 );
+
+   // The other ones are moved
+   Rox_Uchar * d = (Rox_Uchar *) rox_memory_reallocate ( a, 1, 300 );
+   ROX_TEST_CHECK_EQUAL ( d != a, 1 );
+
+   // Deletes in any order give all the memory back
+   rox_memory_delete ( c );
+   rox_memory_delete ( d );
+
+   rox_arena_get_usage ( &used, &peak, &capacity, arena );
+   ROX_TEST_CHECK_EQUAL ( used, used_start );
+
+   error = rox_arena_thread_del ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID );
+
+   error = rox_arena_scope_end ( );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Outside of the scopes the heap is used again
+   Rox_Uchar * e = (Rox_Uchar *) rox_memory_allocate ( 1, 100 );
+   ROX_TEST_CHECK_EQUAL ( rox_arena_thread_owns ( e ), 0 );
+   rox_memory_delete ( e );
+
+   rox_arena_thread_del ( );
+}
+
+ROX_TEST_SUITE_END ( )
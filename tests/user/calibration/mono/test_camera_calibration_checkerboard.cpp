@@ -0,0 +1,313 @@
+//==============================================================================
+//
+//    OPENROX   : File test_camera_calibration_checkerboard.cpp
+//
+//    Contents  : Tests for camera_calibration_checkerboard.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <math.h>
+#include <string.h>
+
+extern "C"
+{
+   #include <baseproc/maths/maths_macros.h>
+   #include <baseproc/maths/linalg/matut3.h>
+   #include <core/model/model_checkerboard.h>
+   #include <user/calibration/mono/camera_calibration_checkerboard.h>
+   #include <inout/system/errors_print.h>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( camera_calibration_checkerboard )
+
+#define COLS   640
+#define ROWS   480
+#define FU     800.0
+#define FV     780.0
+#define CU     322.0
+#define CV     236.0
+
+#define GRID_WIDTH  8
+#define GRID_HEIGHT 6
+#define GRID_SIZE   0.03
+
+#define NB_VIEWS    6
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+// Rotations around the x and y axes in radians, the grid is seen from about 0.5 m
+static const Rox_Double view_angles[NB_VIEWS][2] =
+{
+   {  0.35,  0.00 }, { -0.35,  0.10 }, {  0.00,  0.40 },
+   {  0.10, -0.40 }, {  0.30,  0.30 }, { -0.25, -0.30 }
+};
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Homography from the grid plane (meters) to the image (pixels) of a view
+static void view_homography ( Rox_Double H[3][3], const Rox_Sint view )
+{
+   const Rox_Double a = view_angles[view][0], b = view_angles[view][1];
+   const Rox_Double cx = 0.5 * ( GRID_WIDTH - 1 ) * GRID_SIZE, cy = 0.5 * ( GRID_HEIGHT - 1 ) * GRID_SIZE;
+
+   // R = Rx(a) * Ry(b), the center of the grid is on the optical axis at 0.5 m
+   const Rox_Double R[3][3] =
+   {
+      { cos(b), 0.0, sin(b) },
+      { sin(a) * sin(b), cos(a), -sin(a) * cos(b) },
+      { -cos(a) * sin(b), sin(a), cos(a) * cos(b) }
+   };
+   Rox_Double t[3];
+   for ( Rox_Sint k = 0; k < 3; k++ ) t[k] = - R[k][0] * cx - R[k][1] * cy;
+   t[2] += 0.5;
+
+   const Rox_Double K[3][3] = { { FU, 0.0, CU }, { 0.0, FV, CV }, { 0.0, 0.0, 1.0 } };
+   const Rox_Double M[3][3] = { { R[0][0], R[0][1], t[0] }, { R[1][0], R[1][1], t[1] }, { R[2][0], R[2][1], t[2] } };
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         H[i][j] = K[i][0] * M[0][j] + K[i][1] * M[1][j] + K[i][2] * M[2][j];
+      }
+   }
+}
+
+// Inverse of a 3x3 matrix (up to scale)
+static void inverse3x3 ( Rox_Double Hi[3][3], Rox_Double H[3][3] )
+{
+   Hi[0][0] = H[1][1] * H[2][2] - H[1][2] * H[2][1];
+   Hi[0][1] = H[0][2] * H[2][1] - H[0][1] * H[2][2];
+   Hi[0][2] = H[0][1] * H[1][2] - H[0][2] * H[1][1];
+   Hi[1][0] = H[1][2] * H[2][0] - H[1][0] * H[2][2];
+   Hi[1][1] = H[0][0] * H[2][2] - H[0][2] * H[2][0];
+   Hi[1][2] = H[0][2] * H[1][0] - H[0][0] * H[1][2];
+   Hi[2][0] = H[1][0] * H[2][1] - H[1][1] * H[2][0];
+   Hi[2][1] = H[0][1] * H[2][0] - H[0][0] * H[2][1];
+   Hi[2][2] = H[0][0] * H[1][1] - H[0][1] * H[1][0];
+}
+
+// Render the checkerboard of a view on a white background, with 4x4 samples per pixel
+static void render_view ( Rox_Image image, const Rox_Sint view )
+{
+   Rox_Double H[3][3], Hi[3][3];
+   Rox_Uchar ** data = NULL;
+
+   view_homography ( H, view );
+   inverse3x3 ( Hi, H );
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         Rox_Sint sum = 0;
+         for ( Rox_Sint si = 0; si < 4; si++ )
+         {
+            for ( Rox_Sint sj = 0; sj < 4; sj++ )
+            {
+               const Rox_Double u = j + ( sj + 0.5 ) / 4.0, v = i + ( si + 0.5 ) / 4.0;
+               const Rox_Double w = Hi[2][0] * u + Hi[2][1] * v + Hi[2][2];
+               const Rox_Double X = ( Hi[0][0] * u + Hi[0][1] * v + Hi[0][2] ) / w / GRID_SIZE;
+               const Rox_Double Y = ( Hi[1][0] * u + Hi[1][1] * v + Hi[1][2] ) / w / GRID_SIZE;
+
+               // The inner corners are at integer coordinates, one more square on each side
+               Rox_Sint level = 255;
+               if ( X > -1.0 && Y > -1.0 && X < GRID_WIDTH && Y < GRID_HEIGHT )
+               {
+                  const Rox_Sint x = (Rox_Sint) floor ( X ), y = (Rox_Sint) floor ( Y );
+                  level = ( ( x + y ) & 1 ) ? 255 : 0;
+
+                  // The circles coding the first corner flip the center of two of its squares
+                  const Rox_Double dx = X - x - 0.5, dy = Y - y - 0.5;
+                  if ( x == y && x < 2 && dx * dx + dy * dy < 0.09 ) level = 255 - level;
+               }
+               sum += level;
+            }
+         }
+         data[i][j] = (Rox_Uchar) ( ( sum + 8 ) / 16 );
+      }
+   }
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_camera_calibration_checkerboard_add_images )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Model_CheckerBoard model = NULL;
+   Rox_Camera_Calibration_Checkerboard sequential = NULL, batched = NULL;
+   Rox_MatUT3 K_sequential = NULL, K_batched = NULL;
+   Rox_Image images[NB_VIEWS] = { NULL };
+   Rox_Double ** ds = NULL, ** db = NULL;
+
+   error = rox_model_checkerboard_new ( &model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_model_checkerboard_set_template ( model, GRID_WIDTH, GRID_HEIGHT, GRID_SIZE, GRID_SIZE );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_new ( &sequential, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_new ( &batched, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The calibration objects keep their own copy of the model
+   error = rox_model_checkerboard_del ( &model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   for ( Rox_Sint k = 0; k < NB_VIEWS; k++ )
+   {
+      error = rox_image_new ( &images[k], COLS, ROWS );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+      render_view ( images[k], k );
+
+      error = rox_camera_calibration_checkerboard_add_image ( sequential, images[k] );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_camera_calibration_checkerboard_add_images ( batched, images, NB_VIEWS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The same views in the same order give the same intrinsics after the Schur reduced refinement
+   error = rox_camera_calibration_checkerboard_make ( sequential, 5 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_make ( batched, 5 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matut3_new ( &K_sequential );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matut3_new ( &K_batched );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_get_intrinsics ( K_sequential, sequential );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_get_intrinsics ( K_batched, batched );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_double_get_data_pointer_to_pointer ( &ds, K_sequential );
+   rox_array2d_double_get_data_pointer_to_pointer ( &db, K_batched );
+
+   for ( Rox_Sint i = 0; i < 3; i++ )
+   {
+      for ( Rox_Sint j = 0; j < 3; j++ )
+      {
+         ROX_TEST_CHECK_EQUAL ( ds[i][j], db[i][j] );
+      }
+   }
+
+   // The detected corners are close to the rendered ones
+   ROX_TEST_CHECK_CLOSE ( db[0][0], FU, 2.0 );
+   ROX_TEST_CHECK_CLOSE ( db[1][1], FV, 2.0 );
+   ROX_TEST_CHECK_CLOSE ( db[0][2], CU, 2.0 );
+   ROX_TEST_CHECK_CLOSE ( db[1][2], CV, 2.0 );
+
+   for ( Rox_Sint k = 0; k < NB_VIEWS; k++ ) rox_image_del ( &images[k] );
+   rox_matut3_del ( &K_sequential );
+   rox_matut3_del ( &K_batched );
+   rox_camera_calibration_checkerboard_del ( &sequential );
+   rox_camera_calibration_checkerboard_del ( &batched );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_camera_calibration_checkerboard_add_points )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Model_CheckerBoard model = NULL;
+   Rox_Camera_Calibration_Checkerboard calibration = NULL;
+   Rox_MatUT3 K = NULL;
+   Rox_Point2D_Double_Struct points[GRID_WIDTH * GRID_HEIGHT];
+   Rox_Double ** dk = NULL;
+
+   error = rox_model_checkerboard_new ( &model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_model_checkerboard_set_template ( model, GRID_WIDTH, GRID_HEIGHT, GRID_SIZE, GRID_SIZE );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_new ( &calibration, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Exact projections of the grid
+   for ( Rox_Sint k = 0; k < NB_VIEWS; k++ )
+   {
+      Rox_Double H[3][3];
+      view_homography ( H, k );
+
+      for ( Rox_Sint i = 0; i < GRID_HEIGHT; i++ )
+      {
+         for ( Rox_Sint j = 0; j < GRID_WIDTH; j++ )
+         {
+            const Rox_Double X = j * GRID_SIZE, Y = i * GRID_SIZE;
+            const Rox_Double w = H[2][0] * X + H[2][1] * Y + H[2][2];
+            points[i * GRID_WIDTH + j].u = ( H[0][0] * X + H[0][1] * Y + H[0][2] ) / w;
+            points[i * GRID_WIDTH + j].v = ( H[1][0] * X + H[1][1] * Y + H[1][2] ) / w;
+         }
+      }
+
+      error = rox_camera_calibration_checkerboard_add_points ( calibration, GRID_WIDTH * GRID_HEIGHT, points, COLS, ROWS );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   }
+
+   error = rox_camera_calibration_checkerboard_make ( calibration, 5 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_matut3_new ( &K );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_camera_calibration_checkerboard_get_intrinsics ( K, calibration );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_double_get_data_pointer_to_pointer ( &dk, K );
+
+   ROX_TEST_CHECK_CLOSE ( dk[0][0], FU, 1e-6 );
+   ROX_TEST_CHECK_CLOSE ( dk[1][1], FV, 1e-6 );
+   ROX_TEST_CHECK_CLOSE ( dk[0][2], CU, 1e-6 );
+   ROX_TEST_CHECK_CLOSE ( dk[1][2], CV, 1e-6 );
+   ROX_TEST_CHECK_SMALL ( dk[0][1], 1e-6 );
+
+   // The Schur reduced refinement recovers the intrinsics from a wrong guess
+   dk[0][0] = 0.97 * FU; dk[1][1] = 1.02 * FV; dk[0][2] = CU + 6.0; dk[1][2] = CV - 4.0; dk[0][1] = 0.0;
+
+   error = rox_calibration_mono_perspective_set_intrinsics ( calibration->calib, K );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_calibration_mono_perspective_process_nolinear ( calibration->calib, 4 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_calibration_mono_perspective_get_intrinsics ( K, calibration->calib );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_TEST_CHECK_CLOSE ( dk[0][0], FU, 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dk[1][1], FV, 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dk[0][2], CU, 1e-4 );
+   ROX_TEST_CHECK_CLOSE ( dk[1][2], CV, 1e-4 );
+
+   rox_matut3_del ( &K );
+   rox_model_checkerboard_del ( &model );
+   rox_camera_calibration_checkerboard_del ( &calibration );
+}
+
+ROX_TEST_SUITE_END ( )
@@ -0,0 +1,447 @@
+//==============================================================================
+//
+//    OPENROX   : File test_motion_detection.cpp
+//
+//    Contents  : Tests for motion_detection.c
+//
+//    Author(s) : R&D department directed by Ezio MALIS
+//
+//    Copyright : 2022 Robocortex S.A.S.
+//
+//    License   : LGPL v3 or commercial license
+//
+//==============================================================================
+
+//=== INCLUDED HEADERS   =======================================================
+
+#include <openrox_tests.hpp>
+
+#include <string.h>
+#include <vector>
+
+extern "C"
+{
+   #include <user/detection/motion/motion_detection.h>
+   #include <generated/dynvec_rect_sint_struct.h>
+   #include <baseproc/array/fill/fillval.h>
+   #include <user/detection/motion/ansi_motion_detection.h>
+   #include <user/detection/motion/cluster.h>
+   #include <baseproc/geometry/connectivity/connected_components.h>
+}
+
+// The scalar row kernels, compared with the ones of the library (SSE when enabled)
+namespace ansi
+{
+   #include <user/detection/motion/ansi_motion_detection.c>
+}
+
+//=== INTERNAL MACROS    =======================================================
+
+ROX_TEST_SUITE_BEGIN ( motion_detection )
+
+#define ROWS 240
+#define COLS 320
+
+//=== INTERNAL TYPESDEFS =======================================================
+
+//=== INTERNAL DATATYPES =======================================================
+
+//=== INTERNAL VARIABLES =======================================================
+
+//=== INTERNAL FUNCTDEFS =======================================================
+
+//=== INTERNAL FUNCTIONS =======================================================
+
+// Square of side size and gray level value at (u, v)
+static void draw_square ( Rox_Image image, Rox_Sint u, Rox_Sint v, Rox_Sint size, Rox_Uchar value )
+{
+   Rox_Uchar ** data = NULL;
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = v; i < v + size; i++ )
+   {
+      for ( Rox_Sint j = u; j < u + size; j++ )
+      {
+         data[i][j] = value;
+      }
+   }
+}
+
+// Pseudo random gray levels
+static Rox_Uchar random_level ( Rox_Uint * state )
+{
+   *state = *state * 1664525u + 1013904223u;
+   return (Rox_Uchar) ( *state >> 24 );
+}
+
+// Noisy image of gray levels around 100 with squares of random sizes
+static void draw_scene ( Rox_Image image, Rox_Uint seed )
+{
+   Rox_Uint state = seed;
+   Rox_Uchar ** data = NULL;
+   rox_array2d_uchar_get_data_pointer_to_pointer ( &data, image );
+
+   for ( Rox_Sint i = 0; i < ROWS; i++ )
+   {
+      for ( Rox_Sint j = 0; j < COLS; j++ )
+      {
+         data[i][j] = (Rox_Uchar) ( 90 + random_level ( &state ) % 21 );
+      }
+   }
+
+   for ( Rox_Sint k = 0; k < 12; k++ )
+   {
+      const Rox_Sint size = 4 + random_level ( &state ) % 30;
+      const Rox_Sint u = random_level ( &state ) * ( COLS - size ) / 256;
+      const Rox_Sint v = random_level ( &state ) * ( ROWS - size ) / 256;
+      draw_square ( image, u, v, size, ( k % 2 ) ? 20 : 230 );
+   }
+}
+
+//=== EXPORTED FUNCTIONS =======================================================
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_motion_detection_row_kernels )
+{
+   Rox_Uint state = 7;
+   Rox_Sint mismatches = 0;
+
+   // Lengths around the 16 pixels vectors
+   for ( Rox_Sint cols = 1; cols < 80; cols++ )
+   {
+      std::vector<Rox_Uchar> model ( cols ), image ( cols ), motion ( cols ), above ( cols ), below ( cols );
+      std::vector<Rox_Uchar> out_lib ( cols, 7 ), out_ansi ( cols, 7 ), model_lib ( cols ), model_ansi ( cols );
+      std::vector<Rox_Float> diff_lib ( cols ), diff_ansi ( cols );
+
+      for ( Rox_Sint j = 0; j < cols; j++ )
+      {
+         model[j] = random_level ( &state );
+         image[j] = random_level ( &state );
+         motion[j] = ( random_level ( &state ) < 64 ) ? 255 : 0;
+         above[j] = ( random_level ( &state ) < 200 ) ? 255 : 0;
+         below[j] = ( random_level ( &state ) < 200 ) ? 255 : 0;
+      }
+
+      rox_ansi_motion_difference_row ( &diff_lib[0], &model[0], &image[0], cols );
+      ansi::rox_ansi_motion_difference_row ( &diff_ansi[0], &model[0], &image[0], cols );
+      if ( memcmp ( &diff_lib[0], &diff_ansi[0], cols * sizeof ( Rox_Float ) ) ) mismatches++;
+
+      // Values on both sides of the threshold, and equal to it
+      for ( Rox_Sint j = 0; j < cols; j++ ) diff_lib[j] = (Rox_Float) ( j % 7 - 3 ) * 10.0f;
+      rox_ansi_motion_threshold_row ( &out_lib[0], &diff_lib[0], 20.0f, cols );
+      ansi::rox_ansi_motion_threshold_row ( &out_ansi[0], &diff_lib[0], 20.0f, cols );
+      if ( memcmp ( &out_lib[0], &out_ansi[0], cols ) ) mismatches++;
+
+      rox_ansi_motion_erode3x3_row ( &out_lib[0], &above[0], &motion[0], &below[0], cols );
+      ansi::rox_ansi_motion_erode3x3_row ( &out_ansi[0], &above[0], &motion[0], &below[0], cols );
+      if ( memcmp ( &out_lib[0], &out_ansi[0], cols ) ) mismatches++;
+
+      model_lib = model;
+      model_ansi = model;
+      rox_ansi_motion_model_update_row ( &model_lib[0], &image[0], &motion[0], cols );
+      ansi::rox_ansi_motion_model_update_row ( &model_ansi[0], &image[0], &motion[0], cols );
+      if ( model_lib != model_ansi ) mismatches++;
+   }
+
+   ROX_TEST_CHECK_EQUAL ( mismatches, 0 );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_motion_detection_windows )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image model = NULL, image = NULL;
+   Rox_Detection_Motion motion = NULL;
+   Rox_DynVec_Rect_Sint windows = NULL, detections = NULL;
+
+   error = rox_array2d_uchar_new ( &model, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uchar_new ( &image, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_uchar_fillval ( model, 100 );
+   rox_array2d_uchar_fillval ( image, 100 );
+
+   // One object in each window, a third one out of the windows
+   draw_square ( image, 40, 30, 20, 200 );
+   draw_square ( image, 200, 150, 24, 10 );
+   draw_square ( image, 20, 190, 20, 200 );
+
+   error = rox_detection_motion_new ( &motion, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_rect_sint_new ( &windows, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_dynvec_rect_sint_new ( &detections, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Rect_Sint_Struct window_a = { 0, 0, 160, 120 };
+   Rox_Rect_Sint_Struct window_b = { 160, 120, 160, 120 };
+   rox_dynvec_rect_sint_append ( windows, &window_a );
+   rox_dynvec_rect_sint_append ( windows, &window_b );
+
+   error = rox_detection_motion_set_imask_window_list ( motion, windows );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_window_list ( detections, motion, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( detections->used, 2u );
+
+   if ( detections->used == 2 )
+   {
+      ROX_TEST_CHECK_CLOSE ( detections->data[0].x, 40, 2 );
+      ROX_TEST_CHECK_CLOSE ( detections->data[0].y, 30, 2 );
+      ROX_TEST_CHECK_CLOSE ( detections->data[0].width, 20, 3 );
+      ROX_TEST_CHECK_CLOSE ( detections->data[0].height, 20, 3 );
+
+      ROX_TEST_CHECK_CLOSE ( detections->data[1].x, 200, 2 );
+      ROX_TEST_CHECK_CLOSE ( detections->data[1].y, 150, 2 );
+      ROX_TEST_CHECK_CLOSE ( detections->data[1].width, 24, 3 );
+      ROX_TEST_CHECK_CLOSE ( detections->data[1].height, 24, 3 );
+   }
+
+   // A single window keeps only its object
+   error = rox_detection_motion_set_imask_window ( motion, &window_b );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_window_list ( detections, motion, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( detections->used, 1u );
+
+   // A user defined mask on the whole image finds the three objects
+   Rox_Imask mask = NULL;
+   error = rox_array2d_uint_new ( &mask, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_array2d_uint_fillval ( mask, ~0u );
+
+   error = rox_detection_motion_set_imask ( motion, mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_window_list ( detections, motion, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( detections->used, 3u );
+
+   // No motion without difference
+   error = rox_detection_motion_set_window_list ( detections, motion, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( detections->used, 0u );
+
+   error = rox_detection_motion_set_window_list ( NULL, motion, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NULL_POINTER );
+
+   rox_array2d_uint_del ( &mask );
+   rox_dynvec_rect_sint_del ( &windows );
+   rox_dynvec_rect_sint_del ( &detections );
+   rox_detection_motion_del ( &motion );
+   rox_array2d_uchar_del ( &model );
+   rox_array2d_uchar_del ( &image );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_motion_detection_windows_whole_image )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image model = NULL, image = NULL;
+   Rox_Imask mask = NULL;
+   Rox_Detection_Motion motion_windows = NULL, motion_image = NULL;
+   Rox_DynVec_Rect_Sint windows = NULL, detections_windows = NULL, detections_image = NULL;
+
+   error = rox_array2d_uchar_new ( &model, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uchar_new ( &image, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uint_new ( &mask, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   draw_scene ( model, 1 );
+   draw_scene ( image, 2 );
+
+   error = rox_detection_motion_new ( &motion_windows, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_detection_motion_new ( &motion_image, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_dynvec_rect_sint_new ( &windows, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_dynvec_rect_sint_new ( &detections_windows, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_dynvec_rect_sint_new ( &detections_image, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Overlapping windows, on the image borders and out of the image
+   Rox_Rect_Sint_Struct rects[4] = { { 0, 0, 150, 130 }, { 100, 60, 120, 120 }, { 230, 150, 120, 120 }, { -20, 200, 60, 60 } };
+   for ( Rox_Sint k = 0; k < 4; k++ ) rox_dynvec_rect_sint_append ( windows, &rects[k] );
+
+   error = rox_detection_motion_set_imask_window_list ( motion_windows, windows );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // Same mask processed as a single region on the whole image
+   Rox_Uint ** mask_data = NULL;
+   rox_array2d_uint_get_data_pointer_to_pointer ( &mask_data, mask );
+   rox_array2d_uint_fillval ( mask, 0 );
+
+   for ( Rox_Sint k = 0; k < 4; k++ )
+   {
+      for ( Rox_Sint i = rects[k].y; i < rects[k].y + rects[k].height; i++ )
+      {
+         for ( Rox_Sint j = rects[k].x; j < rects[k].x + rects[k].width; j++ )
+         {
+            if ( i >= 0 && i < ROWS && j >= 0 && j < COLS ) mask_data[i][j] = ~0u;
+         }
+      }
+   }
+
+   error = rox_detection_motion_set_imask ( motion_image, mask );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_sensitivity ( motion_windows, 1.0f );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_detection_motion_set_sensitivity ( motion_image, 1.0f );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_window_list ( detections_windows, motion_windows, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_detection_motion_set_window_list ( detections_image, motion_image, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   ROX_TEST_CHECK_SUPERIOR ( detections_image->used, 0u );
+   ROX_TEST_CHECK_EQUAL ( detections_windows->used, detections_image->used );
+
+   if ( detections_windows->used == detections_image->used )
+   {
+      ROX_TEST_CHECK_EQUAL ( memcmp ( detections_windows->data, detections_image->data, detections_image->used * sizeof ( Rox_Rect_Sint_Struct ) ), 0 );
+   }
+
+   rox_dynvec_rect_sint_del ( &windows );
+   rox_dynvec_rect_sint_del ( &detections_windows );
+   rox_dynvec_rect_sint_del ( &detections_image );
+   rox_detection_motion_del ( &motion_windows );
+   rox_detection_motion_del ( &motion_image );
+   rox_array2d_uint_del ( &mask );
+   rox_array2d_uchar_del ( &model );
+   rox_array2d_uchar_del ( &image );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_motion_detection_adaptation )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image model = NULL, image = NULL;
+   Rox_Detection_Motion motion = NULL;
+   Rox_DynVec_Rect_Sint detections = NULL;
+
+   error = rox_array2d_uchar_new ( &model, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_array2d_uchar_new ( &image, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   rox_array2d_uchar_fillval ( model, 100 );
+   rox_array2d_uchar_fillval ( image, 100 );
+   draw_square ( image, 100, 100, 16, 180 );
+
+   error = rox_detection_motion_new ( &motion, model );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_dynvec_rect_sint_new ( &detections, 10 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   Rox_Rect_Sint_Struct window = { 0, 0, COLS, ROWS };
+   error = rox_detection_motion_set_imask_window ( motion, &window );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_adaptation ( motion, -1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_INVALID_VALUE );
+
+   error = rox_detection_motion_set_adaptation ( motion, 1 );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   error = rox_detection_motion_set_window_list ( detections, motion, image );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   ROX_TEST_CHECK_EQUAL ( detections->used, 1u );
+
+   // A static object is absorbed by the background model
+   Rox_Sint frames = 1;
+   while ( detections->used > 0 && frames < 1000 )
+   {
+      error = rox_detection_motion_set_window_list ( detections, motion, image );
+      ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+      frames++;
+   }
+
+   ROX_TEST_CHECK_EQUAL ( detections->used, 0u );
+
+   rox_dynvec_rect_sint_del ( &detections );
+   rox_detection_motion_del ( &motion );
+   rox_array2d_uchar_del ( &model );
+   rox_array2d_uchar_del ( &image );
+}
+
+ROX_TEST_CASE_DECLARE ( rox::OpenROXTest, test_motion_detection_cluster_many_components )
+{
+   Rox_ErrorCode error = ROX_ERROR_NONE;
+   Rox_Image image = NULL;
+   Rox_Cluster cluster = NULL;
+   Rox_Connected_Components ccl = NULL;
+   Rox_Sint count = 0;
+
+   error = rox_array2d_uchar_new ( &image, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_array2d_uchar_fillval ( image, 0 );
+
+   // 6x8 tiles of 40x40 pixels, each with a 5x5 lattice of isolated pixels 3 pixels apart
+   for ( Rox_Sint tile_v = 0; tile_v < ROWS / 40; tile_v++ )
+      for ( Rox_Sint tile_u = 0; tile_u < COLS / 40; tile_u++ )
+         for ( Rox_Sint i = 0; i < 5; i++ )
+            for ( Rox_Sint j = 0; j < 5; j++ )
+               draw_square ( image, 40 * tile_u + 10 + 3 * j, 40 * tile_v + 10 + 3 * i, 1, 255 );
+
+   error = rox_cluster_new ( &cluster );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   error = rox_connected_components_new ( &ccl, ROWS, COLS );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+
+   // The gaps between the boxes are 3 pixels in a lattice, and 28 pixels between the lattices
+   Rox_Sint separated[2] = { 2, 2 };
+   error = rox_cluster_binary_components ( cluster, ccl, image, separated );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_cluster_get_count ( &count, cluster );
+   ROX_TEST_CHECK_EQUAL ( count, 6 * 8 * 25 );
+
+   Rox_Sint lattices[2] = { 3, 3 };
+   error = rox_cluster_binary_components ( cluster, ccl, image, lattices );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_cluster_get_count ( &count, cluster );
+   ROX_TEST_CHECK_EQUAL ( count, 6 * 8 );
+
+   std::vector<Rox_Sint> seen ( 6 * 8, 0 );
+   Rox_Sint * bounds = rox_cluster_get_bounds ( cluster );
+   for ( Rox_Sint k = 0; k < count; k++ )
+   {
+      const Rox_Sint tile_u = bounds[4 * k] / 40;
+      const Rox_Sint tile_v = bounds[4 * k + 1] / 40;
+
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k], 40 * tile_u + 10 );
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k + 1], 40 * tile_v + 10 );
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k + 2], 40 * tile_u + 22 );
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k + 3], 40 * tile_v + 22 );
+      seen[tile_v * 8 + tile_u]++;
+   }
+   for ( Rox_Sint k = 0; k < 6 * 8; k++ ) ROX_TEST_CHECK_EQUAL ( seen[k], 1 );
+
+   // Along the columns the bandwidth reaches the next lattice exactly
+   Rox_Sint rows_of_lattices[2] = { 3, 28 };
+   error = rox_cluster_binary_components ( cluster, ccl, image, rows_of_lattices );
+   ROX_TEST_CHECK_EQUAL ( error, ROX_ERROR_NONE );
+   rox_cluster_get_count ( &count, cluster );
+   ROX_TEST_CHECK_EQUAL ( count, 6 );
+
+   bounds = rox_cluster_get_bounds ( cluster );
+   for ( Rox_Sint k = 0; k < count; k++ )
+   {
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k], 10 );
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k + 1], 40 * k + 10 );
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k + 2], COLS - 40 + 22 );
+      ROX_TEST_CHECK_EQUAL ( bounds[4 * k + 3], 40 * k + 22 );
+   }
+
+   rox_connected_components_del ( &ccl );
+   rox_cluster_del ( &cluster );
+   rox_array2d_uchar_del ( &image );
+}
+
+ROX_TEST_SUITE_END ( )